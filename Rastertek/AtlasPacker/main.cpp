@@ -0,0 +1,694 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+const int ATLAS_MIN_SIZE = 64;
+const int ATLAS_MAX_SIZE = 8192;
+const int ATLAS_ALIGNMENT = 4;
+const int HEURISTIC_COUNT = 4;
+const int SORT_ORDER_COUNT = 4;
+
+//////////////
+// TYPEDEFS //
+//////////////
+
+//Only the fields of the DDS header needed for uncompressed textures are named
+struct DdsHeaderType
+{
+	unsigned int magic;
+	unsigned int size;
+	unsigned int flags;
+	unsigned int height;
+	unsigned int width;
+	unsigned int pitchOrLinearSize;
+	unsigned int depth;
+	unsigned int mipMapCount;
+	unsigned int reserved1[11];
+	unsigned int pixelFormatSize;
+	unsigned int pixelFormatFlags;
+	unsigned int fourCC;
+	unsigned int rgbBitCount;
+	unsigned int redBitMask;
+	unsigned int greenBitMask;
+	unsigned int blueBitMask;
+	unsigned int alphaBitMask;
+	unsigned int caps;
+	unsigned int caps2;
+	unsigned int caps3;
+	unsigned int caps4;
+	unsigned int reserved2;
+};
+
+//Images are held as A8R8G8B8 whatever channel order they were stored in
+struct ImageType
+{
+	string name;
+	int width;
+	int height;
+	vector<unsigned int> texels;
+};
+
+struct RectType
+{
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+struct PackTaskType
+{
+	int width;
+	int height;
+	int maxHeight;
+	int heuristic;
+	int sortOrder;
+	bool success;
+	vector<RectType> placements;
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+bool LoadSourceImage(char* filename, ImageType& image);
+bool SaveAtlas(char* filename, const vector<unsigned int>& texels, int width, int height);
+bool SaveTable(char* filename, const vector<ImageType>& images, const vector<RectType>& placements, int width, int height);
+string GetBaseName(const char* filename);
+void BuildCandidateSizes(const vector<ImageType>& images, long long usedArea, int padding, int maxSize, vector<PackTaskType>& tasks);
+void PackWorker(const vector<ImageType>* images, vector<PackTaskType>* tasks, atomic<int>* nextTask, int padding);
+bool PackMaxRects(const vector<ImageType>& images, const vector<int>& order, int width, int height, int heuristic, int padding, vector<RectType>& placements);
+bool ScorePosition(const RectType& freeRect, int width, int height, int heuristic, int& score1, int& score2);
+void SplitFreeRects(vector<RectType>& freeRects, const RectType& used);
+void PruneFreeRects(vector<RectType>& freeRects);
+void BlitImage(vector<unsigned int>& atlas, int atlasWidth, int atlasHeight, const ImageType& image, const RectType& placement, int padding);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	bool result;
+	vector<ImageType> images;
+	vector<PackTaskType> tasks;
+	vector<thread> threads;
+	atomic<int> nextTask;
+	vector<unsigned int> atlas;
+	int padding;
+	int maxSize;
+	int threadCount;
+	int firstImage;
+	int best;
+	long long usedArea;
+	long long bestArea;
+	long long area;
+
+	//Usage: AtlasPacker <output atlas.dds> <output table.txt> [-padding n] [-maxsize n] <image.dds> ...
+	if (argc < 4)
+	{
+		cout << "Usage: AtlasPacker <output atlas.dds> <output table.txt> [-padding n] [-maxsize n] <image.dds> ..." << endl;
+		cout << "  -padding  texels of edge extrusion between the images (default 2)" << endl;
+		cout << "  -maxsize  largest width or height of the atlas (default 4096)" << endl;
+		return -1;
+	}
+
+	padding = 2;
+	maxSize = 4096;
+	firstImage = 3;
+	while (firstImage + 1 < argc && argv[firstImage][0] == '-')
+	{
+		if (strcmp(argv[firstImage], "-padding") == 0)
+		{
+			padding = atoi(argv[firstImage + 1]);
+		}
+		else if (strcmp(argv[firstImage], "-maxsize") == 0)
+		{
+			maxSize = atoi(argv[firstImage + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstImage] << endl;
+			return -1;
+		}
+		firstImage += 2;
+	}
+	if (padding < 0 || maxSize < ATLAS_MIN_SIZE || maxSize > ATLAS_MAX_SIZE)
+	{
+		cout << "Invalid padding or maximum size" << endl;
+		return -1;
+	}
+
+	//Read in every image
+	usedArea = 0;
+	for (int i = firstImage; i < argc; i++)
+	{
+		ImageType image;
+		result = LoadSourceImage(argv[i], image);
+		if (!result)
+		{
+			cout << "Could not load " << argv[i] << ", only uncompressed 32 bit DDS files are supported" << endl;
+			return -1;
+		}
+		usedArea += (long long)image.width * image.height;
+		images.push_back(image);
+	}
+	if (images.empty())
+	{
+		cout << "No images to pack" << endl;
+		return -1;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	//Every atlas width that could hold the images is tried with every placement heuristic and input order.
+	//The attempts are independent so they are spread over all the cores
+	BuildCandidateSizes(images, usedArea, padding, maxSize, tasks);
+
+	threadCount = (int)thread::hardware_concurrency();
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	nextTask = 0;
+	for (int i = 0; i < threadCount; i++)
+	{
+		threads.push_back(thread(PackWorker, &images, &tasks, &nextTask, padding));
+	}
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+
+	//The best fit is the attempt with the smallest atlas, and of those the squarest one
+	best = -1;
+	bestArea = 0;
+	for (size_t i = 0; i < tasks.size(); i++)
+	{
+		if (!tasks[i].success)
+		{
+			continue;
+		}
+
+		area = (long long)tasks[i].width * tasks[i].height;
+		if (best < 0 || area < bestArea || (area == bestArea && abs(tasks[i].width - tasks[i].height) < abs(tasks[best].width - tasks[best].height)))
+		{
+			best = (int)i;
+			bestArea = area;
+		}
+	}
+
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+	if (best < 0)
+	{
+		cout << "The images do not fit in a " << maxSize << "x" << maxSize << " atlas" << endl;
+		return -1;
+	}
+
+	//Copy every image into its place in the atlas
+	atlas.assign((size_t)tasks[best].width * tasks[best].height, 0);
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		BlitImage(atlas, tasks[best].width, tasks[best].height, images[i], tasks[best].placements[i], padding);
+	}
+
+	//Display the packing results to the screen for information purpose
+	cout << "Images: " << images.size() << endl;
+	cout << "Atlas: " << tasks[best].width << "x" << tasks[best].height << endl;
+	cout << "Efficiency: " << fixed << setprecision(1) << (100.0 * (double)usedArea / ((double)tasks[best].width * tasks[best].height)) << "%" << endl;
+	cout << "Attempts: " << tasks.size() << " on " << threadCount << " threads" << endl;
+	cout << "Time: " << setprecision(3) << chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0 << " ms" << endl;
+
+	//Write out the atlas and the table of where each image ended up
+	result = SaveAtlas(argv[1], atlas, tasks[best].width, tasks[best].height);
+	if (!result)
+	{
+		cout << "Could not write " << argv[1] << endl;
+		return -1;
+	}
+
+	result = SaveTable(argv[2], images, tasks[best].placements, tasks[best].width, tasks[best].height);
+	if (!result)
+	{
+		cout << "Could not write " << argv[2] << endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+bool LoadSourceImage(char* filename, ImageType& image)
+{
+	ifstream fIn;
+	DdsHeaderType header;
+	vector<unsigned int> texels;
+	unsigned int masks[4];
+	unsigned int shifts[4];
+	unsigned int value;
+
+	//Open the file
+	fIn.open(filename, ios::binary);
+	if (fIn.fail())
+	{
+		return false;
+	}
+
+	//Read in the header, only uncompressed 32 bit textures are supported. Any mip levels after the first are ignored
+	fIn.read((char*)&header, sizeof(DdsHeaderType));
+	if (fIn.fail() || header.magic != 0x20534444 || (header.pixelFormatFlags & 0x4) != 0 || header.rgbBitCount != 32)
+	{
+		return false;
+	}
+
+	texels.resize((size_t)header.width * header.height);
+	fIn.read((char*)&texels[0], texels.size() * sizeof(unsigned int));
+	if (fIn.fail())
+	{
+		return false;
+	}
+
+	//Close the file
+	fIn.close();
+
+	//Work out where each channel sits so X8B8G8R8 and A8R8G8B8 files can be mixed in one atlas
+	masks[0] = header.alphaBitMask;
+	masks[1] = header.redBitMask;
+	masks[2] = header.greenBitMask;
+	masks[3] = header.blueBitMask;
+	for (int c = 0; c < 4; c++)
+	{
+		shifts[c] = 0;
+		while (masks[c] != 0 && ((masks[c] >> shifts[c]) & 1) == 0)
+		{
+			shifts[c]++;
+		}
+	}
+
+	image.name = GetBaseName(filename);
+	image.width = (int)header.width;
+	image.height = (int)header.height;
+	image.texels.resize(texels.size());
+	for (size_t i = 0; i < texels.size(); i++)
+	{
+		//Textures without an alpha channel are opaque
+		value = (masks[0] != 0) ? ((texels[i] & masks[0]) >> shifts[0]) : 0xFF;
+		value = (value << 8) | ((texels[i] & masks[1]) >> shifts[1]);
+		value = (value << 8) | ((texels[i] & masks[2]) >> shifts[2]);
+		value = (value << 8) | ((texels[i] & masks[3]) >> shifts[3]);
+		image.texels[i] = value;
+	}
+
+	return true;
+}
+
+bool SaveAtlas(char* filename, const vector<unsigned int>& texels, int width, int height)
+{
+	ofstream fOut;
+	DdsHeaderType header;
+
+	//Write a single level A8R8G8B8 texture, the same format as the rest of the assets
+	memset(&header, 0, sizeof(DdsHeaderType));
+	header.magic = 0x20534444;
+	header.size = 124;
+	header.flags = 0x100F;
+	header.height = height;
+	header.width = width;
+	header.pitchOrLinearSize = width * 4;
+	header.pixelFormatSize = 32;
+	header.pixelFormatFlags = 0x41;
+	header.rgbBitCount = 32;
+	header.redBitMask = 0x00FF0000;
+	header.greenBitMask = 0x0000FF00;
+	header.blueBitMask = 0x000000FF;
+	header.alphaBitMask = 0xFF000000;
+	header.caps = 0x1000;
+
+	//Open the output file
+	fOut.open(filename, ios::binary);
+	if (fOut.fail())
+	{
+		return false;
+	}
+
+	fOut.write((const char*)&header, sizeof(DdsHeaderType));
+	fOut.write((const char*)&texels[0], texels.size() * sizeof(unsigned int));
+
+	//Close the output file
+	fOut.close();
+
+	return !fOut.fail();
+}
+
+bool SaveTable(char* filename, const vector<ImageType>& images, const vector<RectType>& placements, int width, int height)
+{
+	ofstream fOut;
+
+	//Open the output file
+	fOut.open(filename);
+	if (fOut.fail())
+	{
+		return false;
+	}
+
+	//The table holds the number of images followed by one "name left top right bottom width height" line per image.
+	//The edges are texture coordinates and the size is in texels so a Bitmap can be drawn at the original size
+	fOut << images.size() << endl;
+	fOut << fixed << setprecision(6);
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		fOut << images[i].name << " ";
+		fOut << (float)placements[i].x / (float)width << " ";
+		fOut << (float)placements[i].y / (float)height << " ";
+		fOut << (float)(placements[i].x + images[i].width) / (float)width << " ";
+		fOut << (float)(placements[i].y + images[i].height) / (float)height << " ";
+		fOut << images[i].width << " " << images[i].height << endl;
+	}
+
+	//Close the output file
+	fOut.close();
+
+	return !fOut.fail();
+}
+
+string GetBaseName(const char* filename)
+{
+	string name;
+	size_t slash;
+
+	//Images are looked up by their file name without the directory
+	name = filename;
+	slash = name.find_last_of("/\\");
+	if (slash != string::npos)
+	{
+		name = name.substr(slash + 1);
+	}
+
+	return name;
+}
+
+void BuildCandidateSizes(const vector<ImageType>& images, long long usedArea, int padding, int maxSize, vector<PackTaskType>& tasks)
+{
+	PackTaskType task;
+	long long paddedArea;
+	int minWidth;
+
+	//The atlas has to be at least as wide as the widest image. Each image also takes its padding on the right and bottom,
+	//which the packer gets back at the atlas edge, so that much more of the atlas is there to be filled
+	minWidth = ATLAS_MIN_SIZE;
+	paddedArea = usedArea;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		minWidth = max(minWidth, images[i].width);
+		paddedArea += (long long)padding * (images[i].width + images[i].height + padding);
+	}
+	minWidth = ((minWidth + ATLAS_ALIGNMENT - 1) / ATLAS_ALIGNMENT) * ATLAS_ALIGNMENT;
+
+	//Each attempt packs into a fixed width with the full height available, the height the images end up using gives the atlas size.
+	//The sizes are kept to a multiple of four so the atlas can still be block compressed
+	for (int width = minWidth; width <= maxSize; width += ATLAS_ALIGNMENT)
+	{
+		//Skip the widths that could not hold the images even if they were packed perfectly
+		if ((long long)(width + padding) * (maxSize + padding) < paddedArea)
+		{
+			continue;
+		}
+
+		for (int heuristic = 0; heuristic < HEURISTIC_COUNT; heuristic++)
+		{
+			for (int sortOrder = 0; sortOrder < SORT_ORDER_COUNT; sortOrder++)
+			{
+				task.width = width;
+				task.height = 0;
+				task.maxHeight = maxSize;
+				task.heuristic = heuristic;
+				task.sortOrder = sortOrder;
+				task.success = false;
+				tasks.push_back(task);
+			}
+		}
+	}
+}
+
+void PackWorker(const vector<ImageType>* images, vector<PackTaskType>* tasks, atomic<int>* nextTask, int padding)
+{
+	vector<int> order;
+	int index;
+
+	order.resize(images->size());
+
+	//Keep taking the next attempt until they are all done
+	while ((index = (*nextTask)++) < (int)tasks->size())
+	{
+		PackTaskType& task = (*tasks)[index];
+
+		//Place the images biggest first, with the size measured a different way for each order
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			order[i] = (int)i;
+		}
+		stable_sort(order.begin(), order.end(), [&](int a, int b)
+		{
+			const ImageType& imageA = (*images)[a];
+			const ImageType& imageB = (*images)[b];
+			switch (task.sortOrder)
+			{
+			case 0:
+				return imageA.width * imageA.height > imageB.width * imageB.height;
+			case 1:
+				return max(imageA.width, imageA.height) > max(imageB.width, imageB.height);
+			case 2:
+				return imageA.height > imageB.height;
+			default:
+				return imageA.width > imageB.width;
+			}
+		});
+
+		task.success = PackMaxRects(*images, order, task.width, task.maxHeight, task.heuristic, padding, task.placements);
+		if (!task.success)
+		{
+			continue;
+		}
+
+		//The atlas only needs to reach down to the bottom of the lowest image
+		task.height = 0;
+		for (size_t i = 0; i < images->size(); i++)
+		{
+			task.height = max(task.height, task.placements[i].y + (*images)[i].height);
+		}
+		task.height = ((task.height + ATLAS_ALIGNMENT - 1) / ATLAS_ALIGNMENT) * ATLAS_ALIGNMENT;
+	}
+}
+
+bool PackMaxRects(const vector<ImageType>& images, const vector<int>& order, int width, int height, int heuristic, int padding, vector<RectType>& placements)
+{
+	vector<RectType> freeRects;
+	RectType rect;
+	int bestScore1;
+	int bestScore2;
+	int score1;
+	int score2;
+	int bestFree;
+	int rectWidth;
+	int rectHeight;
+
+	//The whole atlas starts out free. The padding on the right and bottom of each image is part of its rectangle so the atlas is one padding bigger to allow it at the edge too
+	rect.x = 0;
+	rect.y = 0;
+	rect.width = width + padding;
+	rect.height = height + padding;
+	freeRects.push_back(rect);
+
+	placements.resize(images.size());
+
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		rectWidth = images[order[i]].width + padding;
+		rectHeight = images[order[i]].height + padding;
+
+		//Find the free rectangle where the image scores best
+		bestFree = -1;
+		bestScore1 = INT_MAX;
+		bestScore2 = INT_MAX;
+		for (size_t j = 0; j < freeRects.size(); j++)
+		{
+			if (ScorePosition(freeRects[j], rectWidth, rectHeight, heuristic, score1, score2))
+			{
+				if (score1 < bestScore1 || (score1 == bestScore1 && score2 < bestScore2))
+				{
+					bestFree = (int)j;
+					bestScore1 = score1;
+					bestScore2 = score2;
+				}
+			}
+		}
+
+		//The image does not fit anywhere
+		if (bestFree < 0)
+		{
+			return false;
+		}
+
+		//Place it in the top left corner of that free rectangle
+		rect.x = freeRects[bestFree].x;
+		rect.y = freeRects[bestFree].y;
+		rect.width = rectWidth;
+		rect.height = rectHeight;
+		placements[order[i]] = rect;
+
+		//Remove the space it takes from every free rectangle it overlaps
+		SplitFreeRects(freeRects, rect);
+		PruneFreeRects(freeRects);
+	}
+
+	return true;
+}
+
+bool ScorePosition(const RectType& freeRect, int width, int height, int heuristic, int& score1, int& score2)
+{
+	int leftoverX;
+	int leftoverY;
+
+	if (width > freeRect.width || height > freeRect.height)
+	{
+		return false;
+	}
+
+	leftoverX = freeRect.width - width;
+	leftoverY = freeRect.height - height;
+
+	switch (heuristic)
+	{
+	//Best short side fit, the free rectangle whose shorter leftover side is smallest
+	case 0:
+		score1 = min(leftoverX, leftoverY);
+		score2 = max(leftoverX, leftoverY);
+		break;
+	//Best long side fit
+	case 1:
+		score1 = max(leftoverX, leftoverY);
+		score2 = min(leftoverX, leftoverY);
+		break;
+	//Best area fit
+	case 2:
+		score1 = (freeRect.width * freeRect.height) - (width * height);
+		score2 = min(leftoverX, leftoverY);
+		break;
+	//Bottom left, the lowest position and then the leftmost
+	default:
+		score1 = freeRect.y + height;
+		score2 = freeRect.x;
+		break;
+	}
+
+	return true;
+}
+
+void SplitFreeRects(vector<RectType>& freeRects, const RectType& used)
+{
+	vector<RectType> split;
+	RectType rect;
+
+	for (size_t i = 0; i < freeRects.size(); i++)
+	{
+		const RectType& freeRect = freeRects[i];
+
+		//Free rectangles the image does not touch are kept as they are
+		if (used.x >= freeRect.x + freeRect.width || used.x + used.width <= freeRect.x || used.y >= freeRect.y + freeRect.height || used.y + used.height <= freeRect.y)
+		{
+			split.push_back(freeRect);
+			continue;
+		}
+
+		//Otherwise up to four maximal rectangles are left over, one on each side of the image
+		if (used.x > freeRect.x)
+		{
+			rect = freeRect;
+			rect.width = used.x - freeRect.x;
+			split.push_back(rect);
+		}
+		if (used.x + used.width < freeRect.x + freeRect.width)
+		{
+			rect = freeRect;
+			rect.x = used.x + used.width;
+			rect.width = (freeRect.x + freeRect.width) - rect.x;
+			split.push_back(rect);
+		}
+		if (used.y > freeRect.y)
+		{
+			rect = freeRect;
+			rect.height = used.y - freeRect.y;
+			split.push_back(rect);
+		}
+		if (used.y + used.height < freeRect.y + freeRect.height)
+		{
+			rect = freeRect;
+			rect.y = used.y + used.height;
+			rect.height = (freeRect.y + freeRect.height) - rect.y;
+			split.push_back(rect);
+		}
+	}
+
+	freeRects.swap(split);
+}
+
+void PruneFreeRects(vector<RectType>& freeRects)
+{
+	//Drop every free rectangle that lies completely inside another one
+	for (size_t i = 0; i < freeRects.size(); i++)
+	{
+		for (size_t j = i + 1; j < freeRects.size(); j++)
+		{
+			const RectType& a = freeRects[i];
+			const RectType& b = freeRects[j];
+			if (a.x >= b.x && a.y >= b.y && a.x + a.width <= b.x + b.width && a.y + a.height <= b.y + b.height)
+			{
+				freeRects.erase(freeRects.begin() + i);
+				i--;
+				break;
+			}
+			if (b.x >= a.x && b.y >= a.y && b.x + b.width <= a.x + a.width && b.y + b.height <= a.y + a.height)
+			{
+				freeRects.erase(freeRects.begin() + j);
+				j--;
+			}
+		}
+	}
+}
+
+void BlitImage(vector<unsigned int>& atlas, int atlasWidth, int atlasHeight, const ImageType& image, const RectType& placement, int padding)
+{
+	int sourceX;
+	int sourceY;
+
+	//Copy the image and extrude its right and bottom edges into the padding so filtering at the edge does not pick up the neighbouring image
+	for (int y = 0; y < image.height + padding && placement.y + y < atlasHeight; y++)
+	{
+		sourceY = min(y, image.height - 1);
+		for (int x = 0; x < image.width + padding && placement.x + x < atlasWidth; x++)
+		{
+			sourceX = min(x, image.width - 1);
+			atlas[((size_t)(placement.y + y) * atlasWidth) + placement.x + x] = image.texels[((size_t)sourceY * image.width) + sourceX];
+		}
+	}
+}
\ No newline at end of file
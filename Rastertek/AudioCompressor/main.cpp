@@ -0,0 +1,338 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "../Engine/RiffReader.h"
+#include "../Engine/WaveFile.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned int DEFAULT_CHANNEL_BLOCK = 512;
+const unsigned int MAX_CHANNEL_BLOCK = 8192;
+
+//How far the step size moves after each code, and the step sizes themselves
+const int INDEX_TABLE[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+const int STEP_TABLE[89] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166,
+	1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845,
+	8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+void EncodeBlock(const short* samples, size_t frameCount, unsigned int channels, size_t firstFrame, unsigned int framesPerBlock, int* indices, unsigned char* output);
+unsigned int EncodeSample(int sample, int& predictor, int& index);
+bool SaveCompressed(char* filename, unsigned int channels, unsigned int sampleRate, unsigned int blockAlign, unsigned int framesPerBlock, size_t frameCount, const vector<unsigned char>& data);
+void WriteUShort(ofstream& fOut, unsigned short value);
+void WriteUInt(ofstream& fOut, unsigned int value);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	bool result;
+	WaveFile file;
+	WaveFile compressed;
+	vector<short> samples;
+	vector<short> decoded;
+	vector<unsigned char> data;
+	int indices[WAVE_ADPCM_MAX_CHANNELS];
+	unsigned int channelBlock;
+	unsigned int channels;
+	unsigned int blockAlign;
+	unsigned int framesPerBlock;
+	size_t frameCount;
+	size_t blockCount;
+	size_t i;
+	int firstArgument;
+	double signal;
+	double noise;
+	double difference;
+	double snr;
+	double milliseconds;
+	double sourceBytes;
+
+	//Usage: AudioCompressor [-block n] <input.wav> <output.wav>
+	if (argc < 3)
+	{
+		cout << "Usage: AudioCompressor [-block n] <input.wav> <output.wav>" << endl;
+		cout << "  Encodes any wave file the engine reads as 4 bit IMA ADPCM, a quarter the size of 16 bit PCM" << endl;
+		cout << "  -block  bytes per channel in a block, a multiple of 4, smaller blocks seek finer but cost more headers (default 512)" << endl;
+		return -1;
+	}
+
+	channelBlock = DEFAULT_CHANNEL_BLOCK;
+	firstArgument = 1;
+	while (firstArgument + 2 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-block") == 0)
+		{
+			channelBlock = (unsigned int)atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (channelBlock <= 4 || channelBlock % 4 != 0 || channelBlock > MAX_CHANNEL_BLOCK || firstArgument + 2 != argc)
+	{
+		cout << "Invalid block size or missing file names" << endl;
+		return -1;
+	}
+
+	//Read the whole source as 16 bit samples, whatever format it is stored in
+	result = file.Initialize(argv[firstArgument]);
+	if (!result)
+	{
+		cout << "Could not load " << argv[firstArgument] << endl;
+		return -1;
+	}
+
+	channels = file.GetChannels();
+	if (channels > WAVE_ADPCM_MAX_CHANNELS)
+	{
+		cout << "Only up to " << WAVE_ADPCM_MAX_CHANNELS << " channels can be encoded" << endl;
+		return -1;
+	}
+
+	frameCount = file.GetFrameCount();
+	samples.resize(frameCount * channels + 1);
+	file.ReadSamples(0, frameCount, &samples[0]);
+
+	//Each block starts with a header per channel and then holds two codes per byte
+	blockAlign = channelBlock * channels;
+	framesPerBlock = (channelBlock - 4) * 2 + 1;
+	blockCount = (frameCount + framesPerBlock - 1) / framesPerBlock;
+	data.resize(blockCount * blockAlign);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	//The step size carries over from block to block so the next block starts already adapted
+	for (i = 0; i < channels; i++)
+	{
+		indices[i] = 0;
+	}
+	for (i = 0; i < blockCount; i++)
+	{
+		EncodeBlock(&samples[0], frameCount, channels, i * framesPerBlock, framesPerBlock, indices, &data[i * blockAlign]);
+	}
+
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+	milliseconds = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+	result = SaveCompressed(argv[firstArgument + 1], channels, file.GetSampleRate(), blockAlign, framesPerBlock, frameCount, data);
+	if (!result)
+	{
+		cout << "Could not write " << argv[firstArgument + 1] << endl;
+		return -1;
+	}
+
+	//Read the output back through the engine's decoder and measure the error against the source
+	result = compressed.Initialize(argv[firstArgument + 1]);
+	if (!result || compressed.GetFrameCount() != frameCount || compressed.GetChannels() != channels)
+	{
+		cout << "Could not read back " << argv[firstArgument + 1] << endl;
+		return -1;
+	}
+
+	decoded.resize(frameCount * channels + 1);
+	compressed.ReadSamples(0, frameCount, &decoded[0]);
+
+	signal = 0.0;
+	noise = 0.0;
+	for (i = 0; i < frameCount * channels; i++)
+	{
+		difference = (double)samples[i] - (double)decoded[i];
+		signal += (double)samples[i] * (double)samples[i];
+		noise += difference * difference;
+	}
+	snr = (noise > 0.0) ? 10.0 * log10((signal + 1.0) / noise) : 99.99;
+
+	//Display the compression results to the screen for information purpose
+	sourceBytes = (double)frameCount * channels * 2;
+	cout << "Sound: " << argv[firstArgument] << " " << channels << " channels, " << file.GetSampleRate() << " Hz, ";
+	cout << fixed << setprecision(2) << (double)frameCount / file.GetSampleRate() << " s" << endl;
+	cout << "Blocks: " << blockCount << " of " << blockAlign << " bytes, " << framesPerBlock << " frames each" << endl;
+	cout << "SNR: " << snr << " dB against the source as 16 bit" << endl;
+	cout << "Size: " << (size_t)sourceBytes << " -> " << data.size() << " bytes (" << setprecision(1) << sourceBytes / (data.size() + 1e-9) << "x)" << endl;
+	cout << "Time: " << setprecision(3) << milliseconds << " ms, " << setprecision(1) << (sourceBytes / (1024.0 * 1024.0)) / (milliseconds / 1000.0 + 1e-9) << " MB/s" << endl;
+
+	compressed.Shutdown();
+	file.Shutdown();
+
+	return 0;
+}
+
+void EncodeBlock(const short* samples, size_t frameCount, unsigned int channels, size_t firstFrame, unsigned int framesPerBlock, int* indices, unsigned char* output)
+{
+	unsigned char* header;
+	unsigned char* codes;
+	unsigned int channel;
+	unsigned int frame;
+	unsigned int code;
+	size_t sourceFrame;
+	int predictor;
+
+	for (channel = 0; channel < channels; channel++)
+	{
+		//The first sample is stored whole in the header along with where the step size starts
+		predictor = samples[firstFrame * channels + channel];
+		header = output + channel * 4;
+		header[0] = (unsigned char)predictor;
+		header[1] = (unsigned char)(predictor >> 8);
+		header[2] = (unsigned char)indices[channel];
+		header[3] = 0;
+
+		//Codes for a channel come in groups of four bytes, eight codes to a group with the low nibble first
+		codes = output + channels * 4 + channel * 4;
+		for (frame = 1; frame < framesPerBlock; frame++)
+		{
+			//The last block is padded by holding the final sample
+			sourceFrame = firstFrame + frame < frameCount ? firstFrame + frame : frameCount - 1;
+			code = EncodeSample(samples[sourceFrame * channels + channel], predictor, indices[channel]);
+
+			if ((frame - 1) & 1)
+			{
+				codes[((frame - 1) >> 3) * channels * 4 + (((frame - 1) & 7) >> 1)] |= (unsigned char)(code << 4);
+			}
+			else
+			{
+				codes[((frame - 1) >> 3) * channels * 4 + (((frame - 1) & 7) >> 1)] = (unsigned char)code;
+			}
+		}
+	}
+}
+
+unsigned int EncodeSample(int sample, int& predictor, int& index)
+{
+	unsigned int code;
+	int step;
+	int difference;
+
+	//Pick the code bit by bit from the difference, largest step first
+	step = STEP_TABLE[index];
+	difference = sample - predictor;
+	code = 0;
+	if (difference < 0)
+	{
+		code = 8;
+		difference = -difference;
+	}
+	if (difference >= step)
+	{
+		code |= 4;
+		difference -= step;
+	}
+	if (difference >= step >> 1)
+	{
+		code |= 2;
+		difference -= step >> 1;
+	}
+	if (difference >= step >> 2)
+	{
+		code |= 1;
+	}
+
+	//Follow the decoder exactly so the encoder never drifts from what will be heard
+	difference = step >> 3;
+	if (code & 4)
+	{
+		difference += step;
+	}
+	if (code & 2)
+	{
+		difference += step >> 1;
+	}
+	if (code & 1)
+	{
+		difference += step >> 2;
+	}
+	predictor += code & 8 ? -difference : difference;
+	predictor = predictor > 32767 ? 32767 : (predictor < -32768 ? -32768 : predictor);
+
+	index += INDEX_TABLE[code];
+	index = index < 0 ? 0 : (index > 88 ? 88 : index);
+
+	return code;
+}
+
+bool SaveCompressed(char* filename, unsigned int channels, unsigned int sampleRate, unsigned int blockAlign, unsigned int framesPerBlock, size_t frameCount, const vector<unsigned char>& data)
+{
+	ofstream fOut;
+
+	fOut.open(filename, ios::out | ios::binary);
+	if (fOut.fail())
+	{
+		return false;
+	}
+
+	//RIFF header, then the format, the real frame count and the blocks
+	fOut.write("RIFF", 4);
+	WriteUInt(fOut, (unsigned int)(4 + 8 + 20 + 8 + 4 + 8 + data.size()));
+	fOut.write("WAVE", 4);
+
+	fOut.write("fmt ", 4);
+	WriteUInt(fOut, 20);
+	WriteUShort(fOut, (unsigned short)WAVE_FORMAT_TAG_IMA_ADPCM);
+	WriteUShort(fOut, (unsigned short)channels);
+	WriteUInt(fOut, sampleRate);
+	WriteUInt(fOut, (unsigned int)((unsigned long long)sampleRate * blockAlign / framesPerBlock));
+	WriteUShort(fOut, (unsigned short)blockAlign);
+	WriteUShort(fOut, 4);
+	WriteUShort(fOut, 2);
+	WriteUShort(fOut, (unsigned short)framesPerBlock);
+
+	fOut.write("fact", 4);
+	WriteUInt(fOut, 4);
+	WriteUInt(fOut, (unsigned int)frameCount);
+
+	fOut.write("data", 4);
+	WriteUInt(fOut, (unsigned int)data.size());
+	if (!data.empty())
+	{
+		fOut.write((const char*)&data[0], data.size());
+	}
+
+	fOut.close();
+
+	return !fOut.fail();
+}
+
+void WriteUShort(ofstream& fOut, unsigned short value)
+{
+	unsigned char bytes[2];
+
+	bytes[0] = (unsigned char)value;
+	bytes[1] = (unsigned char)(value >> 8);
+	fOut.write((const char*)bytes, 2);
+}
+
+void WriteUInt(ofstream& fOut, unsigned int value)
+{
+	WriteUShort(fOut, (unsigned short)value);
+	WriteUShort(fOut, (unsigned short)(value >> 16));
+}
\ No newline at end of file
@@ -36,8 +36,8 @@ float4 main(PixelInputType input) : SV_TARGET
 	//Get the pixel color from the second texture
 	color2 = shaderTextures[1].Sample(SampleType, input.tex);
 
-	//Get the alpha value from the alpha map texture
-	alphaValue = shaderTextures[2].Sample(SampleType, input.tex);
+	//Get the alpha value from the red channel of the alpha map so it can be stored as a single channel BC4 texture
+	alphaValue = shaderTextures[2].Sample(SampleType, input.tex).rrrr;
 
 	//Combine the two textures based on the alpha value
 	blendColor = (alphaValue * color1) + ((1.0 - alphaValue) * color2);
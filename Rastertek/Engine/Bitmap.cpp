@@ -8,6 +8,7 @@ Bitmap::Bitmap()
 {
 	this->m_vertexBuffer = nullptr;
 	this->m_indexBuffer = nullptr;
+	this->m_FrameMemory = nullptr;
 }
 
 Bitmap::Bitmap(const Bitmap& other)
@@ -20,10 +21,17 @@ Bitmap::~Bitmap()
 }
 
 
-bool Bitmap::Initialize(ID3D11Device* device, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight)
+bool Bitmap::Initialize(ID3D11Device* device, FrameMemory* frameMemory, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight)
 {
 	bool result;
 
+	//The vertex arrays are built in the frame memory's scratch arenas
+	if (!frameMemory)
+	{
+		return false;
+	}
+	this->m_FrameMemory = frameMemory;
+
 	//Store the screen size
 	this->m_screenWidth = screenWidth;
 	this->m_screenHeight = screenHeight;
@@ -36,6 +44,9 @@ bool Bitmap::Initialize(ID3D11Device* device, int screenWidth, int screenHeight,
 	this->m_previousPosX = -1;
 	this->m_previousPosY = -1;
 
+	//Draw the whole texture until a sub rectangle of an atlas is set
+	this->m_textureRect = D3DXVECTOR4(0.0f, 0.0f, 1.0f, 1.0f);
+
 	//Initialize the vertex and index buffers.
 	result = Bitmap::InitializeBuffers(device);
 	if (!result)
@@ -69,6 +80,30 @@ bool Bitmap::Render(ID3D11DeviceContext* deviceContext, int positionX, int posit
 	return true;
 }
 
+bool Bitmap::Render(SpriteBatch* spriteBatch, ID3D11ShaderResourceView* texture, int positionX, int positionY)
+{
+	bool result;
+
+	//Queue the bitmap into the sprite batch rather than rebuilding its own vertex buffer, so bitmaps sharing a texture are drawn together
+	result = spriteBatch->Draw(texture, (float)positionX, (float)positionY, (float)this->m_bitmapWidth, (float)this->m_bitmapHeight, this->m_textureRect, D3DXCOLOR(1.0f, 1.0f, 1.0f, 1.0f), 0.0f);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void Bitmap::SetTextureRect(D3DXVECTOR4 textureRect)
+{
+	//Store the left, top, right and bottom texture coordinates of the region of the texture to draw, such as an image packed into an atlas
+	this->m_textureRect = textureRect;
+
+	//Force the vertex buffer to be rebuilt on the next render
+	this->m_previousPosX = -1;
+	this->m_previousPosY = -1;
+}
+
 UINT Bitmap::GetIndexCount()
 {
 	return this->m_indexCount;
@@ -80,6 +115,9 @@ bool Bitmap::InitializeBuffers(ID3D11Device* device)
 	VertexType* vertices;
 	UINT* indices;
 
+	//The arrays only live until the buffers are made, so they come from the scratch arena and go back when this returns
+	ScratchScope scratch(this->m_FrameMemory);
+
 	//Set the number of vertices in the vertex array
 	this->m_vertexCount = 6;
 
@@ -87,14 +125,14 @@ bool Bitmap::InitializeBuffers(ID3D11Device* device)
 	this->m_indexCount = this->m_vertexCount;
 
 	//Create the vertex array
-	vertices = new VertexType[this->m_vertexCount];
+	vertices = (VertexType*)scratch.Allocate(sizeof(VertexType) * this->m_vertexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!vertices)
 	{
 		return false;
 	}
 
 	//Create the index array
-	indices = new UINT[this->m_indexCount];
+	indices = (UINT*)scratch.Allocate(sizeof(UINT) * this->m_indexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!indices)
 	{
 		return false;
@@ -158,12 +196,6 @@ bool Bitmap::InitializeBuffers(ID3D11Device* device)
 	{
 		return false;
 	}
-	
-	delete[] vertices;
-	vertices = nullptr;
-
-	delete[] indices;
-	indices = nullptr;
 
 	return true;
 }
@@ -217,8 +249,9 @@ bool Bitmap::UpdateBuffers(ID3D11DeviceContext* deviceContext, int positionX, in
 	//Calculate the screen coordinates of the bottom of the bitmap
 	bottom = top - (float)this->m_bitmapHeight;
 
-	//Create the vertex array
-	vertices = new VertexType[this->m_vertexCount];
+	//Create the vertex array on the scratch arena, this runs every time the bitmap moves. It goes back when this returns
+	ScratchScope scratch(this->m_FrameMemory);
+	vertices = (VertexType*)scratch.Allocate(sizeof(VertexType) * this->m_vertexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!vertices)
 	{
 		return false;
@@ -227,23 +260,23 @@ bool Bitmap::UpdateBuffers(ID3D11DeviceContext* deviceContext, int positionX, in
 	//Load the vertex array with data
 	//First triangle
 	vertices[0].position = D3DXVECTOR3(left, top, 0.0f);//Top Left
-	vertices[0].texture = D3DXVECTOR2(0.0f, 0.0f);
+	vertices[0].texture = D3DXVECTOR2(this->m_textureRect.x, this->m_textureRect.y);
 
 	vertices[1].position = D3DXVECTOR3(right, bottom, 0.0f);//Bottom Right
-	vertices[1].texture = D3DXVECTOR2(1.0f, 1.0f);
+	vertices[1].texture = D3DXVECTOR2(this->m_textureRect.z, this->m_textureRect.w);
 
 	vertices[2].position = D3DXVECTOR3(left, bottom, 0.0f);//Bottom Left
-	vertices[2].texture = D3DXVECTOR2(0.0f, 1.0f);
+	vertices[2].texture = D3DXVECTOR2(this->m_textureRect.x, this->m_textureRect.w);
 
 	//Second triangle
 	vertices[3].position = D3DXVECTOR3(left, top, 0.0f);//Top Left
-	vertices[3].texture = D3DXVECTOR2(0.0f, 0.0f);
+	vertices[3].texture = D3DXVECTOR2(this->m_textureRect.x, this->m_textureRect.y);
 
 	vertices[4].position = D3DXVECTOR3(right, top, 0.0f);//Top Right
-	vertices[4].texture = D3DXVECTOR2(1.0f, 0.0f);
+	vertices[4].texture = D3DXVECTOR2(this->m_textureRect.z, this->m_textureRect.y);
 
 	vertices[5].position = D3DXVECTOR3(right, bottom, 0.0f);//Bottom Right
-	vertices[5].texture = D3DXVECTOR2(1.0f, 1.0f);
+	vertices[5].texture = D3DXVECTOR2(this->m_textureRect.z, this->m_textureRect.w);
 
 	//Lock the vertex buffer so it can be written to
 	D3D11_MAPPED_SUBRESOURCE mappedSubresource;
@@ -259,10 +292,6 @@ bool Bitmap::UpdateBuffers(ID3D11DeviceContext* deviceContext, int positionX, in
 	//Unlock the vertex buffer
 	deviceContext->Unmap(this->m_vertexBuffer, 0);
 
-	//Release the vertex array as it is no longer needed
-	delete[] vertices;
-	vertices = nullptr;
-
 	return true;
 }
 
@@ -10,6 +10,12 @@
 #include <d3d11.h>
 #include <d3dx10math.h>
 
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "SpriteBatch.h"
+#include "FrameMemory.h"
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Bitmap
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +30,7 @@ private:
 
 	ID3D11Buffer* m_vertexBuffer;
 	ID3D11Buffer* m_indexBuffer;
+	FrameMemory* m_FrameMemory;
 	UINT m_vertexCount;
 	UINT m_indexCount;
 	int m_screenWidth;
@@ -32,16 +39,19 @@ private:
 	int m_bitmapHeight;
 	int m_previousPosX;
 	int m_previousPosY;
+	D3DXVECTOR4 m_textureRect;
 
 public:
 	Bitmap();
 	Bitmap(const Bitmap& other);
 	~Bitmap();
 
-	bool Initialize(ID3D11Device* device, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight);
+	bool Initialize(ID3D11Device* device, FrameMemory* frameMemory, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight);
 	void Shutdown();
 	bool Render(ID3D11DeviceContext* deviceContext, int positionX, int positionY);
+	bool Render(SpriteBatch* spriteBatch, ID3D11ShaderResourceView* texture, int positionX, int positionY);
 
+	void SetTextureRect(D3DXVECTOR4 textureRect);
 	UINT GetIndexCount();
 
 private:
@@ -48,6 +48,9 @@ float4 main(PixelInputType input) : SV_TARGET
 	//Expand the range of the normal value from (0, +1) to (-1, +1)
 	bumpMap = (bumpMap * 2.0f) - 1.0f;
 
+	//Rebuild Z from X and Y so BC5 normal maps, which only store two channels, light the same
+	bumpMap.z = sqrt(saturate(1.0f - dot(bumpMap.xy, bumpMap.xy)));
+
     	// Calculate the normal from the data in the bump map.
 	bumpNormal = (bumpMap.x * input.tangent) + (bumpMap.y * input.binormal) + (bumpMap.z * input.normal);
 
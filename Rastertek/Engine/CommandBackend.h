@@ -0,0 +1,21 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: CommandBackend.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _COMMANDBACKEND_H_
+#define _COMMANDBACKEND_H_
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: CommandBackend
+////////////////////////////////////////////////////////////////////////////////
+
+//Turns recorded packets into calls on a device, Graphics draws them with Direct3D and a headless run can just count them
+class CommandBackend
+{
+public:
+	virtual ~CommandBackend() {}
+
+	//The data is the struct the type names, it stays valid until the recorder is reset
+	virtual bool Execute(unsigned int type, const void* data) = 0;
+};
+
+#endif
\ No newline at end of file
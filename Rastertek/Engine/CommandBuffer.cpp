@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: CommandBuffer.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "CommandBuffer.h"
+
+
+CommandBuffer::CommandBuffer()
+{
+	this->m_data = nullptr;
+	this->m_size = 0;
+	this->m_capacity = 0;
+	this->m_packetCount = 0;
+}
+
+CommandBuffer::CommandBuffer(const CommandBuffer& other)
+{
+}
+
+
+CommandBuffer::~CommandBuffer()
+{
+}
+
+bool CommandBuffer::Initialize(unsigned int capacity)
+{
+	this->m_data = new unsigned char[capacity];
+	if (!this->m_data)
+	{
+		return false;
+	}
+
+	this->m_capacity = capacity;
+	CommandBuffer::Reset();
+
+	return true;
+}
+
+void CommandBuffer::Shutdown()
+{
+	if (this->m_data)
+	{
+		delete[] this->m_data;
+		this->m_data = nullptr;
+	}
+	this->m_capacity = 0;
+	this->m_size = 0;
+	this->m_packetCount = 0;
+}
+
+void CommandBuffer::Reset()
+{
+	//The memory stays, the next frame writes over it from the start
+	this->m_size = 0;
+	this->m_packetCount = 0;
+}
+
+bool CommandBuffer::Write(unsigned long long sortKey, unsigned int type, const void* data, unsigned int size)
+{
+	PacketType* packet;
+	unsigned int packetSize;
+
+	//Full, the recorder carries on in another buffer
+	packetSize = (sizeof(PacketType) + size + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
+	if (this->m_size + packetSize > this->m_capacity)
+	{
+		return false;
+	}
+
+	packet = (PacketType*)(this->m_data + this->m_size);
+	packet->sortKey = sortKey;
+	packet->type = type;
+	packet->size = packetSize;
+	memcpy(packet + 1, data, size);
+
+	this->m_size += packetSize;
+	this->m_packetCount++;
+
+	return true;
+}
+
+unsigned char* CommandBuffer::GetData()
+{
+	return this->m_data;
+}
+
+unsigned int CommandBuffer::GetSize()
+{
+	return this->m_size;
+}
+
+unsigned int CommandBuffer::GetPacketCount()
+{
+	return this->m_packetCount;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: CommandBuffer.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _COMMANDBUFFER_H_
+#define _COMMANDBUFFER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <cstring>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Packet types, the data after each header is the matching struct below
+const unsigned int COMMAND_DRAW = 1;
+
+//Bytes in a buffer, a thread that fills one takes another from its recorder
+const unsigned int COMMAND_BUFFER_SIZE = 64 * 1024;
+
+//Every packet starts on this many bytes so the data can be read in place
+const unsigned int COMMAND_ALIGNMENT = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: CommandBuffer
+////////////////////////////////////////////////////////////////////////////////
+
+//Packets written one after another into one block of memory by one thread, nothing in them is tied to a device
+//The block never grows, so a packet stays where it was written until the buffer is reset
+class CommandBuffer
+{
+public:
+	struct PacketType
+	{
+		unsigned long long sortKey;
+		unsigned int type;
+		unsigned int size;
+	};
+
+	//Model and shader are whatever the backend numbers them by, the world matrix is row major with the translation in the last row
+	struct DrawCommandType
+	{
+		int model;
+		int shader;
+		float world[16];
+	};
+
+private:
+	unsigned char* m_data;
+	unsigned int m_size;
+	unsigned int m_capacity;
+	unsigned int m_packetCount;
+
+public:
+	CommandBuffer();
+	CommandBuffer(const CommandBuffer& other);
+	~CommandBuffer();
+
+	bool Initialize(unsigned int capacity);
+	void Shutdown();
+	void Reset();
+
+	bool Write(unsigned long long sortKey, unsigned int type, const void* data, unsigned int size);
+
+	unsigned char* GetData();
+	unsigned int GetSize();
+	unsigned int GetPacketCount();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,273 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: CommandRecorder.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "CommandRecorder.h"
+
+
+CommandRecorder::CommandRecorder()
+{
+	this->m_Jobs = nullptr;
+	this->m_usedCount = 0;
+	this->m_current = nullptr;
+	this->m_threadCount = 0;
+}
+
+CommandRecorder::CommandRecorder(const CommandRecorder& other)
+{
+}
+
+
+CommandRecorder::~CommandRecorder()
+{
+}
+
+bool CommandRecorder::Initialize(JobSystem* jobs)
+{
+	int i;
+
+	if (!jobs)
+	{
+		return false;
+	}
+	this->m_Jobs = jobs;
+
+	//The buffer each job thread is writing to, the last is shared by the threads outside the job system
+	this->m_threadCount = jobs->GetThreadSlotCount();
+	this->m_current = new CommandBuffer*[this->m_threadCount];
+	if (!this->m_current)
+	{
+		return false;
+	}
+
+	for (i = 0; i < this->m_threadCount; i++)
+	{
+		this->m_current[i] = nullptr;
+	}
+	this->m_usedCount = 0;
+
+	return true;
+}
+
+void CommandRecorder::Shutdown()
+{
+	size_t i;
+
+	for (i = 0; i < this->m_buffers.size(); i++)
+	{
+		this->m_buffers[i]->Shutdown();
+		delete this->m_buffers[i];
+	}
+	this->m_buffers.clear();
+	this->m_usedCount = 0;
+
+	if (this->m_current)
+	{
+		delete[] this->m_current;
+		this->m_current = nullptr;
+	}
+	this->m_threadCount = 0;
+	this->m_Jobs = nullptr;
+}
+
+void CommandRecorder::Reset()
+{
+	unsigned int i;
+	int j;
+
+	//Every buffer goes back to the pool with its memory
+	for (i = 0; i < this->m_usedCount; i++)
+	{
+		this->m_buffers[i]->Reset();
+	}
+	this->m_usedCount = 0;
+
+	for (j = 0; j < this->m_threadCount; j++)
+	{
+		this->m_current[j] = nullptr;
+	}
+	this->m_sorted.clear();
+}
+
+bool CommandRecorder::Record(unsigned long long sortKey, unsigned int type, const void* data, unsigned int size)
+{
+	CommandBuffer* buffer;
+	int index;
+
+	//A job thread writes to its own buffer, the threads outside the job system take turns on the last one
+	index = this->m_Jobs->GetThreadIndex();
+	unique_lock<mutex> lock(this->m_sharedMutex, defer_lock);
+	if (index == this->m_threadCount - 1)
+	{
+		lock.lock();
+	}
+
+	buffer = this->m_current[index];
+	if (buffer && buffer->Write(sortKey, type, data, size))
+	{
+		return true;
+	}
+
+	buffer = CommandRecorder::NextBuffer();
+	if (!buffer)
+	{
+		return false;
+	}
+	this->m_current[index] = buffer;
+
+	return buffer->Write(sortKey, type, data, size);
+}
+
+void CommandRecorder::Sort()
+{
+	PROFILE_SCOPE("CommandRecorder::Sort");
+
+	CommandBuffer::PacketType* packet;
+	unsigned int count;
+	unsigned int offset;
+	unsigned int i;
+	unsigned int j;
+
+	count = CommandRecorder::GetPacketCount();
+	this->m_sorted.resize(count);
+
+	//Gather a key and where to find it for every packet, the packets themselves stay where they were written
+	i = 0;
+	for (j = 0; j < this->m_usedCount; j++)
+	{
+		for (offset = 0; offset < this->m_buffers[j]->GetSize(); offset += packet->size)
+		{
+			packet = (CommandBuffer::PacketType*)(this->m_buffers[j]->GetData() + offset);
+			this->m_sorted[i].sortKey = packet->sortKey;
+			this->m_sorted[i].buffer = j;
+			this->m_sorted[i].offset = offset;
+			i++;
+		}
+	}
+
+	CommandRecorder::RadixSort();
+}
+
+bool CommandRecorder::Replay(CommandBackend* backend)
+{
+	PROFILE_SCOPE("CommandRecorder::Replay");
+
+	CommandBuffer::PacketType* packet;
+	bool result;
+	size_t i;
+
+	for (i = 0; i < this->m_sorted.size(); i++)
+	{
+		packet = (CommandBuffer::PacketType*)(this->m_buffers[this->m_sorted[i].buffer]->GetData() + this->m_sorted[i].offset);
+		result = backend->Execute(packet->type, packet + 1);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+unsigned int CommandRecorder::GetPacketCount()
+{
+	unsigned int count;
+	unsigned int i;
+
+	count = 0;
+	for (i = 0; i < this->m_usedCount; i++)
+	{
+		count += this->m_buffers[i]->GetPacketCount();
+	}
+
+	return count;
+}
+
+unsigned int CommandRecorder::GetBufferCount()
+{
+	return (unsigned int)this->m_buffers.size();
+}
+
+CommandBuffer* CommandRecorder::NextBuffer()
+{
+	CommandBuffer* buffer;
+	bool result;
+
+	lock_guard<mutex> lock(this->m_bufferMutex);
+
+	//A buffer from the pool if one is left, a new one only while the pool is still growing to what a frame needs
+	if (this->m_usedCount < this->m_buffers.size())
+	{
+		return this->m_buffers[this->m_usedCount++];
+	}
+
+	buffer = new CommandBuffer();
+	if (!buffer)
+	{
+		return nullptr;
+	}
+
+	result = buffer->Initialize(COMMAND_BUFFER_SIZE);
+	if (!result)
+	{
+		delete buffer;
+		return nullptr;
+	}
+
+	this->m_buffers.push_back(buffer);
+	this->m_usedCount++;
+
+	return buffer;
+}
+
+void CommandRecorder::RadixSort()
+{
+	unsigned int counts[8][256];
+	unsigned int total;
+	unsigned int next;
+	unsigned int digit;
+	size_t count;
+	size_t i;
+	int pass;
+	int j;
+
+	count = this->m_sorted.size();
+	if (count < 2)
+	{
+		return;
+	}
+	this->m_scratch.resize(count);
+
+	//Every byte of the key counted in one go, a byte that is the same in every key needs no pass
+	memset(counts, 0, sizeof(counts));
+	for (i = 0; i < count; i++)
+	{
+		for (pass = 0; pass < 8; pass++)
+		{
+			counts[pass][(this->m_sorted[i].sortKey >> (pass * 8)) & 0xFF]++;
+		}
+	}
+
+	//Least significant byte first, each pass keeps the order of the last so ties stay in recording order within a buffer
+	for (pass = 0; pass < 8; pass++)
+	{
+		if (counts[pass][(this->m_sorted[0].sortKey >> (pass * 8)) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		total = 0;
+		for (j = 0; j < 256; j++)
+		{
+			next = total + counts[pass][j];
+			counts[pass][j] = total;
+			total = next;
+		}
+
+		for (i = 0; i < count; i++)
+		{
+			digit = (unsigned int)(this->m_sorted[i].sortKey >> (pass * 8)) & 0xFF;
+			this->m_scratch[counts[pass][digit]++] = this->m_sorted[i];
+		}
+		this->m_sorted.swap(this->m_scratch);
+	}
+}
\ No newline at end of file
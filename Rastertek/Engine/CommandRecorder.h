@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: CommandRecorder.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _COMMANDRECORDER_H_
+#define _COMMANDRECORDER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <mutex>
+#include <vector>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "CommandBuffer.h"
+#include "CommandBackend.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: CommandRecorder
+////////////////////////////////////////////////////////////////////////////////
+
+//Each job thread records into a command buffer of its own so recording takes no lock, the packets are put in key order after and replayed on one thread
+//Full buffers are swapped for others from a pool that is kept from frame to frame, so once it is big enough recording allocates nothing
+class CommandRecorder
+{
+private:
+	struct SortType
+	{
+		unsigned long long sortKey;
+		unsigned int buffer;
+		unsigned int offset;
+	};
+
+	JobSystem* m_Jobs;
+	vector<CommandBuffer*> m_buffers;
+	unsigned int m_usedCount;
+	mutex m_bufferMutex;
+	CommandBuffer** m_current;
+	int m_threadCount;
+	mutex m_sharedMutex;
+	vector<SortType> m_sorted;
+	vector<SortType> m_scratch;
+
+public:
+	CommandRecorder();
+	CommandRecorder(const CommandRecorder& other);
+	~CommandRecorder();
+
+	bool Initialize(JobSystem* jobs);
+	void Shutdown();
+	void Reset();
+
+	bool Record(unsigned long long sortKey, unsigned int type, const void* data, unsigned int size);
+
+	//Both run once every recording job has finished
+	void Sort();
+	bool Replay(CommandBackend* backend);
+
+	unsigned int GetPacketCount();
+	unsigned int GetBufferCount();
+
+private:
+	CommandBuffer* NextBuffer();
+	void RadixSort();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,666 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: DdsFile.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "DdsFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define DDS_MAGIC 0x20534444
+#define DDS_FOURCC(a, b, c, d) ((unsigned int)(a) | ((unsigned int)(b) << 8) | ((unsigned int)(c) << 16) | ((unsigned int)(d) << 24))
+
+#define DDSD_MIPMAPCOUNT 0x20000
+#define DDPF_ALPHAPIXELS 0x1
+#define DDPF_ALPHA 0x2
+#define DDPF_FOURCC 0x4
+#define DDPF_RGB 0x40
+#define DDPF_LUMINANCE 0x20000
+#define DDSCAPS2_CUBEMAP 0x200
+#define DDSCAPS2_VOLUME 0x200000
+#define DDS_DIMENSION_TEXTURE2D 3
+#define DDS_RESOURCE_MISC_TEXTURECUBE 0x4
+
+
+DdsFile::DdsFile()
+{
+	this->m_data = nullptr;
+	this->m_size = 0;
+	this->m_mapped = false;
+	this->m_fileHandle = nullptr;
+	this->m_mappingHandle = nullptr;
+	this->m_fileDescriptor = -1;
+
+	this->m_width = 0;
+	this->m_height = 0;
+	this->m_mipCount = 0;
+	this->m_arraySize = 0;
+	this->m_format = DDS_FORMAT_UNKNOWN;
+	this->m_cubeMap = false;
+	this->m_alpha = false;
+	this->m_surfaces = nullptr;
+}
+
+DdsFile::DdsFile(const DdsFile& other)
+{
+}
+
+
+DdsFile::~DdsFile()
+{
+}
+
+bool DdsFile::Initialize(const char* fileName)
+{
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+	LARGE_INTEGER fileSize;
+
+	//Open the file and map all of it into memory, the surfaces are then read straight out of the mapping
+	file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	this->m_fileHandle = file;
+
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+	this->m_size = (size_t)fileSize.QuadPart;
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+	this->m_mappingHandle = mapping;
+
+	this->m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!this->m_data)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+#else
+	struct stat fileStat;
+	void* view;
+
+	//Open the file and map all of it into memory, the surfaces are then read straight out of the mapping
+	this->m_fileDescriptor = open(fileName, O_RDONLY);
+	if (this->m_fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	if (fstat(this->m_fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+	this->m_size = (size_t)fileStat.st_size;
+
+	view = mmap(nullptr, this->m_size, PROT_READ, MAP_PRIVATE, this->m_fileDescriptor, 0);
+	if (view == MAP_FAILED)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+	this->m_data = (const unsigned char*)view;
+#endif
+	this->m_mapped = true;
+
+	//Read the headers and lay out the surfaces
+	if (!DdsFile::Parse())
+	{
+		DdsFile::Shutdown();
+		return false;
+	}
+
+	return true;
+}
+
+#ifdef _WIN32
+bool DdsFile::Initialize(const wchar_t* fileName)
+{
+	HANDLE file;
+	HANDLE mapping;
+	LARGE_INTEGER fileSize;
+
+	//Open the file and map all of it into memory, the surfaces are then read straight out of the mapping
+	file = CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	this->m_fileHandle = file;
+
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+	this->m_size = (size_t)fileSize.QuadPart;
+
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+	this->m_mappingHandle = mapping;
+
+	this->m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!this->m_data)
+	{
+		DdsFile::Unmap();
+		return false;
+	}
+	this->m_mapped = true;
+
+	//Read the headers and lay out the surfaces
+	if (!DdsFile::Parse())
+	{
+		DdsFile::Shutdown();
+		return false;
+	}
+
+	return true;
+}
+#endif
+
+bool DdsFile::Initialize(const void* data, size_t size)
+{
+	//Parse a file that is already in memory, it has to stay valid for as long as the surfaces are used
+	this->m_data = (const unsigned char*)data;
+	this->m_size = size;
+	this->m_mapped = false;
+
+	if (!DdsFile::Parse())
+	{
+		DdsFile::Shutdown();
+		return false;
+	}
+
+	return true;
+}
+
+void DdsFile::Shutdown()
+{
+	//Release the surface table
+	if (this->m_surfaces)
+	{
+		delete[] this->m_surfaces;
+		this->m_surfaces = nullptr;
+	}
+
+	//Release the file mapping
+	DdsFile::Unmap();
+}
+
+unsigned int DdsFile::GetWidth()
+{
+	return this->m_width;
+}
+
+unsigned int DdsFile::GetHeight()
+{
+	return this->m_height;
+}
+
+unsigned int DdsFile::GetMipCount()
+{
+	return this->m_mipCount;
+}
+
+unsigned int DdsFile::GetArraySize()
+{
+	return this->m_arraySize;
+}
+
+unsigned int DdsFile::GetFormat()
+{
+	return this->m_format;
+}
+
+bool DdsFile::IsCubeMap()
+{
+	return this->m_cubeMap;
+}
+
+bool DdsFile::HasAlpha()
+{
+	return this->m_alpha;
+}
+
+bool DdsFile::IsBlockCompressed()
+{
+	return DdsFile::GetBlockSize(this->m_format) != 0;
+}
+
+size_t DdsFile::GetDataSize()
+{
+	return this->m_size;
+}
+
+bool DdsFile::GetSurface(unsigned int arrayIndex, unsigned int mip, const void*& data, unsigned int& rowPitch, unsigned int& slicePitch, unsigned int& width, unsigned int& height)
+{
+	SurfaceType* surface;
+
+	if (arrayIndex >= this->m_arraySize || mip >= this->m_mipCount)
+	{
+		return false;
+	}
+
+	//The surfaces are stored slice by slice, each with its full mip chain
+	surface = &this->m_surfaces[(arrayIndex * this->m_mipCount) + mip];
+	data = this->m_data + surface->offset;
+	rowPitch = surface->rowPitch;
+	slicePitch = surface->slicePitch;
+	width = surface->width;
+	height = surface->height;
+
+	return true;
+}
+
+bool DdsFile::GetSurfaceRgba(unsigned int arrayIndex, unsigned int mip, unsigned char* texels)
+{
+	const void* data;
+	const unsigned char* row;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+	bool swap;
+
+	//Only the 8 bit per channel formats are converted, the tools read their sources through this
+	if (this->m_format != DDS_FORMAT_R8G8B8A8_UNORM && this->m_format != DDS_FORMAT_B8G8R8A8_UNORM && this->m_format != DDS_FORMAT_B8G8R8X8_UNORM)
+	{
+		return false;
+	}
+
+	if (!DdsFile::GetSurface(arrayIndex, mip, data, rowPitch, slicePitch, width, height))
+	{
+		return false;
+	}
+
+	//Copy the surface out as R, G, B, A bytes with no row padding. Textures without an alpha channel are opaque
+	swap = (this->m_format != DDS_FORMAT_R8G8B8A8_UNORM);
+	for (unsigned int y = 0; y < height; y++)
+	{
+		row = (const unsigned char*)data + ((size_t)y * rowPitch);
+		for (unsigned int x = 0; x < width; x++)
+		{
+			texels[0] = row[swap ? 2 : 0];
+			texels[1] = row[1];
+			texels[2] = row[swap ? 0 : 2];
+			texels[3] = this->m_alpha ? row[3] : 0xFF;
+			row += 4;
+			texels += 4;
+		}
+	}
+
+	return true;
+}
+
+bool DdsFile::Parse()
+{
+	HeaderType header;
+	HeaderDx10Type headerDx10;
+	size_t offset;
+	unsigned int magic;
+	unsigned int bitsPerPixel;
+	unsigned int blockSize;
+	unsigned int width;
+	unsigned int height;
+	unsigned int rows;
+	unsigned int largest;
+	unsigned int mipLimit;
+	unsigned long long surfaceSize;
+	SurfaceType* surface;
+
+	//The file starts with the magic number and the header
+	if (this->m_size < sizeof(unsigned int) + sizeof(HeaderType))
+	{
+		return false;
+	}
+	memcpy(&magic, this->m_data, sizeof(unsigned int));
+	memcpy(&header, this->m_data + sizeof(unsigned int), sizeof(HeaderType));
+	offset = sizeof(unsigned int) + sizeof(HeaderType);
+
+	if (magic != DDS_MAGIC || header.size != sizeof(HeaderType) || header.pixelFormat.size != sizeof(PixelFormatType))
+	{
+		return false;
+	}
+
+	this->m_width = header.width;
+	this->m_height = header.height;
+	this->m_mipCount = (header.flags & DDSD_MIPMAPCOUNT) ? header.mipMapCount : 1;
+	if (this->m_mipCount == 0)
+	{
+		this->m_mipCount = 1;
+	}
+	this->m_arraySize = 1;
+	this->m_cubeMap = false;
+
+	//The DX10 extension header follows when the four character code says so, it holds the format directly
+	if ((header.pixelFormat.flags & DDPF_FOURCC) && header.pixelFormat.fourCC == DDS_FOURCC('D', 'X', '1', '0'))
+	{
+		if (this->m_size < offset + sizeof(HeaderDx10Type))
+		{
+			return false;
+		}
+		memcpy(&headerDx10, this->m_data + offset, sizeof(HeaderDx10Type));
+		offset += sizeof(HeaderDx10Type);
+
+		//Only 2D textures, arrays of them and cube maps are supported
+		if (headerDx10.resourceDimension != DDS_DIMENSION_TEXTURE2D || headerDx10.arraySize == 0 || headerDx10.arraySize > DDS_MAX_ARRAY_SIZE)
+		{
+			return false;
+		}
+
+		this->m_format = headerDx10.dxgiFormat;
+		this->m_alpha = (this->m_format != DDS_FORMAT_B8G8R8X8_UNORM);
+		this->m_arraySize = headerDx10.arraySize;
+		if (headerDx10.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE)
+		{
+			this->m_cubeMap = true;
+			this->m_arraySize *= 6;
+		}
+	}
+	else
+	{
+		//Volume textures are not supported
+		if (header.caps2 & DDSCAPS2_VOLUME)
+		{
+			return false;
+		}
+
+		this->m_format = DdsFile::GetFormatFromPixelFormat(header.pixelFormat);
+
+		//X8B8G8R8 loads as R8G8B8A8, only the pixel format flags tell whether the fourth channel holds alpha
+		this->m_alpha = (header.pixelFormat.flags & (DDPF_FOURCC | DDPF_ALPHAPIXELS | DDPF_ALPHA)) != 0;
+
+		//Legacy cube maps have to hold all six faces
+		if (header.caps2 & DDSCAPS2_CUBEMAP)
+		{
+			if ((header.caps2 & 0xFC00) != 0xFC00)
+			{
+				return false;
+			}
+			this->m_cubeMap = true;
+			this->m_arraySize = 6;
+		}
+	}
+
+	//Sizes past what Direct3D can create would also overflow the pitches worked out below
+	if (this->m_format == DDS_FORMAT_UNKNOWN || this->m_width == 0 || this->m_height == 0 || this->m_width > DDS_MAX_SIZE || this->m_height > DDS_MAX_SIZE || this->m_arraySize > DDS_MAX_ARRAY_SIZE)
+	{
+		return false;
+	}
+
+	//A chain can not go on past the 1x1 level
+	largest = (this->m_width > this->m_height) ? this->m_width : this->m_height;
+	mipLimit = 1;
+	while (largest > 1)
+	{
+		largest /= 2;
+		mipLimit++;
+	}
+	if (this->m_mipCount > mipLimit)
+	{
+		return false;
+	}
+
+	blockSize = DdsFile::GetBlockSize(this->m_format);
+	bitsPerPixel = DdsFile::GetBitsPerPixel(this->m_format);
+	if (blockSize == 0 && bitsPerPixel == 0)
+	{
+		return false;
+	}
+
+	//Create the surface table
+	this->m_surfaces = new SurfaceType[this->m_arraySize * this->m_mipCount];
+	if (!this->m_surfaces)
+	{
+		return false;
+	}
+
+	//Walk the surfaces in file order working out where each one starts and how it is pitched
+	for (unsigned int i = 0; i < this->m_arraySize; i++)
+	{
+		width = this->m_width;
+		height = this->m_height;
+		for (unsigned int mip = 0; mip < this->m_mipCount; mip++)
+		{
+			surface = &this->m_surfaces[(i * this->m_mipCount) + mip];
+			surface->offset = offset;
+			surface->width = width;
+			surface->height = height;
+
+			//Block compressed surfaces are stored as rows of 4x4 blocks, even when the mip is smaller than a block
+			if (blockSize != 0)
+			{
+				surface->rowPitch = ((width + 3) / 4) * blockSize;
+				rows = (height + 3) / 4;
+			}
+			else
+			{
+				surface->rowPitch = ((width * bitsPerPixel) + 7) / 8;
+				rows = height;
+			}
+
+			//The whole surface has to be inside the file and fit the pitch Direct3D takes, the top level of a 16384 square 128 bit texture is 4GB
+			surfaceSize = (unsigned long long)surface->rowPitch * rows;
+			if (surfaceSize > 0xFFFFFFFF || surfaceSize > this->m_size - offset)
+			{
+				return false;
+			}
+			surface->slicePitch = (unsigned int)surfaceSize;
+
+			offset += surface->slicePitch;
+
+			width = (width > 1) ? (width / 2) : 1;
+			height = (height > 1) ? (height / 2) : 1;
+		}
+	}
+
+	return true;
+}
+
+unsigned int DdsFile::GetFormatFromPixelFormat(const PixelFormatType& pixelFormat)
+{
+	//Four character codes, including the D3DFORMAT numbers some tools write for floating point formats
+	if (pixelFormat.flags & DDPF_FOURCC)
+	{
+		switch (pixelFormat.fourCC)
+		{
+		case DDS_FOURCC('D', 'X', 'T', '1'):
+			return DDS_FORMAT_BC1_UNORM;
+		case DDS_FOURCC('D', 'X', 'T', '2'):
+		case DDS_FOURCC('D', 'X', 'T', '3'):
+			return DDS_FORMAT_BC2_UNORM;
+		case DDS_FOURCC('D', 'X', 'T', '4'):
+		case DDS_FOURCC('D', 'X', 'T', '5'):
+			return DDS_FORMAT_BC3_UNORM;
+		case DDS_FOURCC('A', 'T', 'I', '1'):
+		case DDS_FOURCC('B', 'C', '4', 'U'):
+			return DDS_FORMAT_BC4_UNORM;
+		case DDS_FOURCC('B', 'C', '4', 'S'):
+			return DDS_FORMAT_BC4_SNORM;
+		case DDS_FOURCC('A', 'T', 'I', '2'):
+		case DDS_FOURCC('B', 'C', '5', 'U'):
+			return DDS_FORMAT_BC5_UNORM;
+		case DDS_FOURCC('B', 'C', '5', 'S'):
+			return DDS_FORMAT_BC5_SNORM;
+		case 36:
+			return DDS_FORMAT_R16G16B16A16_UNORM;
+		case 111:
+			return DDS_FORMAT_R16_FLOAT;
+		case 112:
+			return DDS_FORMAT_R16G16_FLOAT;
+		case 113:
+			return DDS_FORMAT_R16G16B16A16_FLOAT;
+		case 114:
+			return DDS_FORMAT_R32_FLOAT;
+		case 115:
+			return DDS_FORMAT_R32G32_FLOAT;
+		case 116:
+			return DDS_FORMAT_R32G32B32A32_FLOAT;
+		default:
+			return DDS_FORMAT_UNKNOWN;
+		}
+	}
+
+	//Uncompressed formats are recognised by their channel masks
+	if (pixelFormat.flags & DDPF_RGB)
+	{
+		switch (pixelFormat.rgbBitCount)
+		{
+		case 32:
+			if (pixelFormat.redBitMask == 0x00FF0000 && pixelFormat.greenBitMask == 0x0000FF00 && pixelFormat.blueBitMask == 0x000000FF)
+			{
+				return (pixelFormat.flags & DDPF_ALPHAPIXELS) ? DDS_FORMAT_B8G8R8A8_UNORM : DDS_FORMAT_B8G8R8X8_UNORM;
+			}
+			//There is no DXGI format for X8B8G8R8 so it is loaded as R8G8B8A8 and the shaders ignore the alpha
+			if (pixelFormat.redBitMask == 0x000000FF && pixelFormat.greenBitMask == 0x0000FF00 && pixelFormat.blueBitMask == 0x00FF0000)
+			{
+				return DDS_FORMAT_R8G8B8A8_UNORM;
+			}
+			if (pixelFormat.redBitMask == 0x000003FF && pixelFormat.greenBitMask == 0x000FFC00 && pixelFormat.blueBitMask == 0x3FF00000)
+			{
+				return DDS_FORMAT_R10G10B10A2_UNORM;
+			}
+			if (pixelFormat.redBitMask == 0x0000FFFF && pixelFormat.greenBitMask == 0xFFFF0000)
+			{
+				return DDS_FORMAT_R16G16_UNORM;
+			}
+			break;
+		case 16:
+			if (pixelFormat.redBitMask == 0xF800 && pixelFormat.greenBitMask == 0x07E0 && pixelFormat.blueBitMask == 0x001F)
+			{
+				return DDS_FORMAT_B5G6R5_UNORM;
+			}
+			if (pixelFormat.redBitMask == 0x7C00 && pixelFormat.greenBitMask == 0x03E0 && pixelFormat.blueBitMask == 0x001F)
+			{
+				return DDS_FORMAT_B5G5R5A1_UNORM;
+			}
+			if (pixelFormat.redBitMask == 0x0F00 && pixelFormat.greenBitMask == 0x00F0 && pixelFormat.blueBitMask == 0x000F)
+			{
+				return DDS_FORMAT_B4G4R4A4_UNORM;
+			}
+			break;
+		}
+		return DDS_FORMAT_UNKNOWN;
+	}
+
+	//Single channel formats
+	if (pixelFormat.flags & DDPF_LUMINANCE)
+	{
+		if (pixelFormat.rgbBitCount == 8)
+		{
+			return DDS_FORMAT_R8_UNORM;
+		}
+		if (pixelFormat.rgbBitCount == 16)
+		{
+			return (pixelFormat.flags & DDPF_ALPHAPIXELS) ? DDS_FORMAT_R8G8_UNORM : DDS_FORMAT_R16_UNORM;
+		}
+		return DDS_FORMAT_UNKNOWN;
+	}
+
+	if ((pixelFormat.flags & DDPF_ALPHA) && pixelFormat.rgbBitCount == 8)
+	{
+		return DDS_FORMAT_A8_UNORM;
+	}
+
+	return DDS_FORMAT_UNKNOWN;
+}
+
+unsigned int DdsFile::GetBitsPerPixel(unsigned int format)
+{
+	//Bits per texel of the uncompressed DXGI formats, by range of format values
+	if (format >= 1 && format <= 4)
+	{
+		return 128;
+	}
+	if (format >= 5 && format <= 8)
+	{
+		return 96;
+	}
+	if (format >= 9 && format <= 22)
+	{
+		return 64;
+	}
+	if ((format >= 23 && format <= 47) || format == 67 || (format >= 87 && format <= 93))
+	{
+		return 32;
+	}
+	if ((format >= 48 && format <= 59) || format == 85 || format == 86 || format == 115)
+	{
+		return 16;
+	}
+	if (format >= 60 && format <= 65)
+	{
+		return 8;
+	}
+
+	return 0;
+}
+
+unsigned int DdsFile::GetBlockSize(unsigned int format)
+{
+	//Bytes per 4x4 block of the block compressed formats. BC1 and BC4 use 8 bytes, the others 16
+	if ((format >= 70 && format <= 72) || (format >= 79 && format <= 81))
+	{
+		return 8;
+	}
+	if ((format >= 73 && format <= 78) || (format >= 82 && format <= 84) || (format >= 94 && format <= 99))
+	{
+		return 16;
+	}
+
+	return 0;
+}
+
+void DdsFile::Unmap()
+{
+	//Only files that were opened here are unmapped, data passed in by the caller belongs to the caller
+#ifdef _WIN32
+	if (this->m_mapped && this->m_data)
+	{
+		UnmapViewOfFile(this->m_data);
+	}
+	if (this->m_mappingHandle)
+	{
+		CloseHandle((HANDLE)this->m_mappingHandle);
+		this->m_mappingHandle = nullptr;
+	}
+	if (this->m_fileHandle)
+	{
+		CloseHandle((HANDLE)this->m_fileHandle);
+		this->m_fileHandle = nullptr;
+	}
+#else
+	if (this->m_mapped && this->m_data)
+	{
+		munmap((void*)this->m_data, this->m_size);
+	}
+	if (this->m_fileDescriptor >= 0)
+	{
+		close(this->m_fileDescriptor);
+		this->m_fileDescriptor = -1;
+	}
+#endif
+	this->m_data = nullptr;
+	this->m_size = 0;
+	this->m_mapped = false;
+}
\ No newline at end of file
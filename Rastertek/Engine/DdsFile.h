@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: DdsFile.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _DDSFILE_H_
+#define _DDSFILE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <cstddef>
+#include <cstring>
+
+/////////////
+// GLOBALS //
+/////////////
+
+//The formats are the DXGI_FORMAT values so the parser does not need the Direct3D headers
+const unsigned int DDS_FORMAT_UNKNOWN = 0;
+const unsigned int DDS_FORMAT_R16G16B16A16_FLOAT = 10;
+const unsigned int DDS_FORMAT_R16G16B16A16_UNORM = 11;
+const unsigned int DDS_FORMAT_R32G32B32A32_FLOAT = 2;
+const unsigned int DDS_FORMAT_R10G10B10A2_UNORM = 24;
+const unsigned int DDS_FORMAT_R8G8B8A8_UNORM = 28;
+const unsigned int DDS_FORMAT_R16G16_FLOAT = 34;
+const unsigned int DDS_FORMAT_R16G16_UNORM = 35;
+const unsigned int DDS_FORMAT_R32G32_FLOAT = 16;
+const unsigned int DDS_FORMAT_R32_FLOAT = 41;
+const unsigned int DDS_FORMAT_R8G8_UNORM = 49;
+const unsigned int DDS_FORMAT_R16_FLOAT = 54;
+const unsigned int DDS_FORMAT_R16_UNORM = 56;
+const unsigned int DDS_FORMAT_R8_UNORM = 61;
+const unsigned int DDS_FORMAT_A8_UNORM = 65;
+const unsigned int DDS_FORMAT_BC1_UNORM = 71;
+const unsigned int DDS_FORMAT_BC2_UNORM = 74;
+const unsigned int DDS_FORMAT_BC3_UNORM = 77;
+const unsigned int DDS_FORMAT_BC4_UNORM = 80;
+const unsigned int DDS_FORMAT_BC4_SNORM = 81;
+const unsigned int DDS_FORMAT_BC5_UNORM = 83;
+const unsigned int DDS_FORMAT_BC5_SNORM = 84;
+const unsigned int DDS_FORMAT_B5G6R5_UNORM = 85;
+const unsigned int DDS_FORMAT_B5G5R5A1_UNORM = 86;
+const unsigned int DDS_FORMAT_B8G8R8A8_UNORM = 87;
+const unsigned int DDS_FORMAT_B8G8R8X8_UNORM = 88;
+const unsigned int DDS_FORMAT_BC7_UNORM = 98;
+const unsigned int DDS_FORMAT_B4G4R4A4_UNORM = 115;
+
+//The largest texture and array Direct3D 11 can create, bigger headers are taken as broken
+const unsigned int DDS_MAX_SIZE = 16384;
+const unsigned int DDS_MAX_ARRAY_SIZE = 2048;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DdsFile
+////////////////////////////////////////////////////////////////////////////////
+class DdsFile
+{
+private:
+	struct PixelFormatType
+	{
+		unsigned int size;
+		unsigned int flags;
+		unsigned int fourCC;
+		unsigned int rgbBitCount;
+		unsigned int redBitMask;
+		unsigned int greenBitMask;
+		unsigned int blueBitMask;
+		unsigned int alphaBitMask;
+	};
+
+	struct HeaderType
+	{
+		unsigned int size;
+		unsigned int flags;
+		unsigned int height;
+		unsigned int width;
+		unsigned int pitchOrLinearSize;
+		unsigned int depth;
+		unsigned int mipMapCount;
+		unsigned int reserved1[11];
+		PixelFormatType pixelFormat;
+		unsigned int caps;
+		unsigned int caps2;
+		unsigned int caps3;
+		unsigned int caps4;
+		unsigned int reserved2;
+	};
+
+	struct HeaderDx10Type
+	{
+		unsigned int dxgiFormat;
+		unsigned int resourceDimension;
+		unsigned int miscFlag;
+		unsigned int arraySize;
+		unsigned int miscFlags2;
+	};
+
+	struct SurfaceType
+	{
+		size_t offset;
+		unsigned int width;
+		unsigned int height;
+		unsigned int rowPitch;
+		unsigned int slicePitch;
+	};
+
+	const unsigned char* m_data;
+	size_t m_size;
+	bool m_mapped;
+	void* m_fileHandle;
+	void* m_mappingHandle;
+	int m_fileDescriptor;
+
+	unsigned int m_width;
+	unsigned int m_height;
+	unsigned int m_mipCount;
+	unsigned int m_arraySize;
+	unsigned int m_format;
+	bool m_cubeMap;
+	bool m_alpha;
+	SurfaceType* m_surfaces;
+
+public:
+	DdsFile();
+	DdsFile(const DdsFile& other);
+	~DdsFile();
+
+	bool Initialize(const char* fileName);
+#ifdef _WIN32
+	bool Initialize(const wchar_t* fileName);
+#endif
+	bool Initialize(const void* data, size_t size);
+	void Shutdown();
+
+	unsigned int GetWidth();
+	unsigned int GetHeight();
+	unsigned int GetMipCount();
+	unsigned int GetArraySize();
+	unsigned int GetFormat();
+	bool IsCubeMap();
+	bool HasAlpha();
+	bool IsBlockCompressed();
+	size_t GetDataSize();
+
+	bool GetSurface(unsigned int arrayIndex, unsigned int mip, const void*& data, unsigned int& rowPitch, unsigned int& slicePitch, unsigned int& width, unsigned int& height);
+	bool GetSurfaceRgba(unsigned int arrayIndex, unsigned int mip, unsigned char* texels);
+
+private:
+	bool Parse();
+	unsigned int GetFormatFromPixelFormat(const PixelFormatType& pixelFormat);
+	unsigned int GetBitsPerPixel(unsigned int format);
+	unsigned int GetBlockSize(unsigned int format);
+	void Unmap();
+};
+
+#endif
\ No newline at end of file
@@ -8,6 +8,7 @@ DebugWindow::DebugWindow()
 {
 	this->m_vertexBuffer = nullptr;
 	this->m_indexBuffer = nullptr;
+	this->m_FrameMemory = nullptr;
 }
 
 DebugWindow::DebugWindow(const DebugWindow& other)
@@ -20,10 +21,17 @@ DebugWindow::~DebugWindow()
 }
 
 
-bool DebugWindow::Initialize(ID3D11Device* device, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight)
+bool DebugWindow::Initialize(ID3D11Device* device, FrameMemory* frameMemory, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight)
 {
 	bool result;
 
+	//The vertex arrays are built in the frame memory's scratch arenas
+	if (!frameMemory)
+	{
+		return false;
+	}
+	this->m_FrameMemory = frameMemory;
+
 	//Store the screen size
 	this->m_screenWidth = screenWidth;
 	this->m_screenHeight = screenHeight;
@@ -80,6 +88,9 @@ bool DebugWindow::InitializeBuffers(ID3D11Device* device)
 	VertexType* vertices;
 	UINT* indices;
 
+	//The arrays only live until the buffers are made, so they come from the scratch arena and go back when this returns
+	ScratchScope scratch(this->m_FrameMemory);
+
 	//Set the number of vertices in the vertex array
 	this->m_vertexCount = 6;
 
@@ -87,14 +98,14 @@ bool DebugWindow::InitializeBuffers(ID3D11Device* device)
 	this->m_indexCount = this->m_vertexCount;
 
 	//Create the vertex array
-	vertices = new VertexType[this->m_vertexCount];
+	vertices = (VertexType*)scratch.Allocate(sizeof(VertexType) * this->m_vertexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!vertices)
 	{
 		return false;
 	}
 
 	//Create the index array
-	indices = new UINT[this->m_indexCount];
+	indices = (UINT*)scratch.Allocate(sizeof(UINT) * this->m_indexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!indices)
 	{
 		return false;
@@ -159,12 +170,6 @@ bool DebugWindow::InitializeBuffers(ID3D11Device* device)
 		return false;
 	}
 
-	delete[] vertices;
-	vertices = nullptr;
-
-	delete[] indices;
-	indices = nullptr;
-
 	return true;
 }
 
@@ -217,8 +222,9 @@ bool DebugWindow::UpdateBuffers(ID3D11DeviceContext* deviceContext, int position
 	//Calculate the screen coordinates of the bottom of the bitmap
 	bottom = top - (float)this->m_bitmapHeight;
 
-	//Create the vertex array
-	vertices = new VertexType[this->m_vertexCount];
+	//Create the vertex array on the scratch arena, this runs every time the window moves. It goes back when this returns
+	ScratchScope scratch(this->m_FrameMemory);
+	vertices = (VertexType*)scratch.Allocate(sizeof(VertexType) * this->m_vertexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!vertices)
 	{
 		return false;
@@ -259,10 +265,6 @@ bool DebugWindow::UpdateBuffers(ID3D11DeviceContext* deviceContext, int position
 	//Unlock the vertex buffer
 	deviceContext->Unmap(this->m_vertexBuffer, 0);
 
-	//Release the vertex array as it is no longer needed
-	delete[] vertices;
-	vertices = nullptr;
-
 	return true;
 }
 
@@ -10,6 +10,11 @@
 #include <d3d11.h>
 #include <d3dx10math.h>
 
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "FrameMemory.h"
+
 class DebugWindow
 {
 private:
@@ -21,6 +26,7 @@ private:
 
 	ID3D11Buffer* m_vertexBuffer;
 	ID3D11Buffer* m_indexBuffer;
+	FrameMemory* m_FrameMemory;
 	UINT m_vertexCount;
 	UINT m_indexCount;
 	int m_screenWidth;
@@ -35,7 +41,7 @@ public:
 	DebugWindow(const DebugWindow& other);
 	~DebugWindow();
 
-	bool Initialize(ID3D11Device* device, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight);
+	bool Initialize(ID3D11Device* device, FrameMemory* frameMemory, int screenWidth, int screenHeight, int bitmapWidth, int bitmapHeight);
 	void Shutdown();
 	bool Render(ID3D11DeviceContext* deviceContext, int positionX, int positionY);
 
@@ -47,6 +47,8 @@ void DepthShader::Shutdown()
 
 bool DepthShader::Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix)
 {
+	PROFILE_SCOPE("DepthShader::Render");
+
 	bool result;
 
 	// Set the shader parameters that it will use for rendering.
@@ -14,6 +14,11 @@
 #include <fstream>
 using namespace std;
 
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "Profiler.h"
+
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: DepthShader
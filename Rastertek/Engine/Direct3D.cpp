@@ -481,6 +481,8 @@ void Direct3D::Shutdown()
 
 void Direct3D::BeginScene(D3DXCOLOR backBufferColor)
 {
+	PROFILE_SCOPE("Direct3D::BeginScene");
+
 	//Setup the color to clear the buffer to
 	float color[4] = { backBufferColor.r, backBufferColor.g, backBufferColor.b, backBufferColor.a };
 
@@ -493,6 +495,8 @@ void Direct3D::BeginScene(D3DXCOLOR backBufferColor)
 
 void Direct3D::EndScene()
 {
+	PROFILE_SCOPE("Direct3D::EndScene");
+
 	//Present the back-buffer to the screen since rendering is complete
 	if (this->m_vsync_enabled)
 	{
@@ -20,6 +20,11 @@
 #include <d3dcommon.h>
 #include <d3dx10math.h>
 
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "Profiler.h"
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Direct3D
 ////////////////////////////////////////////////////////////////////////////////
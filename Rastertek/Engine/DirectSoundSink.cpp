@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: DirectSoundSink.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "DirectSoundSink.h"
+
+
+DirectSoundSink::DirectSoundSink()
+{
+	this->m_secondaryBuffer = nullptr;
+	this->m_bufferSize = 0;
+}
+
+DirectSoundSink::DirectSoundSink(const DirectSoundSink& other)
+{
+}
+
+
+DirectSoundSink::~DirectSoundSink()
+{
+}
+
+bool DirectSoundSink::Initialize(IDirectSound8* directSound, unsigned short channels, unsigned int sampleRate, unsigned short bitsPerSample, unsigned int bufferSize)
+{
+	HRESULT result;
+
+	WAVEFORMATEX waveFormat;
+	ZeroMemory(&waveFormat, sizeof(WAVEFORMATEX));
+
+	//Set the format of the ring to the format of the stream so the samples are copied without conversion
+	waveFormat.cbSize = 0;
+	waveFormat.nChannels = channels;
+	waveFormat.nSamplesPerSec = sampleRate;
+	waveFormat.wBitsPerSample = bitsPerSample;
+	waveFormat.wFormatTag = WAVE_FORMAT_PCM;
+	waveFormat.nBlockAlign = (waveFormat.wBitsPerSample / 8) * waveFormat.nChannels;
+	waveFormat.nAvgBytesPerSec = waveFormat.nSamplesPerSec * waveFormat.nBlockAlign;
+
+	DSBUFFERDESC bufferDesc;
+	ZeroMemory(&bufferDesc, sizeof(DSBUFFERDESC));
+
+	//The ring is only a few segments long, the exact play cursor is needed to know which segments are free
+	bufferDesc.dwBufferBytes = bufferSize;
+	bufferDesc.dwFlags = DSBCAPS_CTRLVOLUME | DSBCAPS_GETCURRENTPOSITION2 | DSBCAPS_GLOBALFOCUS;
+	bufferDesc.dwReserved = 0;
+	bufferDesc.dwSize = sizeof(DSBUFFERDESC);
+	bufferDesc.guid3DAlgorithm = GUID_NULL;
+	bufferDesc.lpwfxFormat = &waveFormat;
+
+	//Create a temporary sound buffer with the specific buffer settings
+	IDirectSoundBuffer* tempBuffer;
+	result = directSound->CreateSoundBuffer(&bufferDesc, &tempBuffer, nullptr);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Test the buffer format against the direct sound 8 interface and create the secondary buffer
+	result = tempBuffer->QueryInterface(IID_IDirectSoundBuffer8, (void**)&this->m_secondaryBuffer);
+	tempBuffer->Release();
+	tempBuffer = nullptr;
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	this->m_bufferSize = bufferSize;
+
+	return true;
+}
+
+void DirectSoundSink::Shutdown()
+{
+	//Release the secondary buffer
+	if (this->m_secondaryBuffer)
+	{
+		this->m_secondaryBuffer->Stop();
+		this->m_secondaryBuffer->Release();
+		this->m_secondaryBuffer = nullptr;
+	}
+}
+
+bool DirectSoundSink::Start()
+{
+	HRESULT result;
+
+	//Play the ring from the beginning and keep wrapping around it
+	result = this->m_secondaryBuffer->SetCurrentPosition(0);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = this->m_secondaryBuffer->Play(0, 0, DSBPLAY_LOOPING);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void DirectSoundSink::Stop()
+{
+	this->m_secondaryBuffer->Stop();
+}
+
+unsigned int DirectSoundSink::GetBufferSize()
+{
+	return this->m_bufferSize;
+}
+
+bool DirectSoundSink::GetPlayPosition(unsigned int& position)
+{
+	HRESULT result;
+	DWORD playPosition;
+	DWORD writePosition;
+
+	result = this->m_secondaryBuffer->GetCurrentPosition(&playPosition, &writePosition);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	position = playPosition;
+
+	return true;
+}
+
+bool DirectSoundSink::Lock(unsigned int offset, unsigned int size, void*& data)
+{
+	HRESULT result;
+	void* bufferPtr;
+	DWORD bufferSize;
+
+	//A region that does not wrap always comes back in one piece
+	result = this->m_secondaryBuffer->Lock(offset, size, &bufferPtr, &bufferSize, nullptr, nullptr, 0);
+	if (result == DSERR_BUFFERLOST)
+	{
+		this->m_secondaryBuffer->Restore();
+		result = this->m_secondaryBuffer->Lock(offset, size, &bufferPtr, &bufferSize, nullptr, nullptr, 0);
+	}
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	if (bufferSize < size)
+	{
+		this->m_secondaryBuffer->Unlock(bufferPtr, bufferSize, nullptr, 0);
+		return false;
+	}
+
+	data = bufferPtr;
+
+	return true;
+}
+
+void DirectSoundSink::Unlock(void* data, unsigned int size)
+{
+	this->m_secondaryBuffer->Unlock(data, size, nullptr, 0);
+}
+
+bool DirectSoundSink::SetVolume(long volume)
+{
+	HRESULT result;
+
+	result = this->m_secondaryBuffer->SetVolume(volume);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: DirectSoundSink.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _DIRECTSOUNDSINK_H_
+#define _DIRECTSOUNDSINK_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <windows.h>
+#include <mmsystem.h>
+#include <dsound.h>
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "SoundSink.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: DirectSoundSink
+////////////////////////////////////////////////////////////////////////////////
+class DirectSoundSink : public SoundSink
+{
+private:
+	IDirectSoundBuffer8* m_secondaryBuffer;
+	unsigned int m_bufferSize;
+
+public:
+	DirectSoundSink();
+	DirectSoundSink(const DirectSoundSink& other);
+	~DirectSoundSink();
+
+	bool Initialize(IDirectSound8* directSound, unsigned short channels, unsigned int sampleRate, unsigned short bitsPerSample, unsigned int bufferSize);
+	void Shutdown();
+
+	bool Start();
+	void Stop();
+
+	unsigned int GetBufferSize();
+	bool GetPlayPosition(unsigned int& position);
+
+	bool Lock(unsigned int offset, unsigned int size, void*& data);
+	void Unlock(void* data, unsigned int size);
+
+	bool SetVolume(long volume);
+};
+
+#endif
\ No newline at end of file
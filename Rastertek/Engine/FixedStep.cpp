@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FixedStep.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "FixedStep.h"
+
+
+FixedStep::FixedStep()
+{
+	this->m_tickRate = 0.0f;
+	this->m_tickLength = 0;
+	this->m_accumulator = 0;
+	this->m_totalTicks = 0;
+	this->m_skippedTicks = 0;
+}
+
+FixedStep::FixedStep(const FixedStep& other)
+{
+}
+
+
+FixedStep::~FixedStep()
+{
+}
+
+bool FixedStep::Initialize(float tickRate)
+{
+	bool result;
+
+	result = FixedStep::SetTickRate(tickRate);
+	if (!result)
+	{
+		return false;
+	}
+
+	FixedStep::Reset();
+
+	return true;
+}
+
+void FixedStep::Reset()
+{
+	this->m_accumulator = 0;
+	this->m_totalTicks = 0;
+	this->m_skippedTicks = 0;
+}
+
+bool FixedStep::SetTickRate(float tickRate)
+{
+	if (!(tickRate >= 1.0f && tickRate <= 10000.0f))
+	{
+		return false;
+	}
+
+	//The tick is a whole number of nanoseconds so adding up frames never drifts against the ticks
+	this->m_tickRate = tickRate;
+	this->m_tickLength = (long long)(1000000000.0 / tickRate + 0.5);
+	if (this->m_accumulator >= this->m_tickLength)
+	{
+		this->m_accumulator = this->m_tickLength - 1;
+	}
+
+	return true;
+}
+
+float FixedStep::GetTickRate()
+{
+	return this->m_tickRate;
+}
+
+float FixedStep::GetTickTime()
+{
+	return (float)((double)this->m_tickLength / 1000000.0);
+}
+
+long long FixedStep::GetTickLength()
+{
+	return this->m_tickLength;
+}
+
+int FixedStep::Advance(float frameTime)
+{
+	//The timer hands out milliseconds
+	return FixedStep::AdvanceNanoseconds((long long)((double)frameTime * 1000000.0 + 0.5));
+}
+
+int FixedStep::AdvanceNanoseconds(long long frameTime)
+{
+	long long tickCount;
+
+	if (frameTime < 0)
+	{
+		frameTime = 0;
+	}
+
+	this->m_accumulator += frameTime;
+	tickCount = this->m_accumulator / this->m_tickLength;
+	this->m_accumulator -= tickCount * this->m_tickLength;
+
+	if (tickCount > FIXED_STEP_MAX_TICKS)
+	{
+		this->m_skippedTicks += tickCount - FIXED_STEP_MAX_TICKS;
+		tickCount = FIXED_STEP_MAX_TICKS;
+	}
+	this->m_totalTicks += tickCount;
+
+	return (int)tickCount;
+}
+
+float FixedStep::GetAlpha()
+{
+	//How far the frame is between the last tick and the next one, for blending the two
+	return (float)((double)this->m_accumulator / (double)this->m_tickLength);
+}
+
+unsigned long long FixedStep::GetTotalTicks()
+{
+	return this->m_totalTicks;
+}
+
+unsigned long long FixedStep::GetSkippedTicks()
+{
+	return this->m_skippedTicks;
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FixedStep.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _FIXEDSTEP_H_
+#define _FIXEDSTEP_H_
+
+/////////////
+// GLOBALS //
+/////////////
+const float FIXED_STEP_DEFAULT_RATE = 60.0f;
+
+//A frame never runs more ticks than this, a long stall is skipped instead of making every later frame late too
+const int FIXED_STEP_MAX_TICKS = 8;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: FixedStep
+////////////////////////////////////////////////////////////////////////////////
+class FixedStep
+{
+private:
+	float m_tickRate;
+	long long m_tickLength;
+	long long m_accumulator;
+	unsigned long long m_totalTicks;
+	unsigned long long m_skippedTicks;
+
+public:
+	FixedStep();
+	FixedStep(const FixedStep& other);
+	~FixedStep();
+
+	bool Initialize(float tickRate);
+	void Reset();
+
+	bool SetTickRate(float tickRate);
+	float GetTickRate();
+	float GetTickTime();
+	long long GetTickLength();
+
+	int Advance(float frameTime);
+	int AdvanceNanoseconds(long long frameTime);
+
+	float GetAlpha();
+	unsigned long long GetTotalTicks();
+	unsigned long long GetSkippedTicks();
+};
+
+#endif
\ No newline at end of file
@@ -9,49 +9,39 @@
 //////////////
 #include <d3d11.h>
 #include <d3dx10math.h>
-#include <fstream>
-using namespace std;
 
 ///////////////////////
 // MY CLASS INCLUDES //
 ///////////////////////
-#include "Texture.h"
+#include "TextureManager.h"
+#include "FontLayout.h"
 
 class Font
 {
 private:
-	struct FontType
-	{
-		float left;
-		float right;
-		int size;
-	};
-
-	struct VertexType
-	{
-		D3DXVECTOR3 position;
-		D3DXVECTOR2 texture;
-	};
-
-	FontType* m_Font;
+	FontLayout m_Layout;
+	TextureManager* m_TextureManager;
 	Texture* m_Texture;
 
-	int m_charactersCount;
+	float m_fontHeight;
+	bool m_distanceField;
 
 public:
 	Font();
 	Font(const Font& other);
 	~Font();
 
-	bool Initialize(ID3D11Device* device, char* fontFilename, WCHAR* textureFilename);
+	bool Initialize(ID3D11Device* device, TextureManager* textureManager, char* fontFilename, WCHAR* textureFilename, float fontHeight, bool distanceField);
 	void Shutdown();
 
+	bool LoadKerningData(char* kerningFilename);
+
 	ID3D11ShaderResourceView* GetTexture();
-	void BuildVertexArray(void* vertices, char* sentence, D3DXVECTOR2 drawPosition);
+	float GetFontHeight();
+	bool IsDistanceField();
+	int BuildVertexArray(void* vertices, const char* sentence, int length, D3DXVECTOR2 drawPosition, D3DXCOLOR color, float scale);
 
 private:
-	bool LoadFontData(char* fontFilename);
-	void ReleaseFontData();
 	bool LoadTexture(ID3D11Device* device, WCHAR* textureFilename);
 	void ReleaseTexture();
 };
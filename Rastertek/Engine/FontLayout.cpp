@@ -0,0 +1,575 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FontLayout.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "FontLayout.h"
+
+
+FontLayout::FontLayout()
+{
+	this->m_Font = nullptr;
+	this->m_codepoints = nullptr;
+	this->m_kerning = nullptr;
+	this->m_charactersCount = 95;//The size of the array is set to 95 as that is the number of characters in the texture and hence the number of indexes in the fontdata.txt file.
+	this->m_kerningCount = 0;
+	this->m_fallbackGlyph = -1;
+}
+
+FontLayout::FontLayout(const FontLayout& other)
+{
+}
+
+
+FontLayout::~FontLayout()
+{
+}
+
+bool FontLayout::Initialize(char* fontFilename)
+{
+	ifstream fIn;
+	char tmp;
+
+	//Create the font spacing buffer
+	this->m_Font = new FontType[this->m_charactersCount]; 
+	if (!this->m_Font)
+	{
+		return false;
+	}
+
+	//Create the buffer holding the codepoint of every glyph
+	this->m_codepoints = new int[this->m_charactersCount];
+	if (!this->m_codepoints)
+	{
+		return false;
+	}
+
+	//Read in the font size and spacing between chars
+	fIn.open(fontFilename);
+	if (fIn.fail())
+	{
+		return false;
+	}
+
+	//Read in the characters for text
+	for (int i = 0; i < this->m_charactersCount; i++)
+	{
+		//The first column is the codepoint of the glyph, followed by the glyph itself
+		fIn >> this->m_codepoints[i];
+		fIn.get(tmp);
+		fIn.get(tmp);
+		while (tmp != ' ' && fIn.good())
+		{
+			fIn.get(tmp);
+		}
+		fIn >> this->m_Font[i].left >> this->m_Font[i].right >> this->m_Font[i].size;
+
+		//The codepoints have to be Unicode scalar values, below 0 one would index in front of the ASCII table
+		if (fIn.fail() || this->m_codepoints[i] < 0 || this->m_codepoints[i] > 0x10FFFF)
+		{
+			return false;
+		}
+
+		//The codepoints have to be in ascending order so the glyphs can be binary searched
+		if ((i > 0) && (this->m_codepoints[i] <= this->m_codepoints[i - 1]))
+		{
+			return false;
+		}
+	}
+	//Close the file
+	fIn.close();
+
+	//Build the direct lookup table for the ASCII range which covers nearly every glyph drawn
+	for (int i = 0; i < 128; i++)
+	{
+		this->m_asciiLookup[i] = -1;
+	}
+	for (int i = 0; i < this->m_charactersCount; i++)
+	{
+		if (this->m_codepoints[i] < 128)
+		{
+			this->m_asciiLookup[this->m_codepoints[i]] = (short)i;
+		}
+	}
+
+	//Characters missing from the font are drawn as a question mark
+	this->m_fallbackGlyph = this->m_asciiLookup['?'];
+
+	return true;
+}
+
+bool FontLayout::LoadKerningData(char* kerningFilename)
+{
+	ifstream fIn;
+	int first;
+	int second;
+	int firstGlyph;
+	int secondGlyph;
+	float amount;
+	KerningType kerning;
+
+	//Open the kerning file, it holds the number of pairs followed by one "first second amount" line per pair, with the pairs given as codepoints
+	fIn.open(kerningFilename);
+	if (fIn.fail())
+	{
+		return false;
+	}
+
+	fIn >> this->m_kerningCount;
+	if (fIn.fail() || this->m_kerningCount < 0)
+	{
+		this->m_kerningCount = 0;
+		return false;
+	}
+
+	//Create the kerning pair buffer
+	this->m_kerning = new KerningType[this->m_kerningCount];
+	if (!this->m_kerning)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < this->m_kerningCount; i++)
+	{
+		fIn >> first >> second >> amount;
+
+		//Store the pair keyed on the glyph indices so lookups do not need to translate codepoints again
+		firstGlyph = FontLayout::FindGlyph(first);
+		secondGlyph = FontLayout::FindGlyph(second);
+		if (fIn.fail() || firstGlyph < 0 || secondGlyph < 0)
+		{
+			this->m_kerningCount = i;
+			return false;
+		}
+		this->m_kerning[i].pair = ((unsigned int)firstGlyph << 16) | (unsigned int)secondGlyph;
+		this->m_kerning[i].amount = amount;
+	}
+
+	//Close the file
+	fIn.close();
+
+	//Sort the pairs so they can be binary searched
+	for (int i = 1; i < this->m_kerningCount; i++)
+	{
+		kerning = this->m_kerning[i];
+		int j = i - 1;
+		while (j >= 0 && this->m_kerning[j].pair > kerning.pair)
+		{
+			this->m_kerning[j + 1] = this->m_kerning[j];
+			j--;
+		}
+		this->m_kerning[j + 1] = kerning;
+	}
+
+	return true;
+}
+
+void FontLayout::Shutdown()
+{
+	//Release the kerning pair array
+	if (this->m_kerning)
+	{
+		delete[] this->m_kerning;
+		this->m_kerning = nullptr;
+	}
+	this->m_kerningCount = 0;
+
+	//Release the codepoint array
+	if (this->m_codepoints)
+	{
+		delete[] this->m_codepoints;
+		this->m_codepoints = nullptr;
+	}
+
+	//Release the font data array
+	if (this->m_Font)
+	{
+		delete[] this->m_Font;
+		this->m_Font = nullptr;
+	}
+}
+
+int FontLayout::BuildVertexArray(void* vertices, const char* sentence, int length, float positionX, float positionY, float fontHeight, const float* color, float scale)
+{
+	VertexType* vertexPtr;
+	const unsigned char* textPtr;
+	int glyphs[FONT_LAYOUT_CHUNK];
+	float advances[FONT_LAYOUT_CHUNK];
+	float positions[FONT_LAYOUT_CHUNK];
+	float quadLeft[FONT_LAYOUT_CHUNK];
+	float quadWidth[FONT_LAYOUT_CHUNK];
+	float quadTexLeft[FONT_LAYOUT_CHUNK];
+	float quadTexRight[FONT_LAYOUT_CHUNK];
+	int glyphCount;
+	int quadCount;
+	int codepoint;
+	int glyph;
+	int previousGlyph;
+	int consumed;
+	float penX;
+
+	//Coerce the input vertices into a VertexType structure
+	vertexPtr = (VertexType*)vertices;
+	textPtr = (const unsigned char*)sentence;
+
+	//The pen starts at the draw location and is carried from one chunk to the next
+	penX = positionX;
+	previousGlyph = -1;
+	quadCount = 0;
+
+	//Lay the sentence out in fixed size chunks so no allocation is needed however long the sentence is
+	while (length > 0)
+	{
+		//Decode the UTF-8 text into glyphs and work out how far each one advances the pen, including the kerning against the glyph before it
+		glyphCount = 0;
+		while (length > 0 && glyphCount < FONT_LAYOUT_CHUNK)
+		{
+			//ASCII is by far the common case so it skips the decoder and the glyph search
+			if (textPtr[0] < 0x80)
+			{
+				codepoint = textPtr[0];
+				glyph = this->m_asciiLookup[codepoint];
+				textPtr++;
+				length--;
+			}
+			else
+			{
+				consumed = FontLayout::DecodeCodepoint(textPtr, length, codepoint);
+				textPtr += consumed;
+				length -= consumed;
+				glyph = FontLayout::FindGlyph(codepoint);
+			}
+
+			//Spaces have no quad, they just move over three pixels
+			if (codepoint == ' ')
+			{
+				glyphs[glyphCount] = -1;
+				advances[glyphCount] = 3.0f * scale;
+				previousGlyph = -1;
+				glyphCount++;
+				continue;
+			}
+
+			//Characters missing from the font use the fallback glyph, if the font has none they are skipped
+			if (glyph < 0)
+			{
+				glyph = this->m_fallbackGlyph;
+				if (glyph < 0)
+				{
+					//Nothing is drawn, so the glyphs either side of it are not a kerning pair
+					previousGlyph = -1;
+					continue;
+				}
+			}
+
+			//Every letter is followed by a single pixel of spacing. The metrics are in atlas pixels and are scaled to the size the sentence is drawn at
+			glyphs[glyphCount] = glyph;
+			advances[glyphCount] = (this->m_Font[glyph].size + 1.0f) * scale;
+
+			//The kerning adjusts the space between this glyph and the one before it so it is added to the previous advance.
+			//If the previous glyph was in the last chunk its advance is already in the pen position
+			if (this->m_kerningCount > 0 && previousGlyph >= 0)
+			{
+				if (glyphCount > 0)
+				{
+					advances[glyphCount - 1] += FontLayout::GetKerning(previousGlyph, glyph) * scale;
+				}
+				else
+				{
+					penX += FontLayout::GetKerning(previousGlyph, glyph) * scale;
+				}
+			}
+			previousGlyph = glyph;
+			glyphCount++;
+		}
+
+		//Turn the advances into the pen position of every glyph
+		FontLayout::PrefixSum(advances, positions, glyphCount, penX);
+
+		//Gather the glyphs that produce a quad so they can be emitted four at a time
+		int chunkQuads = 0;
+		for (int i = 0; i < glyphCount; i++)
+		{
+			if (glyphs[i] >= 0)
+			{
+				quadLeft[chunkQuads] = positions[i];
+				quadWidth[chunkQuads] = this->m_Font[glyphs[i]].size * scale;
+				quadTexLeft[chunkQuads] = this->m_Font[glyphs[i]].left;
+				quadTexRight[chunkQuads] = this->m_Font[glyphs[i]].right;
+				chunkQuads++;
+			}
+		}
+
+		//Write the four corners of every quad, they are indexed by the shared quad index buffer
+		FontLayout::EmitQuads(vertexPtr + (quadCount * 4), quadLeft, quadWidth, quadTexLeft, quadTexRight, chunkQuads, positionY, positionY - (fontHeight * scale), color);
+		quadCount += chunkQuads;
+	}
+
+	return quadCount;
+}
+
+int FontLayout::FindGlyph(int codepoint)
+{
+	int low;
+	int high;
+	int middle;
+
+	//The ASCII range is looked up directly
+	if (codepoint >= 0 && codepoint < 128)
+	{
+		return this->m_asciiLookup[codepoint];
+	}
+
+	//Everything else is binary searched in the sorted codepoint array
+	low = 0;
+	high = this->m_charactersCount - 1;
+	while (low <= high)
+	{
+		middle = (low + high) / 2;
+		if (this->m_codepoints[middle] == codepoint)
+		{
+			return middle;
+		}
+		if (this->m_codepoints[middle] < codepoint)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	return -1;
+}
+
+float FontLayout::GetKerning(int previousGlyph, int glyph)
+{
+	unsigned int pair;
+	int low;
+	int high;
+	int middle;
+
+	//Most fonts have no kerning table at all
+	if (this->m_kerningCount == 0)
+	{
+		return 0.0f;
+	}
+
+	pair = ((unsigned int)previousGlyph << 16) | (unsigned int)glyph;
+
+	low = 0;
+	high = this->m_kerningCount - 1;
+	while (low <= high)
+	{
+		middle = (low + high) / 2;
+		if (this->m_kerning[middle].pair == pair)
+		{
+			return this->m_kerning[middle].amount;
+		}
+		if (this->m_kerning[middle].pair < pair)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle - 1;
+		}
+	}
+
+	return 0.0f;
+}
+
+int FontLayout::DecodeCodepoint(const unsigned char* text, int length, int& codepoint)
+{
+	int count;
+	int minimum;
+
+	//Single byte ASCII
+	if (text[0] < 0x80)
+	{
+		codepoint = text[0];
+		return 1;
+	}
+
+	//Work out the length of the sequence from the lead byte
+	if ((text[0] & 0xE0) == 0xC0)
+	{
+		codepoint = text[0] & 0x1F;
+		count = 2;
+		minimum = 0x80;
+	}
+	else if ((text[0] & 0xF0) == 0xE0)
+	{
+		codepoint = text[0] & 0x0F;
+		count = 3;
+		minimum = 0x800;
+	}
+	else if ((text[0] & 0xF8) == 0xF0)
+	{
+		codepoint = text[0] & 0x07;
+		count = 4;
+		minimum = 0x10000;
+	}
+	else
+	{
+		//A stray continuation byte or an invalid lead byte, skip it and draw the fallback glyph
+		codepoint = -1;
+		return 1;
+	}
+
+	//Truncated sequences at the end of the text are invalid too
+	if (count > length)
+	{
+		codepoint = -1;
+		return length;
+	}
+
+	for (int i = 1; i < count; i++)
+	{
+		if ((text[i] & 0xC0) != 0x80)
+		{
+			codepoint = -1;
+			return i;
+		}
+		codepoint = (codepoint << 6) | (text[i] & 0x3F);
+	}
+
+	//Overlong encodings, UTF-16 surrogates and anything past the last codepoint are well formed but not valid characters
+	if (codepoint < minimum || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+	{
+		codepoint = -1;
+	}
+
+	return count;
+}
+
+void FontLayout::PrefixSum(const float* advances, float* positions, int count, float& penX)
+{
+	__m128 carry;
+	__m128 sum;
+	int i;
+
+	//The position of every glyph is the pen position plus the sum of all the advances before it. Four advances are scanned at a time
+	carry = _mm_set1_ps(penX);
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		//Inclusive scan of the four advances in the register
+		sum = _mm_loadu_ps(advances + i);
+		sum = _mm_add_ps(sum, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 4)));
+		sum = _mm_add_ps(sum, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 8)));
+
+		//Shift it to the exclusive scan and offset it by the running pen position
+		_mm_storeu_ps(positions + i, _mm_add_ps(carry, _mm_sub_ps(sum, _mm_loadu_ps(advances + i))));
+
+		//Broadcast the last lane to carry the pen into the next four glyphs
+		carry = _mm_add_ps(carry, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+	penX = _mm_cvtss_f32(carry);
+
+	//Finish the remainder one at a time
+	for (; i < count; i++)
+	{
+		positions[i] = penX;
+		penX += advances[i];
+	}
+}
+
+void FontLayout::EmitQuads(VertexType* vertices, const float* left, const float* width, const float* texLeft, const float* texRight, int count, float top, float bottom, const float* color)
+{
+	float* outputPtr;
+	__m128 left4;
+	__m128 right4;
+	__m128 texLeft4;
+	__m128 texRight4;
+	__m128 glyph[4];
+	__m128 broadcast;
+	int i;
+
+	//Each quad is written as its top left, bottom right, bottom left and top right corners. With the 36 byte vertex
+	//that is 36 floats per quad, which are stored as nine registers. The parts that only depend on the sentence are built
+	//once and the lanes that depend on the glyph are blended in with a mask
+	const __m128 maskLane0 = _mm_castsi128_ps(_mm_set_epi32(0, 0, 0, -1));
+	const __m128 maskLane1 = _mm_castsi128_ps(_mm_set_epi32(0, 0, -1, 0));
+	const __m128 maskLane2 = _mm_castsi128_ps(_mm_set_epi32(0, -1, 0, 0));
+	const __m128 maskLane3 = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	const __m128 maskLane03 = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, -1));
+
+	const __m128 store0 = _mm_setr_ps(0.0f, top, 0.0f, 0.0f);				//x0 top 0 u0
+	const __m128 store1 = _mm_setr_ps(0.0f, color[0], color[1], color[2]);		//0 r g b
+	const __m128 store2 = _mm_setr_ps(color[3], 0.0f, bottom, 0.0f);			//a x1 bottom 0
+	const __m128 store3 = _mm_setr_ps(0.0f, 1.0f, color[0], color[1]);		//u1 1 r g
+	const __m128 store4 = _mm_setr_ps(color[2], color[3], 0.0f, bottom);		//b a x0 bottom
+	const __m128 store5 = _mm_setr_ps(0.0f, 0.0f, 1.0f, color[0]);			//0 u0 1 r
+	const __m128 store6 = _mm_setr_ps(color[1], color[2], color[3], 0.0f);		//g b a x1
+	const __m128 store7 = _mm_setr_ps(top, 0.0f, 0.0f, 0.0f);				//top 0 u1 0
+	const __m128 store8 = _mm_setr_ps(color[0], color[1], color[2], color[3]);	//r g b a
+
+	outputPtr = (float*)vertices;
+
+	for (i = 0; i < count; i += 4)
+	{
+		//Load four glyphs, padding the last group with copies of its first glyph that are not written out
+		if (i + 4 <= count)
+		{
+			left4 = _mm_loadu_ps(left + i);
+			right4 = _mm_add_ps(left4, _mm_loadu_ps(width + i));
+			texLeft4 = _mm_loadu_ps(texLeft + i);
+			texRight4 = _mm_loadu_ps(texRight + i);
+		}
+		else
+		{
+			float padLeft[4];
+			float padWidth[4];
+			float padTexLeft[4];
+			float padTexRight[4];
+			for (int j = 0; j < 4; j++)
+			{
+				int k = (i + j < count) ? (i + j) : i;
+				padLeft[j] = left[k];
+				padWidth[j] = width[k];
+				padTexLeft[j] = texLeft[k];
+				padTexRight[j] = texRight[k];
+			}
+			left4 = _mm_loadu_ps(padLeft);
+			right4 = _mm_add_ps(left4, _mm_loadu_ps(padWidth));
+			texLeft4 = _mm_loadu_ps(padTexLeft);
+			texRight4 = _mm_loadu_ps(padTexRight);
+		}
+
+		//Transpose so each register holds the x0 x1 u0 u1 of one glyph
+		glyph[0] = left4;
+		glyph[1] = right4;
+		glyph[2] = texLeft4;
+		glyph[3] = texRight4;
+		_MM_TRANSPOSE4_PS(glyph[0], glyph[1], glyph[2], glyph[3]);
+
+		for (int j = 0; j < 4 && (i + j) < count; j++)
+		{
+			//x0 and u0 into lanes zero and three
+			broadcast = _mm_shuffle_ps(glyph[j], glyph[j], _MM_SHUFFLE(2, 0, 0, 0));
+			_mm_storeu_ps(outputPtr + 0, _mm_or_ps(_mm_and_ps(broadcast, maskLane03), store0));
+			_mm_storeu_ps(outputPtr + 4, store1);
+
+			//x1
+			broadcast = _mm_shuffle_ps(glyph[j], glyph[j], _MM_SHUFFLE(1, 1, 1, 1));
+			_mm_storeu_ps(outputPtr + 8, _mm_or_ps(_mm_and_ps(broadcast, maskLane1), store2));
+			_mm_storeu_ps(outputPtr + 24, _mm_or_ps(_mm_and_ps(broadcast, maskLane3), store6));
+
+			//u1
+			broadcast = _mm_shuffle_ps(glyph[j], glyph[j], _MM_SHUFFLE(3, 3, 3, 3));
+			_mm_storeu_ps(outputPtr + 12, _mm_or_ps(_mm_and_ps(broadcast, maskLane0), store3));
+			_mm_storeu_ps(outputPtr + 28, _mm_or_ps(_mm_and_ps(broadcast, maskLane2), store7));
+
+			//x0
+			broadcast = _mm_shuffle_ps(glyph[j], glyph[j], _MM_SHUFFLE(0, 0, 0, 0));
+			_mm_storeu_ps(outputPtr + 16, _mm_or_ps(_mm_and_ps(broadcast, maskLane2), store4));
+
+			//u0
+			broadcast = _mm_shuffle_ps(glyph[j], glyph[j], _MM_SHUFFLE(2, 2, 2, 2));
+			_mm_storeu_ps(outputPtr + 20, _mm_or_ps(_mm_and_ps(broadcast, maskLane1), store5));
+
+			_mm_storeu_ps(outputPtr + 32, store8);
+
+			outputPtr += 36;
+		}
+	}
+}
\ No newline at end of file
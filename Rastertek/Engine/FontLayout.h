@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FontLayout.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _FONTLAYOUT_H_
+#define _FONTLAYOUT_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <emmintrin.h>
+#include <fstream>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+const int FONT_LAYOUT_CHUNK = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: FontLayout
+////////////////////////////////////////////////////////////////////////////////
+
+//The glyph metrics and kerning of a font and the layout that turns UTF-8 text into glyph quads
+//Nothing here is tied to a device, the font texture the quads index into is kept by Font
+class FontLayout
+{
+public:
+	//Laid out like the position, texture and color the font shader reads
+	struct VertexType
+	{
+		float position[3];
+		float texture[2];
+		float color[4];
+	};
+
+private:
+	struct FontType
+	{
+		float left;
+		float right;
+		int size;
+	};
+
+	struct KerningType
+	{
+		unsigned int pair;
+		float amount;
+	};
+
+	FontType* m_Font;
+	int* m_codepoints;
+	short m_asciiLookup[128];
+	KerningType* m_kerning;
+
+	int m_charactersCount;
+	int m_kerningCount;
+	int m_fallbackGlyph;
+
+public:
+	FontLayout();
+	FontLayout(const FontLayout& other);
+	~FontLayout();
+
+	bool Initialize(char* fontFilename);
+	void Shutdown();
+
+	bool LoadKerningData(char* kerningFilename);
+
+	//Writes four vertices for every glyph that has a quad and returns how many quads that was, the color is red, green, blue and alpha
+	int BuildVertexArray(void* vertices, const char* sentence, int length, float positionX, float positionY, float fontHeight, const float* color, float scale);
+
+private:
+	int FindGlyph(int codepoint);
+	float GetKerning(int previousGlyph, int glyph);
+	int DecodeCodepoint(const unsigned char* text, int length, int& codepoint);
+	void PrefixSum(const float* advances, float* positions, int count, float& penX);
+	void EmitQuads(VertexType* vertices, const float* left, const float* width, const float* texLeft, const float* texRight, int count, float top, float bottom, const float* color);
+};
+
+#endif
\ No newline at end of file
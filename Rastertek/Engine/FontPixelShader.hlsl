@@ -8,11 +8,6 @@
 Texture2D shaderTexture;
 SamplerState SampleType;
 
-cbuffer PixelBuffer
-{
-	float4 pixelColor;
-};
-
 //////////////
 // TYPEDEFS //
 //////////////
@@ -20,6 +15,7 @@ struct PixelInputType
 {
 	float4 position : SV_POSITION;
 	float2 tex : TEXCOORD0;
+	float4 color : COLOR;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -37,11 +33,11 @@ float4 main(PixelInputType input) : SV_TARGET
 	{
 		color.a = 0.0f;
 	}
-	//If the color is other than black on the texture then this is a pixel in the font so draw it using the font pixel color
+	//If the color is other than black on the texture then this is a pixel in the font so draw it using the sentence color of the vertex
 	else
 	{
-		color.a - 1.0f;
-		color *= pixelColor;
+		color.a = 1.0f;
+		color *= input.color;
 	}
 
 	return color;
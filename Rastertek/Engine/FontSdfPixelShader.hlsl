@@ -0,0 +1,43 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FontSdfPixelShader.hlsl
+////////////////////////////////////////////////////////////////////////////////
+
+/////////////
+// GLOBALS //
+/////////////
+Texture2D shaderTexture;
+SamplerState SampleType;
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct PixelInputType
+{
+	float4 position : SV_POSITION;
+	float2 tex : TEXCOORD0;
+	float4 color : COLOR;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Pixel Shader
+////////////////////////////////////////////////////////////////////////////////
+float4 main(PixelInputType input) : SV_TARGET
+{
+	float distance;
+	float edgeWidth;
+	float alpha;
+	float4 color;
+
+	//Sample the signed distance at this location, the glyph edge is stored as 0.5
+	distance = shaderTexture.Sample(SampleType, input.tex).r;
+
+	//Use the screen space rate of change of the distance so the edge is anti-aliased over about one pixel whatever the scale of the text
+	edgeWidth = fwidth(distance) * 0.5f;
+	alpha = smoothstep(0.5f - edgeWidth, 0.5f + edgeWidth, distance);
+
+	//Draw the pixel using the sentence color of the vertex, fading it out across the edge
+	color = input.color;
+	color.a *= alpha;
+
+	return color;
+}
\ No newline at end of file
@@ -8,9 +8,9 @@ FontShader::FontShader()
 {
 	this->m_vertexShader = nullptr;
 	this->m_pixelShader = nullptr;
+	this->m_distanceFieldPixelShader = nullptr;
 	this->m_inputLayout = nullptr;
 	this->m_constantBuffer = nullptr;
-	this->m_pixelBuffer = nullptr;
 	this->m_samplerState = nullptr;
 }
 
@@ -28,7 +28,7 @@ bool FontShader::Initialize(ID3D11Device* device, HWND hwnd)
 	bool result;
 
 	//Initialize the vertex and pixel shaders
-	result = FontShader::InitializeShader(device, hwnd, L"FontVertexShader.hlsl", L"FontPixelShader.hlsl");
+	result = FontShader::InitializeShader(device, hwnd, L"FontVertexShader.hlsl", L"FontPixelShader.hlsl", L"FontSdfPixelShader.hlsl");
 	if (!result)
 	{
 		return false;
@@ -43,24 +43,24 @@ void FontShader::Shutdown()
 	FontShader::ShutdownShaders();
 }
 
-bool FontShader::Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, D3DXCOLOR fontColor)
+bool FontShader::Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool distanceField)
 {
 	bool result;
 
 	//Set the shader parameters that it will use for rendering
-	result = FontShader::SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture, fontColor);
+	result = FontShader::SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, texture);
 	if (!result)
 	{
 		return false;
 	}
 
 	//Now render the prepared buffers with the shader
-	FontShader::RenderShader(deviceContext, indexCount);
+	FontShader::RenderShader(deviceContext, indexCount, distanceField);
 
 	return true;
 }
 
-bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFileName, WCHAR* psFileName)
+bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFileName, WCHAR* psFileName, WCHAR* sdfPsFileName)
 {
 	HRESULT result;
 
@@ -68,6 +68,7 @@ bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFile
 	ID3D10Blob* errorMessage = nullptr;
 	ID3D10Blob* vertexShaderBuffer = nullptr;
 	ID3D10Blob* pixelShaderBuffer = nullptr;
+	ID3D10Blob* distanceFieldPixelShaderBuffer = nullptr;
 
 	//Compile the vertex shader code
 	result = D3DX11CompileFromFile(vsFileName, nullptr, nullptr, "main", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, nullptr, &vertexShaderBuffer, &errorMessage, nullptr);
@@ -99,6 +100,21 @@ bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFile
 		return false;
 	}
 
+	//Compile the signed distance field pixel shader code
+	result = D3DX11CompileFromFile(sdfPsFileName, nullptr, nullptr, "main", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, nullptr, &distanceFieldPixelShaderBuffer, &errorMessage, nullptr);
+	if (FAILED(result))
+	{
+		if (errorMessage)
+		{
+			FontShader::OutputShaderErrorMessage(errorMessage, hwnd, sdfPsFileName);
+		}
+		else
+		{
+			MessageBox(hwnd, sdfPsFileName, L"Missing Shader File", MB_OK);
+		}
+		return false;
+	}
+
 	//Create the vertex shader from the buffer
 	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), nullptr, &this->m_vertexShader);
 	if (FAILED(result))
@@ -113,9 +129,16 @@ bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFile
 		return false;
 	}
 
+	//Create the signed distance field pixel shader from the buffer
+	result = device->CreatePixelShader(distanceFieldPixelShaderBuffer->GetBufferPointer(), distanceFieldPixelShaderBuffer->GetBufferSize(), nullptr, &this->m_distanceFieldPixelShader);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
 	//Create the vertex input layout description
-	D3D11_INPUT_ELEMENT_DESC polygonLayout[2];
-	ZeroMemory(&polygonLayout, sizeof(D3D11_INPUT_ELEMENT_DESC) * 2);
+	D3D11_INPUT_ELEMENT_DESC polygonLayout[3];
+	ZeroMemory(&polygonLayout, sizeof(D3D11_INPUT_ELEMENT_DESC) * 3);
 
 	polygonLayout[0].AlignedByteOffset = 0;
 	polygonLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
@@ -133,6 +156,15 @@ bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFile
 	polygonLayout[1].SemanticIndex = 0;
 	polygonLayout[1].SemanticName = "TEXCOORD";
 
+	//The color is stored per vertex so sentences with different colors can be drawn in a single call
+	polygonLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polygonLayout[2].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	polygonLayout[2].InputSlot = 0;
+	polygonLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polygonLayout[2].InstanceDataStepRate = 0;
+	polygonLayout[2].SemanticIndex = 0;
+	polygonLayout[2].SemanticName = "COLOR";
+
 	//Get a count of the element in the layout
 	UINT numElements = sizeof(polygonLayout) / sizeof(D3D11_INPUT_ELEMENT_DESC);
 
@@ -150,6 +182,9 @@ bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFile
 	pixelShaderBuffer->Release();
 	pixelShaderBuffer = nullptr;
 
+	distanceFieldPixelShaderBuffer->Release();
+	distanceFieldPixelShaderBuffer = nullptr;
+
 	//Setup the description of the dynamic constant buffer that is in the vertex shader
 	D3D11_BUFFER_DESC constantBufferDesc;
 	ZeroMemory(&constantBufferDesc, sizeof(D3D11_BUFFER_DESC));
@@ -193,36 +228,11 @@ bool FontShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFile
 		return false;
 	}
 
-	//Setup the description pixel constant buffer that is in the pixel shader
-	D3D11_BUFFER_DESC pixelBufferDesc;
-	ZeroMemory(&pixelBufferDesc, sizeof(D3D11_BUFFER_DESC));
-
-	pixelBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-	pixelBufferDesc.ByteWidth = sizeof(PixelBufferType);
-	pixelBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-	pixelBufferDesc.MiscFlags = 0;
-	pixelBufferDesc.StructureByteStride = 0;
-	pixelBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-
-	//Create the pixel constant buffer pointer so we can access the pixel shader constant buffer from whiting this class
-	result = device->CreateBuffer(&pixelBufferDesc, nullptr, &this->m_pixelBuffer);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
 	return true;
 }
 
 void FontShader::ShutdownShaders()
 {
-	//Release the pixel constant buffer
-	if (this->m_pixelBuffer)
-	{
-		this->m_pixelBuffer->Release();
-		this->m_pixelBuffer = nullptr;
-	}
-
 	//Release the sampler state
 	if (this->m_samplerState)
 	{
@@ -244,6 +254,13 @@ void FontShader::ShutdownShaders()
 		this->m_inputLayout = nullptr;
 	}
 
+	//Release the signed distance field pixel shader
+	if (this->m_distanceFieldPixelShader)
+	{
+		this->m_distanceFieldPixelShader->Release();
+		this->m_distanceFieldPixelShader = nullptr;
+	}
+
 	//Release the pixel shader
 	if (this->m_pixelShader)
 	{
@@ -290,7 +307,7 @@ void FontShader::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, W
 	MessageBox(hwnd, L"Error compiling shader.  Check Shader-Error.txt for message.", shaderFileName, MB_OK);
 }
 
-bool FontShader::SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, D3DXCOLOR fontColor)
+bool FontShader::SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture)
 {
 	HRESULT result;
 
@@ -319,42 +336,23 @@ bool FontShader::SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMAT
 	//Unlock the constant buffer
 	deviceContext->Unmap(this->m_constantBuffer, 0);
 
-	//Lock the pixel constant buffer so it can be written to
-	result = deviceContext->Map(this->m_pixelBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	//Get a pointer to the data in the pixel buffer
-	PixelBufferType* pixelBufferPtr = (PixelBufferType*)mappedSubresource.pData;
-
-	//Copy the pixel color into the pixel constant buffer
-	pixelBufferPtr->pixelColor = fontColor;
-
-	//Unlock the pixel constant buffer
-	deviceContext->Unmap(this->m_pixelBuffer, 0);
-
 	//Set shader texture resource in the pixel shader
 	deviceContext->PSSetShaderResources(0, 1, &texture);
 
 	//Now set the constant buffer in the vertex shader with the updated values
 	deviceContext->VSSetConstantBuffers(0, 1, &this->m_constantBuffer);
 
-	//Now set the pixel constant buffer in the pixel shader with the updated value
-	deviceContext->PSSetConstantBuffers(0, 1, &this->m_pixelBuffer);
-
 	return true;
 }
 
-void FontShader::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount)
+void FontShader::RenderShader(ID3D11DeviceContext* deviceContext, int indexCount, bool distanceField)
 {
 	//Set the vertex input layout
 	deviceContext->IASetInputLayout(this->m_inputLayout);
 
-	//Set the vertex and pixel shaders that will be used to render the triangles
+	//Set the vertex and pixel shaders that will be used to render the triangles. Distance field atlases are resolved to a sharp edge at any scale
 	deviceContext->VSSetShader(this->m_vertexShader, nullptr, 0);
-	deviceContext->PSSetShader(this->m_pixelShader, nullptr, 0);
+	deviceContext->PSSetShader(distanceField ? this->m_distanceFieldPixelShader : this->m_pixelShader, nullptr, 0);
 
 	//Set the sampler state in the pixel shader
 	deviceContext->PSSetSamplers(0, 1, &this->m_samplerState);
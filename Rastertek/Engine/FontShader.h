@@ -30,16 +30,11 @@ private:
 		D3DXMATRIX projection;
 	};
 
-	struct PixelBufferType
-	{
-		D3DXCOLOR pixelColor;
-	};
-
 	ID3D11VertexShader* m_vertexShader;
 	ID3D11PixelShader* m_pixelShader;
+	ID3D11PixelShader* m_distanceFieldPixelShader;
 	ID3D11InputLayout* m_inputLayout;
 	ID3D11Buffer* m_constantBuffer;
-	ID3D11Buffer* m_pixelBuffer;
 	ID3D11SamplerState* m_samplerState;
 
 public:
@@ -49,15 +44,15 @@ public:
 
 	bool Initialize(ID3D11Device* device, HWND hwnd);
 	void Shutdown();
-	bool Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, D3DXCOLOR fontColor);
+	bool Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, bool distanceField);
 
 private:
-	bool InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFileName, WCHAR* psFileName);
+	bool InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFileName, WCHAR* psFileName, WCHAR* sdfPsFileName);
 	void ShutdownShaders();
 	void OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFileName);
 
-	bool SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture, D3DXCOLOR fontColor);
-	void RenderShader(ID3D11DeviceContext* deviceContext, int indexCount);
+	bool SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture);
+	void RenderShader(ID3D11DeviceContext* deviceContext, int indexCount, bool distanceField);
 };
 
 #endif
\ No newline at end of file
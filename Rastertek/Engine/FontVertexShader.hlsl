@@ -19,12 +19,14 @@ struct VertexInputType
 {
 	float4 position : POSITION;
 	float2 tex : TEXCOORD0;
+	float4 color : COLOR;
 };
 
 struct PixelInputType
 {
 	float4 position : SV_POSITION;
 	float2 tex : TEXCOORD0;
+	float4 color : COLOR;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -45,5 +47,8 @@ PixelInputType main(VertexInputType input)
 	//Store the texture coordinates for the pixel shader
 	output.tex = input.tex;
 
+	//Pass the sentence color through to the pixel shader
+	output.color = input.color;
+
 	return output;
 }
\ No newline at end of file
@@ -27,16 +27,25 @@ void Fps::Initialize()
 void Fps::Frame()
 {
 	this->m_count++;
-	if (timeGetTime() >= (this->m_startTime + 1000))
+	if (Fps::GetMilliseconds() >= (this->m_startTime + 1000))
 	{
 		this->m_fps = this->m_count;
 		this->m_count = 0;
 
-		this->m_startTime = timeGetTime();
+		this->m_startTime = Fps::GetMilliseconds();
 	}
 }
 
 int Fps::GetFps()
 {
 	return this->m_fps;
+}
+
+unsigned long Fps::GetMilliseconds()
+{
+#ifdef _WIN32
+	return timeGetTime();
+#else
+	return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
 }
\ No newline at end of file
@@ -8,14 +8,20 @@
 /////////////
 // LINKING //
 /////////////
+#ifdef _WIN32
 #pragma comment(lib, "winmm.lib")
+#endif
 
 
 //////////////
 // INCLUDES //
 //////////////
+#ifdef _WIN32
 #include <windows.h>
 #include <mmsystem.h>
+#else
+#include <chrono>
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Fps
@@ -25,7 +31,7 @@ class Fps
 private:
 	int m_fps;
 	int m_count;
-	ULONG m_startTime;
+	unsigned long m_startTime;
 
 public:
 	Fps();
@@ -35,6 +41,9 @@ public:
 	void Initialize();
 	void Frame();
 	int GetFps();
+
+private:
+	unsigned long GetMilliseconds();
 };
 
 #endif
\ No newline at end of file
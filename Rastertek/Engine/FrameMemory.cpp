@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FrameMemory.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "FrameMemory.h"
+
+
+FrameMemory::FrameMemory()
+{
+	this->m_Jobs = nullptr;
+	this->m_scratch = nullptr;
+	this->m_scratchCount = 0;
+	this->m_heapAllocationCount = 0;
+	this->m_frameHeapAllocationCount = 0;
+}
+
+FrameMemory::FrameMemory(const FrameMemory& other)
+{
+}
+
+
+FrameMemory::~FrameMemory()
+{
+}
+
+bool FrameMemory::Initialize(JobSystem* jobs, size_t frameSize, size_t scratchSize)
+{
+	bool result;
+	int i;
+
+	if (!jobs)
+	{
+		return false;
+	}
+	this->m_Jobs = jobs;
+
+	result = this->m_frame.Initialize(frameSize);
+	if (!result)
+	{
+		return false;
+	}
+
+	//A scratch arena for each job thread, made up front so no thread ever has to make one in the middle of a frame
+	//The last thread index is shared by every outside thread, they cannot rewind one arena between them so they get none
+	this->m_scratchCount = jobs->GetThreadSlotCount() - 1;
+	this->m_scratch = new LinearAllocator[this->m_scratchCount];
+	if (!this->m_scratch)
+	{
+		return false;
+	}
+
+	for (i = 0; i < this->m_scratchCount; i++)
+	{
+		result = this->m_scratch[i].Initialize(scratchSize);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	this->m_heapAllocationCount = FrameMemory::GetHeapAllocationCount();
+	this->m_frameHeapAllocationCount = 0;
+
+	return true;
+}
+
+void FrameMemory::Shutdown()
+{
+	int i;
+
+	if (this->m_scratch)
+	{
+		for (i = 0; i < this->m_scratchCount; i++)
+		{
+			this->m_scratch[i].Shutdown();
+		}
+		delete[] this->m_scratch;
+		this->m_scratch = nullptr;
+	}
+	this->m_scratchCount = 0;
+
+	this->m_frame.Shutdown();
+	this->m_Jobs = nullptr;
+}
+
+void* FrameMemory::AllocateFrame(size_t size, size_t alignment)
+{
+	return this->m_frame.Allocate(size, alignment);
+}
+
+void* FrameMemory::AllocateScratch(size_t size, size_t alignment)
+{
+	LinearAllocator* scratch;
+
+	scratch = FrameMemory::GetScratch();
+	if (!scratch)
+	{
+		return this->m_frame.Allocate(size, alignment);
+	}
+
+	return scratch->Allocate(size, alignment);
+}
+
+size_t FrameMemory::GetScratchMarker()
+{
+	LinearAllocator* scratch;
+
+	scratch = FrameMemory::GetScratch();
+	if (!scratch)
+	{
+		return 0;
+	}
+
+	return scratch->GetMarker();
+}
+
+void FrameMemory::RewindScratch(size_t marker)
+{
+	LinearAllocator* scratch;
+
+	//Without a scratch arena the memory came from the shared frame arena, which only goes back at the end of the frame
+	scratch = FrameMemory::GetScratch();
+	if (scratch)
+	{
+		scratch->Rewind(marker);
+	}
+}
+
+void FrameMemory::EndFrame()
+{
+	PROFILE_SCOPE("FrameMemory::EndFrame");
+
+	unsigned long long count;
+	int i;
+
+	this->m_frame.Reset();
+	for (i = 0; i < this->m_scratchCount; i++)
+	{
+		this->m_scratch[i].Reset();
+	}
+
+	//The heap allocations the arenas made over the frame, spills and growth, none once the arenas fit the frame
+	count = FrameMemory::GetHeapAllocationCount();
+	this->m_frameHeapAllocationCount = count - this->m_heapAllocationCount;
+	this->m_heapAllocationCount = count;
+}
+
+unsigned long long FrameMemory::GetHeapAllocationCount()
+{
+	unsigned long long count;
+	int i;
+
+	count = this->m_frame.GetHeapAllocationCount();
+	for (i = 0; i < this->m_scratchCount; i++)
+	{
+		count += this->m_scratch[i].GetHeapAllocationCount();
+	}
+
+	return count;
+}
+
+unsigned long long FrameMemory::GetFrameHeapAllocationCount()
+{
+	return this->m_frameHeapAllocationCount;
+}
+
+size_t FrameMemory::GetFramePeak()
+{
+	return this->m_frame.GetPeak();
+}
+
+size_t FrameMemory::GetScratchPeak()
+{
+	size_t peak;
+	int i;
+
+	peak = 0;
+	for (i = 0; i < this->m_scratchCount; i++)
+	{
+		if (this->m_scratch[i].GetPeak() > peak)
+		{
+			peak = this->m_scratch[i].GetPeak();
+		}
+	}
+
+	return peak;
+}
+
+LinearAllocator* FrameMemory::GetScratch()
+{
+	int index;
+
+	index = this->m_Jobs->GetThreadIndex();
+	if (index >= this->m_scratchCount)
+	{
+		return nullptr;
+	}
+
+	return &this->m_scratch[index];
+}
+
+ScratchScope::ScratchScope(FrameMemory* frameMemory)
+{
+	this->m_FrameMemory = frameMemory;
+	this->m_marker = frameMemory->GetScratchMarker();
+}
+
+ScratchScope::ScratchScope(const ScratchScope& other)
+{
+	this->m_FrameMemory = nullptr;
+	this->m_marker = 0;
+}
+
+
+ScratchScope::~ScratchScope()
+{
+	if (this->m_FrameMemory)
+	{
+		this->m_FrameMemory->RewindScratch(this->m_marker);
+	}
+}
+
+void* ScratchScope::Allocate(size_t size, size_t alignment)
+{
+	return this->m_FrameMemory->AllocateScratch(size, alignment);
+}
\ No newline at end of file
@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FrameMemory.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _FRAMEMEMORY_H_
+#define _FRAMEMEMORY_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <cstddef>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "LinearAllocator.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Bytes the frame arena and each thread's scratch arena start with, both grow at the end of a frame that needed more
+const size_t FRAME_MEMORY_FRAME_SIZE = 4 * 1024 * 1024;
+const size_t FRAME_MEMORY_SCRATCH_SIZE = 1024 * 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: FrameMemory
+////////////////////////////////////////////////////////////////////////////////
+
+//Memory that only has to last the frame, so nothing the frame does needs the heap once the arenas have grown to fit
+//The frame arena is shared by every thread, the scratch arenas are one to each job thread and can give memory back early with a marker
+//A thread outside the job system has no scratch arena of its own, it gets frame memory and its markers do nothing
+//Everything goes at EndFrame, so data a later pipeline stage reads has to stay in the frame slot instead
+class FrameMemory
+{
+private:
+	JobSystem* m_Jobs;
+	LinearAllocator m_frame;
+	LinearAllocator* m_scratch;
+	int m_scratchCount;
+	unsigned long long m_heapAllocationCount;
+	unsigned long long m_frameHeapAllocationCount;
+
+public:
+	FrameMemory();
+	FrameMemory(const FrameMemory& other);
+	~FrameMemory();
+
+	bool Initialize(JobSystem* jobs, size_t frameSize, size_t scratchSize);
+	void Shutdown();
+
+	void* AllocateFrame(size_t size, size_t alignment);
+	void* AllocateScratch(size_t size, size_t alignment);
+	size_t GetScratchMarker();
+	void RewindScratch(size_t marker);
+
+	//Every thread has to be done with the frame, the pipeline waits for its jobs before this
+	void EndFrame();
+
+	unsigned long long GetHeapAllocationCount();
+	unsigned long long GetFrameHeapAllocationCount();
+	size_t GetFramePeak();
+	size_t GetScratchPeak();
+
+private:
+	LinearAllocator* GetScratch();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ScratchScope
+////////////////////////////////////////////////////////////////////////////////
+
+//Takes a scratch marker when it is made and rewinds to it when it goes out of scope, so every way out of a function gives the memory back
+class ScratchScope
+{
+private:
+	FrameMemory* m_FrameMemory;
+	size_t m_marker;
+
+public:
+	ScratchScope(FrameMemory* frameMemory);
+	ScratchScope(const ScratchScope& other);
+	~ScratchScope();
+
+	void* Allocate(size_t size, size_t alignment);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FramePipeline.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "FramePipeline.h"
+
+
+FramePipeline::FramePipeline()
+{
+	this->m_Stages = nullptr;
+	this->m_Jobs = nullptr;
+	this->m_simulateFrame = nullptr;
+	this->m_buildFrame = nullptr;
+	this->m_simulatedCount = 0;
+	this->m_builtCount = 0;
+	this->m_submittedCount = 0;
+	this->m_frameBegun = false;
+}
+
+FramePipeline::FramePipeline(const FramePipeline& other)
+{
+}
+
+
+FramePipeline::~FramePipeline()
+{
+}
+
+bool FramePipeline::Initialize(FrameStages* stages, JobSystem* jobs)
+{
+	if (!stages || !jobs)
+	{
+		return false;
+	}
+
+	this->m_Stages = stages;
+	this->m_Jobs = jobs;
+	this->m_simulatedCount = 0;
+	this->m_builtCount = 0;
+	this->m_submittedCount = 0;
+	this->m_frameBegun = false;
+
+	return true;
+}
+
+void FramePipeline::Shutdown()
+{
+	int i;
+
+	//Every step waits for its jobs, so nothing is running between frames and the frames in flight can just go
+	for (i = 0; i < FRAME_PIPELINE_DEPTH; i++)
+	{
+		this->m_frames[i].objects.clear();
+	}
+	this->m_Stages = nullptr;
+	this->m_Jobs = nullptr;
+}
+
+FrameStages::FrameDataType* FramePipeline::BeginFrame()
+{
+	FrameStages::FrameDataType* frame;
+
+	//The slot of the frame submitted last step is free again, the vectors keep their memory from three frames ago
+	frame = &this->m_frames[this->m_simulatedCount % FRAME_PIPELINE_DEPTH];
+	frame->number = this->m_simulatedCount;
+	frame->frameTime = 0.0f;
+	frame->buttons = 0;
+	frame->tickCount = 0;
+	frame->cameraPosition[0] = 0.0f;
+	frame->cameraPosition[1] = 0.0f;
+	frame->cameraPosition[2] = 0.0f;
+	frame->objects.clear();
+	this->m_frameBegun = true;
+
+	return frame;
+}
+
+bool FramePipeline::RunFrame()
+{
+	bool result;
+
+	if (!this->m_frameBegun)
+	{
+		return false;
+	}
+
+	result = FramePipeline::Step(true);
+	this->m_frameBegun = false;
+
+	return result;
+}
+
+bool FramePipeline::Flush()
+{
+	bool result;
+
+	//Build and submit what is still in flight, for shutting down or for a headless run that wants every frame out
+	while (this->m_submittedCount < this->m_simulatedCount)
+	{
+		result = FramePipeline::Step(false);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+unsigned long long FramePipeline::GetSubmittedCount()
+{
+	return this->m_submittedCount;
+}
+
+int FramePipeline::GetFramesInFlight()
+{
+	return (int)(this->m_simulatedCount - this->m_submittedCount);
+}
+
+bool FramePipeline::Step(bool simulate)
+{
+	PROFILE_SCOPE("FramePipeline::Step");
+
+	JobCounter counter;
+	FrameStages::FrameDataType* submitFrame;
+	bool result;
+
+	//Each stage works on a different slot, so nothing is shared within a step and the wait at the end hands the slots on
+	this->m_simulateFrame = simulate ? &this->m_frames[this->m_simulatedCount % FRAME_PIPELINE_DEPTH] : nullptr;
+	this->m_buildFrame = this->m_builtCount < this->m_simulatedCount ? &this->m_frames[this->m_builtCount % FRAME_PIPELINE_DEPTH] : nullptr;
+	submitFrame = this->m_submittedCount < this->m_builtCount ? &this->m_frames[this->m_submittedCount % FRAME_PIPELINE_DEPTH] : nullptr;
+
+	if (this->m_simulateFrame)
+	{
+		this->m_Jobs->Run(FramePipeline::SimulateJob, this, &counter);
+	}
+	if (this->m_buildFrame)
+	{
+		this->m_Jobs->Run(FramePipeline::BuildJob, this, &counter);
+	}
+
+	//Submitting stays on this thread while the jobs run beside it
+	result = true;
+	if (submitFrame)
+	{
+		result = this->m_Stages->Submit(*submitFrame);
+	}
+
+	this->m_Jobs->Wait(&counter);
+
+	if (this->m_simulateFrame)
+	{
+		this->m_simulatedCount++;
+	}
+	if (this->m_buildFrame)
+	{
+		this->m_builtCount++;
+	}
+	if (submitFrame)
+	{
+		this->m_submittedCount++;
+	}
+
+	return result;
+}
+
+void FramePipeline::SimulateJob(void* data)
+{
+	FramePipeline* pipeline;
+
+	pipeline = (FramePipeline*)data;
+	pipeline->m_Stages->Simulate(*pipeline->m_simulateFrame);
+}
+
+void FramePipeline::BuildJob(void* data)
+{
+	FramePipeline* pipeline;
+
+	pipeline = (FramePipeline*)data;
+	pipeline->m_Stages->Build(*pipeline->m_buildFrame);
+}
\ No newline at end of file
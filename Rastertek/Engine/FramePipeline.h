@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FramePipeline.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _FRAMEPIPELINE_H_
+#define _FRAMEPIPELINE_H_
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "FrameStages.h"
+#include "JobSystem.h"
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Frame N is simulated while N-1 is built and N-2 is submitted, so three frames of data are in flight
+const int FRAME_PIPELINE_DEPTH = 3;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: FramePipeline
+////////////////////////////////////////////////////////////////////////////////
+class FramePipeline
+{
+private:
+	FrameStages* m_Stages;
+	JobSystem* m_Jobs;
+	FrameStages::FrameDataType m_frames[FRAME_PIPELINE_DEPTH];
+	FrameStages::FrameDataType* m_simulateFrame;
+	FrameStages::FrameDataType* m_buildFrame;
+	unsigned long long m_simulatedCount;
+	unsigned long long m_builtCount;
+	unsigned long long m_submittedCount;
+	bool m_frameBegun;
+
+public:
+	FramePipeline();
+	FramePipeline(const FramePipeline& other);
+	~FramePipeline();
+
+	bool Initialize(FrameStages* stages, JobSystem* jobs);
+	void Shutdown();
+
+	FrameStages::FrameDataType* BeginFrame();
+	bool RunFrame();
+	bool Flush();
+
+	unsigned long long GetSubmittedCount();
+	int GetFramesInFlight();
+
+private:
+	bool Step(bool simulate);
+	static void SimulateJob(void* data);
+	static void BuildJob(void* data);
+};
+
+#endif
\ No newline at end of file
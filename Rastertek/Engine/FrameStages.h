@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FrameStages.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _FRAMESTAGES_H_
+#define _FRAMESTAGES_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: FrameStages
+////////////////////////////////////////////////////////////////////////////////
+
+//The three steps of a frame the pipeline overlaps, each one owns its frame's data while it runs
+//Simulate and Build run on job threads, Submit runs on the thread that drives the pipeline so it can use the device
+class FrameStages
+{
+public:
+	struct ObjectType
+	{
+		int model;
+		float position[3];
+		float radius;
+	};
+
+	struct FrameDataType
+	{
+		unsigned long long number;
+		float frameTime;
+		unsigned int buttons;
+		int tickCount;
+		float cameraPosition[3];
+		vector<ObjectType> objects;
+	};
+
+public:
+	virtual ~FrameStages() {}
+
+	//Input and simulation, fills in the camera and the objects
+	virtual void Simulate(FrameDataType& frame) = 0;
+
+	//Culling and recording the draws from what the simulation left, the stage keeps what it records until Submit
+	virtual void Build(FrameDataType& frame) = 0;
+
+	virtual bool Submit(FrameDataType& frame) = 0;
+};
+
+#endif
\ No newline at end of file
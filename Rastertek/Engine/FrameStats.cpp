@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FrameStats.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "FrameStats.h"
+
+
+FrameStats::FrameStats()
+{
+	this->m_history = nullptr;
+	this->m_historyCount = 0;
+	this->m_historyWrite = 0;
+	this->m_recent = nullptr;
+	this->m_buckets = nullptr;
+	this->m_frameCount = 0;
+	this->m_hitchCount = 0;
+	this->m_minimum = 0.0f;
+	this->m_maximum = 0.0f;
+	this->m_mean = 0.0;
+	this->m_squares = 0.0;
+}
+
+FrameStats::FrameStats(const FrameStats& other)
+{
+}
+
+
+FrameStats::~FrameStats()
+{
+}
+
+bool FrameStats::Initialize()
+{
+	this->m_history = new FrameType[FRAME_STATS_HISTORY];
+	if (!this->m_history)
+	{
+		return false;
+	}
+
+	this->m_recent = new float[FRAME_STATS_MEDIAN_FRAMES];
+	if (!this->m_recent)
+	{
+		return false;
+	}
+
+	this->m_buckets = new unsigned int[FRAME_STATS_BUCKETS];
+	if (!this->m_buckets)
+	{
+		return false;
+	}
+
+	FrameStats::Reset();
+
+	return true;
+}
+
+void FrameStats::Shutdown()
+{
+	if (this->m_buckets)
+	{
+		delete[] this->m_buckets;
+		this->m_buckets = nullptr;
+	}
+
+	if (this->m_recent)
+	{
+		delete[] this->m_recent;
+		this->m_recent = nullptr;
+	}
+
+	if (this->m_history)
+	{
+		delete[] this->m_history;
+		this->m_history = nullptr;
+	}
+}
+
+void FrameStats::Reset()
+{
+	memset(this->m_buckets, 0, sizeof(unsigned int) * FRAME_STATS_BUCKETS);
+	this->m_historyCount = 0;
+	this->m_historyWrite = 0;
+	this->m_frameCount = 0;
+	this->m_hitchCount = 0;
+	this->m_minimum = 0.0f;
+	this->m_maximum = 0.0f;
+	this->m_mean = 0.0;
+	this->m_squares = 0.0;
+}
+
+bool FrameStats::AddFrame(float frameTime)
+{
+	FrameType* frame;
+	double microseconds;
+	double delta;
+	float median;
+	int recentCount;
+	int i;
+	bool hitch;
+
+	if (frameTime < 0.0f)
+	{
+		frameTime = 0.0f;
+	}
+
+	//Judge the frame against the median of the ones before it, so a run of slow frames stops being hitches
+	recentCount = min(this->m_historyCount, FRAME_STATS_MEDIAN_FRAMES);
+	for (i = 0; i < recentCount; i++)
+	{
+		this->m_recent[i] = this->m_history[(this->m_historyWrite - 1 - i + FRAME_STATS_HISTORY) % FRAME_STATS_HISTORY].time;
+	}
+
+	median = 0.0f;
+	hitch = false;
+	if (recentCount >= FRAME_STATS_MEDIAN_FRAMES / 4)
+	{
+		nth_element(this->m_recent, this->m_recent + recentCount / 2, this->m_recent + recentCount);
+		median = this->m_recent[recentCount / 2];
+		hitch = frameTime > median * FRAME_STATS_HITCH_FACTOR && frameTime > FRAME_STATS_HITCH_MINIMUM;
+	}
+
+	frame = &this->m_history[this->m_historyWrite];
+	frame->number = this->m_frameCount;
+	frame->time = frameTime;
+	frame->median = median;
+	frame->hitch = hitch;
+	this->m_historyWrite = (this->m_historyWrite + 1) % FRAME_STATS_HISTORY;
+	this->m_historyCount = min(this->m_historyCount + 1, FRAME_STATS_HISTORY);
+
+	//The histogram keeps every frame since the reset, so the percentiles cover the whole run in fixed memory
+	microseconds = floor((double)frameTime * 1000.0 + 0.5);
+	if (microseconds > 4294967295.0)
+	{
+		microseconds = 4294967295.0;
+	}
+	this->m_buckets[FrameStats::GetBucket((unsigned int)microseconds)]++;
+
+	if (this->m_frameCount == 0)
+	{
+		this->m_minimum = frameTime;
+		this->m_maximum = frameTime;
+	}
+	this->m_minimum = min(this->m_minimum, frameTime);
+	this->m_maximum = max(this->m_maximum, frameTime);
+
+	//Welford's update keeps the deviation accurate over millions of frames
+	this->m_frameCount++;
+	delta = frameTime - this->m_mean;
+	this->m_mean += delta / (double)this->m_frameCount;
+	this->m_squares += delta * (frameTime - this->m_mean);
+
+	if (hitch)
+	{
+		this->m_hitchCount++;
+	}
+
+	return hitch;
+}
+
+unsigned long long FrameStats::GetFrameCount()
+{
+	return this->m_frameCount;
+}
+
+unsigned long long FrameStats::GetHitchCount()
+{
+	return this->m_hitchCount;
+}
+
+float FrameStats::GetPercentile(float percent)
+{
+	unsigned long long target;
+	unsigned long long count;
+	float value;
+	int i;
+
+	if (this->m_frameCount == 0)
+	{
+		return 0.0f;
+	}
+
+	//The nearest rank, the smallest frame time that at least this share of the frames are no longer than
+	target = (unsigned long long)ceil((double)percent / 100.0 * (double)this->m_frameCount);
+	target = max(target, 1ULL);
+	target = min(target, this->m_frameCount);
+
+	count = 0;
+	for (i = 0; i < FRAME_STATS_BUCKETS; i++)
+	{
+		count += this->m_buckets[i];
+		if (count >= target)
+		{
+			break;
+		}
+	}
+
+	value = FrameStats::GetBucketValue(i);
+	value = max(value, this->m_minimum);
+	value = min(value, this->m_maximum);
+
+	return value;
+}
+
+float FrameStats::GetMean()
+{
+	return (float)this->m_mean;
+}
+
+float FrameStats::GetMinimum()
+{
+	return this->m_minimum;
+}
+
+float FrameStats::GetMaximum()
+{
+	return this->m_maximum;
+}
+
+float FrameStats::GetStandardDeviation()
+{
+	if (this->m_frameCount < 2)
+	{
+		return 0.0f;
+	}
+
+	return (float)sqrt(this->m_squares / (double)(this->m_frameCount - 1));
+}
+
+float FrameStats::GetMedian()
+{
+	return FrameStats::GetPercentile(50.0f);
+}
+
+bool FrameStats::SaveCsv(const char* fileName)
+{
+	FILE* file;
+	FrameType* frame;
+	int i;
+	bool result;
+
+	file = fopen(fileName, "w");
+	if (!file)
+	{
+		return false;
+	}
+
+	//The kept frames oldest first, with the median each one was judged against
+	fprintf(file, "frame,milliseconds,median,hitch\n");
+	for (i = 0; i < this->m_historyCount; i++)
+	{
+		frame = &this->m_history[(this->m_historyWrite - this->m_historyCount + i + FRAME_STATS_HISTORY) % FRAME_STATS_HISTORY];
+		fprintf(file, "%llu,%.4f,%.4f,%d\n", frame->number, frame->time, frame->median, frame->hitch ? 1 : 0);
+	}
+
+	result = ferror(file) == 0;
+	if (fclose(file) != 0)
+	{
+		return false;
+	}
+
+	return result;
+}
+
+int FrameStats::GetBucket(unsigned int microseconds)
+{
+	int shift;
+
+	//Values below two steps' worth map one to one, above that each power of two gets the same number of steps
+	shift = 0;
+	while ((microseconds >> shift) >= (unsigned int)(FRAME_STATS_SUB_BUCKETS * 2))
+	{
+		shift++;
+	}
+
+	return shift * FRAME_STATS_SUB_BUCKETS + (int)(microseconds >> shift);
+}
+
+float FrameStats::GetBucketValue(int bucket)
+{
+	int shift;
+	unsigned long long low;
+
+	shift = bucket / FRAME_STATS_SUB_BUCKETS - 1;
+	if (shift < 0)
+	{
+		shift = 0;
+	}
+	low = (unsigned long long)(bucket - shift * FRAME_STATS_SUB_BUCKETS) << shift;
+
+	//The middle of the bucket halves the worst error
+	return (float)(((double)low + (double)((1ULL << shift) - 1) / 2.0) / 1000.0);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: FrameStats.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _FRAMESTATS_H_
+#define _FRAMESTATS_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Frames kept for the export and the hitch median
+const int FRAME_STATS_HISTORY = 1024;
+const int FRAME_STATS_MEDIAN_FRAMES = 60;
+
+//A hitch is a frame this many times the recent median and longer than the minimum in milliseconds
+const float FRAME_STATS_HITCH_FACTOR = 2.0f;
+const float FRAME_STATS_HITCH_MINIMUM = 4.0f;
+
+//The histogram counts microseconds with 128 steps per power of two, every value is within 0.8% of its bucket
+const int FRAME_STATS_SUB_BUCKET_BITS = 7;
+const int FRAME_STATS_SUB_BUCKETS = 1 << FRAME_STATS_SUB_BUCKET_BITS;
+const int FRAME_STATS_BUCKETS = (32 - FRAME_STATS_SUB_BUCKET_BITS) * FRAME_STATS_SUB_BUCKETS + FRAME_STATS_SUB_BUCKETS;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: FrameStats
+////////////////////////////////////////////////////////////////////////////////
+class FrameStats
+{
+private:
+	struct FrameType
+	{
+		unsigned long long number;
+		float time;
+		float median;
+		bool hitch;
+	};
+
+	FrameType* m_history;
+	int m_historyCount;
+	int m_historyWrite;
+	float* m_recent;
+
+	unsigned int* m_buckets;
+	unsigned long long m_frameCount;
+	unsigned long long m_hitchCount;
+	float m_minimum;
+	float m_maximum;
+	double m_mean;
+	double m_squares;
+
+public:
+	FrameStats();
+	FrameStats(const FrameStats& other);
+	~FrameStats();
+
+	bool Initialize();
+	void Shutdown();
+	void Reset();
+
+	bool AddFrame(float frameTime);
+
+	unsigned long long GetFrameCount();
+	unsigned long long GetHitchCount();
+	float GetPercentile(float percent);
+	float GetMean();
+	float GetMinimum();
+	float GetMaximum();
+	float GetStandardDeviation();
+	float GetMedian();
+
+	bool SaveCsv(const char* fileName);
+
+private:
+	static int GetBucket(unsigned int microseconds);
+	static float GetBucketValue(int bucket);
+};
+
+#endif
\ No newline at end of file
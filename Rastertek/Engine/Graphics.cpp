@@ -6,10 +6,20 @@
 
 Graphics::Graphics()
 {
+	int i;
+
 	this->m_Direct3D = nullptr;
+	this->m_TextureManager = nullptr;
 	this->m_Camera = nullptr;
-	this->m_Model = nullptr;
 	this->m_DepthShader = nullptr;
+	this->m_Jobs = nullptr;
+	this->m_Commands = nullptr;
+
+	//Draws name models by id, each id has the handle of its model in the pool
+	for (i = 0; i < GRAPHICS_MODEL_CAPACITY; i++)
+	{
+		this->m_modelHandles[i] = ObjectPool<Model>::GetNullHandle();
+	}
 }
 
 Graphics::Graphics(const Graphics& other)
@@ -20,9 +30,15 @@ Graphics::~Graphics()
 {
 }
 
-bool Graphics::Initialize(int screenWidth, int screenHeight, HWND hwnd)
+bool Graphics::Initialize(int screenWidth, int screenHeight, HWND hwnd, JobSystem* jobs, FrameMemory* frameMemory)
 {
+	PROFILE_SCOPE("Graphics::Initialize");
+
+	Model* model;
 	bool result;
+	int i;
+
+	this->m_Jobs = jobs;
 
 	//Create the Direct3D object
 	this->m_Direct3D = new Direct3D();
@@ -39,6 +55,20 @@ bool Graphics::Initialize(int screenWidth, int screenHeight, HWND hwnd)
 		return false;
 	}
 
+	//Create the TextureManager object
+	this->m_TextureManager = new TextureManager();
+	if (!this->m_TextureManager)
+	{
+		return false;
+	}
+
+	//Initialize the TextureManager object, textures nothing uses are kept loaded up to the budget
+	result = this->m_TextureManager->Initialize(TEXTURE_BUDGET);
+	if (!result)
+	{
+		return false;
+	}
+
 	//Create the camera object
 	this->m_Camera = new Camera();
 	if (!this->m_Camera)
@@ -49,15 +79,23 @@ bool Graphics::Initialize(int screenWidth, int screenHeight, HWND hwnd)
 	// Set the initial position of the camera.
 	this->m_Camera->SetPosition(D3DXVECTOR3(0.0f, 2.0f, -10.0f));
 
+	//Models live in a pool and are found by handle, a handle to one that has been released finds nothing
+	result = this->m_Models.Initialize(GRAPHICS_MODEL_CAPACITY);
+	if (!result)
+	{
+		return false;
+	}
+
 	//Create the Model object
-	this->m_Model = new Model();
-	if (!this->m_Model)
+	this->m_modelHandles[GRAPHICS_FLOOR_MODEL] = this->m_Models.Create();
+	model = this->m_Models.Get(this->m_modelHandles[GRAPHICS_FLOOR_MODEL]);
+	if (!model)
 	{
 		return false;
 	}
 
 	//Initialize the Model object
-	result = this->m_Model->Initialize(this->m_Direct3D->GetDevice(), "floor.txt");
+	result = model->Initialize(this->m_Direct3D->GetDevice(), frameMemory, "floor.txt");
 	if (!result)
 	{
 		MessageBox(hwnd, L"Could not initialize the Model object.", L"Error", MB_OK);
@@ -79,11 +117,42 @@ bool Graphics::Initialize(int screenWidth, int screenHeight, HWND hwnd)
 		return false;
 	}
 
+	// Create a CommandRecorder for each frame the pipeline has in flight, one is recorded while an older one is replayed.
+	this->m_Commands = new CommandRecorder[FRAME_PIPELINE_DEPTH];
+	if (!this->m_Commands)
+	{
+		return false;
+	}
+
+	for (i = 0; i < FRAME_PIPELINE_DEPTH; i++)
+	{
+		result = this->m_Commands[i].Initialize(jobs);
+		if (!result)
+		{
+			return false;
+		}
+	}
+
 	return true;
 }
 
 void Graphics::Shutdown()
 {
+	Model* model;
+	int i;
+
+	// Release the CommandRecorder objects.
+	if (this->m_Commands)
+	{
+		for (i = 0; i < FRAME_PIPELINE_DEPTH; i++)
+		{
+			this->m_Commands[i].Shutdown();
+		}
+
+		delete[] this->m_Commands;
+		this->m_Commands = nullptr;
+	}
+
 	//Release the DepthShader object.
 	if (this->m_DepthShader)
 	{
@@ -92,13 +161,18 @@ void Graphics::Shutdown()
 		this->m_DepthShader = nullptr;
 	}
 
-	// Release the Model object.
-	if (this->m_Model)
+	// Release the Model objects and the pool they live in.
+	for (i = 0; i < GRAPHICS_MODEL_CAPACITY; i++)
 	{
-		this->m_Model->Shutdown();
-		delete this->m_Model;
-		this->m_Model = nullptr;
+		model = this->m_Models.Get(this->m_modelHandles[i]);
+		if (model)
+		{
+			model->Shutdown();
+			this->m_Models.Destroy(this->m_modelHandles[i]);
+		}
+		this->m_modelHandles[i] = ObjectPool<Model>::GetNullHandle();
 	}
+	this->m_Models.Shutdown();
 
 	//Release the Camera object
 	if (this->m_Camera)
@@ -107,6 +181,14 @@ void Graphics::Shutdown()
 		this->m_Camera = nullptr;
 	}
 
+	//Release the TextureManager object
+	if (this->m_TextureManager)
+	{
+		this->m_TextureManager->Shutdown();
+		delete this->m_TextureManager;
+		this->m_TextureManager = nullptr;
+	}
+
 	//Release the Direct3D object
 	if (this->m_Direct3D)
 	{
@@ -116,12 +198,17 @@ void Graphics::Shutdown()
 	}
 }
 
-bool Graphics::Frame()
+bool Graphics::Frame(FrameStages::FrameDataType& frame)
 {
+	PROFILE_SCOPE("Graphics::Frame");
+
 	bool result;
 
+	// Place the camera where the simulation had it for this frame.
+	this->m_Camera->SetPosition(D3DXVECTOR3(frame.cameraPosition[0], frame.cameraPosition[1], frame.cameraPosition[2]));
+
 	// Render the scene.
-	result = Graphics::Render();
+	result = Graphics::Render(frame);
 	if (!result)
 	{
 		return false;
@@ -130,13 +217,84 @@ bool Graphics::Frame()
 	return true;
 }
 
-bool Graphics::Render()
+void Graphics::BuildFrame(FrameStages::FrameDataType& frame)
 {
-	bool result;
+	PROFILE_SCOPE("Graphics::BuildFrame");
+
+	BuildType build;
+	JobCounter counter;
+
+	//This runs on a job thread beside the submit of an older frame, so it only records and never touches the device or the camera
+	build.frame = &frame;
+	build.commands = &this->m_Commands[frame.number % FRAME_PIPELINE_DEPTH];
+	build.commands->Reset();
+
+	//Each batch of objects is culled and recorded into the buffer of whichever thread takes it, then the packets are put in key order
+	this->m_Jobs->ParallelFor(Graphics::BuildDraws, &build, (int)frame.objects.size() + 1, GRAPHICS_DRAW_BATCH, &counter);
+	this->m_Jobs->Wait(&counter);
+	build.commands->Sort();
+}
+
+D3DXVECTOR3 Graphics::GetCameraPosition()
+{
+	return this->m_Camera->GetPosition();
+}
 
+bool Graphics::Execute(unsigned int type, const void* data)
+{
+	const CommandBuffer::DrawCommandType* draw;
 	D3DXMATRIX worldMatrix;
-	D3DXMATRIX viewMatrix;
-	D3DXMATRIX projectionMatrix;
+	Model* model;
+	bool result;
+
+	if (type != COMMAND_DRAW)
+	{
+		return false;
+	}
+
+	draw = (const CommandBuffer::DrawCommandType*)data;
+
+	// A model id outside the table was never handed out, so the recording is wrong.
+	if (draw->model < 0 || draw->model >= GRAPHICS_MODEL_CAPACITY)
+	{
+		return false;
+	}
+
+	// A model released after the draw was recorded leaves a stale handle behind, that draw is skipped rather than the frame.
+	model = this->m_Models.Get(this->m_modelHandles[draw->model]);
+	if (!model)
+	{
+		return true;
+	}
+
+	memcpy(&worldMatrix, draw->world, sizeof(draw->world));
+
+	// Put the model vertex and index buffers on the graphics pipeline to prepare them for drawing.
+	model->Render(this->m_Direct3D->GetDeviceContext());
+
+	// Render the Model with the shader the draw asked for, a shader id nothing answers to fails the frame like a bad model id.
+	switch (draw->shader)
+	{
+	case GRAPHICS_DEPTH_SHADER:
+		result = this->m_DepthShader->Render(this->m_Direct3D->GetDeviceContext(), model->GetIndexCount(), worldMatrix, this->m_viewMatrix, this->m_projectionMatrix);
+		break;
+	default:
+		result = false;
+		break;
+	}
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool Graphics::Render(FrameStages::FrameDataType& frame)
+{
+	PROFILE_SCOPE("Graphics::Render");
+
+	bool result;
 
 	// Clear the buffers to begin the scene
 	this->m_Direct3D->BeginScene(D3DXCOLOR(0.0f, 0.0f, 0.0f, 1.0f));
@@ -144,16 +302,12 @@ bool Graphics::Render()
 	// Generate the view matrix based on the camera's position.
 	this->m_Camera->Render();
 
-	// Generate the world, view and projection matrices from the camera and Direct3D objects.
-	this->m_Direct3D->GetWorldMatrix(worldMatrix);
-	this->m_Camera->GetViewMatrix(viewMatrix);
-	this->m_Direct3D->GetProjectionMatrix(projectionMatrix);
-
-	// Put the square model vertex and index buffers on the graphics pipeline to prepare them for drawing.
-	this->m_Model->Render(this->m_Direct3D->GetDeviceContext());
+	// Generate the view and projection matrices from the camera and Direct3D objects.
+	this->m_Camera->GetViewMatrix(this->m_viewMatrix);
+	this->m_Direct3D->GetProjectionMatrix(this->m_projectionMatrix);
 
-	// Render the Model using the FireShader object.
-	result = this->m_DepthShader->Render(this->m_Direct3D->GetDeviceContext(), this->m_Model->GetIndexCount(), worldMatrix, viewMatrix, projectionMatrix);
+	// Replay what the build stage recorded for this frame, in key order, through Execute.
+	result = this->m_Commands[frame.number % FRAME_PIPELINE_DEPTH].Replay(this);
 	if (!result)
 	{
 		return false;
@@ -163,4 +317,60 @@ bool Graphics::Render()
 	this->m_Direct3D->EndScene();
 
 	return true;
+}
+
+void Graphics::BuildDraws(void* data, int begin, int end)
+{
+	BuildType* build;
+	FrameStages::FrameDataType* frame;
+	CommandBuffer::DrawCommandType draw;
+	float position[3];
+	float offset[3];
+	float distance;
+	unsigned long long sortKey;
+	int i;
+	int j;
+
+	build = (BuildType*)data;
+	frame = build->frame;
+	for (i = begin; i < end; i++)
+	{
+		//The floor is the first draw, then one for each object the simulation placed
+		if (i == 0)
+		{
+			draw.model = GRAPHICS_FLOOR_MODEL;
+			memset(position, 0, sizeof(position));
+		}
+		else
+		{
+			draw.model = frame->objects[i - 1].model;
+			memcpy(position, frame->objects[i - 1].position, sizeof(position));
+		}
+
+		for (j = 0; j < 3; j++)
+		{
+			offset[j] = position[j] - frame->cameraPosition[j];
+		}
+		distance = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+
+		//Whatever is past the far plane is not drawn
+		if (i > 0 && sqrtf(distance) - frame->objects[i - 1].radius > SCREEN_DEPTH)
+		{
+			continue;
+		}
+
+		draw.shader = GRAPHICS_DEPTH_SHADER;
+		memset(draw.world, 0, sizeof(draw.world));
+		draw.world[0] = 1.0f;
+		draw.world[5] = 1.0f;
+		draw.world[10] = 1.0f;
+		draw.world[15] = 1.0f;
+		memcpy(&draw.world[12], position, sizeof(position));
+
+		//Front to back so the depth test throws away as much as it can, the bits of a positive float sort like the float
+		sortKey = 0;
+		memcpy(&sortKey, &distance, sizeof(float));
+		sortKey = (sortKey << 16) | (unsigned int)draw.model;
+		build->commands->Record(sortKey, COMMAND_DRAW, &draw, sizeof(draw));
+	}
 }
\ No newline at end of file
@@ -4,6 +4,14 @@
 #ifndef _GRAPHICS_H_
 #define _GRAPHICS_H_
 
+//////////////
+// INCLUDES //
+//////////////
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+using namespace std;
+
 ///////////////////////
 // MY CLASS INCLUDES //
 ///////////////////////
@@ -11,6 +19,14 @@
 #include "Camera.h"
 #include "Model.h"
 #include "DepthShader.h"
+#include "TextureManager.h"
+#include "Profiler.h"
+#include "FrameStages.h"
+#include "FramePipeline.h"
+#include "JobSystem.h"
+#include "FrameMemory.h"
+#include "CommandRecorder.h"
+#include "ObjectPool.h"
 
 
 /////////////
@@ -20,30 +36,55 @@ const bool FULL_SCREEN = false;
 const bool VSYNC_ENABLED = true;
 const float SCREEN_DEPTH = 100.0f;
 const float SCREEN_NEAR = 1.0f;
+const UINT64 TEXTURE_BUDGET = 128 * 1024 * 1024;
+const int GRAPHICS_FLOOR_MODEL = 0;
+const int GRAPHICS_MODEL_CAPACITY = 64;
+const int GRAPHICS_DEPTH_SHADER = 0;
+
+//Objects each build job culls and records
+const int GRAPHICS_DRAW_BATCH = 256;
 
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Graphics
 ////////////////////////////////////////////////////////////////////////////////
-class Graphics
+class Graphics : public CommandBackend
 {
 
 private:
+	struct BuildType
+	{
+		FrameStages::FrameDataType* frame;
+		CommandRecorder* commands;
+	};
+
 	Direct3D* m_Direct3D;
+	TextureManager* m_TextureManager;
 	Camera* m_Camera;
-	Model* m_Model;
+	ObjectPool<Model> m_Models;
+	ObjectPool<Model>::HandleType m_modelHandles[GRAPHICS_MODEL_CAPACITY];
 	DepthShader* m_DepthShader;
+	JobSystem* m_Jobs;
+	CommandRecorder* m_Commands;
+	D3DXMATRIX m_viewMatrix;
+	D3DXMATRIX m_projectionMatrix;
 
 public:
 	Graphics();
 	Graphics(const Graphics& other);
 	~Graphics();
 
-	bool Initialize(int screenWidth, int screenHeight, HWND hwnd);
+	bool Initialize(int screenWidth, int screenHeight, HWND hwnd, JobSystem* jobs, FrameMemory* frameMemory);
 	void Shutdown();
-	bool Frame();
+	bool Frame(FrameStages::FrameDataType& frame);
+	void BuildFrame(FrameStages::FrameDataType& frame);
+
+	D3DXVECTOR3 GetCameraPosition();
+
+	bool Execute(unsigned int type, const void* data);
 
 private:
-	bool Render();
+	bool Render(FrameStages::FrameDataType& frame);
+	static void BuildDraws(void* data, int begin, int end);
 };
 #endif
\ No newline at end of file
@@ -124,6 +124,8 @@ void Input::Shutdown()
 
 bool Input::Frame()
 {
+	PROFILE_SCOPE("Input::Frame");
+
 	bool result;
 
 	//Read the current state of the keyboard
@@ -251,3 +253,24 @@ bool Input::IsRightArrowPressed()
 	}
 	return false;
 }
+
+
+bool Input::IsF10Pressed()
+{
+	//Do a bitwise AND on the keyboard state to check if the F10 key is currently being pressed
+	if (this->m_keyboardState[DIK_F10] & 0x80)
+	{
+		return true;
+	}
+	return false;
+}
+
+bool Input::IsF11Pressed()
+{
+	//Do a bitwise AND on the keyboard state to check if the F11 key is currently being pressed
+	if (this->m_keyboardState[DIK_F11] & 0x80)
+	{
+		return true;
+	}
+	return false;
+}
@@ -20,6 +20,11 @@
 //////////////
 #include <dinput.h>
 
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "Profiler.h"
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Input
 ////////////////////////////////////////////////////////////////////////////////
@@ -50,6 +55,8 @@ public:
 	bool IsEscapePressed();
 	bool IsLeftArrowPressed();
 	bool IsRightArrowPressed();
+	bool IsF10Pressed();
+	bool IsF11Pressed();
 
 	void GetMouseLocation(int&, int&);
 	
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: JobQueue.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "JobQueue.h"
+
+
+JobQueue::JobQueue()
+{
+	this->m_entries = nullptr;
+	this->m_mask = 0;
+	this->m_top = 0;
+	this->m_bottom = 0;
+}
+
+JobQueue::JobQueue(const JobQueue& other)
+{
+}
+
+
+JobQueue::~JobQueue()
+{
+}
+
+bool JobQueue::Initialize(unsigned int capacity)
+{
+	unsigned int i;
+
+	//The indices wrap with a mask, so the size has to be a power of two
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+	{
+		return false;
+	}
+
+	this->m_entries = new atomic<void*>[capacity];
+	if (!this->m_entries)
+	{
+		return false;
+	}
+
+	for (i = 0; i < capacity; i++)
+	{
+		this->m_entries[i].store(nullptr, memory_order_relaxed);
+	}
+	this->m_mask = (long long)capacity - 1;
+	this->m_top = 0;
+	this->m_bottom = 0;
+
+	return true;
+}
+
+void JobQueue::Shutdown()
+{
+	if (this->m_entries)
+	{
+		delete[] this->m_entries;
+		this->m_entries = nullptr;
+	}
+}
+
+bool JobQueue::Push(void* item)
+{
+	long long bottom;
+	long long top;
+
+	bottom = this->m_bottom.load(memory_order_relaxed);
+	top = this->m_top.load(memory_order_acquire);
+
+	//Full, the caller runs the item itself rather than growing the queue under the thieves
+	if (bottom - top > this->m_mask)
+	{
+		return false;
+	}
+
+	//Release so a thief that sees the new bottom also sees the item and everything it points at
+	this->m_entries[bottom & this->m_mask].store(item, memory_order_relaxed);
+	this->m_bottom.store(bottom + 1, memory_order_release);
+
+	return true;
+}
+
+void* JobQueue::Pop()
+{
+	long long bottom;
+	long long top;
+	void* item;
+
+	//Claim the bottom first, the fence orders it before the look at the top so a thief and the owner cannot both take the last one
+	bottom = this->m_bottom.load(memory_order_relaxed) - 1;
+	this->m_bottom.store(bottom, memory_order_relaxed);
+	atomic_thread_fence(memory_order_seq_cst);
+	top = this->m_top.load(memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		this->m_bottom.store(bottom + 1, memory_order_relaxed);
+		return nullptr;
+	}
+
+	item = this->m_entries[bottom & this->m_mask].load(memory_order_relaxed);
+	if (top == bottom)
+	{
+		//The last item, race the thieves for it on the top
+		if (!this->m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+		{
+			item = nullptr;
+		}
+		this->m_bottom.store(bottom + 1, memory_order_relaxed);
+	}
+
+	return item;
+}
+
+void* JobQueue::Steal()
+{
+	long long top;
+	long long bottom;
+	void* item;
+
+	top = this->m_top.load(memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	bottom = this->m_bottom.load(memory_order_acquire);
+
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+
+	//Read the item before the claim, once the top moves on the owner may write over the entry
+	item = this->m_entries[top & this->m_mask].load(memory_order_relaxed);
+	if (!this->m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+	{
+		//Lost to the owner or another thief, the caller looks elsewhere
+		return nullptr;
+	}
+
+	return item;
+}
+
+bool JobQueue::IsEmpty()
+{
+	return this->m_bottom.load(memory_order_seq_cst) <= this->m_top.load(memory_order_seq_cst);
+}
\ No newline at end of file
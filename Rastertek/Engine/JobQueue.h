@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: JobQueue.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _JOBQUEUE_H_
+#define _JOBQUEUE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <atomic>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Keeps the end the owner works on and the end the thieves take from on different cache lines
+const int JOB_QUEUE_PADDING = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: JobQueue
+////////////////////////////////////////////////////////////////////////////////
+
+//A Chase-Lev deque of a fixed size, the owning thread pushes and pops the bottom and any thread can steal from the top
+class JobQueue
+{
+private:
+	atomic<void*>* m_entries;
+	long long m_mask;
+	char m_padding0[JOB_QUEUE_PADDING];
+	atomic<long long> m_top;
+	char m_padding1[JOB_QUEUE_PADDING];
+	atomic<long long> m_bottom;
+	char m_padding2[JOB_QUEUE_PADDING];
+
+public:
+	JobQueue();
+	JobQueue(const JobQueue& other);
+	~JobQueue();
+
+	bool Initialize(unsigned int capacity);
+	void Shutdown();
+
+	bool Push(void* item);
+	void* Pop();
+	void* Steal();
+	bool IsEmpty();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,568 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: JobSystem.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "JobSystem.h"
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Every job system gets a new session so a thread never takes its index from one that was shut down
+static atomic<unsigned int> jobSessions(0);
+static PROFILER_THREAD_LOCAL unsigned int threadSession = 0;
+static PROFILER_THREAD_LOCAL int threadIndex = 0;
+
+//Marks the waiting list of a counter at zero, a job run after it goes straight to a queue
+static char closedList = 0;
+
+
+JobCounter::JobCounter()
+{
+	this->m_count = 0;
+	this->m_waiting = (void*)&closedList;
+}
+
+JobCounter::JobCounter(const JobCounter& other)
+{
+}
+
+
+JobCounter::~JobCounter()
+{
+}
+
+bool JobCounter::IsDone()
+{
+	return this->m_count.load(memory_order_acquire) == 0;
+}
+
+void JobCounter::Add(int count)
+{
+	//A batch starting again takes jobs to run after it again
+	if (this->m_count.fetch_add(count, memory_order_relaxed) == 0)
+	{
+		this->m_waiting.store(nullptr, memory_order_relaxed);
+	}
+}
+
+
+JobSystem::JobSystem()
+{
+	this->m_threadData = nullptr;
+	this->m_threadDataCount = 0;
+	this->m_sleeping = 0;
+	this->m_running = false;
+	this->m_session = 0;
+}
+
+JobSystem::JobSystem(const JobSystem& other)
+{
+}
+
+
+JobSystem::~JobSystem()
+{
+}
+
+bool JobSystem::Initialize(int threadCount)
+{
+	bool result;
+	int i;
+	unsigned int j;
+
+	//Leave a core for the thread that hands out the work, it runs jobs too while it waits
+	if (threadCount < 0)
+	{
+		threadCount = (int)thread::hardware_concurrency() - 1;
+		threadCount = threadCount < 0 ? 0 : threadCount;
+	}
+
+	this->m_threadDataCount = threadCount + 2;
+	this->m_threadData = new ThreadType[this->m_threadDataCount];
+	if (!this->m_threadData)
+	{
+		return false;
+	}
+
+	for (i = 0; i < this->m_threadDataCount; i++)
+	{
+		this->m_threadData[i].jobs = nullptr;
+	}
+
+	for (i = 0; i < this->m_threadDataCount; i++)
+	{
+		result = this->m_threadData[i].queue.Initialize(JOB_SYSTEM_QUEUE_SIZE);
+		if (!result)
+		{
+			return false;
+		}
+
+		this->m_threadData[i].jobs = new JobType[JOB_SYSTEM_JOB_COUNT];
+		if (!this->m_threadData[i].jobs)
+		{
+			return false;
+		}
+
+		for (j = 0; j < JOB_SYSTEM_JOB_COUNT; j++)
+		{
+			this->m_threadData[i].jobs[j].used = false;
+		}
+		this->m_threadData[i].nextJob = 0;
+		this->m_threadData[i].random = (unsigned int)i * 2654435761u + 1;
+		this->m_threadData[i].stolenCount = 0;
+	}
+
+	//The calling thread owns the first queue
+	this->m_session = ++jobSessions;
+	threadSession = this->m_session;
+	threadIndex = 0;
+
+	//Without workers every job runs inside Wait on the calling thread, which keeps headless runs deterministic
+	this->m_sleeping = 0;
+	this->m_running = true;
+	for (i = 0; i < threadCount; i++)
+	{
+		this->m_threads.push_back(thread(&JobSystem::WorkerThread, this, i + 1));
+	}
+
+	return true;
+}
+
+void JobSystem::Shutdown()
+{
+	size_t i;
+	int j;
+
+	//Jobs still queued are dropped, everyone waits on their batches before this
+	this->m_running = false;
+	{
+		lock_guard<mutex> lock(this->m_sleepMutex);
+		this->m_condition.notify_all();
+	}
+
+	for (i = 0; i < this->m_threads.size(); i++)
+	{
+		this->m_threads[i].join();
+	}
+	this->m_threads.clear();
+
+	if (this->m_threadData)
+	{
+		for (j = 0; j < this->m_threadDataCount; j++)
+		{
+			this->m_threadData[j].queue.Shutdown();
+			if (this->m_threadData[j].jobs)
+			{
+				delete[] this->m_threadData[j].jobs;
+				this->m_threadData[j].jobs = nullptr;
+			}
+		}
+
+		delete[] this->m_threadData;
+		this->m_threadData = nullptr;
+	}
+	this->m_threadDataCount = 0;
+}
+
+void JobSystem::Run(JobFunction function, void* data, JobCounter* counter)
+{
+	JobSystem::RunAfter(nullptr, function, data, counter);
+}
+
+void JobSystem::RunAfter(JobCounter* dependency, JobFunction function, void* data, JobCounter* counter)
+{
+	JobType* job;
+	int index;
+
+	index = JobSystem::GetThreadIndex();
+	job = JobSystem::AllocateJob(index);
+	job->function = function;
+	job->rangeFunction = nullptr;
+	job->data = data;
+	job->begin = 0;
+	job->end = 0;
+	job->batchSize = 0;
+	job->counter = counter;
+	job->next = nullptr;
+	if (counter)
+	{
+		counter->Add(1);
+	}
+
+	JobSystem::Schedule(index, job, dependency);
+}
+
+void JobSystem::ParallelFor(RangeFunction function, void* data, int count, int batchSize, JobCounter* counter)
+{
+	JobType* job;
+	int index;
+
+	if (count <= 0)
+	{
+		return;
+	}
+
+	//One job for the whole range, it halves itself as it runs so the idle threads steal the big pieces first
+	index = JobSystem::GetThreadIndex();
+	job = JobSystem::AllocateJob(index);
+	job->function = nullptr;
+	job->rangeFunction = function;
+	job->data = data;
+	job->begin = 0;
+	job->end = count;
+	job->batchSize = batchSize < 1 ? 1 : batchSize;
+	job->counter = counter;
+	job->next = nullptr;
+	if (counter)
+	{
+		counter->Add(1);
+	}
+
+	JobSystem::Schedule(index, job, nullptr);
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+	PROFILE_SCOPE("JobSystem::Wait");
+
+	int index;
+
+	//Run other jobs instead of sleeping, the batch may well be waiting on this thread
+	index = JobSystem::GetThreadIndex();
+	while (!counter->IsDone())
+	{
+		if (!JobSystem::RunJob(index))
+		{
+			this_thread::yield();
+		}
+	}
+}
+
+int JobSystem::GetThreadCount()
+{
+	return (int)this->m_threads.size();
+}
+
+unsigned long long JobSystem::GetStolenCount()
+{
+	unsigned long long count;
+	int i;
+
+	count = 0;
+	for (i = 0; i < this->m_threadDataCount; i++)
+	{
+		count += this->m_threadData[i].stolenCount.load(memory_order_relaxed);
+	}
+
+	return count;
+}
+
+int JobSystem::GetThreadSlotCount()
+{
+	return this->m_threadDataCount;
+}
+
+int JobSystem::GetThreadIndex()
+{
+	if (threadSession == this->m_session)
+	{
+		return threadIndex;
+	}
+
+	//Any other thread, the sound mixer or a loader, shares the last queue
+	return this->m_threadDataCount - 1;
+}
+
+JobSystem::JobType* JobSystem::AllocateJob(int index)
+{
+	ThreadType* data;
+	JobType* job;
+	unsigned int i;
+
+	data = &this->m_threadData[index];
+	while (true)
+	{
+		{
+			unique_lock<mutex> lock(this->m_sharedMutex, defer_lock);
+			if (index == this->m_threadDataCount - 1)
+			{
+				lock.lock();
+			}
+
+			//The jobs go round in a ring, the next one is nearly always long finished
+			for (i = 0; i < JOB_SYSTEM_JOB_COUNT; i++)
+			{
+				job = &data->jobs[data->nextJob & (JOB_SYSTEM_JOB_COUNT - 1)];
+				data->nextJob++;
+				if (!job->used.load(memory_order_acquire))
+				{
+					job->used.store(true, memory_order_relaxed);
+					return job;
+				}
+			}
+		}
+
+		//Every job this thread handed out is still running, help finish some
+		if (!JobSystem::RunJob(index))
+		{
+			this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::Schedule(int index, JobType* job, JobCounter* dependency)
+{
+	void* waiting;
+
+	//Hang the job on the dependency unless it has already finished, the last job of the batch pushes it
+	if (dependency)
+	{
+		waiting = dependency->m_waiting.load(memory_order_acquire);
+		while (waiting != (void*)&closedList)
+		{
+			job->next = (JobType*)waiting;
+			if (dependency->m_waiting.compare_exchange_weak(waiting, (void*)job, memory_order_release, memory_order_acquire))
+			{
+				return;
+			}
+		}
+	}
+
+	JobSystem::PushJob(index, job);
+}
+
+void JobSystem::PushJob(int index, JobType* job)
+{
+	bool result;
+
+	{
+		unique_lock<mutex> lock(this->m_sharedMutex, defer_lock);
+		if (index == this->m_threadDataCount - 1)
+		{
+			lock.lock();
+		}
+		result = this->m_threadData[index].queue.Push(job);
+	}
+
+	//A full queue means plenty of work is waiting already, so run this one now
+	if (!result)
+	{
+		JobSystem::ExecuteJob(index, job);
+		return;
+	}
+
+	JobSystem::WakeWorker();
+}
+
+JobSystem::JobType* JobSystem::FindJob(int index)
+{
+	ThreadType* data;
+	JobType* job;
+	unsigned int start;
+	int i;
+	int victim;
+
+	data = &this->m_threadData[index];
+
+	//Newest first from this thread's own queue, it is the one most likely still in the cache
+	{
+		unique_lock<mutex> lock(this->m_sharedMutex, defer_lock);
+		if (index == this->m_threadDataCount - 1)
+		{
+			lock.lock();
+		}
+		job = (JobType*)data->queue.Pop();
+	}
+	if (job)
+	{
+		return job;
+	}
+
+	//Oldest first from someone else's, starting somewhere random so the thieves spread out
+	start = 0;
+	if (index != this->m_threadDataCount - 1)
+	{
+		data->random ^= data->random << 13;
+		data->random ^= data->random >> 17;
+		data->random ^= data->random << 5;
+		start = data->random;
+	}
+
+	for (i = 0; i < this->m_threadDataCount; i++)
+	{
+		victim = (int)((start + (unsigned int)i) % (unsigned int)this->m_threadDataCount);
+		if (victim == index)
+		{
+			continue;
+		}
+
+		job = (JobType*)this->m_threadData[victim].queue.Steal();
+		if (job)
+		{
+			data->stolenCount.fetch_add(1, memory_order_relaxed);
+			return job;
+		}
+	}
+
+	return nullptr;
+}
+
+bool JobSystem::RunJob(int index)
+{
+	JobType* job;
+
+	job = JobSystem::FindJob(index);
+	if (!job)
+	{
+		return false;
+	}
+
+	JobSystem::ExecuteJob(index, job);
+
+	return true;
+}
+
+void JobSystem::ExecuteJob(int index, JobType* job)
+{
+	JobType* half;
+	int middle;
+
+	if (!job->rangeFunction)
+	{
+		job->function(job->data);
+		JobSystem::FinishJob(index, job);
+		return;
+	}
+
+	//Hand the top half of the range to whoever steals it until what is left is one batch
+	while (job->end - job->begin > job->batchSize)
+	{
+		middle = job->begin + (job->end - job->begin) / 2;
+
+		half = JobSystem::AllocateJob(index);
+		half->function = nullptr;
+		half->rangeFunction = job->rangeFunction;
+		half->data = job->data;
+		half->begin = middle;
+		half->end = job->end;
+		half->batchSize = job->batchSize;
+		half->counter = job->counter;
+		half->next = nullptr;
+		if (half->counter)
+		{
+			half->counter->Add(1);
+		}
+
+		job->end = middle;
+		JobSystem::PushJob(index, half);
+	}
+
+	job->rangeFunction(job->data, job->begin, job->end);
+	JobSystem::FinishJob(index, job);
+}
+
+void JobSystem::FinishJob(int index, JobType* job)
+{
+	JobCounter* counter;
+	JobType* waiting;
+	JobType* next;
+	int count;
+
+	counter = job->counter;
+	job->used.store(false, memory_order_release);
+	if (!counter)
+	{
+		return;
+	}
+
+	//Release so whoever sees the batch finished also sees everything the jobs wrote
+	count = counter->m_count.load(memory_order_relaxed);
+	while (count > 1)
+	{
+		if (counter->m_count.compare_exchange_weak(count, count - 1, memory_order_release, memory_order_relaxed))
+		{
+			return;
+		}
+	}
+
+	//The last job of a batch hands out what waits on it before the count reaches zero, the owner may free the counter after that
+	waiting = (JobType*)counter->m_waiting.exchange((void*)&closedList, memory_order_acq_rel);
+	while (waiting)
+	{
+		next = waiting->next;
+		JobSystem::PushJob(index, waiting);
+		waiting = next;
+	}
+	counter->m_count.fetch_sub(1, memory_order_release);
+}
+
+void JobSystem::WakeWorker()
+{
+	//Pairs with the look at the queues a worker makes before it sleeps, one of the two always sees the other
+	atomic_thread_fence(memory_order_seq_cst);
+	if (this->m_sleeping.load(memory_order_relaxed) > 0)
+	{
+		lock_guard<mutex> lock(this->m_sleepMutex);
+		this->m_condition.notify_one();
+	}
+}
+
+bool JobSystem::HasJobs()
+{
+	int i;
+
+	for (i = 0; i < this->m_threadDataCount; i++)
+	{
+		if (!this->m_threadData[i].queue.IsEmpty())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::WorkerThread(int index)
+{
+	char name[PROFILER_NAME_LENGTH];
+	int idleCount;
+
+	threadSession = this->m_session;
+	threadIndex = index;
+
+	//Show the thread by name in the profiler
+	if (ProfilerHandle)
+	{
+		sprintf(name, "Job Worker %d", index);
+		ProfilerHandle->SetThreadName(name);
+	}
+
+	idleCount = 0;
+	while (this->m_running.load(memory_order_relaxed))
+	{
+		if (JobSystem::RunJob(index))
+		{
+			idleCount = 0;
+			continue;
+		}
+
+		//Stay awake a little in case more work is on its way, then sleep until a push wakes this thread
+		idleCount++;
+		if (idleCount < JOB_SYSTEM_SPIN_COUNT)
+		{
+			this_thread::yield();
+			continue;
+		}
+
+		{
+			unique_lock<mutex> lock(this->m_sleepMutex);
+			this->m_sleeping.fetch_add(1);
+			while (this->m_running.load() && !JobSystem::HasJobs())
+			{
+				this->m_condition.wait(lock);
+			}
+			this->m_sleeping.fetch_sub(1);
+		}
+		idleCount = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: JobSystem.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _JOBSYSTEM_H_
+#define _JOBSYSTEM_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "Profiler.h"
+#include "JobQueue.h"
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Jobs each thread can have queued and handed out but not finished, powers of two
+//There are more jobs than queue entries, so a full queue runs jobs inline long before the jobs run out
+const unsigned int JOB_SYSTEM_QUEUE_SIZE = 4096;
+const unsigned int JOB_SYSTEM_JOB_COUNT = 2 * JOB_SYSTEM_QUEUE_SIZE;
+
+//Empty looks over every queue before a worker goes to sleep
+const int JOB_SYSTEM_SPIN_COUNT = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: JobCounter
+////////////////////////////////////////////////////////////////////////////////
+
+//Counts the jobs of a batch that have not finished, waiting on it waits for the whole batch
+//Jobs run after it are kept on it and handed out by whichever job takes the count to zero
+class JobCounter
+{
+	friend class JobSystem;
+
+private:
+	atomic<int> m_count;
+	atomic<void*> m_waiting;
+
+public:
+	JobCounter();
+	JobCounter(const JobCounter& other);
+	~JobCounter();
+
+	bool IsDone();
+
+private:
+	void Add(int count);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: JobSystem
+////////////////////////////////////////////////////////////////////////////////
+class JobSystem
+{
+public:
+	typedef void (*JobFunction)(void* data);
+	typedef void (*RangeFunction)(void* data, int begin, int end);
+
+private:
+	struct JobType
+	{
+		JobFunction function;
+		RangeFunction rangeFunction;
+		void* data;
+		int begin;
+		int end;
+		int batchSize;
+		JobCounter* counter;
+		JobType* next;
+		atomic<bool> used;
+	};
+
+	struct ThreadType
+	{
+		JobQueue queue;
+		JobType* jobs;
+		unsigned int nextJob;
+		unsigned int random;
+		atomic<unsigned long long> stolenCount;
+	};
+
+	//The first is the thread that initialized the system, then the workers, the last is shared by every other thread under a lock
+	ThreadType* m_threadData;
+	int m_threadDataCount;
+	vector<thread> m_threads;
+	mutex m_sharedMutex;
+	mutex m_sleepMutex;
+	condition_variable m_condition;
+	atomic<int> m_sleeping;
+	atomic<bool> m_running;
+	unsigned int m_session;
+
+public:
+	JobSystem();
+	JobSystem(const JobSystem& other);
+	~JobSystem();
+
+	bool Initialize(int threadCount);
+	void Shutdown();
+
+	void Run(JobFunction function, void* data, JobCounter* counter);
+	void RunAfter(JobCounter* dependency, JobFunction function, void* data, JobCounter* counter);
+	void ParallelFor(RangeFunction function, void* data, int count, int batchSize, JobCounter* counter);
+	void Wait(JobCounter* counter);
+
+	int GetThreadCount();
+	unsigned long long GetStolenCount();
+
+	//Per thread data kept outside is indexed by these, the last index is shared by every thread that is not the system's own
+	int GetThreadIndex();
+	int GetThreadSlotCount();
+
+private:
+	JobType* AllocateJob(int index);
+	void Schedule(int index, JobType* job, JobCounter* dependency);
+	void PushJob(int index, JobType* job);
+	JobType* FindJob(int index);
+	bool RunJob(int index);
+	void ExecuteJob(int index, JobType* job);
+	void FinishJob(int index, JobType* job);
+	void WakeWorker();
+	bool HasJobs();
+	void WorkerThread(int index);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: LinearAllocator.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "LinearAllocator.h"
+
+
+LinearAllocator::LinearAllocator()
+{
+	this->m_data = nullptr;
+	this->m_capacity = 0;
+	this->m_offset = 0;
+	this->m_overflow = nullptr;
+	this->m_overflowSize = 0;
+	this->m_peak = 0;
+	this->m_heapAllocationCount = 0;
+}
+
+LinearAllocator::LinearAllocator(const LinearAllocator& other)
+{
+}
+
+
+LinearAllocator::~LinearAllocator()
+{
+}
+
+bool LinearAllocator::Initialize(size_t capacity)
+{
+	this->m_data = new unsigned char[capacity];
+	if (!this->m_data)
+	{
+		return false;
+	}
+
+	this->m_capacity = capacity;
+	this->m_offset = 0;
+	this->m_overflow = nullptr;
+	this->m_overflowSize = 0;
+	this->m_peak = 0;
+	this->m_heapAllocationCount = 1;
+
+	return true;
+}
+
+void LinearAllocator::Shutdown()
+{
+	LinearAllocator::Reset();
+
+	if (this->m_data)
+	{
+		delete[] this->m_data;
+		this->m_data = nullptr;
+	}
+	this->m_capacity = 0;
+}
+
+void* LinearAllocator::Allocate(size_t size, size_t alignment)
+{
+	size_t offset;
+	size_t start;
+	size_t base;
+
+	if (alignment < 1)
+	{
+		alignment = 1;
+	}
+
+	//Line up the address rather than the offset so alignments past what new[] gives are kept too
+	base = (size_t)this->m_data;
+	offset = this->m_offset.load(memory_order_relaxed);
+	do
+	{
+		start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+		if (start + size > this->m_capacity || start + size < start)
+		{
+			return LinearAllocator::AllocateOverflow(size, alignment);
+		}
+	} while (!this->m_offset.compare_exchange_weak(offset, start + size, memory_order_relaxed));
+
+	return this->m_data + start;
+}
+
+void LinearAllocator::Reset()
+{
+	OverflowType* overflow;
+	unsigned char* data;
+	size_t used;
+	size_t capacity;
+
+	//What this period asked for in all, the block and what spilt over
+	used = this->m_offset.load(memory_order_relaxed) + this->m_overflowSize;
+	if (used > this->m_peak)
+	{
+		this->m_peak = used;
+	}
+
+	while (this->m_overflow)
+	{
+		overflow = this->m_overflow;
+		this->m_overflow = overflow->next;
+		delete[] (unsigned char*)overflow;
+	}
+
+	//Grow once to cover the period that spilt, with room to spare so one more byte next time does not grow it again
+	//A rewind may have given the block back since, so it is sized on the whole block plus the spill rather than the offset
+	if (this->m_overflowSize > 0)
+	{
+		capacity = this->m_capacity + this->m_overflowSize;
+		capacity += capacity / 2;
+		data = new unsigned char[capacity];
+		if (data)
+		{
+			delete[] this->m_data;
+			this->m_data = data;
+			this->m_capacity = capacity;
+			this->m_heapAllocationCount++;
+		}
+	}
+
+	this->m_overflowSize = 0;
+	this->m_offset = 0;
+}
+
+size_t LinearAllocator::GetMarker()
+{
+	return this->m_offset.load(memory_order_relaxed);
+}
+
+void LinearAllocator::Rewind(size_t marker)
+{
+	size_t offset;
+
+	//The peak has to see what was in use before it is given back, the reset only sees what is left
+	offset = this->m_offset.load(memory_order_relaxed);
+	if (offset + this->m_overflowSize > this->m_peak)
+	{
+		this->m_peak = offset + this->m_overflowSize;
+	}
+
+	if (marker <= offset)
+	{
+		this->m_offset.store(marker, memory_order_relaxed);
+	}
+}
+
+size_t LinearAllocator::GetUsed()
+{
+	return this->m_offset.load(memory_order_relaxed) + this->m_overflowSize;
+}
+
+size_t LinearAllocator::GetCapacity()
+{
+	return this->m_capacity;
+}
+
+size_t LinearAllocator::GetPeak()
+{
+	return this->m_peak;
+}
+
+unsigned long long LinearAllocator::GetHeapAllocationCount()
+{
+	return this->m_heapAllocationCount.load(memory_order_relaxed);
+}
+
+void* LinearAllocator::AllocateOverflow(size_t size, size_t alignment)
+{
+	OverflowType* overflow;
+	size_t header;
+	size_t start;
+
+	//Each spill is a heap block of its own with a link in front, freed on the reset
+	header = sizeof(OverflowType) + alignment;
+	overflow = (OverflowType*)new unsigned char[header + size];
+	if (!overflow)
+	{
+		return nullptr;
+	}
+	this->m_heapAllocationCount++;
+
+	start = ((size_t)(overflow + 1) + alignment - 1) & ~(alignment - 1);
+
+	lock_guard<mutex> lock(this->m_overflowMutex);
+	overflow->next = this->m_overflow;
+	this->m_overflow = overflow;
+	this->m_overflowSize += size;
+
+	return (void*)start;
+}
\ No newline at end of file
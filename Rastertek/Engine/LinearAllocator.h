@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: LinearAllocator.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _LINEARALLOCATOR_H_
+#define _LINEARALLOCATOR_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+
+//What new[] already lines a block up to, bigger alignments are lined up by hand
+const size_t LINEAR_ALLOCATOR_ALIGNMENT = 16;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: LinearAllocator
+////////////////////////////////////////////////////////////////////////////////
+
+//Hands out memory by moving an offset along one block and takes it all back at once on a reset
+//Past the end it falls back to the heap until the reset, which grows the block to what was asked for so the next period fits
+class LinearAllocator
+{
+private:
+	struct OverflowType
+	{
+		OverflowType* next;
+	};
+
+	unsigned char* m_data;
+	size_t m_capacity;
+	atomic<size_t> m_offset;
+	mutex m_overflowMutex;
+	OverflowType* m_overflow;
+	size_t m_overflowSize;
+	size_t m_peak;
+	atomic<unsigned long long> m_heapAllocationCount;
+
+public:
+	LinearAllocator();
+	LinearAllocator(const LinearAllocator& other);
+	~LinearAllocator();
+
+	bool Initialize(size_t capacity);
+	void Shutdown();
+
+	//Any thread may allocate at the same time, nothing may allocate during a reset, the alignment is a power of two
+	void* Allocate(size_t size, size_t alignment);
+	void Reset();
+
+	//Only for an allocator one thread has to itself, rewinding gives back everything allocated since the marker
+	size_t GetMarker();
+	void Rewind(size_t marker);
+
+	size_t GetUsed();
+	size_t GetCapacity();
+	size_t GetPeak();
+	unsigned long long GetHeapAllocationCount();
+
+private:
+	void* AllocateOverflow(size_t size, size_t alignment);
+};
+
+#endif
\ No newline at end of file
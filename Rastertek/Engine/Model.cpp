@@ -19,10 +19,18 @@ Model::~Model()
 {
 }
 
-bool Model::Initialize(ID3D11Device* device, char* modelFileName)
+bool Model::Initialize(ID3D11Device* device, FrameMemory* frameMemory, char* modelFileName)
 {
+	PROFILE_SCOPE("Model::Initialize");
+
 	bool result;
 
+	//The vertex and index arrays are built in the frame memory's scratch arenas
+	if (!frameMemory)
+	{
+		return false;
+	}
+
 	// Load in the model data
 	result = Model::LoadModel(modelFileName);
 	if (!result)
@@ -31,7 +39,7 @@ bool Model::Initialize(ID3D11Device* device, char* modelFileName)
 	}
 
 	// Initialize the vertex and index buffers.
-	result = Model::InitializeBuffers(device);
+	result = Model::InitializeBuffers(device, frameMemory);
 	if (!result)
 	{
 		return false;
@@ -51,6 +59,8 @@ void Model::Shutdown()
 
 void Model::Render(ID3D11DeviceContext* deviceContext)
 {
+	PROFILE_SCOPE("Model::Render");
+
 	//Put the vertex and index buffers on the graphics pipeline to prepare them for drawing
 	Model::RenderBuffers(deviceContext);
 }
@@ -60,19 +70,26 @@ int Model::GetIndexCount()
 	return this->m_indexCount;
 }
 
-bool Model::InitializeBuffers(ID3D11Device* device)
+bool Model::InitializeBuffers(ID3D11Device* device, FrameMemory* frameMemory)
 {
+	PROFILE_SCOPE("Model::InitializeBuffers");
+
 	HRESULT result;
+	VertexType* vertices;
+	UINT* indices;
+
+	//The arrays only live until the buffers are made, so they come from the scratch arena and go back when this returns
+	ScratchScope scratch(frameMemory);
 
 	//Create the vertex array
-	VertexType* vertices = new VertexType[this->m_vertexCount];
+	vertices = (VertexType*)scratch.Allocate(sizeof(VertexType) * this->m_vertexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!vertices)
 	{
 		return false;
 	}
 
 	//Create the index array
-	UINT* indices = new UINT[this->m_indexCount];
+	indices = (UINT*)scratch.Allocate(sizeof(UINT) * this->m_indexCount, LINEAR_ALLOCATOR_ALIGNMENT);
 	if (!indices)
 	{
 		return false;
@@ -82,6 +99,7 @@ bool Model::InitializeBuffers(ID3D11Device* device)
 	for (UINT i = 0; i < this->m_vertexCount; i++)
 	{
 		vertices[i].position = this->m_model[i].position;
+		vertices[i].texture = this->m_model[i].texture;
 
 		indices[i] = i;
 	}
@@ -138,13 +156,6 @@ bool Model::InitializeBuffers(ID3D11Device* device)
 		return false;
 	}
 
-	//Release the arrays now that the vertex and index buffers have been created and loaded
-	delete[] vertices;
-	vertices = nullptr;
-
-	delete[] indices;
-	indices = nullptr;
-
 	return true;
 }
 
@@ -183,6 +194,8 @@ void Model::RenderBuffers(ID3D11DeviceContext* deviceContext)
 
 bool Model::LoadModel(char* modelFileName)
 {
+	PROFILE_SCOPE("Model::LoadModel");
+
 	ifstream fIn;
 	char input;
 
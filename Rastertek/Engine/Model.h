@@ -12,6 +12,12 @@
 #include <fstream>
 using namespace std;
 
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "Profiler.h"
+#include "FrameMemory.h"
+
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Model
 ////////////////////////////////////////////////////////////////////////////////
@@ -19,9 +25,11 @@ class Model
 {
 
 private:
+	//The depth shader only reads the position, the texture array shader reads the texture coordinate after it as well
 	struct VertexType
 	{
 		D3DXVECTOR3 position;
+		D3DXVECTOR2 texture;
 	};
 
 	struct ModelType
@@ -42,14 +50,14 @@ public:
 	Model(const Model& other);
 	~Model();
 
-	bool Initialize(ID3D11Device* device, char* modelFileName);
+	bool Initialize(ID3D11Device* device, FrameMemory* frameMemory, char* modelFileName);
 	void Shutdown();
 	void Render(ID3D11DeviceContext* deviceContext);
 
 	int GetIndexCount();
 
 private:
-	bool InitializeBuffers(ID3D11Device* device);
+	bool InitializeBuffers(ID3D11Device* device, FrameMemory* frameMemory);
 	void ShutdownBuffers();
 	void RenderBuffers(ID3D11DeviceContext* deviceContext);
 
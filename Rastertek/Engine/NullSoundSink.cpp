@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: NullSoundSink.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "NullSoundSink.h"
+
+
+NullSoundSink::NullSoundSink()
+{
+	this->m_bytesPerSecond = 0;
+	this->m_blockAlign = 0;
+	this->m_realtime = false;
+	this->m_capture = false;
+	this->m_playing = false;
+	this->m_startBytes = 0;
+	this->m_playedBytes = 0;
+}
+
+NullSoundSink::NullSoundSink(const NullSoundSink& other)
+{
+}
+
+
+NullSoundSink::~NullSoundSink()
+{
+}
+
+bool NullSoundSink::Initialize(unsigned int bytesPerSecond, unsigned int blockAlign, unsigned int bufferSize, bool realtime, bool capture)
+{
+	if (bytesPerSecond == 0 || blockAlign == 0 || bufferSize == 0 || bufferSize % blockAlign != 0)
+	{
+		return false;
+	}
+
+	//In realtime the cursor follows the clock like a sound card would, otherwise it only moves when Advance is called
+	this->m_buffer.assign(bufferSize, 0);
+	this->m_bytesPerSecond = bytesPerSecond;
+	this->m_blockAlign = blockAlign;
+	this->m_realtime = realtime;
+	this->m_capture = capture;
+	this->m_playing = false;
+	this->m_startBytes = 0;
+	this->m_playedBytes = 0;
+	this->m_captured.clear();
+
+	return true;
+}
+
+void NullSoundSink::Shutdown()
+{
+	this->m_buffer.clear();
+	this->m_captured.clear();
+	this->m_playing = false;
+}
+
+bool NullSoundSink::Start()
+{
+	this->m_startTime = chrono::steady_clock::now();
+	this->m_startBytes = this->m_playedBytes;
+	this->m_playing = true;
+
+	return true;
+}
+
+void NullSoundSink::Stop()
+{
+	unsigned int position;
+
+	//Catch the cursor up to the clock before it stops
+	NullSoundSink::GetPlayPosition(position);
+	this->m_playing = false;
+}
+
+unsigned int NullSoundSink::GetBufferSize()
+{
+	return (unsigned int)this->m_buffer.size();
+}
+
+bool NullSoundSink::GetPlayPosition(unsigned int& position)
+{
+	long long elapsed;
+	unsigned long long target;
+
+	if (this->m_realtime && this->m_playing)
+	{
+		//Work out how many whole frames the clock says have been played since the start
+		elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - this->m_startTime).count();
+		target = this->m_startBytes + (unsigned long long)elapsed * this->m_bytesPerSecond / 1000000;
+		target -= target % this->m_blockAlign;
+		if (target > this->m_playedBytes)
+		{
+			NullSoundSink::Play(target - this->m_playedBytes);
+		}
+	}
+
+	position = (unsigned int)(this->m_playedBytes % this->m_buffer.size());
+
+	return true;
+}
+
+bool NullSoundSink::Lock(unsigned int offset, unsigned int size, void*& data)
+{
+	if (offset + size > this->m_buffer.size())
+	{
+		return false;
+	}
+
+	data = &this->m_buffer[offset];
+
+	return true;
+}
+
+void NullSoundSink::Unlock(void* data, unsigned int size)
+{
+}
+
+void NullSoundSink::Advance(unsigned int size)
+{
+	//Move the cursor by hand, used when the sink is not realtime
+	NullSoundSink::Play(size);
+}
+
+unsigned long long NullSoundSink::GetPlayedBytes()
+{
+	return this->m_playedBytes;
+}
+
+const vector<unsigned char>& NullSoundSink::GetCaptured()
+{
+	return this->m_captured;
+}
+
+void NullSoundSink::Play(unsigned long long size)
+{
+	unsigned long long i;
+	size_t bufferSize;
+	size_t position;
+
+	//Record what the cursor passes over so the output can be checked against the source
+	if (this->m_capture)
+	{
+		bufferSize = this->m_buffer.size();
+		position = (size_t)(this->m_playedBytes % bufferSize);
+		for (i = 0; i < size; i++)
+		{
+			this->m_captured.push_back(this->m_buffer[position]);
+			position++;
+			if (position == bufferSize)
+			{
+				position = 0;
+			}
+		}
+	}
+
+	this->m_playedBytes += size;
+}
\ No newline at end of file
@@ -0,0 +1,61 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: NullSoundSink.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _NULLSOUNDSINK_H_
+#define _NULLSOUNDSINK_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <chrono>
+#include <vector>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "SoundSink.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: NullSoundSink
+////////////////////////////////////////////////////////////////////////////////
+class NullSoundSink : public SoundSink
+{
+private:
+	vector<unsigned char> m_buffer;
+	unsigned int m_bytesPerSecond;
+	unsigned int m_blockAlign;
+	bool m_realtime;
+	bool m_capture;
+	bool m_playing;
+	chrono::steady_clock::time_point m_startTime;
+	unsigned long long m_startBytes;
+	unsigned long long m_playedBytes;
+	vector<unsigned char> m_captured;
+
+public:
+	NullSoundSink();
+	NullSoundSink(const NullSoundSink& other);
+	~NullSoundSink();
+
+	bool Initialize(unsigned int bytesPerSecond, unsigned int blockAlign, unsigned int bufferSize, bool realtime, bool capture);
+	void Shutdown();
+
+	bool Start();
+	void Stop();
+
+	unsigned int GetBufferSize();
+	bool GetPlayPosition(unsigned int& position);
+
+	bool Lock(unsigned int offset, unsigned int size, void*& data);
+	void Unlock(void* data, unsigned int size);
+
+	void Advance(unsigned int size);
+	unsigned long long GetPlayedBytes();
+	const vector<unsigned char>& GetCaptured();
+
+private:
+	void Play(unsigned long long size);
+};
+
+#endif
\ No newline at end of file
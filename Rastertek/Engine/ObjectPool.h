@@ -0,0 +1,294 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: ObjectPool.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _OBJECTPOOL_H_
+#define _OBJECTPOOL_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <new>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Ends the free list, no slot has this index
+const unsigned int OBJECT_POOL_NO_SLOT = 0xFFFFFFFF;
+
+//////////////
+// TYPEDEFS //
+//////////////
+
+//Typed by what it names so a texture handle cannot be handed to the model pool, and usable before that type is complete
+template <class T>
+struct ObjectHandle
+{
+	unsigned int index;
+	unsigned int generation;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ObjectPool
+////////////////////////////////////////////////////////////////////////////////
+
+//Keeps objects of one type side by side in pages and hands out handles to them instead of pointers
+//A handle is the slot and the generation the slot had when the object was made, destroying the object moves the generation on,
+//so a handle kept past the destroy finds nothing rather than whatever took the slot next
+//Pages never move, so a pointer from Get stays good until the object is destroyed. One thread at a time
+template <class T>
+class ObjectPool
+{
+public:
+	typedef ObjectHandle<T> HandleType;
+
+private:
+	typedef typename aligned_storage<sizeof(T), alignment_of<T>::value>::type StorageType;
+
+	//The generations sit apart from the objects so checking a handle does not pull the whole object in
+	//A slot holding an object has an odd generation, a free one an even one
+	struct PageType
+	{
+		StorageType* objects;
+		unsigned int* generations;
+		unsigned int* next;
+	};
+
+	vector<PageType> m_pages;
+	unsigned int m_pageBits;
+	unsigned int m_pageMask;
+	unsigned int m_freeHead;
+	int m_count;
+
+public:
+	ObjectPool();
+	ObjectPool(const ObjectPool& other);
+	~ObjectPool();
+
+	//The first page holds the capacity rounded up to a power of two, every page after it the same
+	bool Initialize(int capacity);
+	void Shutdown();
+
+	//A handle with a generation of zero when the pool could not grow
+	HandleType Create();
+	bool Destroy(HandleType handle);
+
+	T* Get(HandleType handle);
+	bool IsValid(HandleType handle);
+
+	int GetCount();
+	int GetCapacity();
+	static HandleType GetNullHandle();
+
+private:
+	bool AddPage();
+};
+
+template <class T>
+ObjectPool<T>::ObjectPool()
+{
+	this->m_pageBits = 0;
+	this->m_pageMask = 0;
+	this->m_freeHead = OBJECT_POOL_NO_SLOT;
+	this->m_count = 0;
+}
+
+template <class T>
+ObjectPool<T>::ObjectPool(const ObjectPool& other)
+{
+}
+
+template <class T>
+ObjectPool<T>::~ObjectPool()
+{
+}
+
+template <class T>
+bool ObjectPool<T>::Initialize(int capacity)
+{
+	this->m_pageBits = 0;
+	while ((1 << this->m_pageBits) < capacity && this->m_pageBits < 20)
+	{
+		this->m_pageBits++;
+	}
+	this->m_pageMask = (1u << this->m_pageBits) - 1;
+	this->m_freeHead = OBJECT_POOL_NO_SLOT;
+	this->m_count = 0;
+
+	return ObjectPool::AddPage();
+}
+
+template <class T>
+void ObjectPool<T>::Shutdown()
+{
+	unsigned int i;
+	unsigned int j;
+
+	//Whatever is still alive is destroyed with its pool
+	for (i = 0; i < this->m_pages.size(); i++)
+	{
+		for (j = 0; j <= this->m_pageMask; j++)
+		{
+			if (this->m_pages[i].generations[j] & 1)
+			{
+				((T*)&this->m_pages[i].objects[j])->~T();
+			}
+		}
+
+		delete[] this->m_pages[i].next;
+		delete[] this->m_pages[i].generations;
+		delete[] this->m_pages[i].objects;
+	}
+	this->m_pages.clear();
+	this->m_freeHead = OBJECT_POOL_NO_SLOT;
+	this->m_count = 0;
+}
+
+template <class T>
+typename ObjectPool<T>::HandleType ObjectPool<T>::Create()
+{
+	HandleType handle;
+	PageType* page;
+	unsigned int slot;
+	bool result;
+
+	if (this->m_freeHead == OBJECT_POOL_NO_SLOT)
+	{
+		result = ObjectPool::AddPage();
+		if (!result)
+		{
+			return ObjectPool::GetNullHandle();
+		}
+	}
+
+	//The slot freed last is taken first, it is the one most likely still in the cache
+	handle.index = this->m_freeHead;
+	page = &this->m_pages[handle.index >> this->m_pageBits];
+	slot = handle.index & this->m_pageMask;
+	this->m_freeHead = page->next[slot];
+
+	new (&page->objects[slot]) T();
+	page->generations[slot]++;
+	handle.generation = page->generations[slot];
+	this->m_count++;
+
+	return handle;
+}
+
+template <class T>
+bool ObjectPool<T>::Destroy(HandleType handle)
+{
+	PageType* page;
+	T* object;
+	unsigned int slot;
+
+	object = ObjectPool::Get(handle);
+	if (!object)
+	{
+		return false;
+	}
+
+	object->~T();
+
+	page = &this->m_pages[handle.index >> this->m_pageBits];
+	slot = handle.index & this->m_pageMask;
+	page->generations[slot]++;
+	page->next[slot] = this->m_freeHead;
+	this->m_freeHead = handle.index;
+	this->m_count--;
+
+	return true;
+}
+
+template <class T>
+T* ObjectPool<T>::Get(HandleType handle)
+{
+	PageType* page;
+	unsigned int slot;
+
+	//An even generation never names a live object, the null handle included
+	if ((handle.generation & 1) == 0 || (handle.index >> this->m_pageBits) >= this->m_pages.size())
+	{
+		return nullptr;
+	}
+
+	page = &this->m_pages[handle.index >> this->m_pageBits];
+	slot = handle.index & this->m_pageMask;
+	if (page->generations[slot] != handle.generation)
+	{
+		return nullptr;
+	}
+
+	return (T*)&page->objects[slot];
+}
+
+template <class T>
+bool ObjectPool<T>::IsValid(HandleType handle)
+{
+	return ObjectPool::Get(handle) != nullptr;
+}
+
+template <class T>
+int ObjectPool<T>::GetCount()
+{
+	return this->m_count;
+}
+
+template <class T>
+int ObjectPool<T>::GetCapacity()
+{
+	return (int)(this->m_pages.size() << this->m_pageBits);
+}
+
+template <class T>
+typename ObjectPool<T>::HandleType ObjectPool<T>::GetNullHandle()
+{
+	HandleType handle;
+
+	handle.index = 0;
+	handle.generation = 0;
+
+	return handle;
+}
+
+template <class T>
+bool ObjectPool<T>::AddPage()
+{
+	PageType page;
+	unsigned int first;
+	unsigned int i;
+
+	//The slot index has to fit in a handle with room left for the free list's end
+	first = (unsigned int)this->m_pages.size() << this->m_pageBits;
+	if (((unsigned long long)this->m_pages.size() + 1) << this->m_pageBits >= (unsigned long long)OBJECT_POOL_NO_SLOT)
+	{
+		return false;
+	}
+
+	page.objects = new StorageType[this->m_pageMask + 1];
+	page.generations = new unsigned int[this->m_pageMask + 1];
+	page.next = new unsigned int[this->m_pageMask + 1];
+	if (!page.objects || !page.generations || !page.next)
+	{
+		delete[] page.next;
+		delete[] page.generations;
+		delete[] page.objects;
+		return false;
+	}
+
+	//The new slots go on the front of the free list in order
+	for (i = 0; i <= this->m_pageMask; i++)
+	{
+		page.generations[i] = 0;
+		page.next[i] = i < this->m_pageMask ? first + i + 1 : this->m_freeHead;
+	}
+	this->m_freeHead = first;
+	this->m_pages.push_back(page);
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,206 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: PageCache.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "PageCache.h"
+#include "VirtualTextureFile.h"
+
+
+PageCache::PageCache()
+{
+	this->m_slots = nullptr;
+	this->m_slotsWide = 0;
+	this->m_slotsHigh = 0;
+	this->m_head = -1;
+	this->m_tail = -1;
+	this->m_evictionCount = 0;
+}
+
+PageCache::PageCache(const PageCache& other)
+{
+}
+
+PageCache::~PageCache()
+{
+}
+
+bool PageCache::Initialize(int slotsWide, int slotsHigh)
+{
+	int slotCount;
+
+	//Slot coordinates are stored in a byte of the page table
+	if (slotsWide <= 0 || slotsHigh <= 0 || slotsWide > 256 || slotsHigh > 256)
+	{
+		return false;
+	}
+
+	this->m_slotsWide = slotsWide;
+	this->m_slotsHigh = slotsHigh;
+	slotCount = slotsWide * slotsHigh;
+
+	//Create the slots, all of them start empty and linked in order
+	this->m_slots = new SlotType[slotCount];
+	if (!this->m_slots)
+	{
+		return false;
+	}
+
+	this->m_head = -1;
+	this->m_tail = -1;
+	for (int i = 0; i < slotCount; i++)
+	{
+		this->m_slots[i].pageId = VT_INVALID_PAGE;
+		this->m_slots[i].lastUsedFrame = 0;
+		this->m_slots[i].locked = false;
+		PageCache::LinkTail(i);
+	}
+
+	this->m_pageSlots.reserve(slotCount);
+
+	return true;
+}
+
+void PageCache::Shutdown()
+{
+	//Release the slots
+	if (this->m_slots)
+	{
+		delete[] this->m_slots;
+		this->m_slots = nullptr;
+	}
+
+	this->m_pageSlots.clear();
+}
+
+int PageCache::FindPage(unsigned int pageId)
+{
+	unordered_map<unsigned int, int>::iterator it;
+
+	it = this->m_pageSlots.find(pageId);
+	if (it == this->m_pageSlots.end())
+	{
+		return PAGE_CACHE_NO_SLOT;
+	}
+
+	return it->second;
+}
+
+void PageCache::TouchSlot(int slot, unsigned int frame)
+{
+	//Move the slot to the back of the list so it is reused last
+	this->m_slots[slot].lastUsedFrame = frame;
+	if (!this->m_slots[slot].locked)
+	{
+		PageCache::Unlink(slot);
+		PageCache::LinkTail(slot);
+	}
+}
+
+int PageCache::AllocateSlot(unsigned int pageId, unsigned int frame, unsigned int& evictedPage)
+{
+	int slot;
+
+	evictedPage = VT_INVALID_PAGE;
+
+	//Take the least recently used slot, but never one that was needed for this frame
+	slot = this->m_head;
+	if (slot == -1)
+	{
+		return PAGE_CACHE_NO_SLOT;
+	}
+	if (this->m_slots[slot].pageId != VT_INVALID_PAGE && this->m_slots[slot].lastUsedFrame == frame)
+	{
+		return PAGE_CACHE_NO_SLOT;
+	}
+
+	//Evict the page that was in the slot
+	if (this->m_slots[slot].pageId != VT_INVALID_PAGE)
+	{
+		evictedPage = this->m_slots[slot].pageId;
+		this->m_pageSlots.erase(evictedPage);
+		this->m_evictionCount++;
+	}
+
+	this->m_slots[slot].pageId = pageId;
+	this->m_pageSlots[pageId] = slot;
+	PageCache::TouchSlot(slot, frame);
+
+	return slot;
+}
+
+void PageCache::LockSlot(int slot)
+{
+	//Locked slots leave the list and are never evicted, used for the coarsest level so there is always a fallback
+	if (!this->m_slots[slot].locked)
+	{
+		PageCache::Unlink(slot);
+		this->m_slots[slot].locked = true;
+	}
+}
+
+int PageCache::GetSlotsWide()
+{
+	return this->m_slotsWide;
+}
+
+int PageCache::GetSlotsHigh()
+{
+	return this->m_slotsHigh;
+}
+
+int PageCache::GetSlotCount()
+{
+	return this->m_slotsWide * this->m_slotsHigh;
+}
+
+int PageCache::GetResidentCount()
+{
+	return (int)this->m_pageSlots.size();
+}
+
+unsigned int PageCache::GetEvictionCount()
+{
+	return this->m_evictionCount;
+}
+
+void PageCache::Unlink(int slot)
+{
+	SlotType* entry = &this->m_slots[slot];
+
+	if (entry->previous != -1)
+	{
+		this->m_slots[entry->previous].next = entry->next;
+	}
+	else
+	{
+		this->m_head = entry->next;
+	}
+
+	if (entry->next != -1)
+	{
+		this->m_slots[entry->next].previous = entry->previous;
+	}
+	else
+	{
+		this->m_tail = entry->previous;
+	}
+
+	entry->previous = -1;
+	entry->next = -1;
+}
+
+void PageCache::LinkTail(int slot)
+{
+	SlotType* entry = &this->m_slots[slot];
+
+	entry->previous = this->m_tail;
+	entry->next = -1;
+	if (this->m_tail != -1)
+	{
+		this->m_slots[this->m_tail].next = slot;
+	}
+	else
+	{
+		this->m_head = slot;
+	}
+	this->m_tail = slot;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: PageCache.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _PAGECACHE_H_
+#define _PAGECACHE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <unordered_map>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+const int PAGE_CACHE_NO_SLOT = -1;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: PageCache
+////////////////////////////////////////////////////////////////////////////////
+class PageCache
+{
+private:
+	//Every slot of the physical texture is in a least recently used list, the head is the next slot to reuse
+	struct SlotType
+	{
+		unsigned int pageId;
+		unsigned int lastUsedFrame;
+		bool locked;
+		int previous;
+		int next;
+	};
+
+	SlotType* m_slots;
+	int m_slotsWide;
+	int m_slotsHigh;
+	int m_head;
+	int m_tail;
+	unordered_map<unsigned int, int> m_pageSlots;
+
+	unsigned int m_evictionCount;
+
+public:
+	PageCache();
+	PageCache(const PageCache& other);
+	~PageCache();
+
+	bool Initialize(int slotsWide, int slotsHigh);
+	void Shutdown();
+
+	int FindPage(unsigned int pageId);
+	void TouchSlot(int slot, unsigned int frame);
+	int AllocateSlot(unsigned int pageId, unsigned int frame, unsigned int& evictedPage);
+	void LockSlot(int slot);
+
+	int GetSlotsWide();
+	int GetSlotsHigh();
+	int GetSlotCount();
+	int GetResidentCount();
+	unsigned int GetEvictionCount();
+
+private:
+	void Unlink(int slot);
+	void LinkTail(int slot);
+};
+
+#endif
\ No newline at end of file
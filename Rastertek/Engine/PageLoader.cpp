@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: PageLoader.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "PageLoader.h"
+
+
+PageLoader::PageLoader()
+{
+	this->m_File = nullptr;
+	this->m_busyCount = 0;
+	this->m_running = false;
+}
+
+PageLoader::PageLoader(const PageLoader& other)
+{
+}
+
+PageLoader::~PageLoader()
+{
+}
+
+bool PageLoader::Initialize(VirtualTextureFile* file, int threadCount)
+{
+	this->m_File = file;
+
+	//Without threads the pages are read as they are requested, which keeps trace replays deterministic
+	if (threadCount <= 0)
+	{
+		this->m_syncFile.open(file->GetFileName(), ios::binary);
+		return !this->m_syncFile.fail();
+	}
+
+	//Start the worker threads, each one opens its own handle to the file
+	this->m_running = true;
+	for (int i = 0; i < threadCount; i++)
+	{
+		this->m_threads.push_back(thread(&PageLoader::WorkerThread, this));
+	}
+
+	return true;
+}
+
+void PageLoader::Shutdown()
+{
+	PageType page;
+
+	//Stop the worker threads
+	{
+		unique_lock<mutex> lock(this->m_mutex);
+		this->m_running = false;
+		this->m_requests.clear();
+	}
+	this->m_condition.notify_all();
+
+	for (size_t i = 0; i < this->m_threads.size(); i++)
+	{
+		this->m_threads[i].join();
+	}
+	this->m_threads.clear();
+
+	//Release any pages that were never collected
+	while (PageLoader::GetCompletedPage(page))
+	{
+		PageLoader::ReleasePage(page);
+	}
+
+	if (this->m_syncFile.is_open())
+	{
+		this->m_syncFile.close();
+	}
+}
+
+void PageLoader::RequestPage(unsigned int pageId)
+{
+	PageType page;
+
+	if (this->m_threads.empty())
+	{
+		PageLoader::LoadPage(this->m_syncFile, pageId, page);
+		this->m_completed.push_back(page);
+		return;
+	}
+
+	{
+		unique_lock<mutex> lock(this->m_mutex);
+		this->m_requests.push_back(pageId);
+	}
+	this->m_condition.notify_one();
+}
+
+bool PageLoader::GetCompletedPage(PageType& page)
+{
+	unique_lock<mutex> lock(this->m_mutex);
+
+	if (this->m_completed.empty())
+	{
+		return false;
+	}
+
+	page = this->m_completed.front();
+	this->m_completed.pop_front();
+
+	return true;
+}
+
+void PageLoader::ReleasePage(PageType& page)
+{
+	if (page.data)
+	{
+		delete[] page.data;
+		page.data = nullptr;
+	}
+}
+
+int PageLoader::GetPendingCount()
+{
+	unique_lock<mutex> lock(this->m_mutex);
+
+	return (int)(this->m_requests.size() + this->m_completed.size()) + this->m_busyCount;
+}
+
+void PageLoader::WorkerThread()
+{
+	ifstream file;
+	PageType page;
+	unsigned int pageId;
+
+	//Show the thread by name in the profiler
+	if (ProfilerHandle)
+	{
+		ProfilerHandle->SetThreadName("Page Loader");
+	}
+
+	file.open(this->m_File->GetFileName(), ios::binary);
+
+	while (true)
+	{
+		//Wait for a request
+		{
+			unique_lock<mutex> lock(this->m_mutex);
+			while (this->m_running && this->m_requests.empty())
+			{
+				this->m_condition.wait(lock);
+			}
+			if (!this->m_running)
+			{
+				break;
+			}
+
+			pageId = this->m_requests.front();
+			this->m_requests.pop_front();
+			this->m_busyCount++;
+		}
+
+		//Read the page outside of the lock
+		PageLoader::LoadPage(file, pageId, page);
+
+		{
+			unique_lock<mutex> lock(this->m_mutex);
+			this->m_completed.push_back(page);
+			this->m_busyCount--;
+		}
+	}
+}
+
+void PageLoader::LoadPage(ifstream& file, unsigned int pageId, PageType& page)
+{
+	PROFILE_SCOPE("PageLoader::LoadPage");
+
+	page.pageId = pageId;
+	page.data = new unsigned char[this->m_File->GetPageBytes()];
+	page.loaded = file.is_open() && this->m_File->ReadPage(file, pageId, page.data);
+
+	//A failed page is still returned so the scheduler stops waiting on it
+	if (!page.loaded)
+	{
+		delete[] page.data;
+		page.data = nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: PageLoader.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _PAGELOADER_H_
+#define _PAGELOADER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "VirtualTextureFile.h"
+#include "Profiler.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: PageLoader
+////////////////////////////////////////////////////////////////////////////////
+class PageLoader
+{
+public:
+	struct PageType
+	{
+		unsigned int pageId;
+		bool loaded;
+		unsigned char* data;
+	};
+
+private:
+	VirtualTextureFile* m_File;
+	vector<thread> m_threads;
+	mutex m_mutex;
+	condition_variable m_condition;
+	deque<unsigned int> m_requests;
+	deque<PageType> m_completed;
+	int m_busyCount;
+	bool m_running;
+	ifstream m_syncFile;
+
+public:
+	PageLoader();
+	PageLoader(const PageLoader& other);
+	~PageLoader();
+
+	bool Initialize(VirtualTextureFile* file, int threadCount);
+	void Shutdown();
+
+	void RequestPage(unsigned int pageId);
+	bool GetCompletedPage(PageType& page);
+	void ReleasePage(PageType& page);
+	int GetPendingCount();
+
+private:
+	void WorkerThread();
+	void LoadPage(ifstream& file, unsigned int pageId, PageType& page);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,376 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: PageScheduler.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "PageScheduler.h"
+#include <algorithm>
+
+
+PageScheduler::PageScheduler()
+{
+	this->m_File = nullptr;
+	this->m_Cache = nullptr;
+	this->m_Loader = nullptr;
+	this->m_pageTable = nullptr;
+	this->m_maxRequests = 0;
+	this->m_maxUploads = 0;
+	this->m_frame = 0;
+	this->m_pageTableDirty = true;
+	this->m_hitCount = 0;
+	this->m_missCount = 0;
+	this->m_requestCount = 0;
+	this->m_uploadCount = 0;
+	this->m_droppedCount = 0;
+}
+
+PageScheduler::PageScheduler(const PageScheduler& other)
+{
+}
+
+PageScheduler::~PageScheduler()
+{
+}
+
+bool PageScheduler::Initialize(VirtualTextureFile* file, PageCache* cache, PageLoader* loader, int maxRequests, int maxUploads)
+{
+	int coarsest;
+
+	this->m_File = file;
+	this->m_Cache = cache;
+	this->m_Loader = loader;
+	this->m_maxRequests = maxRequests;
+	this->m_maxUploads = maxUploads;
+
+	//The whole coarsest level is locked in the cache so every page always has something to fall back to
+	coarsest = file->GetMipCount() - 1;
+	if (file->GetPagesWide(coarsest) * file->GetPagesHigh(coarsest) > cache->GetSlotCount() / 2)
+	{
+		return false;
+	}
+
+	//Create the page table for every level
+	this->m_pageTable = new vector<unsigned int>[file->GetMipCount()];
+	if (!this->m_pageTable)
+	{
+		return false;
+	}
+
+	for (int i = 0; i < file->GetMipCount(); i++)
+	{
+		this->m_pageTable[i].assign(file->GetPagesWide(i) * file->GetPagesHigh(i), 0);
+	}
+
+	//Start loading the coarsest level straight away
+	for (int y = 0; y < file->GetPagesHigh(coarsest); y++)
+	{
+		for (int x = 0; x < file->GetPagesWide(coarsest); x++)
+		{
+			this->m_inFlight.insert(VirtualTextureFile::MakePageId(x, y, coarsest));
+			this->m_Loader->RequestPage(VirtualTextureFile::MakePageId(x, y, coarsest));
+			this->m_requestCount++;
+		}
+	}
+
+	this->m_pageTableDirty = true;
+
+	return true;
+}
+
+void PageScheduler::Shutdown()
+{
+	//Release any pages that were never uploaded
+	PageScheduler::ReleaseUploads();
+
+	//Release the page table
+	if (this->m_pageTable)
+	{
+		delete[] this->m_pageTable;
+		this->m_pageTable = nullptr;
+	}
+
+	this->m_inFlight.clear();
+}
+
+void PageScheduler::Update(const unsigned int* feedback, int count)
+{
+	this->m_frame++;
+
+	//Work out which pages the frame wanted, request the missing ones in priority order and take what has finished loading
+	PageScheduler::CountFeedback(feedback, count);
+	PageScheduler::GatherCandidates();
+	PageScheduler::IssueRequests();
+	PageScheduler::CollectPages();
+
+	//Point every page at itself or its closest resident ancestor
+	if (this->m_pageTableDirty)
+	{
+		PageScheduler::BuildPageTable();
+	}
+}
+
+int PageScheduler::GetUploadCount()
+{
+	return (int)this->m_uploads.size();
+}
+
+PageScheduler::UploadType& PageScheduler::GetUpload(int index)
+{
+	return this->m_uploads[index];
+}
+
+void PageScheduler::ReleaseUploads()
+{
+	PageLoader::PageType page;
+
+	for (size_t i = 0; i < this->m_uploads.size(); i++)
+	{
+		page.data = this->m_uploads[i].data;
+		this->m_Loader->ReleasePage(page);
+	}
+	this->m_uploads.clear();
+}
+
+bool PageScheduler::IsPageTableDirty()
+{
+	return this->m_pageTableDirty;
+}
+
+const unsigned int* PageScheduler::GetPageTable(int mip)
+{
+	return &this->m_pageTable[mip][0];
+}
+
+void PageScheduler::ClearPageTableDirty()
+{
+	this->m_pageTableDirty = false;
+}
+
+unsigned int PageScheduler::GetFrame()
+{
+	return this->m_frame;
+}
+
+int PageScheduler::GetInFlightCount()
+{
+	return (int)this->m_inFlight.size();
+}
+
+unsigned int PageScheduler::GetHitCount()
+{
+	return this->m_hitCount;
+}
+
+unsigned int PageScheduler::GetMissCount()
+{
+	return this->m_missCount;
+}
+
+unsigned int PageScheduler::GetRequestCount()
+{
+	return this->m_requestCount;
+}
+
+unsigned int PageScheduler::GetUploadTotal()
+{
+	return this->m_uploadCount;
+}
+
+unsigned int PageScheduler::GetDroppedCount()
+{
+	return this->m_droppedCount;
+}
+
+void PageScheduler::CountFeedback(const unsigned int* feedback, int count)
+{
+	//Count how many feedback texels asked for each page, anything that does not name a real page is ignored
+	this->m_feedback.clear();
+	for (int i = 0; i < count; i++)
+	{
+		if (this->m_File->IsValidPage(feedback[i]))
+		{
+			this->m_feedback[feedback[i]]++;
+		}
+	}
+}
+
+void PageScheduler::GatherCandidates()
+{
+	unordered_map<unsigned int, unsigned int>::iterator it;
+	unordered_map<unsigned int, CandidateType>::iterator candidate;
+	vector<unsigned int> missing;
+	unsigned int pageId;
+	int slot, mipCount, residentMip;
+
+	mipCount = this->m_File->GetMipCount();
+	this->m_candidates.clear();
+
+	for (it = this->m_feedback.begin(); it != this->m_feedback.end(); ++it)
+	{
+		//Walk up from the page until a resident one is found, that page is used in its place this frame
+		missing.clear();
+		pageId = it->first;
+		slot = PAGE_CACHE_NO_SLOT;
+		while (VirtualTextureFile::GetPageMip(pageId) < mipCount)
+		{
+			slot = this->m_Cache->FindPage(pageId);
+			if (slot != PAGE_CACHE_NO_SLOT)
+			{
+				this->m_Cache->TouchSlot(slot, this->m_frame);
+				break;
+			}
+
+			missing.push_back(pageId);
+			pageId = VirtualTextureFile::GetParentPage(pageId);
+		}
+
+		if (missing.empty())
+		{
+			this->m_hitCount++;
+			continue;
+		}
+		this->m_missCount++;
+
+		//Every missing page on the way is a candidate, the ones closest to what is resident sharpen the frame first
+		residentMip = (slot != PAGE_CACHE_NO_SLOT) ? VirtualTextureFile::GetPageMip(pageId) : mipCount;
+		for (size_t i = 0; i < missing.size(); i++)
+		{
+			if (this->m_inFlight.count(missing[i]))
+			{
+				continue;
+			}
+
+			candidate = this->m_candidates.find(missing[i]);
+			if (candidate == this->m_candidates.end())
+			{
+				CandidateType entry;
+				entry.pageId = missing[i];
+				entry.distance = residentMip - VirtualTextureFile::GetPageMip(missing[i]);
+				entry.count = it->second;
+				this->m_candidates[missing[i]] = entry;
+			}
+			else
+			{
+				candidate->second.count += it->second;
+			}
+		}
+	}
+}
+
+void PageScheduler::IssueRequests()
+{
+	unordered_map<unsigned int, CandidateType>::iterator it;
+	int requests;
+
+	//Sort the candidates by how urgent they are
+	this->m_sorted.clear();
+	for (it = this->m_candidates.begin(); it != this->m_candidates.end(); ++it)
+	{
+		this->m_sorted.push_back(it->second);
+	}
+	sort(this->m_sorted.begin(), this->m_sorted.end(), PageScheduler::SortCandidates);
+
+	//Only a few new pages are requested each frame so the loader queue stays short and follows the camera
+	requests = min((int)this->m_sorted.size(), this->m_maxRequests);
+	for (int i = 0; i < requests; i++)
+	{
+		this->m_inFlight.insert(this->m_sorted[i].pageId);
+		this->m_Loader->RequestPage(this->m_sorted[i].pageId);
+		this->m_requestCount++;
+	}
+}
+
+void PageScheduler::CollectPages()
+{
+	PageLoader::PageType page;
+	UploadType upload;
+	unsigned int evictedPage;
+	int slot;
+
+	//Any uploads that were not taken last frame are released
+	PageScheduler::ReleaseUploads();
+
+	while ((int)this->m_uploads.size() < this->m_maxUploads && this->m_Loader->GetCompletedPage(page))
+	{
+		this->m_inFlight.erase(page.pageId);
+		if (!page.loaded)
+		{
+			this->m_droppedCount++;
+			continue;
+		}
+
+		//Find a slot for the page, when every slot was used this frame the page is dropped and asked for again later
+		slot = this->m_Cache->AllocateSlot(page.pageId, this->m_frame, evictedPage);
+		if (slot == PAGE_CACHE_NO_SLOT)
+		{
+			this->m_Loader->ReleasePage(page);
+			this->m_droppedCount++;
+			continue;
+		}
+
+		if (VirtualTextureFile::GetPageMip(page.pageId) == this->m_File->GetMipCount() - 1)
+		{
+			this->m_Cache->LockSlot(slot);
+		}
+
+		upload.pageId = page.pageId;
+		upload.slotX = slot % this->m_Cache->GetSlotsWide();
+		upload.slotY = slot / this->m_Cache->GetSlotsWide();
+		upload.data = page.data;
+		this->m_uploads.push_back(upload);
+		this->m_uploadCount++;
+
+		this->m_pageTableDirty = true;
+	}
+}
+
+void PageScheduler::BuildPageTable()
+{
+	unsigned int* entry;
+	unsigned int parent;
+	int pagesWide, pagesHigh, parentWide, parentHigh, slot;
+
+	//Build from the coarsest level down so every missing page can copy the entry of its parent
+	for (int mip = this->m_File->GetMipCount() - 1; mip >= 0; mip--)
+	{
+		pagesWide = this->m_File->GetPagesWide(mip);
+		pagesHigh = this->m_File->GetPagesHigh(mip);
+		entry = &this->m_pageTable[mip][0];
+
+		for (int y = 0; y < pagesHigh; y++)
+		{
+			for (int x = 0; x < pagesWide; x++)
+			{
+				slot = this->m_Cache->FindPage(VirtualTextureFile::MakePageId(x, y, mip));
+				if (slot != PAGE_CACHE_NO_SLOT)
+				{
+					*entry = (unsigned int)(slot % this->m_Cache->GetSlotsWide()) | ((unsigned int)(slot / this->m_Cache->GetSlotsWide()) << 8) | ((unsigned int)mip << 16) | 0xFF000000;
+				}
+				else if (mip < this->m_File->GetMipCount() - 1)
+				{
+					parentWide = this->m_File->GetPagesWide(mip + 1);
+					parentHigh = this->m_File->GetPagesHigh(mip + 1);
+					parent = (unsigned int)(min(y / 2, parentHigh - 1) * parentWide + min(x / 2, parentWide - 1));
+					*entry = this->m_pageTable[mip + 1][parent];
+				}
+				else
+				{
+					*entry = 0;
+				}
+				entry++;
+			}
+		}
+	}
+}
+
+bool PageScheduler::SortCandidates(const CandidateType& first, const CandidateType& second)
+{
+	if (first.distance != second.distance)
+	{
+		return first.distance < second.distance;
+	}
+	if (first.count != second.count)
+	{
+		return first.count > second.count;
+	}
+
+	return first.pageId < second.pageId;
+}
\ No newline at end of file
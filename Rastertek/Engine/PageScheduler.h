@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: PageScheduler.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _PAGESCHEDULER_H_
+#define _PAGESCHEDULER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "VirtualTextureFile.h"
+#include "PageCache.h"
+#include "PageLoader.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: PageScheduler
+////////////////////////////////////////////////////////////////////////////////
+class PageScheduler
+{
+public:
+	struct UploadType
+	{
+		unsigned int pageId;
+		int slotX;
+		int slotY;
+		unsigned char* data;
+	};
+
+private:
+	struct CandidateType
+	{
+		unsigned int pageId;
+		int distance;
+		unsigned int count;
+	};
+
+	VirtualTextureFile* m_File;
+	PageCache* m_Cache;
+	PageLoader* m_Loader;
+	int m_maxRequests;
+	int m_maxUploads;
+	unsigned int m_frame;
+
+	unordered_map<unsigned int, unsigned int> m_feedback;
+	unordered_map<unsigned int, CandidateType> m_candidates;
+	vector<CandidateType> m_sorted;
+	unordered_set<unsigned int> m_inFlight;
+	vector<UploadType> m_uploads;
+
+	//One packed entry per page for every level, slotX | slotY << 8 | mip << 16 | 0xFF << 24
+	vector<unsigned int>* m_pageTable;
+	bool m_pageTableDirty;
+
+	unsigned int m_hitCount;
+	unsigned int m_missCount;
+	unsigned int m_requestCount;
+	unsigned int m_uploadCount;
+	unsigned int m_droppedCount;
+
+public:
+	PageScheduler();
+	PageScheduler(const PageScheduler& other);
+	~PageScheduler();
+
+	bool Initialize(VirtualTextureFile* file, PageCache* cache, PageLoader* loader, int maxRequests, int maxUploads);
+	void Shutdown();
+
+	void Update(const unsigned int* feedback, int count);
+
+	int GetUploadCount();
+	UploadType& GetUpload(int index);
+	void ReleaseUploads();
+
+	bool IsPageTableDirty();
+	const unsigned int* GetPageTable(int mip);
+	void ClearPageTableDirty();
+
+	unsigned int GetFrame();
+	int GetInFlightCount();
+	unsigned int GetHitCount();
+	unsigned int GetMissCount();
+	unsigned int GetRequestCount();
+	unsigned int GetUploadTotal();
+	unsigned int GetDroppedCount();
+
+private:
+	void CountFeedback(const unsigned int* feedback, int count);
+	void GatherCandidates();
+	void IssueRequests();
+	void CollectPages();
+	void BuildPageTable();
+	static bool SortCandidates(const CandidateType& first, const CandidateType& second);
+};
+
+#endif
\ No newline at end of file
@@ -5,6 +5,8 @@ Position::Position()
 {
 	this->m_position = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 	this->m_rotation = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+	this->m_previousPosition = this->m_position;
+	this->m_previousRotation = this->m_rotation;
 	this->m_frameTime = 0;
 	this->m_leftSpeed = 0;
 	this->m_rightSpeed = 0;
@@ -21,7 +23,9 @@ Position::~Position()
 
 void Position::SetPosition(_In_ D3DXVECTOR3 position)
 {
+	//Moving it outright is not motion, so nothing is blended in from the old place
 	this->m_position = position;
+	this->m_previousPosition = position;
 }
 
 void Position::GetPosition(_Out_ D3DXVECTOR3& position)
@@ -32,18 +36,37 @@ void Position::GetPosition(_Out_ D3DXVECTOR3& position)
 void Position::SetRotation(_In_ D3DXVECTOR3 rotation)
 {
 	this->m_rotation = rotation;
+	this->m_previousRotation = rotation;
 }
 
-void Position::GetRotation(_Out_ D3DXVECTOR3 rotation)
+void Position::GetRotation(_Out_ D3DXVECTOR3& rotation)
 {
 	rotation = this->m_rotation;
 }
 
 void Position::SetFrameTime(float time)
 {
+	//With a fixed step this is the tick length, so the movement comes out the same at any frame rate
 	this->m_frameTime = time;
 }
 
+void Position::BeginTick()
+{
+	//Keep where the last tick left off so a frame between two ticks can blend them
+	this->m_previousPosition = this->m_position;
+	this->m_previousRotation = this->m_rotation;
+}
+
+void Position::GetRenderPosition(float alpha, _Out_ D3DXVECTOR3& position)
+{
+	D3DXVec3Lerp(&position, &this->m_previousPosition, &this->m_position, alpha);
+}
+
+void Position::GetRenderRotation(float alpha, _Out_ D3DXVECTOR3& rotation)
+{
+	D3DXVec3Lerp(&rotation, &this->m_previousRotation, &this->m_rotation, alpha);
+}
+
 void Position::MoveLeft(bool keydown)
 {
 	// Update the forward speed movement based on the frame time and whether the user is holding the key down or not.
@@ -20,6 +20,8 @@ class Position
 private:
 	D3DXVECTOR3 m_position;
 	D3DXVECTOR3 m_rotation;
+	D3DXVECTOR3 m_previousPosition;
+	D3DXVECTOR3 m_previousRotation;
 	float m_frameTime;
 	float m_leftSpeed;
 	float m_rightSpeed;
@@ -33,9 +35,12 @@ public:
 	void GetPosition(_Out_ D3DXVECTOR3& position);
 
 	void SetRotation(_In_ D3DXVECTOR3 rotation);
-	void GetRotation(_Out_ D3DXVECTOR3 rotation);
+	void GetRotation(_Out_ D3DXVECTOR3& rotation);
 
 	void SetFrameTime(float time);
+	void BeginTick();
+	void GetRenderPosition(float alpha, _Out_ D3DXVECTOR3& position);
+	void GetRenderRotation(float alpha, _Out_ D3DXVECTOR3& rotation);
 
 	void MoveLeft(bool keydown);
 	void MoveRight(bool keydown);
@@ -0,0 +1,715 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: Profiler.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "Profiler.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/////////////
+// GLOBALS //
+/////////////
+Profiler* ProfilerHandle = nullptr;
+
+//Every profiler gets a new session so a thread never reuses a buffer from one that was shut down
+static atomic<unsigned int> profilerSessions(0);
+static PROFILER_THREAD_LOCAL unsigned int threadSession = 0;
+static PROFILER_THREAD_LOCAL void* threadBuffer = nullptr;
+
+#ifdef _WIN32
+static unsigned long long profilerFrequency = 0;
+#endif
+
+
+Profiler::Profiler()
+{
+	memset(this->m_threads, 0, sizeof(this->m_threads));
+	this->m_threadCount = 0;
+	this->m_session = 0;
+	this->m_frameNumber = 0;
+	this->m_frameStart = 0;
+	this->m_frameTime = 0;
+	this->m_droppedCount = 0;
+	this->m_capturing = false;
+	this->m_captureStart = 0;
+}
+
+Profiler::Profiler(const Profiler& other)
+{
+}
+
+
+Profiler::~Profiler()
+{
+}
+
+bool Profiler::Initialize()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency;
+
+	//The chrono clocks of this compiler only tick every millisecond, the performance counter is exact
+	if (!QueryPerformanceFrequency(&frequency) || frequency.QuadPart == 0)
+	{
+		return false;
+	}
+	profilerFrequency = (unsigned long long)frequency.QuadPart;
+#endif
+
+	this->m_session = ++profilerSessions;
+	this->m_frameNumber = 0;
+	this->m_frameTime = 0;
+	this->m_droppedCount = 0;
+	this->m_frameEvents.reserve(PROFILER_THREAD_EVENTS);
+	this->m_nodes.reserve(256);
+
+	//The thread that initializes the profiler is the one that begins and ends the frames
+	ProfilerHandle = this;
+	Profiler::SetThreadName("Main");
+	this->m_frameStart = Profiler::GetTime();
+
+	return true;
+}
+
+void Profiler::Shutdown()
+{
+	int i;
+
+	//Every thread that records scopes has to be stopped before this
+	if (ProfilerHandle == this)
+	{
+		ProfilerHandle = nullptr;
+	}
+
+	lock_guard<mutex> lock(this->m_threadMutex);
+	for (i = 0; i < this->m_threadCount; i++)
+	{
+		delete this->m_threads[i];
+		this->m_threads[i] = nullptr;
+	}
+	this->m_threadCount = 0;
+
+	this->m_frameEvents.clear();
+	this->m_nodes.clear();
+	this->m_captureEvents.clear();
+	this->m_captureFrames.clear();
+	this->m_captureCounters.clear();
+	this->m_capturing = false;
+	this->m_frameCounters.clear();
+	this->m_counters.clear();
+}
+
+unsigned long long Profiler::GetTime()
+{
+#ifdef _WIN32
+	LARGE_INTEGER counter;
+	unsigned long long ticks;
+
+	QueryPerformanceCounter(&counter);
+	ticks = (unsigned long long)counter.QuadPart;
+
+	//Split the conversion so the multiply cannot overflow
+	return ticks / profilerFrequency * 1000000000ULL + ticks % profilerFrequency * 1000000000ULL / profilerFrequency;
+#else
+	return (unsigned long long)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	ThreadBufferType* buffer;
+
+	buffer = Profiler::GetThreadBuffer();
+	if (!buffer)
+	{
+		return;
+	}
+
+	lock_guard<mutex> lock(this->m_threadMutex);
+	strncpy(buffer->name, name, PROFILER_NAME_LENGTH - 1);
+	buffer->name[PROFILER_NAME_LENGTH - 1] = 0;
+}
+
+void Profiler::BeginFrame()
+{
+	this->m_frameStart = Profiler::GetTime();
+}
+
+void Profiler::EndFrame()
+{
+	unsigned long long frameEnd;
+	FrameType frame;
+	CounterEventType counter;
+	size_t i;
+
+	frameEnd = Profiler::GetTime();
+	this->m_frameTime = frameEnd - this->m_frameStart;
+
+	//Scopes land in the frame they finish in, a worker scope may have started in an earlier one
+	this->m_frameEvents.clear();
+	Profiler::DrainThreads();
+	Profiler::BuildTree();
+
+	//The counters added up during the frame become the frame's, the next frame starts from nothing
+	{
+		lock_guard<mutex> lock(this->m_counterMutex);
+		this->m_counters.swap(this->m_frameCounters);
+		this->m_frameCounters.clear();
+	}
+
+	if (this->m_capturing && this->m_frameStart >= this->m_captureStart)
+	{
+		frame.number = this->m_frameNumber;
+		frame.start = this->m_frameStart;
+		frame.end = frameEnd;
+		this->m_captureFrames.push_back(frame);
+
+		for (i = 0; i < this->m_counters.size(); i++)
+		{
+			counter.name = this->m_counters[i].name;
+			counter.time = frameEnd;
+			counter.value = this->m_counters[i].value;
+			this->m_captureCounters.push_back(counter);
+		}
+	}
+
+	this->m_frameNumber++;
+}
+
+unsigned long long Profiler::GetFrameNumber()
+{
+	return this->m_frameNumber;
+}
+
+unsigned long long Profiler::GetFrameTime()
+{
+	return this->m_frameTime;
+}
+
+unsigned int Profiler::GetDroppedCount()
+{
+	return this->m_droppedCount;
+}
+
+const vector<Profiler::NodeType>& Profiler::GetFrameNodes()
+{
+	return this->m_nodes;
+}
+
+int Profiler::FindNode(const char* path)
+{
+	const char* end;
+	size_t length;
+	int node, parent;
+
+	//The path is the names from a root down joined with slashes, like "Frame/Graphics::Render"
+	node = this->m_nodes.empty() ? -1 : 0;
+	parent = -1;
+	while (*path)
+	{
+		end = strchr(path, '/');
+		length = end ? (size_t)(end - path) : strlen(path);
+
+		while (node != -1 && (strncmp(this->m_nodes[node].name, path, length) != 0 || this->m_nodes[node].name[length] != 0))
+		{
+			node = this->m_nodes[node].nextSibling;
+		}
+		if (node == -1)
+		{
+			return -1;
+		}
+
+		parent = node;
+		node = this->m_nodes[node].firstChild;
+		path += length;
+		if (*path == '/')
+		{
+			path++;
+		}
+	}
+
+	return parent;
+}
+
+void Profiler::PrintFrame(FILE* file)
+{
+	size_t i;
+	int node;
+
+	fprintf(file, "Frame %llu, %.3f ms, %u dropped\n", this->m_frameNumber - 1, (double)this->m_frameTime / 1000000.0, this->m_droppedCount);
+
+	//Walk the tree depth first through the child and sibling links
+	node = this->m_nodes.empty() ? -1 : 0;
+	while (node != -1)
+	{
+		const NodeType& current = this->m_nodes[node];
+		fprintf(file, "%*s%-*s %6u %10.3f ms %10.3f ms\n", current.depth * 2, "", 40 - current.depth * 2, current.name, current.callCount, (double)current.totalTime / 1000000.0, (double)current.selfTime / 1000000.0);
+
+		if (current.firstChild != -1)
+		{
+			node = current.firstChild;
+			continue;
+		}
+
+		while (node != -1 && this->m_nodes[node].nextSibling == -1)
+		{
+			node = this->m_nodes[node].parent;
+		}
+		if (node != -1)
+		{
+			node = this->m_nodes[node].nextSibling;
+		}
+	}
+
+	//The counters follow the tree with the value they added up to
+	for (i = 0; i < this->m_counters.size(); i++)
+	{
+		fprintf(file, "%-40s %llu\n", this->m_counters[i].name, this->m_counters[i].value);
+	}
+}
+
+void Profiler::AddCounter(const char* name, unsigned long long value)
+{
+	CounterType counter;
+	size_t i;
+
+	lock_guard<mutex> lock(this->m_counterMutex);
+
+	//A frame has a handful of counters so a search beats a map
+	for (i = 0; i < this->m_frameCounters.size(); i++)
+	{
+		if (this->m_frameCounters[i].name == name || strcmp(this->m_frameCounters[i].name, name) == 0)
+		{
+			this->m_frameCounters[i].value += value;
+			return;
+		}
+	}
+
+	counter.name = name;
+	counter.value = value;
+	this->m_frameCounters.push_back(counter);
+}
+
+const vector<Profiler::CounterType>& Profiler::GetFrameCounters()
+{
+	return this->m_counters;
+}
+
+unsigned long long Profiler::GetCounter(const char* name)
+{
+	size_t i;
+
+	//A counter nothing added to in the last frame is zero
+	for (i = 0; i < this->m_counters.size(); i++)
+	{
+		if (strcmp(this->m_counters[i].name, name) == 0)
+		{
+			return this->m_counters[i].value;
+		}
+	}
+
+	return 0;
+}
+
+void Profiler::StartCapture()
+{
+	this->m_captureEvents.clear();
+	this->m_captureFrames.clear();
+	this->m_captureCounters.clear();
+	this->m_captureStart = Profiler::GetTime();
+	this->m_capturing = true;
+}
+
+void Profiler::StopCapture()
+{
+	this->m_capturing = false;
+}
+
+bool Profiler::IsCapturing()
+{
+	return this->m_capturing;
+}
+
+size_t Profiler::GetCaptureEventCount()
+{
+	return this->m_captureEvents.size();
+}
+
+bool Profiler::SaveTrace(const char* fileName)
+{
+	FILE* file;
+	size_t i;
+	int j;
+	bool result;
+
+	file = fopen(fileName, "w");
+	if (!file)
+	{
+		return false;
+	}
+
+	//The Chrome trace format wants microseconds, three decimals keep the nanoseconds
+	fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"Engine\"}}");
+
+	{
+		lock_guard<mutex> lock(this->m_threadMutex);
+		for (j = 0; j < this->m_threadCount; j++)
+		{
+			fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", j + 1);
+			Profiler::WriteString(file, this->m_threads[j]->name);
+			fprintf(file, "}}");
+			fprintf(file, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"sort_index\":%d}}", j + 1, j);
+		}
+	}
+
+	for (i = 0; i < this->m_captureFrames.size(); i++)
+	{
+		const FrameType& frame = this->m_captureFrames[i];
+		fprintf(file, ",\n{\"name\":\"Frame\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+			(double)(frame.start - this->m_captureStart) / 1000.0, (double)(frame.end - frame.start) / 1000.0, frame.number);
+	}
+
+	for (i = 0; i < this->m_captureEvents.size(); i++)
+	{
+		const EventType& event = this->m_captureEvents[i];
+		fprintf(file, ",\n{\"name\":");
+		Profiler::WriteString(file, event.name);
+		fprintf(file, ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+			event.threadIndex + 1, (double)(event.start - this->m_captureStart) / 1000.0, (double)(event.end - event.start) / 1000.0);
+	}
+
+	//Counters are drawn as a graph over the frames, with the value each frame ended on
+	for (i = 0; i < this->m_captureCounters.size(); i++)
+	{
+		const CounterEventType& counter = this->m_captureCounters[i];
+		fprintf(file, ",\n{\"name\":");
+		Profiler::WriteString(file, counter.name);
+		fprintf(file, ",\"cat\":\"counter\",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{\"value\":%llu}}", (double)(counter.time - this->m_captureStart) / 1000.0, counter.value);
+	}
+
+	fprintf(file, "\n]}\n");
+	result = ferror(file) == 0;
+	if (fclose(file) != 0)
+	{
+		return false;
+	}
+
+	return result;
+}
+
+Profiler::ThreadBufferType* Profiler::GetThreadBuffer()
+{
+	ThreadBufferType* buffer;
+	int count;
+
+	if (threadSession == this->m_session)
+	{
+		return (ThreadBufferType*)threadBuffer;
+	}
+
+	lock_guard<mutex> lock(this->m_threadMutex);
+
+	//A thread past the limit is remembered as having no buffer so it does not ask again
+	buffer = nullptr;
+	count = this->m_threadCount;
+	if (count < PROFILER_MAX_THREADS)
+	{
+		buffer = new ThreadBufferType;
+		buffer->read = 0;
+		buffer->write = 0;
+		buffer->dropped = 0;
+		buffer->depth = 0;
+		buffer->index = count;
+		sprintf(buffer->name, "Thread %d", count);
+
+		this->m_threads[count] = buffer;
+		this->m_threadCount.store(count + 1, memory_order_release);
+	}
+
+	threadSession = this->m_session;
+	threadBuffer = buffer;
+
+	return buffer;
+}
+
+void Profiler::DrainThreads()
+{
+	ThreadBufferType* buffer;
+	unsigned int read, write;
+	int i, count;
+
+	count = this->m_threadCount.load(memory_order_acquire);
+	for (i = 0; i < count; i++)
+	{
+		buffer = this->m_threads[i];
+		write = buffer->write.load(memory_order_acquire);
+		read = buffer->read.load(memory_order_relaxed);
+		while (read != write)
+		{
+			this->m_frameEvents.push_back(buffer->events[read & (PROFILER_THREAD_EVENTS - 1)]);
+			read++;
+		}
+		buffer->read.store(read, memory_order_release);
+
+		this->m_droppedCount += buffer->dropped.exchange(0, memory_order_relaxed);
+	}
+
+	if (this->m_capturing)
+	{
+		for (i = 0; i < (int)this->m_frameEvents.size(); i++)
+		{
+			if (this->m_frameEvents[i].start >= this->m_captureStart)
+			{
+				this->m_captureEvents.push_back(this->m_frameEvents[i]);
+			}
+		}
+
+		if (this->m_captureEvents.size() >= PROFILER_CAPTURE_EVENTS)
+		{
+			this->m_capturing = false;
+		}
+	}
+}
+
+void Profiler::BuildTree()
+{
+	struct StackType
+	{
+		int node;
+		unsigned int depth;
+		unsigned long long end;
+	};
+
+	StackType stack[PROFILER_MAX_DEPTH];
+	size_t i;
+	int top, node, parent, threadIndex, threadRoot, lastRoot;
+
+	this->m_nodes.clear();
+
+	//The main thread hangs under the frame itself, every other thread gets a root of its own
+	AddNode(-1, "Frame", 0, 0);
+	this->m_nodes[0].callCount = 1;
+	this->m_nodes[0].totalTime = this->m_frameTime;
+	lastRoot = 0;
+
+	//Sorting by start then depth puts every parent right before its children
+	sort(this->m_frameEvents.begin(), this->m_frameEvents.end(), Profiler::CompareEvents);
+
+	threadIndex = -1;
+	threadRoot = 0;
+	top = 0;
+	for (i = 0; i < this->m_frameEvents.size(); i++)
+	{
+		const EventType& event = this->m_frameEvents[i];
+
+		if (event.threadIndex != threadIndex)
+		{
+			threadIndex = event.threadIndex;
+			if (threadIndex == 0)
+			{
+				threadRoot = 0;
+			}
+			else
+			{
+				threadRoot = AddNode(-1, this->m_threads[threadIndex]->name, 0, threadIndex);
+				this->m_nodes[threadRoot].callCount = 1;
+				this->m_nodes[lastRoot].nextSibling = threadRoot;
+				lastRoot = threadRoot;
+			}
+			top = 0;
+		}
+
+		//A parent still open at the end of the frame is not in the list, so time decides as well as depth
+		while (top > 0 && (stack[top - 1].end <= event.start || stack[top - 1].depth >= event.depth))
+		{
+			top--;
+		}
+
+		parent = top > 0 ? stack[top - 1].node : threadRoot;
+		node = AddNode(parent, event.name, this->m_nodes[parent].depth + 1, threadIndex);
+		this->m_nodes[node].callCount++;
+		this->m_nodes[node].totalTime += event.end - event.start;
+
+		if (top < PROFILER_MAX_DEPTH)
+		{
+			stack[top].node = node;
+			stack[top].depth = event.depth;
+			stack[top].end = event.end;
+			top++;
+		}
+	}
+
+	//A thread root has no time of its own, it covers the scopes directly under it
+	for (node = 1; node < (int)this->m_nodes.size(); node++)
+	{
+		parent = this->m_nodes[node].parent;
+		if (parent > 0 && this->m_nodes[parent].parent == -1)
+		{
+			this->m_nodes[parent].totalTime += this->m_nodes[node].totalTime;
+		}
+	}
+
+	for (node = 0; node < (int)this->m_nodes.size(); node++)
+	{
+		this->m_nodes[node].selfTime = this->m_nodes[node].totalTime;
+	}
+	for (node = 0; node < (int)this->m_nodes.size(); node++)
+	{
+		parent = this->m_nodes[node].parent;
+		if (parent != -1)
+		{
+			if (this->m_nodes[parent].selfTime > this->m_nodes[node].totalTime)
+			{
+				this->m_nodes[parent].selfTime -= this->m_nodes[node].totalTime;
+			}
+			else
+			{
+				this->m_nodes[parent].selfTime = 0;
+			}
+		}
+	}
+}
+
+int Profiler::AddNode(int parent, const char* name, int depth, int threadIndex)
+{
+	NodeType node;
+	int index, last;
+
+	//Calls with the same name under the same parent share one node
+	last = -1;
+	if (parent != -1)
+	{
+		index = this->m_nodes[parent].firstChild;
+		while (index != -1)
+		{
+			if (this->m_nodes[index].name == name || strcmp(this->m_nodes[index].name, name) == 0)
+			{
+				return index;
+			}
+			last = index;
+			index = this->m_nodes[index].nextSibling;
+		}
+	}
+
+	node.name = name;
+	node.parent = parent;
+	node.firstChild = -1;
+	node.nextSibling = -1;
+	node.depth = depth;
+	node.threadIndex = threadIndex;
+	node.callCount = 0;
+	node.totalTime = 0;
+	node.selfTime = 0;
+
+	index = (int)this->m_nodes.size();
+	this->m_nodes.push_back(node);
+
+	if (parent != -1)
+	{
+		if (last == -1)
+		{
+			this->m_nodes[parent].firstChild = index;
+		}
+		else
+		{
+			this->m_nodes[last].nextSibling = index;
+		}
+	}
+
+	return index;
+}
+
+bool Profiler::CompareEvents(const EventType& first, const EventType& second)
+{
+	if (first.threadIndex != second.threadIndex)
+	{
+		return first.threadIndex < second.threadIndex;
+	}
+	if (first.start != second.start)
+	{
+		return first.start < second.start;
+	}
+
+	return first.depth < second.depth;
+}
+
+void Profiler::WriteString(FILE* file, const char* text)
+{
+	fputc('"', file);
+	for (; *text; text++)
+	{
+		if (*text == '"' || *text == '\\')
+		{
+			fputc('\\', file);
+			fputc(*text, file);
+		}
+		else if ((unsigned char)*text < 0x20)
+		{
+			fprintf(file, "\\u%04x", (unsigned char)*text);
+		}
+		else
+		{
+			fputc(*text, file);
+		}
+	}
+	fputc('"', file);
+}
+
+
+ProfileScope::ProfileScope(const char* name)
+{
+	this->m_Buffer = nullptr;
+	if (!ProfilerHandle)
+	{
+		return;
+	}
+
+	this->m_Buffer = ProfilerHandle->GetThreadBuffer();
+	if (!this->m_Buffer)
+	{
+		return;
+	}
+
+	this->m_name = name;
+	this->m_depth = this->m_Buffer->depth++;
+	this->m_start = Profiler::GetTime();
+}
+
+ProfileScope::ProfileScope(const ProfileScope& other)
+{
+	this->m_Buffer = nullptr;
+}
+
+
+ProfileScope::~ProfileScope()
+{
+	Profiler::EventType* event;
+	unsigned long long end;
+	unsigned int write;
+
+	if (!this->m_Buffer)
+	{
+		return;
+	}
+
+	end = Profiler::GetTime();
+	this->m_Buffer->depth--;
+
+	//Only this thread writes and only the frame reads, so a full ring just counts the loss
+	write = this->m_Buffer->write.load(memory_order_relaxed);
+	if (write - this->m_Buffer->read.load(memory_order_acquire) >= PROFILER_THREAD_EVENTS)
+	{
+		this->m_Buffer->dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	event = &this->m_Buffer->events[write & (PROFILER_THREAD_EVENTS - 1)];
+	event->name = this->m_name;
+	event->start = this->m_start;
+	event->end = end;
+	event->depth = this->m_depth;
+	event->threadIndex = this->m_Buffer->index;
+	this->m_Buffer->write.store(write + 1, memory_order_release);
+}
\ No newline at end of file
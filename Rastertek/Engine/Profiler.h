@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: Profiler.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Events each thread can hold between two frames, a power of two
+const unsigned int PROFILER_THREAD_EVENTS = 16384;
+const int PROFILER_MAX_THREADS = 64;
+const int PROFILER_NAME_LENGTH = 32;
+const int PROFILER_MAX_DEPTH = 64;
+
+//A capture stops by itself past this many events so a forgotten capture cannot eat the memory
+const size_t PROFILER_CAPTURE_EVENTS = 4 * 1024 * 1024;
+
+#ifdef _WIN32
+#define PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+#define PROFILER_THREAD_LOCAL __thread
+#endif
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+//Define PROFILER_DISABLED to compile every marker out
+#ifdef PROFILER_DISABLED
+#define PROFILE_SCOPE(name)
+#define PROFILE_COUNTER(name, value)
+#else
+#define PROFILE_SCOPE(name) ProfileScope PROFILER_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_COUNTER(name, value) do { if (ProfilerHandle) { ProfilerHandle->AddCounter(name, value); } } while (0)
+#endif
+
+class ProfileScope;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: Profiler
+////////////////////////////////////////////////////////////////////////////////
+class Profiler
+{
+public:
+	struct NodeType
+	{
+		const char* name;
+		int parent;
+		int firstChild;
+		int nextSibling;
+		int depth;
+		int threadIndex;
+		unsigned int callCount;
+		unsigned long long totalTime;
+		unsigned long long selfTime;
+	};
+
+	struct CounterType
+	{
+		const char* name;
+		unsigned long long value;
+	};
+
+private:
+	struct EventType
+	{
+		const char* name;
+		unsigned long long start;
+		unsigned long long end;
+		unsigned int depth;
+		int threadIndex;
+	};
+
+	struct ThreadBufferType
+	{
+		EventType events[PROFILER_THREAD_EVENTS];
+		atomic<unsigned int> read;
+		atomic<unsigned int> write;
+		atomic<unsigned int> dropped;
+		unsigned int depth;
+		int index;
+		char name[PROFILER_NAME_LENGTH];
+	};
+
+	struct FrameType
+	{
+		unsigned long long number;
+		unsigned long long start;
+		unsigned long long end;
+	};
+
+	struct CounterEventType
+	{
+		const char* name;
+		unsigned long long time;
+		unsigned long long value;
+	};
+
+	ThreadBufferType* m_threads[PROFILER_MAX_THREADS];
+	atomic<int> m_threadCount;
+	mutex m_threadMutex;
+	unsigned int m_session;
+
+	unsigned long long m_frameNumber;
+	unsigned long long m_frameStart;
+	unsigned long long m_frameTime;
+	unsigned int m_droppedCount;
+	vector<EventType> m_frameEvents;
+	vector<NodeType> m_nodes;
+
+	mutex m_counterMutex;
+	vector<CounterType> m_frameCounters;
+	vector<CounterType> m_counters;
+
+	bool m_capturing;
+	unsigned long long m_captureStart;
+	vector<EventType> m_captureEvents;
+	vector<FrameType> m_captureFrames;
+	vector<CounterEventType> m_captureCounters;
+
+public:
+	Profiler();
+	Profiler(const Profiler& other);
+	~Profiler();
+
+	bool Initialize();
+	void Shutdown();
+
+	static unsigned long long GetTime();
+
+	void SetThreadName(const char* name);
+
+	void BeginFrame();
+	void EndFrame();
+
+	unsigned long long GetFrameNumber();
+	unsigned long long GetFrameTime();
+	unsigned int GetDroppedCount();
+	const vector<NodeType>& GetFrameNodes();
+	int FindNode(const char* path);
+	void PrintFrame(FILE* file);
+
+	//Counters with the same name are added up over the frame, the name has to stay valid like a scope name
+	void AddCounter(const char* name, unsigned long long value);
+	const vector<CounterType>& GetFrameCounters();
+	unsigned long long GetCounter(const char* name);
+
+	void StartCapture();
+	void StopCapture();
+	bool IsCapturing();
+	size_t GetCaptureEventCount();
+	bool SaveTrace(const char* fileName);
+
+private:
+	friend class ProfileScope;
+
+	ThreadBufferType* GetThreadBuffer();
+	void DrainThreads();
+	void BuildTree();
+	int AddNode(int parent, const char* name, int depth, int threadIndex);
+	static bool CompareEvents(const EventType& first, const EventType& second);
+	static void WriteString(FILE* file, const char* text);
+};
+
+/////////////
+// GLOBALS //
+/////////////
+extern Profiler* ProfilerHandle;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: ProfileScope
+////////////////////////////////////////////////////////////////////////////////
+class ProfileScope
+{
+private:
+	Profiler::ThreadBufferType* m_Buffer;
+	const char* m_name;
+	unsigned long long m_start;
+	unsigned int m_depth;
+
+public:
+	ProfileScope(const char* name);
+	ProfileScope(const ProfileScope& other);
+	~ProfileScope();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: RiffReader.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "RiffReader.h"
+
+
+RiffReader::RiffReader()
+{
+	this->m_data = nullptr;
+	this->m_size = 0;
+	this->m_position = 0;
+	memset(this->m_formType, 0, sizeof(this->m_formType));
+}
+
+RiffReader::RiffReader(const RiffReader& other)
+{
+}
+
+
+RiffReader::~RiffReader()
+{
+}
+
+bool RiffReader::Initialize(const void* data, size_t size)
+{
+	size_t riffSize;
+
+	//A RIFF file is a single RIFF chunk holding the form type and then the chunks of the form
+	if (size < 12 || memcmp(data, "RIFF", 4) != 0)
+	{
+		return false;
+	}
+
+	this->m_data = (const unsigned char*)data;
+	memcpy(this->m_formType, this->m_data + 8, 4);
+
+	//Writers that never went back to fill in the size leave it too big or zero, so only trust it when it fits
+	riffSize = RiffReader::ReadUInt(this->m_data + 4);
+	if (riffSize >= 4 && riffSize <= size - 8)
+	{
+		this->m_size = riffSize + 8;
+	}
+	else
+	{
+		this->m_size = size;
+	}
+
+	this->m_position = 12;
+
+	return true;
+}
+
+bool RiffReader::IsFormType(const char* formType)
+{
+	return memcmp(this->m_formType, formType, 4) == 0;
+}
+
+bool RiffReader::NextChunk(ChunkType& chunk)
+{
+	size_t remaining;
+	size_t chunkSize;
+
+	//Every chunk is an id and a size followed by the data, padded to an even length
+	if (this->m_position > this->m_size || this->m_size - this->m_position < 8)
+	{
+		return false;
+	}
+
+	memcpy(chunk.id, this->m_data + this->m_position, 4);
+	chunkSize = RiffReader::ReadUInt(this->m_data + this->m_position + 4);
+	this->m_position += 8;
+
+	//A chunk that runs past the end is cut short and ends the walk, the data chunk of an unfinished recording looks like this
+	remaining = this->m_size - this->m_position;
+	chunk.data = this->m_data + this->m_position;
+	chunk.truncated = chunkSize > remaining;
+	if (chunk.truncated)
+	{
+		chunk.size = remaining;
+		this->m_position = this->m_size;
+		return true;
+	}
+	chunk.size = chunkSize;
+
+	this->m_position += chunkSize + (chunkSize & 1);
+
+	return true;
+}
+
+bool RiffReader::FindChunk(const char* id, ChunkType& chunk)
+{
+	//Search from the start so the order of the chunks does not matter
+	RiffReader::Rewind();
+	while (RiffReader::NextChunk(chunk))
+	{
+		if (memcmp(chunk.id, id, 4) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void RiffReader::Rewind()
+{
+	this->m_position = 12;
+}
+
+unsigned short RiffReader::ReadUShort(const unsigned char* data)
+{
+	//RIFF is little endian and the fields are not aligned, so build the values a byte at a time
+	return (unsigned short)(data[0] | (data[1] << 8));
+}
+
+unsigned int RiffReader::ReadUInt(const unsigned char* data)
+{
+	return (unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: RiffReader.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _RIFFREADER_H_
+#define _RIFFREADER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <cstddef>
+#include <cstring>
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: RiffReader
+////////////////////////////////////////////////////////////////////////////////
+
+//Walks the chunks of a RIFF file in memory, the chunks point into the caller's memory and nothing is copied
+class RiffReader
+{
+public:
+	struct ChunkType
+	{
+		char id[4];
+		const unsigned char* data;
+		size_t size;
+		bool truncated;
+	};
+
+private:
+	const unsigned char* m_data;
+	size_t m_size;
+	size_t m_position;
+	char m_formType[4];
+
+public:
+	RiffReader();
+	RiffReader(const RiffReader& other);
+	~RiffReader();
+
+	bool Initialize(const void* data, size_t size);
+
+	bool IsFormType(const char* formType);
+	bool NextChunk(ChunkType& chunk);
+	bool FindChunk(const char* id, ChunkType& chunk);
+	void Rewind();
+
+	static unsigned short ReadUShort(const unsigned char* data);
+	static unsigned int ReadUInt(const unsigned char* data);
+};
+
+#endif
\ No newline at end of file
@@ -8,9 +8,12 @@ Sound::Sound()
 {
 	this->m_directSound = nullptr;
 	this->m_primaryDirectSoundBuffer = nullptr;
-	this->directSound3DListener = nullptr;
-	this->m_secondaryDirectSoundBuffer = nullptr;
-	this->m_secondaryDirectSound3DBuffer = nullptr;
+	this->m_MixerSink = nullptr;
+	this->m_Mixer = nullptr;
+	this->m_EffectClip = nullptr;
+	this->m_MusicFile = nullptr;
+	this->m_MusicSink = nullptr;
+	this->m_MusicStream = nullptr;
 }
 
 Sound::Sound(const Sound& other)
@@ -25,6 +28,7 @@ Sound::~Sound()
 bool Sound::Initialize(HWND hwnd)
 {
 	bool result;
+	int voice;
 
 	//Initialize direct sound and the primary sound buffer
 	result = Sound::InitializeDirectSound(hwnd);
@@ -33,31 +37,157 @@ bool Sound::Initialize(HWND hwnd)
 		return false;
 	}
 
-	//Load a wave audio file onto a secondary buffer
-	result = Sound::LoadWaveFile("sound02.wav", &this->m_secondaryDirectSoundBuffer, &this->m_secondaryDirectSound3DBuffer);
+	//Start the software mixer that plays every sound effect
+	result = Sound::InitializeMixer();
 	if (!result)
 	{
 		return false;
 	}
 
-	//Play the wave file now that it has been loaded
-	result = Sound::PlayWaveFile();
+	//Load a wave audio file into a clip the mixer can play
+	result = Sound::LoadWaveFile("sound02.wav", &this->m_EffectClip, false);
 	if (!result)
 	{
 		return false;
 	}
+
+	//Play the wave file now that it has been loaded
+	voice = Sound::PlayWaveFile(D3DXVECTOR3(-2.0f, 0.0f, 0.0f));
+	if (voice < 0)
+	{
+		return false;
+	}
+
 	return true;
 }
 
 void Sound::Shutdown()
 {
-	//Release the secondary buffer
-	Sound::ShutdownWaveFile(&this->m_secondaryDirectSoundBuffer, &this->m_secondaryDirectSound3DBuffer);
+	//Stop the music stream
+	Sound::StopMusic();
+
+	//Stop the mixer before the clips it plays are released
+	Sound::ShutdownMixer();
+
+	//Release the clip
+	Sound::ShutdownWaveFile(&this->m_EffectClip);
 
 	//Shutdown the Direct Sound API
 	Sound::ShutdownDirectSound();
 }
 
+void Sound::Frame(Camera* camera)
+{
+	D3DXVECTOR3 position;
+	float radians;
+	float forward[3];
+	float right[3];
+
+	//Hear the world from the camera, it only turns around the y axis
+	position = camera->GetPosition();
+	radians = camera->GetRotation().y * 0.0174532925f;
+	forward[0] = sinf(radians);
+	forward[1] = 0.0f;
+	forward[2] = cosf(radians);
+	right[0] = cosf(radians);
+	right[1] = 0.0f;
+	right[2] = -sinf(radians);
+	this->m_Mixer->SetListener(&position.x, forward, right);
+
+	//Take back the voices that finished playing
+	this->m_Mixer->Update();
+}
+
+int Sound::PlayWaveFile(D3DXVECTOR3 position)
+{
+	SoundMixer::VoiceDescType desc;
+
+	//Place the sound in the world, the mixer pans and attenuates it against the listener
+	desc.volume = 1.0f;
+	desc.pitch = 1.0f;
+	desc.priority = 0;
+	desc.spatial = true;
+	desc.position[0] = position.x;
+	desc.position[1] = position.y;
+	desc.position[2] = position.z;
+
+	return this->m_Mixer->PlayVoice(this->m_EffectClip, desc);
+}
+
+bool Sound::PlayMusic(char* fileName, bool loop)
+{
+	bool result;
+
+	//Only one piece of music plays at a time
+	Sound::StopMusic();
+
+	//Map the wave file, the samples are read from the mapping as they are needed
+	this->m_MusicFile = new WaveFile();
+	if (!this->m_MusicFile)
+	{
+		return false;
+	}
+
+	result = this->m_MusicFile->Initialize(fileName);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Create a sound buffer that only holds a few segments of the music
+	this->m_MusicSink = new DirectSoundSink();
+	if (!this->m_MusicSink)
+	{
+		return false;
+	}
+
+	result = this->m_MusicSink->Initialize(this->m_directSound, this->m_MusicFile->GetChannels(), this->m_MusicFile->GetSampleRate(), SoundStream::GetOutputBits(this->m_MusicFile), SoundStream::GetBufferSize(this->m_MusicFile, SOUND_STREAM_SEGMENT_MILLISECONDS, SOUND_STREAM_SEGMENT_COUNT));
+	if (!result)
+	{
+		return false;
+	}
+
+	//Start the stream, its thread refills the segments as they are played
+	this->m_MusicStream = new SoundStream();
+	if (!this->m_MusicStream)
+	{
+		return false;
+	}
+
+	result = this->m_MusicStream->Initialize(this->m_MusicFile, this->m_MusicSink, SOUND_STREAM_SEGMENT_COUNT, loop, true);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void Sound::StopMusic()
+{
+	//Release the stream before the sound buffer and the file it reads from
+	if (this->m_MusicStream)
+	{
+		this->m_MusicStream->Shutdown();
+		delete this->m_MusicStream;
+		this->m_MusicStream = nullptr;
+	}
+
+	if (this->m_MusicSink)
+	{
+		this->m_MusicSink->Shutdown();
+		delete this->m_MusicSink;
+		this->m_MusicSink = nullptr;
+	}
+
+	if (this->m_MusicFile)
+	{
+		this->m_MusicFile->Shutdown();
+		delete this->m_MusicFile;
+		this->m_MusicFile = nullptr;
+	}
+}
+
 bool Sound::InitializeDirectSound(HWND hwnd)
 {
 	HRESULT result;
@@ -81,7 +211,7 @@ bool Sound::InitializeDirectSound(HWND hwnd)
 
 	//Setup the primary buffer description
 	bufferDesc.dwBufferBytes = 0;
-	bufferDesc.dwFlags = DSBCAPS_PRIMARYBUFFER | DSBCAPS_CTRLVOLUME | DSBCAPS_CTRL3D;
+	bufferDesc.dwFlags = DSBCAPS_PRIMARYBUFFER | DSBCAPS_CTRLVOLUME;
 	bufferDesc.dwReserved = 0;
 	bufferDesc.dwSize = sizeof(DSBUFFERDESC);
 	bufferDesc.guid3DAlgorithm = GUID_NULL;
@@ -100,7 +230,7 @@ bool Sound::InitializeDirectSound(HWND hwnd)
 	//Setup the format of the primary sound buffer
 	//In this case it is a .WAV file recorded at 44,100 samples per second in 16-bit stereo (CD audio format)
 	waveFormat.cbSize = 0;
-	waveFormat.nSamplesPerSec = 44100;
+	waveFormat.nSamplesPerSec = SOUND_SAMPLE_RATE;
 	waveFormat.wBitsPerSample = 16;
 	waveFormat.nChannels = 2;
 	waveFormat.nBlockAlign = (waveFormat.wBitsPerSample / 8) * waveFormat.nChannels;
@@ -114,28 +244,11 @@ bool Sound::InitializeDirectSound(HWND hwnd)
 		return false;
 	}
 
-	// Obtain a listener interface.
-	result = this->m_primaryDirectSoundBuffer->QueryInterface(IID_IDirectSound3DListener8, (LPVOID*)&this->directSound3DListener);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	// Set the initial position of the listener to be in the middle of the screen.
-	this->directSound3DListener->SetPosition(0.0f, 0.0f, 0.0f, DS3D_IMMEDIATE);
-	
 	return true;
 }
 
 void Sound::ShutdownDirectSound()
 {
-	// Release the IDirectSound3DListener pointer.
-	if (this->directSound3DListener)
-	{
-		this->directSound3DListener->Release();
-		this->directSound3DListener = nullptr;
-	}
-
 	// Release the primary DirectSoundBuffer pointer.
 	if (this->m_primaryDirectSoundBuffer)
 	{
@@ -151,182 +264,83 @@ void Sound::ShutdownDirectSound()
 	}
 }
 
-bool Sound::LoadWaveFile(char* fileName, IDirectSoundBuffer8** secondaryBuffer, IDirectSound3DBuffer8** secondary3DBuffer)
+bool Sound::InitializeMixer()
 {
-	HRESULT result;
-
-	//Open the wave file in binary
-	FILE* filePtr;
-	int error = fopen_s(&filePtr, fileName, "rb");
-	if (error != 0)
-	{
-		return false;
-	}
-
-	//Read in the wave file header
-	WaveHeaderType waveFileHeader;
-	UINT count = fread(&waveFileHeader, sizeof(WaveHeaderType), 1, filePtr);
-	if (count != 1)
-	{
-		return false;
-	}
-
-	//Check that the chunk ID is the RIFF format
-	if (
-		(waveFileHeader.chunkId[0] != 'R') ||
-		(waveFileHeader.chunkId[1] != 'I') ||
-		(waveFileHeader.chunkId[2] != 'F') ||
-		(waveFileHeader.chunkId[3] != 'F'))
-	{
-		return false;
-	}
-
-	//Check if the file format is the WAVE format
-	if (
-		(waveFileHeader.format[0] != 'W') ||
-		(waveFileHeader.format[1] != 'A') ||
-		(waveFileHeader.format[2] != 'V') ||
-		(waveFileHeader.format[3] != 'E'))
-	{
-		return false;
-	}
-
-	//Check that the sub chunk ID is the fmt format
-	if (
-		(waveFileHeader.subChunkId[0] != 'f') ||
-		(waveFileHeader.subChunkId[1] != 'm') ||
-		(waveFileHeader.subChunkId[2] != 't') ||
-		(waveFileHeader.subChunkId[3] != ' '))
-	{
-		return false;
-	}
-
-	//Check that the audio format is WAVE_FORMAT_PCM
-	if (waveFileHeader.audioFormat != WAVE_FORMAT_PCM)
-	{
-		return false;
-	}
+	bool result;
 
-	//Check that the wave file was recorded in stereo format
-	if (waveFileHeader.numChannels != 1)
+	//Create a 16 bit stereo sound buffer that only holds a few short segments of the mix
+	this->m_MixerSink = new DirectSoundSink();
+	if (!this->m_MixerSink)
 	{
 		return false;
 	}
 
-	//Check that the wave file was recorded at a sample rate of 44.1KHz
-	if (waveFileHeader.sampleRate != 44100)
+	result = this->m_MixerSink->Initialize(this->m_directSound, 2, SOUND_SAMPLE_RATE, 16, SoundMixer::GetBufferSize(SOUND_SAMPLE_RATE, SOUND_MIXER_SEGMENT_MILLISECONDS, SOUND_MIXER_SEGMENT_COUNT));
+	if (!result)
 	{
 		return false;
 	}
 
-	//Ensure that the wave file was recorded in 16 bit format
-	if (waveFileHeader.bitsPerSample != 16)
+	//Start the mixer, its thread mixes the segments as they are played
+	this->m_Mixer = new SoundMixer();
+	if (!this->m_Mixer)
 	{
 		return false;
 	}
 
-	//Check for the data chunk header
-	if (
-		(waveFileHeader.dataChunkId[0] != 'd') ||
-		(waveFileHeader.dataChunkId[1] != 'a') ||
-		(waveFileHeader.dataChunkId[2] != 't') ||
-		(waveFileHeader.dataChunkId[3] != 'a'))
+	result = this->m_Mixer->Initialize(this->m_MixerSink, SOUND_SAMPLE_RATE, SOUND_MIXER_SEGMENT_COUNT, true);
+	if (!result)
 	{
 		return false;
 	}
 
-	WAVEFORMATEX waveFormat;
-	ZeroMemory(&waveFormat, sizeof(WAVEFORMATEX));
-
-	//Set the wave format of secondary buffer that this wave file will be loaded onto
-	waveFormat.cbSize = 0;
-	waveFormat.nChannels = 1;
-	waveFormat.nSamplesPerSec = 44100;
-	waveFormat.wBitsPerSample = 16;
-	waveFormat.wFormatTag = WAVE_FORMAT_PCM;
-	waveFormat.nBlockAlign = (waveFormat.wBitsPerSample / 8) * waveFormat.nChannels;
-	waveFormat.nAvgBytesPerSec = waveFormat.nSamplesPerSec * waveFormat.nBlockAlign;
-
-	DSBUFFERDESC bufferDesc;
-	ZeroMemory(&bufferDesc, sizeof(DSBUFFERDESC));
-
-	//Set the buffer description of the secondary sound buffer that the wave file will be loaded onto
-	bufferDesc.dwBufferBytes = waveFileHeader.dataSize;
-	bufferDesc.dwFlags = DSBCAPS_CTRLVOLUME | DSBCAPS_CTRL3D;
-	bufferDesc.dwReserved = 0;
-	bufferDesc.dwSize = sizeof(DSBUFFERDESC);
-	bufferDesc.guid3DAlgorithm = GUID_NULL;
-	bufferDesc.lpwfxFormat = &waveFormat;
+	return true;
+}
 
-	//Create a temporary sound buffer with the specific buffer settings
-	IDirectSoundBuffer* tempBuffer;
-	result = this->m_directSound->CreateSoundBuffer(&bufferDesc, &tempBuffer, nullptr);
-	if (FAILED(result))
+void Sound::ShutdownMixer()
+{
+	//Release the mixer before the sound buffer it mixes into
+	if (this->m_Mixer)
 	{
-		return false;
+		this->m_Mixer->Shutdown();
+		delete this->m_Mixer;
+		this->m_Mixer = nullptr;
 	}
 
-	//Test the buffer format against the direct sound 8 interface and create the secondary buffer
-	result = tempBuffer->QueryInterface(IID_IDirectSoundBuffer8, (void**)&*secondaryBuffer);
-	if (FAILED(result))
+	if (this->m_MixerSink)
 	{
-		return false;
-	}
-
-	//Release the temporary buffer
-	tempBuffer->Release();
-	tempBuffer = nullptr;
-
-	//Move to the beginning of the wave data which starts at the end of the data chunk header
-	fseek(filePtr, sizeof(WaveHeaderType), SEEK_SET);
-
-	//Create a temporary buffer to hold the wave file data
-	UCHAR* waveData = new UCHAR[waveFileHeader.dataSize];
-	if (!waveData)
-	{
-		return false;
+		this->m_MixerSink->Shutdown();
+		delete this->m_MixerSink;
+		this->m_MixerSink = nullptr;
 	}
+}
 
-	//Read in the wave file data into the newly created buffer
-	count = fread(waveData, 1, waveFileHeader.dataSize, filePtr);
-	if (count != waveFileHeader.dataSize)
-	{
-		return false;
-	}
+bool Sound::LoadWaveFile(char* fileName, SoundClip** clip, bool loop)
+{
+	bool result;
+	WaveFile waveFile;
 
-	//Close the file once done reading
-	error = fclose(filePtr);
-	if (error != 0)
+	//Map the wave file, the chunks are found wherever they are in the file
+	result = waveFile.Initialize(fileName);
+	if (!result)
 	{
 		return false;
 	}
 
-	//Lock the secondary buffer to write wave data into it
-	UCHAR* bufferPtr = nullptr;
-	ULONG bufferSize;
-	result = (*secondaryBuffer)->Lock(0, waveFileHeader.dataSize, (void**)&bufferPtr, (DWORD*)&bufferSize, nullptr, nullptr, 0);
-	if (FAILED(result))
+	//Convert the samples into a clip, any rate and sample format is played
+	*clip = new SoundClip();
+	if (!*clip)
 	{
+		waveFile.Shutdown();
 		return false;
 	}
 
-	//Copy the wave data into the buffer
-	memcpy(bufferPtr, waveData, waveFileHeader.dataSize);
-
-	//Unlock the secondary buffer after the data has been written to it
-	result = (*secondaryBuffer)->Unlock((void*)bufferPtr, bufferSize, nullptr, 0);
-	if (FAILED(result))
-	{
-		return false;
-	}
+	result = (*clip)->Initialize(&waveFile, loop);
 
-	//Release the wave data since it was copied into the secondary buffer
-	delete[] waveData;
-	waveData = nullptr;
+	//Release the file mapping since the samples were copied into the clip
+	waveFile.Shutdown();
 
-	// Get the 3D interface to the secondary sound buffer
-	result = (*secondaryBuffer)->QueryInterface(IID_IDirectSound3DBuffer8, (void**)&*secondary3DBuffer);
-	if (FAILED(result))
+	if (!result)
 	{
 		return false;
 	}
@@ -334,50 +348,13 @@ bool Sound::LoadWaveFile(char* fileName, IDirectSoundBuffer8** secondaryBuffer,
 	return true;
 }
 
-void Sound::ShutdownWaveFile(IDirectSoundBuffer8** secondaryBuffer, IDirectSound3DBuffer8** secondary3DBuffer)
-{
-	// Release the IDirectSound3DBuffer pointer.
-	if (*secondary3DBuffer)
-	{
-		(*secondary3DBuffer)->Release();
-		(*secondary3DBuffer) = nullptr;
-	}
-	// Release the IDirectSoundBuffer pointer.
-	if (*secondaryBuffer)
-	{
-		(*secondaryBuffer)->Release();
-		(*secondaryBuffer) = nullptr;
-	}
-}
-
-bool Sound::PlayWaveFile()
+void Sound::ShutdownWaveFile(SoundClip** clip)
 {
-	HRESULT result;
-
-	D3DXVECTOR3 position = D3DXVECTOR3(-2.0f, 0.0f, 0.0f);
-
-	//Set position at the beginning of the sound buffer
-	result = this->m_secondaryDirectSoundBuffer->SetCurrentPosition(0);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	//Set volume of the buffer to 100%
-	result = this->m_secondaryDirectSoundBuffer->SetVolume(DSBVOLUME_MAX);
-	if (FAILED(result))
-	{
-		return false;
-	}
-
-	// Set the 3D position of the sound
-	this->m_secondaryDirectSound3DBuffer->SetPosition(position.x, position.y, position.z, DS3D_IMMEDIATE);
-
-	//Play the contents of the secondary sound buffer
-	result = this->m_secondaryDirectSoundBuffer->Play(0, 0, 0); //Set last value to DSBPLAY_LOOPING for looping.
-	if (FAILED(result))
+	// Release the clip.
+	if (*clip)
 	{
-		return false;
+		(*clip)->Shutdown();
+		delete *clip;
+		*clip = nullptr;
 	}
-	return true;
 }
\ No newline at end of file
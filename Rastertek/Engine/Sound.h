@@ -20,6 +20,21 @@
 #include <stdio.h>
 #include <d3dx10math.h>
 
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "Camera.h"
+#include "WaveFile.h"
+#include "DirectSoundSink.h"
+#include "SoundClip.h"
+#include "SoundMixer.h"
+#include "SoundStream.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned int SOUND_SAMPLE_RATE = 44100;
+
 ///////////////////////////////////////////////////////////////////////////////
 // Class name: Sound
 ///////////////////////////////////////////////////////////////////////////////
@@ -27,29 +42,16 @@ class Sound
 {
 
 private:
-	struct WaveHeaderType
-	{
-		char chunkId[4];
-		ULONG chunkSize;
-		char format[4];
-		char subChunkId[4];
-		ULONG subChunkSize;
-		USHORT audioFormat;
-		USHORT numChannels;
-		ULONG sampleRate;
-		ULONG bytesPerSecond;
-		USHORT blockAlign;
-		USHORT bitsPerSample;
-		char dataChunkId[4];
-		ULONG dataSize;
-	};
-
 	IDirectSound8* m_directSound;
 	IDirectSoundBuffer* m_primaryDirectSoundBuffer;
 
-	IDirectSound3DListener8* directSound3DListener;
-	IDirectSoundBuffer8* m_secondaryDirectSoundBuffer;
-	IDirectSound3DBuffer8* m_secondaryDirectSound3DBuffer;
+	DirectSoundSink* m_MixerSink;
+	SoundMixer* m_Mixer;
+	SoundClip* m_EffectClip;
+
+	WaveFile* m_MusicFile;
+	DirectSoundSink* m_MusicSink;
+	SoundStream* m_MusicStream;
 
 public:
 	Sound();
@@ -58,15 +60,23 @@ public:
 
 	bool Initialize(HWND hwnd);
 	void Shutdown();
+	void Frame(Camera* camera);
+
+	int PlayWaveFile(D3DXVECTOR3 position);
+
+	//Streams the music from disk instead of loading all of it into a sound buffer, ADPCM files are decoded by the stream thread
+	bool PlayMusic(char* fileName, bool loop);
+	void StopMusic();
 
 private:
 	bool InitializeDirectSound(HWND hwnd);
 	void ShutdownDirectSound();
 
-	bool LoadWaveFile(char* fileName, IDirectSoundBuffer8** secondaryBuffer, IDirectSound3DBuffer8** secondary3DBuffer);
-	void ShutdownWaveFile(IDirectSoundBuffer8** secondaryBuffer, IDirectSound3DBuffer8** secondary3DBuffer);
+	bool InitializeMixer();
+	void ShutdownMixer();
 
-	bool PlayWaveFile();
+	bool LoadWaveFile(char* fileName, SoundClip** clip, bool loop);
+	void ShutdownWaveFile(SoundClip** clip);
 };
 
 #endif
\ No newline at end of file
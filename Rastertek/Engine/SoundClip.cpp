@@ -0,0 +1,152 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SoundClip.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "SoundClip.h"
+
+
+SoundClip::SoundClip()
+{
+	this->m_buffer = nullptr;
+	this->m_samples = nullptr;
+	this->m_frameCount = 0;
+	this->m_channels = 0;
+	this->m_sampleRate = 0;
+	this->m_loop = false;
+}
+
+SoundClip::SoundClip(const SoundClip& other)
+{
+}
+
+
+SoundClip::~SoundClip()
+{
+}
+
+bool SoundClip::Initialize(WaveFile* file, bool loop)
+{
+	bool result;
+
+	//The mixer plays mono and stereo clips
+	if (file->GetChannels() > 2 || file->GetFrameCount() == 0 || file->GetFrameCount() > 0x7FFFFFFF)
+	{
+		return false;
+	}
+
+	result = SoundClip::Allocate((unsigned int)file->GetFrameCount(), file->GetChannels(), file->GetSampleRate(), loop);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Convert the whole file to floats once so voices never touch the file format
+	file->ReadSamples(0, this->m_frameCount, this->m_samples);
+	SoundClip::FillGuards();
+
+	return true;
+}
+
+bool SoundClip::Initialize(const float* samples, unsigned int frameCount, unsigned short channels, unsigned int sampleRate, bool loop)
+{
+	bool result;
+
+	if (channels == 0 || channels > 2 || frameCount == 0 || sampleRate == 0)
+	{
+		return false;
+	}
+
+	result = SoundClip::Allocate(frameCount, channels, sampleRate, loop);
+	if (!result)
+	{
+		return false;
+	}
+
+	memcpy(this->m_samples, samples, (size_t)frameCount * channels * sizeof(float));
+	SoundClip::FillGuards();
+
+	return true;
+}
+
+void SoundClip::Shutdown()
+{
+	//Release the samples, no voice may still be playing the clip
+	if (this->m_buffer)
+	{
+		delete[] this->m_buffer;
+		this->m_buffer = nullptr;
+	}
+	this->m_samples = nullptr;
+	this->m_frameCount = 0;
+}
+
+const float* SoundClip::GetSamples()
+{
+	return this->m_samples;
+}
+
+unsigned int SoundClip::GetFrameCount()
+{
+	return this->m_frameCount;
+}
+
+unsigned short SoundClip::GetChannels()
+{
+	return this->m_channels;
+}
+
+unsigned int SoundClip::GetSampleRate()
+{
+	return this->m_sampleRate;
+}
+
+bool SoundClip::IsLooping()
+{
+	return this->m_loop;
+}
+
+size_t SoundClip::GetMemorySize()
+{
+	return ((size_t)this->m_frameCount + SOUND_CLIP_GUARD_FRAMES * 2) * this->m_channels * sizeof(float);
+}
+
+bool SoundClip::Allocate(unsigned int frameCount, unsigned short channels, unsigned int sampleRate, bool loop)
+{
+	this->m_buffer = new float[((size_t)frameCount + SOUND_CLIP_GUARD_FRAMES * 2) * channels];
+	if (!this->m_buffer)
+	{
+		return false;
+	}
+
+	this->m_samples = this->m_buffer + SOUND_CLIP_GUARD_FRAMES * channels;
+	this->m_frameCount = frameCount;
+	this->m_channels = channels;
+	this->m_sampleRate = sampleRate;
+	this->m_loop = loop;
+
+	return true;
+}
+
+void SoundClip::FillGuards()
+{
+	unsigned int guardSamples;
+	unsigned int i;
+	unsigned int sampleCount;
+
+	guardSamples = SOUND_CLIP_GUARD_FRAMES * this->m_channels;
+	sampleCount = this->m_frameCount * this->m_channels;
+
+	//A looping clip continues into its own start and comes out of its own end, a one shot clip is silent on both sides
+	for (i = 0; i < guardSamples; i++)
+	{
+		if (this->m_loop)
+		{
+			this->m_samples[-(int)guardSamples + (int)i] = this->m_samples[(sampleCount * 2 - guardSamples % sampleCount + i) % sampleCount];
+			this->m_samples[sampleCount + i] = this->m_samples[i % sampleCount];
+		}
+		else
+		{
+			this->m_samples[-(int)guardSamples + (int)i] = 0.0f;
+			this->m_samples[sampleCount + i] = 0.0f;
+		}
+	}
+}
\ No newline at end of file
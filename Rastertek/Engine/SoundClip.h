@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SoundClip.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SOUNDCLIP_H_
+#define _SOUNDCLIP_H_
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "WaveFile.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned int SOUND_CLIP_GUARD_FRAMES = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SoundClip
+////////////////////////////////////////////////////////////////////////////////
+
+//Samples of a sound as floats, shared by every voice that plays it
+//Guard frames before and after the samples let the mixer interpolate and delay across the ends without checking
+class SoundClip
+{
+private:
+	float* m_buffer;
+	float* m_samples;
+	unsigned int m_frameCount;
+	unsigned short m_channels;
+	unsigned int m_sampleRate;
+	bool m_loop;
+
+public:
+	SoundClip();
+	SoundClip(const SoundClip& other);
+	~SoundClip();
+
+	bool Initialize(WaveFile* file, bool loop);
+	bool Initialize(const float* samples, unsigned int frameCount, unsigned short channels, unsigned int sampleRate, bool loop);
+	void Shutdown();
+
+	const float* GetSamples();
+	unsigned int GetFrameCount();
+	unsigned short GetChannels();
+	unsigned int GetSampleRate();
+	bool IsLooping();
+	size_t GetMemorySize();
+
+private:
+	bool Allocate(unsigned int frameCount, unsigned short channels, unsigned int sampleRate, bool loop);
+	void FillGuards();
+};
+
+#endif
\ No newline at end of file
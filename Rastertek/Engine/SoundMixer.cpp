@@ -0,0 +1,1223 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SoundMixer.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "SoundMixer.h"
+
+
+SoundMixer::SoundMixer()
+{
+	this->m_Sink = nullptr;
+	this->m_sampleRate = 0;
+	this->m_segmentSize = 0;
+	this->m_segmentCount = 0;
+	this->m_commands = nullptr;
+	this->m_commandRead = 0;
+	this->m_commandWrite = 0;
+	this->m_events = nullptr;
+	this->m_eventRead = 0;
+	this->m_eventWrite = 0;
+	this->m_Slots = nullptr;
+	this->m_busyCount = 0;
+	memset(this->m_listenerPosition, 0, sizeof(this->m_listenerPosition));
+	this->m_voices = nullptr;
+	this->m_realVoiceLimit = SOUND_MIXER_REAL_VOICES;
+	this->m_ranks = nullptr;
+	this->m_blockMemory = nullptr;
+	this->m_Block = nullptr;
+	this->m_activeCount = 0;
+	this->m_realCount = 0;
+	this->m_writtenBytes = 0;
+	this->m_playedBytes = 0;
+	this->m_lastPosition = 0;
+	this->m_underrunCount = 0;
+	this->m_running = false;
+}
+
+SoundMixer::SoundMixer(const SoundMixer& other)
+{
+}
+
+
+SoundMixer::~SoundMixer()
+{
+}
+
+unsigned int SoundMixer::GetBufferSize(unsigned int sampleRate, unsigned int segmentMilliseconds, unsigned int segmentCount)
+{
+	unsigned int segmentFrames;
+
+	//The output is always 16 bit stereo, four bytes a frame
+	segmentFrames = sampleRate * segmentMilliseconds / 1000;
+	if (segmentFrames == 0)
+	{
+		segmentFrames = 1;
+	}
+
+	return segmentFrames * 4 * segmentCount;
+}
+
+bool SoundMixer::Initialize(SoundSink* sink, unsigned int sampleRate, unsigned int segmentCount, bool threaded)
+{
+	bool result;
+	int i;
+	unsigned int j;
+
+	if (sampleRate == 0)
+	{
+		return false;
+	}
+	this->m_sampleRate = sampleRate;
+
+	//Create the two rings between the game thread and the mixer
+	this->m_commands = new CommandType[SOUND_MIXER_COMMAND_COUNT];
+	if (!this->m_commands)
+	{
+		return false;
+	}
+
+	this->m_events = new int[SOUND_MIXER_MAX_VOICES];
+	if (!this->m_events)
+	{
+		return false;
+	}
+
+	//The game thread hands out voice numbers and only takes them back once the mixer says they finished
+	this->m_Slots = new SlotType[SOUND_MIXER_MAX_VOICES];
+	if (!this->m_Slots)
+	{
+		return false;
+	}
+
+	//Every voice is allocated up front, playing a sound only fills one in
+	this->m_voices = new VoiceType[SOUND_MIXER_MAX_VOICES];
+	if (!this->m_voices)
+	{
+		return false;
+	}
+
+	this->m_ranks = new RankType[SOUND_MIXER_MAX_VOICES];
+	if (!this->m_ranks)
+	{
+		return false;
+	}
+
+	this->m_freeVoices.clear();
+	for (i = SOUND_MIXER_MAX_VOICES - 1; i >= 0; i--)
+	{
+		this->m_freeVoices.push_back(i);
+		this->m_Slots[i].busy = false;
+		this->m_Slots[i].generation = 0;
+		this->m_Slots[i].stolen = 0;
+		this->m_voices[i].active = false;
+		this->m_voices[i].audible = false;
+	}
+	this->m_busyCount = 0;
+	this->m_realVoiceLimit = SOUND_MIXER_REAL_VOICES;
+	memset(this->m_listenerPosition, 0, sizeof(this->m_listenerPosition));
+
+	//Start with the listener at the origin looking down z, the way the camera starts
+	memset(this->m_listener, 0, sizeof(this->m_listener));
+	this->m_listener[5] = 1.0f;
+	this->m_listener[6] = 1.0f;
+
+	this->m_blockMemory = new unsigned char[sizeof(BlockType) + 15];
+	if (!this->m_blockMemory)
+	{
+		return false;
+	}
+	this->m_Block = (BlockType*)(((size_t)this->m_blockMemory + 15) & ~(size_t)15);
+
+	//Without a sink the mixer only renders when Mix is called
+	this->m_Sink = sink;
+	if (!sink)
+	{
+		return true;
+	}
+
+	if (segmentCount < 2 || sink->GetBufferSize() % segmentCount != 0 || (sink->GetBufferSize() / segmentCount) % 4 != 0)
+	{
+		return false;
+	}
+	this->m_segmentSize = sink->GetBufferSize() / segmentCount;
+	this->m_segmentCount = segmentCount;
+	this->m_output.resize(this->m_segmentSize / 2);
+
+	//Fill the ring with silence before the cursor starts moving
+	this->m_writtenBytes = 0;
+	this->m_playedBytes = 0;
+	this->m_lastPosition = 0;
+	for (j = 0; j < segmentCount; j++)
+	{
+		result = SoundMixer::FillSegment();
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	result = sink->Start();
+	if (!result)
+	{
+		return false;
+	}
+
+	if (threaded)
+	{
+		this->m_running = true;
+		this->m_thread = thread(&SoundMixer::MixerThread, this);
+	}
+
+	return true;
+}
+
+void SoundMixer::Shutdown()
+{
+	//Stop the mixer thread
+	if (this->m_thread.joinable())
+	{
+		this->m_running = false;
+		this->m_thread.join();
+	}
+
+	//Stop the sink, it belongs to the caller
+	if (this->m_Sink)
+	{
+		this->m_Sink->Stop();
+		this->m_Sink = nullptr;
+	}
+
+	if (this->m_blockMemory)
+	{
+		delete[] this->m_blockMemory;
+		this->m_blockMemory = nullptr;
+		this->m_Block = nullptr;
+	}
+
+	if (this->m_ranks)
+	{
+		delete[] this->m_ranks;
+		this->m_ranks = nullptr;
+	}
+
+	if (this->m_voices)
+	{
+		delete[] this->m_voices;
+		this->m_voices = nullptr;
+	}
+
+	if (this->m_Slots)
+	{
+		delete[] this->m_Slots;
+		this->m_Slots = nullptr;
+	}
+
+	if (this->m_events)
+	{
+		delete[] this->m_events;
+		this->m_events = nullptr;
+	}
+
+	if (this->m_commands)
+	{
+		delete[] this->m_commands;
+		this->m_commands = nullptr;
+	}
+
+	this->m_freeVoices.clear();
+	this->m_output.clear();
+}
+
+int SoundMixer::PlayVoice(SoundClip* clip, const VoiceDescType& desc)
+{
+	CommandType command;
+	SlotType* slot;
+	int voice;
+
+	//Spatial voices are placed by the mixer, so they have to be mono like the 3D buffers of Direct Sound
+	if (!clip || (desc.spatial && clip->GetChannels() != 1))
+	{
+		return -1;
+	}
+
+	//With every voice in use the new one takes over the least important one, as long as that one is no more important than it
+	if (this->m_freeVoices.empty())
+	{
+		voice = SoundMixer::FindVictim(desc.priority);
+		if (voice < 0)
+		{
+			return -1;
+		}
+
+		command.kind = COMMAND_STOP;
+		command.voice = voice;
+		if (!SoundMixer::PostCommand(command))
+		{
+			return -1;
+		}
+
+		//The mixer still sends back one finish for the voice that was stolen, it must not free the number again
+		this->m_Slots[voice].busy = false;
+		this->m_Slots[voice].stolen++;
+		this->m_busyCount--;
+		this->m_freeVoices.push_back(voice);
+	}
+
+	voice = this->m_freeVoices.back();
+
+	command.kind = COMMAND_PLAY;
+	command.voice = voice;
+	command.clip = clip;
+	command.spatial = desc.spatial;
+	command.number = desc.priority;
+	command.values[0] = desc.volume;
+	command.values[1] = desc.pitch;
+	command.values[2] = desc.position[0];
+	command.values[3] = desc.position[1];
+	command.values[4] = desc.position[2];
+	if (!SoundMixer::PostCommand(command))
+	{
+		return -1;
+	}
+
+	this->m_freeVoices.pop_back();
+	this->m_busyCount++;
+
+	//The handle carries how many times the number was handed out, so an old handle cannot touch the voice that replaced it
+	slot = &this->m_Slots[voice];
+	slot->busy = true;
+	slot->generation = (slot->generation + 1) % (0x7FFFFFFF / SOUND_MIXER_MAX_VOICES);
+	slot->priority = desc.priority;
+	slot->spatial = desc.spatial;
+	memcpy(slot->position, desc.position, sizeof(float) * 3);
+
+	return slot->generation * SOUND_MIXER_MAX_VOICES + voice;
+}
+
+bool SoundMixer::StopVoice(int voice)
+{
+	CommandType command;
+
+	command.voice = SoundMixer::GetSlot(voice);
+	if (command.voice < 0)
+	{
+		return false;
+	}
+
+	command.kind = COMMAND_STOP;
+
+	return SoundMixer::PostCommand(command);
+}
+
+bool SoundMixer::SetVoicePosition(int voice, float x, float y, float z)
+{
+	CommandType command;
+
+	command.voice = SoundMixer::GetSlot(voice);
+	if (command.voice < 0)
+	{
+		return false;
+	}
+
+	command.kind = COMMAND_POSITION;
+	command.values[0] = x;
+	command.values[1] = y;
+	command.values[2] = z;
+	memcpy(this->m_Slots[command.voice].position, command.values, sizeof(float) * 3);
+
+	return SoundMixer::PostCommand(command);
+}
+
+bool SoundMixer::SetVoiceVolume(int voice, float volume)
+{
+	CommandType command;
+
+	command.voice = SoundMixer::GetSlot(voice);
+	if (command.voice < 0)
+	{
+		return false;
+	}
+
+	command.kind = COMMAND_VOLUME;
+	command.values[0] = volume;
+
+	return SoundMixer::PostCommand(command);
+}
+
+bool SoundMixer::SetVoicePitch(int voice, float pitch)
+{
+	CommandType command;
+
+	command.voice = SoundMixer::GetSlot(voice);
+	if (command.voice < 0)
+	{
+		return false;
+	}
+
+	command.kind = COMMAND_PITCH;
+	command.values[0] = pitch;
+
+	return SoundMixer::PostCommand(command);
+}
+
+bool SoundMixer::SetListener(const float* position, const float* forward, const float* right)
+{
+	CommandType command;
+
+	command.kind = COMMAND_LISTENER;
+	command.voice = -1;
+	memcpy(command.values, position, sizeof(float) * 3);
+	memcpy(command.values + 3, forward, sizeof(float) * 3);
+	memcpy(command.values + 6, right, sizeof(float) * 3);
+	memcpy(this->m_listenerPosition, position, sizeof(float) * 3);
+
+	return SoundMixer::PostCommand(command);
+}
+
+bool SoundMixer::SetRealVoiceLimit(int count)
+{
+	CommandType command;
+
+	if (count < 0)
+	{
+		return false;
+	}
+
+	command.kind = COMMAND_REAL_VOICES;
+	command.voice = -1;
+	command.number = count;
+
+	return SoundMixer::PostCommand(command);
+}
+
+void SoundMixer::Update()
+{
+	PROFILE_SCOPE("SoundMixer::Update");
+
+	unsigned int read;
+	unsigned int write;
+	int voice;
+
+	//Take back the voices the mixer has finished with
+	read = this->m_eventRead.load(memory_order_relaxed);
+	write = this->m_eventWrite.load(memory_order_acquire);
+	while (read != write)
+	{
+		voice = this->m_events[read % SOUND_MIXER_MAX_VOICES];
+		read++;
+
+		//A stolen voice was already handed back when it was stolen
+		if (this->m_Slots[voice].stolen > 0)
+		{
+			this->m_Slots[voice].stolen--;
+			continue;
+		}
+
+		this->m_Slots[voice].busy = false;
+		this->m_busyCount--;
+		this->m_freeVoices.push_back(voice);
+	}
+	this->m_eventRead.store(read, memory_order_release);
+}
+
+bool SoundMixer::IsVoicePlaying(int voice)
+{
+	return SoundMixer::GetSlot(voice) >= 0;
+}
+
+int SoundMixer::GetVoiceCount()
+{
+	return this->m_busyCount;
+}
+
+bool SoundMixer::Service()
+{
+	bool result;
+	unsigned int position;
+	unsigned int bufferSize;
+
+	if (!this->m_Sink)
+	{
+		return false;
+	}
+
+	result = this->m_Sink->GetPlayPosition(position);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Add up how far the cursor moved since the last look, it only moves forward around the ring
+	bufferSize = this->m_Sink->GetBufferSize();
+	this->m_playedBytes += (position + bufferSize - this->m_lastPosition) % bufferSize;
+	this->m_lastPosition = position;
+
+	//The cursor went past the last segment that was mixed, skip ahead to the segment after it
+	if (this->m_playedBytes > this->m_writtenBytes)
+	{
+		this->m_underrunCount++;
+		this->m_writtenBytes = this->m_playedBytes - this->m_playedBytes % this->m_segmentSize + this->m_segmentSize;
+	}
+
+	//Mix every segment the cursor has finished with
+	while (this->m_writtenBytes + this->m_segmentSize <= this->m_playedBytes - this->m_playedBytes % this->m_segmentSize + (unsigned long long)this->m_segmentSize * this->m_segmentCount)
+	{
+		result = SoundMixer::FillSegment();
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void SoundMixer::Mix(float* output, unsigned int frameCount)
+{
+	PROFILE_SCOPE("SoundMixer::Mix");
+
+	unsigned int done;
+	unsigned int count;
+	int i;
+	int activeCount;
+	int realCount;
+
+	//Pick up everything the game thread posted since the last mix
+	SoundMixer::RunCommands();
+
+	//Mix a block at a time so the work arrays stay in the cache
+	for (done = 0; done < frameCount; done += count)
+	{
+		count = frameCount - done;
+		if (count > SOUND_MIXER_BLOCK_FRAMES)
+		{
+			count = SOUND_MIXER_BLOCK_FRAMES;
+		}
+
+		SoundMixer::MixBlock(output + done * 2, count);
+	}
+
+	activeCount = 0;
+	realCount = 0;
+	for (i = 0; i < SOUND_MIXER_MAX_VOICES; i++)
+	{
+		if (this->m_voices[i].active)
+		{
+			activeCount++;
+			if (this->m_voices[i].audible)
+			{
+				realCount++;
+			}
+		}
+	}
+	this->m_activeCount.store(activeCount, memory_order_relaxed);
+	this->m_realCount.store(realCount, memory_order_relaxed);
+}
+
+int SoundMixer::GetActiveVoiceCount()
+{
+	return this->m_activeCount.load(memory_order_relaxed);
+}
+
+int SoundMixer::GetRealVoiceCount()
+{
+	return this->m_realCount.load(memory_order_relaxed);
+}
+
+int SoundMixer::GetUnderrunCount()
+{
+	return this->m_underrunCount.load(memory_order_relaxed);
+}
+
+int SoundMixer::GetSlot(int voice)
+{
+	int slot;
+
+	//Handles from a play that has since finished or been stolen no longer match the number's generation
+	if (voice < 0)
+	{
+		return -1;
+	}
+
+	slot = voice % SOUND_MIXER_MAX_VOICES;
+	if (!this->m_Slots[slot].busy || this->m_Slots[slot].generation != voice / SOUND_MIXER_MAX_VOICES)
+	{
+		return -1;
+	}
+
+	return slot;
+}
+
+int SoundMixer::FindVictim(int priority)
+{
+	SlotType* slot;
+	float offset[3];
+	float distance;
+	float victimDistance;
+	int victim;
+	int i;
+
+	//The lowest priority goes first, and among those the one furthest from the listener, voices that are not placed count as close
+	victim = -1;
+	victimDistance = 0.0f;
+	for (i = 0; i < SOUND_MIXER_MAX_VOICES; i++)
+	{
+		slot = &this->m_Slots[i];
+		if (!slot->busy || slot->priority > priority)
+		{
+			continue;
+		}
+
+		distance = 0.0f;
+		if (slot->spatial)
+		{
+			offset[0] = slot->position[0] - this->m_listenerPosition[0];
+			offset[1] = slot->position[1] - this->m_listenerPosition[1];
+			offset[2] = slot->position[2] - this->m_listenerPosition[2];
+			distance = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+		}
+
+		if (victim < 0 || slot->priority < this->m_Slots[victim].priority || (slot->priority == this->m_Slots[victim].priority && distance > victimDistance))
+		{
+			victim = i;
+			victimDistance = distance;
+		}
+	}
+
+	return victim;
+}
+
+bool SoundMixer::PostCommand(const CommandType& command)
+{
+	unsigned int read;
+	unsigned int write;
+
+	//Single producer, the slot is written before the mixer is allowed to see it
+	write = this->m_commandWrite.load(memory_order_relaxed);
+	read = this->m_commandRead.load(memory_order_acquire);
+	if (write - read >= SOUND_MIXER_COMMAND_COUNT)
+	{
+		return false;
+	}
+
+	this->m_commands[write % SOUND_MIXER_COMMAND_COUNT] = command;
+	this->m_commandWrite.store(write + 1, memory_order_release);
+
+	return true;
+}
+
+void SoundMixer::RunCommands()
+{
+	unsigned int read;
+	unsigned int write;
+	CommandType* command;
+	VoiceType* voice;
+
+	read = this->m_commandRead.load(memory_order_relaxed);
+	write = this->m_commandWrite.load(memory_order_acquire);
+	while (read != write)
+	{
+		command = &this->m_commands[read % SOUND_MIXER_COMMAND_COUNT];
+		voice = command->voice >= 0 ? &this->m_voices[command->voice] : nullptr;
+
+		//Commands for a voice that already finished are dropped, its number is not handed out again until the game thread sees it finish
+		switch (command->kind)
+		{
+		case COMMAND_PLAY:
+			voice->active = true;
+			voice->real = false;
+			voice->audible = false;
+			voice->clip = command->clip;
+			voice->spatial = command->spatial;
+			voice->priority = command->number;
+			voice->volume = command->values[0];
+			voice->pitch = command->values[1];
+			memcpy(voice->position, command->values + 2, sizeof(float) * 3);
+			voice->cursor = 0.0;
+			voice->started = false;
+			voice->filter[0] = 0.0f;
+			voice->filter[1] = 0.0f;
+			break;
+		case COMMAND_STOP:
+			if (voice->active)
+			{
+				SoundMixer::FinishVoice(command->voice);
+			}
+			break;
+		case COMMAND_POSITION:
+			memcpy(voice->position, command->values, sizeof(float) * 3);
+			break;
+		case COMMAND_VOLUME:
+			voice->volume = command->values[0];
+			break;
+		case COMMAND_PITCH:
+			voice->pitch = command->values[0];
+			break;
+		case COMMAND_LISTENER:
+			memcpy(this->m_listener, command->values, sizeof(this->m_listener));
+			break;
+		case COMMAND_REAL_VOICES:
+			this->m_realVoiceLimit = command->number;
+			break;
+		}
+
+		read++;
+	}
+	this->m_commandRead.store(read, memory_order_release);
+}
+
+void SoundMixer::FinishVoice(int voice)
+{
+	unsigned int write;
+
+	//Each voice finishes once per play, so the ring never holds more events than there are voices
+	this->m_voices[voice].active = false;
+	this->m_voices[voice].audible = false;
+
+	write = this->m_eventWrite.load(memory_order_relaxed);
+	this->m_events[write % SOUND_MIXER_MAX_VOICES] = voice;
+	this->m_eventWrite.store(write + 1, memory_order_release);
+}
+
+void SoundMixer::MixBlock(float* output, unsigned int frameCount)
+{
+	bool result;
+	int i;
+
+	memset(output, 0, frameCount * 2 * sizeof(float));
+
+	//Decide which voices are heard in this block
+	SoundMixer::RankVoices();
+
+	//A voice that was heard in the last block is mixed once more to fade it out, other virtual voices only move their cursor
+	for (i = 0; i < SOUND_MIXER_MAX_VOICES; i++)
+	{
+		if (this->m_voices[i].active)
+		{
+			if (this->m_voices[i].real || this->m_voices[i].audible)
+			{
+				result = SoundMixer::MixVoice(this->m_voices[i], output, frameCount);
+			}
+			else
+			{
+				result = SoundMixer::SkipVoice(this->m_voices[i], frameCount);
+			}
+			if (!result)
+			{
+				SoundMixer::FinishVoice(i);
+			}
+		}
+	}
+}
+
+void SoundMixer::RankVoices()
+{
+	VoiceType* voice;
+	float level;
+	int count;
+	int i;
+
+	//Voices too quiet to hear are virtual whatever the limit is
+	count = 0;
+	for (i = 0; i < SOUND_MIXER_MAX_VOICES; i++)
+	{
+		voice = &this->m_voices[i];
+		if (!voice->active)
+		{
+			continue;
+		}
+		voice->real = false;
+
+		//A voice being heard holds its place against one about as loud, so the two do not keep swapping
+		level = voice->volume * SoundMixer::GetAttenuation(*voice);
+		if (voice->audible)
+		{
+			level *= 1.25f;
+		}
+		if (level > SOUND_MIXER_VIRTUAL_LEVEL)
+		{
+			this->m_ranks[count].priority = voice->priority;
+			this->m_ranks[count].level = level;
+			this->m_ranks[count].voice = i;
+			count++;
+		}
+	}
+
+	//Keep the most important voices when there are more than can be mixed, the order among the kept ones does not matter
+	if (count > this->m_realVoiceLimit)
+	{
+		nth_element(this->m_ranks, this->m_ranks + this->m_realVoiceLimit, this->m_ranks + count, SoundMixer::CompareRanks);
+		count = this->m_realVoiceLimit;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		this->m_voices[this->m_ranks[i].voice].real = true;
+	}
+}
+
+bool SoundMixer::CompareRanks(const RankType& first, const RankType& second)
+{
+	//Higher priority first, then louder
+	if (first.priority != second.priority)
+	{
+		return first.priority > second.priority;
+	}
+
+	return first.level > second.level;
+}
+
+bool SoundMixer::MixVoice(VoiceType& voice, float* output, unsigned int frameCount)
+{
+	float gain[2];
+	float delay[2];
+	float shadow[2];
+	float gainStart[2];
+	float gainEnd[2];
+	float delayStart[2];
+	float delayEnd[2];
+	float step;
+	float start;
+	float end;
+	double clipFrames;
+	unsigned int done;
+	unsigned int count;
+	int channel;
+	int channels;
+
+	//Work out where the voice should be heard by the end of the block, the block ramps to it from where the last one ended
+	//A voice that lost its place fades out over the block
+	SoundMixer::Spatialize(voice, gain, delay, shadow);
+	if (!voice.real)
+	{
+		gain[0] = 0.0f;
+		gain[1] = 0.0f;
+	}
+	if (!voice.started)
+	{
+		memcpy(voice.gain, gain, sizeof(gain));
+		memcpy(voice.delay, delay, sizeof(delay));
+		voice.started = true;
+	}
+	voice.audible = voice.real;
+
+	step = SoundMixer::GetStep(voice);
+	if (step <= 0.0f)
+	{
+		memcpy(voice.gain, gain, sizeof(gain));
+		memcpy(voice.delay, delay, sizeof(delay));
+		return true;
+	}
+
+	clipFrames = (double)voice.clip->GetFrameCount();
+	channels = voice.clip->GetChannels();
+
+	for (done = 0; done < frameCount; done += count)
+	{
+		//Stop at the end of the clip so a loop can start again from the front
+		count = frameCount - done;
+		if ((clipFrames - voice.cursor) / step < (double)count)
+		{
+			count = (unsigned int)ceil((clipFrames - voice.cursor) / step);
+		}
+
+		start = (float)done / (float)frameCount;
+		end = (float)(done + count) / (float)frameCount;
+		for (channel = 0; channel < 2; channel++)
+		{
+			gainStart[channel] = voice.gain[channel] + (gain[channel] - voice.gain[channel]) * start;
+			gainEnd[channel] = voice.gain[channel] + (gain[channel] - voice.gain[channel]) * end;
+			delayStart[channel] = voice.delay[channel] + (delay[channel] - voice.delay[channel]) * start;
+			delayEnd[channel] = voice.delay[channel] + (delay[channel] - voice.delay[channel]) * end;
+		}
+
+		if (voice.spatial)
+		{
+			//Each ear hears the clip at its own delay, the ear facing away from the sound also loses the highs
+			for (channel = 0; channel < 2; channel++)
+			{
+				SoundMixer::Resample(voice.clip->GetSamples(), 1, 0, voice.cursor, step, delayStart[channel], delayEnd[channel], count, this->m_Block->channel[channel]);
+				SoundMixer::Shadow(this->m_Block->channel[channel], count, shadow[channel], voice.filter[channel]);
+			}
+			SoundMixer::Accumulate(output + done * 2, this->m_Block->channel[0], this->m_Block->channel[1], gainStart, gainEnd, count);
+		}
+		else if (channels == 1)
+		{
+			SoundMixer::Resample(voice.clip->GetSamples(), 1, 0, voice.cursor, step, 0.0f, 0.0f, count, this->m_Block->channel[0]);
+			SoundMixer::Accumulate(output + done * 2, this->m_Block->channel[0], this->m_Block->channel[0], gainStart, gainEnd, count);
+		}
+		else
+		{
+			SoundMixer::Resample(voice.clip->GetSamples(), 2, 0, voice.cursor, step, 0.0f, 0.0f, count, this->m_Block->channel[0]);
+			SoundMixer::Resample(voice.clip->GetSamples(), 2, 1, voice.cursor, step, 0.0f, 0.0f, count, this->m_Block->channel[1]);
+			SoundMixer::Accumulate(output + done * 2, this->m_Block->channel[0], this->m_Block->channel[1], gainStart, gainEnd, count);
+		}
+
+		voice.cursor += (double)count * step;
+		if (voice.cursor >= clipFrames)
+		{
+			if (!voice.clip->IsLooping())
+			{
+				return false;
+			}
+			voice.cursor = fmod(voice.cursor, clipFrames);
+		}
+	}
+
+	memcpy(voice.gain, gain, sizeof(gain));
+	memcpy(voice.delay, delay, sizeof(delay));
+
+	return true;
+}
+
+bool SoundMixer::SkipVoice(VoiceType& voice, unsigned int frameCount)
+{
+	float step;
+	double clipFrames;
+
+	//Nothing is heard, so when the voice comes back it fades in from silence
+	if (!voice.started)
+	{
+		voice.delay[0] = 0.0f;
+		voice.delay[1] = 0.0f;
+		voice.started = true;
+	}
+	voice.gain[0] = 0.0f;
+	voice.gain[1] = 0.0f;
+
+	step = SoundMixer::GetStep(voice);
+	if (step <= 0.0f)
+	{
+		return true;
+	}
+
+	//Move through the clip exactly as far as mixing would have
+	clipFrames = (double)voice.clip->GetFrameCount();
+	voice.cursor += (double)frameCount * step;
+	if (voice.cursor >= clipFrames)
+	{
+		if (!voice.clip->IsLooping())
+		{
+			return false;
+		}
+		voice.cursor = fmod(voice.cursor, clipFrames);
+	}
+
+	return true;
+}
+
+float SoundMixer::GetStep(VoiceType& voice)
+{
+	float step;
+
+	//The step through the clip covers both its rate and the pitch
+	step = voice.pitch * (float)voice.clip->GetSampleRate() / (float)this->m_sampleRate;
+	if (step > SOUND_MIXER_MAX_STEP)
+	{
+		step = SOUND_MIXER_MAX_STEP;
+	}
+
+	return step;
+}
+
+float SoundMixer::GetAttenuation(VoiceType& voice)
+{
+	float offset[3];
+	float distance;
+	float attenuation;
+
+	//Voices that are not placed in the world are not attenuated
+	if (!voice.spatial)
+	{
+		return 1.0f;
+	}
+
+	offset[0] = voice.position[0] - this->m_listener[0];
+	offset[1] = voice.position[1] - this->m_listener[1];
+	offset[2] = voice.position[2] - this->m_listener[2];
+	distance = sqrtf(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+
+	//Inverse distance falloff past the reference distance, faded out over the last tenth before the maximum distance
+	attenuation = 0.0f;
+	if (distance < SOUND_MIXER_MAX_DISTANCE)
+	{
+		attenuation = SOUND_MIXER_REFERENCE_DISTANCE / (SOUND_MIXER_REFERENCE_DISTANCE + SOUND_MIXER_ROLLOFF * ((distance > SOUND_MIXER_REFERENCE_DISTANCE ? distance : SOUND_MIXER_REFERENCE_DISTANCE) - SOUND_MIXER_REFERENCE_DISTANCE));
+		if (distance > SOUND_MIXER_MAX_DISTANCE * 0.9f)
+		{
+			attenuation *= (SOUND_MIXER_MAX_DISTANCE - distance) / (SOUND_MIXER_MAX_DISTANCE * 0.1f);
+		}
+	}
+
+	return attenuation;
+}
+
+void SoundMixer::Spatialize(VoiceType& voice, float* gain, float* delay, float* shadow)
+{
+	float offset[3];
+	float distance;
+	float attenuation;
+	float side;
+	float front;
+	float angle;
+	float rear;
+	float maxDelay;
+	int farEar;
+
+	//Voices that are not placed in the world play as they are
+	delay[0] = 0.0f;
+	delay[1] = 0.0f;
+	shadow[0] = 1.0f;
+	shadow[1] = 1.0f;
+	if (!voice.spatial)
+	{
+		gain[0] = voice.volume;
+		gain[1] = voice.volume;
+		return;
+	}
+
+	offset[0] = voice.position[0] - this->m_listener[0];
+	offset[1] = voice.position[1] - this->m_listener[1];
+	offset[2] = voice.position[2] - this->m_listener[2];
+	distance = sqrtf(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+	attenuation = SoundMixer::GetAttenuation(voice);
+
+	//Find how far to the side and to the front the sound is, a sound inside the head is centered
+	side = 0.0f;
+	front = 1.0f;
+	if (distance > 0.0001f)
+	{
+		side = (offset[0] * this->m_listener[6] + offset[1] * this->m_listener[7] + offset[2] * this->m_listener[8]) / distance;
+		front = (offset[0] * this->m_listener[3] + offset[1] * this->m_listener[4] + offset[2] * this->m_listener[5]) / distance;
+		side = side < -1.0f ? -1.0f : (side > 1.0f ? 1.0f : side);
+	}
+
+	//Constant power panning for the level difference between the ears, a head lets through about 14 dB at the side
+	angle = (side * 0.75f + 1.0f) * 0.785398163f;
+	gain[0] = cosf(angle) * voice.volume * attenuation;
+	gain[1] = sinf(angle) * voice.volume * attenuation;
+
+	//The far ear hears the sound later and duller, the delay is counted in clip frames and limited to the guard frames
+	farEar = side > 0.0f ? 0 : 1;
+	maxDelay = (float)(SOUND_CLIP_GUARD_FRAMES - 2);
+	delay[farEar] = SOUND_MIXER_HEAD_DELAY * fabsf(side) * (float)voice.clip->GetSampleRate() * voice.pitch;
+	delay[farEar] = delay[farEar] > maxDelay ? maxDelay : delay[farEar];
+	shadow[farEar] = 1.0f - 0.75f * fabsf(side);
+
+	//Sounds behind the listener are a little quieter and duller in both ears
+	if (front < 0.0f)
+	{
+		rear = 1.0f + 0.3f * front;
+		gain[0] *= rear;
+		gain[1] *= rear;
+		shadow[0] *= 1.0f + 0.4f * front;
+		shadow[1] *= 1.0f + 0.4f * front;
+	}
+}
+
+void SoundMixer::Resample(const float* samples, int channels, int channel, double cursor, float step, float delayStart, float delayEnd, unsigned int frameCount, float* destination)
+{
+	const float* source;
+	double base;
+	float origin;
+	float slope;
+	float position;
+	float fraction;
+	int index;
+	unsigned int i;
+	__m128 originVector;
+	__m128 slopeVector;
+	__m128 guardVector;
+	__m128 positionVector;
+	__m128 fractionVector;
+	__m128 first;
+	__m128 second;
+	__m128i indexVector;
+	int indices[4];
+
+	//Positions are kept relative to the whole frame the block starts on so floats hold them exactly enough
+	base = floor(cursor);
+	source = samples + (ptrdiff_t)base * channels + channel;
+	origin = (float)(cursor - base) - delayStart;
+
+	//A delay that changes over the block stretches the step, so the position is still a straight line
+	slope = step - (delayEnd - delayStart) / (float)frameCount;
+
+	originVector = _mm_set1_ps(origin);
+	slopeVector = _mm_set1_ps(slope);
+	guardVector = _mm_set1_ps((float)SOUND_CLIP_GUARD_FRAMES);
+
+	//Four frames at a time, the samples are gathered one by one and interpolated together
+	for (i = 0; i + 4 <= frameCount; i += 4)
+	{
+		positionVector = _mm_add_ps(originVector, _mm_mul_ps(_mm_setr_ps((float)i, (float)(i + 1), (float)(i + 2), (float)(i + 3)), slopeVector));
+
+		//Truncating a position shifted past the front guard is the same as rounding it down
+		indexVector = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(positionVector, guardVector)), _mm_set1_epi32(SOUND_CLIP_GUARD_FRAMES));
+		fractionVector = _mm_sub_ps(positionVector, _mm_cvtepi32_ps(indexVector));
+		_mm_storeu_si128((__m128i*)indices, indexVector);
+
+		first = _mm_setr_ps(source[indices[0] * channels], source[indices[1] * channels], source[indices[2] * channels], source[indices[3] * channels]);
+		second = _mm_setr_ps(source[(indices[0] + 1) * channels], source[(indices[1] + 1) * channels], source[(indices[2] + 1) * channels], source[(indices[3] + 1) * channels]);
+
+		_mm_storeu_ps(destination + i, _mm_add_ps(first, _mm_mul_ps(_mm_sub_ps(second, first), fractionVector)));
+	}
+
+	//Finish the remainder one at a time
+	for (; i < frameCount; i++)
+	{
+		position = origin + (float)i * slope;
+		index = (int)(position + (float)SOUND_CLIP_GUARD_FRAMES) - (int)SOUND_CLIP_GUARD_FRAMES;
+		fraction = position - (float)index;
+		destination[i] = source[index * channels] + (source[(index + 1) * channels] - source[index * channels]) * fraction;
+	}
+}
+
+void SoundMixer::Shadow(float* samples, unsigned int frameCount, float coefficient, float& state)
+{
+	unsigned int i;
+	float value;
+	float keep;
+	__m128 coefficientVector;
+	__m128 keepVector;
+	__m128 keepSquaredVector;
+	__m128 keepPowers;
+	__m128 previous;
+	__m128 sum;
+
+	//A one pole low pass, a coefficient of one lets everything through
+	if (coefficient >= 1.0f)
+	{
+		if (frameCount > 0)
+		{
+			state = samples[frameCount - 1];
+		}
+		return;
+	}
+
+	//Each output is the input scaled by the coefficient plus the last output scaled by what is kept of it
+	//Four outputs are solved at a time as a scan of the scaled inputs, with the last output of the previous four decayed into all of them
+	keep = 1.0f - coefficient;
+	coefficientVector = _mm_set1_ps(coefficient);
+	keepVector = _mm_set1_ps(keep);
+	keepSquaredVector = _mm_set1_ps(keep * keep);
+	keepPowers = _mm_setr_ps(keep, keep * keep, keep * keep * keep, keep * keep * keep * keep);
+	previous = _mm_set1_ps(state);
+	for (i = 0; i + 4 <= frameCount; i += 4)
+	{
+		sum = _mm_mul_ps(_mm_loadu_ps(samples + i), coefficientVector);
+		sum = _mm_add_ps(sum, _mm_mul_ps(keepVector, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 4))));
+		sum = _mm_add_ps(sum, _mm_mul_ps(keepSquaredVector, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(sum), 8))));
+		sum = _mm_add_ps(sum, _mm_mul_ps(keepPowers, previous));
+		_mm_storeu_ps(samples + i, sum);
+
+		previous = _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(3, 3, 3, 3));
+	}
+	value = _mm_cvtss_f32(previous);
+
+	//Finish the remainder one at a time
+	for (; i < frameCount; i++)
+	{
+		value += (samples[i] - value) * coefficient;
+		samples[i] = value;
+	}
+	state = value;
+}
+
+void SoundMixer::Accumulate(float* output, const float* left, const float* right, const float* gainStart, const float* gainEnd, unsigned int frameCount)
+{
+	float leftGain;
+	float rightGain;
+	float leftRamp;
+	float rightRamp;
+	unsigned int i;
+	__m128 frameVector;
+	__m128 leftVector;
+	__m128 rightVector;
+
+	//Ramp the gains across the span so a moving voice does not click
+	leftRamp = (gainEnd[0] - gainStart[0]) / (float)frameCount;
+	rightRamp = (gainEnd[1] - gainStart[1]) / (float)frameCount;
+
+	//Four frames at a time, the two channels are interleaved back into left right pairs
+	for (i = 0; i + 4 <= frameCount; i += 4)
+	{
+		frameVector = _mm_setr_ps((float)i, (float)(i + 1), (float)(i + 2), (float)(i + 3));
+		leftVector = _mm_mul_ps(_mm_loadu_ps(left + i), _mm_add_ps(_mm_set1_ps(gainStart[0]), _mm_mul_ps(frameVector, _mm_set1_ps(leftRamp))));
+		rightVector = _mm_mul_ps(_mm_loadu_ps(right + i), _mm_add_ps(_mm_set1_ps(gainStart[1]), _mm_mul_ps(frameVector, _mm_set1_ps(rightRamp))));
+
+		_mm_storeu_ps(output + i * 2, _mm_add_ps(_mm_loadu_ps(output + i * 2), _mm_unpacklo_ps(leftVector, rightVector)));
+		_mm_storeu_ps(output + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(output + i * 2 + 4), _mm_unpackhi_ps(leftVector, rightVector)));
+	}
+
+	//Finish the remainder one at a time
+	for (; i < frameCount; i++)
+	{
+		leftGain = gainStart[0] + leftRamp * (float)i;
+		rightGain = gainStart[1] + rightRamp * (float)i;
+		output[i * 2] += left[i] * leftGain;
+		output[i * 2 + 1] += right[i] * rightGain;
+	}
+}
+
+bool SoundMixer::FillSegment()
+{
+	bool result;
+	void* data;
+	short* samples;
+	unsigned int offset;
+	unsigned int sampleCount;
+	unsigned int i;
+	float value;
+	__m128 scale;
+
+	//Segments are mixed in order around the ring
+	offset = (unsigned int)(this->m_writtenBytes % this->m_Sink->GetBufferSize());
+	sampleCount = this->m_segmentSize / 2;
+
+	SoundMixer::Mix(&this->m_output[0], sampleCount / 2);
+
+	result = this->m_Sink->Lock(offset, this->m_segmentSize, data);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Convert to 16 bit eight samples at a time, the pack saturates anything that clipped
+	samples = (short*)data;
+	scale = _mm_set1_ps(32767.0f);
+	for (i = 0; i + 8 <= sampleCount; i += 8)
+	{
+		_mm_storeu_si128((__m128i*)(samples + i), _mm_packs_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(&this->m_output[i]), scale)), _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(&this->m_output[i + 4]), scale))));
+	}
+	for (; i < sampleCount; i++)
+	{
+		value = this->m_output[i] * 32767.0f;
+		value = value > 32767.0f ? 32767.0f : (value < -32768.0f ? -32768.0f : value);
+		samples[i] = (short)value;
+	}
+
+	this->m_Sink->Unlock(data, this->m_segmentSize);
+
+	this->m_writtenBytes += this->m_segmentSize;
+
+	return true;
+}
+
+void SoundMixer::MixerThread()
+{
+	chrono::microseconds interval;
+
+	//Show the thread by name in the profiler
+	if (ProfilerHandle)
+	{
+		ProfilerHandle->SetThreadName("Sound Mixer");
+	}
+
+	//Wake up a few times per segment so a segment is mixed well before the cursor comes back to it
+	interval = chrono::microseconds((unsigned long long)this->m_segmentSize / 4 * 1000000 / this->m_sampleRate / 4);
+
+	while (this->m_running.load())
+	{
+		SoundMixer::Service();
+		this_thread::sleep_for(interval);
+	}
+}
\ No newline at end of file
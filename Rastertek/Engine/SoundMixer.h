@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SoundMixer.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SOUNDMIXER_H_
+#define _SOUNDMIXER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "SoundClip.h"
+#include "SoundSink.h"
+#include "Profiler.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int SOUND_MIXER_MAX_VOICES = 1024;
+const int SOUND_MIXER_REAL_VOICES = 64;
+const float SOUND_MIXER_VIRTUAL_LEVEL = 0.0005f;
+const unsigned int SOUND_MIXER_COMMAND_COUNT = 4096;
+const unsigned int SOUND_MIXER_BLOCK_FRAMES = 256;
+const unsigned int SOUND_MIXER_SEGMENT_MILLISECONDS = 20;
+const unsigned int SOUND_MIXER_SEGMENT_COUNT = 4;
+const float SOUND_MIXER_MAX_STEP = 8.0f;
+const float SOUND_MIXER_REFERENCE_DISTANCE = 1.0f;
+const float SOUND_MIXER_MAX_DISTANCE = 100.0f;
+const float SOUND_MIXER_ROLLOFF = 1.0f;
+const float SOUND_MIXER_HEAD_DELAY = 0.00066f;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SoundMixer
+////////////////////////////////////////////////////////////////////////////////
+
+//Mixes any number of voices into one 16 bit stereo sink
+//The game thread only posts commands into a ring and the mixer thread only posts finished voices back, neither side takes a lock
+//Only the loudest voices of the highest priority are mixed, the rest are virtual and only keep their place in the clip
+class SoundMixer
+{
+public:
+	struct VoiceDescType
+	{
+		float volume;
+		float pitch;
+		int priority;
+		bool spatial;
+		float position[3];
+	};
+
+private:
+	enum CommandKind
+	{
+		COMMAND_PLAY,
+		COMMAND_STOP,
+		COMMAND_POSITION,
+		COMMAND_VOLUME,
+		COMMAND_PITCH,
+		COMMAND_LISTENER,
+		COMMAND_REAL_VOICES
+	};
+
+	struct CommandType
+	{
+		CommandKind kind;
+		int voice;
+		SoundClip* clip;
+		bool spatial;
+		int number;
+		float values[9];
+	};
+
+	//What the game thread knows about each voice number, enough to hand out handles and pick a voice to steal
+	struct SlotType
+	{
+		bool busy;
+		int generation;
+		int stolen;
+		int priority;
+		bool spatial;
+		float position[3];
+	};
+
+	struct VoiceType
+	{
+		bool active;
+		bool real;
+		bool audible;
+		SoundClip* clip;
+		bool spatial;
+		int priority;
+		float volume;
+		float pitch;
+		float position[3];
+		double cursor;
+		bool started;
+		float gain[2];
+		float delay[2];
+		float shadow[2];
+		float filter[2];
+	};
+
+	//Work arrays for one block, aligned so the kernels can use aligned loads
+	struct BlockType
+	{
+		float channel[2][SOUND_MIXER_BLOCK_FRAMES + 4];
+		float mix[SOUND_MIXER_BLOCK_FRAMES * 2 + 4];
+	};
+
+	struct RankType
+	{
+		int priority;
+		float level;
+		int voice;
+	};
+
+	SoundSink* m_Sink;
+	unsigned int m_sampleRate;
+	unsigned int m_segmentSize;
+	unsigned int m_segmentCount;
+
+	CommandType* m_commands;
+	atomic<unsigned int> m_commandRead;
+	atomic<unsigned int> m_commandWrite;
+	int* m_events;
+	atomic<unsigned int> m_eventRead;
+	atomic<unsigned int> m_eventWrite;
+
+	vector<int> m_freeVoices;
+	SlotType* m_Slots;
+	int m_busyCount;
+	float m_listenerPosition[3];
+
+	VoiceType* m_voices;
+	float m_listener[9];
+	int m_realVoiceLimit;
+	RankType* m_ranks;
+	unsigned char* m_blockMemory;
+	BlockType* m_Block;
+	vector<float> m_output;
+	atomic<int> m_activeCount;
+	atomic<int> m_realCount;
+
+	unsigned long long m_writtenBytes;
+	unsigned long long m_playedBytes;
+	unsigned int m_lastPosition;
+	atomic<int> m_underrunCount;
+
+	thread m_thread;
+	atomic<bool> m_running;
+
+public:
+	SoundMixer();
+	SoundMixer(const SoundMixer& other);
+	~SoundMixer();
+
+	static unsigned int GetBufferSize(unsigned int sampleRate, unsigned int segmentMilliseconds, unsigned int segmentCount);
+
+	bool Initialize(SoundSink* sink, unsigned int sampleRate, unsigned int segmentCount, bool threaded);
+	void Shutdown();
+
+	//Called from the game thread
+	int PlayVoice(SoundClip* clip, const VoiceDescType& desc);
+	bool StopVoice(int voice);
+	bool SetVoicePosition(int voice, float x, float y, float z);
+	bool SetVoiceVolume(int voice, float volume);
+	bool SetVoicePitch(int voice, float pitch);
+	bool SetListener(const float* position, const float* forward, const float* right);
+	bool SetRealVoiceLimit(int count);
+	void Update();
+	bool IsVoicePlaying(int voice);
+	int GetVoiceCount();
+
+	//Called from the mixer thread, or from the game thread when the mixer is not threaded
+	bool Service();
+	void Mix(float* output, unsigned int frameCount);
+
+	int GetActiveVoiceCount();
+	int GetRealVoiceCount();
+	int GetUnderrunCount();
+
+private:
+	int GetSlot(int voice);
+	int FindVictim(int priority);
+	bool PostCommand(const CommandType& command);
+	void RunCommands();
+	void FinishVoice(int voice);
+	void MixBlock(float* output, unsigned int frameCount);
+	void RankVoices();
+	static bool CompareRanks(const RankType& first, const RankType& second);
+	bool MixVoice(VoiceType& voice, float* output, unsigned int frameCount);
+	bool SkipVoice(VoiceType& voice, unsigned int frameCount);
+	float GetStep(VoiceType& voice);
+	float GetAttenuation(VoiceType& voice);
+	void Spatialize(VoiceType& voice, float* gain, float* delay, float* shadow);
+	void Resample(const float* samples, int channels, int channel, double cursor, float step, float delayStart, float delayEnd, unsigned int frameCount, float* destination);
+	void Shadow(float* samples, unsigned int frameCount, float coefficient, float& state);
+	void Accumulate(float* output, const float* left, const float* right, const float* gainStart, const float* gainEnd, unsigned int frameCount);
+	bool FillSegment();
+	void MixerThread();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SoundSink.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SOUNDSINK_H_
+#define _SOUNDSINK_H_
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SoundSink
+////////////////////////////////////////////////////////////////////////////////
+
+//A looping ring of sample memory that is played from a moving cursor
+//DirectSoundSink plays it on the sound card, NullSoundSink only moves the cursor so streams can run without a device
+class SoundSink
+{
+public:
+	virtual ~SoundSink() {}
+
+	virtual bool Start() = 0;
+	virtual void Stop() = 0;
+
+	virtual unsigned int GetBufferSize() = 0;
+	virtual bool GetPlayPosition(unsigned int& position) = 0;
+
+	//The region never wraps past the end of the ring
+	virtual bool Lock(unsigned int offset, unsigned int size, void*& data) = 0;
+	virtual void Unlock(void* data, unsigned int size) = 0;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,372 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SoundStream.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "SoundStream.h"
+
+
+SoundStream::SoundStream()
+{
+	this->m_File = nullptr;
+	this->m_Sink = nullptr;
+	this->m_blockAlign = 0;
+	this->m_bytesPerSecond = 0;
+	this->m_segmentSize = 0;
+	this->m_segmentCount = 0;
+	this->m_loop = false;
+	this->m_direct = false;
+	this->m_decoded = nullptr;
+	this->m_decodedFrames = 0;
+	this->m_decodedFirst = 0;
+	this->m_decodedCount = 0;
+	this->m_readPosition = 0;
+	this->m_decodedFirst = 0;
+	this->m_decodedCount = 0;
+	this->m_endOfFile = false;
+	this->m_endBytes = 0;
+	this->m_writtenBytes = 0;
+	this->m_playedBytes = 0;
+	this->m_lastPosition = 0;
+	this->m_playing = false;
+	this->m_underrunCount = 0;
+	this->m_running = false;
+}
+
+SoundStream::SoundStream(const SoundStream& other)
+{
+}
+
+
+SoundStream::~SoundStream()
+{
+}
+
+unsigned int SoundStream::GetOutputBits(WaveFile* file)
+{
+	//8 and 16 bit PCM plays as it is, everything else is decoded to 16 bit
+	if (file->GetFormatTag() == WAVE_FORMAT_TAG_PCM && file->GetBitsPerSample() <= 16)
+	{
+		return file->GetBitsPerSample();
+	}
+
+	return 16;
+}
+
+unsigned int SoundStream::GetBufferSize(WaveFile* file, unsigned int segmentMilliseconds, unsigned int segmentCount)
+{
+	unsigned int blockAlign;
+	unsigned int segmentSize;
+
+	//Size the sink for the stream, each segment holds whole frames of what the sink plays
+	blockAlign = file->GetChannels() * SoundStream::GetOutputBits(file) / 8;
+	segmentSize = (unsigned int)((unsigned long long)file->GetSampleRate() * blockAlign * segmentMilliseconds / 1000);
+	segmentSize -= segmentSize % blockAlign;
+	if (segmentSize == 0)
+	{
+		segmentSize = blockAlign;
+	}
+
+	return segmentSize * segmentCount;
+}
+
+bool SoundStream::Initialize(WaveFile* file, SoundSink* sink, unsigned int segmentCount, bool loop, bool threaded)
+{
+	bool result;
+	unsigned int blockAlign;
+
+	//The sink has to split evenly into segments of whole frames
+	blockAlign = file->GetChannels() * SoundStream::GetOutputBits(file) / 8;
+	if (segmentCount < 2 || sink->GetBufferSize() % segmentCount != 0 || (sink->GetBufferSize() / segmentCount) % blockAlign != 0)
+	{
+		return false;
+	}
+
+	//Compressed files decode one block at a time, other formats a short run of frames
+	this->m_direct = file->GetFormatTag() == WAVE_FORMAT_TAG_PCM && file->GetBitsPerSample() == SoundStream::GetOutputBits(file);
+	if (!this->m_direct)
+	{
+		this->m_decodedFrames = file->IsCompressed() ? file->GetFramesPerBlock() : WAVE_DECODE_FRAMES;
+		this->m_decoded = new short[this->m_decodedFrames * file->GetChannels()];
+		if (!this->m_decoded)
+		{
+			return false;
+		}
+	}
+
+	this->m_File = file;
+	this->m_Sink = sink;
+	this->m_blockAlign = blockAlign;
+	this->m_bytesPerSecond = file->GetSampleRate() * blockAlign;
+	this->m_segmentSize = sink->GetBufferSize() / segmentCount;
+	this->m_segmentCount = segmentCount;
+	this->m_loop = loop;
+
+	//Fill the whole ring before the cursor starts moving
+	result = SoundStream::Start();
+	if (!result)
+	{
+		return false;
+	}
+
+	//Without a thread Service has to be called often enough to stay ahead of the cursor, which keeps tests deterministic
+	if (threaded)
+	{
+		this->m_running = true;
+		this->m_thread = thread(&SoundStream::StreamThread, this);
+	}
+
+	return true;
+}
+
+void SoundStream::Shutdown()
+{
+	//Stop the stream thread
+	if (this->m_thread.joinable())
+	{
+		{
+			unique_lock<mutex> lock(this->m_mutex);
+			this->m_running = false;
+		}
+		this->m_condition.notify_all();
+		this->m_thread.join();
+	}
+
+	//Stop the sink, it belongs to the caller
+	if (this->m_Sink && this->m_playing)
+	{
+		this->m_Sink->Stop();
+	}
+	this->m_playing = false;
+	this->m_Sink = nullptr;
+	this->m_File = nullptr;
+
+	//Release the decode block
+	if (this->m_decoded)
+	{
+		delete[] this->m_decoded;
+		this->m_decoded = nullptr;
+	}
+	this->m_decodedFrames = 0;
+}
+
+bool SoundStream::Service()
+{
+	unique_lock<mutex> lock(this->m_mutex);
+
+	return SoundStream::Update();
+}
+
+bool SoundStream::IsPlaying()
+{
+	unique_lock<mutex> lock(this->m_mutex);
+
+	return this->m_playing;
+}
+
+unsigned long long SoundStream::GetPlayedBytes()
+{
+	unique_lock<mutex> lock(this->m_mutex);
+
+	return this->m_playedBytes;
+}
+
+int SoundStream::GetUnderrunCount()
+{
+	unique_lock<mutex> lock(this->m_mutex);
+
+	return this->m_underrunCount;
+}
+
+bool SoundStream::Start()
+{
+	bool result;
+	unsigned int i;
+
+	this->m_readPosition = 0;
+	this->m_endOfFile = false;
+	this->m_endBytes = 0;
+	this->m_writtenBytes = 0;
+	this->m_playedBytes = 0;
+	this->m_lastPosition = 0;
+	this->m_underrunCount = 0;
+
+	for (i = 0; i < this->m_segmentCount; i++)
+	{
+		result = SoundStream::FillSegment();
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	result = this->m_Sink->Start();
+	if (!result)
+	{
+		return false;
+	}
+	this->m_playing = true;
+
+	return true;
+}
+
+bool SoundStream::Update()
+{
+	PROFILE_SCOPE("SoundStream::Update");
+
+	bool result;
+	unsigned int position;
+	unsigned int bufferSize;
+
+	if (!this->m_playing)
+	{
+		return true;
+	}
+
+	result = this->m_Sink->GetPlayPosition(position);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Add up how far the cursor moved since the last look, it only moves forward around the ring
+	bufferSize = this->m_Sink->GetBufferSize();
+	this->m_playedBytes += (position + bufferSize - this->m_lastPosition) % bufferSize;
+	this->m_lastPosition = position;
+
+	//The cursor went past the last segment that was written, so old samples were played again
+	//Skip ahead to the segment after the cursor, the one it is in is already being heard
+	if (this->m_playedBytes > this->m_writtenBytes)
+	{
+		this->m_underrunCount++;
+		this->m_writtenBytes = this->m_playedBytes - this->m_playedBytes % this->m_segmentSize + this->m_segmentSize;
+	}
+
+	//Once the last real sample has been played the rest of the ring is silence
+	if (this->m_endOfFile && this->m_playedBytes >= this->m_endBytes)
+	{
+		this->m_Sink->Stop();
+		this->m_playing = false;
+		return true;
+	}
+
+	//Refill every segment the cursor has finished with, the segment it is in stays untouched
+	while (this->m_writtenBytes + this->m_segmentSize <= this->m_playedBytes - this->m_playedBytes % this->m_segmentSize + (unsigned long long)this->m_segmentSize * this->m_segmentCount)
+	{
+		result = SoundStream::FillSegment();
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool SoundStream::FillSegment()
+{
+	bool result;
+	void* data;
+	unsigned int offset;
+
+	//Segments are filled in order around the ring
+	offset = (unsigned int)(this->m_writtenBytes % this->m_Sink->GetBufferSize());
+
+	result = this->m_Sink->Lock(offset, this->m_segmentSize, data);
+	if (!result)
+	{
+		return false;
+	}
+
+	SoundStream::Decode((unsigned char*)data, this->m_segmentSize);
+
+	this->m_Sink->Unlock(data, this->m_segmentSize);
+
+	this->m_writtenBytes += this->m_segmentSize;
+
+	return true;
+}
+
+void SoundStream::Decode(unsigned char* destination, unsigned int size)
+{
+	PROFILE_SCOPE("SoundStream::Decode");
+
+	size_t frameCount;
+	size_t count;
+	unsigned int written;
+
+	frameCount = this->m_File->GetFrameCount();
+
+	//Copy straight out of the mapped file or out of the decoded block, wrapping back to the start when looping
+	written = 0;
+	while (written < size && !this->m_endOfFile)
+	{
+		count = frameCount - this->m_readPosition;
+		if (count > (size - written) / this->m_blockAlign)
+		{
+			count = (size - written) / this->m_blockAlign;
+		}
+
+		if (this->m_direct)
+		{
+			memcpy(destination + written, this->m_File->GetSamples() + this->m_readPosition * this->m_blockAlign, count * this->m_blockAlign);
+		}
+		else
+		{
+			//Decode the block holding the read position when it is not the one already decoded
+			if (this->m_readPosition < this->m_decodedFirst || this->m_readPosition >= this->m_decodedFirst + this->m_decodedCount)
+			{
+				this->m_decodedFirst = this->m_readPosition - this->m_readPosition % this->m_decodedFrames;
+				this->m_decodedCount = this->m_File->ReadSamples(this->m_decodedFirst, this->m_decodedFrames, this->m_decoded);
+			}
+			if (count > this->m_decodedFirst + this->m_decodedCount - this->m_readPosition)
+			{
+				count = this->m_decodedFirst + this->m_decodedCount - this->m_readPosition;
+			}
+
+			memcpy(destination + written, this->m_decoded + (this->m_readPosition - this->m_decodedFirst) * this->m_File->GetChannels(), count * this->m_blockAlign);
+		}
+		written += (unsigned int)(count * this->m_blockAlign);
+		this->m_readPosition += count;
+
+		if (this->m_readPosition == frameCount)
+		{
+			if (this->m_loop && frameCount > 0)
+			{
+				this->m_readPosition = 0;
+			}
+			else
+			{
+				this->m_endOfFile = true;
+				this->m_endBytes = this->m_writtenBytes + written;
+			}
+		}
+	}
+
+	//Pad the rest with silence, 8 bit samples are unsigned so their silence is the middle value
+	memset(destination + written, this->m_blockAlign == this->m_File->GetChannels() ? 0x80 : 0, size - written);
+}
+
+void SoundStream::StreamThread()
+{
+	chrono::microseconds interval;
+
+	//Show the thread by name in the profiler
+	if (ProfilerHandle)
+	{
+		ProfilerHandle->SetThreadName("Sound Stream");
+	}
+
+	//Wake up a few times per segment so a segment is refilled well before the cursor comes back to it
+	interval = chrono::microseconds((unsigned long long)this->m_segmentSize * 1000000 / this->m_bytesPerSecond / 4);
+
+	unique_lock<mutex> lock(this->m_mutex);
+	while (this->m_running)
+	{
+		this->m_condition.wait_for(lock, interval);
+		if (!this->m_running)
+		{
+			break;
+		}
+
+		SoundStream::Update();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SoundStream.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SOUNDSTREAM_H_
+#define _SOUNDSTREAM_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "SoundSink.h"
+#include "WaveFile.h"
+#include "Profiler.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned int SOUND_STREAM_SEGMENT_MILLISECONDS = 100;
+const unsigned int SOUND_STREAM_SEGMENT_COUNT = 4;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SoundStream
+////////////////////////////////////////////////////////////////////////////////
+
+//Plays a wave file through a short ring split into segments, a segment is refilled from the file once the cursor has left it
+//Small PCM is copied as it is, anything else is decoded to 16 bit a block at a time by whoever services the stream
+class SoundStream
+{
+private:
+	WaveFile* m_File;
+	SoundSink* m_Sink;
+	unsigned int m_blockAlign;
+	unsigned int m_bytesPerSecond;
+	unsigned int m_segmentSize;
+	unsigned int m_segmentCount;
+	bool m_loop;
+
+	bool m_direct;
+	short* m_decoded;
+	size_t m_decodedFrames;
+	size_t m_decodedFirst;
+	size_t m_decodedCount;
+
+	size_t m_readPosition;
+	bool m_endOfFile;
+	unsigned long long m_endBytes;
+	unsigned long long m_writtenBytes;
+	unsigned long long m_playedBytes;
+	unsigned int m_lastPosition;
+	bool m_playing;
+	int m_underrunCount;
+
+	thread m_thread;
+	mutex m_mutex;
+	condition_variable m_condition;
+	bool m_running;
+
+public:
+	SoundStream();
+	SoundStream(const SoundStream& other);
+	~SoundStream();
+
+	static unsigned int GetOutputBits(WaveFile* file);
+	static unsigned int GetBufferSize(WaveFile* file, unsigned int segmentMilliseconds, unsigned int segmentCount);
+
+	bool Initialize(WaveFile* file, SoundSink* sink, unsigned int segmentCount, bool loop, bool threaded);
+	void Shutdown();
+
+	bool Service();
+
+	bool IsPlaying();
+	unsigned long long GetPlayedBytes();
+	int GetUnderrunCount();
+
+private:
+	bool Start();
+	bool Update();
+	bool FillSegment();
+	void Decode(unsigned char* destination, unsigned int size);
+	void StreamThread();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,286 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SpriteBatch.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "SpriteBatch.h"
+
+
+SpriteBatch::SpriteBatch()
+{
+	this->m_vertexBuffer = nullptr;
+	this->m_indexBuffer = nullptr;
+	this->m_drawCount = 0;
+}
+
+SpriteBatch::SpriteBatch(const SpriteBatch& other)
+{
+}
+
+
+SpriteBatch::~SpriteBatch()
+{
+}
+
+bool SpriteBatch::Initialize(ID3D11Device* device, int screenWidth, int screenHeight, int maxSprites)
+{
+	bool result;
+
+	//Create the sprite queue the batch is sorted in
+	result = this->m_Queue.Initialize(screenWidth, screenHeight, maxSprites);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Initialize the vertex ring buffer and the shared quad index buffer
+	result = SpriteBatch::InitializeBuffers(device);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void SpriteBatch::Shutdown()
+{
+	//Release the vertex and index buffers
+	SpriteBatch::ShutdownBuffers();
+
+	//Release the sprite queue
+	this->m_Queue.Shutdown();
+}
+
+void SpriteBatch::Begin()
+{
+	//Empty the sprite queue and forget the textures of the last batch
+	this->m_Queue.Begin();
+}
+
+bool SpriteBatch::Draw(ID3D11ShaderResourceView* texture, float positionX, float positionY, float width, float height, D3DXVECTOR4 uvRect, D3DXCOLOR color, float depth)
+{
+	//The D3DX vector and color are each four floats in a row
+	return this->m_Queue.Draw(texture, positionX, positionY, width, height, &uvRect.x, &color.r, depth);
+}
+
+bool SpriteBatch::End(ID3D11DeviceContext* deviceContext, SpriteShader* spriteShader, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX orthoMatrix)
+{
+	HRESULT result;
+	bool renderResult;
+
+	D3D11_MAP mapType;
+	int sprite;
+	int spriteCount;
+	int quadCount;
+	int runStart;
+	int texture;
+
+	this->m_drawCount = 0;
+
+	//Nothing to draw
+	spriteCount = this->m_Queue.GetSpriteCount();
+	if (spriteCount == 0)
+	{
+		return true;
+	}
+
+	//Order the queue by texture so each texture only needs one draw
+	this->m_Queue.SortSprites();
+
+	sprite = 0;
+	while (sprite < spriteCount)
+	{
+		//Write as many sprites as the ring can hold at once
+		quadCount = spriteCount - sprite;
+		if (quadCount > SPRITE_RING_QUADS)
+		{
+			quadCount = SPRITE_RING_QUADS;
+		}
+
+		//Append to the ring buffer without stalling on the regions the GPU may still be reading. Only when the ring wraps around is the buffer discarded
+		mapType = D3D11_MAP_WRITE_NO_OVERWRITE;
+		if (this->m_ringPosition + quadCount > SPRITE_RING_QUADS)
+		{
+			mapType = D3D11_MAP_WRITE_DISCARD;
+			this->m_ringPosition = 0;
+		}
+
+		D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+		ZeroMemory(&mappedSubresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
+
+		//Lock the vertex buffer so it can be written to
+		result = deviceContext->Map(this->m_vertexBuffer, 0, mapType, 0, &mappedSubresource);
+		if (FAILED(result))
+		{
+			return false;
+		}
+
+		//Write the quads of the sorted sprites into the free region of the ring
+		this->m_Queue.BuildVertexArray((VertexType*)mappedSubresource.pData + (this->m_ringPosition * 4), sprite, quadCount);
+
+		//Unlock the vertex buffer
+		deviceContext->Unmap(this->m_vertexBuffer, 0);
+
+		//Draw each run of sprites that share a texture
+		runStart = 0;
+		for (int i = 1; i <= quadCount; i++)
+		{
+			if (i < quadCount && this->m_Queue.GetTextureSlot(sprite + i) == this->m_Queue.GetTextureSlot(sprite + runStart))
+			{
+				continue;
+			}
+
+			texture = this->m_Queue.GetTextureSlot(sprite + runStart);
+
+			//Put the start of the run on the graphics pipeline to prepare it for drawing
+			SpriteBatch::RenderBuffers(deviceContext, this->m_ringPosition + runStart);
+
+			//Render the run using the sprite shader
+			renderResult = spriteShader->Render(deviceContext, (i - runStart) * 6, worldMatrix, viewMatrix, orthoMatrix, (ID3D11ShaderResourceView*)this->m_Queue.GetTexture(texture));
+			if (!renderResult)
+			{
+				return false;
+			}
+			this->m_drawCount++;
+
+			runStart = i;
+		}
+
+		this->m_ringPosition += quadCount;
+		sprite += quadCount;
+	}
+
+	return true;
+}
+
+int SpriteBatch::GetSpriteCount()
+{
+	return this->m_Queue.GetSpriteCount();
+}
+
+int SpriteBatch::GetDrawCount()
+{
+	return this->m_drawCount;
+}
+
+bool SpriteBatch::InitializeBuffers(ID3D11Device* device)
+{
+	HRESULT result;
+
+	UINT* indices;
+	UINT indexCount;
+
+	//Set the number of indices in the shared quad index array
+	indexCount = 6 * SPRITE_RING_QUADS;
+
+	//Create the index array
+	indices = new UINT[indexCount];
+	if (!indices)
+	{
+		return false;
+	}
+
+	//Every quad is stored as its top left, bottom right, bottom left and top right corners
+	for (UINT i = 0; i < SPRITE_RING_QUADS; i++)
+	{
+		//First triangle in quad
+		indices[(i * 6) + 0] = (i * 4) + 0;
+		indices[(i * 6) + 1] = (i * 4) + 1;
+		indices[(i * 6) + 2] = (i * 4) + 2;
+
+		//Second triangle in quad
+		indices[(i * 6) + 3] = (i * 4) + 0;
+		indices[(i * 6) + 4] = (i * 4) + 3;
+		indices[(i * 6) + 5] = (i * 4) + 1;
+	}
+
+	//Create the Vertex Buffer Descriptor
+	D3D11_BUFFER_DESC vertexBufferDesc;
+	ZeroMemory(&vertexBufferDesc, sizeof(D3D11_BUFFER_DESC));
+
+	//Set up the description of the dynamic vertex ring buffer
+	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType) * 4 * SPRITE_RING_QUADS;
+	vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	vertexBufferDesc.MiscFlags = 0;
+	vertexBufferDesc.StructureByteStride = 0;
+	vertexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+
+	//Create the vertex buffer. Its contents are written each frame so no initial data is needed
+	result = device->CreateBuffer(&vertexBufferDesc, nullptr, &this->m_vertexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Start the ring at its end so the first batch discards the buffer
+	this->m_ringPosition = SPRITE_RING_QUADS;
+
+	//Create the Index Buffer Descriptor
+	D3D11_BUFFER_DESC indexBufferDesc;
+	ZeroMemory(&indexBufferDesc, sizeof(D3D11_BUFFER_DESC));
+
+	//Setup the description of the static index buffer
+	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	indexBufferDesc.ByteWidth = sizeof(UINT) * indexCount;
+	indexBufferDesc.CPUAccessFlags = 0;
+	indexBufferDesc.MiscFlags = 0;
+	indexBufferDesc.StructureByteStride = 0;
+	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
+
+	//Create the sub resource to map the data
+	D3D11_SUBRESOURCE_DATA indexData;
+	ZeroMemory(&indexData, sizeof(D3D11_SUBRESOURCE_DATA));
+
+	//Give the sub-resource structure a pointer to the index data
+	indexData.pSysMem = indices;
+	indexData.SysMemPitch = 0;
+	indexData.SysMemSlicePitch = 0;
+
+	//Create the index buffer
+	result = device->CreateBuffer(&indexBufferDesc, &indexData, &this->m_indexBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	delete[] indices;
+	indices = nullptr;
+
+	return true;
+}
+
+void SpriteBatch::ShutdownBuffers()
+{
+	//Release the index buffer
+	if (this->m_indexBuffer)
+	{
+		this->m_indexBuffer->Release();
+		this->m_indexBuffer = nullptr;
+	}
+
+	//Release the vertex buffer
+	if (this->m_vertexBuffer)
+	{
+		this->m_vertexBuffer->Release();
+		this->m_vertexBuffer = nullptr;
+	}
+}
+
+void SpriteBatch::RenderBuffers(ID3D11DeviceContext* deviceContext, int firstQuad)
+{
+	UINT stride;
+	UINT offset;
+
+	//Set the vertex buffer stride and the offset of the first quad of the run
+	stride = sizeof(VertexType);
+	offset = sizeof(VertexType) * 4 * firstQuad;
+
+	//Set the vertex buffer to active in the input assembler so it can be rendered
+	deviceContext->IASetVertexBuffers(0, 1, &this->m_vertexBuffer, &stride, &offset);
+
+	//Set the index buffer to active in the input assembler so it can be rendered
+	deviceContext->IASetIndexBuffer(this->m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+
+	//Set the type of primitive that should be rendered from this vertex buffer, in this case triangles
+	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SpriteBatch.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SPRITEBATCH_H_
+#define _SPRITEBATCH_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <d3d11.h>
+#include <d3dx10math.h>
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "SpriteShader.h"
+#include "SpriteQueue.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int SPRITE_RING_QUADS = 16384;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SpriteBatch
+////////////////////////////////////////////////////////////////////////////////
+
+//Queues sprites and draws them sorted by texture, the queueing and sorting are done by the SpriteQueue and this keeps the buffers
+class SpriteBatch
+{
+private:
+	typedef SpriteQueue::VertexType VertexType;
+
+	ID3D11Buffer* m_vertexBuffer;
+	ID3D11Buffer* m_indexBuffer;
+	int m_ringPosition;
+
+	SpriteQueue m_Queue;
+	int m_drawCount;
+
+public:
+	SpriteBatch();
+	SpriteBatch(const SpriteBatch& other);
+	~SpriteBatch();
+
+	bool Initialize(ID3D11Device* device, int screenWidth, int screenHeight, int maxSprites);
+	void Shutdown();
+
+	void Begin();
+	bool Draw(ID3D11ShaderResourceView* texture, float positionX, float positionY, float width, float height, D3DXVECTOR4 uvRect, D3DXCOLOR color, float depth);
+	bool End(ID3D11DeviceContext* deviceContext, SpriteShader* spriteShader, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX orthoMatrix);
+
+	int GetSpriteCount();
+	int GetDrawCount();
+
+private:
+	bool InitializeBuffers(ID3D11Device* device);
+	void ShutdownBuffers();
+	void RenderBuffers(ID3D11DeviceContext* deviceContext, int firstQuad);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,303 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SpriteQueue.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "SpriteQueue.h"
+
+
+SpriteQueue::SpriteQueue()
+{
+	this->m_sprites = nullptr;
+	this->m_sortKeys = nullptr;
+	this->m_sortIndices = nullptr;
+	this->m_sortKeysTemp = nullptr;
+	this->m_sortIndicesTemp = nullptr;
+	this->m_maxSprites = 0;
+	this->m_spriteCount = 0;
+
+	this->m_textureCount = 0;
+	this->m_lastTexture = -1;
+}
+
+SpriteQueue::SpriteQueue(const SpriteQueue& other)
+{
+}
+
+
+SpriteQueue::~SpriteQueue()
+{
+}
+
+bool SpriteQueue::Initialize(int screenWidth, int screenHeight, int maxSprites)
+{
+	//Store the screen size
+	this->m_screenWidth = screenWidth;
+	this->m_screenHeight = screenHeight;
+
+	//Store the number of sprites that can be queued between Begin and End
+	this->m_maxSprites = maxSprites;
+
+	//Create the sprite queue
+	this->m_sprites = new SpriteType[maxSprites];
+	if (!this->m_sprites)
+	{
+		return false;
+	}
+
+	//Create the sort keys and the sprite indices they are sorted with, plus the second copy of each the radix sort scatters into
+	this->m_sortKeys = new unsigned int[maxSprites];
+	this->m_sortIndices = new unsigned int[maxSprites];
+	this->m_sortKeysTemp = new unsigned int[maxSprites];
+	this->m_sortIndicesTemp = new unsigned int[maxSprites];
+	if (!this->m_sortKeys || !this->m_sortIndices || !this->m_sortKeysTemp || !this->m_sortIndicesTemp)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void SpriteQueue::Shutdown()
+{
+	//Release the sort arrays
+	if (this->m_sortIndicesTemp)
+	{
+		delete[] this->m_sortIndicesTemp;
+		this->m_sortIndicesTemp = nullptr;
+	}
+
+	if (this->m_sortKeysTemp)
+	{
+		delete[] this->m_sortKeysTemp;
+		this->m_sortKeysTemp = nullptr;
+	}
+
+	if (this->m_sortIndices)
+	{
+		delete[] this->m_sortIndices;
+		this->m_sortIndices = nullptr;
+	}
+
+	if (this->m_sortKeys)
+	{
+		delete[] this->m_sortKeys;
+		this->m_sortKeys = nullptr;
+	}
+
+	//Release the sprite queue
+	if (this->m_sprites)
+	{
+		delete[] this->m_sprites;
+		this->m_sprites = nullptr;
+	}
+}
+
+void SpriteQueue::Begin()
+{
+	//Empty the sprite queue and forget the textures of the last batch
+	this->m_spriteCount = 0;
+	this->m_textureCount = 0;
+	this->m_lastTexture = -1;
+}
+
+bool SpriteQueue::Draw(void* texture, float positionX, float positionY, float width, float height, const float* uvRect, const float* color, float depth)
+{
+	SpriteType* sprite;
+
+	//Check for possible queue overflow
+	if (this->m_spriteCount >= this->m_maxSprites)
+	{
+		return false;
+	}
+
+	//Find the slot of the texture. Sprites tend to come in runs that share a texture so the last one used is checked first
+	if (this->m_lastTexture < 0 || this->m_textures[this->m_lastTexture] != texture)
+	{
+		this->m_lastTexture = -1;
+		for (int i = 0; i < this->m_textureCount; i++)
+		{
+			if (this->m_textures[i] == texture)
+			{
+				this->m_lastTexture = i;
+				break;
+			}
+		}
+
+		//First sprite with this texture in the batch
+		if (this->m_lastTexture < 0)
+		{
+			if (this->m_textureCount >= SPRITE_MAX_TEXTURES)
+			{
+				return false;
+			}
+			this->m_textures[this->m_textureCount] = texture;
+			this->m_lastTexture = this->m_textureCount;
+			this->m_textureCount++;
+		}
+	}
+
+	//Keep the depth in the range the sort key can hold
+	if (depth < 0.0f)
+	{
+		depth = 0.0f;
+	}
+	if (depth > 1.0f)
+	{
+		depth = 1.0f;
+	}
+
+	sprite = &this->m_sprites[this->m_spriteCount];
+
+	//Calculate the screen coordinates of the sprite the same way Bitmap does, with the origin at the top left of the screen
+	sprite->left = (float)((this->m_screenWidth / 2) * -1) + positionX;
+	sprite->right = sprite->left + width;
+	sprite->top = (float)(this->m_screenHeight / 2) - positionY;
+	sprite->bottom = sprite->top - height;
+	memcpy(sprite->uvRect, uvRect, sizeof(sprite->uvRect));
+	memcpy(sprite->color, color, sizeof(sprite->color));
+	sprite->depth = depth;
+
+	//The key sorts by texture first so every texture is drawn as one run, then back to front within the texture so blended sprites overlap correctly.
+	//Sprites with the same key keep the order they were queued in
+	this->m_sortKeys[this->m_spriteCount] = ((unsigned int)this->m_lastTexture << 24) | (0xFFFFFF - (unsigned int)(depth * 16777215.0f));
+	this->m_sortIndices[this->m_spriteCount] = (unsigned int)this->m_spriteCount;
+
+	this->m_spriteCount++;
+
+	return true;
+}
+
+void SpriteQueue::SortSprites()
+{
+	unsigned int histogram[4][256];
+	unsigned int offsets[256];
+	unsigned int* swap;
+	unsigned int key;
+	unsigned int digit;
+	unsigned int total;
+	int shift;
+
+	//Nothing to sort, and the first key is read below
+	if (this->m_spriteCount == 0)
+	{
+		return;
+	}
+
+	//Count how often every byte of the keys occurs, for all four bytes in one pass
+	memset(histogram, 0, sizeof(histogram));
+	for (int i = 0; i < this->m_spriteCount; i++)
+	{
+		key = this->m_sortKeys[i];
+		histogram[0][key & 0xFF]++;
+		histogram[1][(key >> 8) & 0xFF]++;
+		histogram[2][(key >> 16) & 0xFF]++;
+		histogram[3][key >> 24]++;
+	}
+
+	//Least significant digit radix sort, one byte per pass. Each pass is stable so the queue order survives between equal keys
+	for (int pass = 0; pass < 4; pass++)
+	{
+		shift = pass * 8;
+
+		//If every key has the same byte the pass would not move anything. This skips most passes as there are few textures and depths
+		if (histogram[pass][(this->m_sortKeys[0] >> shift) & 0xFF] == (unsigned int)this->m_spriteCount)
+		{
+			continue;
+		}
+
+		//Turn the counts into the position each digit starts at
+		total = 0;
+		for (int i = 0; i < 256; i++)
+		{
+			offsets[i] = total;
+			total += histogram[pass][i];
+		}
+
+		//Scatter the keys and their sprite indices into the other arrays
+		for (int i = 0; i < this->m_spriteCount; i++)
+		{
+			digit = (this->m_sortKeys[i] >> shift) & 0xFF;
+			this->m_sortKeysTemp[offsets[digit]] = this->m_sortKeys[i];
+			this->m_sortIndicesTemp[offsets[digit]] = this->m_sortIndices[i];
+			offsets[digit]++;
+		}
+
+		//The sorted arrays become the source of the next pass
+		swap = this->m_sortKeys;
+		this->m_sortKeys = this->m_sortKeysTemp;
+		this->m_sortKeysTemp = swap;
+
+		swap = this->m_sortIndices;
+		this->m_sortIndices = this->m_sortIndicesTemp;
+		this->m_sortIndicesTemp = swap;
+	}
+}
+
+void SpriteQueue::BuildVertexArray(void* vertices, int firstSprite, int count)
+{
+	VertexType* vertexPtr;
+	SpriteType* sprite;
+
+	//Coerce the input vertices into a VertexType structure
+	vertexPtr = (VertexType*)vertices;
+
+	for (int i = firstSprite; i < firstSprite + count; i++)
+	{
+		sprite = &this->m_sprites[this->m_sortIndices[i]];
+
+		//Every quad is stored as its top left, bottom right, bottom left and top right corners to match the shared index buffer
+		vertexPtr[0].position[0] = sprite->left;
+		vertexPtr[0].position[1] = sprite->top;
+		vertexPtr[0].position[2] = sprite->depth;
+		vertexPtr[0].texture[0] = sprite->uvRect[0];
+		vertexPtr[0].texture[1] = sprite->uvRect[1];
+		memcpy(vertexPtr[0].color, sprite->color, sizeof(sprite->color));
+
+		vertexPtr[1].position[0] = sprite->right;
+		vertexPtr[1].position[1] = sprite->bottom;
+		vertexPtr[1].position[2] = sprite->depth;
+		vertexPtr[1].texture[0] = sprite->uvRect[2];
+		vertexPtr[1].texture[1] = sprite->uvRect[3];
+		memcpy(vertexPtr[1].color, sprite->color, sizeof(sprite->color));
+
+		vertexPtr[2].position[0] = sprite->left;
+		vertexPtr[2].position[1] = sprite->bottom;
+		vertexPtr[2].position[2] = sprite->depth;
+		vertexPtr[2].texture[0] = sprite->uvRect[0];
+		vertexPtr[2].texture[1] = sprite->uvRect[3];
+		memcpy(vertexPtr[2].color, sprite->color, sizeof(sprite->color));
+
+		vertexPtr[3].position[0] = sprite->right;
+		vertexPtr[3].position[1] = sprite->top;
+		vertexPtr[3].position[2] = sprite->depth;
+		vertexPtr[3].texture[0] = sprite->uvRect[2];
+		vertexPtr[3].texture[1] = sprite->uvRect[1];
+		memcpy(vertexPtr[3].color, sprite->color, sizeof(sprite->color));
+
+		vertexPtr += 4;
+	}
+}
+
+int SpriteQueue::GetTextureSlot(int sortedSprite)
+{
+	return (int)(this->m_sortKeys[sortedSprite] >> 24);
+}
+
+int SpriteQueue::GetQueueIndex(int sortedSprite)
+{
+	return (int)this->m_sortIndices[sortedSprite];
+}
+
+void* SpriteQueue::GetTexture(int slot)
+{
+	return this->m_textures[slot];
+}
+
+int SpriteQueue::GetSpriteCount()
+{
+	return this->m_spriteCount;
+}
+
+int SpriteQueue::GetTextureCount()
+{
+	return this->m_textureCount;
+}
\ No newline at end of file
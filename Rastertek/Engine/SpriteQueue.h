@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SpriteQueue.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SPRITEQUEUE_H_
+#define _SPRITEQUEUE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <cstring>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+const int SPRITE_MAX_TEXTURES = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SpriteQueue
+////////////////////////////////////////////////////////////////////////////////
+
+//The sprites queued between a batch's Begin and End, sorted so each texture is one run and written out as quads
+//Nothing here is tied to a device, a texture is only a pointer to tell textures apart
+class SpriteQueue
+{
+public:
+	//Laid out like the position, texture and color the sprite shader reads
+	struct VertexType
+	{
+		float position[3];
+		float texture[2];
+		float color[4];
+	};
+
+private:
+	struct SpriteType
+	{
+		float left;
+		float top;
+		float right;
+		float bottom;
+		float uvRect[4];
+		float color[4];
+		float depth;
+	};
+
+	SpriteType* m_sprites;
+	unsigned int* m_sortKeys;
+	unsigned int* m_sortIndices;
+	unsigned int* m_sortKeysTemp;
+	unsigned int* m_sortIndicesTemp;
+	int m_maxSprites;
+	int m_spriteCount;
+
+	void* m_textures[SPRITE_MAX_TEXTURES];
+	int m_textureCount;
+	int m_lastTexture;
+
+	int m_screenWidth;
+	int m_screenHeight;
+
+public:
+	SpriteQueue();
+	SpriteQueue(const SpriteQueue& other);
+	~SpriteQueue();
+
+	bool Initialize(int screenWidth, int screenHeight, int maxSprites);
+	void Shutdown();
+
+	void Begin();
+	bool Draw(void* texture, float positionX, float positionY, float width, float height, const float* uvRect, const float* color, float depth);
+
+	void SortSprites();
+	void BuildVertexArray(void* vertices, int firstSprite, int count);
+
+	//After SortSprites, the texture and queue position of the sprite at each place in the sorted order
+	int GetTextureSlot(int sortedSprite);
+	int GetQueueIndex(int sortedSprite);
+	void* GetTexture(int slot);
+
+	int GetSpriteCount();
+	int GetTextureCount();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: SpriteShader.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _SPRITESHADER_H_
+#define _SPRITESHADER_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include <d3dx11async.h>
+#include <fstream>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: SpriteShader
+////////////////////////////////////////////////////////////////////////////////
+class SpriteShader
+{
+private:
+	struct MatrixBufferType
+	{
+		D3DXMATRIX world;
+		D3DXMATRIX view;
+		D3DXMATRIX projection;
+	};
+
+	ID3D11VertexShader* m_vertexShader;
+	ID3D11PixelShader* m_pixelShader;
+	ID3D11InputLayout* m_layout;
+	ID3D11SamplerState* m_sampleState;
+	ID3D11Buffer* m_matrixBuffer;
+
+public:
+	SpriteShader();
+	SpriteShader(const SpriteShader& other);
+	~SpriteShader();
+
+	bool Initialize(ID3D11Device* device, HWND hwnd);
+	void Shutdown();
+	bool Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture);
+
+private:
+	bool InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename);
+	void ShutdownShader();
+	void OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename);
+
+	bool SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, ID3D11ShaderResourceView* texture);
+	void RenderShader(ID3D11DeviceContext* deviceContext, int indexCount);
+};
+#endif
\ No newline at end of file
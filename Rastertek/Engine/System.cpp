@@ -8,6 +8,18 @@ System::System()
 {
 	this->m_Input = nullptr;
 	this->m_Graphics = nullptr;
+	this->m_Profiler = nullptr;
+	this->m_traceKeyDown = false;
+	this->m_tracing = false;
+	this->m_traceFrames = 0;
+	this->m_Timer = nullptr;
+	this->m_FrameStats = nullptr;
+	this->m_statsKeyDown = false;
+	this->m_FixedStep = nullptr;
+	this->m_Position = nullptr;
+	this->m_Jobs = nullptr;
+	this->m_Pipeline = nullptr;
+	this->m_FrameMemory = nullptr;
 }
 
 System::System(const System& other)
@@ -29,6 +41,19 @@ bool System::Initialize()
 	screenWidth = 0;
 	screenHeight = 0;
 
+	//Create the Profiler object first so the rest of the start up is timed as well
+	this->m_Profiler = new Profiler();
+	if (!this->m_Profiler)
+	{
+		return false;
+	}
+
+	result = this->m_Profiler->Initialize();
+	if (!result)
+	{
+		return false;
+	}
+
 	//Initialize the windows API
 	System::InitializeWindows(screenWidth, screenHeight);
 
@@ -47,6 +72,32 @@ bool System::Initialize()
 		return false;
 	}
 
+	//Create the JobSystem object. Its workers simulate and build frames beside the one being submitted
+	this->m_Jobs = new JobSystem();
+	if (!this->m_Jobs)
+	{
+		return false;
+	}
+
+	result = this->m_Jobs->Initialize(-1);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Create the FrameMemory object, it keeps a scratch arena for each job thread and loading already takes its temporary arrays from them
+	this->m_FrameMemory = new FrameMemory();
+	if (!this->m_FrameMemory)
+	{
+		return false;
+	}
+
+	result = this->m_FrameMemory->Initialize(this->m_Jobs, FRAME_MEMORY_FRAME_SIZE, FRAME_MEMORY_SCRATCH_SIZE);
+	if (!result)
+	{
+		return false;
+	}
+
 	//Create the Graphics object. This object will handle rendering all the graphics for this application
 	this->m_Graphics = new Graphics();
 	if (!this->m_Graphics)
@@ -54,9 +105,70 @@ bool System::Initialize()
 		return false;
 	}
 	//Initialize the Graphics object
-	result = this->m_Graphics->Initialize(screenWidth, screenHeight, m_hwnd);
+	result = this->m_Graphics->Initialize(screenWidth, screenHeight, m_hwnd, this->m_Jobs, this->m_FrameMemory);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Create the Position object. The simulation moves it and the camera follows it
+	this->m_Position = new Position();
+	if (!this->m_Position)
+	{
+		return false;
+	}
+	this->m_Position->SetPosition(this->m_Graphics->GetCameraPosition());
+
+	//Create the FixedStep object. This object runs the simulation at the same rate whatever the frame rate is
+	this->m_FixedStep = new FixedStep();
+	if (!this->m_FixedStep)
+	{
+		return false;
+	}
+
+	result = this->m_FixedStep->Initialize(SIMULATION_TICK_RATE);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Create the FramePipeline object. This object overlaps the stages of three frames
+	this->m_Pipeline = new FramePipeline();
+	if (!this->m_Pipeline)
+	{
+		return false;
+	}
+
+	result = this->m_Pipeline->Initialize(this, this->m_Jobs);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Create the FrameStats object. This object keeps the frame time percentiles and finds the hitches
+	this->m_FrameStats = new FrameStats();
+	if (!this->m_FrameStats)
+	{
+		return false;
+	}
+
+	result = this->m_FrameStats->Initialize();
+	if (!result)
+	{
+		return false;
+	}
+
+	//Create the Timer object last so the first frame does not count the loading
+	this->m_Timer = new Timer();
+	if (!this->m_Timer)
+	{
+		return false;
+	}
+
+	result = this->m_Timer->Intialize();
 	if (!result)
 	{
+		MessageBox(this->m_hwnd, L"Could not initialize the timer object", L"Error", MB_OK);
 		return false;
 	}
 	return true;
@@ -64,6 +176,51 @@ bool System::Initialize()
 
 void System::Shutdown()
 {
+	//Release the Timer object
+	if (this->m_Timer)
+	{
+		delete this->m_Timer;
+		this->m_Timer = nullptr;
+	}
+
+	//Release the FramePipeline object, nothing runs between frames so the frames in flight are dropped
+	if (this->m_Pipeline)
+	{
+		this->m_Pipeline->Shutdown();
+		delete this->m_Pipeline;
+		this->m_Pipeline = nullptr;
+	}
+
+	//Release the JobSystem object
+	if (this->m_Jobs)
+	{
+		this->m_Jobs->Shutdown();
+		delete this->m_Jobs;
+		this->m_Jobs = nullptr;
+	}
+
+	//Release the FixedStep object
+	if (this->m_FixedStep)
+	{
+		delete this->m_FixedStep;
+		this->m_FixedStep = nullptr;
+	}
+
+	//Release the Position object
+	if (this->m_Position)
+	{
+		delete this->m_Position;
+		this->m_Position = nullptr;
+	}
+
+	//Release the FrameStats object
+	if (this->m_FrameStats)
+	{
+		this->m_FrameStats->Shutdown();
+		delete this->m_FrameStats;
+		this->m_FrameStats = nullptr;
+	}
+
 	//Release the Graphics object
 	if (this->m_Graphics)
 	{
@@ -80,6 +237,28 @@ void System::Shutdown()
 		this->m_Input = nullptr;
 	}
 
+	//Release the FrameMemory object, nothing allocates from it once the graphics are gone
+	if (this->m_FrameMemory)
+	{
+		this->m_FrameMemory->Shutdown();
+		delete this->m_FrameMemory;
+		this->m_FrameMemory = nullptr;
+	}
+
+	//Release the Profiler object last, every thread that records into it is gone by now
+	if (this->m_Profiler)
+	{
+		if (this->m_tracing)
+		{
+			this->m_Profiler->StopCapture();
+			this->m_Profiler->SaveTrace(PROFILER_TRACE_FILE);
+		}
+
+		this->m_Profiler->Shutdown();
+		delete this->m_Profiler;
+		this->m_Profiler = nullptr;
+	}
+
 	// Shutdown the window.
 	System::ShutdownWindows();
 }
@@ -132,6 +311,13 @@ void System::Run()
 bool System::Frame()
 {
 	bool result;
+	FrameDataType* frame;
+
+	this->m_Profiler->BeginFrame();
+
+	//Time the whole loop from the last frame to this one, presenting included
+	this->m_Timer->Frame();
+	this->m_FrameStats->AddFrame(this->m_Timer->GetTime());
 
 	//Do the Input frame processing
 	result = this->m_Input->Frame();
@@ -140,16 +326,107 @@ bool System::Frame()
 		return false;
 	}
 
-	//Do the frame processing for the Graphics object
-	result = this->m_Graphics->Frame();
+	//The new frame takes what the main thread knows, the keys and the time, the rest is filled in by the stages
+	frame = this->m_Pipeline->BeginFrame();
+	frame->frameTime = this->m_Timer->GetTime();
+	frame->buttons = (this->m_Input->IsLeftArrowPressed() ? FRAME_BUTTON_LEFT : 0) | (this->m_Input->IsRightArrowPressed() ? FRAME_BUTTON_RIGHT : 0);
+
+	//Simulate this frame and build the last one on the workers while the one before that is drawn here
+	result = this->m_Pipeline->RunFrame();
 	if (!result)
 	{
 		return false;
 	}
 
+	//Build this frame's timing tree out of every thread's scopes
+	this->m_Profiler->EndFrame();
+	System::UpdateTrace();
+
+	//Pressing F10 writes the recent frame times out for a spreadsheet
+	if (this->m_Input->IsF10Pressed() && !this->m_statsKeyDown)
+	{
+		this->m_FrameStats->SaveCsv(FRAME_STATS_FILE);
+	}
+	this->m_statsKeyDown = this->m_Input->IsF10Pressed();
+
+	//The step has waited for its jobs, so the frame and scratch arenas can all go back for the next one
+	this->m_FrameMemory->EndFrame();
+
 	return true;
 }
 
+void System::Simulate(FrameDataType& frame)
+{
+	PROFILE_SCOPE("System::Simulate");
+
+	D3DXVECTOR3 cameraPosition;
+	int i;
+
+	//Run as many whole ticks as the time since the last frame covers, the rest carries over to the next frame
+	frame.tickCount = this->m_FixedStep->Advance(frame.frameTime);
+	for (i = 0; i < frame.tickCount; i++)
+	{
+		System::Tick(frame.buttons);
+	}
+
+	//Draw between the last two ticks so the motion stays smooth when the frame rate is not the tick rate
+	this->m_Position->GetRenderPosition(this->m_FixedStep->GetAlpha(), cameraPosition);
+	frame.cameraPosition[0] = cameraPosition.x;
+	frame.cameraPosition[1] = cameraPosition.y;
+	frame.cameraPosition[2] = cameraPosition.z;
+}
+
+void System::Build(FrameDataType& frame)
+{
+	this->m_Graphics->BuildFrame(frame);
+}
+
+bool System::Submit(FrameDataType& frame)
+{
+	//Do the frame processing for the Graphics object
+	return this->m_Graphics->Frame(frame);
+}
+
+void System::Tick(unsigned int buttons)
+{
+	PROFILE_SCOPE("System::Tick");
+
+	//Every tick is the same length, so the same keys always move the camera the same way
+	this->m_Position->BeginTick();
+	this->m_Position->SetFrameTime(this->m_FixedStep->GetTickTime());
+	this->m_Position->MoveLeft((buttons & FRAME_BUTTON_LEFT) != 0);
+	this->m_Position->MoveRight((buttons & FRAME_BUTTON_RIGHT) != 0);
+}
+
+void System::UpdateTrace()
+{
+	bool keyDown;
+
+	//Pressing F11 records the next frames into a trace that loads in chrome://tracing
+	keyDown = this->m_Input->IsF11Pressed();
+	if (keyDown && !this->m_traceKeyDown && !this->m_tracing)
+	{
+		this->m_Profiler->StartCapture();
+		this->m_tracing = true;
+		this->m_traceFrames = 0;
+	}
+	this->m_traceKeyDown = keyDown;
+
+	if (!this->m_tracing)
+	{
+		return;
+	}
+
+	//The profiler stops a capture by itself when it gets too big, save what it has then
+	this->m_traceFrames++;
+	if (this->m_traceFrames >= PROFILER_TRACE_FRAMES || !this->m_Profiler->IsCapturing())
+	{
+		this->m_Profiler->StopCapture();
+		this->m_Profiler->SaveTrace(PROFILER_TRACE_FILE);
+		this->m_tracing = false;
+	}
+}
+
 LRESULT CALLBACK System::MessageHandler(HWND hwnd, UINT umsg, WPARAM wParam, LPARAM lParam)
 {
 	return DefWindowProc(hwnd, umsg, wParam, lParam);
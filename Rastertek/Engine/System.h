@@ -16,12 +16,30 @@
 ///////////////////////
 #include "Input.h"
 #include "Graphics.h"
+#include "Profiler.h"
+#include "Timer.h"
+#include "FrameStats.h"
+#include "FixedStep.h"
+#include "Position.h"
+#include "JobSystem.h"
+#include "FramePipeline.h"
+#include "FrameMemory.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int PROFILER_TRACE_FRAMES = 300;
+const char PROFILER_TRACE_FILE[] = "profile.json";
+const char FRAME_STATS_FILE[] = "frametimes.csv";
+const float SIMULATION_TICK_RATE = 60.0f;
+const unsigned int FRAME_BUTTON_LEFT = 1;
+const unsigned int FRAME_BUTTON_RIGHT = 2;
 
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: System
 ////////////////////////////////////////////////////////////////////////////////
-class System
+class System : public FrameStages
 {
 
 private:
@@ -31,6 +49,19 @@ private:
 
 	Input* m_Input;
 	Graphics* m_Graphics;
+	Profiler* m_Profiler;
+	Timer* m_Timer;
+	FrameStats* m_FrameStats;
+	FixedStep* m_FixedStep;
+	Position* m_Position;
+	JobSystem* m_Jobs;
+	FramePipeline* m_Pipeline;
+	FrameMemory* m_FrameMemory;
+
+	bool m_traceKeyDown;
+	bool m_tracing;
+	int m_traceFrames;
+	bool m_statsKeyDown;
 
 public:
 	System();
@@ -43,8 +74,14 @@ public:
 
 	LRESULT CALLBACK MessageHandler(HWND hwnd, UINT umsg, WPARAM wParam, LPARAM lParam);
 
+	void Simulate(FrameDataType& frame);
+	void Build(FrameDataType& frame);
+	bool Submit(FrameDataType& frame);
+
 private:
 	bool Frame();
+	void Tick(unsigned int buttons);
+	void UpdateTrace();
 	void InitializeWindows(int& screenWidth, int& screenHeight);
 	void ShutdownWindows();
 
@@ -9,7 +9,20 @@ Text::Text()
 	this->m_Font = nullptr;
 	this->m_FontShader = nullptr;
 
-	this->m_sentence = nullptr;
+	this->m_vertexBuffer = nullptr;
+	this->m_indexBuffer = nullptr;
+	this->m_layout = nullptr;
+	this->m_glyphsReserved = 0;
+
+	for (int i = 0; i < TEXT_MAX_SENTENCES; i++)
+	{
+		this->m_sentences[i] = ObjectPool<TextSentence>::GetNullHandle();
+	}
+	this->m_sentenceCount = 0;
+	this->m_renderCount = -1;
+
+	this->m_bytesUploaded = 0;
+	this->m_uploadCount = 0;
 }
 
 Text::Text(const Text& other)
@@ -21,8 +34,10 @@ Text::~Text()
 {
 }
 
-bool Text::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext, HWND hwnd, int screenWidth, int screenHeight, D3DXMATRIX baseViewMatrix)
+bool Text::Initialize(ID3D11Device* device, TextureManager* textureManager, HWND hwnd, int screenWidth, int screenHeight, D3DXMATRIX baseViewMatrix)
 {
+	PROFILE_SCOPE("Text::Initialize");
+
 	bool result;
 
 	//Store the screen width and height
@@ -40,7 +55,7 @@ bool Text::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext,
 	}
 
 	//Initialize the Font object
-	result = this->m_Font->Initialize(device, "fontdata.txt", L"font.dds");
+	result = this->m_Font->Initialize(device, textureManager, "fontdata.txt", L"font.dds", 16.0f, false);
 	if (!result)
 	{
 		MessageBox(hwnd, L"Could not initialize the Font object", L"Error", MB_OK);
@@ -62,15 +77,30 @@ bool Text::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext,
 		return false;
 	}
 
+	//Create the vertex buffer holding the glyph slots of every sentence and the shared quad index buffer they are drawn with
+	result = Text::InitializeBuffers(device);
+	if (!result)
+	{
+		return false;
+	}
+
+	//The sentences live in a pool with room for as many as the text can hold
+	result = this->m_sentencePool.Initialize(TEXT_MAX_SENTENCES);
+	if (!result)
+	{
+		return false;
+	}
+
 	//Initialize the first sentence
-	result = InitializeSentence(&this->m_sentence, 32, device);
+	result = Text::InitializeSentence(&this->m_sentences[0], 32);
 	if (!result)
 	{
 		return false;
 	}
+	this->m_sentenceCount = 1;
 
-	//Now update the sentence vertex buffer with the new string information
-	result = UpdateSentence(this->m_sentence, "Render Count: ", D3DXVECTOR2(20, 20), D3DXCOLOR(1.0f, 1.0f, 1.0f, 1.0f), deviceContext);
+	//Now build the layout of the sentence with the new string information
+	result = Text::UpdateSentence(this->m_sentencePool.Get(this->m_sentences[0]), "Render Count: ", D3DXVECTOR2(20, 20), D3DXCOLOR(1.0f, 1.0f, 1.0f, 1.0f), 1.0f);
 	if (!result)
 	{
 		return false;
@@ -81,8 +111,16 @@ bool Text::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext,
 
 void Text::Shutdown()
 {
-	//Release the first Sentence
-	Text::ReleaseSentence(&this->m_sentence);
+	//Release the sentences
+	for (int i = 0; i < this->m_sentenceCount; i++)
+	{
+		Text::ReleaseSentence(&this->m_sentences[i]);
+	}
+	this->m_sentenceCount = 0;
+	this->m_sentencePool.Shutdown();
+
+	//Release the vertex and index buffers
+	Text::ShutdownBuffers();
 
 	//Release the FontShader object
 	if (this->m_FontShader)
@@ -103,10 +141,43 @@ void Text::Shutdown()
 
 bool Text::Render(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix)
 {
+	PROFILE_SCOPE("Text::Render");
+
 	bool result;
 
-	//Draw the first sentence
-	result = RenderSentence(deviceContext, this->m_sentence, worldMatrix, orthoMatrix);
+	TextSentence* sentence;
+	int glyphCount;
+
+	//Start counting the bytes uploaded this frame
+	this->m_bytesUploaded = 0;
+	this->m_uploadCount = 0;
+
+	//Upload the glyphs of the sentences that changed since the last frame, the rest are already on the GPU
+	Text::UpdateBuffers(deviceContext);
+
+	//Every sentence lives in its own range of glyph slots so the draw only has to cover up to the end of the last sentence that has glyphs.
+	//The slots a sentence does not use hold degenerate quads, which lets every sentence still be drawn with a single call
+	glyphCount = 0;
+	for (int i = 0; i < this->m_sentenceCount; i++)
+	{
+		sentence = this->m_sentencePool.Get(this->m_sentences[i]);
+		if (sentence->GetGlyphCount() > 0 && sentence->GetFirstGlyph() + sentence->GetGlyphCount() > glyphCount)
+		{
+			glyphCount = sentence->GetFirstGlyph() + sentence->GetGlyphCount();
+		}
+	}
+
+	//Nothing to draw
+	if (glyphCount == 0)
+	{
+		return true;
+	}
+
+	//Put the vertex and index buffers on the graphics pipeline to prepare them for drawing
+	Text::RenderBuffers(deviceContext);
+
+	//Render every sentence of the frame with a single draw call using the font shader
+	result = this->m_FontShader->Render(deviceContext, glyphCount * 6, worldMatrix, this->m_baseViewMatrix, orthoMatrix, this->m_Font->GetTexture(), this->m_Font->IsDistanceField());
 	if (!result)
 	{
 		return false;
@@ -115,95 +186,89 @@ bool Text::Render(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3
 	return true;
 }
 
-bool Text::InitializeSentence(SentenceType** sentence, int maxLength, ID3D11Device* device)
+bool Text::InitializeBuffers(ID3D11Device* device)
 {
 	HRESULT result;
 
-	VertexType* vertices;
 	UINT* indices;
-	
-	//Create a new sentence object
-	*sentence = new SentenceType();
-	if (!*sentence)
-	{
-		return false;
-	}
-
-	//Initialize the sentence buffers to null
-	(*sentence)->vertexBuffer = nullptr;
-	(*sentence)->indexBuffer = nullptr;
+	UINT indexCount;
 
-	//Set the maximum length of the sentence
-	(*sentence)->maxLength = maxLength;
-
-	//Set the number of vertices in the vertex array
-	(*sentence)->vertexCount = 6 * maxLength;
-
-	//Set the number of indices in the index array
-	(*sentence)->indexCount = (*sentence)->vertexCount;
-
-	//Create the vertex array
-	vertices = new VertexType[(*sentence)->vertexCount];
-	if (!vertices)
-	{
-		return false;
-	}
+	//Set the number of indices in the shared quad index array
+	indexCount = 6 * TEXT_MAX_GLYPHS;
 
 	//Create the index array
-	indices = new UINT[(*sentence)->indexCount];
+	indices = new UINT[indexCount];
 	if (!indices)
 	{
 		return false;
 	}
 
-	//Initialize vertex array to zeros at first
-	ZeroMemory(vertices, sizeof(VertexType) * (*sentence)->vertexCount);
+	//Every glyph quad is stored as its top left, bottom right, bottom left and top right corners
+	for (UINT i = 0; i < TEXT_MAX_GLYPHS; i++)
+	{
+		//First triangle in quad
+		indices[(i * 6) + 0] = (i * 4) + 0;
+		indices[(i * 6) + 1] = (i * 4) + 1;
+		indices[(i * 6) + 2] = (i * 4) + 2;
+
+		//Second triangle in quad
+		indices[(i * 6) + 3] = (i * 4) + 0;
+		indices[(i * 6) + 4] = (i * 4) + 3;
+		indices[(i * 6) + 5] = (i * 4) + 1;
+	}
 
-	//Initialize the index array
-	for (UINT i = 0; i < (*sentence)->indexCount; i++)
+	//Create the scratch array sentences are laid out into before they are compared with what is already uploaded
+	this->m_layout = new VertexType[4 * TEXT_MAX_GLYPHS];
+	if (!this->m_layout)
 	{
-		indices[i] = i;
+		return false;
 	}
 
+	//Every slot starts out as a degenerate quad with all four corners at the origin
+	ZeroMemory(this->m_layout, sizeof(VertexType) * 4 * TEXT_MAX_GLYPHS);
+
 	//Create the Vertex Buffer Descriptor
 	D3D11_BUFFER_DESC vertexBufferDesc;
 	ZeroMemory(&vertexBufferDesc, sizeof(D3D11_BUFFER_DESC));
 
-	//Set up the description of the dynamic vertex buffer
+	//Set up the description of the vertex buffer. It is only written with partial updates of the glyphs that changed so it does not need CPU access
 	vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vertexBufferDesc.ByteWidth = sizeof(VertexType) * (*sentence)->vertexCount;
-	vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	vertexBufferDesc.ByteWidth = sizeof(VertexType) * 4 * TEXT_MAX_GLYPHS;
+	vertexBufferDesc.CPUAccessFlags = 0;
 	vertexBufferDesc.MiscFlags = 0;
 	vertexBufferDesc.StructureByteStride = 0;
-	vertexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	vertexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
 
 	//Create the sub resource to map the data
 	D3D11_SUBRESOURCE_DATA vertexData;
 	ZeroMemory(&vertexData, sizeof(D3D11_SUBRESOURCE_DATA));
 
-	//Give the sub resource structure a pointer to the vertex data
-	vertexData.pSysMem = vertices;
+	//Give the sub-resource structure a pointer to the empty slots
+	vertexData.pSysMem = this->m_layout;
 	vertexData.SysMemPitch = 0;
 	vertexData.SysMemSlicePitch = 0;
 
 	//Create the vertex buffer
-	result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &(*sentence)->vertexBuffer);
+	result = device->CreateBuffer(&vertexBufferDesc, &vertexData, &this->m_vertexBuffer);
 	if (FAILED(result))
 	{
 		return false;
 	}
 
+	//No glyph slots have been handed out to sentences yet
+	this->m_glyphsReserved = 0;
+
 	//Create the Index Buffer Descriptor
 	D3D11_BUFFER_DESC indexBufferDesc;
 	ZeroMemory(&indexBufferDesc, sizeof(D3D11_BUFFER_DESC));
 
 	//Setup the description of the static index buffer
 	indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	indexBufferDesc.ByteWidth = sizeof(UINT) * (*sentence)->indexCount;
+	indexBufferDesc.ByteWidth = sizeof(UINT) * indexCount;
 	indexBufferDesc.CPUAccessFlags = 0;
 	indexBufferDesc.MiscFlags = 0;
 	indexBufferDesc.StructureByteStride = 0;
-	indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	indexBufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
 
 	//Create the sub resource to map the data
 	D3D11_SUBRESOURCE_DATA indexData;
@@ -215,151 +280,195 @@ bool Text::InitializeSentence(SentenceType** sentence, int maxLength, ID3D11Devi
 	indexData.SysMemSlicePitch = 0;
 
 	//Create the index buffer
-	result = device->CreateBuffer(&indexBufferDesc, &indexData, &(*sentence)->indexBuffer);
+	result = device->CreateBuffer(&indexBufferDesc, &indexData, &this->m_indexBuffer);
 	if (FAILED(result))
 	{
 		return false;
 	}
 
-	delete[] vertices;
-	vertices = nullptr;
-
 	delete[] indices;
 	indices = nullptr;
 
 	return true;
 }
 
-bool Text::UpdateSentence(SentenceType* sentence, char* text, D3DXVECTOR2 position, D3DXCOLOR color, ID3D11DeviceContext* deviceContext)
+void Text::ShutdownBuffers()
 {
-	HRESULT result;
-
-	int numLetters;
-	VertexType* vertices;
-	VertexType* verticesPtr;
-	D3DXVECTOR2 drawPosition;
-
-	//Store the color of the sentence
-	sentence->red = color.r;
-	sentence->green = color.g;
-	sentence->blue = color.b;
-
-	//Get the number of letters in the sentence
-	numLetters = (int)strlen(text);
-
-	//Check for possible buffer overflow
-	if (numLetters > sentence->maxLength)
+	//Release the index buffer
+	if (this->m_indexBuffer)
 	{
-		return false;
+		this->m_indexBuffer->Release();
+		this->m_indexBuffer = nullptr;
 	}
 
-	//Create the vertex array
-	vertices = new VertexType[sentence->vertexCount];
-	if (!vertices)
+	//Release the vertex buffer
+	if (this->m_vertexBuffer)
 	{
-		return false;
+		this->m_vertexBuffer->Release();
+		this->m_vertexBuffer = nullptr;
 	}
 
-	//Initialize vertex array to zeros at first
-	ZeroMemory(vertices, sizeof(VertexType) * sentence->vertexCount);
-
-	//Calculate the X and Y pixel position on the screen to start drawing to.
-	drawPosition.x = (float)(((this->m_screenWidth / 2) * -1) + position.x);
-	drawPosition.y = (float)((this->m_screenHeight / 2) - position.y);
-
-	//Use the font class to build the vertex array from the sentence text and sentence draw location
-	this->m_Font->BuildVertexArray((void*)vertices, text, drawPosition);
-
-	//MappedSubresource to write the data on the video card memory
-	D3D11_MAPPED_SUBRESOURCE mappedSubresource;
-	ZeroMemory(&mappedSubresource, sizeof(D3D11_MAPPED_SUBRESOURCE));
-
-	//Lock the vertex buffer so it can be written to
-	result = deviceContext->Map(sentence->vertexBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
-	if (FAILED(result))
+	//Release the layout scratch array
+	if (this->m_layout)
 	{
-		return false;
+		delete[] this->m_layout;
+		this->m_layout = nullptr;
 	}
+}
 
-	//Get a pointer to the data in the vertex buffer
-	verticesPtr = (VertexType*)mappedSubresource.pData;
-	
-	//Copy the data into the vertex buffer
-	memcpy(verticesPtr, (void*)vertices, sizeof(VertexType)*sentence->vertexCount);
+void Text::UpdateBuffers(ID3D11DeviceContext* deviceContext)
+{
+	PROFILE_SCOPE("Text::UpdateBuffers");
 
-	//Unlock the vertex buffer
-	deviceContext->Unmap(sentence->vertexBuffer, 0);
+	TextSentence* sentence;
+	const void* vertices;
 
-	//Release the vertex array as it is no longer needed
-	delete[] vertices;
-	vertices = nullptr;
+	D3D11_BOX destinationBox;
+	ZeroMemory(&destinationBox, sizeof(D3D11_BOX));
 
-	return true;
-}
+	//A buffer is one dimensional so the box only selects a byte range along x
+	destinationBox.top = 0;
+	destinationBox.bottom = 1;
+	destinationBox.front = 0;
+	destinationBox.back = 1;
 
-void Text::ReleaseSentence(SentenceType** sentence)
-{
-	if (*sentence)
+	for (int i = 0; i < this->m_sentenceCount; i++)
 	{
-		//Release the sentence vertex buffer
-		if ((*sentence)->vertexBuffer)
-		{
-			(*sentence)->vertexBuffer->Release();
-			(*sentence)->vertexBuffer = nullptr;
-		}
+		sentence = this->m_sentencePool.Get(this->m_sentences[i]);
 
-		//Release the sentence index buffer
-		if ((*sentence)->indexBuffer)
+		//Skip the sentences whose glyphs are all already on the GPU
+		if (!sentence->GetDirtyRange(destinationBox.left, destinationBox.right, vertices))
 		{
-			(*sentence)->indexBuffer->Release();
-			(*sentence)->indexBuffer = nullptr;
+			continue;
 		}
 
-		//Release the sentence
-		delete *sentence;
-		*sentence = nullptr;
+		//Copy just the dirty range of glyphs into the sentence's slots
+		deviceContext->UpdateSubresource(this->m_vertexBuffer, 0, &destinationBox, vertices, 0, 0);
+
+		//Keep count of what was uploaded
+		this->m_bytesUploaded += destinationBox.right - destinationBox.left;
+		this->m_uploadCount++;
+
+		//The sentence is clean again
+		sentence->ClearDirty();
 	}
+
+	//Record what the frame uploaded next to the scopes
+	PROFILE_COUNTER("Text bytes uploaded", this->m_bytesUploaded);
+	PROFILE_COUNTER("Text uploads", this->m_uploadCount);
 }
 
-bool Text::RenderSentence(ID3D11DeviceContext* deviceContext, SentenceType* sentence, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix)
+void Text::RenderBuffers(ID3D11DeviceContext* deviceContext)
 {
-	bool result;
-
 	UINT stride;
 	UINT offset;
-	
+
 	//Set the vertex buffer stride and offset
 	stride = sizeof(VertexType);
 	offset = 0;
 
 	//Set the vertex buffer to active in the input assembler so it can be rendered
-	deviceContext->IASetVertexBuffers(0, 1, &sentence->vertexBuffer, &stride, &offset);
+	deviceContext->IASetVertexBuffers(0, 1, &this->m_vertexBuffer, &stride, &offset);
 
 	//Set the index buffer to active in the input assembler so it can be rendered
-	deviceContext->IASetIndexBuffer(sentence->indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetIndexBuffer(this->m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
 
 	//Set the type of primitive that should be rendered from this vertex buffer, in this case triangles
 	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+bool Text::InitializeSentence(ObjectHandle<TextSentence>* sentence, int maxLength)
+{
+	TextSentence* newSentence;
+	bool result;
+
+	//Check there are enough glyph slots left in the vertex buffer for the sentence
+	if (this->m_glyphsReserved + maxLength > TEXT_MAX_GLYPHS)
+	{
+		return false;
+	}
+
+	//Create a new sentence object in the pool
+	*sentence = this->m_sentencePool.Create();
+	newSentence = this->m_sentencePool.Get(*sentence);
+	if (!newSentence)
+	{
+		return false;
+	}
+
+	//Reserve the sentence its own range of glyph slots in the vertex buffer
+	result = newSentence->Initialize(this->m_glyphsReserved, maxLength);
+	if (!result)
+	{
+		return false;
+	}
+	this->m_glyphsReserved += maxLength;
+
+	return true;
+}
 
-	//Create a pixel color vector with the input sentence color
-	D3DXCOLOR pixelColor = D3DXCOLOR(sentence->red, sentence->green, sentence->blue, 1.0f);
+bool Text::UpdateSentence(TextSentence* sentence, char* text, D3DXVECTOR2 position, D3DXCOLOR color, float scale)
+{
+	PROFILE_SCOPE("Text::UpdateSentence");
 
-	//Render the text using the font shader
-	result = this->m_FontShader->Render(deviceContext, sentence->indexCount, worldMatrix, this->m_baseViewMatrix, orthoMatrix, this->m_Font->GetTexture(), pixelColor);
+	bool result;
+	bool changed;
+	int glyphCount;
+	D3DXVECTOR2 drawPosition;
+
+	//Store the string, position, color and scale, nothing is laid out again when they are the same as last time
+	result = sentence->SetText(text, position.x, position.y, &color.r, scale, changed);
 	if (!result)
 	{
 		return false;
 	}
+	if (!changed)
+	{
+		return true;
+	}
+
+	//Calculate the X and Y pixel position on the screen to start drawing to.
+	drawPosition.x = (float)(((this->m_screenWidth / 2) * -1) + position.x);
+	drawPosition.y = (float)((this->m_screenHeight / 2) - position.y);
+
+	//Use the font class to lay the sentence out from its text and draw location into the scratch array
+	glyphCount = this->m_Font->BuildVertexArray((void*)this->m_layout, text, (int)strlen(text), drawPosition, color, scale);
+
+	//Only the glyphs that differ from the cached layout are marked to be uploaded
+	sentence->SetLayout(this->m_layout, glyphCount);
+
 	return true;
 }
 
-bool Text::SetRenderCount(int renderCount, ID3D11DeviceContext* deviceContext)
+void Text::ReleaseSentence(ObjectHandle<TextSentence>* sentence)
+{
+	TextSentence* oldSentence;
+
+	oldSentence = this->m_sentencePool.Get(*sentence);
+	if (oldSentence)
+	{
+		//Release the cached string and layout
+		oldSentence->Shutdown();
+
+		//Release the sentence, the handle finds nothing from here on
+		this->m_sentencePool.Destroy(*sentence);
+		*sentence = ObjectPool<TextSentence>::GetNullHandle();
+	}
+}
+
+bool Text::SetRenderCount(int renderCount)
 {
 	bool result;
 
 	char tempString[32];
 	char countString[32];
 
+	//The count is usually the same as last frame, in which case there is nothing to format or compare
+	if (renderCount == this->m_renderCount)
+	{
+		return true;
+	}
+
 	//Convert the render count integer to string format
 	_itoa_s(renderCount, tempString, 10);
 
@@ -367,11 +476,13 @@ bool Text::SetRenderCount(int renderCount, ID3D11DeviceContext* deviceContext)
 	strcpy_s(countString, "Render Count: ");
 	strcat_s(countString, tempString);
 
-	//Update the sentence vertex buffer with the new string information
-	result = Text::UpdateSentence(this->m_sentence, countString, D3DXVECTOR2(20.0f, 20.0f), D3DXCOLOR(1.0f, 1.0f, 1.0f, 1.0f), deviceContext);
+	//Update the sentence layout with the new string information
+	result = Text::UpdateSentence(this->m_sentencePool.Get(this->m_sentences[0]), countString, D3DXVECTOR2(20.0f, 20.0f), D3DXCOLOR(1.0f, 1.0f, 1.0f, 1.0f), 1.0f);
 	if (!result)
 	{
 		return false;
 	}
+	this->m_renderCount = renderCount;
+
 	return true;
 }
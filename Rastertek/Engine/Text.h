@@ -9,6 +9,15 @@
 ///////////////////////
 #include "Font.h"
 #include "FontShader.h"
+#include "ObjectPool.h"
+#include "Profiler.h"
+#include "TextSentence.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int TEXT_MAX_SENTENCES = 16;
+const int TEXT_MAX_GLYPHS = 4096;
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Text
@@ -16,23 +25,7 @@
 class Text
 {
 private:
-	struct SentenceType
-	{
-		ID3D11Buffer* vertexBuffer;
-		ID3D11Buffer* indexBuffer;
-		UINT vertexCount;
-		UINT indexCount;
-		int maxLength;
-		float red;
-		float green;
-		float blue;
-	};
-
-	struct VertexType
-	{
-		D3DXVECTOR3 position;
-		D3DXVECTOR2 texture;
-	};
+	typedef TextSentence::VertexType VertexType;
 
 	Font* m_Font;
 	FontShader* m_FontShader;
@@ -40,23 +33,37 @@ private:
 	int m_screenHeight;
 	D3DXMATRIX m_baseViewMatrix;
 
-	SentenceType* m_sentence;
+	ID3D11Buffer* m_vertexBuffer;
+	ID3D11Buffer* m_indexBuffer;
+	VertexType* m_layout;
+	int m_glyphsReserved;
+
+	ObjectPool<TextSentence> m_sentencePool;
+	ObjectHandle<TextSentence> m_sentences[TEXT_MAX_SENTENCES];
+	int m_sentenceCount;
+	int m_renderCount;
+
+	UINT m_bytesUploaded;
+	UINT m_uploadCount;
 
 public:
 	Text();
 	Text(const Text& other);
 	~Text();
 
-	bool Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext, HWND hwnd, int screenWidth, int screenHeight, D3DXMATRIX baseViewMatrix);
+	bool Initialize(ID3D11Device* device, TextureManager* textureManager, HWND hwnd, int screenWidth, int screenHeight, D3DXMATRIX baseViewMatrix);
 	void Shutdown();
 	bool Render(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix);
 
-	bool SetRenderCount(int renderCount, ID3D11DeviceContext* deviceContext);
+	bool SetRenderCount(int renderCount);
 
 private:
-	bool InitializeSentence(SentenceType** sentence, int indexCount, ID3D11Device* device);
-	bool UpdateSentence(SentenceType* sentence, char* text, D3DXVECTOR2 position, D3DXCOLOR color, ID3D11DeviceContext* deviceContext);
-	void ReleaseSentence(SentenceType** sentece);
-	bool RenderSentence(ID3D11DeviceContext* deviceContext, SentenceType* sentence, D3DXMATRIX worldMatrix, D3DXMATRIX orthoMatrix);
+	bool InitializeBuffers(ID3D11Device* device);
+	void ShutdownBuffers();
+	void UpdateBuffers(ID3D11DeviceContext* deviceContext);
+	void RenderBuffers(ID3D11DeviceContext* deviceContext);
+	bool InitializeSentence(ObjectHandle<TextSentence>* sentence, int maxLength);
+	bool UpdateSentence(TextSentence* sentence, char* text, D3DXVECTOR2 position, D3DXCOLOR color, float scale);
+	void ReleaseSentence(ObjectHandle<TextSentence>* sentence);
 };
 #endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextSentence.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "TextSentence.h"
+
+
+TextSentence::TextSentence()
+{
+	this->m_vertices = nullptr;
+	this->m_text = nullptr;
+	this->m_maxLength = 0;
+	this->m_firstGlyph = 0;
+	this->m_glyphCount = 0;
+	this->m_dirtyFirst = 0;
+	this->m_dirtyLast = -1;
+	this->m_scale = 1.0f;
+}
+
+TextSentence::TextSentence(const TextSentence& other)
+{
+}
+
+
+TextSentence::~TextSentence()
+{
+}
+
+bool TextSentence::Initialize(int firstGlyph, int maxLength)
+{
+	//Store the maximum length of the sentence and the first of the glyph slots it owns in the vertex buffer
+	this->m_maxLength = maxLength;
+	this->m_firstGlyph = firstGlyph;
+
+	//The sentence starts out empty
+	this->m_glyphCount = 0;
+	this->m_dirtyFirst = maxLength;
+	this->m_dirtyLast = -1;
+	this->m_position[0] = 0.0f;
+	this->m_position[1] = 0.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		this->m_color[i] = 1.0f;
+	}
+	this->m_scale = 1.0f;
+
+	//Create the cached layout, four vertices for each glyph quad. This is the only allocation the sentence ever makes
+	this->m_vertices = new VertexType[4 * maxLength];
+	if (!this->m_vertices)
+	{
+		return false;
+	}
+
+	//It mirrors the sentence's slots in the vertex buffer which start out as degenerate quads
+	memset(this->m_vertices, 0, sizeof(VertexType) * 4 * maxLength);
+
+	//Create the cached copy of the string the layout was built from
+	this->m_text = new char[maxLength + 1];
+	if (!this->m_text)
+	{
+		return false;
+	}
+	this->m_text[0] = '\0';
+
+	return true;
+}
+
+void TextSentence::Shutdown()
+{
+	//Release the cached string
+	if (this->m_text)
+	{
+		delete[] this->m_text;
+		this->m_text = nullptr;
+	}
+
+	//Release the cached layout
+	if (this->m_vertices)
+	{
+		delete[] this->m_vertices;
+		this->m_vertices = nullptr;
+	}
+}
+
+bool TextSentence::SetText(const char* text, float positionX, float positionY, const float* color, float scale, bool& changed)
+{
+	int length;
+
+	changed = false;
+
+	//Check for possible buffer overflow
+	length = (int)strlen(text);
+	if (length > this->m_maxLength)
+	{
+		return false;
+	}
+
+	//If the string, position, color and scale have not changed then the cached layout is still valid
+	if (strcmp(this->m_text, text) == 0 && this->m_position[0] == positionX && this->m_position[1] == positionY && memcmp(this->m_color, color, sizeof(this->m_color)) == 0 && this->m_scale == scale)
+	{
+		return true;
+	}
+
+	//Store the string, position, color and scale the layout is built from
+	memcpy(this->m_text, text, length + 1);
+	this->m_position[0] = positionX;
+	this->m_position[1] = positionY;
+	memcpy(this->m_color, color, sizeof(this->m_color));
+	this->m_scale = scale;
+	changed = true;
+
+	return true;
+}
+
+void TextSentence::SetLayout(const void* vertices, int glyphCount)
+{
+	VertexType emptyQuad[4];
+	const VertexType* quad;
+	int compareCount;
+
+	//Glyphs past the new end of a sentence that got shorter are turned back into degenerate quads
+	memset(emptyQuad, 0, sizeof(emptyQuad));
+
+	//The layout may hold more quads than the sentence has slots, only the ones it owns are kept
+	if (glyphCount > this->m_maxLength)
+	{
+		glyphCount = this->m_maxLength;
+	}
+
+	compareCount = (glyphCount > this->m_glyphCount) ? glyphCount : this->m_glyphCount;
+	for (int i = 0; i < compareCount; i++)
+	{
+		quad = (i < glyphCount) ? (const VertexType*)vertices + (4 * i) : emptyQuad;
+		if (memcmp(this->m_vertices + (4 * i), quad, sizeof(VertexType) * 4) != 0)
+		{
+			memcpy(this->m_vertices + (4 * i), quad, sizeof(VertexType) * 4);
+
+			//Grow the dirty range to cover the glyph, it may already hold changes that have not been uploaded yet
+			if (i < this->m_dirtyFirst)
+			{
+				this->m_dirtyFirst = i;
+			}
+			if (i > this->m_dirtyLast)
+			{
+				this->m_dirtyLast = i;
+			}
+		}
+	}
+	this->m_glyphCount = glyphCount;
+}
+
+bool TextSentence::GetDirtyRange(unsigned int& left, unsigned int& right, const void*& vertices)
+{
+	//Nothing to upload when every glyph is already on the GPU
+	if (this->m_dirtyFirst > this->m_dirtyLast)
+	{
+		return false;
+	}
+
+	left = (unsigned int)(sizeof(VertexType) * 4 * (this->m_firstGlyph + this->m_dirtyFirst));
+	right = (unsigned int)(sizeof(VertexType) * 4 * (this->m_firstGlyph + this->m_dirtyLast + 1));
+	vertices = this->m_vertices + (4 * this->m_dirtyFirst);
+
+	return true;
+}
+
+void TextSentence::ClearDirty()
+{
+	this->m_dirtyFirst = this->m_maxLength;
+	this->m_dirtyLast = -1;
+}
+
+int TextSentence::GetFirstGlyph()
+{
+	return this->m_firstGlyph;
+}
+
+int TextSentence::GetGlyphCount()
+{
+	return this->m_glyphCount;
+}
+
+int TextSentence::GetMaxLength()
+{
+	return this->m_maxLength;
+}
\ No newline at end of file
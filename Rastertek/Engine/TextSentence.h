@@ -0,0 +1,65 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextSentence.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TEXTSENTENCE_H_
+#define _TEXTSENTENCE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <cstring>
+using namespace std;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TextSentence
+////////////////////////////////////////////////////////////////////////////////
+
+//The cached layout of one sentence and the range of its glyphs that changed since it was last uploaded
+//Nothing here is tied to a device, the sentence's slots in the shared vertex buffer are only a glyph index
+class TextSentence
+{
+public:
+	//Laid out like the position, texture and color the font shader reads
+	struct VertexType
+	{
+		float position[3];
+		float texture[2];
+		float color[4];
+	};
+
+private:
+	VertexType* m_vertices;
+	char* m_text;
+	int m_maxLength;
+	int m_firstGlyph;
+	int m_glyphCount;
+	int m_dirtyFirst;
+	int m_dirtyLast;
+	float m_position[2];
+	float m_color[4];
+	float m_scale;
+
+public:
+	TextSentence();
+	TextSentence(const TextSentence& other);
+	~TextSentence();
+
+	bool Initialize(int firstGlyph, int maxLength);
+	void Shutdown();
+
+	//Keeps the string and where it is drawn, changed is false when they are what the cached layout was built from
+	bool SetText(const char* text, float positionX, float positionY, const float* color, float scale, bool& changed);
+
+	//Compares a new layout with the cached one quad by quad and grows the dirty range over the quads that differ
+	void SetLayout(const void* vertices, int glyphCount);
+
+	//The bytes of the vertex buffer the dirty glyphs go to and the vertices to copy there, false when nothing changed
+	bool GetDirtyRange(unsigned int& left, unsigned int& right, const void*& vertices);
+	void ClearDirty();
+
+	int GetFirstGlyph();
+	int GetGlyphCount();
+	int GetMaxLength();
+};
+
+#endif
\ No newline at end of file
@@ -6,7 +6,12 @@
 
 Texture::Texture()
 {
+	this->m_resource = nullptr;
 	this->m_texture = nullptr;
+	this->m_DdsFile = nullptr;
+	this->m_mipCount = 0;
+	this->m_residentMip = 0;
+	this->m_memorySize = 0;
 }
 
 Texture::Texture(const Texture& other)
@@ -19,29 +24,334 @@ Texture::~Texture()
 
 bool Texture::Initialize(ID3D11Device* device, WCHAR* fileName)
 {
-	HRESULT result;
+	bool result;
 
-	//Load the texture in
-	result = D3DX11CreateShaderResourceViewFromFile(device, fileName, nullptr, nullptr, &this->m_texture, nullptr);
-	if (FAILED(result))
+	//Map the file in
+	result = Texture::LoadFile(fileName);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Create the texture with every mip uploaded straight out of the mapping
+	result = Texture::CreateTexture(device, true);
+	if (!result)
+	{
+		return false;
+	}
+
+	//The file is not needed once the texture holds all of it
+	this->m_DdsFile->Shutdown();
+	delete this->m_DdsFile;
+	this->m_DdsFile = nullptr;
+
+	return true;
+}
+
+bool Texture::Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext, WCHAR* fileName, int residentMips)
+{
+	bool result;
+
+	//Map the file in
+	result = Texture::LoadFile(fileName);
+	if (!result)
 	{
 		return false;
 	}
 
+	//A single mip has nothing to stream, it is loaded whole so the rest of its chain can be generated
+	if (this->m_mipCount == 1)
+	{
+		result = Texture::CreateTexture(device, true);
+
+		this->m_DdsFile->Shutdown();
+		delete this->m_DdsFile;
+		this->m_DdsFile = nullptr;
+
+		return result;
+	}
+
+	//Create the texture empty, the mips are uploaded from the smallest up
+	result = Texture::CreateTexture(device, false);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Keep at least the smallest mip resident so the texture can always be sampled
+	if (residentMips < 1)
+	{
+		residentMips = 1;
+	}
+
+	this->m_residentMip = this->m_mipCount;
+	Texture::StreamMips(deviceContext, residentMips);
+
 	return true;
 }
 
 void Texture::Shutdown()
 {
+	//Release the file if the texture was still streaming
+	if (this->m_DdsFile)
+	{
+		this->m_DdsFile->Shutdown();
+		delete this->m_DdsFile;
+		this->m_DdsFile = nullptr;
+	}
+
 	// Release the ID3D11ShaderResourceView.
 	if (this->m_texture)
 	{
 		this->m_texture->Release();
 		this->m_texture = nullptr;
 	}
+
+	//Release the texture resource
+	if (this->m_resource)
+	{
+		this->m_resource->Release();
+		this->m_resource = nullptr;
+	}
+}
+
+bool Texture::StreamMips(ID3D11DeviceContext* deviceContext, int count)
+{
+	if (!this->m_DdsFile)
+	{
+		return false;
+	}
+
+	//Upload the next finer mips in place
+	while (count > 0 && this->m_residentMip > 0)
+	{
+		this->m_residentMip--;
+		Texture::UploadMip(deviceContext, this->m_residentMip);
+		count--;
+	}
+
+	//Stop the sampler from reading the mips that are not uploaded yet
+	deviceContext->SetResourceMinLOD(this->m_resource, (FLOAT)this->m_residentMip);
+
+	//Close the file once the whole chain is resident
+	if (this->m_residentMip == 0)
+	{
+		this->m_DdsFile->Shutdown();
+		delete this->m_DdsFile;
+		this->m_DdsFile = nullptr;
+	}
+
+	return true;
 }
 
 ID3D11ShaderResourceView* Texture::GetTexture()
 {
 	return this->m_texture;
+}
+
+int Texture::GetMipCount()
+{
+	return this->m_mipCount;
+}
+
+int Texture::GetResidentMip()
+{
+	return this->m_residentMip;
+}
+
+bool Texture::IsFullyResident()
+{
+	return this->m_residentMip == 0;
+}
+
+UINT64 Texture::GetMemorySize()
+{
+	return this->m_memorySize;
+}
+
+bool Texture::LoadFile(WCHAR* fileName)
+{
+	bool result;
+
+	//Create the dds file object
+	this->m_DdsFile = new DdsFile;
+	if (!this->m_DdsFile)
+	{
+		return false;
+	}
+
+	//Map the file and read its headers
+	result = this->m_DdsFile->Initialize(fileName);
+	if (!result)
+	{
+		delete this->m_DdsFile;
+		this->m_DdsFile = nullptr;
+		return false;
+	}
+
+	this->m_mipCount = (int)this->m_DdsFile->GetMipCount();
+	this->m_residentMip = 0;
+
+	return true;
+}
+
+bool Texture::CreateTexture(ID3D11Device* device, bool uploadAll)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
+	D3D11_SUBRESOURCE_DATA* initialData;
+	ID3D11DeviceContext* deviceContext;
+	HRESULT result;
+	UINT formatSupport;
+	bool generateMips;
+	const void* data;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int arraySize;
+	unsigned int mipCount;
+	unsigned int width;
+	unsigned int height;
+
+	arraySize = this->m_DdsFile->GetArraySize();
+	mipCount = this->m_DdsFile->GetMipCount();
+
+	//A file with a single mip gets the rest of its chain generated on the GPU, as D3DX did, when the format can be rendered to
+	generateMips = false;
+	if (uploadAll && mipCount == 1)
+	{
+		result = device->CheckFormatSupport((DXGI_FORMAT)this->m_DdsFile->GetFormat(), &formatSupport);
+		generateMips = SUCCEEDED(result) && (formatSupport & D3D11_FORMAT_SUPPORT_MIP_AUTOGEN) != 0;
+	}
+
+	//Setup the texture description from the file headers. A generated chain goes all the way down and is rendered into, so it can not be immutable
+	textureDesc.Width = this->m_DdsFile->GetWidth();
+	textureDesc.Height = this->m_DdsFile->GetHeight();
+	textureDesc.MipLevels = generateMips ? 0 : mipCount;
+	textureDesc.ArraySize = arraySize;
+	textureDesc.Format = (DXGI_FORMAT)this->m_DdsFile->GetFormat();
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = (uploadAll && !generateMips) ? D3D11_USAGE_IMMUTABLE : D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | (generateMips ? D3D11_BIND_RENDER_TARGET : 0);
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = (this->m_DdsFile->IsCubeMap() ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0) | (generateMips ? D3D11_RESOURCE_MISC_GENERATE_MIPS : 0);
+
+	//Add up the size of every surface so the video memory the texture takes can be tracked
+	this->m_memorySize = 0;
+	for (unsigned int i = 0; i < arraySize; i++)
+	{
+		for (unsigned int mip = 0; mip < mipCount; mip++)
+		{
+			this->m_DdsFile->GetSurface(i, mip, data, rowPitch, slicePitch, width, height);
+			this->m_memorySize += slicePitch;
+		}
+	}
+
+	//The generated chain only has the top level in the file, it can not be handed over as initial data
+	initialData = nullptr;
+	if (uploadAll && !generateMips)
+	{
+		//The subresources are ordered slice by slice like the file so the mapping is passed in as it is
+		initialData = new D3D11_SUBRESOURCE_DATA[arraySize * mipCount];
+		if (!initialData)
+		{
+			return false;
+		}
+
+		for (unsigned int i = 0; i < arraySize; i++)
+		{
+			for (unsigned int mip = 0; mip < mipCount; mip++)
+			{
+				D3D11_SUBRESOURCE_DATA* subresource = &initialData[(i * mipCount) + mip];
+				this->m_DdsFile->GetSurface(i, mip, subresource->pSysMem, subresource->SysMemPitch, subresource->SysMemSlicePitch, width, height);
+			}
+		}
+	}
+
+	//Create the texture
+	result = device->CreateTexture2D(&textureDesc, initialData, &this->m_resource);
+	if (initialData)
+	{
+		delete[] initialData;
+		initialData = nullptr;
+	}
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//The generated levels are counted in the chain and in the memory the texture takes, with the texel size of the top level
+	if (generateMips)
+	{
+		this->m_resource->GetDesc(&textureDesc);
+		this->m_mipCount = (int)textureDesc.MipLevels;
+		this->m_DdsFile->GetSurface(0, 0, data, rowPitch, slicePitch, width, height);
+		for (unsigned int mip = 1; mip < textureDesc.MipLevels; mip++)
+		{
+			width = (textureDesc.Width >> mip) > 0 ? (textureDesc.Width >> mip) : 1;
+			height = (textureDesc.Height >> mip) > 0 ? (textureDesc.Height >> mip) : 1;
+			this->m_memorySize += (UINT64)width * height * (rowPitch / textureDesc.Width) * arraySize;
+		}
+	}
+
+	//Setup the description of the shader resource view over the whole chain
+	shaderResourceViewDesc.Format = textureDesc.Format;
+	if (this->m_DdsFile->IsCubeMap())
+	{
+		shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
+		shaderResourceViewDesc.TextureCube.MostDetailedMip = 0;
+		shaderResourceViewDesc.TextureCube.MipLevels = -1;
+	}
+	else if (arraySize > 1)
+	{
+		shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+		shaderResourceViewDesc.Texture2DArray.MostDetailedMip = 0;
+		shaderResourceViewDesc.Texture2DArray.MipLevels = -1;
+		shaderResourceViewDesc.Texture2DArray.FirstArraySlice = 0;
+		shaderResourceViewDesc.Texture2DArray.ArraySize = arraySize;
+	}
+	else
+	{
+		shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+		shaderResourceViewDesc.Texture2D.MostDetailedMip = 0;
+		shaderResourceViewDesc.Texture2D.MipLevels = -1;
+	}
+
+	//Create the shader resource view
+	result = device->CreateShaderResourceView(this->m_resource, &shaderResourceViewDesc, &this->m_texture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Upload the top level of every slice and have the GPU filter it down the chain
+	if (generateMips)
+	{
+		device->GetImmediateContext(&deviceContext);
+		for (unsigned int i = 0; i < arraySize; i++)
+		{
+			this->m_DdsFile->GetSurface(i, 0, data, rowPitch, slicePitch, width, height);
+			deviceContext->UpdateSubresource(this->m_resource, D3D11CalcSubresource(0, i, textureDesc.MipLevels), nullptr, data, rowPitch, slicePitch);
+		}
+		deviceContext->GenerateMips(this->m_texture);
+		deviceContext->Release();
+	}
+
+	return true;
+}
+
+void Texture::UploadMip(ID3D11DeviceContext* deviceContext, int mip)
+{
+	const void* data;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+
+	//Copy the mip of every slice from the mapping into the texture
+	for (unsigned int i = 0; i < this->m_DdsFile->GetArraySize(); i++)
+	{
+		this->m_DdsFile->GetSurface(i, mip, data, rowPitch, slicePitch, width, height);
+		deviceContext->UpdateSubresource(this->m_resource, D3D11CalcSubresource(mip, i, this->m_mipCount), nullptr, data, rowPitch, slicePitch);
+	}
 }
\ No newline at end of file
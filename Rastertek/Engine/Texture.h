@@ -9,7 +9,11 @@
 //////////////
 #include <d3d11.h>
 #include <dxgi.h>
-#include <d3dx11tex.h>
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "DdsFile.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // Class name: Texture
@@ -17,7 +21,12 @@
 class Texture
 {
 private:
+	ID3D11Texture2D* m_resource;
 	ID3D11ShaderResourceView* m_texture;
+	DdsFile* m_DdsFile;
+	int m_mipCount;
+	int m_residentMip;
+	UINT64 m_memorySize;
 
 public:
 	Texture();
@@ -25,8 +34,20 @@ public:
 	~Texture();
 
 	bool Initialize(ID3D11Device* device, WCHAR* fileName);
+	bool Initialize(ID3D11Device* device, ID3D11DeviceContext* deviceContext, WCHAR* fileName, int residentMips);
 	void Shutdown();
 
+	bool StreamMips(ID3D11DeviceContext* deviceContext, int count);
+
 	ID3D11ShaderResourceView* GetTexture();
+	int GetMipCount();
+	int GetResidentMip();
+	bool IsFullyResident();
+	UINT64 GetMemorySize();
+
+private:
+	bool LoadFile(WCHAR* fileName);
+	bool CreateTexture(ID3D11Device* device, bool uploadAll);
+	void UploadMip(ID3D11DeviceContext* deviceContext, int mip);
 };
 #endif
\ No newline at end of file
@@ -2,13 +2,17 @@
 // Filename: TextureArray.cpp
 ////////////////////////////////////////////////////////////////////////////////
 #include "TextureArray.h"
+#include <cwctype>
 
 
 TextureArray::TextureArray()
 {
-	this->m_textures[0] = nullptr;
-	this->m_textures[1] = nullptr;
-	this->m_textures[2] = nullptr;
+	this->m_resource = nullptr;
+	this->m_texture = nullptr;
+	this->m_width = 0;
+	this->m_height = 0;
+	this->m_mipCount = 0;
+	this->m_memorySize = 0;
 }
 
 TextureArray::TextureArray(const TextureArray& other)
@@ -20,57 +24,216 @@ TextureArray::~TextureArray()
 {
 }
 
-bool TextureArray::Initialize(ID3D11Device* device, WCHAR* baseTextureFileName, WCHAR* bumpMapTextureFileName, WCHAR* specularMapTextureFileName)
+bool TextureArray::Initialize(ID3D11Device* device, WCHAR** fileNames, int fileCount)
 {
-	HRESULT result;
+	bool result;
+	TextureArrayPacker packer;
+	vector<DdsFile*> files;
+	wstring key;
+	int slice;
 
-	//Load the first texture in
-	result = D3DX11CreateShaderResourceViewFromFile(device, baseTextureFileName, nullptr, nullptr, &this->m_textures[0], nullptr);
-	if (FAILED(result))
+	//Every image becomes a slice of one Texture2DArray, so materials pick their texture with a slice index
+	result = packer.Initialize(TEXTURE_ARRAY_MAX_SLICES);
+	if (!result)
 	{
 		return false;
 	}
 
-	//Load the second texture in
-	result = D3DX11CreateShaderResourceViewFromFile(device, bumpMapTextureFileName, nullptr, nullptr, &this->m_textures[1], nullptr);
-	if (FAILED(result))
+	for (int i = 0; i < fileCount && result; i++)
 	{
-		return false;
+		//The same file listed twice shares its slice
+		key = TextureArray::BuildKey(fileNames[i]);
+		if (TextureArray::GetSlice(fileNames[i]) >= 0)
+		{
+			continue;
+		}
+
+		//Map the file in, it has to stay open until the texture has been created from it
+		files.push_back(new DdsFile);
+		result = files.back() && files.back()->Initialize(fileNames[i]);
+		if (!result)
+		{
+			break;
+		}
+
+		//Check the image against the others and add its slices
+		slice = packer.AddImage(files.back());
+		if (slice < 0)
+		{
+			result = false;
+			break;
+		}
+
+		//Only the first slice is named after the file, the other elements of an array in it follow that slice unnamed
+		this->m_sliceNames.resize(packer.GetSliceCount());
+		this->m_sliceNames[slice] = key;
 	}
 
-	//Load the third texture in
-	result = D3DX11CreateShaderResourceViewFromFile(device, specularMapTextureFileName, nullptr, nullptr, &this->m_textures[2], nullptr);
-	if (FAILED(result))
+	//Create the texture array from every slice
+	if (result)
 	{
-		return false;
+		result = TextureArray::CreateTexture(device, &packer);
 	}
 
-	return true;
+	//Release the files, the texture holds its own copy of the data
+	packer.Shutdown();
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (files[i])
+		{
+			files[i]->Shutdown();
+			delete files[i];
+		}
+	}
+
+	return result;
 }
 
 void TextureArray::Shutdown()
 {
-	//Release the texture resource
-	if (this->m_textures[0])
+	//Release the texture view
+	if (this->m_texture)
+	{
+		this->m_texture->Release();
+		this->m_texture = nullptr;
+	}
+
+	//Release the texture
+	if (this->m_resource)
+	{
+		this->m_resource->Release();
+		this->m_resource = nullptr;
+	}
+
+	this->m_sliceNames.clear();
+}
+
+ID3D11ShaderResourceView* TextureArray::GetTexture()
+{
+	return this->m_texture;
+}
+
+int TextureArray::GetSlice(WCHAR* fileName)
+{
+	wstring key;
+
+	//Look the file up by the same key it was added with, an empty name would match the unnamed slices of an array
+	key = TextureArray::BuildKey(fileName);
+	if (key.empty())
+	{
+		return -1;
+	}
+	for (size_t i = 0; i < this->m_sliceNames.size(); i++)
+	{
+		if (this->m_sliceNames[i] == key)
+		{
+			return (int)i;
+		}
+	}
+
+	return -1;
+}
+
+int TextureArray::GetSliceCount()
+{
+	return (int)this->m_sliceNames.size();
+}
+
+unsigned int TextureArray::GetWidth()
+{
+	return this->m_width;
+}
+
+unsigned int TextureArray::GetHeight()
+{
+	return this->m_height;
+}
+
+unsigned int TextureArray::GetMipCount()
+{
+	return this->m_mipCount;
+}
+
+unsigned long long TextureArray::GetMemorySize()
+{
+	return this->m_memorySize;
+}
+
+bool TextureArray::CreateTexture(ID3D11Device* device, TextureArrayPacker* packer)
+{
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
+	vector<TextureArrayPacker::SubresourceType> subresources;
+	vector<D3D11_SUBRESOURCE_DATA> initialData;
+	HRESULT result;
+
+	//Get the surfaces of every slice in the order Direct3D expects them
+	if (!packer->GetSubresources(subresources))
 	{
-		this->m_textures[0]->Release();
-		this->m_textures[0] = nullptr;
+		return false;
 	}
 
-	if (this->m_textures[1])
+	initialData.resize(subresources.size());
+	for (size_t i = 0; i < subresources.size(); i++)
 	{
-		this->m_textures[1]->Release();
-		this->m_textures[1] = nullptr;
+		initialData[i].pSysMem = subresources[i].data;
+		initialData[i].SysMemPitch = subresources[i].rowPitch;
+		initialData[i].SysMemSlicePitch = subresources[i].slicePitch;
 	}
 
-	if (this->m_textures[2])
+	this->m_width = packer->GetWidth();
+	this->m_height = packer->GetHeight();
+	this->m_mipCount = packer->GetMipCount();
+	this->m_memorySize = packer->GetMemorySize();
+
+	//Setup the texture description, the slices never change so the array is immutable
+	textureDesc.Width = this->m_width;
+	textureDesc.Height = this->m_height;
+	textureDesc.MipLevels = this->m_mipCount;
+	textureDesc.ArraySize = packer->GetSliceCount();
+	textureDesc.Format = (DXGI_FORMAT)packer->GetFormat();
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	textureDesc.CPUAccessFlags = 0;
+	textureDesc.MiscFlags = 0;
+
+	//Create the texture
+	result = device->CreateTexture2D(&textureDesc, &initialData[0], &this->m_resource);
+	if (FAILED(result))
 	{
-		this->m_textures[2]->Release();
-		this->m_textures[2] = nullptr;
+		return false;
 	}
+
+	//Setup the description of the shader resource view, always an array even with a single slice
+	shaderResourceViewDesc.Format = textureDesc.Format;
+	shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	shaderResourceViewDesc.Texture2DArray.MostDetailedMip = 0;
+	shaderResourceViewDesc.Texture2DArray.MipLevels = this->m_mipCount;
+	shaderResourceViewDesc.Texture2DArray.FirstArraySlice = 0;
+	shaderResourceViewDesc.Texture2DArray.ArraySize = textureDesc.ArraySize;
+
+	//Create the shader resource view
+	result = device->CreateShaderResourceView(this->m_resource, &shaderResourceViewDesc, &this->m_texture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
 }
 
-ID3D11ShaderResourceView** TextureArray::GetTextureArray()
+wstring TextureArray::BuildKey(WCHAR* fileName)
 {
-	return this->m_textures;
+	wstring key;
+
+	//Files are matched without case and with either kind of slash, like the texture manager does
+	key = fileName;
+	for (size_t i = 0; i < key.size(); i++)
+	{
+		key[i] = (key[i] == L'\\') ? L'/' : (WCHAR)towlower(key[i]);
+	}
+
+	return key;
 }
\ No newline at end of file
@@ -9,7 +9,16 @@
 // INCLUDES //
 //////////////
 #include <d3d11.h>
-#include <d3dx11tex.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "DdsFile.h"
+#include "TextureArrayPacker.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -18,17 +27,35 @@
 class TextureArray
 {
 private:
-	ID3D11ShaderResourceView* m_textures[3];
+	ID3D11Texture2D* m_resource;
+	ID3D11ShaderResourceView* m_texture;
+	vector<wstring> m_sliceNames;
+	unsigned int m_width;
+	unsigned int m_height;
+	unsigned int m_mipCount;
+	unsigned long long m_memorySize;
 
 public:
 	TextureArray();
 	TextureArray(const TextureArray& other);
 	~TextureArray();
 
-	bool Initialize(ID3D11Device* device, WCHAR* baseTextureFileName, WCHAR* bumpMapTextureFileName, WCHAR* specularMapTextureFileName);
+	bool Initialize(ID3D11Device* device, WCHAR** fileNames, int fileCount);
 	void Shutdown();
 
-	ID3D11ShaderResourceView** GetTextureArray();
+	ID3D11ShaderResourceView* GetTexture();
+
+	//The first slice of the file, the other elements of an array in the file are the slices after it
+	int GetSlice(WCHAR* fileName);
+	int GetSliceCount();
+	unsigned int GetWidth();
+	unsigned int GetHeight();
+	unsigned int GetMipCount();
+	unsigned long long GetMemorySize();
+
+private:
+	bool CreateTexture(ID3D11Device* device, TextureArrayPacker* packer);
+	static wstring BuildKey(WCHAR* fileName);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureArrayPacker.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "TextureArrayPacker.h"
+
+
+TextureArrayPacker::TextureArrayPacker()
+{
+	this->m_maxSlices = 0;
+	this->m_width = 0;
+	this->m_height = 0;
+	this->m_mipCount = 0;
+	this->m_format = DDS_FORMAT_UNKNOWN;
+}
+
+TextureArrayPacker::TextureArrayPacker(const TextureArrayPacker& other)
+{
+}
+
+TextureArrayPacker::~TextureArrayPacker()
+{
+}
+
+bool TextureArrayPacker::Initialize(unsigned int maxSlices)
+{
+	if (maxSlices == 0 || maxSlices > TEXTURE_ARRAY_MAX_SLICES)
+	{
+		return false;
+	}
+
+	this->m_maxSlices = maxSlices;
+	this->m_slices.clear();
+	this->m_slices.reserve(maxSlices);
+	this->m_width = 0;
+	this->m_height = 0;
+	this->m_mipCount = 0;
+	this->m_format = DDS_FORMAT_UNKNOWN;
+
+	return true;
+}
+
+void TextureArrayPacker::Shutdown()
+{
+	//The files belong to the caller, only the list of slices is dropped
+	this->m_slices.clear();
+}
+
+int TextureArrayPacker::AddImage(DdsFile* file)
+{
+	SliceType slice;
+	int firstSlice;
+
+	//Cube maps can not be a slice, an array in the file adds one slice for each of its elements
+	if (file->IsCubeMap())
+	{
+		return TEXTURE_ARRAY_ERROR_CUBE_MAP;
+	}
+	if (this->m_slices.size() + file->GetArraySize() > this->m_maxSlices)
+	{
+		return TEXTURE_ARRAY_ERROR_FULL;
+	}
+
+	//The first image sets the size and format every other slice has to match
+	if (this->m_slices.empty())
+	{
+		this->m_width = file->GetWidth();
+		this->m_height = file->GetHeight();
+		this->m_mipCount = file->GetMipCount();
+		this->m_format = file->GetFormat();
+	}
+	else
+	{
+		if (file->GetWidth() != this->m_width || file->GetHeight() != this->m_height)
+		{
+			return TEXTURE_ARRAY_ERROR_SIZE;
+		}
+		if (file->GetFormat() != this->m_format)
+		{
+			return TEXTURE_ARRAY_ERROR_FORMAT;
+		}
+
+		//Chains of different lengths are cut down to the shortest, the top levels are the same size
+		if (file->GetMipCount() < this->m_mipCount)
+		{
+			this->m_mipCount = file->GetMipCount();
+		}
+	}
+
+	firstSlice = (int)this->m_slices.size();
+	for (unsigned int i = 0; i < file->GetArraySize(); i++)
+	{
+		slice.file = file;
+		slice.arrayIndex = i;
+		this->m_slices.push_back(slice);
+	}
+
+	return firstSlice;
+}
+
+bool TextureArrayPacker::GetSubresources(vector<SubresourceType>& subresources)
+{
+	SubresourceType* subresource;
+	unsigned int width;
+	unsigned int height;
+	unsigned int expectedWidth;
+	unsigned int expectedHeight;
+
+	if (this->m_slices.empty())
+	{
+		return false;
+	}
+
+	//Direct3D orders array subresources slice by slice, each with its full chain
+	subresources.resize(this->m_slices.size() * this->m_mipCount);
+	for (size_t i = 0; i < this->m_slices.size(); i++)
+	{
+		for (unsigned int mip = 0; mip < this->m_mipCount; mip++)
+		{
+			subresource = &subresources[(i * this->m_mipCount) + mip];
+			if (!this->m_slices[i].file->GetSurface(this->m_slices[i].arrayIndex, mip, subresource->data, subresource->rowPitch, subresource->slicePitch, width, height))
+			{
+				return false;
+			}
+
+			//Every slice has to have the same surface at every level or the array can not be created
+			expectedWidth = (this->m_width >> mip) > 0 ? (this->m_width >> mip) : 1;
+			expectedHeight = (this->m_height >> mip) > 0 ? (this->m_height >> mip) : 1;
+			if (width != expectedWidth || height != expectedHeight || subresource->slicePitch != subresources[mip].slicePitch)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+unsigned int TextureArrayPacker::GetSliceCount()
+{
+	return (unsigned int)this->m_slices.size();
+}
+
+unsigned int TextureArrayPacker::GetWidth()
+{
+	return this->m_width;
+}
+
+unsigned int TextureArrayPacker::GetHeight()
+{
+	return this->m_height;
+}
+
+unsigned int TextureArrayPacker::GetMipCount()
+{
+	return this->m_mipCount;
+}
+
+unsigned int TextureArrayPacker::GetFormat()
+{
+	return this->m_format;
+}
+
+unsigned long long TextureArrayPacker::GetMemorySize()
+{
+	const void* data;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+	unsigned long long size;
+
+	//Every slice is the same size so one chain is added up and multiplied
+	size = 0;
+	if (!this->m_slices.empty())
+	{
+		for (unsigned int mip = 0; mip < this->m_mipCount; mip++)
+		{
+			this->m_slices[0].file->GetSurface(this->m_slices[0].arrayIndex, mip, data, rowPitch, slicePitch, width, height);
+			size += slicePitch;
+		}
+	}
+
+	return size * this->m_slices.size();
+}
\ No newline at end of file
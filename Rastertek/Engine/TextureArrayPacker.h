@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureArrayPacker.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TEXTUREARRAYPACKER_H_
+#define _TEXTUREARRAYPACKER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <vector>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "DdsFile.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned int TEXTURE_ARRAY_MAX_SLICES = 2048;
+
+//AddImage returns the first slice of the image or one of these
+const int TEXTURE_ARRAY_ERROR_CUBE_MAP = -1;
+const int TEXTURE_ARRAY_ERROR_SIZE = -2;
+const int TEXTURE_ARRAY_ERROR_FORMAT = -3;
+const int TEXTURE_ARRAY_ERROR_FULL = -4;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TextureArrayPacker
+////////////////////////////////////////////////////////////////////////////////
+class TextureArrayPacker
+{
+public:
+	//Matches D3D11_SUBRESOURCE_DATA so the list can be handed straight to CreateTexture2D
+	struct SubresourceType
+	{
+		const void* data;
+		unsigned int rowPitch;
+		unsigned int slicePitch;
+	};
+
+private:
+	struct SliceType
+	{
+		DdsFile* file;
+		unsigned int arrayIndex;
+	};
+
+	vector<SliceType> m_slices;
+	unsigned int m_maxSlices;
+	unsigned int m_width;
+	unsigned int m_height;
+	unsigned int m_mipCount;
+	unsigned int m_format;
+
+public:
+	TextureArrayPacker();
+	TextureArrayPacker(const TextureArrayPacker& other);
+	~TextureArrayPacker();
+
+	bool Initialize(unsigned int maxSlices);
+	void Shutdown();
+
+	int AddImage(DdsFile* file);
+	bool GetSubresources(vector<SubresourceType>& subresources);
+
+	unsigned int GetSliceCount();
+	unsigned int GetWidth();
+	unsigned int GetHeight();
+	unsigned int GetMipCount();
+	unsigned int GetFormat();
+	unsigned long long GetMemorySize();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureArrayPixelShader.hlsl
+////////////////////////////////////////////////////////////////////////////////
+
+/////////////
+// GLOBALS //
+/////////////
+Texture2DArray shaderTextures;
+SamplerState SampleType;
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct PixelInputType
+{
+	float4 position : SV_POSITION;
+	float2 tex : TEXCOORD0;
+	nointerpolation uint slice : TEXCOORD1;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Pixel Shader
+////////////////////////////////////////////////////////////////////////////////
+float4 main(PixelInputType input) : SV_TARGET
+{
+	float4 textureColor;
+
+	// Sample the slice of the texture array this instance uses at this texture coordinate location.
+	textureColor = shaderTextures.Sample(SampleType, float3(input.tex, input.slice));
+
+	return textureColor;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureArrayShader.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TEXTUREARRAYSHADER_H_
+#define _TEXTUREARRAYSHADER_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include <d3dx11async.h>
+#include <fstream>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "TextureArray.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int TEXTURE_ARRAY_MAX_INSTANCES = 1024;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TextureArrayShader
+////////////////////////////////////////////////////////////////////////////////
+class TextureArrayShader
+{
+public:
+	//Every instance of the model is moved by its position and textured with its slice of the array
+	struct InstanceType
+	{
+		D3DXVECTOR3 position;
+		UINT slice;
+	};
+
+private:
+	struct MatrixBufferType
+	{
+		D3DXMATRIX world;
+		D3DXMATRIX view;
+		D3DXMATRIX projection;
+	};
+
+	ID3D11VertexShader* m_vertexShader;
+	ID3D11PixelShader* m_pixelShader;
+	ID3D11InputLayout* m_layout;
+	ID3D11SamplerState* m_sampleState;
+	ID3D11Buffer* m_matrixBuffer;
+	ID3D11Buffer* m_instanceBuffer;
+
+public:
+	TextureArrayShader();
+	TextureArrayShader(const TextureArrayShader& other);
+	~TextureArrayShader();
+
+	bool Initialize(ID3D11Device* device, HWND hwnd);
+	void Shutdown();
+	bool Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, TextureArray* textureArray, const InstanceType* instances, int instanceCount);
+
+private:
+	bool InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename);
+	void ShutdownShader();
+	void OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename);
+
+	bool SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, TextureArray* textureArray);
+	bool RenderShader(ID3D11DeviceContext* deviceContext, int indexCount, const InstanceType* instances, int instanceCount);
+};
+#endif
\ No newline at end of file
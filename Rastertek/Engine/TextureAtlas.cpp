@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureAtlas.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "TextureAtlas.h"
+
+
+TextureAtlas::TextureAtlas()
+{
+	this->m_TextureManager = nullptr;
+	this->m_Texture = nullptr;
+	this->m_regions = nullptr;
+	this->m_regionCount = 0;
+}
+
+TextureAtlas::TextureAtlas(const TextureAtlas& other)
+{
+}
+
+
+TextureAtlas::~TextureAtlas()
+{
+}
+
+bool TextureAtlas::Initialize(ID3D11Device* device, TextureManager* textureManager, char* tableFilename, WCHAR* textureFilename)
+{
+	bool result;
+
+	//Load the table of where every image sits in the atlas
+	result = TextureAtlas::LoadTable(tableFilename);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Get the combined atlas texture from the texture manager
+	this->m_TextureManager = textureManager;
+	this->m_Texture = this->m_TextureManager->AcquireTexture(device, textureFilename);
+	if (!this->m_Texture)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void TextureAtlas::Shutdown()
+{
+	//Hand the texture back to the texture manager
+	if (this->m_Texture)
+	{
+		this->m_TextureManager->ReleaseTexture(this->m_Texture);
+		this->m_Texture = nullptr;
+	}
+
+	//Release the region table
+	TextureAtlas::ReleaseTable();
+}
+
+ID3D11ShaderResourceView* TextureAtlas::GetTexture()
+{
+	return this->m_Texture->GetTexture();
+}
+
+bool TextureAtlas::GetRegion(const char* name, D3DXVECTOR4& textureRect, int& width, int& height)
+{
+	//The regions are only looked up while setting things up so a linear search is enough
+	for (int i = 0; i < this->m_regionCount; i++)
+	{
+		if (strcmp(this->m_regions[i].name, name) == 0)
+		{
+			textureRect = this->m_regions[i].textureRect;
+			width = this->m_regions[i].width;
+			height = this->m_regions[i].height;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TextureAtlas::LoadTable(char* tableFilename)
+{
+	ifstream fIn;
+
+	//Open the table written by the atlas packer
+	fIn.open(tableFilename);
+	if (fIn.fail())
+	{
+		return false;
+	}
+
+	//Read in the number of regions
+	fIn >> this->m_regionCount;
+	if (fIn.fail() || this->m_regionCount < 0)
+	{
+		this->m_regionCount = 0;
+		return false;
+	}
+
+	//Create the region array
+	this->m_regions = new RegionType[this->m_regionCount];
+	if (!this->m_regions)
+	{
+		return false;
+	}
+
+	//Every line holds the image name, its left, top, right and bottom texture coordinates and its size in texels
+	for (int i = 0; i < this->m_regionCount; i++)
+	{
+		fIn.width(ATLAS_NAME_LENGTH);
+		fIn >> this->m_regions[i].name;
+		fIn >> this->m_regions[i].textureRect.x >> this->m_regions[i].textureRect.y >> this->m_regions[i].textureRect.z >> this->m_regions[i].textureRect.w;
+		fIn >> this->m_regions[i].width >> this->m_regions[i].height;
+		if (fIn.fail())
+		{
+			this->m_regionCount = i;
+			return false;
+		}
+	}
+
+	//Close the file
+	fIn.close();
+
+	return true;
+}
+
+void TextureAtlas::ReleaseTable()
+{
+	//Release the region array
+	if (this->m_regions)
+	{
+		delete[] this->m_regions;
+		this->m_regions = nullptr;
+	}
+	this->m_regionCount = 0;
+}
\ No newline at end of file
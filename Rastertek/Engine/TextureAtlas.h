@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureAtlas.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TEXTUREATLAS_H_
+#define _TEXTUREATLAS_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include <fstream>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "TextureManager.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int ATLAS_NAME_LENGTH = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TextureAtlas
+////////////////////////////////////////////////////////////////////////////////
+class TextureAtlas
+{
+private:
+	struct RegionType
+	{
+		char name[ATLAS_NAME_LENGTH];
+		D3DXVECTOR4 textureRect;
+		int width;
+		int height;
+	};
+
+	TextureManager* m_TextureManager;
+	Texture* m_Texture;
+	RegionType* m_regions;
+	int m_regionCount;
+
+public:
+	TextureAtlas();
+	TextureAtlas(const TextureAtlas& other);
+	~TextureAtlas();
+
+	bool Initialize(ID3D11Device* device, TextureManager* textureManager, char* tableFilename, WCHAR* textureFilename);
+	void Shutdown();
+
+	ID3D11ShaderResourceView* GetTexture();
+	bool GetRegion(const char* name, D3DXVECTOR4& textureRect, int& width, int& height);
+
+private:
+	bool LoadTable(char* tableFilename);
+	void ReleaseTable();
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,321 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureManager.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "TextureManager.h"
+
+
+TextureManager::TextureManager()
+{
+	this->m_budget = TEXTURE_DEFAULT_BUDGET;
+	this->m_residentBytes = 0;
+	this->m_peakResidentBytes = 0;
+	this->m_hitCount = 0;
+	this->m_missCount = 0;
+	this->m_evictionCount = 0;
+}
+
+TextureManager::TextureManager(const TextureManager& other)
+{
+}
+
+TextureManager::~TextureManager()
+{
+}
+
+bool TextureManager::Initialize(UINT64 budget)
+{
+	bool result;
+
+	//Set how many bytes of textures may stay loaded once nothing is using them
+	this->m_budget = budget;
+
+	result = this->m_texturePool.Initialize(TEXTURE_POOL_CAPACITY);
+	if (!result)
+	{
+		return false;
+	}
+
+	result = this->m_entryPool.Initialize(TEXTURE_POOL_CAPACITY);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void TextureManager::Shutdown()
+{
+	map<wstring, EntryType*>::iterator it;
+
+	//Release every texture, whether it is still in use or not
+	for (it = this->m_entries.begin(); it != this->m_entries.end(); ++it)
+	{
+		it->second->texture->Shutdown();
+		this->m_texturePool.Destroy(it->second->textureHandle);
+		this->m_entryPool.Destroy(it->second->entryHandle);
+	}
+
+	this->m_entries.clear();
+	this->m_textureEntries.clear();
+	this->m_idleEntries.clear();
+	this->m_residentBytes = 0;
+
+	this->m_entryPool.Shutdown();
+	this->m_texturePool.Shutdown();
+}
+
+Texture* TextureManager::AcquireTexture(ID3D11Device* device, WCHAR* fileName)
+{
+	PROFILE_SCOPE("TextureManager::AcquireTexture");
+
+	ObjectHandle<Texture> textureHandle;
+	Texture* texture;
+	wstring key;
+	bool result;
+
+	//Return the loaded copy if there is one
+	key = TextureManager::BuildKey(fileName, 0);
+	texture = TextureManager::FindTexture(key);
+	if (texture)
+	{
+		return texture;
+	}
+
+	//Create the texture object in the pool
+	textureHandle = this->m_texturePool.Create();
+	texture = this->m_texturePool.Get(textureHandle);
+	if (!texture)
+	{
+		return nullptr;
+	}
+
+	//Initialize the texture object
+	result = texture->Initialize(device, fileName);
+	if (!result)
+	{
+		texture->Shutdown();
+		this->m_texturePool.Destroy(textureHandle);
+		return nullptr;
+	}
+
+	return TextureManager::AddTexture(key, textureHandle);
+}
+
+Texture* TextureManager::AcquireTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, WCHAR* fileName, int residentMips)
+{
+	PROFILE_SCOPE("TextureManager::AcquireTexture");
+
+	ObjectHandle<Texture> textureHandle;
+	Texture* texture;
+	wstring key;
+	bool result;
+
+	//Streamed textures are kept apart from fully loaded ones of the same file
+	key = TextureManager::BuildKey(fileName, residentMips);
+	texture = TextureManager::FindTexture(key);
+	if (texture)
+	{
+		return texture;
+	}
+
+	//Create the texture object in the pool
+	textureHandle = this->m_texturePool.Create();
+	texture = this->m_texturePool.Get(textureHandle);
+	if (!texture)
+	{
+		return nullptr;
+	}
+
+	//Initialize the texture object with only the smallest mips uploaded
+	result = texture->Initialize(device, deviceContext, fileName, residentMips);
+	if (!result)
+	{
+		texture->Shutdown();
+		this->m_texturePool.Destroy(textureHandle);
+		return nullptr;
+	}
+
+	return TextureManager::AddTexture(key, textureHandle);
+}
+
+void TextureManager::ReleaseTexture(Texture* texture)
+{
+	map<Texture*, EntryType*>::iterator it;
+	EntryType* entry;
+
+	it = this->m_textureEntries.find(texture);
+	if (it == this->m_textureEntries.end())
+	{
+		return;
+	}
+
+	entry = it->second;
+	entry->refCount--;
+
+	//Textures nobody uses stay loaded in case they are asked for again, the most recently used at the back
+	if (entry->refCount == 0)
+	{
+		this->m_idleEntries.push_back(entry);
+		entry->idlePosition = --this->m_idleEntries.end();
+		TextureManager::EvictTextures();
+	}
+}
+
+void TextureManager::SetBudget(UINT64 budget)
+{
+	this->m_budget = budget;
+	TextureManager::EvictTextures();
+}
+
+UINT64 TextureManager::GetBudget()
+{
+	return this->m_budget;
+}
+
+UINT64 TextureManager::GetResidentBytes()
+{
+	return this->m_residentBytes;
+}
+
+UINT64 TextureManager::GetPeakResidentBytes()
+{
+	return this->m_peakResidentBytes;
+}
+
+int TextureManager::GetTextureCount()
+{
+	return (int)this->m_entries.size();
+}
+
+int TextureManager::GetHitCount()
+{
+	return this->m_hitCount;
+}
+
+int TextureManager::GetMissCount()
+{
+	return this->m_missCount;
+}
+
+int TextureManager::GetEvictionCount()
+{
+	return this->m_evictionCount;
+}
+
+wstring TextureManager::BuildKey(WCHAR* fileName, int residentMips)
+{
+	wstring key;
+
+	//File names are not case sensitive on Windows and either slash can be used
+	key = fileName;
+	for (size_t i = 0; i < key.size(); i++)
+	{
+		if (key[i] == L'\\')
+		{
+			key[i] = L'/';
+		}
+		else if (key[i] >= L'A' && key[i] <= L'Z')
+		{
+			key[i] = key[i] - L'A' + L'a';
+		}
+	}
+
+	//The load parameters are part of the key
+	key += L'|';
+	key += to_wstring((long long)residentMips);
+
+	return key;
+}
+
+Texture* TextureManager::FindTexture(const wstring& key)
+{
+	map<wstring, EntryType*>::iterator it;
+	EntryType* entry;
+
+	it = this->m_entries.find(key);
+	if (it == this->m_entries.end())
+	{
+		this->m_missCount++;
+		return nullptr;
+	}
+
+	this->m_hitCount++;
+
+	//Take the texture back out of the idle list so it can not be evicted while in use
+	entry = it->second;
+	if (entry->refCount == 0)
+	{
+		this->m_idleEntries.erase(entry->idlePosition);
+	}
+	entry->refCount++;
+
+	return entry->texture;
+}
+
+Texture* TextureManager::AddTexture(const wstring& key, ObjectHandle<Texture> textureHandle)
+{
+	ObjectHandle<EntryType> entryHandle;
+	EntryType* entry;
+	Texture* texture;
+
+	texture = this->m_texturePool.Get(textureHandle);
+
+	//Create the entry holding the first reference
+	entryHandle = this->m_entryPool.Create();
+	entry = this->m_entryPool.Get(entryHandle);
+	if (!entry)
+	{
+		texture->Shutdown();
+		this->m_texturePool.Destroy(textureHandle);
+		return nullptr;
+	}
+
+	entry->key = key;
+	entry->texture = texture;
+	entry->textureHandle = textureHandle;
+	entry->entryHandle = entryHandle;
+	entry->refCount = 1;
+
+	this->m_entries[key] = entry;
+	this->m_textureEntries[texture] = entry;
+
+	this->m_residentBytes += texture->GetMemorySize();
+	if (this->m_residentBytes > this->m_peakResidentBytes)
+	{
+		this->m_peakResidentBytes = this->m_residentBytes;
+	}
+
+	//Make room for the new texture
+	TextureManager::EvictTextures();
+
+	return texture;
+}
+
+void TextureManager::EvictTextures()
+{
+	PROFILE_SCOPE("TextureManager::EvictTextures");
+
+	EntryType* entry;
+
+	//Release the least recently used idle textures until the budget is met. Textures in use are never released
+	while (this->m_residentBytes > this->m_budget && !this->m_idleEntries.empty())
+	{
+		entry = this->m_idleEntries.front();
+		this->m_idleEntries.pop_front();
+		TextureManager::DestroyEntry(entry);
+		this->m_evictionCount++;
+	}
+}
+
+void TextureManager::DestroyEntry(EntryType* entry)
+{
+	this->m_residentBytes -= entry->texture->GetMemorySize();
+	this->m_entries.erase(entry->key);
+	this->m_textureEntries.erase(entry->texture);
+
+	//Release the texture object, then the entry, which takes the handles with it
+	entry->texture->Shutdown();
+	this->m_texturePool.Destroy(entry->textureHandle);
+	this->m_entryPool.Destroy(entry->entryHandle);
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: TextureManager.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _TEXTUREMANAGER_H_
+#define _TEXTUREMANAGER_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <d3d11.h>
+#include <string>
+#include <map>
+#include <list>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "Texture.h"
+#include "ObjectPool.h"
+#include "Profiler.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const UINT64 TEXTURE_DEFAULT_BUDGET = 256 * 1024 * 1024;
+
+//Textures and entries the pools make room for up front, they grow past it a page at a time
+const int TEXTURE_POOL_CAPACITY = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: TextureManager
+////////////////////////////////////////////////////////////////////////////////
+class TextureManager
+{
+private:
+	struct EntryType
+	{
+		wstring key;
+		Texture* texture;
+		ObjectHandle<Texture> textureHandle;
+		ObjectHandle<EntryType> entryHandle;
+		int refCount;
+		list<EntryType*>::iterator idlePosition;
+	};
+
+	//The textures and their entries live in pools, the pages never move so the pointers handed out stay good
+	ObjectPool<Texture> m_texturePool;
+	ObjectPool<EntryType> m_entryPool;
+
+	map<wstring, EntryType*> m_entries;
+	map<Texture*, EntryType*> m_textureEntries;
+	list<EntryType*> m_idleEntries;
+
+	UINT64 m_budget;
+	UINT64 m_residentBytes;
+	UINT64 m_peakResidentBytes;
+	int m_hitCount;
+	int m_missCount;
+	int m_evictionCount;
+
+public:
+	TextureManager();
+	TextureManager(const TextureManager& other);
+	~TextureManager();
+
+	bool Initialize(UINT64 budget);
+	void Shutdown();
+
+	Texture* AcquireTexture(ID3D11Device* device, WCHAR* fileName);
+	Texture* AcquireTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, WCHAR* fileName, int residentMips);
+	void ReleaseTexture(Texture* texture);
+
+	void SetBudget(UINT64 budget);
+	UINT64 GetBudget();
+	UINT64 GetResidentBytes();
+	UINT64 GetPeakResidentBytes();
+	int GetTextureCount();
+	int GetHitCount();
+	int GetMissCount();
+	int GetEvictionCount();
+
+private:
+	wstring BuildKey(WCHAR* fileName, int residentMips);
+	Texture* FindTexture(const wstring& key);
+	Texture* AddTexture(const wstring& key, ObjectHandle<Texture> textureHandle);
+	void EvictTextures();
+	void DestroyEntry(EntryType* entry);
+};
+
+#endif
\ No newline at end of file
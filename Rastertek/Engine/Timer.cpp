@@ -16,27 +16,33 @@ Timer::~Timer()
 
 bool Timer::Intialize()
 {
+#ifdef _WIN32
 	//Check to see if this system supports high performance timers
 	QueryPerformanceFrequency((LARGE_INTEGER*)&this->m_frequency);
 	if (this->m_frequency == 0)
 	{
 		return false;
 	}
+#else
+	//Without a window the steady clock counts in nanoseconds, so benchmarks can time frames headless
+	this->m_frequency = 1000000000;
+#endif
 
 	//Find out how many times the frequency counter ticks every millisecond
 	this->m_ticksPerMs = (float)(this->m_frequency / 1000);
 
-	QueryPerformanceCounter((LARGE_INTEGER*)&this->m_startTime);
+	this->m_startTime = Timer::GetCounter();
+	this->m_frameTime = 0.0f;
 
 	return true;
 }
 
 void Timer::Frame()
 {
-	INT64 currentTime;
+	long long currentTime;
 	float timeDifference;
 
-	QueryPerformanceCounter((LARGE_INTEGER*)&currentTime);
+	currentTime = Timer::GetCounter();
 
 	timeDifference = (float)(currentTime - this->m_startTime);
 	this->m_frameTime = timeDifference / this->m_ticksPerMs;
@@ -46,4 +52,16 @@ void Timer::Frame()
 float Timer::GetTime()
 {
 	return this->m_frameTime;
+}
+
+long long Timer::GetCounter()
+{
+#ifdef _WIN32
+	long long counter;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&counter);
+	return counter;
+#else
+	return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
 }
\ No newline at end of file
@@ -8,16 +8,20 @@
 //////////////
 // INCLUDES //
 //////////////
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <chrono>
+#endif
 
 #pragma once
 class Timer
 {
 private:
-	INT64 m_frequency;
-	FLOAT m_ticksPerMs;
-	INT64 m_startTime;
-	FLOAT m_frameTime;
+	long long m_frequency;
+	float m_ticksPerMs;
+	long long m_startTime;
+	float m_frameTime;
 
 public:
 	Timer();
@@ -28,6 +32,9 @@ public:
 	void Frame();
 
 	float GetTime();
+
+private:
+	long long GetCounter();
 };
 
 #endif
\ No newline at end of file
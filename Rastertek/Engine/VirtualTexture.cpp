@@ -0,0 +1,550 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTexture.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "VirtualTexture.h"
+#include <algorithm>
+#include <cmath>
+
+
+VirtualTexture::VirtualTexture()
+{
+	this->m_File = nullptr;
+	this->m_Cache = nullptr;
+	this->m_Loader = nullptr;
+	this->m_Scheduler = nullptr;
+	this->m_physicalTexture = nullptr;
+	this->m_physicalView = nullptr;
+	this->m_pageTableTexture = nullptr;
+	this->m_pageTableView = nullptr;
+	this->m_feedbackTexture = nullptr;
+	this->m_feedbackView = nullptr;
+	this->m_feedbackDepthTexture = nullptr;
+	this->m_feedbackDepthView = nullptr;
+	for (int i = 0; i < VT_FEEDBACK_BUFFERS; i++)
+	{
+		this->m_stagingTextures[i] = nullptr;
+		this->m_stagingPending[i] = false;
+	}
+	this->m_stagingIndex = 0;
+	this->m_feedbackWidth = 0;
+	this->m_feedbackHeight = 0;
+	this->m_feedbackBias = 0.0f;
+	this->m_savedRenderTarget = nullptr;
+	this->m_savedDepthStencil = nullptr;
+}
+
+VirtualTexture::VirtualTexture(const VirtualTexture& other)
+{
+}
+
+VirtualTexture::~VirtualTexture()
+{
+}
+
+bool VirtualTexture::Initialize(ID3D11Device* device, const char* fileName, int slotsWide, int slotsHigh, int feedbackWidth, int feedbackHeight, int loaderThreads)
+{
+	HRESULT result;
+	D3D11_TEXTURE2D_DESC textureDesc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc;
+	vector<unsigned char> clear;
+	int paddedSize;
+
+	this->m_feedbackWidth = feedbackWidth;
+	this->m_feedbackHeight = feedbackHeight;
+
+	//Create and initialize the file object, only the tables are read here
+	this->m_File = new VirtualTextureFile();
+	if (!this->m_File)
+	{
+		return false;
+	}
+
+	if (!this->m_File->Initialize(fileName))
+	{
+		return false;
+	}
+
+	//Create the cache of physical slots
+	this->m_Cache = new PageCache();
+	if (!this->m_Cache)
+	{
+		return false;
+	}
+
+	if (!this->m_Cache->Initialize(slotsWide, slotsHigh))
+	{
+		return false;
+	}
+
+	//Create the loader that reads pages off the main thread
+	this->m_Loader = new PageLoader();
+	if (!this->m_Loader)
+	{
+		return false;
+	}
+
+	if (!this->m_Loader->Initialize(this->m_File, loaderThreads))
+	{
+		return false;
+	}
+
+	//Create the scheduler, a handful of pages are requested and uploaded each frame
+	this->m_Scheduler = new PageScheduler();
+	if (!this->m_Scheduler)
+	{
+		return false;
+	}
+
+	if (!this->m_Scheduler->Initialize(this->m_File, this->m_Cache, this->m_Loader, 16, 8))
+	{
+		return false;
+	}
+
+	//Create the physical texture, pages are stored with their border so filtering never reads a neighbouring slot
+	paddedSize = this->m_File->GetPaddedPageSize();
+	ZeroMemory(&textureDesc, sizeof(D3D11_TEXTURE2D_DESC));
+	textureDesc.Width = slotsWide * paddedSize;
+	textureDesc.Height = slotsHigh * paddedSize;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	result = device->CreateTexture2D(&textureDesc, nullptr, &this->m_physicalTexture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = device->CreateShaderResourceView(this->m_physicalTexture, nullptr, &this->m_physicalView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Create the page table with one texel per page and one mip per level of the virtual texture
+	textureDesc.Width = this->m_File->GetPagesWide(0);
+	textureDesc.Height = this->m_File->GetPagesHigh(0);
+	textureDesc.MipLevels = this->m_File->GetMipCount();
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UINT;
+
+	result = device->CreateTexture2D(&textureDesc, nullptr, &this->m_pageTableTexture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	ZeroMemory(&shaderResourceViewDesc, sizeof(D3D11_SHADER_RESOURCE_VIEW_DESC));
+	shaderResourceViewDesc.Format = textureDesc.Format;
+	shaderResourceViewDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+	shaderResourceViewDesc.Texture2D.MostDetailedMip = 0;
+	shaderResourceViewDesc.Texture2D.MipLevels = textureDesc.MipLevels;
+
+	result = device->CreateShaderResourceView(this->m_pageTableTexture, &shaderResourceViewDesc, &this->m_pageTableView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Create the feedback target and the staging textures it is copied into
+	if (!VirtualTexture::InitializeFeedback(device))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void VirtualTexture::Shutdown()
+{
+	VirtualTexture::StopTrace();
+
+	//Release the feedback resources
+	for (int i = 0; i < VT_FEEDBACK_BUFFERS; i++)
+	{
+		if (this->m_stagingTextures[i])
+		{
+			this->m_stagingTextures[i]->Release();
+			this->m_stagingTextures[i] = nullptr;
+		}
+	}
+
+	if (this->m_feedbackDepthView)
+	{
+		this->m_feedbackDepthView->Release();
+		this->m_feedbackDepthView = nullptr;
+	}
+
+	if (this->m_feedbackDepthTexture)
+	{
+		this->m_feedbackDepthTexture->Release();
+		this->m_feedbackDepthTexture = nullptr;
+	}
+
+	if (this->m_feedbackView)
+	{
+		this->m_feedbackView->Release();
+		this->m_feedbackView = nullptr;
+	}
+
+	if (this->m_feedbackTexture)
+	{
+		this->m_feedbackTexture->Release();
+		this->m_feedbackTexture = nullptr;
+	}
+
+	//Release the page table
+	if (this->m_pageTableView)
+	{
+		this->m_pageTableView->Release();
+		this->m_pageTableView = nullptr;
+	}
+
+	if (this->m_pageTableTexture)
+	{
+		this->m_pageTableTexture->Release();
+		this->m_pageTableTexture = nullptr;
+	}
+
+	//Release the physical texture
+	if (this->m_physicalView)
+	{
+		this->m_physicalView->Release();
+		this->m_physicalView = nullptr;
+	}
+
+	if (this->m_physicalTexture)
+	{
+		this->m_physicalTexture->Release();
+		this->m_physicalTexture = nullptr;
+	}
+
+	//Release the scheduler before the loader since it still holds loaded pages
+	if (this->m_Scheduler)
+	{
+		this->m_Scheduler->Shutdown();
+		delete this->m_Scheduler;
+		this->m_Scheduler = nullptr;
+	}
+
+	if (this->m_Loader)
+	{
+		this->m_Loader->Shutdown();
+		delete this->m_Loader;
+		this->m_Loader = nullptr;
+	}
+
+	if (this->m_Cache)
+	{
+		this->m_Cache->Shutdown();
+		delete this->m_Cache;
+		this->m_Cache = nullptr;
+	}
+
+	if (this->m_File)
+	{
+		this->m_File->Shutdown();
+		delete this->m_File;
+		this->m_File = nullptr;
+	}
+}
+
+void VirtualTexture::BeginFeedback(ID3D11DeviceContext* deviceContext)
+{
+	D3D11_VIEWPORT viewport;
+	unsigned int viewportCount;
+	float color[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	//Remember the current target and viewport so EndFeedback can put them back
+	viewportCount = 1;
+	deviceContext->RSGetViewports(&viewportCount, &this->m_savedViewport);
+	deviceContext->OMGetRenderTargets(1, &this->m_savedRenderTarget, &this->m_savedDepthStencil);
+
+	//Render at the size of the feedback target, the shader biases the mip level to make up for it
+	this->m_feedbackBias = -log2(this->m_savedViewport.Width / (float)this->m_feedbackWidth);
+	viewport.TopLeftX = 0.0f;
+	viewport.TopLeftY = 0.0f;
+	viewport.Width = (float)this->m_feedbackWidth;
+	viewport.Height = (float)this->m_feedbackHeight;
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+
+	deviceContext->OMSetRenderTargets(1, &this->m_feedbackView, this->m_feedbackDepthView);
+	deviceContext->RSSetViewports(1, &viewport);
+
+	//Zero means no page, the shader writes the page id plus one
+	deviceContext->ClearRenderTargetView(this->m_feedbackView, color);
+	deviceContext->ClearDepthStencilView(this->m_feedbackDepthView, D3D11_CLEAR_DEPTH, 1.0f, 0);
+}
+
+void VirtualTexture::EndFeedback(ID3D11DeviceContext* deviceContext)
+{
+	//Copy the feedback into the next staging texture, it is only read once the GPU is done with it
+	deviceContext->CopyResource(this->m_stagingTextures[this->m_stagingIndex], this->m_feedbackTexture);
+	this->m_stagingPending[this->m_stagingIndex] = true;
+	this->m_stagingIndex = (this->m_stagingIndex + 1) % VT_FEEDBACK_BUFFERS;
+
+	//Restore the target and viewport that were set before the feedback pass
+	deviceContext->OMSetRenderTargets(1, &this->m_savedRenderTarget, this->m_savedDepthStencil);
+	deviceContext->RSSetViewports(1, &this->m_savedViewport);
+
+	if (this->m_savedRenderTarget)
+	{
+		this->m_savedRenderTarget->Release();
+		this->m_savedRenderTarget = nullptr;
+	}
+
+	if (this->m_savedDepthStencil)
+	{
+		this->m_savedDepthStencil->Release();
+		this->m_savedDepthStencil = nullptr;
+	}
+}
+
+void VirtualTexture::Update(ID3D11DeviceContext* deviceContext)
+{
+	//Read back the oldest feedback that is ready, the frame goes on with no feedback rather than stalling on the GPU
+	if (!VirtualTexture::ReadFeedback(deviceContext))
+	{
+		this->m_feedback.clear();
+	}
+
+	if (this->m_trace.is_open())
+	{
+		VirtualTexture::WriteTrace();
+	}
+
+	//Let the scheduler request new pages and hand back the ones that finished loading
+	this->m_Scheduler->Update(this->m_feedback.empty() ? nullptr : &this->m_feedback[0], (int)this->m_feedback.size());
+
+	//Copy the new pages and the page table to the GPU
+	VirtualTexture::UploadPages(deviceContext);
+}
+
+bool VirtualTexture::StartTrace(const char* fileName)
+{
+	VirtualTexture::StopTrace();
+
+	this->m_trace.open(fileName);
+
+	return !this->m_trace.fail();
+}
+
+void VirtualTexture::StopTrace()
+{
+	if (this->m_trace.is_open())
+	{
+		this->m_trace.close();
+	}
+}
+
+ID3D11ShaderResourceView* VirtualTexture::GetPhysicalTexture()
+{
+	return this->m_physicalView;
+}
+
+ID3D11ShaderResourceView* VirtualTexture::GetPageTable()
+{
+	return this->m_pageTableView;
+}
+
+VirtualTextureFile* VirtualTexture::GetFile()
+{
+	return this->m_File;
+}
+
+PageCache* VirtualTexture::GetCache()
+{
+	return this->m_Cache;
+}
+
+PageScheduler* VirtualTexture::GetScheduler()
+{
+	return this->m_Scheduler;
+}
+
+int VirtualTexture::GetFeedbackWidth()
+{
+	return this->m_feedbackWidth;
+}
+
+int VirtualTexture::GetFeedbackHeight()
+{
+	return this->m_feedbackHeight;
+}
+
+float VirtualTexture::GetFeedbackBias()
+{
+	return this->m_feedbackBias;
+}
+
+bool VirtualTexture::InitializeFeedback(ID3D11Device* device)
+{
+	HRESULT result;
+	D3D11_TEXTURE2D_DESC textureDesc;
+
+	//Create the feedback render target
+	ZeroMemory(&textureDesc, sizeof(D3D11_TEXTURE2D_DESC));
+	textureDesc.Width = this->m_feedbackWidth;
+	textureDesc.Height = this->m_feedbackHeight;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R32_UINT;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_DEFAULT;
+	textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+	result = device->CreateTexture2D(&textureDesc, nullptr, &this->m_feedbackTexture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = device->CreateRenderTargetView(this->m_feedbackTexture, nullptr, &this->m_feedbackView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Create the depth buffer for the feedback pass, the one for the back buffer is the wrong size
+	textureDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	textureDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+	result = device->CreateTexture2D(&textureDesc, nullptr, &this->m_feedbackDepthTexture);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = device->CreateDepthStencilView(this->m_feedbackDepthTexture, nullptr, &this->m_feedbackDepthView);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Create the staging textures the feedback is read back through
+	textureDesc.Format = DXGI_FORMAT_R32_UINT;
+	textureDesc.Usage = D3D11_USAGE_STAGING;
+	textureDesc.BindFlags = 0;
+	textureDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+
+	for (int i = 0; i < VT_FEEDBACK_BUFFERS; i++)
+	{
+		result = device->CreateTexture2D(&textureDesc, nullptr, &this->m_stagingTextures[i]);
+		if (FAILED(result))
+		{
+			return false;
+		}
+	}
+
+	this->m_feedback.reserve(this->m_feedbackWidth * this->m_feedbackHeight);
+
+	return true;
+}
+
+bool VirtualTexture::ReadFeedback(ID3D11DeviceContext* deviceContext)
+{
+	HRESULT result;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	const unsigned int* row;
+	int index;
+
+	//The oldest copy is the one the index points at next
+	index = this->m_stagingIndex;
+	if (!this->m_stagingPending[index])
+	{
+		return false;
+	}
+
+	result = deviceContext->Map(this->m_stagingTextures[index], 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedResource);
+	if (FAILED(result))
+	{
+		return false;
+	}
+	this->m_stagingPending[index] = false;
+
+	//Keep every pixel that asked for a page, the scheduler counts how often each page was asked for
+	this->m_feedback.clear();
+	for (int y = 0; y < this->m_feedbackHeight; y++)
+	{
+		row = (const unsigned int*)((const unsigned char*)mappedResource.pData + (y * mappedResource.RowPitch));
+		for (int x = 0; x < this->m_feedbackWidth; x++)
+		{
+			if (row[x] != 0)
+			{
+				this->m_feedback.push_back(row[x] - 1);
+			}
+		}
+	}
+
+	deviceContext->Unmap(this->m_stagingTextures[index], 0);
+
+	return true;
+}
+
+void VirtualTexture::WriteTrace()
+{
+	vector<unsigned int> pages;
+	size_t start, pageCount;
+
+	//Each frame is one line holding the number of distinct pages followed by a page id and count for each
+	pages = this->m_feedback;
+	sort(pages.begin(), pages.end());
+	pageCount = 0;
+	for (size_t i = 0; i < pages.size(); i++)
+	{
+		if (i == 0 || pages[i] != pages[i - 1])
+		{
+			pageCount++;
+		}
+	}
+
+	this->m_trace << pageCount;
+	start = 0;
+	for (size_t i = 1; i <= pages.size(); i++)
+	{
+		if (i == pages.size() || pages[i] != pages[start])
+		{
+			this->m_trace << " " << pages[start] << " " << (i - start);
+			start = i;
+		}
+	}
+	this->m_trace << endl;
+}
+
+void VirtualTexture::UploadPages(ID3D11DeviceContext* deviceContext)
+{
+	PageScheduler::UploadType* upload;
+	D3D11_BOX box;
+	int paddedSize, rowPitch;
+
+	//Copy every page that finished loading into its slot
+	paddedSize = this->m_File->GetPaddedPageSize();
+	rowPitch = paddedSize * 4;
+	for (int i = 0; i < this->m_Scheduler->GetUploadCount(); i++)
+	{
+		upload = &this->m_Scheduler->GetUpload(i);
+
+		box.left = upload->slotX * paddedSize;
+		box.top = upload->slotY * paddedSize;
+		box.front = 0;
+		box.right = box.left + paddedSize;
+		box.bottom = box.top + paddedSize;
+		box.back = 1;
+
+		deviceContext->UpdateSubresource(this->m_physicalTexture, 0, &box, upload->data, rowPitch, 0);
+	}
+	this->m_Scheduler->ReleaseUploads();
+
+	//Copy the page table whenever a page came in or was evicted
+	if (this->m_Scheduler->IsPageTableDirty())
+	{
+		for (int i = 0; i < this->m_File->GetMipCount(); i++)
+		{
+			deviceContext->UpdateSubresource(this->m_pageTableTexture, i, nullptr, this->m_Scheduler->GetPageTable(i), this->m_File->GetPagesWide(i) * 4, 0);
+		}
+		this->m_Scheduler->ClearPageTableDirty();
+	}
+}
\ No newline at end of file
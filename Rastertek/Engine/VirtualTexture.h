@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTexture.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _VIRTUALTEXTURE_H_
+#define _VIRTUALTEXTURE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <d3d11.h>
+#include <fstream>
+#include <vector>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "VirtualTextureFile.h"
+#include "PageCache.h"
+#include "PageLoader.h"
+#include "PageScheduler.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int VT_FEEDBACK_BUFFERS = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: VirtualTexture
+////////////////////////////////////////////////////////////////////////////////
+class VirtualTexture
+{
+private:
+	VirtualTextureFile* m_File;
+	PageCache* m_Cache;
+	PageLoader* m_Loader;
+	PageScheduler* m_Scheduler;
+
+	//The physical texture holds the resident pages, the page table maps every virtual page to a slot in it
+	ID3D11Texture2D* m_physicalTexture;
+	ID3D11ShaderResourceView* m_physicalView;
+	ID3D11Texture2D* m_pageTableTexture;
+	ID3D11ShaderResourceView* m_pageTableView;
+
+	//The feedback pass writes the page every pixel needs into a small target that is read back a frame later
+	ID3D11Texture2D* m_feedbackTexture;
+	ID3D11RenderTargetView* m_feedbackView;
+	ID3D11Texture2D* m_feedbackDepthTexture;
+	ID3D11DepthStencilView* m_feedbackDepthView;
+	ID3D11Texture2D* m_stagingTextures[VT_FEEDBACK_BUFFERS];
+	bool m_stagingPending[VT_FEEDBACK_BUFFERS];
+	int m_stagingIndex;
+	int m_feedbackWidth;
+	int m_feedbackHeight;
+	float m_feedbackBias;
+	vector<unsigned int> m_feedback;
+
+	ID3D11RenderTargetView* m_savedRenderTarget;
+	ID3D11DepthStencilView* m_savedDepthStencil;
+	D3D11_VIEWPORT m_savedViewport;
+
+	ofstream m_trace;
+
+public:
+	VirtualTexture();
+	VirtualTexture(const VirtualTexture& other);
+	~VirtualTexture();
+
+	bool Initialize(ID3D11Device* device, const char* fileName, int slotsWide, int slotsHigh, int feedbackWidth, int feedbackHeight, int loaderThreads);
+	void Shutdown();
+
+	void BeginFeedback(ID3D11DeviceContext* deviceContext);
+	void EndFeedback(ID3D11DeviceContext* deviceContext);
+	void Update(ID3D11DeviceContext* deviceContext);
+
+	bool StartTrace(const char* fileName);
+	void StopTrace();
+
+	ID3D11ShaderResourceView* GetPhysicalTexture();
+	ID3D11ShaderResourceView* GetPageTable();
+	VirtualTextureFile* GetFile();
+	PageCache* GetCache();
+	PageScheduler* GetScheduler();
+	int GetFeedbackWidth();
+	int GetFeedbackHeight();
+	float GetFeedbackBias();
+
+private:
+	bool InitializeFeedback(ID3D11Device* device);
+	bool ReadFeedback(ID3D11DeviceContext* deviceContext);
+	void WriteTrace();
+	void UploadPages(ID3D11DeviceContext* deviceContext);
+};
+
+#endif
\ No newline at end of file
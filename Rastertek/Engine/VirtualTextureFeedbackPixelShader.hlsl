@@ -0,0 +1,56 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTextureFeedbackPixelShader.hlsl
+////////////////////////////////////////////////////////////////////////////////
+
+/////////////
+// GLOBALS //
+/////////////
+cbuffer VirtualTextureBuffer
+{
+	float2 virtualPages;
+	float pageSize;
+	float border;
+	float2 physicalSize;
+	float mipCount;
+	float mipBias;
+	float2 virtualSize;
+	float2 padding;
+};
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct PixelInputType
+{
+	float4 position : SV_POSITION;
+	float2 tex : TEXCOORD0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Pixel Shader
+////////////////////////////////////////////////////////////////////////////////
+uint main(PixelInputType input) : SV_TARGET
+{
+	float2 texel;
+	float2 dx;
+	float2 dy;
+	float lod;
+	uint mip;
+	uint2 pages;
+	uint2 page;
+
+	// Work out the mip level the hardware would pick from how fast the texture coordinates change across the pixel.
+	texel = input.tex * virtualSize;
+	dx = ddx(texel);
+	dy = ddy(texel);
+	lod = 0.5f * log2(max(dot(dx, dx), dot(dy, dy))) + mipBias;
+	mip = (uint)clamp(floor(lod), 0.0f, mipCount - 1.0f);
+
+	// Find the page at that level that covers the pixel, the texture wraps like the regular texture shader.
+	pages = max((uint2)virtualPages >> mip, uint2(1, 1));
+	page = min((uint2)(frac(input.tex) * pages), pages - 1);
+
+	// Write the page id the same way the CPU packs it, plus one so a cleared pixel reads as no page.
+	return ((mip << 28) | (page.y << 14) | page.x) + 1;
+}
\ No newline at end of file
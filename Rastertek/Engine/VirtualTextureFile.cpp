@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTextureFile.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "VirtualTextureFile.h"
+
+
+VirtualTextureFile::VirtualTextureFile()
+{
+	this->m_levels = nullptr;
+	this->m_pages = nullptr;
+	this->m_header.width = 0;
+	this->m_header.height = 0;
+	this->m_header.pageSize = 0;
+	this->m_header.border = 0;
+	this->m_header.mipCount = 0;
+	this->m_header.pageCount = 0;
+}
+
+VirtualTextureFile::VirtualTextureFile(const VirtualTextureFile& other)
+{
+}
+
+VirtualTextureFile::~VirtualTextureFile()
+{
+}
+
+bool VirtualTextureFile::Initialize(const char* fileName)
+{
+	ifstream fin;
+	unsigned int pageCount;
+
+	//Open the file, the pages themselves are read later by the loader threads
+	fin.open(fileName, ios::binary);
+	if (fin.fail())
+	{
+		return false;
+	}
+	this->m_fileName = fileName;
+
+	//Read in the header
+	fin.read((char*)&this->m_header, sizeof(HeaderType));
+	if (fin.fail() || this->m_header.magic != VT_MAGIC || this->m_header.version != VT_VERSION)
+	{
+		return false;
+	}
+	if (this->m_header.mipCount == 0 || this->m_header.mipCount > VT_MAX_MIPS || this->m_header.pageSize == 0)
+	{
+		return false;
+	}
+
+	//Read in the size of every level in pages
+	this->m_levels = new LevelType[this->m_header.mipCount];
+	if (!this->m_levels)
+	{
+		return false;
+	}
+
+	fin.read((char*)this->m_levels, sizeof(LevelType) * this->m_header.mipCount);
+	if (fin.fail())
+	{
+		return false;
+	}
+
+	//The levels have to account for every page in the file, and page coordinates have to fit in a page id
+	pageCount = 0;
+	for (unsigned int i = 0; i < this->m_header.mipCount; i++)
+	{
+		if (this->m_levels[i].firstPage != pageCount || this->m_levels[i].pagesWide > 0x3FFF || this->m_levels[i].pagesHigh > 0x3FFF)
+		{
+			return false;
+		}
+		pageCount += this->m_levels[i].pagesWide * this->m_levels[i].pagesHigh;
+	}
+	if (pageCount != this->m_header.pageCount)
+	{
+		return false;
+	}
+
+	//Read in where every page is stored
+	this->m_pages = new PageType[this->m_header.pageCount];
+	if (!this->m_pages)
+	{
+		return false;
+	}
+
+	fin.read((char*)this->m_pages, sizeof(PageType) * this->m_header.pageCount);
+	if (fin.fail())
+	{
+		return false;
+	}
+
+	//Close the file
+	fin.close();
+
+	return true;
+}
+
+void VirtualTextureFile::Shutdown()
+{
+	//Release the page table
+	if (this->m_pages)
+	{
+		delete[] this->m_pages;
+		this->m_pages = nullptr;
+	}
+
+	//Release the level table
+	if (this->m_levels)
+	{
+		delete[] this->m_levels;
+		this->m_levels = nullptr;
+	}
+}
+
+const char* VirtualTextureFile::GetFileName()
+{
+	return this->m_fileName.c_str();
+}
+
+int VirtualTextureFile::GetWidth()
+{
+	return (int)this->m_header.width;
+}
+
+int VirtualTextureFile::GetHeight()
+{
+	return (int)this->m_header.height;
+}
+
+int VirtualTextureFile::GetPageSize()
+{
+	return (int)this->m_header.pageSize;
+}
+
+int VirtualTextureFile::GetBorder()
+{
+	return (int)this->m_header.border;
+}
+
+int VirtualTextureFile::GetPaddedPageSize()
+{
+	return (int)(this->m_header.pageSize + (this->m_header.border * 2));
+}
+
+int VirtualTextureFile::GetPageBytes()
+{
+	return VirtualTextureFile::GetPaddedPageSize() * VirtualTextureFile::GetPaddedPageSize() * 4;
+}
+
+int VirtualTextureFile::GetMipCount()
+{
+	return (int)this->m_header.mipCount;
+}
+
+int VirtualTextureFile::GetPagesWide(int mip)
+{
+	return (int)this->m_levels[mip].pagesWide;
+}
+
+int VirtualTextureFile::GetPagesHigh(int mip)
+{
+	return (int)this->m_levels[mip].pagesHigh;
+}
+
+bool VirtualTextureFile::IsValidPage(unsigned int pageId)
+{
+	int mip;
+
+	if (pageId == VT_INVALID_PAGE)
+	{
+		return false;
+	}
+
+	mip = VirtualTextureFile::GetPageMip(pageId);
+	if (mip >= (int)this->m_header.mipCount)
+	{
+		return false;
+	}
+
+	return VirtualTextureFile::GetPageX(pageId) < (int)this->m_levels[mip].pagesWide && VirtualTextureFile::GetPageY(pageId) < (int)this->m_levels[mip].pagesHigh;
+}
+
+bool VirtualTextureFile::ReadPage(ifstream& file, unsigned int pageId, unsigned char* buffer)
+{
+	PageType* page;
+	unsigned int index;
+	int mip;
+
+	if (!VirtualTextureFile::IsValidPage(pageId))
+	{
+		return false;
+	}
+
+	//Find the page in the table and read it straight into the buffer
+	mip = VirtualTextureFile::GetPageMip(pageId);
+	index = this->m_levels[mip].firstPage + (VirtualTextureFile::GetPageY(pageId) * this->m_levels[mip].pagesWide) + VirtualTextureFile::GetPageX(pageId);
+	page = &this->m_pages[index];
+	if (page->size != (unsigned int)VirtualTextureFile::GetPageBytes())
+	{
+		return false;
+	}
+
+	file.clear();
+	file.seekg((streamoff)page->offset, ios::beg);
+	file.read((char*)buffer, page->size);
+
+	return !file.fail();
+}
+
+unsigned int VirtualTextureFile::MakePageId(int x, int y, int mip)
+{
+	//The mip level takes the top 4 bits and each coordinate 14 bits
+	return ((unsigned int)mip << 28) | ((unsigned int)y << 14) | (unsigned int)x;
+}
+
+int VirtualTextureFile::GetPageX(unsigned int pageId)
+{
+	return (int)(pageId & 0x3FFF);
+}
+
+int VirtualTextureFile::GetPageY(unsigned int pageId)
+{
+	return (int)((pageId >> 14) & 0x3FFF);
+}
+
+int VirtualTextureFile::GetPageMip(unsigned int pageId)
+{
+	return (int)(pageId >> 28);
+}
+
+unsigned int VirtualTextureFile::GetParentPage(unsigned int pageId)
+{
+	//The page one level coarser that covers the same area
+	return VirtualTextureFile::MakePageId(VirtualTextureFile::GetPageX(pageId) / 2, VirtualTextureFile::GetPageY(pageId) / 2, VirtualTextureFile::GetPageMip(pageId) + 1);
+}
\ No newline at end of file
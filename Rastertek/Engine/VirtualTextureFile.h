@@ -0,0 +1,90 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTextureFile.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _VIRTUALTEXTUREFILE_H_
+#define _VIRTUALTEXTUREFILE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <fstream>
+#include <string>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned int VT_MAGIC = 0x58455456;
+const unsigned int VT_VERSION = 1;
+const unsigned int VT_MAX_MIPS = 15;
+const unsigned int VT_INVALID_PAGE = 0xFFFFFFFF;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: VirtualTextureFile
+////////////////////////////////////////////////////////////////////////////////
+class VirtualTextureFile
+{
+private:
+	//The file holds this header, one LevelType per mip, one PageType per page and then the page data.
+	//Pages are square A8R8G8B8 tiles of pageSize texels with a border of texels copied from their neighbours
+	struct HeaderType
+	{
+		unsigned int magic;
+		unsigned int version;
+		unsigned int width;
+		unsigned int height;
+		unsigned int pageSize;
+		unsigned int border;
+		unsigned int mipCount;
+		unsigned int pageCount;
+	};
+
+	struct LevelType
+	{
+		unsigned int pagesWide;
+		unsigned int pagesHigh;
+		unsigned int firstPage;
+	};
+
+	struct PageType
+	{
+		unsigned long long offset;
+		unsigned int size;
+		unsigned int reserved;
+	};
+
+	string m_fileName;
+	HeaderType m_header;
+	LevelType* m_levels;
+	PageType* m_pages;
+
+public:
+	VirtualTextureFile();
+	VirtualTextureFile(const VirtualTextureFile& other);
+	~VirtualTextureFile();
+
+	bool Initialize(const char* fileName);
+	void Shutdown();
+
+	const char* GetFileName();
+	int GetWidth();
+	int GetHeight();
+	int GetPageSize();
+	int GetBorder();
+	int GetPaddedPageSize();
+	int GetPageBytes();
+	int GetMipCount();
+	int GetPagesWide(int mip);
+	int GetPagesHigh(int mip);
+
+	bool IsValidPage(unsigned int pageId);
+	bool ReadPage(ifstream& file, unsigned int pageId, unsigned char* buffer);
+
+	static unsigned int MakePageId(int x, int y, int mip);
+	static int GetPageX(unsigned int pageId);
+	static int GetPageY(unsigned int pageId);
+	static int GetPageMip(unsigned int pageId);
+	static unsigned int GetParentPage(unsigned int pageId);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTexturePixelShader.hlsl
+////////////////////////////////////////////////////////////////////////////////
+
+/////////////
+// GLOBALS //
+/////////////
+Texture2D<uint4> pageTable : register(t0);
+Texture2D physicalTexture : register(t1);
+SamplerState SampleType;
+
+cbuffer VirtualTextureBuffer
+{
+	float2 virtualPages;
+	float pageSize;
+	float border;
+	float2 physicalSize;
+	float mipCount;
+	float mipBias;
+	float2 virtualSize;
+	float2 padding;
+};
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct PixelInputType
+{
+	float4 position : SV_POSITION;
+	float2 tex : TEXCOORD0;
+};
+
+
+////////////////////////////////////////////////////////////////////////////////
+// Pixel Shader
+////////////////////////////////////////////////////////////////////////////////
+float4 main(PixelInputType input) : SV_TARGET
+{
+	float2 texel;
+	float2 dx;
+	float2 dy;
+	float2 uv;
+	float2 pageUV;
+	float lod;
+	uint mip;
+	uint2 pages;
+	uint2 page;
+	uint4 entry;
+
+	// Pick the same mip level and page as the feedback pass did.
+	texel = input.tex * virtualSize;
+	dx = ddx(texel);
+	dy = ddy(texel);
+	lod = 0.5f * log2(max(dot(dx, dx), dot(dy, dy))) + mipBias;
+	mip = (uint)clamp(floor(lod), 0.0f, mipCount - 1.0f);
+
+	uv = frac(input.tex);
+	pages = max((uint2)virtualPages >> mip, uint2(1, 1));
+	page = min((uint2)(uv * pages), pages - 1);
+
+	// Look up the slot holding that page, or its closest resident ancestor while it is still loading.
+	entry = pageTable.Load(int3(page, mip));
+	if (entry.a == 0)
+	{
+		return float4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	// Find where the pixel falls inside the page at the level that is actually resident.
+	pages = max((uint2)virtualPages >> entry.b, uint2(1, 1));
+	pageUV = frac(uv * pages);
+
+	// Sample the page in the physical texture, skipping over the border around it.
+	uv = ((float2)entry.rg * (pageSize + (2.0f * border)) + border + (pageUV * pageSize)) / physicalSize;
+
+	return physicalTexture.SampleLevel(SampleType, uv, 0);
+}
\ No newline at end of file
@@ -0,0 +1,415 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTextureShader.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "VirtualTextureShader.h"
+
+VirtualTextureShader::VirtualTextureShader()
+{
+	this->m_vertexShader = nullptr;
+	this->m_pixelShader = nullptr;
+	this->m_feedbackPixelShader = nullptr;
+	this->m_layout = nullptr;
+	this->m_sampleState = nullptr;
+	this->m_matrixBuffer = nullptr;
+	this->m_virtualTextureBuffer = nullptr;
+}
+
+VirtualTextureShader::VirtualTextureShader(const VirtualTextureShader& other)
+{
+}
+
+VirtualTextureShader::~VirtualTextureShader()
+{
+}
+
+bool VirtualTextureShader::Initialize(ID3D11Device* device, HWND hwnd)
+{
+	bool result;
+
+	//Initialize the vertex shader and both pixel shaders, the vertex shader is the one the texture shader uses
+	result = VirtualTextureShader::InitializeShader(device, hwnd, L"TextureVertexShader.hlsl", L"VirtualTexturePixelShader.hlsl", L"VirtualTextureFeedbackPixelShader.hlsl");
+	if (!result)
+	{
+		return false;
+	}
+	return true;
+}
+
+void VirtualTextureShader::Shutdown()
+{
+	//Shutdown the vertex and pixel shaders as well as the related objects
+	VirtualTextureShader::ShutdownShader();
+}
+
+bool VirtualTextureShader::RenderFeedback(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, VirtualTexture* virtualTexture)
+{
+	bool result;
+
+	//Set the shader parameters, the feedback target is smaller than the screen so the mip level is biased to match
+	result = VirtualTextureShader::SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, virtualTexture, virtualTexture->GetFeedbackBias());
+	if (!result)
+	{
+		return false;
+	}
+
+	//Now render the prepared buffer writing the page ids
+	VirtualTextureShader::RenderShader(deviceContext, this->m_feedbackPixelShader, indexCount);
+
+	return true;
+}
+
+bool VirtualTextureShader::Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, VirtualTexture* virtualTexture)
+{
+	bool result;
+
+	//Set the shader parameters that it will use for rendering
+	result = VirtualTextureShader::SetShaderParameters(deviceContext, worldMatrix, viewMatrix, projectionMatrix, virtualTexture, 0.0f);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Now render the prepared buffer with the shader
+	VirtualTextureShader::RenderShader(deviceContext, this->m_pixelShader, indexCount);
+
+	return true;
+}
+
+bool VirtualTextureShader::InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFileName, WCHAR* psFileName, WCHAR* feedbackPsFileName)
+{
+	HRESULT result;
+	ID3D10Blob* errorMessage;
+	ID3D10Blob* vertexShaderBuffer;
+	ID3D10Blob* pixelShaderBuffer;
+	ID3D10Blob* feedbackPixelShaderBuffer;
+	D3D11_INPUT_ELEMENT_DESC inputElementDesc[2];
+	unsigned int numElements;
+	D3D11_BUFFER_DESC bufferDesc;
+	D3D11_SAMPLER_DESC samplerDesc;
+
+	//Initialize the pointers this function will use to null
+	errorMessage = nullptr;
+	vertexShaderBuffer = nullptr;
+	pixelShaderBuffer = nullptr;
+	feedbackPixelShaderBuffer = nullptr;
+
+	//Compile the vertex shader code
+	result = D3DX11CompileFromFile(vsFileName, nullptr, nullptr, "main", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, nullptr, &vertexShaderBuffer, &errorMessage, nullptr);
+	if (FAILED(result))
+	{
+		//If the shader failed to compile, it should have written something to the error message
+		if (errorMessage)
+		{
+			VirtualTextureShader::OutputShaderErrorMessage(errorMessage, hwnd, vsFileName);
+		}
+		//If there was nothing in the error message then it simply could not find the shader file itself
+		else
+		{
+			MessageBox(hwnd, vsFileName, L"Missing Shader File", MB_OK);
+		}
+		return false;
+	}
+
+	//Compile the pixel shader code
+	result = D3DX11CompileFromFile(psFileName, nullptr, nullptr, "main", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, nullptr, &pixelShaderBuffer, &errorMessage, nullptr);
+	if (FAILED(result))
+	{
+		//If the shader failed to compile it should have written something to the error message
+		if (errorMessage)
+		{
+			VirtualTextureShader::OutputShaderErrorMessage(errorMessage, hwnd, psFileName);
+		}
+		//If there was nothing in the error message then it simply could not find the file itself
+		else
+		{
+			MessageBox(hwnd, psFileName, L"Missing Shader File", MB_OK);
+		}
+		return false;
+	}
+
+	//Compile the feedback pixel shader code
+	result = D3DX11CompileFromFile(feedbackPsFileName, nullptr, nullptr, "main", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, nullptr, &feedbackPixelShaderBuffer, &errorMessage, nullptr);
+	if (FAILED(result))
+	{
+		if (errorMessage)
+		{
+			VirtualTextureShader::OutputShaderErrorMessage(errorMessage, hwnd, feedbackPsFileName);
+		}
+		else
+		{
+			MessageBox(hwnd, feedbackPsFileName, L"Missing Shader File", MB_OK);
+		}
+		return false;
+	}
+
+	//Create the vertex shader from the buffer
+	result = device->CreateVertexShader(vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), nullptr, &this->m_vertexShader);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Create the pixel shaders from the buffers
+	result = device->CreatePixelShader(pixelShaderBuffer->GetBufferPointer(), pixelShaderBuffer->GetBufferSize(), nullptr, &this->m_pixelShader);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = device->CreatePixelShader(feedbackPixelShaderBuffer->GetBufferPointer(), feedbackPixelShaderBuffer->GetBufferSize(), nullptr, &this->m_feedbackPixelShader);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Create the vertex input layout description
+	//This setup needs to match the VertexType structure in the ModelClass and in the shader
+	inputElementDesc[0].SemanticName = "POSITION";
+	inputElementDesc[0].SemanticIndex = 0;
+	inputElementDesc[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	inputElementDesc[0].InputSlot = 0;
+	inputElementDesc[0].AlignedByteOffset = 0;
+	inputElementDesc[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	inputElementDesc[0].InstanceDataStepRate = 0;
+
+	inputElementDesc[1].SemanticName = "TEXCOORD";
+	inputElementDesc[1].SemanticIndex = 0;
+	inputElementDesc[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	inputElementDesc[1].InputSlot = 0;
+	inputElementDesc[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	inputElementDesc[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	inputElementDesc[1].InstanceDataStepRate = 0;
+
+	//Get a count of the elements in the layout
+	numElements = sizeof(inputElementDesc) / sizeof(inputElementDesc[0]);
+
+	//Create the vertex input layout
+	result = device->CreateInputLayout(inputElementDesc, numElements, vertexShaderBuffer->GetBufferPointer(), vertexShaderBuffer->GetBufferSize(), &this->m_layout);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Release the shader buffers since they are no longer needed
+	vertexShaderBuffer->Release();
+	vertexShaderBuffer = nullptr;
+
+	pixelShaderBuffer->Release();
+	pixelShaderBuffer = nullptr;
+
+	feedbackPixelShaderBuffer->Release();
+	feedbackPixelShaderBuffer = nullptr;
+
+	//Setup the description of the dynamic matrix constant buffer that is in the vertex shader
+	bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	bufferDesc.ByteWidth = sizeof(MatrixBufferType);
+	bufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bufferDesc.MiscFlags = 0;
+	bufferDesc.StructureByteStride = 0;
+
+	result = device->CreateBuffer(&bufferDesc, nullptr, &this->m_matrixBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Setup the description of the virtual texture constant buffer that is in both pixel shaders
+	bufferDesc.ByteWidth = sizeof(VirtualTextureBufferType);
+
+	result = device->CreateBuffer(&bufferDesc, nullptr, &this->m_virtualTextureBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Create a texture sampler state description, pages carry a border so clamping only matters at the atlas edge
+	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
+	samplerDesc.MipLODBias = 0.0f;
+	samplerDesc.MaxAnisotropy = 1;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	samplerDesc.BorderColor[0] = 0;
+	samplerDesc.BorderColor[1] = 0;
+	samplerDesc.BorderColor[2] = 0;
+	samplerDesc.BorderColor[3] = 0;
+	samplerDesc.MinLOD = 0;
+	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+	//Create the texture sampler state
+	result = device->CreateSamplerState(&samplerDesc, &this->m_sampleState);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void VirtualTextureShader::ShutdownShader()
+{
+	//Release the sampler state
+	if (this->m_sampleState)
+	{
+		this->m_sampleState->Release();
+		this->m_sampleState = nullptr;
+	}
+
+	//Release the constant buffers
+	if (this->m_virtualTextureBuffer)
+	{
+		this->m_virtualTextureBuffer->Release();
+		this->m_virtualTextureBuffer = nullptr;
+	}
+
+	if (this->m_matrixBuffer)
+	{
+		this->m_matrixBuffer->Release();
+		this->m_matrixBuffer = nullptr;
+	}
+
+	//Release the layout
+	if (this->m_layout)
+	{
+		this->m_layout->Release();
+		this->m_layout = nullptr;
+	}
+
+	//Release the pixel shaders
+	if (this->m_feedbackPixelShader)
+	{
+		this->m_feedbackPixelShader->Release();
+		this->m_feedbackPixelShader = nullptr;
+	}
+
+	if (this->m_pixelShader)
+	{
+		this->m_pixelShader->Release();
+		this->m_pixelShader = nullptr;
+	}
+
+	//Release the vertex shader
+	if (this->m_vertexShader)
+	{
+		this->m_vertexShader->Release();
+		this->m_vertexShader = nullptr;
+	}
+}
+
+void VirtualTextureShader::OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFileName)
+{
+	char* compileErrors;
+	ofstream fout;
+
+	//Get a pointer to the error message text buffer
+	compileErrors = (char*)(errorMessage->GetBufferPointer());
+
+	//Get the length of the message
+	ULONG bufferSize = errorMessage->GetBufferSize();
+
+	//Open a file to write the error message in
+	fout.open("shader-error.txt");
+
+	//Write out the error message
+	for (ULONG i = 0; i < bufferSize; i++)
+	{
+		fout << compileErrors[i];
+	}
+
+	//Close the file
+	fout.close();
+
+	//Release the errorMessage
+	errorMessage->Release();
+	errorMessage = nullptr;
+
+	// Pop a message up on the screen to notify the user to check the text file for compile errors.
+	MessageBox(hwnd, L"Error compiling shader.  Check shader-error.txt for message.", shaderFileName, MB_OK);
+}
+
+bool VirtualTextureShader::SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, VirtualTexture* virtualTexture, float mipBias)
+{
+	HRESULT result;
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	MatrixBufferType* dataPtr;
+	VirtualTextureBufferType* dataPtr2;
+	VirtualTextureFile* file;
+	ID3D11ShaderResourceView* textures[2];
+	unsigned int bufferNumber;
+
+	//Transpose the matrices to prepare them for the shader
+	D3DXMatrixTranspose(&worldMatrix, &worldMatrix);
+	D3DXMatrixTranspose(&viewMatrix, &viewMatrix);
+	D3DXMatrixTranspose(&projectionMatrix, &projectionMatrix);
+
+	//Lock the constant buffer so it can be written to
+	result = deviceContext->Map(this->m_matrixBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Copy the matrices into the constant buffer
+	dataPtr = (MatrixBufferType*)mappedResource.pData;
+	dataPtr->world = worldMatrix;
+	dataPtr->view = viewMatrix;
+	dataPtr->projection = projectionMatrix;
+
+	//Unlock the constant buffer
+	deviceContext->Unmap(this->m_matrixBuffer, 0);
+
+	//Now set the constant buffer in the vertex shader with the updated values
+	bufferNumber = 0;
+	deviceContext->VSSetConstantBuffers(bufferNumber, 1, &this->m_matrixBuffer);
+
+	//Lock the virtual texture constant buffer so it can be written to
+	result = deviceContext->Map(this->m_virtualTextureBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//Copy the layout of the virtual and physical textures into the constant buffer
+	file = virtualTexture->GetFile();
+	dataPtr2 = (VirtualTextureBufferType*)mappedResource.pData;
+	dataPtr2->virtualPages = D3DXVECTOR2((float)file->GetPagesWide(0), (float)file->GetPagesHigh(0));
+	dataPtr2->pageSize = (float)file->GetPageSize();
+	dataPtr2->border = (float)file->GetBorder();
+	dataPtr2->physicalSize = D3DXVECTOR2((float)(virtualTexture->GetCache()->GetSlotsWide() * file->GetPaddedPageSize()), (float)(virtualTexture->GetCache()->GetSlotsHigh() * file->GetPaddedPageSize()));
+	dataPtr2->mipCount = (float)file->GetMipCount();
+	dataPtr2->mipBias = mipBias;
+	dataPtr2->virtualSize = D3DXVECTOR2((float)file->GetWidth(), (float)file->GetHeight());
+	dataPtr2->padding = D3DXVECTOR2(0.0f, 0.0f);
+
+	//Unlock the constant buffer
+	deviceContext->Unmap(this->m_virtualTextureBuffer, 0);
+
+	//Now set the constant buffer in the pixel shader with the updated values
+	bufferNumber = 0;
+	deviceContext->PSSetConstantBuffers(bufferNumber, 1, &this->m_virtualTextureBuffer);
+
+	//Set the page table and the physical texture in the pixel shader
+	textures[0] = virtualTexture->GetPageTable();
+	textures[1] = virtualTexture->GetPhysicalTexture();
+	deviceContext->PSSetShaderResources(0, 2, textures);
+
+	return true;
+}
+
+void VirtualTextureShader::RenderShader(ID3D11DeviceContext* deviceContext, ID3D11PixelShader* pixelShader, int indexCount)
+{
+	//Set the vertex input layout
+	deviceContext->IASetInputLayout(this->m_layout);
+
+	//Set the vertex and pixel shaders that will be used to render this triangle
+	deviceContext->VSSetShader(this->m_vertexShader, nullptr, 0);
+	deviceContext->PSSetShader(pixelShader, nullptr, 0);
+
+	//Set the sampler state in the pixel shader
+	deviceContext->PSSetSamplers(0, 1, &this->m_sampleState);
+
+	//Render the triangle
+	deviceContext->DrawIndexed(indexCount, 0, 0);
+}
\ No newline at end of file
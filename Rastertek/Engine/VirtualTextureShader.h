@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: VirtualTextureShader.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _VIRTUALTEXTURESHADER_H_
+#define _VIRTUALTEXTURESHADER_H_
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include <d3dx11async.h>
+#include <fstream>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "VirtualTexture.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: VirtualTextureShader
+////////////////////////////////////////////////////////////////////////////////
+class VirtualTextureShader
+{
+private:
+	struct MatrixBufferType
+	{
+		D3DXMATRIX world;
+		D3DXMATRIX view;
+		D3DXMATRIX projection;
+	};
+
+	struct VirtualTextureBufferType
+	{
+		D3DXVECTOR2 virtualPages;
+		float pageSize;
+		float border;
+		D3DXVECTOR2 physicalSize;
+		float mipCount;
+		float mipBias;
+		D3DXVECTOR2 virtualSize;
+		D3DXVECTOR2 padding;
+	};
+
+	ID3D11VertexShader* m_vertexShader;
+	ID3D11PixelShader* m_pixelShader;
+	ID3D11PixelShader* m_feedbackPixelShader;
+	ID3D11InputLayout* m_layout;
+	ID3D11SamplerState* m_sampleState;
+	ID3D11Buffer* m_matrixBuffer;
+	ID3D11Buffer* m_virtualTextureBuffer;
+
+public:
+	VirtualTextureShader();
+	VirtualTextureShader(const VirtualTextureShader& other);
+	~VirtualTextureShader();
+
+	bool Initialize(ID3D11Device* device, HWND hwnd);
+	void Shutdown();
+	bool RenderFeedback(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, VirtualTexture* virtualTexture);
+	bool Render(ID3D11DeviceContext* deviceContext, int indexCount, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, VirtualTexture* virtualTexture);
+
+private:
+	bool InitializeShader(ID3D11Device* device, HWND hwnd, WCHAR* vsFilename, WCHAR* psFilename, WCHAR* feedbackPsFilename);
+	void ShutdownShader();
+	void OutputShaderErrorMessage(ID3D10Blob* errorMessage, HWND hwnd, WCHAR* shaderFilename);
+
+	bool SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX worldMatrix, D3DXMATRIX viewMatrix, D3DXMATRIX projectionMatrix, VirtualTexture* virtualTexture, float mipBias);
+	void RenderShader(ID3D11DeviceContext* deviceContext, ID3D11PixelShader* pixelShader, int indexCount);
+};
+#endif
\ No newline at end of file
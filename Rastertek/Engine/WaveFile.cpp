@@ -0,0 +1,666 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: WaveFile.cpp
+////////////////////////////////////////////////////////////////////////////////
+#include "WaveFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/////////////
+// GLOBALS //
+/////////////
+
+//How far the step size moves after each code, and the step sizes themselves
+static const int adpcmIndexTable[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+static const int adpcmStepTable[89] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166,
+	1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845,
+	8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+//////////////
+// TYPEDEFS //
+//////////////
+
+//What each code does at each step size, built once when the program loads
+struct AdpcmTableType
+{
+	int differences[89 * 16];
+	unsigned char indices[89 * 16];
+};
+
+static AdpcmTableType BuildAdpcmTable()
+{
+	AdpcmTableType table;
+	int index;
+	int code;
+	int step;
+	int difference;
+	int next;
+
+	for (index = 0; index < 89; index++)
+	{
+		for (code = 0; code < 16; code++)
+		{
+			//The three magnitude bits scale the step, the top bit is the sign
+			step = adpcmStepTable[index];
+			difference = step >> 3;
+			if (code & 4)
+			{
+				difference += step;
+			}
+			if (code & 2)
+			{
+				difference += step >> 1;
+			}
+			if (code & 1)
+			{
+				difference += step >> 2;
+			}
+			table.differences[index * 16 + code] = code & 8 ? -difference : difference;
+
+			next = index + adpcmIndexTable[code];
+			table.indices[index * 16 + code] = (unsigned char)(next < 0 ? 0 : (next > 88 ? 88 : next));
+		}
+	}
+
+	return table;
+}
+
+static const AdpcmTableType adpcmTable = BuildAdpcmTable();
+
+
+WaveFile::WaveFile()
+{
+	this->m_data = nullptr;
+	this->m_size = 0;
+	this->m_mapped = false;
+	this->m_fileHandle = nullptr;
+	this->m_mappingHandle = nullptr;
+	this->m_fileDescriptor = -1;
+	this->m_formatTag = 0;
+	this->m_channels = 0;
+	this->m_sampleRate = 0;
+	this->m_bytesPerSecond = 0;
+	this->m_blockAlign = 0;
+	this->m_bitsPerSample = 0;
+	this->m_framesPerBlock = 0;
+	this->m_samples = nullptr;
+	this->m_sampleSize = 0;
+	this->m_frameCount = 0;
+}
+
+WaveFile::WaveFile(const WaveFile& other)
+{
+}
+
+
+WaveFile::~WaveFile()
+{
+}
+
+bool WaveFile::Initialize(const char* fileName)
+{
+#ifdef _WIN32
+	HANDLE file;
+	HANDLE mapping;
+	LARGE_INTEGER fileSize;
+
+	//Open the file and map all of it into memory, the samples are streamed straight out of the mapping
+	file = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	this->m_fileHandle = file;
+
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		WaveFile::Unmap();
+		return false;
+	}
+	this->m_size = (size_t)fileSize.QuadPart;
+
+	mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mapping)
+	{
+		WaveFile::Unmap();
+		return false;
+	}
+	this->m_mappingHandle = mapping;
+
+	this->m_data = (const unsigned char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!this->m_data)
+	{
+		WaveFile::Unmap();
+		return false;
+	}
+#else
+	struct stat fileStat;
+	void* view;
+
+	//Open the file and map all of it into memory, the samples are streamed straight out of the mapping
+	this->m_fileDescriptor = open(fileName, O_RDONLY);
+	if (this->m_fileDescriptor < 0)
+	{
+		return false;
+	}
+
+	if (fstat(this->m_fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		WaveFile::Unmap();
+		return false;
+	}
+	this->m_size = (size_t)fileStat.st_size;
+
+	view = mmap(nullptr, this->m_size, PROT_READ, MAP_PRIVATE, this->m_fileDescriptor, 0);
+	if (view == MAP_FAILED)
+	{
+		WaveFile::Unmap();
+		return false;
+	}
+	this->m_data = (const unsigned char*)view;
+
+	//The file is read front to back, so let the kernel read ahead
+	madvise(view, this->m_size, MADV_SEQUENTIAL);
+#endif
+	this->m_mapped = true;
+
+	//Read the header and find the samples
+	if (!WaveFile::Parse())
+	{
+		WaveFile::Shutdown();
+		return false;
+	}
+
+	return true;
+}
+
+bool WaveFile::Initialize(const void* data, size_t size)
+{
+	//Parse a file that is already in memory, it has to stay valid for as long as the samples are used
+	this->m_data = (const unsigned char*)data;
+	this->m_size = size;
+	this->m_mapped = false;
+
+	if (!WaveFile::Parse())
+	{
+		WaveFile::Shutdown();
+		return false;
+	}
+
+	return true;
+}
+
+void WaveFile::Shutdown()
+{
+	//Release the file mapping
+	WaveFile::Unmap();
+	this->m_samples = nullptr;
+	this->m_sampleSize = 0;
+	this->m_frameCount = 0;
+}
+
+unsigned short WaveFile::GetFormatTag()
+{
+	return this->m_formatTag;
+}
+
+unsigned short WaveFile::GetChannels()
+{
+	return this->m_channels;
+}
+
+unsigned int WaveFile::GetSampleRate()
+{
+	return this->m_sampleRate;
+}
+
+unsigned int WaveFile::GetBytesPerSecond()
+{
+	return this->m_bytesPerSecond;
+}
+
+unsigned short WaveFile::GetBlockAlign()
+{
+	return this->m_blockAlign;
+}
+
+unsigned short WaveFile::GetBitsPerSample()
+{
+	return this->m_bitsPerSample;
+}
+
+unsigned int WaveFile::GetFramesPerBlock()
+{
+	return this->m_framesPerBlock;
+}
+
+bool WaveFile::IsCompressed()
+{
+	return this->m_formatTag == WAVE_FORMAT_TAG_IMA_ADPCM;
+}
+
+const unsigned char* WaveFile::GetSamples()
+{
+	return this->m_samples;
+}
+
+size_t WaveFile::GetSampleSize()
+{
+	return this->m_sampleSize;
+}
+
+size_t WaveFile::GetFrameCount()
+{
+	return this->m_frameCount;
+}
+
+size_t WaveFile::ReadSamples(size_t firstFrame, size_t frameCount, float* destination)
+{
+	const unsigned char* source;
+	short decoded[WAVE_DECODE_FRAMES * WAVE_ADPCM_MAX_CHANNELS];
+	size_t sampleCount;
+	size_t count;
+	size_t i;
+	size_t j;
+	int value;
+
+	//Read whole frames as interleaved floats between -1 and 1 whatever the file stores
+	if (firstFrame >= WaveFile::GetFrameCount())
+	{
+		return 0;
+	}
+	if (frameCount > WaveFile::GetFrameCount() - firstFrame)
+	{
+		frameCount = WaveFile::GetFrameCount() - firstFrame;
+	}
+
+	sampleCount = frameCount * this->m_channels;
+
+	//Compressed samples are decoded to 16 bit a piece at a time first
+	if (this->m_formatTag == WAVE_FORMAT_TAG_IMA_ADPCM)
+	{
+		for (i = 0; i < frameCount; i += count)
+		{
+			count = frameCount - i < WAVE_DECODE_FRAMES ? frameCount - i : WAVE_DECODE_FRAMES;
+			WaveFile::DecodeAdpcm(firstFrame + i, count, decoded);
+			for (j = 0; j < count * this->m_channels; j++)
+			{
+				destination[i * this->m_channels + j] = (float)decoded[j] * (1.0f / 32768.0f);
+			}
+		}
+		return frameCount;
+	}
+
+	source = this->m_samples + firstFrame * this->m_blockAlign;
+
+	if (this->m_formatTag == WAVE_FORMAT_TAG_IEEE_FLOAT)
+	{
+		memcpy(destination, source, sampleCount * sizeof(float));
+		return frameCount;
+	}
+
+	switch (this->m_bitsPerSample)
+	{
+	case 8:
+		//8 bit samples are unsigned around 128
+		for (i = 0; i < sampleCount; i++)
+		{
+			destination[i] = (float)((int)source[i] - 128) * (1.0f / 128.0f);
+		}
+		break;
+	case 16:
+		for (i = 0; i < sampleCount; i++)
+		{
+			destination[i] = (float)(short)RiffReader::ReadUShort(source + i * 2) * (1.0f / 32768.0f);
+		}
+		break;
+	case 24:
+		//Put the three bytes at the top of an int so the sign carries, then shift back down
+		for (i = 0; i < sampleCount; i++)
+		{
+			value = (int)(((unsigned int)source[i * 3] << 8) | ((unsigned int)source[i * 3 + 1] << 16) | ((unsigned int)source[i * 3 + 2] << 24)) >> 8;
+			destination[i] = (float)value * (1.0f / 8388608.0f);
+		}
+		break;
+	case 32:
+		for (i = 0; i < sampleCount; i++)
+		{
+			destination[i] = (float)(int)RiffReader::ReadUInt(source + i * 4) * (1.0f / 2147483648.0f);
+		}
+		break;
+	}
+
+	return frameCount;
+}
+
+size_t WaveFile::ReadSamples(size_t firstFrame, size_t frameCount, short* destination)
+{
+	const unsigned char* source;
+	size_t sampleCount;
+	size_t i;
+	float value;
+
+	//Read whole frames as interleaved 16 bit samples, the format sound buffers play
+	if (firstFrame >= WaveFile::GetFrameCount())
+	{
+		return 0;
+	}
+	if (frameCount > WaveFile::GetFrameCount() - firstFrame)
+	{
+		frameCount = WaveFile::GetFrameCount() - firstFrame;
+	}
+
+	if (this->m_formatTag == WAVE_FORMAT_TAG_IMA_ADPCM)
+	{
+		WaveFile::DecodeAdpcm(firstFrame, frameCount, destination);
+		return frameCount;
+	}
+
+	source = this->m_samples + firstFrame * this->m_blockAlign;
+	sampleCount = frameCount * this->m_channels;
+
+	if (this->m_formatTag == WAVE_FORMAT_TAG_IEEE_FLOAT)
+	{
+		for (i = 0; i < sampleCount; i++)
+		{
+			memcpy(&value, source + i * 4, sizeof(float));
+			value *= 32767.0f;
+			value = value > 32767.0f ? 32767.0f : (value < -32768.0f ? -32768.0f : value);
+			destination[i] = (short)value;
+		}
+		return frameCount;
+	}
+
+	//Wider samples keep their top 16 bits
+	switch (this->m_bitsPerSample)
+	{
+	case 8:
+		for (i = 0; i < sampleCount; i++)
+		{
+			destination[i] = (short)(((int)source[i] - 128) * 256);
+		}
+		break;
+	case 16:
+		memcpy(destination, source, sampleCount * 2);
+		break;
+	case 24:
+		for (i = 0; i < sampleCount; i++)
+		{
+			destination[i] = (short)RiffReader::ReadUShort(source + i * 3 + 1);
+		}
+		break;
+	case 32:
+		for (i = 0; i < sampleCount; i++)
+		{
+			destination[i] = (short)RiffReader::ReadUShort(source + i * 4 + 2);
+		}
+		break;
+	}
+
+	return frameCount;
+}
+
+bool WaveFile::Parse()
+{
+	bool result;
+	RiffReader reader;
+	RiffReader::ChunkType chunk;
+
+	//The file is a RIFF file of the WAVE form, its chunks can come in any order and unknown ones such as LIST and fact are skipped
+	result = reader.Initialize(this->m_data, this->m_size);
+	if (!result || !reader.IsFormType("WAVE"))
+	{
+		return false;
+	}
+
+	result = reader.FindChunk("fmt ", chunk);
+	if (!result)
+	{
+		return false;
+	}
+
+	result = WaveFile::ParseFormat(chunk);
+	if (!result)
+	{
+		return false;
+	}
+
+	//The samples are used straight out of the data chunk, a cut short chunk keeps the whole frames that are there
+	result = reader.FindChunk("data", chunk);
+	if (!result)
+	{
+		return false;
+	}
+
+	this->m_samples = chunk.data;
+	if (this->m_formatTag != WAVE_FORMAT_TAG_IMA_ADPCM)
+	{
+		this->m_sampleSize = chunk.size - chunk.size % this->m_blockAlign;
+		this->m_frameCount = this->m_sampleSize / this->m_blockAlign;
+		return true;
+	}
+
+	//Compressed blocks each start with a header per channel, a cut short last block keeps the whole groups of eight codes it has
+	this->m_sampleSize = chunk.size;
+	this->m_frameCount = chunk.size / this->m_blockAlign * this->m_framesPerBlock;
+	if (chunk.size % this->m_blockAlign >= 4u * this->m_channels)
+	{
+		this->m_frameCount += (chunk.size % this->m_blockAlign - 4 * this->m_channels) / (4 * this->m_channels) * 8 + 1;
+	}
+
+	//The fact chunk says how many frames the last block really holds
+	result = reader.FindChunk("fact", chunk);
+	if (result && chunk.size >= 4 && RiffReader::ReadUInt(chunk.data) < this->m_frameCount)
+	{
+		this->m_frameCount = RiffReader::ReadUInt(chunk.data);
+	}
+
+	return true;
+}
+
+bool WaveFile::ParseFormat(const RiffReader::ChunkType& chunk)
+{
+	//The GUID of an extensible format is the format tag followed by these bytes
+	static const unsigned char subFormatBase[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+	unsigned short formatTag;
+	unsigned short channels;
+	unsigned int sampleRate;
+	unsigned short blockAlign;
+	unsigned short bitsPerSample;
+
+	if (chunk.size < 16)
+	{
+		return false;
+	}
+
+	formatTag = RiffReader::ReadUShort(chunk.data);
+	channels = RiffReader::ReadUShort(chunk.data + 2);
+	sampleRate = RiffReader::ReadUInt(chunk.data + 4);
+	blockAlign = RiffReader::ReadUShort(chunk.data + 12);
+	bitsPerSample = RiffReader::ReadUShort(chunk.data + 14);
+
+	//IMA ADPCM packs four bit codes in blocks, each channel gets four bytes of header and then groups of four bytes in turn
+	if (formatTag == WAVE_FORMAT_TAG_IMA_ADPCM)
+	{
+		if (chunk.size < 20 || bitsPerSample != 4 || channels == 0 || channels > WAVE_ADPCM_MAX_CHANNELS || sampleRate == 0)
+		{
+			return false;
+		}
+		if (blockAlign <= 4 * channels || blockAlign % (4 * channels) != 0 || RiffReader::ReadUShort(chunk.data + 18) != (blockAlign - 4 * channels) * 2 / channels + 1)
+		{
+			return false;
+		}
+
+		this->m_formatTag = formatTag;
+		this->m_channels = channels;
+		this->m_sampleRate = sampleRate;
+		this->m_framesPerBlock = RiffReader::ReadUShort(chunk.data + 18);
+		this->m_bytesPerSecond = (unsigned int)((unsigned long long)sampleRate * blockAlign / this->m_framesPerBlock);
+		this->m_blockAlign = blockAlign;
+		this->m_bitsPerSample = bitsPerSample;
+		return true;
+	}
+
+	//Extensible formats keep the real format tag at the front of the sub format
+	if (formatTag == WAVE_FORMAT_TAG_EXTENSIBLE)
+	{
+		if (chunk.size < 40 || RiffReader::ReadUShort(chunk.data + 16) < 22 || memcmp(chunk.data + 26, subFormatBase, sizeof(subFormatBase)) != 0)
+		{
+			return false;
+		}
+		formatTag = RiffReader::ReadUShort(chunk.data + 24);
+	}
+
+	//Integer PCM can be 8, 16, 24 or 32 bit, floats have to be 32 bit
+	if (formatTag == WAVE_FORMAT_TAG_PCM)
+	{
+		if (bitsPerSample != 8 && bitsPerSample != 16 && bitsPerSample != 24 && bitsPerSample != 32)
+		{
+			return false;
+		}
+	}
+	else if (formatTag == WAVE_FORMAT_TAG_IEEE_FLOAT)
+	{
+		if (bitsPerSample != 32)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+
+	//Any channel count and rate is fine as long as the frame size agrees with them and the byte rate fits
+	if (channels == 0 || sampleRate == 0 || blockAlign != (unsigned int)channels * (bitsPerSample / 8) || sampleRate > 0xFFFFFFFF / blockAlign)
+	{
+		return false;
+	}
+
+	this->m_formatTag = formatTag;
+	this->m_channels = channels;
+	this->m_sampleRate = sampleRate;
+	this->m_bytesPerSecond = sampleRate * blockAlign;
+	this->m_blockAlign = blockAlign;
+	this->m_bitsPerSample = bitsPerSample;
+	this->m_framesPerBlock = 1;
+
+	return true;
+}
+
+void WaveFile::DecodeAdpcm(size_t firstFrame, size_t frameCount, short* destination)
+{
+	const unsigned char* block;
+	const unsigned char* codes;
+	size_t blockIndex;
+	unsigned int start;
+	unsigned int end;
+	unsigned int frame;
+	unsigned int channel;
+	unsigned int stride;
+	unsigned int code;
+	unsigned int group;
+	int predictor;
+	int index;
+
+	stride = 4 * this->m_channels;
+	while (frameCount > 0)
+	{
+		//Every block decodes on its own, but within a block each code depends on the one before it
+		blockIndex = firstFrame / this->m_framesPerBlock;
+		start = (unsigned int)(firstFrame - blockIndex * this->m_framesPerBlock);
+		end = this->m_framesPerBlock;
+		if (blockIndex * this->m_framesPerBlock + end > this->m_frameCount)
+		{
+			end = (unsigned int)(this->m_frameCount - blockIndex * this->m_framesPerBlock);
+		}
+		if (end - start > frameCount)
+		{
+			end = start + (unsigned int)frameCount;
+		}
+		block = this->m_samples + blockIndex * this->m_blockAlign;
+
+		for (channel = 0; channel < this->m_channels; channel++)
+		{
+			//The header holds the first sample and where the step size starts
+			predictor = (short)RiffReader::ReadUShort(block + channel * 4);
+			index = block[channel * 4 + 2] > 88 ? 88 : block[channel * 4 + 2];
+			if (start == 0)
+			{
+				destination[channel] = (short)predictor;
+			}
+
+			//Eight codes per group of four bytes, low nibble first
+			codes = block + stride + channel * 4;
+			group = 0;
+			for (frame = 1; frame < end; frame++)
+			{
+				if (((frame - 1) & 7) == 0)
+				{
+					group = RiffReader::ReadUInt(codes);
+					codes += stride;
+				}
+				code = group & 15;
+				group >>= 4;
+
+				//One lookup gives both the difference and the next step, which keeps the chain from one code to the next short
+				predictor += adpcmTable.differences[index * 16 + code];
+				predictor = predictor > 32767 ? 32767 : (predictor < -32768 ? -32768 : predictor);
+				index = adpcmTable.indices[index * 16 + code];
+
+				if (frame >= start)
+				{
+					destination[(frame - start) * this->m_channels + channel] = (short)predictor;
+				}
+			}
+		}
+
+		destination += (end - start) * this->m_channels;
+		firstFrame += end - start;
+		frameCount -= end - start;
+	}
+}
+
+void WaveFile::Unmap()
+{
+	//Only files that were opened here are unmapped, data passed in by the caller belongs to the caller
+#ifdef _WIN32
+	if (this->m_mapped && this->m_data)
+	{
+		UnmapViewOfFile(this->m_data);
+	}
+	if (this->m_mappingHandle)
+	{
+		CloseHandle((HANDLE)this->m_mappingHandle);
+		this->m_mappingHandle = nullptr;
+	}
+	if (this->m_fileHandle)
+	{
+		CloseHandle((HANDLE)this->m_fileHandle);
+		this->m_fileHandle = nullptr;
+	}
+#else
+	if (this->m_mapped && this->m_data)
+	{
+		munmap((void*)this->m_data, this->m_size);
+	}
+	if (this->m_fileDescriptor >= 0)
+	{
+		close(this->m_fileDescriptor);
+		this->m_fileDescriptor = -1;
+	}
+#endif
+	this->m_data = nullptr;
+	this->m_size = 0;
+	this->m_mapped = false;
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: WaveFile.h
+////////////////////////////////////////////////////////////////////////////////
+#ifndef _WAVEFILE_H_
+#define _WAVEFILE_H_
+
+//////////////
+// INCLUDES //
+//////////////
+#include <cstddef>
+#include <cstring>
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "RiffReader.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned short WAVE_FORMAT_TAG_PCM = 1;
+const unsigned short WAVE_FORMAT_TAG_IEEE_FLOAT = 3;
+const unsigned short WAVE_FORMAT_TAG_IMA_ADPCM = 0x11;
+const unsigned short WAVE_FORMAT_TAG_EXTENSIBLE = 0xFFFE;
+
+//Compressed samples are decoded in runs of this many frames when converting to float
+const unsigned short WAVE_ADPCM_MAX_CHANNELS = 8;
+const size_t WAVE_DECODE_FRAMES = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+// Class name: WaveFile
+////////////////////////////////////////////////////////////////////////////////
+class WaveFile
+{
+private:
+	const unsigned char* m_data;
+	size_t m_size;
+	bool m_mapped;
+	void* m_fileHandle;
+	void* m_mappingHandle;
+	int m_fileDescriptor;
+
+	unsigned short m_formatTag;
+	unsigned short m_channels;
+	unsigned int m_sampleRate;
+	unsigned int m_bytesPerSecond;
+	unsigned short m_blockAlign;
+	unsigned short m_bitsPerSample;
+	unsigned int m_framesPerBlock;
+	const unsigned char* m_samples;
+	size_t m_sampleSize;
+	size_t m_frameCount;
+
+public:
+	WaveFile();
+	WaveFile(const WaveFile& other);
+	~WaveFile();
+
+	bool Initialize(const char* fileName);
+	bool Initialize(const void* data, size_t size);
+	void Shutdown();
+
+	unsigned short GetFormatTag();
+	unsigned short GetChannels();
+	unsigned int GetSampleRate();
+	unsigned int GetBytesPerSecond();
+	unsigned short GetBlockAlign();
+	unsigned short GetBitsPerSample();
+	unsigned int GetFramesPerBlock();
+	bool IsCompressed();
+	const unsigned char* GetSamples();
+	size_t GetSampleSize();
+	size_t GetFrameCount();
+
+	size_t ReadSamples(size_t firstFrame, size_t frameCount, float* destination);
+	size_t ReadSamples(size_t firstFrame, size_t frameCount, short* destination);
+
+private:
+	bool Parse();
+	bool ParseFormat(const RiffReader::ChunkType& chunk);
+	void DecodeAdpcm(size_t firstFrame, size_t frameCount, short* destination);
+	void Unmap();
+};
+
+#endif
\ No newline at end of file
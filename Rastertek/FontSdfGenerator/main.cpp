@@ -0,0 +1,406 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+using namespace std;
+
+/////////////
+// GLOBALS //
+/////////////
+const float EDT_INFINITY = 1e20f;
+
+//////////////
+// TYPEDEFS //
+//////////////
+
+//Only the fields of the DDS header needed for uncompressed atlases are named, the rest is copied through untouched
+struct DdsHeaderType
+{
+	unsigned int magic;
+	unsigned int size;
+	unsigned int flags;
+	unsigned int height;
+	unsigned int width;
+	unsigned int pitchOrLinearSize;
+	unsigned int depth;
+	unsigned int mipMapCount;
+	unsigned int reserved1[11];
+	unsigned int pixelFormatSize;
+	unsigned int pixelFormatFlags;
+	unsigned int fourCC;
+	unsigned int rgbBitCount;
+	unsigned int redBitMask;
+	unsigned int greenBitMask;
+	unsigned int blueBitMask;
+	unsigned int alphaBitMask;
+	unsigned int caps;
+	unsigned int caps2;
+	unsigned int caps3;
+	unsigned int caps4;
+	unsigned int reserved2;
+};
+
+struct ImageType
+{
+	int width;
+	int height;
+	vector<float> pixels;
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+bool LoadAtlas(char* filename, ImageType& coverage);
+bool SaveAtlas(char* filename, const ImageType& image);
+void DistanceTransform(ImageType& field, int threadCount);
+void TransformColumns(ImageType* field, int first, int last);
+void TransformRows(ImageType* field, int first, int last);
+void Transform1D(const float* f, float* d, int* v, float* z, int n);
+void BuildSignedField(const ImageType& coverage, ImageType& output, int downscale, float spread, int threadCount);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	bool result;
+	ImageType coverage;
+	ImageType output;
+	int downscale;
+	float spread;
+	int threadCount;
+
+	//Usage: FontSdfGenerator <source atlas.dds> <output atlas.dds> [downscale] [spread]
+	if (argc < 3)
+	{
+		cout << "Usage: FontSdfGenerator <source atlas.dds> <output atlas.dds> [downscale] [spread]" << endl;
+		cout << "  downscale  integer factor the source atlas is reduced by (default 1)" << endl;
+		cout << "  spread     distance in source pixels mapped to the full 0-1 range (default 4)" << endl;
+		return -1;
+	}
+
+	downscale = (argc > 3) ? atoi(argv[3]) : 1;
+	spread = (argc > 4) ? (float)atof(argv[4]) : 4.0f;
+	if (downscale < 1 || spread <= 0.0f)
+	{
+		cout << "Invalid downscale or spread" << endl;
+		return -1;
+	}
+
+	//Use every core, the rows and columns of the transform are independent
+	threadCount = (int)thread::hardware_concurrency();
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	//Read in the high resolution glyph atlas
+	result = LoadAtlas(argv[1], coverage);
+	if (!result)
+	{
+		cout << "Could not load " << argv[1] << endl;
+		return -1;
+	}
+
+	if ((coverage.width % downscale) != 0 || (coverage.height % downscale) != 0)
+	{
+		cout << "The atlas size must be a multiple of the downscale factor" << endl;
+		return -1;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	//Build the signed distance field and reduce it to the output size
+	BuildSignedField(coverage, output, downscale, spread, threadCount);
+
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+	//Display the sizes and timing to the screen for information purpose
+	cout << "Source: " << coverage.width << "x" << coverage.height << endl;
+	cout << "Output: " << output.width << "x" << output.height << endl;
+	cout << "Threads: " << threadCount << endl;
+	cout << "Time: " << chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0 << " ms" << endl;
+
+	//Write out the distance field atlas, the UVs in the font data file stay valid since the atlas is scaled uniformly
+	result = SaveAtlas(argv[2], output);
+	if (!result)
+	{
+		cout << "Could not write " << argv[2] << endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+bool LoadAtlas(char* filename, ImageType& coverage)
+{
+	ifstream fIn;
+	DdsHeaderType header;
+	vector<unsigned int> texels;
+	unsigned int redShift;
+
+	//Open the file
+	fIn.open(filename, ios::binary);
+	if (fIn.fail())
+	{
+		return false;
+	}
+
+	//Read in the header, only uncompressed 32 bit atlases are supported
+	fIn.read((char*)&header, sizeof(DdsHeaderType));
+	if (fIn.fail() || header.magic != 0x20534444 || header.rgbBitCount != 32 || header.redBitMask == 0)
+	{
+		return false;
+	}
+
+	texels.resize(header.width * header.height);
+	fIn.read((char*)&texels[0], texels.size() * sizeof(unsigned int));
+	if (fIn.fail())
+	{
+		return false;
+	}
+
+	//Close the file
+	fIn.close();
+
+	//The font shader treats any texel with a red value as part of a glyph so the same channel is used here
+	redShift = 0;
+	while (((header.redBitMask >> redShift) & 1) == 0)
+	{
+		redShift++;
+	}
+
+	coverage.width = (int)header.width;
+	coverage.height = (int)header.height;
+	coverage.pixels.resize(texels.size());
+	for (size_t i = 0; i < texels.size(); i++)
+	{
+		coverage.pixels[i] = (float)((texels[i] & header.redBitMask) >> redShift) / (float)(header.redBitMask >> redShift);
+	}
+
+	return true;
+}
+
+bool SaveAtlas(char* filename, const ImageType& image)
+{
+	ofstream fOut;
+	DdsHeaderType header;
+	vector<unsigned int> texels;
+	unsigned int value;
+
+	//Write the distance into every channel of an A8R8G8B8 texture so it loads like the bitmap atlas did
+	memset(&header, 0, sizeof(DdsHeaderType));
+	header.magic = 0x20534444;
+	header.size = 124;
+	header.flags = 0x100F;
+	header.height = image.height;
+	header.width = image.width;
+	header.pitchOrLinearSize = image.width * 4;
+	header.pixelFormatSize = 32;
+	header.pixelFormatFlags = 0x41;
+	header.rgbBitCount = 32;
+	header.redBitMask = 0x00FF0000;
+	header.greenBitMask = 0x0000FF00;
+	header.blueBitMask = 0x000000FF;
+	header.alphaBitMask = 0xFF000000;
+	header.caps = 0x1000;
+
+	texels.resize(image.pixels.size());
+	for (size_t i = 0; i < image.pixels.size(); i++)
+	{
+		value = (unsigned int)(image.pixels[i] * 255.0f + 0.5f);
+		texels[i] = (value << 24) | (value << 16) | (value << 8) | value;
+	}
+
+	//Open the output file
+	fOut.open(filename, ios::binary);
+	if (fOut.fail())
+	{
+		return false;
+	}
+
+	fOut.write((const char*)&header, sizeof(DdsHeaderType));
+	fOut.write((const char*)&texels[0], texels.size() * sizeof(unsigned int));
+
+	//Close the output file
+	fOut.close();
+
+	return !fOut.fail();
+}
+
+void DistanceTransform(ImageType& field, int threadCount)
+{
+	vector<thread> threads;
+	int first;
+	int last;
+
+	//The squared euclidean distance transform is separable, first every column is transformed then every row.
+	//Each pass is split in contiguous blocks over the worker threads
+	for (int i = 0; i < threadCount; i++)
+	{
+		first = (field.width * i) / threadCount;
+		last = (field.width * (i + 1)) / threadCount;
+		threads.push_back(thread(TransformColumns, &field, first, last));
+	}
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+	threads.clear();
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		first = (field.height * i) / threadCount;
+		last = (field.height * (i + 1)) / threadCount;
+		threads.push_back(thread(TransformRows, &field, first, last));
+	}
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+}
+
+void TransformColumns(ImageType* field, int first, int last)
+{
+	vector<float> f(field->height);
+	vector<float> d(field->height);
+	vector<int> v(field->height);
+	vector<float> z(field->height + 1);
+
+	for (int x = first; x < last; x++)
+	{
+		//Gather the column, transform it and scatter it back
+		for (int y = 0; y < field->height; y++)
+		{
+			f[y] = field->pixels[(y * field->width) + x];
+		}
+		Transform1D(&f[0], &d[0], &v[0], &z[0], field->height);
+		for (int y = 0; y < field->height; y++)
+		{
+			field->pixels[(y * field->width) + x] = d[y];
+		}
+	}
+}
+
+void TransformRows(ImageType* field, int first, int last)
+{
+	vector<float> d(field->width);
+	vector<int> v(field->width);
+	vector<float> z(field->width + 1);
+
+	for (int y = first; y < last; y++)
+	{
+		//Rows are contiguous so they are transformed in place through a copy of the result
+		float* row = &field->pixels[y * field->width];
+		Transform1D(row, &d[0], &v[0], &z[0], field->width);
+		memcpy(row, &d[0], field->width * sizeof(float));
+	}
+}
+
+void Transform1D(const float* f, float* d, int* v, float* z, int n)
+{
+	int k;
+	float s;
+
+	//Felzenszwalb and Huttenlocher's linear time lower envelope of parabolas rooted at every sample
+	k = 0;
+	v[0] = 0;
+	z[0] = -EDT_INFINITY;
+	z[1] = EDT_INFINITY;
+	for (int q = 1; q < n; q++)
+	{
+		s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+		while (s <= z[k])
+		{
+			k--;
+			s = ((f[q] + (float)(q * q)) - (f[v[k]] + (float)(v[k] * v[k]))) / (float)(2 * q - 2 * v[k]);
+		}
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = EDT_INFINITY;
+	}
+
+	//Read the distance of every sample off the envelope
+	k = 0;
+	for (int q = 0; q < n; q++)
+	{
+		while (z[k + 1] < (float)q)
+		{
+			k++;
+		}
+		d[q] = ((float)(q - v[k]) * (float)(q - v[k])) + f[v[k]];
+	}
+}
+
+void BuildSignedField(const ImageType& coverage, ImageType& output, int downscale, float spread, int threadCount)
+{
+	ImageType toInside;
+	ImageType toOutside;
+	float distance;
+	float sum;
+
+	//Seed one field with the glyph texels and the other with the background texels
+	toInside.width = toOutside.width = coverage.width;
+	toInside.height = toOutside.height = coverage.height;
+	toInside.pixels.resize(coverage.pixels.size());
+	toOutside.pixels.resize(coverage.pixels.size());
+	for (size_t i = 0; i < coverage.pixels.size(); i++)
+	{
+		bool inside = coverage.pixels[i] >= 0.5f;
+		toInside.pixels[i] = inside ? 0.0f : EDT_INFINITY;
+		toOutside.pixels[i] = inside ? EDT_INFINITY : 0.0f;
+	}
+
+	//Squared distance of every texel to the nearest glyph and to the nearest background texel
+	DistanceTransform(toInside, threadCount);
+	DistanceTransform(toOutside, threadCount);
+
+	//Combine them into a signed distance that is positive inside the glyphs, mapped so the glyph edge sits at 0.5,
+	//and box filter it down to the output size
+	output.width = coverage.width / downscale;
+	output.height = coverage.height / downscale;
+	output.pixels.resize(output.width * output.height);
+	for (int y = 0; y < output.height; y++)
+	{
+		for (int x = 0; x < output.width; x++)
+		{
+			sum = 0.0f;
+			for (int j = 0; j < downscale; j++)
+			{
+				for (int i = 0; i < downscale; i++)
+				{
+					int index = (((y * downscale) + j) * coverage.width) + (x * downscale) + i;
+					distance = sqrtf(toOutside.pixels[index]) - sqrtf(toInside.pixels[index]);
+
+					//The distances are measured between texel centers, shift them so the edge lies half a texel out
+					distance += (coverage.pixels[index] >= 0.5f) ? -0.5f : 0.5f;
+					sum += distance;
+				}
+			}
+			distance = sum / (float)(downscale * downscale);
+
+			distance = 0.5f + (distance / (2.0f * spread));
+			if (distance < 0.0f)
+			{
+				distance = 0.0f;
+			}
+			if (distance > 1.0f)
+			{
+				distance = 1.0f;
+			}
+			output.pixels[(y * output.width) + x] = distance;
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,5231 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <dirent.h>
+#include <strings.h>
+#endif
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "../Engine/Profiler.h"
+#include "../Engine/FrameStats.h"
+#include "../Engine/Timer.h"
+#include "../Engine/Fps.h"
+#include "../Engine/FixedStep.h"
+#include "../Engine/JobSystem.h"
+#include "../Engine/FramePipeline.h"
+#include "../Engine/CommandRecorder.h"
+#include "../Engine/LinearAllocator.h"
+#include "../Engine/FrameMemory.h"
+#include "../Engine/ObjectPool.h"
+#include "../Engine/SpriteQueue.h"
+#include "../Engine/FontLayout.h"
+#include "../Engine/TextSentence.h"
+#include "../Engine/DdsFile.h"
+#include "../Engine/TextureArrayPacker.h"
+
+/////////////
+// GLOBALS //
+/////////////
+
+//Frames the memory run leaves the arenas to grow in before it starts counting heap allocations
+const int MEMORY_WARM_UP_FRAMES = 10;
+const int MEMORY_BLOCK_SIZE = 64;
+const int MEMORY_TIMED_BATCH = 1024;
+
+//Every new in the process, the memory run checks the frame loop adds none once it is warm
+static atomic<unsigned long long> memoryHeapCount(0);
+
+//Objects the pool run has alive, its constructor and destructor keep count
+static int pooledLiveCount = 0;
+
+//Sprites the run order keeps on one texture before it picks another, and the depths the sprites are spread over
+const int SPRITE_BENCH_RUN = 32;
+const int SPRITE_BENCH_DEPTHS = 64;
+
+//Characters in the short text the font run lays out, a line or two of a chat window or a debug overlay
+const int FONT_BENCH_SHORT = 4000;
+
+//Sentences the text run keeps side by side in one buffer
+const int TEXT_BENCH_SENTENCES = 4;
+
+//The magic number and the four character codes the dds run writes its made up files with
+const unsigned int DDS_BENCH_MAGIC = 0x20534444;
+const unsigned int DDS_BENCH_DX10 = 0x30315844;
+const unsigned int DDS_BENCH_BC1 = 0x31545844;
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct BodyType
+{
+	float x;
+	float previousX;
+	float leftSpeed;
+	float rightSpeed;
+};
+
+//What the job checks and the scaling run share with their jobs
+struct ChainType
+{
+	atomic<int>* position;
+	atomic<bool>* failed;
+	int index;
+};
+
+struct FanType
+{
+	atomic<int> finished;
+	atomic<bool> failed;
+	int jobCount;
+};
+
+struct NestedType
+{
+	JobSystem* jobs;
+	int count;
+	atomic<int> passed;
+};
+
+struct WorkType
+{
+	float* results;
+	int iterations;
+};
+
+struct DrawType
+{
+	unsigned long long sortKey;
+	int model;
+	float position[3];
+};
+
+struct RecordType
+{
+	CommandRecorder* commands;
+	int frame;
+};
+
+struct KeyedDrawType
+{
+	unsigned long long sortKey;
+	CommandBuffer::DrawCommandType draw;
+};
+
+struct CheckMemoryType
+{
+	FrameMemory* memory;
+	unsigned char** blocks;
+	atomic<bool> failed;
+};
+
+struct ScratchType
+{
+	FrameMemory* memory;
+	float* results;
+	int frame;
+};
+
+struct SpriteInputType
+{
+	int texture;
+	float x;
+	float y;
+	float depth;
+};
+
+//The font the font run writes out for FontLayout to load, and lays text out with itself to check against
+struct ReferenceFontType
+{
+	vector<int> codepoints;
+	vector<float> left;
+	vector<float> right;
+	vector<int> size;
+	map<int, int> glyphs;
+	map<pair<int, int>, float> kerning;
+	int fallback;
+};
+
+//A made up DDS file, the header fields it is written with and what the parser should find in it
+struct DdsTestType
+{
+	const char* name;
+	unsigned int width;
+	unsigned int height;
+	unsigned int mipCount;
+	unsigned int pixelFlags;
+	unsigned int fourCC;
+	unsigned int bitCount;
+	unsigned int masks[4];
+	unsigned int caps2;
+	unsigned int dx10[4];
+	unsigned int format;
+	unsigned int arraySize;
+	bool cubeMap;
+	bool blockCompressed;
+};
+
+//One field of a made up file changed so the parser has to turn it down
+struct DdsBrokenType
+{
+	const char* name;
+	int test;
+	size_t offset;
+	unsigned int value;
+};
+
+//Stands in for a model, a texture, a light or a sentence, about their size
+class PooledObject
+{
+public:
+	float m_world[16];
+	int m_id;
+
+public:
+	PooledObject();
+	~PooledObject();
+};
+
+//Stands in for a device, checks the packets come in key order and each draw exactly once
+class CheckBackend : public CommandBackend
+{
+public:
+	vector<unsigned char> m_seen;
+	unsigned long long m_lastKey;
+	unsigned long long m_checksum;
+	unsigned int m_count;
+	int m_frame;
+	bool m_failed;
+
+public:
+	void Reset(int drawCount, int frame);
+	bool Execute(unsigned int type, const void* data);
+};
+
+//Made up stages with known results, every stage marks its slot busy so two stages on one frame are caught
+class BenchStages : public FrameStages
+{
+public:
+	int m_objectCount;
+	unsigned long long m_work;
+	float m_phase;
+	unsigned long long m_nextSubmit;
+	vector<unsigned long long> m_checksums;
+	vector<DrawType> m_draws[FRAME_PIPELINE_DEPTH];
+	atomic<int> m_busy[FRAME_PIPELINE_DEPTH];
+	atomic<bool> m_overlap;
+	atomic<bool> m_outOfOrder;
+
+public:
+	BenchStages(int objectCount, unsigned long long work);
+
+	void Simulate(FrameDataType& frame);
+	void Build(FrameDataType& frame);
+	bool Submit(FrameDataType& frame);
+
+private:
+	void Enter(FrameDataType& frame);
+	void Leave(FrameDataType& frame);
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+void PrintUsage();
+int ProfileBench(int argc, char* argv[]);
+bool CheckTree();
+bool CheckDropped();
+bool CheckSessions();
+bool CheckCounters();
+bool CheckTrace(const char* fileName);
+bool CheckNode(Profiler& profiler, const char* path, unsigned int callCount);
+void TimeScopes(int frameCount, int scopesPerFrame, double& scopeTime);
+void SimulateFrame(int drawCount);
+void ProfileWorker(int index, atomic<bool>* running);
+void Spin(unsigned long long nanoseconds);
+int StatsBench(int argc, char* argv[]);
+bool CheckPercentiles();
+bool CheckHitches();
+float GetExactPercentile(vector<float>& times, float percent);
+int StepBench(int argc, char* argv[]);
+bool RunSteps(float tickRate, int tickCount, const vector<float>& frameTimes, BodyType& body, float& largestStep);
+void TickBody(BodyType& body, float tickTime, int tick);
+int PipelineBench(int argc, char* argv[]);
+bool RunPipeline(BenchStages& stages, int threadCount, int frameCount, double& frameTime);
+void RunSerial(BenchStages& stages, int frameCount, double& frameTime);
+int JobsBench(int argc, char* argv[]);
+bool CheckJobs(int threadCount);
+bool CheckCounts(int* counts, int count, const char* what);
+double TimeJobs(int threadCount, int jobCount, bool parallelFor);
+double TimeWork(int threadCount, int itemCount, int iterations, double& checksum);
+void CountRange(void* data, int begin, int end);
+void ChainJob(void* data);
+void FanJob(void* data);
+void FanCheckJob(void* data);
+void NestedJob(void* data);
+void EmptyJob(void* data);
+void EmptyRange(void* data, int begin, int end);
+void WorkRange(void* data, int begin, int end);
+int RecordBench(int argc, char* argv[]);
+bool RunRecord(int threadCount, int drawCount, int frameCount, double& recordTime, double& sortTime, double& replayTime, unsigned long long& checksum);
+double RunVectorSort(int drawCount, int frameCount, unsigned long long& checksum);
+void RecordRange(void* data, int begin, int end);
+void MakeDraw(int index, int frame, unsigned long long& sortKey, CommandBuffer::DrawCommandType& draw);
+unsigned long long GetDrawKey(int index, int frame);
+int MemoryBench(int argc, char* argv[]);
+bool CheckArena();
+bool CheckFrameMemory(int threadCount);
+double TimeAllocations(int allocationCount, bool arena, unsigned long long& checksum);
+bool RunSteadyFrames(int threadCount, int frameCount, int itemCount, double& frameTime);
+void FillBlocks(void* data, int begin, int end);
+void ScratchRange(void* data, int begin, int end);
+int GetScratchVertexCount(int index, int frame);
+float GetScratchSum(int index, int frame);
+int PoolBench(int argc, char* argv[]);
+bool CheckPool();
+double TimeObjects(int objectCount, int roundCount, bool pooled, unsigned long long& checksum);
+void TimeLookups(int objectCount, double& pointerTime, double& handleTime);
+int SpriteBench(int argc, char* argv[]);
+bool CheckSpriteLimits();
+void MakeSprites(int spriteCount, int textureCount, bool runs, vector<SpriteInputType>& sprites);
+bool CheckSprites(const vector<SpriteInputType>& sprites);
+void TimeSprites(const vector<SpriteInputType>& sprites, int roundCount, double& queueTime, double& sortTime, double& buildTime, double& stableTime);
+void GetSpriteRect(int index, float* uvRect, float* color);
+int FontBench(int argc, char* argv[]);
+void MakeReferenceFont(bool fallback, ReferenceFontType& font);
+bool WriteReferenceFont(const ReferenceFontType& font, const char* fontFile, const char* kerningFile);
+string MakeFontText(int glyphCount, int seed);
+bool CheckFontLayout(const ReferenceFontType& font, const string& text, float scale);
+bool CheckBrokenFonts(const ReferenceFontType& font);
+int LayoutReference(const ReferenceFontType& font, const string& text, float positionX, float positionY, float fontHeight, const float* color, float scale, FontLayout::VertexType* vertices);
+void SetReferenceVertex(FontLayout::VertexType& vertex, float x, float y, float u, float v, const float* color);
+int DecodeReference(const unsigned char* text, int length, int& codepoint);
+string EncodeUtf8(int codepoint);
+bool TimeFontLayout(const ReferenceFontType& font, const string& text, int roundCount, double& layoutTime, int& quadCount);
+int TextBench(int argc, char* argv[]);
+bool CheckTextSentences(const ReferenceFontType& font, int updateCount);
+bool TimeTextSentences(const ReferenceFontType& font, int roundCount, double& updateTime, unsigned long long& uploadedBytes, unsigned long long& wholeBytes);
+int DdsBench(int argc, char* argv[]);
+bool ListDdsFiles(const string& directory, vector<string>& fileNames);
+bool CheckDdsFiles(const vector<string>& fileNames);
+bool CheckDdsSurfaces(DdsFile& file, const unsigned char* data, size_t size, const char* name);
+bool GetReferencePitch(unsigned int format, unsigned int width, unsigned int height, unsigned int& rowPitch, unsigned int& rows);
+void MakeDdsFile(const DdsTestType& test, vector<unsigned char>& file);
+void SetDdsValue(vector<unsigned char>& file, size_t offset, unsigned int value);
+bool CheckMadeDdsFiles();
+bool CheckBrokenDdsFiles();
+const DdsTestType* GetDdsTests(int& testCount);
+const DdsBrokenType* GetBrokenDdsTests(int& brokenCount);
+bool CheckTextureArrays();
+bool TimeDdsFiles(const vector<string>& fileNames, int roundCount, double& openTime);
+
+//The global new and delete, passed through to malloc with a count on the way
+void* operator new(size_t size)
+{
+	void* pointer;
+
+	memoryHeapCount.fetch_add(1, memory_order_relaxed);
+	pointer = malloc(size > 0 ? size : 1);
+	if (!pointer)
+	{
+		throw bad_alloc();
+	}
+
+	return pointer;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* pointer) throw()
+{
+	free(pointer);
+}
+
+void operator delete[](void* pointer) throw()
+{
+	free(pointer);
+}
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	//Usage: FrameBench <mode> [options]
+	if (argc < 2)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	if (strcmp(argv[1], "profile") == 0)
+	{
+		return ProfileBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "stats") == 0)
+	{
+		return StatsBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "step") == 0)
+	{
+		return StepBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "pipeline") == 0)
+	{
+		return PipelineBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "jobs") == 0)
+	{
+		return JobsBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "record") == 0)
+	{
+		return RecordBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "memory") == 0)
+	{
+		return MemoryBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "pool") == 0)
+	{
+		return PoolBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "sprites") == 0)
+	{
+		return SpriteBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "font") == 0)
+	{
+		return FontBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "text") == 0)
+	{
+		return TextBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "dds") == 0)
+	{
+		return DdsBench(argc - 2, argv + 2);
+	}
+
+	cout << "Unknown mode " << argv[1] << endl;
+	PrintUsage();
+	return -1;
+}
+
+void PrintUsage()
+{
+	cout << "Usage: FrameBench <mode> [options]" << endl;
+	cout << "  profile [-frames n] [-threads n] [-out file.json]" << endl;
+	cout << "    Checks the frame tree the profiler builds out of nested scopes on several threads, times a scope, then" << endl;
+	cout << "    profiles a made up frame loop with workers beside it and writes the capture as a Chrome trace" << endl;
+	cout << "    -frames   frames in the made up loop (default 120)" << endl;
+	cout << "    -threads  worker threads beside the main one (default 2)" << endl;
+	cout << "    -out      where the trace goes (default profile.json)" << endl;
+	cout << "  stats [-frames n] [-ms n] [-out file.csv]" << endl;
+	cout << "    Checks the streaming percentiles against sorted frame times and the hitch detection against known spikes," << endl;
+	cout << "    then times a headless frame loop with a spike now and then and writes the kept frames as CSV" << endl;
+	cout << "    -frames  frames in the timed loop (default 600)" << endl;
+	cout << "    -ms      work in each frame in milliseconds (default 2)" << endl;
+	cout << "    -out     where the frames go (default frametimes.csv)" << endl;
+	cout << "  step [-rate n] [-ticks n]" << endl;
+	cout << "    Replays the same keys through the fixed step at several frame rates and checks the simulation ends up in" << endl;
+	cout << "    exactly the same place, checks long stalls are skipped and the blend is smooth, then times it headless" << endl;
+	cout << "    -rate   ticks per second (default " << FIXED_STEP_DEFAULT_RATE << ")" << endl;
+	cout << "    -ticks  ticks in each replay (default 1200)" << endl;
+	cout << "  pipeline [-frames n] [-threads n] [-objects n] [-us n]" << endl;
+	cout << "    Runs made up simulate, build and submit stages three frames deep on the job system, checks every frame" << endl;
+	cout << "    comes out in order with the same draws as a serial run and no two stages share a frame, then times both" << endl;
+	cout << "    -frames   frames in each run (default 600)" << endl;
+	cout << "    -threads  job threads (default the cores less one)" << endl;
+	cout << "    -objects  objects the simulation moves (default 2000)" << endl;
+	cout << "    -us       work in each stage in microseconds (default 1000)" << endl;
+	cout << "  jobs [-threads n] [-jobs n] [-items n] [-iterations n]" << endl;
+	cout << "    Checks parallel for covers every index once, dependent jobs run in order, nested and outside waits work," << endl;
+	cout << "    then times the cost of a job and how a fixed amount of work scales from no workers up to -threads" << endl;
+	cout << "    -threads     most workers in the scaling run (default the cores less one, at least 3)" << endl;
+	cout << "    -jobs        jobs in the overhead run (default 1000000)" << endl;
+	cout << "    -items       items in the scaling run (default 4096)" << endl;
+	cout << "    -iterations  work in each item (default 20000)" << endl;
+	cout << "  record [-draws n] [-frames n] [-threads n]" << endl;
+	cout << "    Records draw packets on the job threads, sorts and replays them into a backend that checks the order," << endl;
+	cout << "    then times each step against one thread filling and sorting a plain vector of the same draws" << endl;
+	cout << "    -draws    draws in each frame (default 100000)" << endl;
+	cout << "    -frames   frames timed after the first (default 20)" << endl;
+	cout << "    -threads  job threads (default the cores less one)" << endl;
+	cout << "  memory [-frames n] [-threads n] [-items n] [-allocations n]" << endl;
+	cout << "    Checks the arenas line up, rewind, spill and grow, times an arena allocation against new and delete, then" << endl;
+	cout << "    runs a frame loop of scratch and frame allocations on the job threads and checks it makes no heap allocations" << endl;
+	cout << "    -frames       frames in the loop, the first " << MEMORY_WARM_UP_FRAMES << " warm the arenas up (default 600)" << endl;
+	cout << "    -threads      job threads (default the cores less one, at least 2)" << endl;
+	cout << "    -items        items each frame splits over the jobs (default 4096)" << endl;
+	cout << "    -allocations  allocations in the timed run (default 1000000)" << endl;
+	cout << "  pool [-objects n] [-rounds n]" << endl;
+	cout << "    Checks pool handles go stale when their object is destroyed and slots are reused, then times making and" << endl;
+	cout << "    freeing objects in the pool against new and delete and looking them up by handle against by pointer" << endl;
+	cout << "    -objects  objects made and freed each round (default 1000000)" << endl;
+	cout << "    -rounds   rounds timed after the first (default 5)" << endl;
+	cout << "  sprites [-sprites n] [-textures n] [-rounds n]" << endl;
+	cout << "    Queues sprites in runs that share a texture and in shuffled order, checks the sort groups them by texture," << endl;
+	cout << "    back to front within one and in queue order between equals, then times queueing, sorting and the quads" << endl;
+	cout << "    -sprites   sprites in the queue (default 100000)" << endl;
+	cout << "    -textures  textures they are spread over, at most " << SPRITE_MAX_TEXTURES << " (default 64)" << endl;
+	cout << "    -rounds    rounds timed after the first (default 20)" << endl;
+	cout << "  font [-glyphs n] [-rounds n]" << endl;
+	cout << "    Writes out made up fonts with multi-byte characters and kerned pairs, lays a long and a " << FONT_BENCH_SHORT << " character" << endl;
+	cout << "    text out with them and checks every quad against a plain scalar layout, then times the layout" << endl;
+	cout << "    -glyphs  characters in the long text (default 100000)" << endl;
+	cout << "    -rounds  rounds timed after the first (default 20)" << endl;
+	cout << "  text [-updates n] [-rounds n]" << endl;
+	cout << "    Changes sentences with made up text, numbers, moves, colors and scales, uploads their dirty glyphs into a" << endl;
+	cout << "    buffer and checks the ranges start and end on the glyphs that changed, then times a render count line" << endl;
+	cout << "    -updates  sentence updates in the check (default 20000)" << endl;
+	cout << "    -rounds   frames the render count line is timed over (default 20000)" << endl;
+	cout << "  dds [-dir path] [-rounds n]" << endl;
+	cout << "    Parses every .dds file in -dir mapped and from memory and checks each surface against a reference layout," << endl;
+	cout << "    does the same for made up BC chains, DX10 arrays and cube maps, checks every truncation and broken header" << endl;
+	cout << "    is turned down, checks texture arrays are packed from them slice by slice, then times mapping and parsing" << endl;
+	cout << "    -dir     where the files are (default ../Engine)" << endl;
+	cout << "    -rounds  rounds timed after the first (default 20)" << endl;
+}
+
+int ProfileBench(int argc, char* argv[])
+{
+	bool result;
+	Profiler profiler;
+	vector<thread> workers;
+	atomic<bool> running;
+	const char* outputFile;
+	int frameCount;
+	int threadCount;
+	int firstArgument;
+	int i;
+	double enabledTime;
+	double disabledTime;
+
+	frameCount = 120;
+	threadCount = 2;
+	outputFile = "profile.json";
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-frames") == 0)
+		{
+			frameCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-threads") == 0)
+		{
+			threadCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-out") == 0)
+		{
+			outputFile = argv[firstArgument + 1];
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || frameCount < 1 || threadCount < 0 || threadCount > PROFILER_MAX_THREADS - 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	if (!CheckTree() || !CheckDropped() || !CheckSessions() || !CheckCounters())
+	{
+		return -1;
+	}
+	cout << "Frame tree and counters: OK" << endl;
+
+	//What a scope costs is the difference to the same loop with nobody listening
+	TimeScopes(100, 10000, disabledTime);
+	result = profiler.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the profiler" << endl;
+		return -1;
+	}
+	TimeScopes(100, 10000, enabledTime);
+	profiler.Shutdown();
+	cout << "Scope: " << fixed << setprecision(1) << enabledTime - disabledTime << " ns recorded, " << disabledTime << " ns for the empty loop" << endl;
+
+	result = profiler.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the profiler" << endl;
+		return -1;
+	}
+
+	running = true;
+	for (i = 0; i < threadCount; i++)
+	{
+		workers.push_back(thread(ProfileWorker, i, &running));
+	}
+
+	profiler.StartCapture();
+	for (i = 0; i < frameCount; i++)
+	{
+		profiler.BeginFrame();
+		SimulateFrame(20);
+		profiler.EndFrame();
+	}
+	profiler.StopCapture();
+
+	running = false;
+	for (i = 0; i < threadCount; i++)
+	{
+		workers[i].join();
+	}
+
+	profiler.PrintFrame(stdout);
+	cout << "Captured " << profiler.GetCaptureEventCount() << " scopes over " << frameCount << " frames" << endl;
+
+	result = profiler.SaveTrace(outputFile);
+	if (!result)
+	{
+		cout << "Could not write " << outputFile << endl;
+		return -1;
+	}
+	profiler.Shutdown();
+
+	result = CheckTrace(outputFile);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Trace: " << outputFile << " OK" << endl;
+
+	return 0;
+}
+
+bool CheckTree()
+{
+	bool result;
+	Profiler profiler;
+	thread worker;
+	int node;
+	unsigned long long childTime;
+	size_t i;
+
+	result = profiler.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the profiler" << endl;
+		return false;
+	}
+
+	//Three calls of the same scope make one node, a worker gets a root of its own named after the thread
+	profiler.BeginFrame();
+	{
+		PROFILE_SCOPE("Update");
+		for (i = 0; i < 3; i++)
+		{
+			PROFILE_SCOPE("Update::Step");
+			Spin(20000);
+			{
+				PROFILE_SCOPE("Update::Step::Inner");
+				Spin(10000);
+			}
+		}
+	}
+	{
+		PROFILE_SCOPE("Render");
+		Spin(50000);
+	}
+	worker = thread([]()
+	{
+		ProfilerHandle->SetThreadName("Checker");
+		PROFILE_SCOPE("Job");
+		{
+			PROFILE_SCOPE("Job::Part");
+			Spin(10000);
+		}
+		{
+			PROFILE_SCOPE("Job::Part");
+			Spin(10000);
+		}
+	});
+	worker.join();
+	profiler.EndFrame();
+
+	result = CheckNode(profiler, "Frame", 1) && CheckNode(profiler, "Frame/Update", 1) && CheckNode(profiler, "Frame/Update/Update::Step", 3) &&
+		CheckNode(profiler, "Frame/Update/Update::Step/Update::Step::Inner", 3) && CheckNode(profiler, "Frame/Render", 1) &&
+		CheckNode(profiler, "Checker", 1) && CheckNode(profiler, "Checker/Job", 1) && CheckNode(profiler, "Checker/Job/Job::Part", 2);
+	if (!result)
+	{
+		profiler.PrintFrame(stdout);
+		return false;
+	}
+
+	//A parent covers its children and its own time is what is left
+	const vector<Profiler::NodeType>& nodes = profiler.GetFrameNodes();
+	for (i = 0; i < nodes.size(); i++)
+	{
+		childTime = 0;
+		for (node = nodes[i].firstChild; node != -1; node = nodes[node].nextSibling)
+		{
+			childTime += nodes[node].totalTime;
+		}
+		if (childTime > nodes[i].totalTime || nodes[i].selfTime != nodes[i].totalTime - childTime)
+		{
+			cout << "FAILED: " << nodes[i].name << " has " << nodes[i].totalTime << " ns with " << childTime << " ns of children and " << nodes[i].selfTime << " ns of its own" << endl;
+			return false;
+		}
+	}
+
+	node = profiler.FindNode("Frame/Update/Update::Step");
+	if (nodes[node].totalTime < 90000)
+	{
+		cout << "FAILED: three steps of 30 us took " << nodes[node].totalTime << " ns" << endl;
+		return false;
+	}
+
+	//Nothing recorded in the next frame leaves just the frame itself
+	profiler.BeginFrame();
+	profiler.EndFrame();
+	if (profiler.GetFrameNodes().size() != 1 || profiler.GetDroppedCount() != 0)
+	{
+		cout << "FAILED: an empty frame has " << profiler.GetFrameNodes().size() << " nodes" << endl;
+		return false;
+	}
+
+	profiler.Shutdown();
+
+	return true;
+}
+
+bool CheckDropped()
+{
+	bool result;
+	Profiler profiler;
+	unsigned int i;
+
+	result = profiler.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the profiler" << endl;
+		return false;
+	}
+
+	//A thread that records more than its ring holds between two frames loses the rest and says how many
+	profiler.BeginFrame();
+	for (i = 0; i < PROFILER_THREAD_EVENTS + 100; i++)
+	{
+		PROFILE_SCOPE("Flood");
+	}
+	profiler.EndFrame();
+
+	result = CheckNode(profiler, "Frame/Flood", PROFILER_THREAD_EVENTS);
+	if (!result)
+	{
+		return false;
+	}
+	if (profiler.GetDroppedCount() != 100)
+	{
+		cout << "FAILED: " << profiler.GetDroppedCount() << " scopes dropped instead of 100" << endl;
+		return false;
+	}
+
+	profiler.Shutdown();
+
+	return true;
+}
+
+bool CheckSessions()
+{
+	bool result;
+	Profiler first;
+	Profiler second;
+
+	//A thread that recorded into a profiler that was shut down gets a new buffer from the next one
+	result = first.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the profiler" << endl;
+		return false;
+	}
+	first.BeginFrame();
+	{
+		PROFILE_SCOPE("First");
+	}
+	first.EndFrame();
+	first.Shutdown();
+
+	{
+		PROFILE_SCOPE("Nobody");
+	}
+
+	result = second.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the profiler" << endl;
+		return false;
+	}
+	second.BeginFrame();
+	{
+		PROFILE_SCOPE("Second");
+	}
+	second.EndFrame();
+
+	result = CheckNode(second, "Frame/Second", 1) && second.FindNode("Frame/First") == -1 && second.FindNode("Frame/Nobody") == -1;
+	if (!result)
+	{
+		cout << "FAILED: the second profiler saw scopes from before it started" << endl;
+		return false;
+	}
+
+	second.Shutdown();
+
+	return true;
+}
+
+bool CheckCounters()
+{
+	bool result;
+	Profiler profiler;
+	thread worker;
+
+	result = profiler.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the profiler" << endl;
+		return false;
+	}
+
+	//Counters with the same name add up over the frame, whatever thread they come from
+	profiler.BeginFrame();
+	PROFILE_COUNTER("Bytes", 10);
+	PROFILE_COUNTER("Uploads", 3);
+	worker = thread([]()
+	{
+		PROFILE_COUNTER("Bytes", 5);
+	});
+	worker.join();
+	PROFILE_COUNTER("Bytes", 10);
+	profiler.EndFrame();
+
+	if (profiler.GetFrameCounters().size() != 2 || profiler.GetCounter("Bytes") != 25 || profiler.GetCounter("Uploads") != 3)
+	{
+		cout << "FAILED: the frame counted " << profiler.GetCounter("Bytes") << " bytes in " << profiler.GetCounter("Uploads") << " uploads instead of 25 in 3" << endl;
+		return false;
+	}
+
+	//The next frame starts from nothing
+	profiler.BeginFrame();
+	profiler.EndFrame();
+	if (!profiler.GetFrameCounters().empty() || profiler.GetCounter("Bytes") != 0)
+	{
+		cout << "FAILED: the counters of one frame were kept in the next" << endl;
+		return false;
+	}
+
+	profiler.Shutdown();
+
+	return true;
+}
+
+bool CheckTrace(const char* fileName)
+{
+	ifstream file;
+	stringstream text;
+	string trace;
+	size_t position;
+	int depth;
+	int eventCount;
+	bool inString;
+
+	file.open(fileName);
+	if (!file)
+	{
+		cout << "FAILED: could not read " << fileName << " back" << endl;
+		return false;
+	}
+	text << file.rdbuf();
+	trace = text.str();
+
+	//The brackets outside the strings have to balance for a JSON reader to take it
+	depth = 0;
+	eventCount = 0;
+	inString = false;
+	for (position = 0; position < trace.size(); position++)
+	{
+		if (inString)
+		{
+			if (trace[position] == '\\')
+			{
+				position++;
+			}
+			else if (trace[position] == '"')
+			{
+				inString = false;
+			}
+			continue;
+		}
+
+		switch (trace[position])
+		{
+		case '"':
+			inString = true;
+			break;
+		case '{':
+		case '[':
+			depth++;
+			break;
+		case '}':
+		case ']':
+			depth--;
+			break;
+		}
+		if (depth < 0)
+		{
+			break;
+		}
+	}
+	if (depth != 0 || inString)
+	{
+		cout << "FAILED: " << fileName << " is not balanced" << endl;
+		return false;
+	}
+
+	for (position = trace.find("\"ph\":\"X\""); position != string::npos; position = trace.find("\"ph\":\"X\"", position + 1))
+	{
+		eventCount++;
+	}
+	if (eventCount == 0 || trace.find("\"Say \\\"when\\\"\"") == string::npos || trace.find("\"thread_name\"") == string::npos || trace.find("\"ph\":\"C\"") == string::npos)
+	{
+		cout << "FAILED: " << fileName << " is missing events" << endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool CheckNode(Profiler& profiler, const char* path, unsigned int callCount)
+{
+	int node;
+
+	node = profiler.FindNode(path);
+	if (node == -1)
+	{
+		cout << "FAILED: no node at " << path << endl;
+		return false;
+	}
+	if (profiler.GetFrameNodes()[node].callCount != callCount)
+	{
+		cout << "FAILED: " << path << " was called " << profiler.GetFrameNodes()[node].callCount << " times instead of " << callCount << endl;
+		return false;
+	}
+
+	return true;
+}
+
+void TimeScopes(int frameCount, int scopesPerFrame, double& scopeTime)
+{
+	unsigned long long start;
+	unsigned long long total;
+	int i, j;
+
+	total = 0;
+	for (i = 0; i < frameCount; i++)
+	{
+		if (ProfilerHandle)
+		{
+			ProfilerHandle->BeginFrame();
+		}
+
+		start = Profiler::GetTime();
+		for (j = 0; j < scopesPerFrame; j++)
+		{
+			PROFILE_SCOPE("Empty");
+		}
+		total += Profiler::GetTime() - start;
+
+		if (ProfilerHandle)
+		{
+			ProfilerHandle->EndFrame();
+		}
+	}
+
+	scopeTime = (double)total / ((double)frameCount * scopesPerFrame);
+}
+
+void SimulateFrame(int drawCount)
+{
+	int i;
+
+	{
+		PROFILE_SCOPE("Input::Frame");
+		Spin(100000);
+	}
+
+	{
+		PROFILE_SCOPE("Graphics::Frame");
+		PROFILE_SCOPE("Graphics::Render");
+		for (i = 0; i < drawCount; i++)
+		{
+			PROFILE_SCOPE("Model::Render");
+			Spin(20000);
+		}
+		PROFILE_COUNTER("Draws", drawCount);
+		{
+			PROFILE_SCOPE("Text::UpdateSentence");
+			Spin(50000);
+		}
+		{
+			PROFILE_SCOPE("Say \"when\"");
+		}
+		{
+			PROFILE_SCOPE("Direct3D::EndScene");
+			Spin(500000);
+		}
+	}
+}
+
+void ProfileWorker(int index, atomic<bool>* running)
+{
+	char name[PROFILER_NAME_LENGTH];
+
+	sprintf(name, "Worker %d", index);
+	ProfilerHandle->SetThreadName(name);
+
+	while (running->load())
+	{
+		PROFILE_SCOPE("Job");
+		{
+			PROFILE_SCOPE("Job::Load");
+			Spin(200000);
+		}
+		{
+			PROFILE_SCOPE("Job::Decode");
+			Spin(300000);
+		}
+	}
+}
+
+void Spin(unsigned long long nanoseconds)
+{
+	unsigned long long end;
+
+	end = Profiler::GetTime() + nanoseconds;
+	while (Profiler::GetTime() < end)
+	{
+	}
+}
+
+int StatsBench(int argc, char* argv[])
+{
+	bool result;
+	FrameStats stats;
+	Timer timer;
+	Fps fps;
+	const char* outputFile;
+	unsigned long long start;
+	int frameCount;
+	int firstArgument;
+	int i;
+	float frameWork;
+	double addTime;
+
+	frameCount = 600;
+	frameWork = 2.0f;
+	outputFile = "frametimes.csv";
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-frames") == 0)
+		{
+			frameCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-ms") == 0)
+		{
+			frameWork = (float)atof(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-out") == 0)
+		{
+			outputFile = argv[firstArgument + 1];
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || frameCount < 1 || frameWork < 0.0f)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	if (!CheckPercentiles() || !CheckHitches())
+	{
+		return -1;
+	}
+
+	result = stats.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the frame statistics" << endl;
+		return -1;
+	}
+
+	//What recording a frame costs, it runs once a frame so it has to stay well under a microsecond
+	start = Profiler::GetTime();
+	for (i = 0; i < 1000000; i++)
+	{
+		stats.AddFrame(16.0f + (float)(i % 7));
+	}
+	addTime = (double)(Profiler::GetTime() - start) / 1000000.0;
+	cout << "AddFrame: " << fixed << setprecision(1) << addTime << " ns" << endl;
+	stats.Reset();
+
+	//The same timer the engine uses, with every tenth of a second of frames carrying a spike four times as long
+	result = timer.Intialize();
+	if (!result)
+	{
+		cout << "Could not initialize the timer" << endl;
+		return -1;
+	}
+	fps.Initialize();
+
+	for (i = 0; i < frameCount; i++)
+	{
+		Spin((unsigned long long)(frameWork * 1000000.0f) * (i % 100 == 99 ? 4 : 1));
+		timer.Frame();
+		fps.Frame();
+		stats.AddFrame(timer.GetTime());
+	}
+
+	cout << "Frames: " << stats.GetFrameCount() << ", " << fps.GetFps() << " in the last second" << endl;
+	cout << setprecision(3) << "Mean " << stats.GetMean() << " ms, deviation " << stats.GetStandardDeviation() << " ms, ";
+	cout << "min " << stats.GetMinimum() << " ms, max " << stats.GetMaximum() << " ms" << endl;
+	cout << "p50 " << stats.GetPercentile(50.0f) << " ms, p95 " << stats.GetPercentile(95.0f) << " ms, p99 " << stats.GetPercentile(99.0f);
+	cout << " ms, p99.9 " << stats.GetPercentile(99.9f) << " ms" << endl;
+	cout << "Hitches: " << stats.GetHitchCount() << endl;
+
+	result = stats.SaveCsv(outputFile);
+	if (!result)
+	{
+		cout << "Could not write " << outputFile << endl;
+		return -1;
+	}
+	cout << "Frames written to " << outputFile << endl;
+
+	stats.Shutdown();
+
+	return 0;
+}
+
+bool CheckPercentiles()
+{
+	bool result;
+	FrameStats stats;
+	mt19937 random(1);
+	lognormal_distribution<float> steady(log(16.6f), 0.1f);
+	uniform_real_distribution<float> spike(40.0f, 200.0f);
+	uniform_real_distribution<float> chance(0.0f, 1.0f);
+	vector<float> times;
+	float percents[5] = { 50.0f, 90.0f, 95.0f, 99.0f, 99.9f };
+	float estimate;
+	float exact;
+	double mean;
+	double squares;
+	int i;
+
+	result = stats.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the frame statistics" << endl;
+		return false;
+	}
+
+	//Mostly steady frames around 60 Hz with one in a hundred a long spike, the tail is what the percentiles are for
+	for (i = 0; i < 200000; i++)
+	{
+		times.push_back(chance(random) < 0.01f ? spike(random) : steady(random));
+		stats.AddFrame(times.back());
+	}
+
+	for (i = 0; i < 5; i++)
+	{
+		estimate = stats.GetPercentile(percents[i]);
+		exact = GetExactPercentile(times, percents[i]);
+		if (fabs(estimate - exact) > exact * 0.01f)
+		{
+			cout << "FAILED: p" << percents[i] << " is " << estimate << " ms instead of " << exact << " ms" << endl;
+			return false;
+		}
+	}
+
+	mean = 0.0;
+	for (i = 0; i < (int)times.size(); i++)
+	{
+		mean += times[i];
+	}
+	mean /= (double)times.size();
+	squares = 0.0;
+	for (i = 0; i < (int)times.size(); i++)
+	{
+		squares += (times[i] - mean) * (times[i] - mean);
+	}
+
+	sort(times.begin(), times.end());
+	if (fabs(stats.GetMean() - mean) > mean * 0.0001 || fabs(stats.GetStandardDeviation() - sqrt(squares / (times.size() - 1))) > 0.001 ||
+		stats.GetMinimum() != times.front() || stats.GetMaximum() != times.back())
+	{
+		cout << "FAILED: the mean, deviation or range is off" << endl;
+		return false;
+	}
+
+	stats.Shutdown();
+
+	return true;
+}
+
+bool CheckHitches()
+{
+	bool result;
+	FrameStats stats;
+	mt19937 random(2);
+	uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+	int hitchCount;
+	int stepHitches;
+	int i;
+	bool hitch;
+
+	result = stats.Initialize();
+	if (!result)
+	{
+		cout << "Could not initialize the frame statistics" << endl;
+		return false;
+	}
+
+	//A spike three times a jittery 60 Hz frame every 97 frames, and nothing else is a hitch
+	hitchCount = 0;
+	for (i = 0; i < 10000; i++)
+	{
+		hitch = stats.AddFrame(16.6f + jitter(random) + (i % 97 == 96 ? 33.2f : 0.0f));
+		if (hitch != (i % 97 == 96))
+		{
+			cout << "FAILED: frame " << i << (hitch ? " is" : " is not") << " a hitch" << endl;
+			return false;
+		}
+		hitchCount += hitch ? 1 : 0;
+	}
+
+	//Dropping to 20 Hz for good is a few hitches until the median catches up, not one every frame
+	stepHitches = 0;
+	for (i = 0; i < 1000; i++)
+	{
+		stepHitches += stats.AddFrame(50.0f + jitter(random)) ? 1 : 0;
+	}
+	if (stepHitches == 0 || stepHitches > FRAME_STATS_MEDIAN_FRAMES / 2 + 1 || stats.GetHitchCount() != (unsigned long long)(hitchCount + stepHitches))
+	{
+		cout << "FAILED: " << stepHitches << " hitches after the frame rate dropped" << endl;
+		return false;
+	}
+
+	stats.Shutdown();
+
+	return true;
+}
+
+float GetExactPercentile(vector<float>& times, float percent)
+{
+	vector<float> sorted;
+	size_t rank;
+
+	sorted = times;
+	sort(sorted.begin(), sorted.end());
+
+	rank = (size_t)ceil((double)percent / 100.0 * (double)sorted.size());
+	rank = max(rank, (size_t)1);
+
+	return sorted[rank - 1];
+}
+
+int StepBench(int argc, char* argv[])
+{
+	bool result;
+	FixedStep step;
+	BodyType reference;
+	BodyType body;
+	vector<float> frameTimes;
+	mt19937 random(3);
+	uniform_real_distribution<float> jitter(5.0f, 40.0f);
+	float frameRates[5] = { 30.0f, 60.0f, 75.0f, 144.0f, 240.0f };
+	float tickRate;
+	float largestStep;
+	float tickStep;
+	float alpha;
+	unsigned long long start;
+	long long elapsed;
+	int tickCount;
+	int firstArgument;
+	int i;
+	int ticks;
+
+	tickRate = FIXED_STEP_DEFAULT_RATE;
+	tickCount = 1200;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-rate") == 0)
+		{
+			tickRate = (float)atof(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-ticks") == 0)
+		{
+			tickCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || tickCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	result = step.Initialize(tickRate);
+	if (!result)
+	{
+		cout << "A tick rate of " << tickRate << " is not allowed" << endl;
+		return -1;
+	}
+
+	//Headless, every frame is exactly one tick long
+	frameTimes.assign(1, step.GetTickTime());
+	RunSteps(tickRate, tickCount, frameTimes, reference, tickStep);
+	cout << "Headless: " << tickCount << " ticks at " << fixed << setprecision(0) << tickRate << " Hz end at x = " << setprecision(6) << reference.x << endl;
+
+	//The same keys at any frame rate have to land on the same bits, and frames shorter than a tick have to share its move evenly
+	for (i = 0; i < 6; i++)
+	{
+		frameTimes.clear();
+		if (i < 5)
+		{
+			frameTimes.push_back(1000.0f / frameRates[i]);
+		}
+		else
+		{
+			for (ticks = 0; ticks < 1000; ticks++)
+			{
+				frameTimes.push_back(jitter(random));
+			}
+		}
+
+		result = RunSteps(tickRate, tickCount, frameTimes, body, largestStep);
+		if (!result)
+		{
+			return -1;
+		}
+		if (memcmp(&body, &reference, sizeof(BodyType)) != 0)
+		{
+			cout << "FAILED: at " << (i < 5 ? frameRates[i] : 0.0f) << " frames a second the body ends at x = " << body.x << endl;
+			return -1;
+		}
+		if (i < 5 && frameTimes[0] < step.GetTickTime() && largestStep > tickStep * frameTimes[0] / step.GetTickTime() * 1.001f)
+		{
+			cout << "FAILED: at " << frameRates[i] << " frames a second the blend jumps " << largestStep << " in a frame" << endl;
+			return -1;
+		}
+
+		if (i < 5)
+		{
+			cout << setprecision(0) << frameRates[i] << " Hz: ";
+		}
+		else
+		{
+			cout << "5 to 40 ms frames: ";
+		}
+		cout << "same end, largest move in one frame " << setprecision(4) << largestStep << " against " << tickStep << " in a tick" << endl;
+	}
+
+	//A one second stall runs the most ticks a frame may and drops the rest
+	step.Reset();
+	ticks = step.Advance(1000.0f);
+	if (ticks != FIXED_STEP_MAX_TICKS || step.GetSkippedTicks() != (unsigned long long)(1000000000LL / step.GetTickLength() - FIXED_STEP_MAX_TICKS))
+	{
+		cout << "FAILED: a one second stall ran " << ticks << " ticks and skipped " << step.GetSkippedTicks() << endl;
+		return -1;
+	}
+
+	//Frames add up to ticks and what is left over, nothing is lost in between
+	step.Reset();
+	elapsed = 0;
+	for (i = 0; i < 100000; i++)
+	{
+		elapsed += 1000000 + (i * 7919) % 20000000;
+		step.AdvanceNanoseconds(1000000 + (i * 7919) % 20000000);
+		alpha = step.GetAlpha();
+		if (alpha < 0.0f || alpha >= 1.0f)
+		{
+			cout << "FAILED: the blend is " << alpha << endl;
+			return -1;
+		}
+	}
+	if ((long long)step.GetTotalTicks() != elapsed / step.GetTickLength() || step.GetSkippedTicks() != 0)
+	{
+		cout << "FAILED: " << step.GetTotalTicks() << " ticks for " << elapsed << " ns" << endl;
+		return -1;
+	}
+	cout << "Stalls and leftovers: OK" << endl;
+
+	//With nothing to wait for the simulation runs as fast as the machine allows
+	start = Profiler::GetTime();
+	frameTimes.assign(1, step.GetTickTime());
+	RunSteps(tickRate, 10000000, frameTimes, body, largestStep);
+	elapsed = (long long)(Profiler::GetTime() - start);
+	cout << "Headless speed: " << setprecision(1) << 10000000.0 / ((double)elapsed / 1000000000.0) / 1000000.0 << " million ticks a second, ";
+	cout << setprecision(0) << 10000000.0 / tickRate / ((double)elapsed / 1000000000.0) << "x realtime" << endl;
+
+	return 0;
+}
+
+bool RunSteps(float tickRate, int tickCount, const vector<float>& frameTimes, BodyType& body, float& largestStep)
+{
+	bool result;
+	FixedStep step;
+	float rendered;
+	float lastRendered;
+	int tick;
+	int ticks;
+	int frame;
+	int i;
+
+	result = step.Initialize(tickRate);
+	if (!result)
+	{
+		return false;
+	}
+
+	memset(&body, 0, sizeof(BodyType));
+	lastRendered = 0.0f;
+	largestStep = 0.0f;
+	tick = 0;
+	frame = 0;
+	while (tick < tickCount)
+	{
+		ticks = step.Advance(frameTimes[frame % frameTimes.size()]);
+		for (i = 0; i < ticks && tick < tickCount; i++)
+		{
+			TickBody(body, step.GetTickTime(), tick);
+			tick++;
+		}
+
+		//What the frame would draw, between the last two ticks
+		rendered = body.previousX + (body.x - body.previousX) * step.GetAlpha();
+		largestStep = max(largestStep, fabs(rendered - lastRendered));
+		lastRendered = rendered;
+		frame++;
+	}
+
+	return true;
+}
+
+void TickBody(BodyType& body, float tickTime, int tick)
+{
+	bool left;
+	bool right;
+
+	//The recorded keys for this tick, the same replay every time
+	left = (tick % 600) >= 30 && (tick % 600) < 150;
+	right = (tick % 600) >= 200 && (tick % 600) < 420;
+
+	//The same speed up, cap and slow down as Position
+	body.previousX = body.x;
+	if (left)
+	{
+		body.leftSpeed = min(body.leftSpeed + tickTime * 0.001f, tickTime * 0.03f);
+	}
+	else
+	{
+		body.leftSpeed = max(body.leftSpeed - tickTime * 0.0007f, 0.0f);
+	}
+	if (right)
+	{
+		body.rightSpeed = min(body.rightSpeed + tickTime * 0.001f, tickTime * 0.03f);
+	}
+	else
+	{
+		body.rightSpeed = max(body.rightSpeed - tickTime * 0.0007f, 0.0f);
+	}
+	body.x += body.rightSpeed - body.leftSpeed;
+}
+
+int PipelineBench(int argc, char* argv[])
+{
+	bool result;
+	double serialTime;
+	double pipelinedTime;
+	double inlineTime;
+	int frameCount;
+	int threadCount;
+	int objectCount;
+	int work;
+	int firstArgument;
+
+	frameCount = 600;
+	threadCount = -1;
+	objectCount = 2000;
+	work = 1000;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-frames") == 0)
+		{
+			frameCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-threads") == 0)
+		{
+			threadCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-objects") == 0)
+		{
+			objectCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-us") == 0)
+		{
+			work = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || frameCount < 1 || objectCount < 0 || work < 0)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	//The serial run is the reference, one frame all the way through before the next
+	BenchStages serial(objectCount, (unsigned long long)work * 1000);
+	RunSerial(serial, frameCount, serialTime);
+
+	//With no job threads every job runs inside the wait, the results have to be the same
+	BenchStages inlined(objectCount, (unsigned long long)work * 1000);
+	result = RunPipeline(inlined, 0, frameCount, inlineTime);
+	if (!result || inlined.m_checksums != serial.m_checksums)
+	{
+		cout << "FAILED: the pipeline without job threads does not draw what the serial run does" << endl;
+		return -1;
+	}
+
+	BenchStages pipelined(objectCount, (unsigned long long)work * 1000);
+	result = RunPipeline(pipelined, threadCount, frameCount, pipelinedTime);
+	if (!result || pipelined.m_checksums != serial.m_checksums)
+	{
+		cout << "FAILED: the pipeline does not draw what the serial run does" << endl;
+		return -1;
+	}
+	cout << "Same draws in the same order as the serial run, no stage shared a frame: OK" << endl;
+
+	cout << fixed << setprecision(3);
+	cout << "Serial:              " << serialTime << " ms a frame" << endl;
+	cout << "Pipelined, inline:   " << inlineTime << " ms a frame" << endl;
+	cout << "Pipelined, threaded: " << pipelinedTime << " ms a frame on " << thread::hardware_concurrency() << " cores, ";
+	cout << setprecision(2) << serialTime / pipelinedTime << "x" << endl;
+
+	return 0;
+}
+
+bool RunPipeline(BenchStages& stages, int threadCount, int frameCount, double& frameTime)
+{
+	bool result;
+	JobSystem jobs;
+	FramePipeline pipeline;
+	FrameStages::FrameDataType* frame;
+	unsigned long long start;
+	int i;
+
+	result = jobs.Initialize(threadCount);
+	if (!result)
+	{
+		return false;
+	}
+
+	result = pipeline.Initialize(&stages, &jobs);
+	if (!result)
+	{
+		jobs.Shutdown();
+		return false;
+	}
+
+	start = Profiler::GetTime();
+	for (i = 0; i < frameCount && result; i++)
+	{
+		frame = pipeline.BeginFrame();
+		frame->frameTime = 16.0f + (float)(i % 7);
+		frame->buttons = (unsigned int)(i / 60) & 3;
+		result = pipeline.RunFrame();
+
+		//Once it is full the pipeline always holds the two frames behind the one just simulated
+		if (result && pipeline.GetFramesInFlight() != min(i + 1, FRAME_PIPELINE_DEPTH - 1))
+		{
+			cout << "FAILED: " << pipeline.GetFramesInFlight() << " frames in flight after frame " << i << endl;
+			result = false;
+		}
+	}
+
+	//The frames still in flight come out at the end
+	if (result)
+	{
+		result = pipeline.Flush();
+	}
+	frameTime = (double)(Profiler::GetTime() - start) / 1000000.0 / (double)frameCount;
+
+	if (result && (pipeline.GetFramesInFlight() != 0 || pipeline.GetSubmittedCount() != (unsigned long long)frameCount))
+	{
+		cout << "FAILED: " << pipeline.GetSubmittedCount() << " of " << frameCount << " frames submitted after the flush" << endl;
+		result = false;
+	}
+
+	pipeline.Shutdown();
+	jobs.Shutdown();
+
+	if (stages.m_overlap || stages.m_outOfOrder)
+	{
+		cout << "FAILED: " << (stages.m_overlap ? "two stages ran on one frame" : "the frames were submitted out of order") << endl;
+		return false;
+	}
+
+	return result;
+}
+
+void RunSerial(BenchStages& stages, int frameCount, double& frameTime)
+{
+	FrameStages::FrameDataType frame;
+	unsigned long long start;
+	int i;
+
+	start = Profiler::GetTime();
+	for (i = 0; i < frameCount; i++)
+	{
+		frame.number = (unsigned long long)i;
+		frame.frameTime = 16.0f + (float)(i % 7);
+		frame.buttons = (unsigned int)(i / 60) & 3;
+		frame.tickCount = 0;
+		frame.objects.clear();
+		stages.Simulate(frame);
+		stages.Build(frame);
+		stages.Submit(frame);
+	}
+	frameTime = (double)(Profiler::GetTime() - start) / 1000000.0 / (double)frameCount;
+}
+
+BenchStages::BenchStages(int objectCount, unsigned long long work)
+{
+	int i;
+
+	this->m_objectCount = objectCount;
+	this->m_work = work;
+	this->m_phase = 0.0f;
+	this->m_nextSubmit = 0;
+	for (i = 0; i < FRAME_PIPELINE_DEPTH; i++)
+	{
+		this->m_busy[i] = 0;
+	}
+	this->m_overlap = false;
+	this->m_outOfOrder = false;
+}
+
+void BenchStages::Simulate(FrameDataType& frame)
+{
+	ObjectType object;
+	float angle;
+	int i;
+
+	BenchStages::Enter(frame);
+
+	//The phase carries from frame to frame, so simulating out of order would move everything somewhere else
+	this->m_phase += frame.frameTime * 0.001f * (frame.buttons & 1 ? -1.0f : 1.0f);
+	frame.tickCount = 1;
+	frame.cameraPosition[0] = sinf(this->m_phase) * 50.0f;
+	frame.cameraPosition[1] = 2.0f;
+	frame.cameraPosition[2] = cosf(this->m_phase) * 50.0f;
+
+	for (i = 0; i < this->m_objectCount; i++)
+	{
+		angle = this->m_phase * (float)(i % 13 + 1) * 0.1f + (float)i;
+		object.model = i % 5;
+		object.position[0] = sinf(angle) * (float)(i % 1200);
+		object.position[1] = (float)(i % 17);
+		object.position[2] = cosf(angle) * (float)(i % 1200);
+		object.radius = 1.0f + (float)(i % 3);
+		frame.objects.push_back(object);
+	}
+	Spin(this->m_work);
+
+	BenchStages::Leave(frame);
+}
+
+void BenchStages::Build(FrameDataType& frame)
+{
+	vector<DrawType>* draws;
+	DrawType draw;
+	float offset[3];
+	float distance;
+	size_t i;
+	int j;
+
+	BenchStages::Enter(frame);
+
+	//The draws stay with the stages until the frame is submitted, like the commands Graphics records
+	draws = &this->m_draws[frame.number % FRAME_PIPELINE_DEPTH];
+	draws->clear();
+
+	//The same culling and front to back keys as Graphics::BuildFrame
+	for (i = 0; i < frame.objects.size(); i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			offset[j] = frame.objects[i].position[j] - frame.cameraPosition[j];
+		}
+		distance = offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2];
+		if (sqrtf(distance) - frame.objects[i].radius > 1000.0f)
+		{
+			continue;
+		}
+
+		draw.model = frame.objects[i].model;
+		memcpy(draw.position, frame.objects[i].position, sizeof(draw.position));
+		draw.sortKey = 0;
+		memcpy(&draw.sortKey, &distance, sizeof(float));
+		draw.sortKey = (draw.sortKey << 16) | (unsigned int)draw.model;
+		draws->push_back(draw);
+	}
+	sort(draws->begin(), draws->end(), [](const DrawType& a, const DrawType& b) { return a.sortKey < b.sortKey; });
+	Spin(this->m_work);
+
+	BenchStages::Leave(frame);
+}
+
+bool BenchStages::Submit(FrameDataType& frame)
+{
+	vector<DrawType>* draws;
+	unsigned long long checksum;
+	unsigned int bits;
+	size_t i;
+	int j;
+
+	BenchStages::Enter(frame);
+
+	if (frame.number != this->m_nextSubmit)
+	{
+		this->m_outOfOrder = true;
+	}
+	this->m_nextSubmit = frame.number + 1;
+
+	//FNV-1a over what would be drawn, in the order it would be drawn
+	checksum = 14695981039346656037ULL;
+	draws = &this->m_draws[frame.number % FRAME_PIPELINE_DEPTH];
+	for (i = 0; i < draws->size(); i++)
+	{
+		checksum = (checksum ^ (unsigned long long)(*draws)[i].model) * 1099511628211ULL;
+		for (j = 0; j < 3; j++)
+		{
+			memcpy(&bits, &(*draws)[i].position[j], sizeof(bits));
+			checksum = (checksum ^ bits) * 1099511628211ULL;
+		}
+	}
+	this->m_checksums.push_back(checksum ^ draws->size());
+	Spin(this->m_work);
+
+	BenchStages::Leave(frame);
+
+	return true;
+}
+
+void BenchStages::Enter(FrameDataType& frame)
+{
+	if (this->m_busy[frame.number % FRAME_PIPELINE_DEPTH].exchange(1) != 0)
+	{
+		this->m_overlap = true;
+	}
+}
+
+void BenchStages::Leave(FrameDataType& frame)
+{
+	this->m_busy[frame.number % FRAME_PIPELINE_DEPTH] = 0;
+}
+
+int JobsBench(int argc, char* argv[])
+{
+	bool result;
+	double baseTime;
+	double time;
+	double baseChecksum;
+	double checksum;
+	int threadCount;
+	int jobCount;
+	int itemCount;
+	int iterations;
+	int firstArgument;
+	int i;
+
+	threadCount = max((int)thread::hardware_concurrency() - 1, 3);
+	jobCount = 1000000;
+	itemCount = 4096;
+	iterations = 20000;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-threads") == 0)
+		{
+			threadCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-jobs") == 0)
+		{
+			jobCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-items") == 0)
+		{
+			itemCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-iterations") == 0)
+		{
+			iterations = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || threadCount < 0 || jobCount < 1 || itemCount < 1 || iterations < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	//The same checks with every job inline, with one worker and with several
+	for (i = 0; i < 3; i++)
+	{
+		result = CheckJobs(i == 0 ? 0 : (i == 1 ? 1 : max(threadCount, 2)));
+		if (!result)
+		{
+			return -1;
+		}
+	}
+	cout << "Parallel for, dependencies, nested and outside waits: OK" << endl;
+
+	//What handing out a job costs, one at a time from the main thread and split up by parallel for
+	cout << fixed << setprecision(1);
+	cout << "Run and wait, no workers:     " << TimeJobs(0, jobCount, false) << " ns a job" << endl;
+	cout << "Run and wait, " << threadCount << " workers:      " << TimeJobs(threadCount, jobCount, false) << " ns a job" << endl;
+	cout << "Parallel for, no workers:     " << TimeJobs(0, jobCount, true) << " ns an item" << endl;
+	cout << "Parallel for, " << threadCount << " workers:      " << TimeJobs(threadCount, jobCount, true) << " ns an item" << endl;
+
+	//The same work on more threads, the efficiency is the speed up over the thread count
+	cout << "Scaling over " << itemCount << " items on " << thread::hardware_concurrency() << " cores:" << endl;
+	baseTime = TimeWork(0, itemCount, iterations, baseChecksum);
+	for (i = 0; i <= threadCount; i++)
+	{
+		time = i == 0 ? baseTime : TimeWork(i, itemCount, iterations, checksum);
+		if (i > 0 && checksum != baseChecksum)
+		{
+			cout << "FAILED: " << i << " workers worked out something else" << endl;
+			return -1;
+		}
+		cout << "  " << i + 1 << " threads: " << setprecision(2) << time << " ms, " << baseTime / time << "x, ";
+		cout << setprecision(0) << baseTime / time / (double)(i + 1) * 100.0 << "% efficient" << endl;
+	}
+
+	return 0;
+}
+
+bool CheckJobs(int threadCount)
+{
+	bool result;
+	JobSystem jobs;
+	JobCounter counter;
+	JobCounter fanCounter;
+	JobCounter checkCounter;
+	JobCounter chainCounters[1000];
+	ChainType chain[1000];
+	FanType fan;
+	NestedType nested;
+	atomic<int> position;
+	atomic<bool> failed;
+	vector<int> counts;
+	int batchSizes[4] = { 1, 7, 1000, 200000 };
+	int i;
+
+	result = jobs.Initialize(threadCount);
+	if (!result)
+	{
+		cout << "FAILED: the job system did not start with " << threadCount << " workers" << endl;
+		return false;
+	}
+
+	//Every index once whatever the batch size
+	for (i = 0; i < 4 && result; i++)
+	{
+		counts.assign(100000, 0);
+		jobs.ParallelFor(CountRange, &counts[0], (int)counts.size(), batchSizes[i], &counter);
+		jobs.Wait(&counter);
+		result = CheckCounts(&counts[0], (int)counts.size(), "parallel for");
+	}
+
+	//A chain handed out all at once still runs one after the other
+	position = 0;
+	failed = false;
+	for (i = 0; i < 1000 && result; i++)
+	{
+		chain[i].position = &position;
+		chain[i].failed = &failed;
+		chain[i].index = i;
+		jobs.RunAfter(i > 0 ? &chainCounters[i - 1] : nullptr, ChainJob, &chain[i], &chainCounters[i]);
+	}
+
+	//A job after a batch sees the whole batch finished
+	fan.finished = 0;
+	fan.failed = false;
+	fan.jobCount = 64;
+	for (i = 0; i < fan.jobCount; i++)
+	{
+		jobs.Run(FanJob, &fan, &fanCounter);
+	}
+	jobs.RunAfter(&fanCounter, FanCheckJob, &fan, &checkCounter);
+
+	jobs.Wait(&chainCounters[999]);
+	jobs.Wait(&checkCounter);
+	if (result && (failed || position != 1000))
+	{
+		cout << "FAILED: the chain ran out of order with " << threadCount << " workers" << endl;
+		result = false;
+	}
+	if (result && fan.failed)
+	{
+		cout << "FAILED: the job after the batch ran before it finished with " << threadCount << " workers" << endl;
+		result = false;
+	}
+
+	//A job that waits on jobs of its own, the way a build job splits up its culling
+	if (result)
+	{
+		nested.jobs = &jobs;
+		nested.count = 50000;
+		nested.passed = 0;
+		for (i = 0; i < 4; i++)
+		{
+			jobs.Run(NestedJob, &nested, &counter);
+		}
+		jobs.Wait(&counter);
+		if (nested.passed != 4)
+		{
+			cout << "FAILED: " << 4 - nested.passed << " of 4 nested waits went wrong with " << threadCount << " workers" << endl;
+			result = false;
+		}
+	}
+
+	//A thread the job system does not know, like the sound mixer, hands out work and waits on it too
+	if (result)
+	{
+		counts.assign(100000, 0);
+		thread outside([&jobs, &counts]()
+		{
+			JobCounter outsideCounter;
+
+			jobs.ParallelFor(CountRange, &counts[0], (int)counts.size(), 64, &outsideCounter);
+			jobs.Wait(&outsideCounter);
+		});
+		outside.join();
+		result = CheckCounts(&counts[0], (int)counts.size(), "an outside thread");
+	}
+
+	jobs.Shutdown();
+
+	return result;
+}
+
+bool CheckCounts(int* counts, int count, const char* what)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (counts[i] != 1)
+		{
+			cout << "FAILED: " << what << " ran index " << i << " " << counts[i] << " times" << endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+double TimeJobs(int threadCount, int jobCount, bool parallelFor)
+{
+	JobSystem jobs;
+	JobCounter counter;
+	unsigned long long start;
+	int i;
+
+	jobs.Initialize(threadCount);
+
+	start = Profiler::GetTime();
+	if (parallelFor)
+	{
+		jobs.ParallelFor(EmptyRange, nullptr, jobCount, 1, &counter);
+	}
+	else
+	{
+		for (i = 0; i < jobCount; i++)
+		{
+			jobs.Run(EmptyJob, nullptr, &counter);
+		}
+	}
+	jobs.Wait(&counter);
+
+	jobs.Shutdown();
+
+	return (double)(Profiler::GetTime() - start) / (double)jobCount;
+}
+
+double TimeWork(int threadCount, int itemCount, int iterations, double& checksum)
+{
+	JobSystem jobs;
+	JobCounter counter;
+	WorkType work;
+	vector<float> results;
+	unsigned long long start;
+	double time;
+	int i;
+
+	jobs.Initialize(threadCount);
+	results.assign(itemCount, 0.0f);
+	work.results = &results[0];
+	work.iterations = iterations;
+
+	start = Profiler::GetTime();
+	jobs.ParallelFor(WorkRange, &work, itemCount, 16, &counter);
+	jobs.Wait(&counter);
+	time = (double)(Profiler::GetTime() - start) / 1000000.0;
+
+	jobs.Shutdown();
+
+	checksum = 0.0;
+	for (i = 0; i < itemCount; i++)
+	{
+		checksum += results[i];
+	}
+
+	return time;
+}
+
+void CountRange(void* data, int begin, int end)
+{
+	int* counts;
+	int i;
+
+	counts = (int*)data;
+	for (i = begin; i < end; i++)
+	{
+		counts[i]++;
+	}
+}
+
+void ChainJob(void* data)
+{
+	ChainType* chain;
+
+	chain = (ChainType*)data;
+	if (chain->position->fetch_add(1) != chain->index)
+	{
+		*chain->failed = true;
+	}
+}
+
+void FanJob(void* data)
+{
+	FanType* fan;
+
+	fan = (FanType*)data;
+	Spin(2000);
+	fan->finished++;
+}
+
+void FanCheckJob(void* data)
+{
+	FanType* fan;
+
+	fan = (FanType*)data;
+	if (fan->finished != fan->jobCount)
+	{
+		fan->failed = true;
+	}
+}
+
+void NestedJob(void* data)
+{
+	NestedType* nested;
+	JobCounter counter;
+	vector<int> counts;
+	int i;
+
+	//Each job counts into its own array, the wait inside a job runs other jobs including the other nested ones
+	nested = (NestedType*)data;
+	counts.assign(nested->count, 0);
+	nested->jobs->ParallelFor(CountRange, &counts[0], nested->count, 256, &counter);
+	nested->jobs->Wait(&counter);
+
+	for (i = 0; i < nested->count && counts[i] == 1; i++)
+	{
+	}
+	if (i == nested->count)
+	{
+		nested->passed++;
+	}
+}
+
+void EmptyJob(void* data)
+{
+}
+
+void EmptyRange(void* data, int begin, int end)
+{
+}
+
+void WorkRange(void* data, int begin, int end)
+{
+	WorkType* work;
+	float value;
+	int i;
+	int j;
+
+	//Plain arithmetic with nothing shared, so any loss is the scheduler's
+	work = (WorkType*)data;
+	for (i = begin; i < end; i++)
+	{
+		value = (float)i;
+		for (j = 0; j < work->iterations; j++)
+		{
+			value = value * 0.9999f + 1.0f;
+		}
+		work->results[i] = value;
+	}
+}
+
+int RecordBench(int argc, char* argv[])
+{
+	bool result;
+	double recordTime;
+	double sortTime;
+	double replayTime;
+	double vectorTime;
+	unsigned long long checksum;
+	unsigned long long vectorChecksum;
+	int drawCount;
+	int frameCount;
+	int threadCount;
+	int firstArgument;
+	int i;
+
+	drawCount = 100000;
+	frameCount = 20;
+	threadCount = -1;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-draws") == 0)
+		{
+			drawCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-frames") == 0)
+		{
+			frameCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-threads") == 0)
+		{
+			threadCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || drawCount < 1 || frameCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	//The plain vector is what one thread building its own draw list costs
+	vectorTime = RunVectorSort(drawCount, frameCount, vectorChecksum);
+
+	cout << fixed << setprecision(1);
+	cout << drawCount << " draws a frame, " << thread::hardware_concurrency() << " cores" << endl;
+	cout << "  One thread, vector and sort: " << vectorTime / (double)drawCount * 1000000.0 << " ns a draw" << endl;
+	for (i = 0; i < 2; i++)
+	{
+		result = RunRecord(i == 0 ? 0 : threadCount, drawCount, frameCount, recordTime, sortTime, replayTime, checksum);
+		if (!result)
+		{
+			return -1;
+		}
+		if (checksum != vectorChecksum)
+		{
+			cout << "FAILED: the replay does not match the sorted vector" << endl;
+			return -1;
+		}
+
+		cout << "  " << (i == 0 ? "No workers:   " : "Job threads:  ") << "record " << recordTime / (double)drawCount * 1000000.0 << " ns, ";
+		cout << "sort " << sortTime / (double)drawCount * 1000000.0 << " ns, replay " << replayTime / (double)drawCount * 1000000.0 << " ns a draw, ";
+		cout << setprecision(2) << (double)drawCount / recordTime / 1000.0 << " million recorded a second" << setprecision(1) << endl;
+	}
+	cout << "Replayed in key order, every draw once, the buffer pool stays bounded: OK" << endl;
+
+	return 0;
+}
+
+bool RunRecord(int threadCount, int drawCount, int frameCount, double& recordTime, double& sortTime, double& replayTime, unsigned long long& checksum)
+{
+	bool result;
+	JobSystem jobs;
+	CommandRecorder commands;
+	CheckBackend backend;
+	JobCounter counter;
+	RecordType record;
+	unsigned long long start;
+	unsigned long long recorded;
+	unsigned long long sorted;
+	unsigned int bufferCount;
+	unsigned int neededCount;
+	int frame;
+
+	result = jobs.Initialize(threadCount);
+	if (!result)
+	{
+		return false;
+	}
+
+	result = commands.Initialize(&jobs);
+	if (!result)
+	{
+		jobs.Shutdown();
+		return false;
+	}
+
+	//The first frame sizes the buffers and is not timed
+	recordTime = 0.0;
+	sortTime = 0.0;
+	replayTime = 0.0;
+	checksum = 0;
+	bufferCount = 0;
+	for (frame = 0; frame <= frameCount && result; frame++)
+	{
+		record.commands = &commands;
+		record.frame = frame;
+		backend.Reset(drawCount, frame);
+
+		start = Profiler::GetTime();
+		commands.Reset();
+		jobs.ParallelFor(RecordRange, &record, drawCount, 256, &counter);
+		jobs.Wait(&counter);
+		recorded = Profiler::GetTime();
+		commands.Sort();
+		sorted = Profiler::GetTime();
+		result = commands.Replay(&backend);
+
+		if (frame == 0)
+		{
+			bufferCount = commands.GetBufferCount();
+			continue;
+		}
+		recordTime += (double)(recorded - start) / 1000000.0;
+		sortTime += (double)(sorted - recorded) / 1000000.0;
+		replayTime += (double)(Profiler::GetTime() - sorted) / 1000000.0;
+		checksum ^= backend.m_checksum * (unsigned long long)(frame * 2 + 1);
+
+		if (!result || backend.m_failed || backend.m_count != (unsigned int)drawCount)
+		{
+			cout << "FAILED: frame " << frame << " replayed " << backend.m_count << " of " << drawCount << " draws" << (backend.m_failed ? " out of order" : "") << endl;
+			result = false;
+		}
+	}
+
+	//Which thread records what changes from frame to frame, so the pool may take a few more buffers than the first frame did
+	//It never needs more than the packets fill plus a part full buffer on each thread
+	neededCount = (unsigned int)(((unsigned long long)drawCount * (sizeof(CommandBuffer::PacketType) + sizeof(CommandBuffer::DrawCommandType)) + COMMAND_BUFFER_SIZE - 1) / COMMAND_BUFFER_SIZE);
+	if (result && commands.GetBufferCount() > neededCount + (unsigned int)jobs.GetThreadSlotCount())
+	{
+		cout << "FAILED: " << commands.GetBufferCount() << " buffers for what fits in " << neededCount << endl;
+		result = false;
+	}
+	if (result)
+	{
+		cout << "  " << bufferCount << " buffers after the first frame, " << commands.GetBufferCount() - bufferCount << " more over the next " << frameCount << endl;
+	}
+
+	commands.Shutdown();
+	jobs.Shutdown();
+
+	recordTime /= (double)frameCount;
+	sortTime /= (double)frameCount;
+	replayTime /= (double)frameCount;
+
+	return result;
+}
+
+double RunVectorSort(int drawCount, int frameCount, unsigned long long& checksum)
+{
+	CheckBackend backend;
+	vector<KeyedDrawType> draws;
+	unsigned long long start;
+	double time;
+	int frame;
+	int i;
+
+	time = 0.0;
+	checksum = 0;
+	for (frame = 0; frame <= frameCount; frame++)
+	{
+		backend.Reset(drawCount, frame);
+
+		start = Profiler::GetTime();
+		draws.resize(drawCount);
+		for (i = 0; i < drawCount; i++)
+		{
+			MakeDraw(i, frame, draws[i].sortKey, draws[i].draw);
+		}
+		sort(draws.begin(), draws.end(), [](const KeyedDrawType& a, const KeyedDrawType& b) { return a.sortKey < b.sortKey; });
+		for (i = 0; i < drawCount; i++)
+		{
+			backend.Execute(COMMAND_DRAW, &draws[i].draw);
+		}
+
+		if (frame > 0)
+		{
+			time += (double)(Profiler::GetTime() - start) / 1000000.0;
+			checksum ^= backend.m_checksum * (unsigned long long)(frame * 2 + 1);
+		}
+	}
+
+	return time / (double)frameCount;
+}
+
+void RecordRange(void* data, int begin, int end)
+{
+	RecordType* record;
+	CommandBuffer::DrawCommandType draw;
+	unsigned long long sortKey;
+	int i;
+
+	record = (RecordType*)data;
+	for (i = begin; i < end; i++)
+	{
+		MakeDraw(i, record->frame, sortKey, draw);
+		record->commands->Record(sortKey, COMMAND_DRAW, &draw, sizeof(draw));
+	}
+}
+
+void MakeDraw(int index, int frame, unsigned long long& sortKey, CommandBuffer::DrawCommandType& draw)
+{
+	//The draw carries its own index in the model so the backend can tell which one it is
+	sortKey = GetDrawKey(index, frame);
+	draw.model = index;
+	draw.shader = index % 3;
+	memset(draw.world, 0, sizeof(draw.world));
+	draw.world[0] = 1.0f;
+	draw.world[5] = 1.0f;
+	draw.world[10] = 1.0f;
+	draw.world[15] = 1.0f;
+	draw.world[12] = (float)(index % 1000);
+	draw.world[13] = (float)(frame % 7);
+	draw.world[14] = (float)(index / 1000);
+}
+
+unsigned long long GetDrawKey(int index, int frame)
+{
+	unsigned long long key;
+
+	//Scattered but unique, the index in the low bits breaks every tie
+	key = (unsigned long long)(unsigned int)index * 0x9E3779B97F4A7C15ULL + (unsigned long long)frame * 0xBF58476D1CE4E5B9ULL;
+	return (key & 0xFFFFFFFF00000000ULL) | (unsigned long long)(unsigned int)index;
+}
+
+void CheckBackend::Reset(int drawCount, int frame)
+{
+	this->m_seen.assign(drawCount, 0);
+	this->m_lastKey = 0;
+	this->m_checksum = 14695981039346656037ULL;
+	this->m_count = 0;
+	this->m_failed = false;
+	this->m_frame = frame;
+}
+
+bool CheckBackend::Execute(unsigned int type, const void* data)
+{
+	const CommandBuffer::DrawCommandType* draw;
+	unsigned long long key;
+	unsigned int bits;
+	int i;
+
+	draw = (const CommandBuffer::DrawCommandType*)data;
+	if (type != COMMAND_DRAW || draw->model < 0 || draw->model >= (int)this->m_seen.size() || this->m_seen[draw->model])
+	{
+		this->m_failed = true;
+		return false;
+	}
+	this->m_seen[draw->model] = 1;
+
+	key = GetDrawKey(draw->model, this->m_frame);
+	if (this->m_count > 0 && key <= this->m_lastKey)
+	{
+		this->m_failed = true;
+	}
+	this->m_lastKey = key;
+	this->m_count++;
+
+	//FNV-1a over the draws in the order they came
+	this->m_checksum = (this->m_checksum ^ (unsigned long long)draw->model) * 1099511628211ULL;
+	for (i = 12; i < 15; i++)
+	{
+		memcpy(&bits, &draw->world[i], sizeof(bits));
+		this->m_checksum = (this->m_checksum ^ bits) * 1099511628211ULL;
+	}
+
+	return true;
+}
+
+int MemoryBench(int argc, char* argv[])
+{
+	bool result;
+	double heapTime;
+	double arenaTime;
+	double frameTime;
+	unsigned long long heapChecksum;
+	unsigned long long arenaChecksum;
+	int threadCount;
+	int frameCount;
+	int itemCount;
+	int allocationCount;
+	int firstArgument;
+
+	threadCount = max((int)thread::hardware_concurrency() - 1, 2);
+	frameCount = 600;
+	itemCount = 4096;
+	allocationCount = 1000000;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-frames") == 0)
+		{
+			frameCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-threads") == 0)
+		{
+			threadCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-items") == 0)
+		{
+			itemCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-allocations") == 0)
+		{
+			allocationCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || threadCount < 0 || frameCount <= MEMORY_WARM_UP_FRAMES || itemCount < 1 || allocationCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	result = CheckArena();
+	if (!result)
+	{
+		return -1;
+	}
+
+	result = CheckFrameMemory(threadCount);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Alignment, rewinding, spilling and growing, one scratch arena a job thread: OK" << endl;
+
+	//What one allocation costs, freed a frame's worth at a time the way the arenas give it back
+	heapTime = TimeAllocations(allocationCount, false, heapChecksum);
+	arenaTime = TimeAllocations(allocationCount, true, arenaChecksum);
+	if (heapChecksum != arenaChecksum)
+	{
+		cout << "FAILED: the arena handed back something else than the heap" << endl;
+		return -1;
+	}
+	cout << fixed << setprecision(1);
+	cout << "new and delete: " << heapTime << " ns an allocation" << endl;
+	cout << "Arena:          " << arenaTime << " ns an allocation, " << heapTime / arenaTime << "x" << endl;
+
+	result = RunSteadyFrames(threadCount, frameCount, itemCount, frameTime);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << setprecision(3) << frameCount - MEMORY_WARM_UP_FRAMES << " frames of " << itemCount << " items on " << threadCount;
+	cout << " workers after " << MEMORY_WARM_UP_FRAMES << " to warm up, " << frameTime << " ms a frame, no heap allocations: OK" << endl;
+
+	return 0;
+}
+
+bool CheckArena()
+{
+	LinearAllocator arena;
+	unsigned char* pointer;
+	unsigned char* again;
+	unsigned char* spill;
+	size_t alignment;
+	size_t marker;
+	bool result;
+
+	result = arena.Initialize(4096);
+	if (!result)
+	{
+		cout << "FAILED: the arena did not start" << endl;
+		return false;
+	}
+
+	//Odd sizes in between so every alignment has to move the offset
+	for (alignment = 1; alignment <= 256 && result; alignment *= 2)
+	{
+		arena.Allocate(3, 1);
+		pointer = (unsigned char*)arena.Allocate(40, alignment);
+		if (!pointer || (size_t)pointer % alignment != 0)
+		{
+			cout << "FAILED: an allocation is not lined up to " << alignment << endl;
+			result = false;
+		}
+	}
+
+	//Rewinding hands the same memory out again
+	marker = arena.GetMarker();
+	pointer = (unsigned char*)arena.Allocate(100, 16);
+	arena.Rewind(marker);
+	again = (unsigned char*)arena.Allocate(100, 16);
+	if (result && (!pointer || pointer != again || arena.GetMarker() < marker + 100))
+	{
+		cout << "FAILED: the rewind did not give the memory back" << endl;
+		result = false;
+	}
+
+	//Past the end it spills to the heap, the reset grows the block so the same asks fit next time
+	spill = (unsigned char*)arena.Allocate(8192, 64);
+	if (result && (!spill || (size_t)spill % 64 != 0 || arena.GetHeapAllocationCount() != 2))
+	{
+		cout << "FAILED: the arena did not spill to the heap" << endl;
+		result = false;
+	}
+	if (spill)
+	{
+		memset(spill, 0xAB, 8192);
+	}
+
+	arena.Reset();
+	if (result && (arena.GetHeapAllocationCount() != 3 || arena.GetCapacity() < 4096 + 8192 || arena.GetPeak() < 8192))
+	{
+		cout << "FAILED: the reset did not grow the arena to fit, " << arena.GetCapacity() << " bytes" << endl;
+		result = false;
+	}
+
+	arena.Allocate(4000, 16);
+	arena.Allocate(8192, 64);
+	arena.Reset();
+	if (result && arena.GetHeapAllocationCount() != 3)
+	{
+		cout << "FAILED: the grown arena still went to the heap" << endl;
+		result = false;
+	}
+
+	arena.Shutdown();
+
+	return result;
+}
+
+bool CheckFrameMemory(int threadCount)
+{
+	bool result;
+	JobSystem jobs;
+	FrameMemory memory;
+	JobCounter counter;
+	CheckMemoryType check;
+	vector<unsigned char*> blocks;
+	unsigned char* pointer;
+	size_t marker;
+	unsigned long long heapCount;
+	int frame;
+	int i;
+	int j;
+
+	result = jobs.Initialize(threadCount);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Small enough that the first frame spills everywhere
+	result = memory.Initialize(&jobs, 1024, 256);
+	if (!result)
+	{
+		jobs.Shutdown();
+		return false;
+	}
+
+	//Every thread takes blocks of the shared arena at once, none may overlap and all have to last the frame
+	blocks.assign(20000, nullptr);
+	check.memory = &memory;
+	check.blocks = &blocks[0];
+	check.failed = false;
+	for (frame = 0; frame < 2 && result; frame++)
+	{
+		jobs.ParallelFor(FillBlocks, &check, (int)blocks.size(), 64, &counter);
+		jobs.Wait(&counter);
+
+		for (i = 0; i < (int)blocks.size() && result; i++)
+		{
+			for (j = 0; j < MEMORY_BLOCK_SIZE; j++)
+			{
+				if (blocks[i][j] != (unsigned char)(i * 31 + j))
+				{
+					cout << "FAILED: block " << i << " was written over" << endl;
+					result = false;
+					break;
+				}
+			}
+		}
+		if (result && check.failed)
+		{
+			cout << "FAILED: a scratch rewind on a job thread did not give the memory back" << endl;
+			result = false;
+		}
+
+		//The first frame spilt and grew the arenas it used, the second fits
+		memory.EndFrame();
+		heapCount = memory.GetFrameHeapAllocationCount();
+		if (result && (frame == 0 ? heapCount == 0 : heapCount != 0))
+		{
+			cout << "FAILED: frame " << frame << " made " << heapCount << " heap allocations" << endl;
+			result = false;
+		}
+	}
+
+	//This thread's scratch arena spills once and grows to fit, the others never went past what they started with
+	if (result)
+	{
+		marker = memory.GetScratchMarker();
+		pointer = (unsigned char*)memory.AllocateScratch(1000, 16);
+		memory.RewindScratch(marker);
+		memory.EndFrame();
+		heapCount = memory.GetFrameHeapAllocationCount();
+
+		pointer = (unsigned char*)memory.AllocateScratch(1000, 16);
+		memory.EndFrame();
+		if (heapCount != 2 || memory.GetFrameHeapAllocationCount() != 0)
+		{
+			cout << "FAILED: the scratch arena did not grow to fit, " << heapCount << " heap allocations" << endl;
+			result = false;
+		}
+	}
+
+	//A scratch scope gives its memory back however its block is left, breaking out early included
+	if (result)
+	{
+		marker = memory.GetScratchMarker();
+		for (i = 0; i < 4; i++)
+		{
+			ScratchScope scope(&memory);
+			pointer = (unsigned char*)scope.Allocate(100, 16);
+			if (pointer)
+			{
+				break;
+			}
+		}
+		if (!pointer || memory.GetScratchMarker() != marker)
+		{
+			cout << "FAILED: a scratch scope did not rewind when it was left" << endl;
+			result = false;
+		}
+		memory.EndFrame();
+	}
+
+	//A thread outside the job system gets frame memory, which it cannot rewind
+	if (result)
+	{
+		pointer = nullptr;
+		marker = 1;
+		thread outside([&memory, &pointer, &marker]()
+		{
+			marker = memory.GetScratchMarker();
+			pointer = (unsigned char*)memory.AllocateScratch(64, 16);
+			memory.RewindScratch(marker);
+		});
+		outside.join();
+		if (!pointer || marker != 0)
+		{
+			cout << "FAILED: an outside thread did not get frame memory for its scratch" << endl;
+			result = false;
+		}
+		memory.EndFrame();
+	}
+
+	memory.Shutdown();
+	jobs.Shutdown();
+
+	return result;
+}
+
+double TimeAllocations(int allocationCount, bool arena, unsigned long long& checksum)
+{
+	LinearAllocator allocator;
+	vector<unsigned char*> pointers;
+	unsigned char* pointer;
+	unsigned long long start;
+	double time;
+	int count;
+	int i;
+	int j;
+
+	allocator.Initialize(MEMORY_TIMED_BATCH * 256);
+	pointers.resize(MEMORY_TIMED_BATCH);
+
+	//A frame's worth at a time, mixed sizes the way vertex arrays and culling lists are
+	checksum = 0;
+	start = Profiler::GetTime();
+	for (i = 0; i < allocationCount; i += MEMORY_TIMED_BATCH)
+	{
+		count = min(MEMORY_TIMED_BATCH, allocationCount - i);
+		for (j = 0; j < count; j++)
+		{
+			if (arena)
+			{
+				pointer = (unsigned char*)allocator.Allocate(16 + (j % 15) * 16, 16);
+			}
+			else
+			{
+				pointer = new unsigned char[16 + (j % 15) * 16];
+			}
+			pointer[0] = (unsigned char)j;
+			pointer[15] = (unsigned char)i;
+			pointers[j] = pointer;
+		}
+
+		for (j = 0; j < count; j++)
+		{
+			checksum = checksum * 31 + pointers[j][0] + pointers[j][15];
+			if (!arena)
+			{
+				delete[] pointers[j];
+			}
+		}
+		if (arena)
+		{
+			allocator.Reset();
+		}
+	}
+	time = (double)(Profiler::GetTime() - start) / (double)allocationCount;
+
+	allocator.Shutdown();
+
+	return time;
+}
+
+bool RunSteadyFrames(int threadCount, int frameCount, int itemCount, double& frameTime)
+{
+	bool result;
+	JobSystem jobs;
+	FrameMemory memory;
+	JobCounter counter;
+	ScratchType scratch;
+	unsigned long long start;
+	unsigned long long heapCount;
+	unsigned long long frameHeapCount;
+	double sum;
+	double expected;
+	int frame;
+	int i;
+
+	result = jobs.Initialize(threadCount);
+	if (!result)
+	{
+		return false;
+	}
+
+	//The frame arena starts too small for the results, so the first frame has to grow it
+	result = memory.Initialize(&jobs, 1024, 16 * 1024);
+	if (!result)
+	{
+		jobs.Shutdown();
+		return false;
+	}
+
+	frameTime = 0.0;
+	heapCount = 0;
+	frameHeapCount = 0;
+	for (frame = 0; frame < frameCount && result; frame++)
+	{
+		if (frame == MEMORY_WARM_UP_FRAMES)
+		{
+			heapCount = memoryHeapCount.load();
+		}
+
+		start = Profiler::GetTime();
+		scratch.memory = &memory;
+		scratch.frame = frame;
+		scratch.results = (float*)memory.AllocateFrame(sizeof(float) * itemCount, LINEAR_ALLOCATOR_ALIGNMENT);
+		jobs.ParallelFor(ScratchRange, &scratch, itemCount, 64, &counter);
+		jobs.Wait(&counter);
+
+		sum = 0.0;
+		for (i = 0; i < itemCount; i++)
+		{
+			sum += scratch.results[i];
+		}
+		memory.EndFrame();
+
+		if (frame >= MEMORY_WARM_UP_FRAMES)
+		{
+			frameTime += (double)(Profiler::GetTime() - start) / 1000000.0;
+			frameHeapCount += memory.GetFrameHeapAllocationCount();
+		}
+
+		//The same sums worked out in order on this thread
+		expected = 0.0;
+		for (i = 0; i < itemCount; i++)
+		{
+			expected += GetScratchSum(i, frame);
+		}
+		if (sum != expected)
+		{
+			cout << "FAILED: frame " << frame << " added up to " << sum << " rather than " << expected << endl;
+			result = false;
+		}
+	}
+
+	//The arenas count their own heap use, the hooks on new count everything else in the process too
+	heapCount = memoryHeapCount.load() - heapCount;
+	if (result && (heapCount != 0 || frameHeapCount != 0))
+	{
+		cout << "FAILED: " << heapCount << " heap allocations, " << frameHeapCount << " by the arenas, after the warm up" << endl;
+		result = false;
+	}
+	if (result)
+	{
+		cout << "  Frame arena peak " << memory.GetFramePeak() << " bytes, largest scratch peak " << memory.GetScratchPeak() << " bytes" << endl;
+	}
+
+	memory.Shutdown();
+	jobs.Shutdown();
+
+	frameTime /= (double)(frameCount - MEMORY_WARM_UP_FRAMES);
+
+	return result;
+}
+
+void FillBlocks(void* data, int begin, int end)
+{
+	CheckMemoryType* check;
+	unsigned char* block;
+	unsigned char* scratch;
+	unsigned char* again;
+	size_t marker;
+	int i;
+	int j;
+
+	check = (CheckMemoryType*)data;
+	for (i = begin; i < end; i++)
+	{
+		block = (unsigned char*)check->memory->AllocateFrame(MEMORY_BLOCK_SIZE, 16);
+		for (j = 0; j < MEMORY_BLOCK_SIZE; j++)
+		{
+			block[j] = (unsigned char)(i * 31 + j);
+		}
+		check->blocks[i] = block;
+
+		//A job thread has its own scratch arena, so what it rewinds it gets straight back
+		marker = check->memory->GetScratchMarker();
+		scratch = (unsigned char*)check->memory->AllocateScratch(200, 16);
+		memset(scratch, 0xCD, 200);
+		check->memory->RewindScratch(marker);
+		again = (unsigned char*)check->memory->AllocateScratch(200, 16);
+		check->memory->RewindScratch(marker);
+		if (scratch != again)
+		{
+			check->failed = true;
+		}
+	}
+}
+
+void ScratchRange(void* data, int begin, int end)
+{
+	ScratchType* scratch;
+	float* vertices;
+	size_t marker;
+	int vertexCount;
+	int i;
+	int j;
+
+	//Each item builds a throwaway array of its own size and gives it back before the next one
+	scratch = (ScratchType*)data;
+	for (i = begin; i < end; i++)
+	{
+		marker = scratch->memory->GetScratchMarker();
+		vertexCount = GetScratchVertexCount(i, scratch->frame);
+		vertices = (float*)scratch->memory->AllocateScratch(sizeof(float) * vertexCount, LINEAR_ALLOCATOR_ALIGNMENT);
+		for (j = 0; j < vertexCount; j++)
+		{
+			vertices[j] = (float)((i + j) % 5);
+		}
+
+		scratch->results[i] = 0.0f;
+		for (j = 0; j < vertexCount; j++)
+		{
+			scratch->results[i] += vertices[j];
+		}
+		scratch->memory->RewindScratch(marker);
+	}
+}
+
+int GetScratchVertexCount(int index, int frame)
+{
+	return 16 + (index * 7 + frame) % 240;
+}
+
+float GetScratchSum(int index, int frame)
+{
+	float sum;
+	int vertexCount;
+	int j;
+
+	sum = 0.0f;
+	vertexCount = GetScratchVertexCount(index, frame);
+	for (j = 0; j < vertexCount; j++)
+	{
+		sum += (float)((index + j) % 5);
+	}
+
+	return sum;
+}
+
+int PoolBench(int argc, char* argv[])
+{
+	bool result;
+	double heapTime;
+	double poolTime;
+	double pointerTime;
+	double handleTime;
+	unsigned long long heapChecksum;
+	unsigned long long poolChecksum;
+	int objectCount;
+	int roundCount;
+	int firstArgument;
+
+	objectCount = 1000000;
+	roundCount = 5;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-objects") == 0)
+		{
+			objectCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-rounds") == 0)
+		{
+			roundCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || objectCount < 1 || roundCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	result = CheckPool();
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Stale and forged handles found, slots reused, pointers kept over growth, every object destroyed: OK" << endl;
+
+	//Both make and free the same objects in the same shuffled order, the first round is left out since it grows the pool
+	heapTime = TimeObjects(objectCount, roundCount, false, heapChecksum);
+	poolTime = TimeObjects(objectCount, roundCount, true, poolChecksum);
+	if (heapChecksum != poolChecksum)
+	{
+		cout << "FAILED: the pool handed back something else than new" << endl;
+		return -1;
+	}
+
+	cout << fixed << setprecision(1);
+	cout << objectCount << " objects of " << sizeof(PooledObject) << " bytes, " << roundCount << " rounds" << endl;
+	cout << "  new and delete: " << heapTime << " ns to make and free one" << endl;
+	cout << "  Pool:           " << poolTime << " ns to make and free one, " << heapTime / poolTime << "x" << endl;
+
+	//Looking objects up at random, a checked handle against a bare pointer
+	TimeLookups(objectCount, pointerTime, handleTime);
+	cout << "  Pointer lookup: " << pointerTime << " ns, handle lookup " << handleTime << " ns" << endl;
+
+	return 0;
+}
+
+bool CheckPool()
+{
+	ObjectPool<PooledObject> pool;
+	ObjectPool<PooledObject>::HandleType handles[104];
+	ObjectPool<PooledObject>::HandleType stale;
+	ObjectPool<PooledObject>::HandleType handle;
+	PooledObject* first;
+	bool result;
+	int i;
+
+	pooledLiveCount = 0;
+	result = pool.Initialize(4);
+	if (!result || pool.GetCapacity() != 4)
+	{
+		cout << "FAILED: the pool did not start with room for 4" << endl;
+		return false;
+	}
+
+	//Past the first page the pool grows, what it already handed out stays where it is
+	for (i = 0; i < 104; i++)
+	{
+		handles[i] = pool.Create();
+		pool.Get(handles[i])->m_id = i;
+	}
+	first = pool.Get(handles[0]);
+	if (pool.GetCount() != 104 || pool.GetCapacity() < 104 || pooledLiveCount != 104 || first->m_id != 0)
+	{
+		cout << "FAILED: " << pool.GetCount() << " objects in a pool of " << pool.GetCapacity() << " after making 104" << endl;
+		result = false;
+	}
+	for (i = 0; i < 104 && result; i++)
+	{
+		if (!pool.IsValid(handles[i]) || pool.Get(handles[i])->m_id != i || (i > 0 && pool.Get(handles[i]) == first))
+		{
+			cout << "FAILED: handle " << i << " finds the wrong object" << endl;
+			result = false;
+		}
+	}
+
+	//A destroyed object's handle finds nothing, even once its slot is taken again
+	stale = handles[1];
+	if (result && (!pool.Destroy(stale) || pool.Get(stale) || pool.Destroy(stale) || pooledLiveCount != 103))
+	{
+		cout << "FAILED: a destroyed object can still be found or destroyed" << endl;
+		result = false;
+	}
+	handles[1] = pool.Create();
+	if (result && (handles[1].index != stale.index || handles[1].generation == stale.generation || pool.Get(stale) || !pool.Get(handles[1])))
+	{
+		cout << "FAILED: the freed slot was not reused under a new generation" << endl;
+		result = false;
+	}
+
+	//A slot made and freed over and over never lets an old handle back in
+	for (i = 0; i < 1000 && result; i++)
+	{
+		handle = handles[2];
+		pool.Destroy(handle);
+		handles[2] = pool.Create();
+		if (pool.Get(handle) || pool.Get(stale))
+		{
+			cout << "FAILED: an old handle found the object made after " << i + 1 << " reuses" << endl;
+			result = false;
+		}
+	}
+
+	//Nor does a handle nobody was given
+	handle = ObjectPool<PooledObject>::GetNullHandle();
+	if (result && pool.Get(handle))
+	{
+		cout << "FAILED: the null handle finds an object" << endl;
+		result = false;
+	}
+	handle.index = (unsigned int)pool.GetCapacity();
+	handle.generation = 1;
+	if (result && pool.Get(handle))
+	{
+		cout << "FAILED: a handle past the end finds an object" << endl;
+		result = false;
+	}
+	handle.index = handles[3].index;
+	handle.generation = handles[3].generation + 1;
+	if (result && pool.Get(handle))
+	{
+		cout << "FAILED: a handle with the wrong generation finds an object" << endl;
+		result = false;
+	}
+
+	pool.Shutdown();
+	if (result && pooledLiveCount != 0)
+	{
+		cout << "FAILED: " << pooledLiveCount << " objects were not destroyed with the pool" << endl;
+		result = false;
+	}
+
+	return result;
+}
+
+double TimeObjects(int objectCount, int roundCount, bool pooled, unsigned long long& checksum)
+{
+	ObjectPool<PooledObject> pool;
+	vector<ObjectPool<PooledObject>::HandleType> handles;
+	vector<PooledObject*> objects;
+	vector<int> order;
+	unsigned long long start;
+	double time;
+	int round;
+	int i;
+
+	//The order objects are freed in, the same for both so neither gets the friendlier pattern
+	order.resize(objectCount);
+	for (i = 0; i < objectCount; i++)
+	{
+		order[i] = i;
+	}
+	shuffle(order.begin(), order.end(), mt19937(1234));
+
+	pool.Initialize(1024);
+	handles.resize(objectCount);
+	objects.resize(objectCount);
+
+	time = 0.0;
+	checksum = 0;
+	for (round = 0; round <= roundCount; round++)
+	{
+		start = Profiler::GetTime();
+		if (pooled)
+		{
+			for (i = 0; i < objectCount; i++)
+			{
+				handles[i] = pool.Create();
+				pool.Get(handles[i])->m_id = i;
+			}
+			for (i = 0; i < objectCount; i++)
+			{
+				checksum = checksum * 31 + (unsigned long long)pool.Get(handles[order[i]])->m_id;
+				pool.Destroy(handles[order[i]]);
+			}
+		}
+		else
+		{
+			for (i = 0; i < objectCount; i++)
+			{
+				objects[i] = new PooledObject();
+				objects[i]->m_id = i;
+			}
+			for (i = 0; i < objectCount; i++)
+			{
+				checksum = checksum * 31 + (unsigned long long)objects[order[i]]->m_id;
+				delete objects[order[i]];
+			}
+		}
+
+		if (round > 0)
+		{
+			time += (double)(Profiler::GetTime() - start);
+		}
+	}
+
+	pool.Shutdown();
+
+	return time / (double)roundCount / (double)objectCount;
+}
+
+void TimeLookups(int objectCount, double& pointerTime, double& handleTime)
+{
+	ObjectPool<PooledObject> pool;
+	vector<ObjectPool<PooledObject>::HandleType> handles;
+	vector<PooledObject*> objects;
+	vector<int> order;
+	unsigned long long start;
+	unsigned long long pointerSum;
+	unsigned long long handleSum;
+	int i;
+
+	order.resize(objectCount);
+	for (i = 0; i < objectCount; i++)
+	{
+		order[i] = i;
+	}
+	shuffle(order.begin(), order.end(), mt19937(5678));
+
+	pool.Initialize(objectCount);
+	handles.resize(objectCount);
+	objects.resize(objectCount);
+	for (i = 0; i < objectCount; i++)
+	{
+		handles[i] = pool.Create();
+		pool.Get(handles[i])->m_id = i;
+		objects[i] = new PooledObject();
+		objects[i]->m_id = i;
+	}
+
+	pointerSum = 0;
+	start = Profiler::GetTime();
+	for (i = 0; i < objectCount; i++)
+	{
+		pointerSum += (unsigned long long)objects[order[i]]->m_id;
+	}
+	pointerTime = (double)(Profiler::GetTime() - start) / (double)objectCount;
+
+	handleSum = 0;
+	start = Profiler::GetTime();
+	for (i = 0; i < objectCount; i++)
+	{
+		handleSum += (unsigned long long)pool.Get(handles[order[i]])->m_id;
+	}
+	handleTime = (double)(Profiler::GetTime() - start) / (double)objectCount;
+
+	if (pointerSum != handleSum)
+	{
+		cout << "FAILED: the handles found other objects than the pointers" << endl;
+	}
+
+	for (i = 0; i < objectCount; i++)
+	{
+		delete objects[i];
+	}
+	pool.Shutdown();
+}
+
+PooledObject::PooledObject()
+{
+	memset(this->m_world, 0, sizeof(this->m_world));
+	this->m_id = -1;
+	pooledLiveCount++;
+}
+
+PooledObject::~PooledObject()
+{
+	pooledLiveCount--;
+}
+
+int SpriteBench(int argc, char* argv[])
+{
+	bool result;
+	vector<SpriteInputType> sprites;
+	double queueTime;
+	double sortTime;
+	double buildTime;
+	double stableTime;
+	int spriteCount;
+	int textureCount;
+	int roundCount;
+	int order;
+	int firstArgument;
+
+	spriteCount = 100000;
+	textureCount = 64;
+	roundCount = 20;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-sprites") == 0)
+		{
+			spriteCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-textures") == 0)
+		{
+			textureCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-rounds") == 0)
+		{
+			roundCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || spriteCount < 1 || textureCount < 1 || textureCount > SPRITE_MAX_TEXTURES || roundCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	result = CheckSpriteLimits();
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Queue and texture limits, an empty sort: OK" << endl;
+
+	cout << fixed << setprecision(1);
+	cout << spriteCount << " sprites over " << textureCount << " textures, " << roundCount << " rounds" << endl;
+
+	//Runs of sprites that share a texture, as a scene mostly queues them, then every sprite on a texture of its own picking
+	for (order = 0; order < 2; order++)
+	{
+		MakeSprites(spriteCount, textureCount, order == 0, sprites);
+
+		result = CheckSprites(sprites);
+		if (!result)
+		{
+			return -1;
+		}
+
+		TimeSprites(sprites, roundCount, queueTime, sortTime, buildTime, stableTime);
+		cout << (order == 0 ? "  In runs:  " : "  Shuffled: ") << "grouped by texture, back to front, stable, the same as std::stable_sort: OK" << endl;
+		cout << "    queue " << queueTime << " ns, sort " << sortTime << " ns, quads " << buildTime << " ns a sprite";
+		cout << ", std::stable_sort " << stableTime << " ns, " << stableTime / sortTime << "x" << endl;
+	}
+
+	return 0;
+}
+
+bool CheckSpriteLimits()
+{
+	SpriteQueue queue;
+	unsigned char textures[SPRITE_MAX_TEXTURES + 1];
+	float uvRect[4];
+	float color[4];
+	bool result;
+	int i;
+
+	memset(uvRect, 0, sizeof(uvRect));
+	memset(color, 0, sizeof(color));
+
+	result = queue.Initialize(800, 600, SPRITE_MAX_TEXTURES + 1);
+	if (!result)
+	{
+		cout << "FAILED: the sprite queue could not be made" << endl;
+		return false;
+	}
+
+	//Sorting nothing does nothing
+	queue.Begin();
+	queue.SortSprites();
+	if (queue.GetSpriteCount() != 0)
+	{
+		cout << "FAILED: an empty queue has sprites after sorting" << endl;
+		result = false;
+	}
+
+	//One texture more than a batch holds is turned away, the sprites before it are kept
+	for (i = 0; i <= SPRITE_MAX_TEXTURES && result; i++)
+	{
+		if (queue.Draw(&textures[i], 0.0f, 0.0f, 1.0f, 1.0f, uvRect, color, 0.5f) != (i < SPRITE_MAX_TEXTURES))
+		{
+			cout << "FAILED: texture " << i << " was " << (i < SPRITE_MAX_TEXTURES ? "turned away" : "taken") << endl;
+			result = false;
+		}
+	}
+	if (result && (queue.GetSpriteCount() != SPRITE_MAX_TEXTURES || queue.GetTextureCount() != SPRITE_MAX_TEXTURES))
+	{
+		cout << "FAILED: the queue holds " << queue.GetSpriteCount() << " sprites after the texture limit" << endl;
+		result = false;
+	}
+
+	//A sprite more than the queue holds is turned away, Begin empties it again
+	if (result)
+	{
+		queue.Draw(&textures[0], 0.0f, 0.0f, 1.0f, 1.0f, uvRect, color, 0.5f);
+		if (queue.Draw(&textures[0], 0.0f, 0.0f, 1.0f, 1.0f, uvRect, color, 0.5f))
+		{
+			cout << "FAILED: a full queue took another sprite" << endl;
+			result = false;
+		}
+		queue.Begin();
+		if (queue.GetSpriteCount() != 0 || queue.GetTextureCount() != 0)
+		{
+			cout << "FAILED: Begin did not empty the queue" << endl;
+			result = false;
+		}
+	}
+
+	queue.Shutdown();
+
+	return result;
+}
+
+void MakeSprites(int spriteCount, int textureCount, bool runs, vector<SpriteInputType>& sprites)
+{
+	mt19937 random(2468);
+	int texture;
+	int i;
+
+	sprites.resize(spriteCount);
+	texture = 0;
+	for (i = 0; i < spriteCount; i++)
+	{
+		//Runs change texture every so often and come back to the ones before, shuffled sprites change every time
+		if (!runs || i % SPRITE_BENCH_RUN == 0)
+		{
+			texture = (int)(random() % (unsigned int)textureCount);
+		}
+		sprites[i].texture = texture;
+		sprites[i].x = (float)(random() % 800);
+		sprites[i].y = (float)(random() % 600);
+
+		//Few depths, so a lot of sprites share a key and the order they were queued in has to hold between them
+		sprites[i].depth = (float)(random() % SPRITE_BENCH_DEPTHS) / (float)(SPRITE_BENCH_DEPTHS - 1);
+	}
+}
+
+bool CheckSprites(const vector<SpriteInputType>& sprites)
+{
+	SpriteQueue queue;
+	vector<SpriteQueue::VertexType> vertices;
+	vector<int> slots;
+	vector<int> reference;
+	vector<unsigned char> seen;
+	vector<unsigned char> finished;
+	unsigned char textures[SPRITE_MAX_TEXTURES];
+	SpriteQueue::VertexType* quad;
+	const SpriteInputType* sprite;
+	const SpriteInputType* previous;
+	float uvRect[4];
+	float color[4];
+	bool result;
+	int spriteCount;
+	int slotCount;
+	int index;
+	int i;
+
+	spriteCount = (int)sprites.size();
+	result = queue.Initialize(800, 600, spriteCount);
+	if (!result)
+	{
+		cout << "FAILED: the sprite queue could not be made" << endl;
+		return false;
+	}
+
+	queue.Begin();
+	for (i = 0; i < spriteCount; i++)
+	{
+		GetSpriteRect(i, uvRect, color);
+		result = queue.Draw(&textures[sprites[i].texture], sprites[i].x, sprites[i].y, 16.0f, 8.0f, uvRect, color, sprites[i].depth);
+		if (!result)
+		{
+			cout << "FAILED: sprite " << i << " was turned away" << endl;
+			queue.Shutdown();
+			return false;
+		}
+	}
+	queue.SortSprites();
+
+	vertices.resize(spriteCount * 4);
+	queue.BuildVertexArray(&vertices[0], 0, spriteCount);
+
+	//The reference, textures in the order they were first queued, back to front within one and queue order between equals
+	slots.assign(SPRITE_MAX_TEXTURES, -1);
+	slotCount = 0;
+	reference.resize(spriteCount);
+	for (i = 0; i < spriteCount; i++)
+	{
+		if (slots[sprites[i].texture] < 0)
+		{
+			slots[sprites[i].texture] = slotCount;
+			slotCount++;
+		}
+		reference[i] = i;
+	}
+	stable_sort(reference.begin(), reference.end(), [&sprites, &slots](int first, int second)
+	{
+		if (slots[sprites[first].texture] != slots[sprites[second].texture])
+		{
+			return slots[sprites[first].texture] < slots[sprites[second].texture];
+		}
+		return sprites[first].depth > sprites[second].depth;
+	});
+
+	seen.assign(spriteCount, 0);
+	finished.assign(SPRITE_MAX_TEXTURES, 0);
+	previous = nullptr;
+	for (i = 0; i < spriteCount && result; i++)
+	{
+		index = queue.GetQueueIndex(i);
+		if (index < 0 || index >= spriteCount || seen[index])
+		{
+			cout << "FAILED: sorted sprite " << i << " is queued sprite " << index << ", which is out of range or came up before" << endl;
+			result = false;
+			break;
+		}
+		seen[index] = 1;
+		sprite = &sprites[index];
+
+		//Every sprite keeps its own texture, and once a texture's run ends it never comes back
+		if (queue.GetTexture(queue.GetTextureSlot(i)) != &textures[sprite->texture])
+		{
+			cout << "FAILED: sorted sprite " << i << " lost its texture" << endl;
+			result = false;
+		}
+		if (previous && previous->texture != sprite->texture)
+		{
+			finished[previous->texture] = 1;
+			if (finished[sprite->texture])
+			{
+				cout << "FAILED: texture " << sprite->texture << " is split over more than one run" << endl;
+				result = false;
+			}
+		}
+
+		//Within a texture back to front, and sprites at the same depth in the order they were queued
+		if (previous && previous->texture == sprite->texture)
+		{
+			if (previous->depth < sprite->depth)
+			{
+				cout << "FAILED: sorted sprite " << i << " is behind the one before it" << endl;
+				result = false;
+			}
+			else if (previous->depth == sprite->depth && queue.GetQueueIndex(i - 1) > index)
+			{
+				cout << "FAILED: sorted sprite " << i << " came after an equal one that was queued later" << endl;
+				result = false;
+			}
+		}
+
+		if (result && index != reference[i])
+		{
+			cout << "FAILED: sorted sprite " << i << " is " << index << ", std::stable_sort put " << reference[i] << " there" << endl;
+			result = false;
+		}
+
+		//The quad is the sprite's, corners in the order the shared index buffer expects
+		quad = &vertices[i * 4];
+		GetSpriteRect(index, uvRect, color);
+		if (result && (quad[0].position[0] != sprite->x - 400.0f || quad[0].position[1] != 300.0f - sprite->y || quad[0].position[2] != sprite->depth ||
+			quad[1].position[0] != quad[0].position[0] + 16.0f || quad[1].position[1] != quad[0].position[1] - 8.0f ||
+			quad[2].position[0] != quad[0].position[0] || quad[2].position[1] != quad[1].position[1] ||
+			quad[3].position[0] != quad[1].position[0] || quad[3].position[1] != quad[0].position[1] ||
+			quad[0].texture[0] != uvRect[0] || quad[0].texture[1] != uvRect[1] || quad[1].texture[0] != uvRect[2] || quad[1].texture[1] != uvRect[3] ||
+			quad[2].texture[0] != uvRect[0] || quad[2].texture[1] != uvRect[3] || quad[3].texture[0] != uvRect[2] || quad[3].texture[1] != uvRect[1] ||
+			memcmp(quad[3].color, color, sizeof(color)) != 0))
+		{
+			cout << "FAILED: the quad of sorted sprite " << i << " is not the sprite's" << endl;
+			result = false;
+		}
+
+		previous = sprite;
+	}
+
+	queue.Shutdown();
+
+	return result;
+}
+
+void TimeSprites(const vector<SpriteInputType>& sprites, int roundCount, double& queueTime, double& sortTime, double& buildTime, double& stableTime)
+{
+	SpriteQueue queue;
+	vector<SpriteQueue::VertexType> vertices;
+	vector<unsigned long long> keyed;
+	unsigned char textures[SPRITE_MAX_TEXTURES];
+	unsigned long long start;
+	float uvRect[4];
+	float color[4];
+	int spriteCount;
+	int round;
+	int i;
+
+	spriteCount = (int)sprites.size();
+	queue.Initialize(800, 600, spriteCount);
+	vertices.resize(spriteCount * 4);
+	keyed.resize(spriteCount);
+	GetSpriteRect(0, uvRect, color);
+
+	queueTime = 0.0;
+	sortTime = 0.0;
+	buildTime = 0.0;
+	stableTime = 0.0;
+	for (round = 0; round <= roundCount; round++)
+	{
+		start = Profiler::GetTime();
+		queue.Begin();
+		for (i = 0; i < spriteCount; i++)
+		{
+			queue.Draw(&textures[sprites[i].texture], sprites[i].x, sprites[i].y, 16.0f, 8.0f, uvRect, color, sprites[i].depth);
+		}
+		if (round > 0)
+		{
+			queueTime += (double)(Profiler::GetTime() - start);
+		}
+
+		//The same keys with the queue position below them through the library's stable sort, before the queue sorts its own in place
+		for (i = 0; i < spriteCount; i++)
+		{
+			keyed[i] = (((unsigned long long)queue.GetTextureSlot(i) << 24) | (0xFFFFFF - (unsigned int)(sprites[i].depth * 16777215.0f))) << 32 | (unsigned long long)i;
+		}
+		start = Profiler::GetTime();
+		stable_sort(keyed.begin(), keyed.end(), [](unsigned long long first, unsigned long long second)
+		{
+			return first < second;
+		});
+		if (round > 0)
+		{
+			stableTime += (double)(Profiler::GetTime() - start);
+		}
+
+		start = Profiler::GetTime();
+		queue.SortSprites();
+		if (round > 0)
+		{
+			sortTime += (double)(Profiler::GetTime() - start);
+		}
+
+		start = Profiler::GetTime();
+		queue.BuildVertexArray(&vertices[0], 0, spriteCount);
+		if (round > 0)
+		{
+			buildTime += (double)(Profiler::GetTime() - start);
+		}
+	}
+
+	queue.Shutdown();
+
+	queueTime /= (double)roundCount * (double)spriteCount;
+	sortTime /= (double)roundCount * (double)spriteCount;
+	buildTime /= (double)roundCount * (double)spriteCount;
+	stableTime /= (double)roundCount * (double)spriteCount;
+}
+
+void GetSpriteRect(int index, float* uvRect, float* color)
+{
+	//Something different for every sprite so a quad written from the wrong one shows
+	uvRect[0] = (float)(index % 7) / 8.0f;
+	uvRect[1] = (float)(index % 5) / 8.0f;
+	uvRect[2] = uvRect[0] + 0.125f;
+	uvRect[3] = uvRect[1] + 0.125f;
+	color[0] = (float)(index % 256) / 255.0f;
+	color[1] = (float)(index % 3) / 2.0f;
+	color[2] = 1.0f;
+	color[3] = 0.5f;
+}
+
+int FontBench(int argc, char* argv[])
+{
+	bool result;
+	ReferenceFontType fonts[2];
+	string texts[2];
+	double layoutTime;
+	int glyphCounts[2];
+	int quadCount;
+	int roundCount;
+	int font;
+	int text;
+	int firstArgument;
+
+	glyphCounts[0] = 100000;
+	glyphCounts[1] = FONT_BENCH_SHORT;
+	roundCount = 20;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-glyphs") == 0)
+		{
+			glyphCounts[0] = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-rounds") == 0)
+		{
+			roundCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || glyphCounts[0] < 1 || roundCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	//One font draws missing characters as a question mark, the other has no question mark and skips them
+	MakeReferenceFont(true, fonts[0]);
+	MakeReferenceFont(false, fonts[1]);
+
+	cout << fixed << setprecision(1);
+	for (text = 0; text < 2; text++)
+	{
+		texts[text] = MakeFontText(glyphCounts[text], text);
+		for (font = 0; font < 2; font++)
+		{
+			result = CheckFontLayout(fonts[font], texts[text], 1.0f) && CheckFontLayout(fonts[font], texts[text], 1.5f);
+			if (!result)
+			{
+				return -1;
+			}
+		}
+		cout << texts[text].size() << " bytes of UTF-8, both fonts, two scales, the same quads as the scalar layout: OK" << endl;
+	}
+	cout << "  Multi-byte characters, kerned pairs, missing glyphs with and without a fallback and invalid sequences" << endl;
+
+	result = CheckBrokenFonts(fonts[0]);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Font files with codepoints out of order or outside Unicode, or cut short, turned down: OK" << endl;
+
+	//The short text is laid out more often so both take about as long
+	for (text = 0; text < 2; text++)
+	{
+		result = TimeFontLayout(fonts[0], texts[text], roundCount * (text == 0 ? 1 : max(1, glyphCounts[0] / glyphCounts[1])), layoutTime, quadCount);
+		if (!result)
+		{
+			return -1;
+		}
+		cout << "Layout of " << glyphCounts[text] << " characters, " << quadCount << " quads: " << layoutTime << " ns a quad" << endl;
+	}
+
+	return 0;
+}
+
+void MakeReferenceFont(bool fallback, ReferenceFontType& font)
+{
+	int extra[5] = { 0xE9, 0x3A9, 0x20AC, 0x4E2D, 0x1F600 };
+	int codepoint;
+	int i;
+
+	//The ASCII range up to the 95 glyphs a font file holds, without the question mark in the second font
+	font.codepoints.clear();
+	for (codepoint = 32; (int)font.codepoints.size() < 90; codepoint++)
+	{
+		if (codepoint != '?' || fallback)
+		{
+			font.codepoints.push_back(codepoint);
+		}
+	}
+	for (i = 0; i < 5; i++)
+	{
+		font.codepoints.push_back(extra[i]);
+	}
+
+	//Metrics that are exact in binary, so the layout and the reference can be held to the same floats
+	font.left.resize(font.codepoints.size());
+	font.right.resize(font.codepoints.size());
+	font.size.resize(font.codepoints.size());
+	font.glyphs.clear();
+	for (i = 0; i < (int)font.codepoints.size(); i++)
+	{
+		font.size[i] = 1 + (i * 7) % 11;
+		font.left[i] = (float)i / 128.0f;
+		font.right[i] = font.left[i] + (float)font.size[i] / 1024.0f;
+		font.glyphs[font.codepoints[i]] = i;
+	}
+	font.fallback = fallback ? font.glyphs['?'] : -1;
+
+	//Pairs between ASCII, multi-byte characters and the fallback
+	font.kerning.clear();
+	font.kerning[make_pair((int)'A', (int)'V')] = -1.5f;
+	font.kerning[make_pair((int)'V', (int)'A')] = -1.5f;
+	font.kerning[make_pair((int)'T', (int)'o')] = -2.0f;
+	font.kerning[make_pair((int)'f', (int)'f')] = 0.25f;
+	font.kerning[make_pair(0xE9, 0x20AC)] = 0.5f;
+	font.kerning[make_pair(0x1F600, (int)'A')] = -1.0f;
+	if (fallback)
+	{
+		font.kerning[make_pair((int)'?', (int)'A')] = -0.75f;
+	}
+}
+
+bool WriteReferenceFont(const ReferenceFontType& font, const char* fontFile, const char* kerningFile)
+{
+	ofstream output;
+	map<pair<int, int>, float>::const_iterator kerning;
+	int i;
+
+	//The format Font reads, the codepoint, the glyph itself, its left and right in the atlas and its width
+	output.open(fontFile, ios::binary);
+	if (output.fail())
+	{
+		return false;
+	}
+	output << setprecision(10);
+	for (i = 0; i < (int)font.codepoints.size(); i++)
+	{
+		output << font.codepoints[i] << " " << EncodeUtf8(font.codepoints[i]) << " " << font.left[i] << " " << font.right[i] << " " << font.size[i] << "\n";
+	}
+	output.close();
+
+	output.open(kerningFile, ios::binary);
+	if (output.fail())
+	{
+		return false;
+	}
+	output << font.kerning.size() << "\n";
+	for (kerning = font.kerning.begin(); kerning != font.kerning.end(); kerning++)
+	{
+		output << kerning->first.first << " " << kerning->first.second << " " << kerning->second << "\n";
+	}
+	output.close();
+
+	return !output.fail();
+}
+
+string MakeFontText(int glyphCount, int seed)
+{
+	//Plain text most of the time, with everything the layout has to get right mixed in
+	const char* pieces[] =
+	{
+		"AV", "VA", "To", "ff", "?A", "A~V", "A{V", " ", "  ", "\n",
+		"\xC3\xA9\xE2\x82\xAC", "\xCE\xA9", "\xE4\xB8\xAD", "\xF0\x9F\x98\x80" "A",
+		"\xFF", "\x80", "\xC0\xAF", "\xE0\x80\xAF", "\xED\xA0\x80", "\xF4\x90\x80\x80", "\xE2\x82" "A", "\xF0\x9F\x98" " "
+	};
+	mt19937 random(1357 + seed);
+	string text;
+	const char* piece;
+	int count;
+
+	//Counted in characters, every byte that does not continue a sequence starts one
+	count = 0;
+	while (count < glyphCount)
+	{
+		if (random() % 4 != 0)
+		{
+			text += (char)(33 + random() % 94);
+			count++;
+		}
+		else
+		{
+			for (piece = pieces[random() % (sizeof(pieces) / sizeof(pieces[0]))]; *piece; piece++)
+			{
+				text += *piece;
+				count += ((unsigned char)*piece & 0xC0) != 0x80 ? 1 : 0;
+			}
+		}
+	}
+
+	//A sequence cut off by the end of the text
+	text += "\xF0\x9F\x98";
+
+	return text;
+}
+
+bool CheckFontLayout(const ReferenceFontType& font, const string& text, float scale)
+{
+	FontLayout layout;
+	vector<FontLayout::VertexType> vertices;
+	vector<FontLayout::VertexType> expected;
+	char fontFile[] = "fontbench.txt";
+	char kerningFile[] = "fontbench_kerning.txt";
+	float color[4];
+	float tolerance;
+	bool result;
+	int quadCount;
+	int expectedCount;
+	int i;
+	int j;
+
+	color[0] = 1.0f;
+	color[1] = 0.5f;
+	color[2] = 0.25f;
+	color[3] = 0.75f;
+
+	result = WriteReferenceFont(font, fontFile, kerningFile);
+	if (result)
+	{
+		result = layout.Initialize(fontFile) && layout.LoadKerningData(kerningFile);
+	}
+	remove(fontFile);
+	remove(kerningFile);
+	if (!result)
+	{
+		cout << "FAILED: the made up font could not be loaded" << endl;
+		layout.Shutdown();
+		return false;
+	}
+
+	//Room for a quad for every byte, which is more than any text can need
+	vertices.resize(text.size() * 4);
+	expected.resize(text.size() * 4);
+	quadCount = layout.BuildVertexArray(&vertices[0], text.c_str(), (int)text.size(), -400.0f, 300.0f, 16.0f, color, scale);
+	expectedCount = LayoutReference(font, text, -400.0f, 300.0f, 16.0f, color, scale, &expected[0]);
+	layout.Shutdown();
+
+	if (quadCount != expectedCount)
+	{
+		cout << "FAILED: the layout made " << quadCount << " quads, the scalar layout " << expectedCount << endl;
+		return false;
+	}
+
+	//Everything but the pen position has to be the same float, the pen is summed in another order so it gets a little room
+	for (i = 0; i < quadCount * 4; i++)
+	{
+		tolerance = 0.0001f + fabsf(expected[i].position[0]) * 0.000001f;
+		if (fabsf(vertices[i].position[0] - expected[i].position[0]) > tolerance || vertices[i].position[1] != expected[i].position[1] || vertices[i].position[2] != expected[i].position[2] ||
+			vertices[i].texture[0] != expected[i].texture[0] || vertices[i].texture[1] != expected[i].texture[1])
+		{
+			cout << "FAILED: vertex " << i % 4 << " of quad " << i / 4 << " is " << vertices[i].position[0] << ", " << vertices[i].position[1] << " at " << vertices[i].texture[0] << ", " << vertices[i].texture[1];
+			cout << ", the scalar layout made it " << expected[i].position[0] << ", " << expected[i].position[1] << " at " << expected[i].texture[0] << ", " << expected[i].texture[1] << endl;
+			return false;
+		}
+		for (j = 0; j < 4; j++)
+		{
+			if (vertices[i].color[j] != color[j])
+			{
+				cout << "FAILED: vertex " << i % 4 << " of quad " << i / 4 << " has the wrong color" << endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool CheckBrokenFonts(const ReferenceFontType& font)
+{
+	FontLayout layout;
+	ReferenceFontType broken;
+	char fontFile[] = "fontbench.txt";
+	char kerningFile[] = "fontbench_kerning.txt";
+	const char* names[4] = { "a negative codepoint", "a codepoint past 0x10FFFF", "codepoints out of order", "too few glyphs" };
+	bool result;
+
+	for (int i = 0; i < 4; i++)
+	{
+		//One thing wrong with a good font
+		broken = font;
+		switch (i)
+		{
+		case 0:
+			broken.codepoints[0] = -1;
+			break;
+		case 1:
+			broken.codepoints.back() = 0x110000;
+			break;
+		case 2:
+			swap(broken.codepoints[10], broken.codepoints[11]);
+			break;
+		default:
+			broken.codepoints.resize(10);
+			break;
+		}
+
+		result = WriteReferenceFont(broken, fontFile, kerningFile);
+		if (result)
+		{
+			result = !layout.Initialize(fontFile);
+			layout.Shutdown();
+		}
+		remove(fontFile);
+		remove(kerningFile);
+		if (!result)
+		{
+			cout << "FAILED: a font file with " << names[i] << " was loaded" << endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int LayoutReference(const ReferenceFontType& font, const string& text, float positionX, float positionY, float fontHeight, const float* color, float scale, FontLayout::VertexType* vertices)
+{
+	map<int, int>::const_iterator found;
+	map<pair<int, int>, float>::const_iterator kerning;
+	FontLayout::VertexType* quad;
+	const unsigned char* bytes;
+	float penX;
+	float right;
+	float bottom;
+	int position;
+	int codepoint;
+	int glyph;
+	int previousGlyph;
+	int quadCount;
+
+	//One character at a time, the pen moves by the glyph width plus a pixel, a space by three pixels
+	bytes = (const unsigned char*)text.c_str();
+	penX = positionX;
+	previousGlyph = -1;
+	quadCount = 0;
+	position = 0;
+	while (position < (int)text.size())
+	{
+		position += DecodeReference(bytes + position, (int)text.size() - position, codepoint);
+		if (codepoint == ' ')
+		{
+			penX += 3.0f * scale;
+			previousGlyph = -1;
+			continue;
+		}
+
+		found = font.glyphs.find(codepoint);
+		glyph = found != font.glyphs.end() ? found->second : font.fallback;
+		if (glyph < 0)
+		{
+			previousGlyph = -1;
+			continue;
+		}
+
+		if (previousGlyph >= 0)
+		{
+			kerning = font.kerning.find(make_pair(font.codepoints[previousGlyph], font.codepoints[glyph]));
+			if (kerning != font.kerning.end())
+			{
+				penX += kerning->second * scale;
+			}
+		}
+
+		//Top left, bottom right, bottom left and top right
+		quad = &vertices[quadCount * 4];
+		right = penX + (float)font.size[glyph] * scale;
+		bottom = positionY - fontHeight * scale;
+		SetReferenceVertex(quad[0], penX, positionY, font.left[glyph], 0.0f, color);
+		SetReferenceVertex(quad[1], right, bottom, font.right[glyph], 1.0f, color);
+		SetReferenceVertex(quad[2], penX, bottom, font.left[glyph], 1.0f, color);
+		SetReferenceVertex(quad[3], right, positionY, font.right[glyph], 0.0f, color);
+		quadCount++;
+
+		penX += (float)(font.size[glyph] + 1) * scale;
+		previousGlyph = glyph;
+	}
+
+	return quadCount;
+}
+
+void SetReferenceVertex(FontLayout::VertexType& vertex, float x, float y, float u, float v, const float* color)
+{
+	vertex.position[0] = x;
+	vertex.position[1] = y;
+	vertex.position[2] = 0.0f;
+	vertex.texture[0] = u;
+	vertex.texture[1] = v;
+	memcpy(vertex.color, color, sizeof(vertex.color));
+}
+
+int DecodeReference(const unsigned char* text, int length, int& codepoint)
+{
+	int count;
+	int i;
+
+	codepoint = -1;
+	if (text[0] < 0x80)
+	{
+		codepoint = text[0];
+		return 1;
+	}
+
+	//A bad lead byte is skipped alone, a sequence cut off by the end takes the rest and one broken off early stops before the byte that broke it
+	count = text[0] >= 0xC0 && text[0] < 0xE0 ? 2 : text[0] >= 0xE0 && text[0] < 0xF0 ? 3 : text[0] >= 0xF0 && text[0] < 0xF8 ? 4 : 0;
+	if (count == 0)
+	{
+		return 1;
+	}
+	if (count > length)
+	{
+		return length;
+	}
+	for (i = 1; i < count; i++)
+	{
+		if (text[i] < 0x80 || text[i] >= 0xC0)
+		{
+			return i;
+		}
+	}
+
+	if (count == 2)
+	{
+		codepoint = ((text[0] & 0x1F) << 6) | (text[1] & 0x3F);
+	}
+	else if (count == 3)
+	{
+		codepoint = ((text[0] & 0x0F) << 12) | ((text[1] & 0x3F) << 6) | (text[2] & 0x3F);
+	}
+	else
+	{
+		codepoint = ((text[0] & 0x07) << 18) | ((text[1] & 0x3F) << 12) | ((text[2] & 0x3F) << 6) | (text[3] & 0x3F);
+	}
+
+	//The shortest encoding only, no surrogates and nothing past U+10FFFF
+	if ((count == 2 && codepoint < 0x80) || (count == 3 && codepoint < 0x800) || (count == 4 && codepoint < 0x10000) || (codepoint >= 0xD800 && codepoint < 0xE000) || codepoint > 0x10FFFF)
+	{
+		codepoint = -1;
+	}
+
+	return count;
+}
+
+string EncodeUtf8(int codepoint)
+{
+	string text;
+
+	if (codepoint < 0x80)
+	{
+		text += (char)codepoint;
+	}
+	else if (codepoint < 0x800)
+	{
+		text += (char)(0xC0 | (codepoint >> 6));
+		text += (char)(0x80 | (codepoint & 0x3F));
+	}
+	else if (codepoint < 0x10000)
+	{
+		text += (char)(0xE0 | (codepoint >> 12));
+		text += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		text += (char)(0x80 | (codepoint & 0x3F));
+	}
+	else
+	{
+		text += (char)(0xF0 | (codepoint >> 18));
+		text += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+		text += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		text += (char)(0x80 | (codepoint & 0x3F));
+	}
+
+	return text;
+}
+
+bool TimeFontLayout(const ReferenceFontType& font, const string& text, int roundCount, double& layoutTime, int& quadCount)
+{
+	FontLayout layout;
+	vector<FontLayout::VertexType> vertices;
+	char fontFile[] = "fontbench.txt";
+	char kerningFile[] = "fontbench_kerning.txt";
+	unsigned long long start;
+	float color[4];
+	bool result;
+	int round;
+
+	result = WriteReferenceFont(font, fontFile, kerningFile);
+	if (result)
+	{
+		result = layout.Initialize(fontFile) && layout.LoadKerningData(kerningFile);
+	}
+	remove(fontFile);
+	remove(kerningFile);
+	if (!result)
+	{
+		cout << "FAILED: the made up font could not be loaded" << endl;
+		layout.Shutdown();
+		return false;
+	}
+
+	color[0] = 1.0f;
+	color[1] = 1.0f;
+	color[2] = 1.0f;
+	color[3] = 1.0f;
+	vertices.resize(text.size() * 4);
+
+	//The first round is left out, it brings the text and the vertices into the cache
+	quadCount = 0;
+	layoutTime = 0.0;
+	for (round = 0; round <= roundCount; round++)
+	{
+		start = Profiler::GetTime();
+		quadCount = layout.BuildVertexArray(&vertices[0], text.c_str(), (int)text.size(), 0.0f, 0.0f, 16.0f, color, 1.0f);
+		if (round > 0)
+		{
+			layoutTime += (double)(Profiler::GetTime() - start);
+		}
+	}
+
+	layout.Shutdown();
+
+	layoutTime /= (double)roundCount * (double)max(quadCount, 1);
+
+	return true;
+}
+
+int TextBench(int argc, char* argv[])
+{
+	bool result;
+	ReferenceFontType font;
+	unsigned long long uploadedBytes;
+	unsigned long long wholeBytes;
+	double updateTime;
+	int updateCount;
+	int roundCount;
+	int firstArgument;
+
+	updateCount = 20000;
+	roundCount = 20000;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-updates") == 0)
+		{
+			updateCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-rounds") == 0)
+		{
+			roundCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || updateCount < 1 || roundCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	MakeReferenceFont(true, font);
+
+	result = CheckTextSentences(font, updateCount);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << updateCount << " sentence updates, the uploaded ranges start and end on the changed glyphs: OK" << endl;
+	cout << "  New text, digits, shorter and longer text, moves, colors, scales and no change, one or several between uploads" << endl;
+
+	result = TimeTextSentences(font, roundCount, updateTime, uploadedBytes, wholeBytes);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << fixed << setprecision(1);
+	cout << "Render count line over " << roundCount << " frames: " << uploadedBytes << " bytes uploaded, " << wholeBytes << " for whole sentences (";
+	cout << (double)uploadedBytes * 100.0 / (double)max(wholeBytes, 1ULL) << "%), " << updateTime << " ns a frame" << endl;
+
+	return 0;
+}
+
+bool CheckTextSentences(const ReferenceFontType& font, int updateCount)
+{
+	const int maxLengths[TEXT_BENCH_SENTENCES] = { 16, 32, 64, 8 };
+	const int quadBytes = (int)sizeof(TextSentence::VertexType) * 4;
+	TextSentence sentences[TEXT_BENCH_SENTENCES];
+	FontLayout layout;
+	vector<TextSentence::VertexType> vertices;
+	vector<unsigned char> buffer;
+	vector<unsigned char> expected;
+	string texts[TEXT_BENCH_SENTENCES];
+	string text;
+	float position[2];
+	float color[4];
+	float scale;
+	float positions[TEXT_BENCH_SENTENCES][2];
+	float colors[TEXT_BENCH_SENTENCES][4];
+	float scales[TEXT_BENCH_SENTENCES];
+	int touched[TEXT_BENCH_SENTENCES];
+	mt19937 random(2468);
+	char fontFile[] = "textbench.txt";
+	char kerningFile[] = "textbench_kerning.txt";
+	const void* source;
+	unsigned int left;
+	unsigned int right;
+	int firstChanged;
+	int lastChanged;
+	int glyphCount;
+	int slotCount;
+	int updates;
+	int sentence;
+	int quad;
+	int i;
+	bool changed;
+	bool dirty;
+	bool result;
+
+	result = WriteReferenceFont(font, fontFile, kerningFile);
+	if (result)
+	{
+		result = layout.Initialize(fontFile) && layout.LoadKerningData(kerningFile);
+	}
+	remove(fontFile);
+	remove(kerningFile);
+	if (!result)
+	{
+		cout << "FAILED: the made up font could not be loaded" << endl;
+		layout.Shutdown();
+		return false;
+	}
+
+	//The sentences own ranges of slots one after the other in the buffer, like the sentences of a text
+	slotCount = 0;
+	for (sentence = 0; sentence < TEXT_BENCH_SENTENCES; sentence++)
+	{
+		result = sentences[sentence].Initialize(slotCount, maxLengths[sentence]);
+		if (!result)
+		{
+			cout << "FAILED: a sentence could not be made" << endl;
+			return false;
+		}
+		slotCount += maxLengths[sentence];
+
+		texts[sentence] = "";
+		positions[sentence][0] = 0.0f;
+		positions[sentence][1] = 0.0f;
+		for (i = 0; i < 4; i++)
+		{
+			colors[sentence][i] = 1.0f;
+		}
+		scales[sentence] = 1.0f;
+	}
+
+	//The buffer the uploads go to and what laying every sentence out again would put there, both start as degenerate quads
+	buffer.assign(slotCount * quadBytes, 0);
+	expected.assign(slotCount * quadBytes, 0);
+	vertices.resize(64 * 4);
+
+	result = true;
+	for (updates = 0; updates < updateCount && result;)
+	{
+		//Most of the time one sentence changes between two uploads, now and then several changes pile up
+		memset(touched, 0, sizeof(touched));
+		for (i = (random() % 4 == 0) ? 3 : 1; i > 0 && updates < updateCount; i--, updates++)
+		{
+			sentence = random() % TEXT_BENCH_SENTENCES;
+			text = texts[sentence];
+			memcpy(position, positions[sentence], sizeof(position));
+			memcpy(color, colors[sentence], sizeof(color));
+			scale = scales[sentence];
+
+			switch (random() % 8)
+			{
+			case 0:
+				//The same text again
+				break;
+			case 1:
+				text = MakeFontText(random() % (maxLengths[sentence] / 2 + 1), random() % 1000);
+				break;
+			case 2:
+				text = "Count: " + to_string(random() % 100000);
+				break;
+			case 3:
+				text = "Count: " + to_string(random() % 100);
+				break;
+			case 4:
+				position[0] += (float)(random() % 3) - 1.0f;
+				break;
+			case 5:
+				color[random() % 4] = (float)(random() % 4) / 4.0f;
+				break;
+			case 6:
+				scale = (random() % 2 == 0) ? 1.0f : 1.5f;
+				break;
+			default:
+				text = "";
+				break;
+			}
+			if (text.size() > (size_t)maxLengths[sentence])
+			{
+				text.resize(maxLengths[sentence]);
+			}
+
+			//The layout is only built again when something it is built from changed
+			sentences[sentence].SetText(text.c_str(), position[0], position[1], color, scale, changed);
+			if (changed != (text != texts[sentence] || memcmp(position, positions[sentence], sizeof(position)) != 0 || memcmp(color, colors[sentence], sizeof(color)) != 0 || scale != scales[sentence]))
+			{
+				cout << "FAILED: a sentence said it " << (changed ? "changed" : "did not change") << " when it " << (changed ? "did not" : "did") << endl;
+				result = false;
+				break;
+			}
+			if (!changed)
+			{
+				continue;
+			}
+			texts[sentence] = text;
+			memcpy(positions[sentence], position, sizeof(position));
+			memcpy(colors[sentence], color, sizeof(color));
+			scales[sentence] = scale;
+
+			glyphCount = layout.BuildVertexArray(&vertices[0], text.c_str(), (int)text.size(), position[0], position[1], 16.0f, color, scale);
+			sentences[sentence].SetLayout(&vertices[0], glyphCount);
+			touched[sentence]++;
+
+			//What the slots should hold, the glyphs and degenerate quads past them
+			memset(&expected[sentences[sentence].GetFirstGlyph() * quadBytes], 0, maxLengths[sentence] * quadBytes);
+			memcpy(&expected[sentences[sentence].GetFirstGlyph() * quadBytes], &vertices[0], glyphCount * quadBytes);
+		}
+
+		//Upload every sentence like the text does and hold the ranges to the glyphs that differ from what the buffer had
+		for (sentence = 0; sentence < TEXT_BENCH_SENTENCES && result; sentence++)
+		{
+			firstChanged = -1;
+			lastChanged = -1;
+			for (quad = sentences[sentence].GetFirstGlyph(); quad < sentences[sentence].GetFirstGlyph() + maxLengths[sentence]; quad++)
+			{
+				if (memcmp(&buffer[quad * quadBytes], &expected[quad * quadBytes], quadBytes) != 0)
+				{
+					firstChanged = (firstChanged == -1) ? quad : firstChanged;
+					lastChanged = quad;
+				}
+			}
+
+			dirty = sentences[sentence].GetDirtyRange(left, right, source);
+			if (!dirty)
+			{
+				if (firstChanged != -1)
+				{
+					cout << "FAILED: sentence " << sentence << " changed glyphs " << firstChanged << " to " << lastChanged << " and uploaded nothing" << endl;
+					result = false;
+				}
+				continue;
+			}
+
+			//A glyph changed and changed back between two uploads is still in the range, so only a single change has to be exact
+			if (left % quadBytes != 0 || right % quadBytes != 0 || left >= right || (int)(left / quadBytes) < sentences[sentence].GetFirstGlyph() ||
+				(int)(right / quadBytes) > sentences[sentence].GetFirstGlyph() + maxLengths[sentence] ||
+				(firstChanged != -1 && ((int)(left / quadBytes) > firstChanged || (int)(right / quadBytes) <= lastChanged)) ||
+				(touched[sentence] == 1 && ((int)(left / quadBytes) != firstChanged || (int)(right / quadBytes) != lastChanged + 1)))
+			{
+				cout << "FAILED: sentence " << sentence << " uploaded glyphs " << left / quadBytes << " to " << (right / quadBytes) - 1 << " when " << firstChanged << " to " << lastChanged << " changed" << endl;
+				result = false;
+				continue;
+			}
+
+			memcpy(&buffer[left], source, right - left);
+			sentences[sentence].ClearDirty();
+		}
+
+		//Once uploaded the buffer holds what laying everything out again would
+		if (result && buffer != expected)
+		{
+			cout << "FAILED: the buffer is not what the sentences were last laid out as" << endl;
+			result = false;
+		}
+	}
+
+	for (sentence = 0; sentence < TEXT_BENCH_SENTENCES; sentence++)
+	{
+		sentences[sentence].Shutdown();
+	}
+	layout.Shutdown();
+
+	return result;
+}
+
+bool TimeTextSentences(const ReferenceFontType& font, int roundCount, double& updateTime, unsigned long long& uploadedBytes, unsigned long long& wholeBytes)
+{
+	TextSentence sentence;
+	FontLayout layout;
+	vector<TextSentence::VertexType> vertices;
+	char fontFile[] = "textbench.txt";
+	char kerningFile[] = "textbench_kerning.txt";
+	char text[64];
+	float color[4];
+	const void* source;
+	unsigned long long start;
+	unsigned int left;
+	unsigned int right;
+	int glyphCount;
+	int round;
+	bool changed;
+	bool result;
+
+	result = WriteReferenceFont(font, fontFile, kerningFile);
+	if (result)
+	{
+		result = layout.Initialize(fontFile) && layout.LoadKerningData(kerningFile) && sentence.Initialize(0, 64);
+	}
+	remove(fontFile);
+	remove(kerningFile);
+	if (!result)
+	{
+		cout << "FAILED: the made up font could not be loaded" << endl;
+		layout.Shutdown();
+		sentence.Shutdown();
+		return false;
+	}
+
+	color[0] = 1.0f;
+	color[1] = 1.0f;
+	color[2] = 1.0f;
+	color[3] = 1.0f;
+	vertices.resize(64 * 4);
+
+	//The render count line, set every frame and changing every few frames, mostly in its last digits
+	uploadedBytes = 0;
+	wholeBytes = 0;
+	glyphCount = 0;
+	start = Profiler::GetTime();
+	for (round = 0; round < roundCount; round++)
+	{
+		sprintf(text, "Render Count: %d", 1200 + (round / 4) % 500);
+		sentence.SetText(text, 20.0f, 20.0f, color, 1.0f, changed);
+		if (changed)
+		{
+			glyphCount = layout.BuildVertexArray(&vertices[0], text, (int)strlen(text), 20.0f, 20.0f, 16.0f, color, 1.0f);
+			sentence.SetLayout(&vertices[0], glyphCount);
+			if (sentence.GetDirtyRange(left, right, source))
+			{
+				uploadedBytes += right - left;
+				sentence.ClearDirty();
+			}
+		}
+
+		//Against writing the whole sentence every frame
+		wholeBytes += glyphCount * sizeof(TextSentence::VertexType) * 4;
+	}
+	updateTime = (double)(Profiler::GetTime() - start) / (double)roundCount;
+
+	sentence.Shutdown();
+	layout.Shutdown();
+
+	return true;
+}
+
+int DdsBench(int argc, char* argv[])
+{
+	bool result;
+	string directory;
+	vector<string> fileNames;
+	double openTime;
+	int roundCount;
+	int firstArgument;
+
+	directory = "../Engine";
+	roundCount = 20;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-dir") == 0)
+		{
+			directory = argv[firstArgument + 1];
+		}
+		else if (strcmp(argv[firstArgument], "-rounds") == 0)
+		{
+			roundCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (firstArgument != argc || roundCount < 1)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	result = ListDdsFiles(directory, fileNames);
+	if (!result || fileNames.empty())
+	{
+		cout << "FAILED: no .dds files in " << directory << endl;
+		return -1;
+	}
+
+	result = CheckDdsFiles(fileNames);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << fileNames.size() << " files in " << directory << ", mapped and from memory, every surface where it should be: OK" << endl;
+
+	result = CheckMadeDdsFiles();
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Made up BC mip chains, DX10 arrays and cube maps, legacy cube maps and odd sizes: OK" << endl;
+
+	result = CheckBrokenDdsFiles();
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Every truncation of them, broken headers and sizes that overflow the pitches rejected: OK" << endl;
+
+	result = CheckTextureArrays();
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Texture arrays take a slice for each image and array element in order, cut the chains down to the shortest" << endl;
+	cout << "  and turn down cube maps, other sizes and formats and images past the last slice: OK" << endl;
+
+	result = TimeDdsFiles(fileNames, roundCount, openTime);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << fixed << setprecision(1);
+	cout << "Mapping and parsing a file: " << openTime << " us" << endl;
+
+	return 0;
+}
+
+bool ListDdsFiles(const string& directory, vector<string>& fileNames)
+{
+	fileNames.clear();
+#ifdef _WIN32
+	_finddata_t found;
+	intptr_t search;
+
+	search = _findfirst((directory + "/*.dds").c_str(), &found);
+	if (search == -1)
+	{
+		return false;
+	}
+	do
+	{
+		fileNames.push_back(directory + "/" + found.name);
+	} while (_findnext(search, &found) == 0);
+	_findclose(search);
+#else
+	DIR* folder;
+	dirent* entry;
+	string name;
+
+	folder = opendir(directory.c_str());
+	if (!folder)
+	{
+		return false;
+	}
+	while ((entry = readdir(folder)) != nullptr)
+	{
+		//Matched without case like the Windows search does
+		name = entry->d_name;
+		if (name.size() > 4 && strcasecmp(name.c_str() + name.size() - 4, ".dds") == 0)
+		{
+			fileNames.push_back(directory + "/" + name);
+		}
+	}
+	closedir(folder);
+#endif
+
+	sort(fileNames.begin(), fileNames.end());
+
+	return true;
+}
+
+bool CheckDdsFiles(const vector<string>& fileNames)
+{
+	DdsFile mapped;
+	DdsFile loaded;
+	ifstream input;
+	vector<unsigned char> data;
+	const void* mappedData;
+	const void* loadedData;
+	unsigned int rowPitches[2];
+	unsigned int slicePitches[2];
+	unsigned int widths[2];
+	unsigned int heights[2];
+	bool result;
+
+	for (size_t i = 0; i < fileNames.size(); i++)
+	{
+		//Read the whole file in to parse it from memory as well
+		input.open(fileNames[i].c_str(), ios::binary);
+		data.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+		input.close();
+		input.clear();
+		if (data.empty())
+		{
+			cout << "FAILED: could not read " << fileNames[i] << endl;
+			return false;
+		}
+
+		if (!mapped.Initialize(fileNames[i].c_str()) || !loaded.Initialize(&data[0], data.size()))
+		{
+			cout << "FAILED: " << fileNames[i] << " did not parse" << endl;
+			mapped.Shutdown();
+			loaded.Shutdown();
+			return false;
+		}
+
+		//The surfaces of the copy in memory are checked against the reference layout, the mapped file has to match them byte for byte
+		result = CheckDdsSurfaces(loaded, &data[0], data.size(), fileNames[i].c_str());
+		if (result && (mapped.GetWidth() != loaded.GetWidth() || mapped.GetHeight() != loaded.GetHeight() || mapped.GetMipCount() != loaded.GetMipCount() ||
+			mapped.GetArraySize() != loaded.GetArraySize() || mapped.GetFormat() != loaded.GetFormat() || mapped.GetDataSize() != data.size()))
+		{
+			cout << "FAILED: " << fileNames[i] << " mapped does not match the copy in memory" << endl;
+			result = false;
+		}
+		for (unsigned int slice = 0; result && slice < loaded.GetArraySize(); slice++)
+		{
+			for (unsigned int mip = 0; result && mip < loaded.GetMipCount(); mip++)
+			{
+				mapped.GetSurface(slice, mip, mappedData, rowPitches[0], slicePitches[0], widths[0], heights[0]);
+				loaded.GetSurface(slice, mip, loadedData, rowPitches[1], slicePitches[1], widths[1], heights[1]);
+				if (rowPitches[0] != rowPitches[1] || slicePitches[0] != slicePitches[1] || memcmp(mappedData, loadedData, slicePitches[0]) != 0)
+				{
+					cout << "FAILED: " << fileNames[i] << " slice " << slice << " mip " << mip << " mapped does not match the copy in memory" << endl;
+					result = false;
+				}
+			}
+		}
+
+		mapped.Shutdown();
+		loaded.Shutdown();
+		if (!result)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CheckDdsSurfaces(DdsFile& file, const unsigned char* data, size_t size, const char* name)
+{
+	const void* surface;
+	size_t offset;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+	unsigned int expectedWidth;
+	unsigned int expectedHeight;
+	unsigned int expectedPitch;
+	unsigned int rows;
+	unsigned int fourCC;
+
+	//The surfaces start after the header, which is longer when the four character code says a DX10 header follows
+	memcpy(&fourCC, data + 84, sizeof(unsigned int));
+	offset = (fourCC == DDS_BENCH_DX10) ? 148 : 128;
+
+	//Slice by slice each with its full chain, packed with nothing between them, up to the end of the file
+	for (unsigned int slice = 0; slice < file.GetArraySize(); slice++)
+	{
+		expectedWidth = file.GetWidth();
+		expectedHeight = file.GetHeight();
+		for (unsigned int mip = 0; mip < file.GetMipCount(); mip++)
+		{
+			if (!file.GetSurface(slice, mip, surface, rowPitch, slicePitch, width, height))
+			{
+				cout << "FAILED: " << name << " has no slice " << slice << " mip " << mip << endl;
+				return false;
+			}
+			if (!GetReferencePitch(file.GetFormat(), expectedWidth, expectedHeight, expectedPitch, rows))
+			{
+				cout << "FAILED: " << name << " is in format " << file.GetFormat() << " which the check does not know" << endl;
+				return false;
+			}
+			if ((const unsigned char*)surface != data + offset || width != expectedWidth || height != expectedHeight || rowPitch != expectedPitch || slicePitch != expectedPitch * rows)
+			{
+				cout << "FAILED: " << name << " slice " << slice << " mip " << mip << " is " << width << "x" << height << " at " << ((const unsigned char*)surface - data);
+				cout << " pitched " << rowPitch << " and " << slicePitch << ", expected " << expectedWidth << "x" << expectedHeight << " at " << offset;
+				cout << " pitched " << expectedPitch << " and " << expectedPitch * rows << endl;
+				return false;
+			}
+
+			offset += slicePitch;
+			expectedWidth = max(expectedWidth / 2, 1u);
+			expectedHeight = max(expectedHeight / 2, 1u);
+		}
+	}
+
+	if (offset != size)
+	{
+		cout << "FAILED: " << name << " has surfaces up to " << offset << " of its " << size << " bytes" << endl;
+		return false;
+	}
+
+	//Past the last slice and the last mip there is nothing
+	if (file.GetSurface(file.GetArraySize(), 0, surface, rowPitch, slicePitch, width, height) || file.GetSurface(0, file.GetMipCount(), surface, rowPitch, slicePitch, width, height))
+	{
+		cout << "FAILED: " << name << " has a surface past its last slice or mip" << endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool GetReferencePitch(unsigned int format, unsigned int width, unsigned int height, unsigned int& rowPitch, unsigned int& rows)
+{
+	unsigned int blockSize;
+	unsigned int pixelSize;
+
+	//Bytes a 4x4 block or a texel takes, written out one format at a time
+	blockSize = 0;
+	pixelSize = 0;
+	switch (format)
+	{
+	case DDS_FORMAT_BC1_UNORM:
+	case DDS_FORMAT_BC4_UNORM:
+	case DDS_FORMAT_BC4_SNORM:
+		blockSize = 8;
+		break;
+	case DDS_FORMAT_BC2_UNORM:
+	case DDS_FORMAT_BC3_UNORM:
+	case DDS_FORMAT_BC5_UNORM:
+	case DDS_FORMAT_BC5_SNORM:
+	case DDS_FORMAT_BC7_UNORM:
+		blockSize = 16;
+		break;
+	case DDS_FORMAT_R32G32B32A32_FLOAT:
+		pixelSize = 16;
+		break;
+	case DDS_FORMAT_R16G16B16A16_FLOAT:
+	case DDS_FORMAT_R16G16B16A16_UNORM:
+	case DDS_FORMAT_R32G32_FLOAT:
+		pixelSize = 8;
+		break;
+	case DDS_FORMAT_R10G10B10A2_UNORM:
+	case DDS_FORMAT_R8G8B8A8_UNORM:
+	case DDS_FORMAT_R16G16_FLOAT:
+	case DDS_FORMAT_R16G16_UNORM:
+	case DDS_FORMAT_R32_FLOAT:
+	case DDS_FORMAT_B8G8R8A8_UNORM:
+	case DDS_FORMAT_B8G8R8X8_UNORM:
+		pixelSize = 4;
+		break;
+	case DDS_FORMAT_R8G8_UNORM:
+	case DDS_FORMAT_R16_FLOAT:
+	case DDS_FORMAT_R16_UNORM:
+	case DDS_FORMAT_B5G6R5_UNORM:
+	case DDS_FORMAT_B5G5R5A1_UNORM:
+	case DDS_FORMAT_B4G4R4A4_UNORM:
+		pixelSize = 2;
+		break;
+	case DDS_FORMAT_R8_UNORM:
+	case DDS_FORMAT_A8_UNORM:
+		pixelSize = 1;
+		break;
+	default:
+		return false;
+	}
+
+	//A block compressed level smaller than a block still takes a whole one
+	if (blockSize != 0)
+	{
+		rowPitch = max((width + 3) / 4, 1u) * blockSize;
+		rows = max((height + 3) / 4, 1u);
+	}
+	else
+	{
+		rowPitch = width * pixelSize;
+		rows = height;
+	}
+
+	return true;
+}
+
+void MakeDdsFile(const DdsTestType& test, vector<unsigned char>& file)
+{
+	unsigned int width;
+	unsigned int height;
+	unsigned int rowPitch;
+	unsigned int rows;
+	unsigned int mipCount;
+	size_t size;
+
+	//The magic number and the header, with the mip count only flagged when the test has one
+	mipCount = max(test.mipCount, 1u);
+	file.assign(test.dx10[0] != 0 ? 148 : 128, 0);
+	SetDdsValue(file, 0, DDS_BENCH_MAGIC);
+	SetDdsValue(file, 4, 124);
+	SetDdsValue(file, 8, 0x1007 | (test.mipCount != 0 ? 0x20000 : 0));
+	SetDdsValue(file, 12, test.height);
+	SetDdsValue(file, 16, test.width);
+	SetDdsValue(file, 28, test.mipCount);
+	SetDdsValue(file, 76, 32);
+	SetDdsValue(file, 80, test.pixelFlags);
+	SetDdsValue(file, 84, test.fourCC);
+	SetDdsValue(file, 88, test.bitCount);
+	for (int i = 0; i < 4; i++)
+	{
+		SetDdsValue(file, 92 + (i * 4), test.masks[i]);
+	}
+	SetDdsValue(file, 108, 0x1000);
+	SetDdsValue(file, 112, test.caps2);
+
+	//The DX10 header holds the format, the dimension, the cube map flag and the array size
+	if (test.dx10[0] != 0)
+	{
+		SetDdsValue(file, 80, 0x4);
+		SetDdsValue(file, 84, DDS_BENCH_DX10);
+		for (int i = 0; i < 4; i++)
+		{
+			SetDdsValue(file, 128 + (i * 4), test.dx10[i]);
+		}
+	}
+
+	//Surfaces of the size the reference gives them, filled with a pattern so a misplaced one would show
+	size = file.size();
+	for (unsigned int slice = 0; slice < test.arraySize; slice++)
+	{
+		width = test.width;
+		height = test.height;
+		for (unsigned int mip = 0; mip < mipCount; mip++)
+		{
+			GetReferencePitch(test.format, width, height, rowPitch, rows);
+			size += rowPitch * rows;
+			width = max(width / 2, 1u);
+			height = max(height / 2, 1u);
+		}
+	}
+	for (size_t i = file.size(); i < size; i++)
+	{
+		file.push_back((unsigned char)((i * 7) >> 3));
+	}
+}
+
+void SetDdsValue(vector<unsigned char>& file, size_t offset, unsigned int value)
+{
+	memcpy(&file[offset], &value, sizeof(unsigned int));
+}
+
+bool CheckMadeDdsFiles()
+{
+	DdsFile file;
+	vector<unsigned char> data;
+	const DdsTestType* tests;
+	const DdsTestType* test;
+	int testCount;
+
+	tests = GetDdsTests(testCount);
+	for (int i = 0; i < testCount; i++)
+	{
+		test = &tests[i];
+
+		MakeDdsFile(*test, data);
+		if (!file.Initialize(&data[0], data.size()))
+		{
+			cout << "FAILED: " << test->name << " did not parse" << endl;
+			return false;
+		}
+
+		if (file.GetWidth() != test->width || file.GetHeight() != test->height || file.GetMipCount() != max(test->mipCount, 1u) || file.GetArraySize() != test->arraySize ||
+			file.GetFormat() != test->format || file.IsCubeMap() != test->cubeMap || file.IsBlockCompressed() != test->blockCompressed)
+		{
+			cout << "FAILED: " << test->name << " parsed as " << file.GetWidth() << "x" << file.GetHeight() << " with " << file.GetMipCount() << " mips and ";
+			cout << file.GetArraySize() << " slices in format " << file.GetFormat() << endl;
+			file.Shutdown();
+			return false;
+		}
+
+		if (!CheckDdsSurfaces(file, &data[0], data.size(), test->name))
+		{
+			file.Shutdown();
+			return false;
+		}
+
+		file.Shutdown();
+	}
+
+	return true;
+}
+
+bool CheckBrokenDdsFiles()
+{
+	DdsFile file;
+	vector<unsigned char> data;
+	vector<unsigned char> cut;
+	const DdsTestType* tests;
+	const DdsBrokenType* brokens;
+	const DdsBrokenType* broken;
+	const unsigned char* start;
+	int testCount;
+	int brokenCount;
+
+	//Every file cut short anywhere. Up into the first surfaces the cut is copied out exactly as long, so a read past it is caught by a checked build
+	tests = GetDdsTests(testCount);
+	for (int i = 0; i < testCount; i++)
+	{
+		MakeDdsFile(tests[i], data);
+		for (size_t size = 0; size < data.size(); size++)
+		{
+			start = &data[0];
+			if (size < 256)
+			{
+				cut.assign(data.begin(), data.begin() + size);
+				start = cut.empty() ? nullptr : &cut[0];
+			}
+			if (file.Initialize(start, size))
+			{
+				cout << "FAILED: " << tests[i].name << " cut down to " << size << " of " << data.size() << " bytes parsed" << endl;
+				file.Shutdown();
+				return false;
+			}
+		}
+	}
+
+	//One field of a good file changed to something the parser has to turn down
+	brokens = GetBrokenDdsTests(brokenCount);
+	for (int i = 0; i < brokenCount; i++)
+	{
+		broken = &brokens[i];
+
+		MakeDdsFile(tests[broken->test], data);
+		SetDdsValue(data, broken->offset, broken->value);
+		if (file.Initialize(&data[0], data.size()))
+		{
+			cout << "FAILED: " << tests[broken->test].name << " with " << broken->name << " parsed" << endl;
+			file.Shutdown();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const DdsTestType* GetDdsTests(int& testCount)
+{
+	//Name, size and mips, the legacy pixel format, the cube map faces, the DX10 format, dimension, flags and array size,
+	//then what the parser should find. A mip count of 0 leaves the count out of the header
+	static const DdsTestType tests[] =
+	{
+		{ "a BC1 mip chain", 256, 64, 9, 0x4, DDS_BENCH_BC1, 0, { 0, 0, 0, 0 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_BC1_UNORM, 1, false, true },
+		{ "a DX10 BC3 chain of odd sizes", 100, 60, 7, 0, 0, 0, { 0, 0, 0, 0 }, 0, { DDS_FORMAT_BC3_UNORM, 3, 0, 1 }, DDS_FORMAT_BC3_UNORM, 1, false, true },
+		{ "a DX10 array", 64, 32, 4, 0, 0, 0, { 0, 0, 0, 0 }, 0, { DDS_FORMAT_R8G8B8A8_UNORM, 3, 0, 5 }, DDS_FORMAT_R8G8B8A8_UNORM, 5, false, false },
+		{ "a DX10 BC7 cube map array", 32, 32, 6, 0, 0, 0, { 0, 0, 0, 0 }, 0, { DDS_FORMAT_BC7_UNORM, 3, 0x4, 2 }, DDS_FORMAT_BC7_UNORM, 12, true, true },
+		{ "a legacy cube map", 16, 16, 5, 0x41, 0, 32, { 0xFF0000, 0xFF00, 0xFF, 0xFF000000 }, 0xFE00, { 0, 0, 0, 0 }, DDS_FORMAT_B8G8R8A8_UNORM, 6, true, false },
+		{ "an odd width 565 texture", 33, 7, 0, 0x40, 0, 16, { 0xF800, 0x07E0, 0x001F, 0 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_B5G6R5_UNORM, 1, false, false },
+		{ "a luminance chain", 3, 3, 2, 0x20000, 0, 8, { 0xFF, 0, 0, 0 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_R8_UNORM, 1, false, false },
+		{ "a float chain by D3DFORMAT number", 8, 8, 4, 0x4, 116, 0, { 0, 0, 0, 0 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_R32G32B32A32_FLOAT, 1, false, false }
+	};
+
+	testCount = sizeof(tests) / sizeof(tests[0]);
+	return tests;
+}
+
+const DdsBrokenType* GetBrokenDdsTests(int& brokenCount)
+{
+	//What is broken, the test it is done to and the field that is changed
+	static const DdsBrokenType brokens[] =
+	{
+		{ "a bad magic number", 0, 0, 0x20534445 },
+		{ "a header size of 0", 0, 4, 0 },
+		{ "a pixel format size of 0", 0, 76, 0 },
+		{ "no height", 0, 12, 0 },
+		{ "no width", 0, 16, 0 },
+		{ "more mips than the chain has", 0, 28, 10 },
+		{ "a width that wraps the row pitch round to 0", 5, 16, 0x10000000 },
+		{ "a height past the largest texture", 5, 12, DDS_MAX_SIZE + 1 },
+		{ "an unknown four character code", 0, 84, 0x575A5958 },
+		{ "an RGB layout the parser does not know", 4, 88, 24 },
+		{ "a volume texture", 0, 112, 0x200000 },
+		{ "a cube map missing faces", 4, 112, 0x0600 },
+		{ "no DX10 format", 1, 128, 0 },
+		{ "a DX10 format the parser does not know", 1, 128, 200 },
+		{ "a 3D resource dimension", 1, 132, 4 },
+		{ "an array size of 0", 2, 140, 0 },
+		{ "an array size that wraps the surface table round to 0", 2, 140, 0x40000000 },
+		{ "more cube faces than an array can hold", 3, 140, (DDS_MAX_ARRAY_SIZE / 6) + 1 }
+	};
+
+	brokenCount = sizeof(brokens) / sizeof(brokens[0]);
+	return brokens;
+}
+
+bool CheckTextureArrays()
+{
+	TextureArrayPacker packer;
+	DdsFile files[7];
+	vector<unsigned char> data[7];
+	vector<TextureArrayPacker::SubresourceType> subresources;
+	TextureArrayPacker::SubresourceType* subresource;
+	const void* surface;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+	unsigned int mip;
+	unsigned long long chainSize;
+	bool result;
+	int slices[7];
+	int file;
+	int arrayIndex;
+
+	//Files the packer takes and files it turns down, in the order they are added
+	static const DdsTestType images[] =
+	{
+		{ "a texture with 4 mips", 64, 32, 4, 0x41, 0, 32, { 0xFF, 0xFF00, 0xFF0000, 0xFF000000 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_R8G8B8A8_UNORM, 1, false, false },
+		{ "a DX10 array of 5 with 4 mips", 64, 32, 4, 0, 0, 0, { 0, 0, 0, 0 }, 0, { DDS_FORMAT_R8G8B8A8_UNORM, 3, 0, 5 }, DDS_FORMAT_R8G8B8A8_UNORM, 5, false, false },
+		{ "a texture with 2 mips", 64, 32, 2, 0x41, 0, 32, { 0xFF, 0xFF00, 0xFF0000, 0xFF000000 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_R8G8B8A8_UNORM, 1, false, false },
+		{ "a cube map", 64, 32, 2, 0, 0, 0, { 0, 0, 0, 0 }, 0, { DDS_FORMAT_R8G8B8A8_UNORM, 3, 0x4, 1 }, DDS_FORMAT_R8G8B8A8_UNORM, 6, true, false },
+		{ "a narrower texture", 32, 32, 2, 0x41, 0, 32, { 0xFF, 0xFF00, 0xFF0000, 0xFF000000 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_R8G8B8A8_UNORM, 1, false, false },
+		{ "a shorter texture", 64, 16, 2, 0x41, 0, 32, { 0xFF, 0xFF00, 0xFF0000, 0xFF000000 }, 0, { 0, 0, 0, 0 }, DDS_FORMAT_R8G8B8A8_UNORM, 1, false, false },
+		{ "a BC3 texture", 64, 32, 2, 0, 0, 0, { 0, 0, 0, 0 }, 0, { DDS_FORMAT_BC3_UNORM, 3, 0, 1 }, DDS_FORMAT_BC3_UNORM, 1, false, true }
+	};
+	const int expected[7] = { 0, 1, 6, TEXTURE_ARRAY_ERROR_CUBE_MAP, TEXTURE_ARRAY_ERROR_SIZE, TEXTURE_ARRAY_ERROR_SIZE, TEXTURE_ARRAY_ERROR_FORMAT };
+	const unsigned int expectedSlices[7] = { 1, 6, 7, 7, 7, 7, 7 };
+	const unsigned int expectedMips[7] = { 4, 4, 2, 2, 2, 2, 2 };
+
+	for (file = 0; file < 7; file++)
+	{
+		MakeDdsFile(images[file], data[file]);
+		if (!files[file].Initialize(&data[file][0], data[file].size()))
+		{
+			cout << "FAILED: " << images[file].name << " for the texture array did not parse" << endl;
+			return false;
+		}
+	}
+
+	//No slices at all or more than an array can hold
+	result = !packer.Initialize(0) && !packer.Initialize(TEXTURE_ARRAY_MAX_SLICES + 1) && packer.Initialize(8);
+	if (result)
+	{
+		result = !packer.GetSubresources(subresources) && packer.GetMemorySize() == 0;
+	}
+	if (!result)
+	{
+		cout << "FAILED: the texture array packer took a bad slice count or made an empty array" << endl;
+	}
+
+	//Each file goes in at the next free slice, the array in the file takes one slice for each of its elements. The rest are turned down and change nothing
+	for (file = 0; result && file < 7; file++)
+	{
+		slices[file] = packer.AddImage(&files[file]);
+		if (slices[file] != expected[file] || packer.GetSliceCount() != expectedSlices[file] || packer.GetMipCount() != expectedMips[file])
+		{
+			cout << "FAILED: adding " << images[file].name << " to the texture array gave " << slices[file] << " instead of " << expected[file];
+			cout << " with " << packer.GetSliceCount() << " slices and " << packer.GetMipCount() << " mips" << endl;
+			result = false;
+		}
+	}
+
+	//The chains are cut down to the shortest one
+	if (result && (packer.GetWidth() != 64 || packer.GetHeight() != 32 || packer.GetFormat() != DDS_FORMAT_R8G8B8A8_UNORM || packer.GetMipCount() != 2))
+	{
+		cout << "FAILED: the texture array is " << packer.GetWidth() << "x" << packer.GetHeight() << " with " << packer.GetMipCount() << " mips in format " << packer.GetFormat() << endl;
+		result = false;
+	}
+
+	//Slice by slice each with its chain, every one the surface of the file and element it came from
+	if (result && !packer.GetSubresources(subresources))
+	{
+		cout << "FAILED: the texture array could not list its subresources" << endl;
+		result = false;
+	}
+	if (result && subresources.size() != 7 * 2)
+	{
+		cout << "FAILED: the texture array has " << subresources.size() << " subresources instead of " << 7 * 2 << endl;
+		result = false;
+	}
+	for (int slice = 0; result && slice < 7; slice++)
+	{
+		file = (slice == 0) ? 0 : ((slice < 6) ? 1 : 2);
+		arrayIndex = (file == 1) ? slice - 1 : 0;
+		for (mip = 0; result && mip < 2; mip++)
+		{
+			subresource = &subresources[(slice * 2) + mip];
+			files[file].GetSurface(arrayIndex, mip, surface, rowPitch, slicePitch, width, height);
+			if (subresource->data != surface || subresource->rowPitch != rowPitch || subresource->slicePitch != slicePitch || rowPitch != (64u >> mip) * 4)
+			{
+				cout << "FAILED: slice " << slice << " mip " << mip << " of the texture array is not element " << arrayIndex << " of " << images[file].name << endl;
+				result = false;
+			}
+		}
+	}
+
+	chainSize = (64 * 32 * 4) + (32 * 16 * 4);
+	if (result && packer.GetMemorySize() != chainSize * 7)
+	{
+		cout << "FAILED: the texture array takes " << packer.GetMemorySize() << " bytes instead of " << chainSize * 7 << endl;
+		result = false;
+	}
+
+	//One slice is left, an array of five no longer fits but a single image does, and after it nothing does
+	if (result)
+	{
+		slices[0] = packer.AddImage(&files[1]);
+		slices[1] = packer.AddImage(&files[0]);
+		slices[2] = packer.AddImage(&files[2]);
+		if (slices[0] != TEXTURE_ARRAY_ERROR_FULL || slices[1] != 7 || slices[2] != TEXTURE_ARRAY_ERROR_FULL || packer.GetSliceCount() != 8)
+		{
+			cout << "FAILED: filling the texture array gave " << slices[0] << ", " << slices[1] << " and " << slices[2] << " with " << packer.GetSliceCount() << " slices" << endl;
+			result = false;
+		}
+	}
+
+	//A short chain first keeps the array short, the longer chains after it are cut down too
+	if (result)
+	{
+		packer.Initialize(8);
+		slices[0] = packer.AddImage(&files[2]);
+		slices[1] = packer.AddImage(&files[0]);
+		if (slices[0] != 0 || slices[1] != 1 || packer.GetMipCount() != 2 || !packer.GetSubresources(subresources) || subresources.size() != 2 * 2)
+		{
+			cout << "FAILED: a short chain first gave a texture array with " << packer.GetMipCount() << " mips" << endl;
+			result = false;
+		}
+	}
+
+	packer.Shutdown();
+	for (file = 0; file < 7; file++)
+	{
+		files[file].Shutdown();
+	}
+
+	return result;
+}
+
+bool TimeDdsFiles(const vector<string>& fileNames, int roundCount, double& openTime)
+{
+	DdsFile file;
+	unsigned long long start;
+
+	//The first round is left out, it brings the files into the cache
+	openTime = 0.0;
+	for (int round = 0; round <= roundCount; round++)
+	{
+		start = Profiler::GetTime();
+		for (size_t i = 0; i < fileNames.size(); i++)
+		{
+			if (!file.Initialize(fileNames[i].c_str()))
+			{
+				cout << "FAILED: " << fileNames[i] << " did not parse" << endl;
+				return false;
+			}
+			file.Shutdown();
+		}
+		if (round > 0)
+		{
+			openTime += (double)(Profiler::GetTime() - start);
+		}
+	}
+
+	openTime /= (double)roundCount * (double)fileNames.size() * 1000.0;
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,751 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <emmintrin.h>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "../Engine/DdsFile.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int FILTER_BOX = 0;
+const int FILTER_KAISER = 1;
+const int FILTER_LANCZOS = 2;
+
+const int TYPE_AUTO = 0;
+const int TYPE_COLOR = 1;
+const int TYPE_LINEAR = 2;
+const int TYPE_NORMAL = 3;
+
+//Half widths of the filters in texels of the smaller level
+const float KAISER_WIDTH = 3.0f;
+const float KAISER_ALPHA = 4.0f;
+const float LANCZOS_WIDTH = 3.0f;
+
+const int SRGB_ENCODE_ENTRIES = 4096;
+const float NORMAL_TOLERANCE = 0.1f;
+const float NORMAL_FRACTION = 0.95f;
+const float PI = 3.14159265358979f;
+
+float g_srgbDecode[256];
+unsigned char g_srgbEncode[SRGB_ENCODE_ENTRIES + 1];
+
+//////////////
+// TYPEDEFS //
+//////////////
+
+//The header written out in front of the generated chain, sources are read with DdsFile
+struct DdsHeaderType
+{
+	unsigned int magic;
+	unsigned int size;
+	unsigned int flags;
+	unsigned int height;
+	unsigned int width;
+	unsigned int pitchOrLinearSize;
+	unsigned int depth;
+	unsigned int mipMapCount;
+	unsigned int reserved1[11];
+	unsigned int pixelFormatSize;
+	unsigned int pixelFormatFlags;
+	unsigned int fourCC;
+	unsigned int rgbBitCount;
+	unsigned int redBitMask;
+	unsigned int greenBitMask;
+	unsigned int blueBitMask;
+	unsigned int alphaBitMask;
+	unsigned int caps;
+	unsigned int caps2;
+	unsigned int caps3;
+	unsigned int caps4;
+	unsigned int reserved2;
+};
+
+//Levels are held as four floats per texel, in linear space for color and as -1 to +1 vectors for normal maps
+struct LevelType
+{
+	int width;
+	int height;
+	vector<float> texels;
+};
+
+struct ImageType
+{
+	string inputName;
+	string outputName;
+	int type;
+	vector<LevelType> levels;
+};
+
+//The source texels and weights that make up one texel of the smaller level along one axis
+struct ContributionType
+{
+	int first;
+	int count;
+	int weightStart;
+};
+
+struct FilterTableType
+{
+	vector<ContributionType> contributions;
+	vector<float> weights;
+};
+
+struct MipTaskType
+{
+	vector<ImageType>* images;
+	vector<int>* imageIndices;
+	vector<int>* levelIndices;
+	atomic<int>* nextTask;
+	int filter;
+	bool wrap;
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+bool LoadSourceImage(const char* filename, int type, ImageType& image);
+bool SaveImage(const ImageType& image);
+int ChooseType(const vector<unsigned char>& texels);
+const char* GetTypeName(int type);
+void MipWorker(MipTaskType* task);
+void GenerateLevel(const LevelType& source, int filter, bool wrap, bool normalMap, LevelType& level);
+void BuildFilterTable(int sourceSize, int size, int filter, bool wrap, FilterTableType& table);
+float EvaluateFilter(int filter, float x);
+float GetFilterWidth(int filter);
+float BesselI0(float x);
+float Sinc(float x);
+void BuildGammaTables();
+float SrgbToLinear(unsigned char value);
+unsigned char LinearToSrgb(float value);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	bool result;
+	vector<ImageType> images;
+	vector<int> imageIndices;
+	vector<int> levelIndices;
+	vector<thread> threads;
+	atomic<int> nextTask;
+	MipTaskType task;
+	int filter;
+	int type;
+	int threadCount;
+	int firstArgument;
+	int levelCount;
+	bool wrap;
+	long long texelCount;
+
+	//Usage: MipGenerator [-filter kaiser|lanczos|box] [-type auto|color|linear|normal] [-clamp] <input.dds> <output.dds> ...
+	if (argc < 3)
+	{
+		cout << "Usage: MipGenerator [-filter kaiser|lanczos|box] [-type auto|color|linear|normal] [-clamp] <input.dds> <output.dds> ..." << endl;
+		cout << "  -filter  downsampling filter (default kaiser)" << endl;
+		cout << "  -type    color is filtered in linear space, linear as stored and normal maps are renormalized (default auto)" << endl;
+		cout << "  -clamp   clamp at the edges instead of wrapping for textures that do not tile" << endl;
+		return -1;
+	}
+
+	filter = FILTER_KAISER;
+	type = TYPE_AUTO;
+	wrap = true;
+	firstArgument = 1;
+	while (firstArgument < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-clamp") == 0)
+		{
+			wrap = false;
+			firstArgument++;
+			continue;
+		}
+
+		if (firstArgument + 1 >= argc)
+		{
+			cout << "Missing value for " << argv[firstArgument] << endl;
+			return -1;
+		}
+
+		if (strcmp(argv[firstArgument], "-filter") == 0)
+		{
+			const char* names[3] = { "box", "kaiser", "lanczos" };
+			filter = -1;
+			for (int i = 0; i < 3; i++)
+			{
+				if (strcmp(argv[firstArgument + 1], names[i]) == 0)
+				{
+					filter = i;
+				}
+			}
+		}
+		else if (strcmp(argv[firstArgument], "-type") == 0)
+		{
+			const char* names[4] = { "auto", "color", "linear", "normal" };
+			type = -1;
+			for (int i = 0; i < 4; i++)
+			{
+				if (strcmp(argv[firstArgument + 1], names[i]) == 0)
+				{
+					type = i;
+				}
+			}
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (filter < 0 || type < 0 || firstArgument >= argc || ((argc - firstArgument) % 2) != 0)
+	{
+		cout << "Invalid filter or type, or the files are not in input and output pairs" << endl;
+		return -1;
+	}
+
+	BuildGammaTables();
+
+	//Read in every image
+	for (int i = firstArgument; i < argc; i += 2)
+	{
+		ImageType image;
+		result = LoadSourceImage(argv[i], type, image);
+		if (!result)
+		{
+			cout << "Could not load " << argv[i] << ", only uncompressed 32 bit 2D DDS files are supported" << endl;
+			return -1;
+		}
+		image.outputName = argv[i + 1];
+		images.push_back(image);
+	}
+
+	//Every level of every image is a separate task. Each level is filtered straight from the top level
+	//with a wider kernel, so no level waits on the one above it and no error builds up down the chain
+	texelCount = 0;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		levelCount = 1;
+		while ((images[i].levels[0].width >> levelCount) > 0 || (images[i].levels[0].height >> levelCount) > 0)
+		{
+			levelCount++;
+		}
+
+		images[i].levels.resize(levelCount);
+		for (int level = 1; level < levelCount; level++)
+		{
+			images[i].levels[level].width = max(images[i].levels[0].width >> level, 1);
+			images[i].levels[level].height = max(images[i].levels[0].height >> level, 1);
+			imageIndices.push_back((int)i);
+			levelIndices.push_back(level);
+			texelCount += (long long)images[i].levels[level].width * images[i].levels[level].height;
+		}
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	threadCount = (int)thread::hardware_concurrency();
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	nextTask = 0;
+	task.images = &images;
+	task.imageIndices = &imageIndices;
+	task.levelIndices = &levelIndices;
+	task.nextTask = &nextTask;
+	task.filter = filter;
+	task.wrap = wrap;
+	for (int i = 0; i < threadCount; i++)
+	{
+		threads.push_back(thread(MipWorker, &task));
+	}
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+	//Write out every image with its full chain
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		result = SaveImage(images[i]);
+		if (!result)
+		{
+			cout << "Could not write " << images[i].outputName << endl;
+			return -1;
+		}
+
+		//Display the results to the screen for information purpose
+		cout << images[i].inputName << ": " << images[i].levels[0].width << "x" << images[i].levels[0].height << ", ";
+		cout << GetTypeName(images[i].type) << ", " << images[i].levels.size() << " levels" << endl;
+	}
+
+	cout << "Texels generated: " << texelCount << endl;
+	cout << "Time: " << fixed << setprecision(3) << chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0 << " ms on " << threadCount << " threads" << endl;
+
+	return 0;
+}
+
+bool LoadSourceImage(const char* filename, int type, ImageType& image)
+{
+	DdsFile file;
+	vector<unsigned char> bytes;
+	const void* data;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+	float* texel;
+	bool result;
+
+	//Map the file in, the header sizes are checked against the file there
+	result = file.Initialize(filename);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Only single uncompressed 32 bit textures are supported, not arrays or cube maps. Any mip levels in the file are replaced
+	if (file.GetArraySize() != 1)
+	{
+		file.Shutdown();
+		return false;
+	}
+
+	file.GetSurface(0, 0, data, rowPitch, slicePitch, width, height);
+	bytes.resize((size_t)width * height * 4);
+	result = file.GetSurfaceRgba(0, 0, &bytes[0]);
+
+	//Release the file
+	file.Shutdown();
+
+	if (!result)
+	{
+		return false;
+	}
+
+	image.inputName = filename;
+	image.type = (type == TYPE_AUTO) ? ChooseType(bytes) : type;
+	image.levels.resize(1);
+	image.levels[0].width = (int)width;
+	image.levels[0].height = (int)height;
+	image.levels[0].texels.resize(bytes.size());
+
+	//Move the texels into the space they are filtered in. Alpha is always linear
+	for (size_t i = 0; i < bytes.size() / 4; i++)
+	{
+		texel = &image.levels[0].texels[i * 4];
+		for (int c = 0; c < 3; c++)
+		{
+			if (image.type == TYPE_COLOR)
+			{
+				texel[c] = SrgbToLinear(bytes[(i * 4) + c]);
+			}
+			else if (image.type == TYPE_NORMAL)
+			{
+				texel[c] = ((float)bytes[(i * 4) + c] / 127.5f) - 1.0f;
+			}
+			else
+			{
+				texel[c] = (float)bytes[(i * 4) + c] / 255.0f;
+			}
+		}
+		texel[3] = (float)bytes[(i * 4) + 3] / 255.0f;
+	}
+
+	return true;
+}
+
+bool SaveImage(const ImageType& image)
+{
+	ofstream fOut;
+	DdsHeaderType header;
+	vector<unsigned int> texels;
+	const float* texel;
+	unsigned int channels[4];
+
+	//Write an A8R8G8B8 texture with the full chain, the same format as the rest of the assets
+	memset(&header, 0, sizeof(DdsHeaderType));
+	header.magic = 0x20534444;
+	header.size = 124;
+	header.flags = 0x2100F;
+	header.height = image.levels[0].height;
+	header.width = image.levels[0].width;
+	header.pitchOrLinearSize = image.levels[0].width * 4;
+	header.mipMapCount = (unsigned int)image.levels.size();
+	header.pixelFormatSize = 32;
+	header.pixelFormatFlags = 0x41;
+	header.rgbBitCount = 32;
+	header.redBitMask = 0x00FF0000;
+	header.greenBitMask = 0x0000FF00;
+	header.blueBitMask = 0x000000FF;
+	header.alphaBitMask = 0xFF000000;
+	header.caps = 0x401008;
+
+	//Open the output file
+	fOut.open(image.outputName.c_str(), ios::binary);
+	if (fOut.fail())
+	{
+		return false;
+	}
+
+	fOut.write((const char*)&header, sizeof(DdsHeaderType));
+
+	for (size_t level = 0; level < image.levels.size(); level++)
+	{
+		//Move the texels back out of the space they were filtered in
+		texels.resize((size_t)image.levels[level].width * image.levels[level].height);
+		for (size_t i = 0; i < texels.size(); i++)
+		{
+			texel = &image.levels[level].texels[i * 4];
+			for (int c = 0; c < 3; c++)
+			{
+				if (image.type == TYPE_COLOR)
+				{
+					channels[c] = LinearToSrgb(texel[c]);
+				}
+				else if (image.type == TYPE_NORMAL)
+				{
+					channels[c] = (unsigned int)min(max((texel[c] + 1.0f) * 127.5f + 0.5f, 0.0f), 255.0f);
+				}
+				else
+				{
+					channels[c] = (unsigned int)min(max(texel[c] * 255.0f + 0.5f, 0.0f), 255.0f);
+				}
+			}
+			channels[3] = (unsigned int)min(max(texel[3] * 255.0f + 0.5f, 0.0f), 255.0f);
+
+			texels[i] = (channels[3] << 24) | (channels[0] << 16) | (channels[1] << 8) | channels[2];
+		}
+
+		fOut.write((const char*)&texels[0], texels.size() * sizeof(unsigned int));
+	}
+
+	//Close the output file
+	fOut.close();
+
+	return !fOut.fail();
+}
+
+int ChooseType(const vector<unsigned char>& texels)
+{
+	size_t count;
+	size_t unitLength;
+	float x;
+	float y;
+	float z;
+	float length;
+
+	//Normal maps hold unit vectors, so almost every texel expands to a length of one
+	count = texels.size() / 4;
+	unitLength = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		x = ((float)texels[(i * 4) + 0] / 127.5f) - 1.0f;
+		y = ((float)texels[(i * 4) + 1] / 127.5f) - 1.0f;
+		z = ((float)texels[(i * 4) + 2] / 127.5f) - 1.0f;
+		length = sqrtf((x * x) + (y * y) + (z * z));
+		if (fabsf(length - 1.0f) < NORMAL_TOLERANCE && z > 0.0f)
+		{
+			unitLength++;
+		}
+	}
+
+	if ((float)unitLength >= NORMAL_FRACTION * (float)count)
+	{
+		return TYPE_NORMAL;
+	}
+
+	//Anything else is taken to be color, data maps have to be marked linear on the command line
+	return TYPE_COLOR;
+}
+
+const char* GetTypeName(int type)
+{
+	switch (type)
+	{
+	case TYPE_COLOR:
+		return "color";
+	case TYPE_NORMAL:
+		return "normal map";
+	default:
+		return "linear";
+	}
+}
+
+void MipWorker(MipTaskType* task)
+{
+	int index;
+
+	//Take levels until there are none left
+	index = (*task->nextTask)++;
+	while (index < (int)task->imageIndices->size())
+	{
+		ImageType& image = (*task->images)[(*task->imageIndices)[index]];
+		int level = (*task->levelIndices)[index];
+
+		GenerateLevel(image.levels[0], task->filter, task->wrap, image.type == TYPE_NORMAL, image.levels[level]);
+
+		index = (*task->nextTask)++;
+	}
+}
+
+void GenerateLevel(const LevelType& source, int filter, bool wrap, bool normalMap, LevelType& level)
+{
+	FilterTableType horizontal;
+	FilterTableType vertical;
+	vector<float> rows;
+	__m128 sum;
+	__m128 texel;
+	float* output;
+	float length;
+
+	//The filter is separable, so the rows are shrunk first and then the columns
+	BuildFilterTable(source.width, level.width, filter, wrap, horizontal);
+	BuildFilterTable(source.height, level.height, filter, wrap, vertical);
+
+	rows.resize((size_t)level.width * source.height * 4);
+	for (int y = 0; y < source.height; y++)
+	{
+		const float* sourceRow = &source.texels[(size_t)y * source.width * 4];
+		for (int x = 0; x < level.width; x++)
+		{
+			const ContributionType& contribution = horizontal.contributions[x];
+			const float* weights = &horizontal.weights[contribution.weightStart];
+			int sourceX;
+
+			//All four channels of a texel are weighted in one go
+			sum = _mm_setzero_ps();
+			for (int i = 0; i < contribution.count; i++)
+			{
+				sourceX = contribution.first + i;
+				sourceX = wrap ? (((sourceX % source.width) + source.width) % source.width) : min(max(sourceX, 0), source.width - 1);
+				texel = _mm_loadu_ps(&sourceRow[sourceX * 4]);
+				sum = _mm_add_ps(sum, _mm_mul_ps(texel, _mm_set1_ps(weights[i])));
+			}
+			_mm_storeu_ps(&rows[((size_t)y * level.width + x) * 4], sum);
+		}
+	}
+
+	level.texels.resize((size_t)level.width * level.height * 4);
+	for (int y = 0; y < level.height; y++)
+	{
+		const ContributionType& contribution = vertical.contributions[y];
+		const float* weights = &vertical.weights[contribution.weightStart];
+
+		for (int x = 0; x < level.width; x++)
+		{
+			int sourceY;
+
+			sum = _mm_setzero_ps();
+			for (int i = 0; i < contribution.count; i++)
+			{
+				sourceY = contribution.first + i;
+				sourceY = wrap ? (((sourceY % source.height) + source.height) % source.height) : min(max(sourceY, 0), source.height - 1);
+				texel = _mm_loadu_ps(&rows[((size_t)sourceY * level.width + x) * 4]);
+				sum = _mm_add_ps(sum, _mm_mul_ps(texel, _mm_set1_ps(weights[i])));
+			}
+
+			//The negative lobes of the filter can ring past the ends of the range
+			sum = _mm_min_ps(_mm_max_ps(sum, _mm_set1_ps(normalMap ? -1.0f : 0.0f)), _mm_set1_ps(1.0f));
+
+			output = &level.texels[((size_t)y * level.width + x) * 4];
+			_mm_storeu_ps(output, sum);
+
+			//Averaged normals get shorter where the surface is bumpy, so they are brought back to unit length
+			if (normalMap)
+			{
+				length = sqrtf((output[0] * output[0]) + (output[1] * output[1]) + (output[2] * output[2]));
+				if (length > 1e-6f)
+				{
+					output[0] /= length;
+					output[1] /= length;
+					output[2] /= length;
+				}
+				else
+				{
+					output[0] = 0.0f;
+					output[1] = 0.0f;
+					output[2] = 1.0f;
+				}
+			}
+		}
+	}
+}
+
+void BuildFilterTable(int sourceSize, int size, int filter, bool wrap, FilterTableType& table)
+{
+	ContributionType contribution;
+	float scale;
+	float center;
+	float radius;
+	float weight;
+	float total;
+	int last;
+
+	//The filter is stretched by the ratio of the sizes so it covers the same area of the smaller level
+	scale = (float)sourceSize / (float)size;
+	radius = GetFilterWidth(filter) * scale;
+
+	table.contributions.resize(size);
+	table.weights.clear();
+	for (int i = 0; i < size; i++)
+	{
+		center = ((float)i + 0.5f) * scale;
+		contribution.first = (int)floorf(center - radius);
+		last = (int)ceilf(center + radius);
+		contribution.weightStart = (int)table.weights.size();
+
+		//Without wrapping the taps past the edges would all land on the edge texel, so they are left out
+		if (!wrap)
+		{
+			contribution.first = max(contribution.first, 0);
+			last = min(last, sourceSize);
+		}
+
+		total = 0.0f;
+		for (int j = contribution.first; j < last; j++)
+		{
+			weight = EvaluateFilter(filter, (((float)j + 0.5f) - center) / scale);
+			table.weights.push_back(weight);
+			total += weight;
+		}
+		contribution.count = last - contribution.first;
+
+		//Normalize so flat areas keep their value
+		for (int j = 0; j < contribution.count; j++)
+		{
+			table.weights[contribution.weightStart + j] /= total;
+		}
+
+		table.contributions[i] = contribution;
+	}
+}
+
+float EvaluateFilter(int filter, float x)
+{
+	float width;
+	float t;
+
+	x = fabsf(x);
+	width = GetFilterWidth(filter);
+	if (x >= width)
+	{
+		return 0.0f;
+	}
+
+	switch (filter)
+	{
+	case FILTER_KAISER:
+		t = x / width;
+		return Sinc(x) * BesselI0(KAISER_ALPHA * sqrtf(1.0f - (t * t))) / BesselI0(KAISER_ALPHA);
+	case FILTER_LANCZOS:
+		return Sinc(x) * Sinc(x / width);
+	default:
+		return 1.0f;
+	}
+}
+
+float GetFilterWidth(int filter)
+{
+	switch (filter)
+	{
+	case FILTER_KAISER:
+		return KAISER_WIDTH;
+	case FILTER_LANCZOS:
+		return LANCZOS_WIDTH;
+	default:
+		return 0.5f;
+	}
+}
+
+float BesselI0(float x)
+{
+	float sum;
+	float term;
+	float halfX;
+
+	//The series converges quickly for the small arguments the window uses
+	sum = 1.0f;
+	term = 1.0f;
+	halfX = x / 2.0f;
+	for (int k = 1; k < 20; k++)
+	{
+		term *= (halfX / (float)k) * (halfX / (float)k);
+		sum += term;
+		if (term < sum * 1e-7f)
+		{
+			break;
+		}
+	}
+
+	return sum;
+}
+
+float Sinc(float x)
+{
+	if (fabsf(x) < 1e-5f)
+	{
+		return 1.0f;
+	}
+
+	return sinf(PI * x) / (PI * x);
+}
+
+void BuildGammaTables()
+{
+	float value;
+
+	//Decoding only ever sees 256 values, encoding uses a table fine enough to round the same as the formula
+	for (int i = 0; i < 256; i++)
+	{
+		value = (float)i / 255.0f;
+		g_srgbDecode[i] = (value <= 0.04045f) ? (value / 12.92f) : powf((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	for (int i = 0; i <= SRGB_ENCODE_ENTRIES; i++)
+	{
+		value = (float)i / (float)SRGB_ENCODE_ENTRIES;
+		value = (value <= 0.0031308f) ? (value * 12.92f) : ((1.055f * powf(value, 1.0f / 2.4f)) - 0.055f);
+		g_srgbEncode[i] = (unsigned char)min(max((value * 255.0f) + 0.5f, 0.0f), 255.0f);
+	}
+}
+
+float SrgbToLinear(unsigned char value)
+{
+	return g_srgbDecode[value];
+}
+
+unsigned char LinearToSrgb(float value)
+{
+	int index;
+
+	index = (int)((min(max(value, 0.0f), 1.0f) * (float)SRGB_ENCODE_ENTRIES) + 0.5f);
+
+	return g_srgbEncode[index];
+}
\ No newline at end of file
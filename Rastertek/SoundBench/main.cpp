@@ -0,0 +1,1545 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "../Engine/RiffReader.h"
+#include "../Engine/WaveFile.h"
+#include "../Engine/NullSoundSink.h"
+#include "../Engine/SoundStream.h"
+#include "../Engine/SoundClip.h"
+#include "../Engine/SoundMixer.h"
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+void PrintUsage();
+int StreamBench(int argc, char* argv[]);
+bool CheckCapture(WaveFile& file, const vector<unsigned char>& captured);
+int FuzzBench(int argc, char* argv[]);
+void BuildWave(mt19937& random, unsigned short formatTag, bool extensible, unsigned short channels, unsigned int sampleRate, unsigned short bitsPerSample, const vector<float>& samples, vector<unsigned char>& wave);
+void AppendChunk(vector<unsigned char>& wave, const char* id, const vector<unsigned char>& data);
+void AppendUShort(vector<unsigned char>& data, unsigned short value);
+void AppendUInt(vector<unsigned char>& data, unsigned int value);
+void Mutate(mt19937& random, vector<unsigned char>& wave);
+bool CheckParse(const vector<unsigned char>& wave, bool& accepted);
+int MixBench(int argc, char* argv[]);
+bool CheckMixer(unsigned int sampleRate, const char* outputDirectory);
+bool RenderVoice(unsigned int sampleRate, SoundClip& clip, const SoundMixer::VoiceDescType& desc, const float* forward, const float* right, unsigned int frameCount, vector<float>& mix);
+bool CheckThreadedMixer(unsigned int sampleRate, SoundClip& clip);
+bool CheckVoiceManager(unsigned int sampleRate, const char* outputDirectory);
+bool CompareMix(const vector<float>& mix, const vector<float>& expected, size_t firstFrame, size_t frameCount);
+void MakeTone(SoundClip& clip, float frequency, unsigned int sampleRate, unsigned int frameCount, bool loop);
+float GetLevel(const vector<float>& mix, int channel, size_t firstFrame, size_t frameCount);
+int CountCrossings(const vector<float>& mix, int channel, size_t firstFrame, size_t frameCount);
+bool SaveMix(const char* outputDirectory, const char* name, const vector<float>& mix, unsigned int sampleRate);
+int DecodeBench(int argc, char* argv[]);
+void DecodeWorker(WaveFile* file, double seconds, long long* frameCount);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	//Usage: SoundBench <mode> [options] <files>
+	if (argc < 2)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	if (strcmp(argv[1], "stream") == 0)
+	{
+		return StreamBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "fuzz") == 0)
+	{
+		return FuzzBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "mix") == 0)
+	{
+		return MixBench(argc - 2, argv + 2);
+	}
+
+	if (strcmp(argv[1], "decode") == 0)
+	{
+		return DecodeBench(argc - 2, argv + 2);
+	}
+
+	cout << "Unknown mode " << argv[1] << endl;
+	PrintUsage();
+	return -1;
+}
+
+void PrintUsage()
+{
+	cout << "Usage: SoundBench <mode> [options] <files>" << endl;
+	cout << "  stream [-segments n] [-ms n] [-step n] [-realtime] <file.wav>" << endl;
+	cout << "    Streams the file through a null sink and checks that what was played is the file followed by silence" << endl;
+	cout << "    -segments  segments in the ring (default 4)" << endl;
+	cout << "    -ms        length of a segment in milliseconds (default 100)" << endl;
+	cout << "    -step      bytes the cursor moves between services, 0 picks a quarter segment (default 0)" << endl;
+	cout << "    -realtime  play at the file's rate with the stream thread instead of stepping the cursor by hand" << endl;
+	cout << "  fuzz [-iterations n] [-seed n] <file.wav>..." << endl;
+	cout << "    Writes every sample format with the chunks shuffled and checks they read back, then feeds damaged copies" << endl;
+	cout << "    of those and of the given files to the parser and checks it never reads outside the file" << endl;
+	cout << "    -iterations  damaged files to parse (default 100000)" << endl;
+	cout << "    -seed        seed for the random damage (default 1)" << endl;
+	cout << "  mix [-voices n] [-real n] [-seconds n] [-rate n] [-out dir] [file.wav]..." << endl;
+	cout << "    Renders known scenes through the mixer and checks them, then times a mix of many voices moving around a turning listener" << endl;
+	cout << "    -voices   voices in the timed mix (default 256)" << endl;
+	cout << "    -real     voices actually mixed, the rest are virtual (default " << SOUND_MIXER_REAL_VOICES << ")" << endl;
+	cout << "    -seconds  length of the timed mix (default 10)" << endl;
+	cout << "    -rate     output rate (default 44100)" << endl;
+	cout << "    -out      write every rendered mix as a wave file into this directory" << endl;
+	cout << "    The files are mono clips for the timed mix, tones are made up when none are given" << endl;
+	cout << "  decode [-seconds n] [-threads n] <file.wav> [source.wav]" << endl;
+	cout << "    Times decoding the file to 16 bit a block at a time the way the stream does, on one thread and then on several" << endl;
+	cout << "    at once, and measures the error against the source it was compressed from" << endl;
+	cout << "    -seconds  how long to keep decoding for each timing (default 1)" << endl;
+	cout << "    -threads  decoders running at once in the second timing, 0 is one per core (default 0)" << endl;
+}
+
+int StreamBench(int argc, char* argv[])
+{
+	bool result;
+	WaveFile file;
+	NullSoundSink sink;
+	SoundStream stream;
+	unsigned int segmentCount;
+	unsigned int segmentMilliseconds;
+	unsigned int step;
+	unsigned int bufferSize;
+	unsigned int blockAlign;
+	bool realtime;
+	int firstArgument;
+	int serviceCount;
+	long long streamTime;
+
+	segmentCount = SOUND_STREAM_SEGMENT_COUNT;
+	segmentMilliseconds = SOUND_STREAM_SEGMENT_MILLISECONDS;
+	step = 0;
+	realtime = false;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-realtime") == 0)
+		{
+			realtime = true;
+			firstArgument++;
+			continue;
+		}
+
+		if (strcmp(argv[firstArgument], "-segments") == 0)
+		{
+			segmentCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-ms") == 0)
+		{
+			segmentMilliseconds = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-step") == 0)
+		{
+			step = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (argc - firstArgument != 1)
+	{
+		cout << "Expected a wave file" << endl;
+		return -1;
+	}
+
+	//Map the file, only the header is read here
+	result = file.Initialize(argv[firstArgument]);
+	if (!result)
+	{
+		cout << "Could not load " << argv[firstArgument] << endl;
+		return -1;
+	}
+
+	cout << argv[firstArgument] << ": " << file.GetChannels() << " channels, " << file.GetSampleRate() << " Hz, " << file.GetBitsPerSample() << " bit" << (file.IsCompressed() ? " ADPCM, " : ", ");
+	cout << fixed << setprecision(2) << (double)file.GetFrameCount() / file.GetSampleRate() << " s" << endl;
+
+	//Size the ring the same way Sound does and capture everything the cursor passes over
+	blockAlign = file.GetChannels() * SoundStream::GetOutputBits(&file) / 8;
+	bufferSize = SoundStream::GetBufferSize(&file, segmentMilliseconds, segmentCount);
+	result = sink.Initialize(file.GetSampleRate() * blockAlign, blockAlign, bufferSize, realtime, true);
+	if (!result)
+	{
+		cout << "Could not create the sink" << endl;
+		return -1;
+	}
+
+	if (step == 0)
+	{
+		step = bufferSize / segmentCount / 4;
+	}
+	step -= step % blockAlign;
+	if (step == 0)
+	{
+		step = blockAlign;
+	}
+
+	chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+
+	result = stream.Initialize(&file, &sink, segmentCount, false, realtime);
+	if (!result)
+	{
+		cout << "Could not start the stream" << endl;
+		return -1;
+	}
+
+	//Step the cursor by hand and service after every step, or let the stream thread keep up with the clock
+	serviceCount = 0;
+	while (stream.IsPlaying())
+	{
+		if (realtime)
+		{
+			this_thread::sleep_for(chrono::milliseconds(10));
+		}
+		else
+		{
+			sink.Advance(step);
+			stream.Service();
+			serviceCount++;
+		}
+	}
+
+	streamTime = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - startTime).count();
+
+	stream.Shutdown();
+
+	cout << "Ring: " << segmentCount << " segments of " << bufferSize / segmentCount << " bytes, " << bufferSize << " bytes instead of " << (unsigned long long)file.GetFrameCount() * blockAlign << endl;
+	cout << "Played " << sink.GetPlayedBytes() << " bytes in " << setprecision(3) << streamTime / 1000.0 << " ms";
+	if (!realtime)
+	{
+		cout << " over " << serviceCount << " services of " << step << " bytes";
+	}
+	cout << endl;
+	cout << "Underruns: " << stream.GetUnderrunCount() << endl;
+
+	result = CheckCapture(file, sink.GetCaptured());
+
+	sink.Shutdown();
+	file.Shutdown();
+
+	if (!result)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+bool CheckCapture(WaveFile& file, const vector<unsigned char>& captured)
+{
+	vector<short> decoded;
+	const unsigned char* samples;
+	size_t sampleSize;
+	size_t i;
+	unsigned char silence;
+
+	//Formats the sink cannot play are expected as the file decoded to 16 bit
+	if (file.GetFormatTag() == WAVE_FORMAT_TAG_PCM && file.GetBitsPerSample() == SoundStream::GetOutputBits(&file))
+	{
+		samples = file.GetSamples();
+		sampleSize = file.GetSampleSize();
+	}
+	else
+	{
+		decoded.resize(file.GetFrameCount() * file.GetChannels() + 1);
+		file.ReadSamples(0, file.GetFrameCount(), &decoded[0]);
+		samples = (const unsigned char*)&decoded[0];
+		sampleSize = (decoded.size() - 1) * 2;
+	}
+	silence = SoundStream::GetOutputBits(&file) == 8 ? 0x80 : 0;
+
+	//Everything in the file has to come out in order, anything played after it has to be silence
+	if (captured.size() < sampleSize)
+	{
+		cout << "FAILED: only " << captured.size() << " of " << sampleSize << " bytes were played" << endl;
+		return false;
+	}
+
+	for (i = 0; i < sampleSize; i++)
+	{
+		if (captured[i] != samples[i])
+		{
+			cout << "FAILED: byte " << i << " does not match the file" << endl;
+			return false;
+		}
+	}
+
+	for (i = sampleSize; i < captured.size(); i++)
+	{
+		if (captured[i] != silence)
+		{
+			cout << "FAILED: byte " << i << " after the end of the file is not silence" << endl;
+			return false;
+		}
+	}
+
+	cout << "Output matches the file" << endl;
+
+	return true;
+}
+int FuzzBench(int argc, char* argv[])
+{
+	static const unsigned short formatTags[6] = { WAVE_FORMAT_TAG_PCM, WAVE_FORMAT_TAG_PCM, WAVE_FORMAT_TAG_PCM, WAVE_FORMAT_TAG_PCM, WAVE_FORMAT_TAG_IEEE_FLOAT, WAVE_FORMAT_TAG_PCM };
+	static const unsigned short bitsPerSample[6] = { 8, 16, 24, 32, 32, 24 };
+	static const unsigned short channelCounts[4] = { 1, 2, 6, 8 };
+	static const unsigned int sampleRates[4] = { 8000, 22050, 44100, 96000 };
+	bool result;
+	bool accepted;
+	WaveFile file;
+	vector<vector<unsigned char> > seeds;
+	vector<unsigned char> wave;
+	vector<float> samples;
+	vector<float> decoded;
+	mt19937 random;
+	int iterationCount;
+	unsigned int seed;
+	int firstArgument;
+	int formatIndex;
+	int channelIndex;
+	int rateIndex;
+	int roundTripCount;
+	int acceptedCount;
+	int i;
+	size_t j;
+	size_t frameCount;
+	float tolerance;
+	float error;
+	float maxError;
+	long long fuzzTime;
+
+	iterationCount = 100000;
+	seed = 1;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-iterations") == 0)
+		{
+			iterationCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-seed") == 0)
+		{
+			seed = (unsigned int)atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	random.seed(seed);
+
+	//Write every format, channel count and rate with the chunks in a random order and check they come back the same
+	roundTripCount = 0;
+	for (formatIndex = 0; formatIndex < 6; formatIndex++)
+	{
+		for (channelIndex = 0; channelIndex < 4; channelIndex++)
+		{
+			for (rateIndex = 0; rateIndex < 4; rateIndex++)
+			{
+				frameCount = 1 + random() % 300;
+				samples.resize(frameCount * channelCounts[channelIndex]);
+				for (j = 0; j < samples.size(); j++)
+				{
+					samples[j] = (float)sin((double)j * 0.37) * 0.99f;
+				}
+
+				BuildWave(random, formatTags[formatIndex], formatIndex == 5, channelCounts[channelIndex], sampleRates[rateIndex], bitsPerSample[formatIndex], samples, wave);
+
+				result = file.Initialize(&wave[0], wave.size());
+				if (!result)
+				{
+					cout << "FAILED: could not read a " << bitsPerSample[formatIndex] << " bit file with " << channelCounts[channelIndex] << " channels at " << sampleRates[rateIndex] << " Hz" << endl;
+					return -1;
+				}
+
+				if (file.GetFormatTag() != formatTags[formatIndex] || file.GetChannels() != channelCounts[channelIndex] || file.GetSampleRate() != sampleRates[rateIndex] ||
+					file.GetBitsPerSample() != bitsPerSample[formatIndex] || file.GetFrameCount() != frameCount)
+				{
+					cout << "FAILED: the format of a " << bitsPerSample[formatIndex] << " bit file with " << channelCounts[channelIndex] << " channels read back wrong" << endl;
+					return -1;
+				}
+
+				//Each format can only be off by its own rounding
+				decoded.resize(samples.size());
+				file.ReadSamples(0, frameCount, &decoded[0]);
+				tolerance = formatTags[formatIndex] == WAVE_FORMAT_TAG_IEEE_FLOAT ? 0.0f : 1.0f / (float)(1 << (bitsPerSample[formatIndex] > 24 ? 23 : bitsPerSample[formatIndex] - 1));
+				maxError = 0.0f;
+				for (j = 0; j < samples.size(); j++)
+				{
+					error = fabs(decoded[j] - samples[j]);
+					maxError = error > maxError ? error : maxError;
+				}
+				if (maxError > tolerance)
+				{
+					cout << "FAILED: " << bitsPerSample[formatIndex] << " bit samples read back " << maxError << " away" << endl;
+					return -1;
+				}
+
+				file.Shutdown();
+				seeds.push_back(wave);
+				roundTripCount++;
+			}
+		}
+	}
+	cout << "Round trips: " << roundTripCount << " files in every format read back" << endl;
+
+	//Add the files from the command line to what gets damaged
+	for (i = firstArgument; i < argc; i++)
+	{
+		result = file.Initialize(argv[i]);
+		if (!result)
+		{
+			cout << "Could not load " << argv[i] << endl;
+			return -1;
+		}
+		file.Shutdown();
+
+		ifstream input(argv[i], ios::binary);
+		seeds.push_back(vector<unsigned char>((istreambuf_iterator<char>(input)), istreambuf_iterator<char>()));
+	}
+
+	//Parse damaged copies, each copy is its own allocation so reading past it is caught by a debug heap or a sanitizer
+	chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+
+	acceptedCount = 0;
+	for (i = 0; i < iterationCount; i++)
+	{
+		wave = seeds[random() % seeds.size()];
+		Mutate(random, wave);
+
+		result = CheckParse(wave, accepted);
+		if (!result)
+		{
+			cout << "FAILED: iteration " << i << " with seed " << seed << endl;
+			return -1;
+		}
+		if (accepted)
+		{
+			acceptedCount++;
+		}
+	}
+
+	fuzzTime = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - startTime).count();
+
+	cout << "Fuzzed: " << iterationCount << " damaged files from " << seeds.size() << " seeds, " << acceptedCount << " still accepted, ";
+	cout << fixed << setprecision(0) << iterationCount / (fuzzTime / 1000000.0 + 1e-9) << " files per second" << endl;
+	cout << "Parser held up" << endl;
+
+	return 0;
+}
+
+void BuildWave(mt19937& random, unsigned short formatTag, bool extensible, unsigned short channels, unsigned int sampleRate, unsigned short bitsPerSample, const vector<float>& samples, vector<unsigned char>& wave)
+{
+	static const unsigned char subFormatBase[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+	vector<unsigned char> format;
+	vector<unsigned char> data;
+	vector<unsigned char> extra;
+	vector<int> order;
+	unsigned short blockAlign;
+	size_t i;
+	int j;
+	int value;
+	float sample;
+
+	//The format chunk, extensible files carry the format tag inside the sub format
+	blockAlign = (unsigned short)(channels * bitsPerSample / 8);
+	AppendUShort(format, extensible ? WAVE_FORMAT_TAG_EXTENSIBLE : formatTag);
+	AppendUShort(format, channels);
+	AppendUInt(format, sampleRate);
+	AppendUInt(format, sampleRate * blockAlign);
+	AppendUShort(format, blockAlign);
+	AppendUShort(format, bitsPerSample);
+	if (extensible)
+	{
+		AppendUShort(format, 22);
+		AppendUShort(format, bitsPerSample);
+		AppendUInt(format, 0);
+		AppendUShort(format, formatTag);
+		format.insert(format.end(), subFormatBase, subFormatBase + sizeof(subFormatBase));
+	}
+
+	//The data chunk in the file's own encoding
+	for (i = 0; i < samples.size(); i++)
+	{
+		sample = samples[i];
+		if (formatTag == WAVE_FORMAT_TAG_IEEE_FLOAT)
+		{
+			data.insert(data.end(), (unsigned char*)&sample, (unsigned char*)&sample + 4);
+			continue;
+		}
+
+		value = (int)floor(sample * (float)(1 << (bitsPerSample > 24 ? 23 : bitsPerSample - 1)) + 0.5f);
+		switch (bitsPerSample)
+		{
+		case 8:
+			data.push_back((unsigned char)(value + 128));
+			break;
+		case 16:
+			AppendUShort(data, (unsigned short)value);
+			break;
+		case 24:
+			data.push_back((unsigned char)value);
+			data.push_back((unsigned char)(value >> 8));
+			data.push_back((unsigned char)(value >> 16));
+			break;
+		case 32:
+			AppendUInt(data, (unsigned int)value << 8);
+			break;
+		}
+	}
+
+	//Write the chunks in a random order with odd sized chunks the parser does not know about in between
+	wave.clear();
+	wave.insert(wave.end(), (const unsigned char*)"RIFF\0\0\0\0WAVE", (const unsigned char*)"RIFF\0\0\0\0WAVE" + 12);
+
+	order.push_back(0);
+	order.push_back(1);
+	order.push_back(2);
+	order.push_back(3);
+	order.push_back(4);
+	shuffle(order.begin(), order.end(), random);
+	for (j = 0; j < 5; j++)
+	{
+		extra.assign(random() % 41, (unsigned char)(random() & 0xFF));
+		switch (order[j])
+		{
+		case 0:
+			AppendChunk(wave, "fmt ", format);
+			break;
+		case 1:
+			AppendChunk(wave, "data", data);
+			break;
+		case 2:
+			AppendChunk(wave, "LIST", extra);
+			break;
+		case 3:
+			AppendChunk(wave, "fact", extra);
+			break;
+		case 4:
+			AppendChunk(wave, "JUNK", extra);
+			break;
+		}
+	}
+
+	wave[4] = (unsigned char)(wave.size() - 8);
+	wave[5] = (unsigned char)((wave.size() - 8) >> 8);
+	wave[6] = (unsigned char)((wave.size() - 8) >> 16);
+	wave[7] = (unsigned char)((wave.size() - 8) >> 24);
+}
+
+void AppendChunk(vector<unsigned char>& wave, const char* id, const vector<unsigned char>& data)
+{
+	wave.insert(wave.end(), id, id + 4);
+	AppendUInt(wave, (unsigned int)data.size());
+	wave.insert(wave.end(), data.begin(), data.end());
+	if (data.size() & 1)
+	{
+		wave.push_back(0);
+	}
+}
+
+void AppendUShort(vector<unsigned char>& data, unsigned short value)
+{
+	data.push_back((unsigned char)value);
+	data.push_back((unsigned char)(value >> 8));
+}
+
+void AppendUInt(vector<unsigned char>& data, unsigned int value)
+{
+	AppendUShort(data, (unsigned short)value);
+	AppendUShort(data, (unsigned short)(value >> 16));
+}
+
+void Mutate(mt19937& random, vector<unsigned char>& wave)
+{
+	static const unsigned int sizes[6] = { 0, 1, 0x7FFFFFFF, 0x80000000, 0xFFFFFFF8, 0xFFFFFFFF };
+	int mutationCount;
+	int i;
+	size_t offset;
+	unsigned int value;
+
+	//Flip bytes, overwrite fields with sizes that are easy to get wrong, or cut the file short
+	mutationCount = 1 + random() % 4;
+	for (i = 0; i < mutationCount && !wave.empty(); i++)
+	{
+		offset = random() % wave.size();
+		switch (random() % 4)
+		{
+		case 0:
+			wave[offset] = (unsigned char)random();
+			break;
+		case 1:
+			wave[offset] ^= (unsigned char)(1 << (random() % 8));
+			break;
+		case 2:
+			if (offset + 4 <= wave.size())
+			{
+				value = random() % 2 ? sizes[random() % 6] : (unsigned int)(random() % (wave.size() * 2 + 1));
+				wave[offset] = (unsigned char)value;
+				wave[offset + 1] = (unsigned char)(value >> 8);
+				wave[offset + 2] = (unsigned char)(value >> 16);
+				wave[offset + 3] = (unsigned char)(value >> 24);
+			}
+			break;
+		case 3:
+			wave.resize(offset);
+			break;
+		}
+	}
+}
+
+bool CheckParse(const vector<unsigned char>& wave, bool& accepted)
+{
+	WaveFile file;
+	unsigned char* copy;
+	vector<float> decoded;
+	vector<short> decoded16;
+	bool result;
+
+	//Parse a copy that is exactly as big as the file
+	copy = new unsigned char[wave.size()];
+	if (!wave.empty())
+	{
+		memcpy(copy, &wave[0], wave.size());
+	}
+
+	result = true;
+	accepted = file.Initialize(copy, wave.size());
+	if (accepted)
+	{
+		//The samples have to lie inside the file and be whole frames, or for compressed files no more frames than the blocks hold
+		if (file.GetSamples() < copy || file.GetSamples() + file.GetSampleSize() > copy + wave.size())
+		{
+			result = false;
+		}
+		else if (!file.IsCompressed() && (file.GetSampleSize() % file.GetBlockAlign() != 0 || file.GetBlockAlign() != file.GetChannels() * file.GetBitsPerSample() / 8))
+		{
+			result = false;
+		}
+		else if (file.IsCompressed() && file.GetFrameCount() > (file.GetSampleSize() / file.GetBlockAlign() + 1) * file.GetFramesPerBlock())
+		{
+			result = false;
+		}
+		else if (file.GetFrameCount() > 0)
+		{
+			//Reading every sample both ways touches all of the data chunk
+			decoded.resize(file.GetFrameCount() * file.GetChannels());
+			file.ReadSamples(0, file.GetFrameCount(), &decoded[0]);
+			decoded16.resize(file.GetFrameCount() * file.GetChannels());
+			file.ReadSamples(0, file.GetFrameCount(), &decoded16[0]);
+		}
+		file.Shutdown();
+	}
+
+	delete[] copy;
+	copy = nullptr;
+
+	return result;
+}
+int MixBench(int argc, char* argv[])
+{
+	bool result;
+	vector<SoundClip*> clips;
+	SoundClip* clip;
+	WaveFile file;
+	SoundMixer mixer;
+	SoundMixer::VoiceDescType desc;
+	vector<float> mix;
+	vector<float> block;
+	mt19937 random;
+	const char* outputDirectory;
+	unsigned int sampleRate;
+	unsigned int blockFrames;
+	unsigned int frameCount;
+	unsigned int done;
+	int voiceCount;
+	int realCount;
+	int firstArgument;
+	int i;
+	float seconds;
+	float angle;
+	float listener[3];
+	float forward[3];
+	float right[3];
+	long long mixTime;
+	double audioMilliseconds;
+	double voiceMilliseconds;
+
+	voiceCount = 256;
+	realCount = SOUND_MIXER_REAL_VOICES;
+	seconds = 10.0f;
+	sampleRate = 44100;
+	outputDirectory = nullptr;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-voices") == 0)
+		{
+			voiceCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-real") == 0)
+		{
+			realCount = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-seconds") == 0)
+		{
+			seconds = (float)atof(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-rate") == 0)
+		{
+			sampleRate = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-out") == 0)
+		{
+			outputDirectory = argv[firstArgument + 1];
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (voiceCount < 1 || voiceCount > SOUND_MIXER_MAX_VOICES || realCount < 0 || sampleRate < 8000)
+	{
+		cout << "Expected 1 to " << SOUND_MIXER_MAX_VOICES << " voices, no fewer than 0 real ones and a rate of at least 8000" << endl;
+		return -1;
+	}
+
+	//Render the known scenes first, the timing means nothing if they are wrong
+	result = CheckMixer(sampleRate, outputDirectory);
+	if (!result)
+	{
+		return -1;
+	}
+
+	//Load the clips for the timed mix as looping mono clips, or make up tones at rates that need resampling
+	for (i = firstArgument; i < argc; i++)
+	{
+		result = file.Initialize(argv[i]);
+		if (!result)
+		{
+			cout << "Could not load " << argv[i] << endl;
+			return -1;
+		}
+
+		clip = new SoundClip();
+		result = file.GetChannels() == 1 && clip->Initialize(&file, true);
+		file.Shutdown();
+		if (!result)
+		{
+			cout << argv[i] << " has to be a mono wave file" << endl;
+			delete clip;
+			return -1;
+		}
+		clips.push_back(clip);
+	}
+	if (clips.empty())
+	{
+		for (i = 0; i < 4; i++)
+		{
+			clip = new SoundClip();
+			MakeTone(*clip, 220.0f * (float)(i + 1), i % 2 ? 22050 : 48000, 30000 + i * 7919, true);
+			clips.push_back(clip);
+		}
+	}
+
+	//Scatter the voices around the listener at different pitches
+	result = mixer.Initialize(nullptr, sampleRate, 0, false);
+	if (!result)
+	{
+		cout << "Could not create the mixer" << endl;
+		return -1;
+	}
+
+	mixer.SetRealVoiceLimit(realCount);
+
+	random.seed(1);
+	for (i = 0; i < voiceCount; i++)
+	{
+		desc.volume = 0.5f / sqrtf((float)voiceCount);
+		desc.pitch = 0.75f + (float)(random() % 1000) / 2000.0f;
+		desc.priority = 0;
+		desc.spatial = true;
+		desc.position[0] = (float)((int)(random() % 160) - 80);
+		desc.position[1] = (float)((int)(random() % 20) - 10);
+		desc.position[2] = (float)((int)(random() % 160) - 80);
+		if (mixer.PlayVoice(clips[i % clips.size()], desc) < 0)
+		{
+			cout << "Could not play voice " << i << endl;
+			return -1;
+		}
+	}
+
+	//Mix a game frame at a time while the listener turns, moving every voice on every frame
+	blockFrames = sampleRate / 60;
+	frameCount = (unsigned int)(seconds * (float)sampleRate);
+	frameCount -= frameCount % blockFrames;
+	mix.resize((size_t)frameCount * 2);
+	listener[0] = 0.0f;
+	listener[1] = 0.0f;
+	listener[2] = 0.0f;
+
+	chrono::high_resolution_clock::time_point startTime = chrono::high_resolution_clock::now();
+
+	for (done = 0; done < frameCount; done += blockFrames)
+	{
+		angle = (float)done / (float)sampleRate * 0.5f;
+		forward[0] = sinf(angle);
+		forward[1] = 0.0f;
+		forward[2] = cosf(angle);
+		right[0] = cosf(angle);
+		right[1] = 0.0f;
+		right[2] = -sinf(angle);
+		mixer.SetListener(listener, forward, right);
+
+		mixer.Mix(&mix[(size_t)done * 2], blockFrames);
+		mixer.Update();
+	}
+
+	mixTime = chrono::duration_cast<chrono::microseconds>(chrono::high_resolution_clock::now() - startTime).count();
+
+	audioMilliseconds = (double)frameCount * 1000.0 / sampleRate;
+	voiceMilliseconds = (double)mixer.GetRealVoiceCount() * audioMilliseconds;
+	cout << "Mixed " << mixer.GetActiveVoiceCount() << " voices from " << clips.size() << " clips into " << fixed << setprecision(1) << audioMilliseconds / 1000.0 << " s of " << sampleRate << " Hz stereo in " << mixTime / 1000.0 << " ms" << endl;
+	cout << "Voices: " << mixer.GetRealVoiceCount() << " real and " << mixer.GetActiveVoiceCount() - mixer.GetRealVoiceCount() << " virtual at the end" << endl;
+	cout << "Throughput: " << setprecision(0) << voiceMilliseconds / (mixTime / 1000.0) << " real voices mixed per ms, " << audioMilliseconds / (mixTime / 1000.0) << " times realtime" << endl;
+
+	result = SaveMix(outputDirectory, "voices.wav", mix, sampleRate);
+	if (!result)
+	{
+		return -1;
+	}
+
+	mixer.Shutdown();
+	for (i = 0; i < (int)clips.size(); i++)
+	{
+		clips[i]->Shutdown();
+		delete clips[i];
+	}
+
+	return 0;
+}
+
+bool CheckMixer(unsigned int sampleRate, const char* outputDirectory)
+{
+	static const float forward[3] = { 0.0f, 0.0f, 1.0f };
+	static const float right[3] = { 1.0f, 0.0f, 0.0f };
+	static const float backward[3] = { 0.0f, 0.0f, -1.0f };
+	static const float left[3] = { -1.0f, 0.0f, 0.0f };
+	bool result;
+	SoundClip tone;
+	SoundClip slowTone;
+	SoundClip loopTone;
+	SoundMixer::VoiceDescType desc;
+	vector<float> mix;
+	unsigned int frameCount;
+	unsigned int i;
+	float level[4];
+	float jump;
+	int crossings;
+
+	desc.volume = 1.0f;
+	desc.pitch = 1.0f;
+	desc.priority = 0;
+	desc.spatial = false;
+	desc.position[0] = 0.0f;
+	desc.position[1] = 0.0f;
+	desc.position[2] = 0.0f;
+
+	//A clip at the output rate with nothing applied comes out exactly, followed by silence
+	frameCount = sampleRate / 2;
+	MakeTone(tone, 441.0f, sampleRate, frameCount, false);
+	result = RenderVoice(sampleRate, tone, desc, forward, right, frameCount + 1000, mix);
+	if (!result)
+	{
+		return false;
+	}
+	for (i = 0; i < frameCount + 1000; i++)
+	{
+		if (mix[i * 2] != (i < frameCount ? tone.GetSamples()[i] : 0.0f) || mix[i * 2] != mix[i * 2 + 1])
+		{
+			cout << "FAILED: an unchanged voice differs from its clip at frame " << i << endl;
+			return false;
+		}
+	}
+	SaveMix(outputDirectory, "identity.wav", mix, sampleRate);
+	cout << "Identity: an unchanged voice is copied exactly" << endl;
+
+	//A tone at half the output rate keeps its pitch, and twice the pitch doubles it, half a second of 441 Hz is 220 cycles
+	MakeTone(slowTone, 441.0f, sampleRate / 2, sampleRate / 2, false);
+	result = RenderVoice(sampleRate, slowTone, desc, forward, right, sampleRate / 2, mix);
+	if (!result)
+	{
+		return false;
+	}
+	crossings = CountCrossings(mix, 0, 0, sampleRate / 2);
+	SaveMix(outputDirectory, "resample.wav", mix, sampleRate);
+
+	desc.pitch = 2.0f;
+	RenderVoice(sampleRate, slowTone, desc, forward, right, sampleRate / 4, mix);
+	desc.pitch = 1.0f;
+	if (abs(crossings - 220) > 1 || abs(CountCrossings(mix, 0, 0, sampleRate / 4) - 220) > 1)
+	{
+		cout << "FAILED: a resampled tone changed pitch" << endl;
+		return false;
+	}
+	cout << "Resample: a 441 Hz tone at half the rate keeps its pitch, at double pitch it plays twice as fast" << endl;
+
+	//A loop of ten whole cycles joins without a jump bigger than the tone itself makes
+	MakeTone(loopTone, (float)(sampleRate / 2) / 50.0f, sampleRate / 2, 500, true);
+	result = RenderVoice(sampleRate, loopTone, desc, forward, right, sampleRate, mix);
+	if (!result)
+	{
+		return false;
+	}
+	jump = 0.0f;
+	for (i = 1; i < sampleRate; i++)
+	{
+		jump = fabs(mix[i * 2] - mix[i * 2 - 2]) > jump ? fabs(mix[i * 2] - mix[i * 2 - 2]) : jump;
+	}
+	if (jump > 2.0f * 3.14159265f * 0.5f / 100.0f * 1.05f)
+	{
+		cout << "FAILED: the loop clicks, a jump of " << jump << endl;
+		return false;
+	}
+	SaveMix(outputDirectory, "loop.wav", mix, sampleRate);
+	cout << "Loop: a looping tone plays on without clicks" << endl;
+
+	//A sound to the right is louder and earlier in the right ear, turning around swaps the ears
+	desc.spatial = true;
+	desc.position[0] = 1.0f;
+	RenderVoice(sampleRate, tone, desc, forward, right, frameCount, mix);
+	level[0] = GetLevel(mix, 0, 0, frameCount);
+	level[1] = GetLevel(mix, 1, 0, frameCount);
+	SaveMix(outputDirectory, "right.wav", mix, sampleRate);
+
+	RenderVoice(sampleRate, tone, desc, backward, left, frameCount, mix);
+	level[2] = GetLevel(mix, 0, 0, frameCount);
+	level[3] = GetLevel(mix, 1, 0, frameCount);
+	SaveMix(outputDirectory, "turned.wav", mix, sampleRate);
+
+	if (level[1] < level[0] * 4.0f || level[2] < level[3] * 4.0f)
+	{
+		cout << "FAILED: panning put the sound in the wrong ear, " << level[0] << " " << level[1] << " then " << level[2] << " " << level[3] << endl;
+		return false;
+	}
+	cout << "Panning: a sound to the right is " << setprecision(1) << fixed << 20.0f * log10(level[1] / level[0]) << " dB louder in the right ear, turning around swaps the ears" << endl;
+
+	//Ten times the distance is about a tenth of the level, past the maximum distance it is silent
+	desc.position[0] = 0.0f;
+	desc.position[2] = 2.0f;
+	RenderVoice(sampleRate, tone, desc, forward, right, frameCount, mix);
+	level[0] = GetLevel(mix, 0, 0, frameCount);
+	desc.position[2] = 20.0f;
+	RenderVoice(sampleRate, tone, desc, forward, right, frameCount, mix);
+	level[1] = GetLevel(mix, 0, 0, frameCount);
+	desc.position[2] = SOUND_MIXER_MAX_DISTANCE + 1.0f;
+	RenderVoice(sampleRate, tone, desc, forward, right, frameCount, mix);
+	level[2] = GetLevel(mix, 0, 0, frameCount);
+	if (fabs(level[1] / level[0] - 0.1f) > 0.01f || level[2] != 0.0f)
+	{
+		cout << "FAILED: distance attenuation is off, " << level[0] << " " << level[1] << " " << level[2] << endl;
+		return false;
+	}
+	cout << "Distance: level falls off with distance and is silent past " << SOUND_MIXER_MAX_DISTANCE << endl;
+
+	//Let the mixer thread play into a realtime null sink while the game thread keeps starting and moving voices
+	result = CheckThreadedMixer(sampleRate, tone);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Limit the voices that are mixed and fill the pool to see what gets virtual and what gets stolen
+	result = CheckVoiceManager(sampleRate, outputDirectory);
+	if (!result)
+	{
+		return false;
+	}
+
+	tone.Shutdown();
+	slowTone.Shutdown();
+	loopTone.Shutdown();
+
+	return true;
+}
+
+bool RenderVoice(unsigned int sampleRate, SoundClip& clip, const SoundMixer::VoiceDescType& desc, const float* forward, const float* right, unsigned int frameCount, vector<float>& mix)
+{
+	static const float origin[3] = { 0.0f, 0.0f, 0.0f };
+	SoundMixer mixer;
+	int voice;
+	bool result;
+
+	//Render one voice from the start with a mixer of its own
+	result = mixer.Initialize(nullptr, sampleRate, 0, false);
+	if (!result)
+	{
+		cout << "FAILED: could not create the mixer" << endl;
+		return false;
+	}
+
+	mixer.SetListener(origin, forward, right);
+	voice = mixer.PlayVoice(&clip, desc);
+	if (voice < 0)
+	{
+		cout << "FAILED: could not play the voice" << endl;
+		return false;
+	}
+
+	mix.assign((size_t)frameCount * 2, 0.0f);
+	mixer.Mix(&mix[0], frameCount);
+	mixer.Shutdown();
+
+	return true;
+}
+
+bool CheckThreadedMixer(unsigned int sampleRate, SoundClip& clip)
+{
+	NullSoundSink sink;
+	SoundMixer mixer;
+	SoundMixer::VoiceDescType desc;
+	vector<int> voices;
+	bool result;
+	int voice;
+	int startCount;
+	int frame;
+	size_t i;
+	float angle;
+
+	result = sink.Initialize(sampleRate * 4, 4, SoundMixer::GetBufferSize(sampleRate, SOUND_MIXER_SEGMENT_MILLISECONDS, SOUND_MIXER_SEGMENT_COUNT), true, false);
+	if (!result)
+	{
+		cout << "FAILED: could not create the sink" << endl;
+		return false;
+	}
+
+	result = mixer.Initialize(&sink, sampleRate, SOUND_MIXER_SEGMENT_COUNT, true);
+	if (!result)
+	{
+		cout << "FAILED: could not start the mixer" << endl;
+		return false;
+	}
+
+	//Run sixty game frames a second for a second, a new voice every frame and every voice moving
+	desc.volume = 0.1f;
+	desc.pitch = 1.0f;
+	desc.priority = 0;
+	desc.spatial = true;
+	startCount = 0;
+	for (frame = 0; frame < 60; frame++)
+	{
+		angle = (float)frame * 0.2f;
+		desc.position[0] = sinf(angle) * 5.0f;
+		desc.position[1] = 0.0f;
+		desc.position[2] = cosf(angle) * 5.0f;
+		voice = mixer.PlayVoice(&clip, desc);
+		if (voice >= 0)
+		{
+			voices.push_back(voice);
+			startCount++;
+		}
+
+		for (i = 0; i < voices.size(); i++)
+		{
+			if (mixer.IsVoicePlaying(voices[i]))
+			{
+				mixer.SetVoicePosition(voices[i], desc.position[2], 0.0f, desc.position[0]);
+			}
+		}
+
+		mixer.Update();
+		this_thread::sleep_for(chrono::milliseconds(16));
+	}
+
+	//Wait for every voice to play out and be handed back
+	for (frame = 0; frame < 100 && mixer.GetVoiceCount() > 0; frame++)
+	{
+		this_thread::sleep_for(chrono::milliseconds(16));
+		mixer.Update();
+	}
+
+	mixer.Shutdown();
+	sink.Shutdown();
+
+	if (startCount != 60 || mixer.GetVoiceCount() != 0 || mixer.GetUnderrunCount() != 0)
+	{
+		cout << "FAILED: the mixer thread started " << startCount << " voices, " << mixer.GetVoiceCount() << " never finished, " << mixer.GetUnderrunCount() << " underruns" << endl;
+		return false;
+	}
+	cout << "Threaded: 60 voices started and moved from the game thread while the mixer thread played, no underruns" << endl;
+
+	return true;
+}
+
+bool CheckVoiceManager(unsigned int sampleRate, const char* outputDirectory)
+{
+	static const float origin[3] = { 0.0f, 0.0f, 0.0f };
+	static const float forward[3] = { 0.0f, 0.0f, 1.0f };
+	static const float right[3] = { 1.0f, 0.0f, 0.0f };
+	bool result;
+	SoundClip tone;
+	SoundClip highTone;
+	SoundMixer mixer;
+	SoundMixer::VoiceDescType desc;
+	vector<float> mix;
+	vector<float> expected;
+	vector<int> voices;
+	unsigned int frameCount;
+	unsigned int skipFrames;
+	int voice;
+	int i;
+
+	MakeTone(tone, 441.0f, sampleRate, sampleRate / 10, true);
+	MakeTone(highTone, 882.0f, sampleRate, sampleRate / 10, true);
+	frameCount = sampleRate / 2;
+	skipFrames = SOUND_MIXER_BLOCK_FRAMES * 40;
+
+	desc.volume = 1.0f;
+	desc.pitch = 1.1f;
+	desc.priority = 0;
+	desc.spatial = true;
+	desc.position[0] = 0.0f;
+	desc.position[1] = 0.0f;
+	desc.position[2] = 2.0f;
+
+	//A voice that starts out of range is virtual, once it comes in range it has to be where it would have been had it been heard all along
+	result = RenderVoice(sampleRate, tone, desc, forward, right, frameCount, expected);
+	if (!result)
+	{
+		return false;
+	}
+
+	result = mixer.Initialize(nullptr, sampleRate, 0, false);
+	if (!result)
+	{
+		cout << "FAILED: could not create the mixer" << endl;
+		return false;
+	}
+	mixer.SetListener(origin, forward, right);
+
+	desc.position[2] = SOUND_MIXER_MAX_DISTANCE * 2.0f;
+	voice = mixer.PlayVoice(&tone, desc);
+	mix.assign((size_t)frameCount * 2, 0.0f);
+	mixer.Mix(&mix[0], skipFrames);
+	if (mixer.GetActiveVoiceCount() != 1 || mixer.GetRealVoiceCount() != 0)
+	{
+		cout << "FAILED: a voice out of range was mixed" << endl;
+		return false;
+	}
+
+	mixer.SetVoicePosition(voice, 0.0f, 0.0f, 2.0f);
+	mixer.Mix(&mix[(size_t)skipFrames * 2], frameCount - skipFrames);
+	mixer.Shutdown();
+
+	//The first block back fades in, after that it is the same as the voice that was always heard
+	if (GetLevel(mix, 0, 0, skipFrames) != 0.0f || !CompareMix(mix, expected, skipFrames + SOUND_MIXER_BLOCK_FRAMES, frameCount - skipFrames - SOUND_MIXER_BLOCK_FRAMES))
+	{
+		cout << "FAILED: a virtual voice lost its place in the clip" << endl;
+		return false;
+	}
+	SaveMix(outputDirectory, "virtual.wav", mix, sampleRate);
+	cout << "Virtual: a voice out of range keeps its place in the clip and fades back in where it would have been" << endl;
+
+	//With room for one real voice a quiet voice of higher priority wins over a loud one, and among equals the nearer one wins
+	desc.position[2] = 2.0f;
+	desc.volume = 0.1f;
+	desc.priority = 1;
+	RenderVoice(sampleRate, tone, desc, forward, right, frameCount, expected);
+
+	mixer.Initialize(nullptr, sampleRate, 0, false);
+	mixer.SetListener(origin, forward, right);
+	mixer.SetRealVoiceLimit(1);
+	mixer.PlayVoice(&tone, desc);
+	desc.volume = 1.0f;
+	desc.priority = 0;
+	mixer.PlayVoice(&highTone, desc);
+	mix.assign((size_t)frameCount * 2, 0.0f);
+	mixer.Mix(&mix[0], frameCount);
+	mixer.Shutdown();
+	if (!CompareMix(mix, expected, 0, frameCount))
+	{
+		cout << "FAILED: the voice of lower priority was mixed" << endl;
+		return false;
+	}
+
+	desc.volume = 1.0f;
+	desc.priority = 0;
+	RenderVoice(sampleRate, tone, desc, forward, right, frameCount, expected);
+
+	mixer.Initialize(nullptr, sampleRate, 0, false);
+	mixer.SetListener(origin, forward, right);
+	mixer.SetRealVoiceLimit(1);
+	desc.position[2] = 20.0f;
+	mixer.PlayVoice(&highTone, desc);
+	desc.position[2] = 2.0f;
+	mixer.PlayVoice(&tone, desc);
+	mix.assign((size_t)frameCount * 2, 0.0f);
+	mixer.Mix(&mix[0], frameCount);
+	if (!CompareMix(mix, expected, 0, frameCount) || mixer.GetRealVoiceCount() != 1 || mixer.GetActiveVoiceCount() != 2)
+	{
+		cout << "FAILED: the further voice was mixed" << endl;
+		return false;
+	}
+	mixer.Shutdown();
+	cout << "Priority: with one real voice the higher priority wins, then the nearer voice" << endl;
+
+	//Fill every voice, all sharing the one clip, the furthest voice of the lowest priority makes room for a new one
+	mixer.Initialize(nullptr, sampleRate, 0, false);
+	mixer.SetListener(origin, forward, right);
+	for (i = 0; i < SOUND_MIXER_MAX_VOICES; i++)
+	{
+		desc.priority = i % 2;
+		desc.position[2] = 1.0f + (float)(i % 101);
+		voices.push_back(mixer.PlayVoice(&tone, desc));
+	}
+	mixer.Mix(&mix[0], SOUND_MIXER_BLOCK_FRAMES);
+
+	desc.priority = -1;
+	if (mixer.PlayVoice(&tone, desc) >= 0)
+	{
+		cout << "FAILED: a voice of lower priority than every playing voice stole one" << endl;
+		return false;
+	}
+
+	desc.priority = 0;
+	voice = mixer.PlayVoice(&tone, desc);
+	for (i = 0; i < SOUND_MIXER_MAX_VOICES; i++)
+	{
+		if (mixer.IsVoicePlaying(voices[i]) != (i != 100))
+		{
+			cout << "FAILED: voice " << i << " was " << (mixer.IsVoicePlaying(voices[i]) ? "kept" : "stolen") << endl;
+			return false;
+		}
+	}
+
+	//The stolen voice must not be handed back twice, and stopping everything gives every voice back
+	mixer.Mix(&mix[0], SOUND_MIXER_BLOCK_FRAMES);
+	mixer.Update();
+	if (voice < 0 || !mixer.IsVoicePlaying(voice) || mixer.GetVoiceCount() != SOUND_MIXER_MAX_VOICES || mixer.GetRealVoiceCount() != SOUND_MIXER_REAL_VOICES)
+	{
+		cout << "FAILED: stealing lost track of the voices, " << mixer.GetVoiceCount() << " playing" << endl;
+		return false;
+	}
+
+	for (i = 0; i < SOUND_MIXER_MAX_VOICES; i++)
+	{
+		mixer.StopVoice(voices[i]);
+	}
+	mixer.StopVoice(voice);
+	mixer.Mix(&mix[0], SOUND_MIXER_BLOCK_FRAMES);
+	mixer.Update();
+	if (mixer.GetVoiceCount() != 0)
+	{
+		cout << "FAILED: " << mixer.GetVoiceCount() << " voices were never handed back" << endl;
+		return false;
+	}
+	mixer.Shutdown();
+	cout << "Stealing: " << SOUND_MIXER_MAX_VOICES << " voices share one clip of " << tone.GetMemorySize() << " bytes, the furthest of the lowest priority is stolen and handed back once" << endl;
+
+	tone.Shutdown();
+	highTone.Shutdown();
+
+	return true;
+}
+
+bool CompareMix(const vector<float>& mix, const vector<float>& expected, size_t firstFrame, size_t frameCount)
+{
+	size_t i;
+
+	for (i = firstFrame * 2; i < (firstFrame + frameCount) * 2; i++)
+	{
+		if (fabs(mix[i] - expected[i]) > 0.0001f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void MakeTone(SoundClip& clip, float frequency, unsigned int sampleRate, unsigned int frameCount, bool loop)
+{
+	vector<float> samples;
+	unsigned int i;
+
+	samples.resize(frameCount);
+	for (i = 0; i < frameCount; i++)
+	{
+		samples[i] = 0.5f * sinf(2.0f * 3.14159265f * frequency * (float)i / (float)sampleRate);
+	}
+
+	clip.Initialize(&samples[0], frameCount, 1, sampleRate, loop);
+}
+
+float GetLevel(const vector<float>& mix, int channel, size_t firstFrame, size_t frameCount)
+{
+	double sum;
+	size_t i;
+
+	//Root mean square of one channel
+	sum = 0.0;
+	for (i = firstFrame; i < firstFrame + frameCount; i++)
+	{
+		sum += (double)mix[i * 2 + channel] * mix[i * 2 + channel];
+	}
+
+	return (float)sqrt(sum / (double)frameCount);
+}
+
+int CountCrossings(const vector<float>& mix, int channel, size_t firstFrame, size_t frameCount)
+{
+	size_t i;
+	int count;
+
+	//Count the times the signal goes from below zero to zero or above, once per cycle
+	count = 0;
+	for (i = firstFrame + 1; i < firstFrame + frameCount; i++)
+	{
+		if (mix[(i - 1) * 2 + channel] < 0.0f && mix[i * 2 + channel] >= 0.0f)
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+bool SaveMix(const char* outputDirectory, const char* name, const vector<float>& mix, unsigned int sampleRate)
+{
+	vector<unsigned char> format;
+	vector<unsigned char> data;
+	vector<unsigned char> wave;
+	size_t i;
+	float value;
+	string fileName;
+
+	if (!outputDirectory)
+	{
+		return true;
+	}
+
+	//Write the mix as a 16 bit stereo wave file
+	AppendUShort(format, WAVE_FORMAT_TAG_PCM);
+	AppendUShort(format, 2);
+	AppendUInt(format, sampleRate);
+	AppendUInt(format, sampleRate * 4);
+	AppendUShort(format, 4);
+	AppendUShort(format, 16);
+
+	for (i = 0; i < mix.size(); i++)
+	{
+		value = mix[i] * 32767.0f;
+		value = value > 32767.0f ? 32767.0f : (value < -32768.0f ? -32768.0f : value);
+		AppendUShort(data, (unsigned short)(short)value);
+	}
+
+	wave.insert(wave.end(), (const unsigned char*)"RIFF", (const unsigned char*)"RIFF" + 4);
+	AppendUInt(wave, (unsigned int)(4 + 8 + format.size() + 8 + data.size() + (data.size() & 1)));
+	wave.insert(wave.end(), (const unsigned char*)"WAVE", (const unsigned char*)"WAVE" + 4);
+	AppendChunk(wave, "fmt ", format);
+	AppendChunk(wave, "data", data);
+
+	fileName = string(outputDirectory) + "/" + name;
+	ofstream output(fileName.c_str(), ios::binary);
+	if (!output.write((const char*)&wave[0], wave.size()))
+	{
+		cout << "Could not write " << fileName << endl;
+		return false;
+	}
+
+	return true;
+}
+
+int DecodeBench(int argc, char* argv[])
+{
+	bool result;
+	WaveFile file;
+	WaveFile source;
+	vector<thread> threads;
+	vector<long long> counts;
+	vector<short> decoded;
+	vector<short> original;
+	double seconds;
+	int threadCount;
+	int firstArgument;
+	int i;
+	size_t j;
+	long long frameCount;
+	double singleRate;
+	double threadedRate;
+	double signal;
+	double noise;
+	double difference;
+
+	seconds = 1.0;
+	threadCount = 0;
+	firstArgument = 0;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-seconds") == 0)
+		{
+			seconds = atof(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-threads") == 0)
+		{
+			threadCount = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (argc - firstArgument < 1 || argc - firstArgument > 2)
+	{
+		cout << "Expected a wave file and optionally its source" << endl;
+		return -1;
+	}
+	if (threadCount <= 0)
+	{
+		threadCount = (int)thread::hardware_concurrency();
+		threadCount = threadCount < 1 ? 1 : threadCount;
+	}
+
+	result = file.Initialize(argv[firstArgument]);
+	if (!result)
+	{
+		cout << "Could not load " << argv[firstArgument] << endl;
+		return -1;
+	}
+	if (file.GetFrameCount() == 0)
+	{
+		cout << argv[firstArgument] << " has no samples" << endl;
+		return -1;
+	}
+
+	cout << argv[firstArgument] << ": " << file.GetChannels() << " channels, " << file.GetSampleRate() << " Hz, " << file.GetBitsPerSample() << " bit";
+	if (file.IsCompressed())
+	{
+		cout << " ADPCM in blocks of " << file.GetFramesPerBlock() << " frames";
+	}
+	cout << endl;
+	cout << "Size: " << file.GetSampleSize() << " bytes for " << file.GetFrameCount() * file.GetChannels() * 2 << " bytes of 16 bit samples (";
+	cout << fixed << setprecision(2) << (double)file.GetFrameCount() * file.GetChannels() * 2 / file.GetSampleSize() << "x)" << endl;
+
+	//One decoder is what a single stream costs, several at once show whether decoding scales over the cores
+	DecodeWorker(&file, seconds, &frameCount);
+	singleRate = frameCount / seconds;
+
+	counts.resize(threadCount);
+	for (i = 0; i < threadCount; i++)
+	{
+		threads.push_back(thread(DecodeWorker, &file, seconds, &counts[i]));
+	}
+	frameCount = 0;
+	for (i = 0; i < threadCount; i++)
+	{
+		threads[i].join();
+		frameCount += counts[i];
+	}
+	threadedRate = frameCount / seconds;
+
+	cout << "1 thread: " << setprecision(1) << singleRate * file.GetChannels() * 2 / (1024.0 * 1024.0) << " MB/s of 16 bit samples, " << setprecision(0) << singleRate / file.GetSampleRate() << "x realtime, ";
+	cout << setprecision(3) << 100.0 * file.GetSampleRate() / singleRate << "% of a core per stream" << endl;
+	cout << threadCount << " threads: " << setprecision(1) << threadedRate * file.GetChannels() * 2 / (1024.0 * 1024.0) << " MB/s, " << setprecision(0) << threadedRate / file.GetSampleRate() << "x realtime, ";
+	cout << setprecision(2) << threadedRate / singleRate << "x one thread" << endl;
+
+	//Compare against the file it was made from
+	if (argc - firstArgument == 2)
+	{
+		result = source.Initialize(argv[firstArgument + 1]);
+		if (!result || source.GetChannels() != file.GetChannels() || source.GetFrameCount() != file.GetFrameCount())
+		{
+			cout << "FAILED: " << argv[firstArgument + 1] << " is not the same length and layout" << endl;
+			return -1;
+		}
+
+		decoded.resize(file.GetFrameCount() * file.GetChannels());
+		original.resize(decoded.size());
+		file.ReadSamples(0, file.GetFrameCount(), &decoded[0]);
+		source.ReadSamples(0, source.GetFrameCount(), &original[0]);
+
+		signal = 0.0;
+		noise = 0.0;
+		for (j = 0; j < decoded.size(); j++)
+		{
+			difference = (double)original[j] - (double)decoded[j];
+			signal += (double)original[j] * (double)original[j];
+			noise += difference * difference;
+		}
+		cout << "SNR: " << setprecision(2) << (noise > 0.0 ? 10.0 * log10((signal + 1.0) / noise) : 99.99) << " dB against " << argv[firstArgument + 1] << endl;
+
+		source.Shutdown();
+	}
+
+	file.Shutdown();
+
+	return 0;
+}
+
+void DecodeWorker(WaveFile* file, double seconds, long long* frameCount)
+{
+	vector<short> block;
+	size_t blockFrames;
+	size_t position;
+	int i;
+
+	//Decode whole blocks in order like the stream does, going round the file until the time is up
+	blockFrames = file->IsCompressed() ? file->GetFramesPerBlock() : WAVE_DECODE_FRAMES;
+	block.resize(blockFrames * file->GetChannels());
+
+	chrono::high_resolution_clock::time_point endTime = chrono::high_resolution_clock::now() + chrono::microseconds((long long)(seconds * 1000000.0));
+
+	*frameCount = 0;
+	position = 0;
+	while (chrono::high_resolution_clock::now() < endTime)
+	{
+		for (i = 0; i < 16; i++)
+		{
+			*frameCount += file->ReadSamples(position, blockFrames, &block[0]);
+			position += blockFrames;
+			if (position >= file->GetFrameCount())
+			{
+				position = 0;
+			}
+		}
+	}
+}
\ No newline at end of file
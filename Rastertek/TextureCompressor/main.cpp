@@ -0,0 +1,1341 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <cfloat>
+#include <emmintrin.h>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "../Engine/DdsFile.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const int FORMAT_AUTO = 0;
+const int FORMAT_BC1 = 1;
+const int FORMAT_BC3 = 2;
+const int FORMAT_BC4 = 3;
+const int FORMAT_BC5 = 4;
+const int FORMAT_BC7 = 5;
+
+const int QUALITY_FAST = 0;
+const int QUALITY_HIGH = 1;
+
+const int REFINE_ITERATIONS = 2;
+const int GRAY_TOLERANCE = 2;
+const float NORMAL_TOLERANCE = 0.1f;
+const float NORMAL_FRACTION = 0.95f;
+
+//The BC7 interpolation weights for 4 bit indices, out of 64
+const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+//////////////
+// TYPEDEFS //
+//////////////
+
+//The header written out in front of the compressed levels, sources are read with DdsFile
+struct DdsHeaderType
+{
+	unsigned int magic;
+	unsigned int size;
+	unsigned int flags;
+	unsigned int height;
+	unsigned int width;
+	unsigned int pitchOrLinearSize;
+	unsigned int depth;
+	unsigned int mipMapCount;
+	unsigned int reserved1[11];
+	unsigned int pixelFormatSize;
+	unsigned int pixelFormatFlags;
+	unsigned int fourCC;
+	unsigned int rgbBitCount;
+	unsigned int redBitMask;
+	unsigned int greenBitMask;
+	unsigned int blueBitMask;
+	unsigned int alphaBitMask;
+	unsigned int caps;
+	unsigned int caps2;
+	unsigned int caps3;
+	unsigned int caps4;
+	unsigned int reserved2;
+};
+
+struct DdsHeaderDx10Type
+{
+	unsigned int dxgiFormat;
+	unsigned int resourceDimension;
+	unsigned int miscFlag;
+	unsigned int arraySize;
+	unsigned int miscFlags2;
+};
+
+//Every mip level is held as R, G, B, A bytes whatever channel order it was stored in
+struct LevelType
+{
+	int width;
+	int height;
+	vector<unsigned char> texels;
+};
+
+//The 16 texels of a 4x4 block split into one array per channel so four texels can be handled at once
+struct BlockType
+{
+	float channels[4][16];
+};
+
+struct CompressTaskType
+{
+	const vector<LevelType>* levels;
+	vector<vector<unsigned char> >* outputs;
+	int format;
+	atomic<int>* nextRow;
+	vector<int>* rowLevels;
+	vector<int>* rowStarts;
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+bool LoadSourceImage(char* filename, vector<LevelType>& levels);
+bool SaveCompressed(char* filename, const vector<LevelType>& levels, const vector<vector<unsigned char> >& outputs, int format);
+int ChooseFormat(const vector<LevelType>& levels, int quality);
+int GetBlockBytes(int format);
+const char* GetFormatName(int format);
+void CompressWorker(CompressTaskType* task);
+void ReadBlock(const LevelType& level, int blockX, int blockY, unsigned char* texels);
+void CompressBlock(const unsigned char* texels, int format, unsigned char* output);
+void DecompressBlock(const unsigned char* input, int format, unsigned char* texels);
+float FindIndices(const BlockType& block, int channelCount, const float palette[][4], int paletteSize, unsigned char* indices);
+void FindPrincipalAxis(const BlockType& block, int channelCount, float* mean, float* axis);
+void SolveEndpoints(const BlockType& block, int channelCount, const unsigned char* indices, const float* weights, float* endpoint0, float* endpoint1);
+void CompressColorBlock(const unsigned char* texels, unsigned char* output);
+void CompressSingleChannelBlock(const unsigned char* texels, int channel, unsigned char* output);
+void CompressBc7Block(const unsigned char* texels, unsigned char* output);
+void DecompressColorBlock(const unsigned char* input, bool alwaysFourColors, unsigned char* texels);
+void DecompressSingleChannelBlock(const unsigned char* input, int channel, unsigned char* texels);
+void DecompressBc7Block(const unsigned char* input, unsigned char* texels);
+void BuildColorPalette(unsigned short color0, unsigned short color1, bool alwaysFourColors, unsigned char palette[4][4]);
+void BuildSingleChannelPalette(int endpoint0, int endpoint1, int* palette);
+unsigned short PackColor(const float* color);
+void UnpackColor(unsigned short color, unsigned char* rgb);
+void WriteBits(unsigned char* output, int& position, unsigned int value, int count);
+unsigned int ReadBits(const unsigned char* input, int& position, int count);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	bool result;
+	vector<LevelType> levels;
+	vector<vector<unsigned char> > outputs;
+	vector<int> rowLevels;
+	vector<int> rowStarts;
+	vector<thread> threads;
+	atomic<int> nextRow;
+	CompressTaskType task;
+	unsigned char source[64];
+	unsigned char decoded[64];
+	int format;
+	int quality;
+	int threadCount;
+	int firstArgument;
+	int channelCount;
+	int blocksWide;
+	int blocksHigh;
+	double squaredError;
+	double samples;
+	double difference;
+	double psnr;
+	double milliseconds;
+	long long sourceBytes;
+	long long compressedBytes;
+
+	//Usage: TextureCompressor [-format auto|bc1|bc3|bc4|bc5|bc7] [-quality fast|high] <input.dds> <output.dds>
+	if (argc < 3)
+	{
+		cout << "Usage: TextureCompressor [-format auto|bc1|bc3|bc4|bc5|bc7] [-quality fast|high] <input.dds> <output.dds>" << endl;
+		cout << "  -format   auto picks BC5 for normal maps, BC4 for gray maps, BC3 or BC7 for alpha and BC1 or BC7 for color (default auto)" << endl;
+		cout << "  -quality  high uses BC7 in place of BC1 and BC3 (default fast)" << endl;
+		return -1;
+	}
+
+	format = FORMAT_AUTO;
+	quality = QUALITY_FAST;
+	firstArgument = 1;
+	while (firstArgument + 2 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-format") == 0)
+		{
+			const char* names[6] = { "auto", "bc1", "bc3", "bc4", "bc5", "bc7" };
+			format = -1;
+			for (int i = 0; i < 6; i++)
+			{
+				if (strcmp(argv[firstArgument + 1], names[i]) == 0)
+				{
+					format = i;
+				}
+			}
+		}
+		else if (strcmp(argv[firstArgument], "-quality") == 0)
+		{
+			quality = (strcmp(argv[firstArgument + 1], "high") == 0) ? QUALITY_HIGH : QUALITY_FAST;
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (format < 0 || firstArgument + 2 != argc)
+	{
+		cout << "Invalid format or missing file names" << endl;
+		return -1;
+	}
+
+	//Read in every mip level of the image
+	result = LoadSourceImage(argv[firstArgument], levels);
+	if (!result)
+	{
+		cout << "Could not load " << argv[firstArgument] << ", only uncompressed 32 bit 2D DDS files are supported" << endl;
+		return -1;
+	}
+
+	//Look at the contents to pick the format when it was not given
+	if (format == FORMAT_AUTO)
+	{
+		format = ChooseFormat(levels, quality);
+	}
+
+	//Every row of blocks in every level is a separate task so the levels share the threads
+	outputs.resize(levels.size());
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		blocksWide = (levels[i].width + 3) / 4;
+		blocksHigh = (levels[i].height + 3) / 4;
+		outputs[i].resize((size_t)blocksWide * blocksHigh * GetBlockBytes(format));
+		for (int y = 0; y < blocksHigh; y++)
+		{
+			rowLevels.push_back((int)i);
+			rowStarts.push_back(y);
+		}
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	threadCount = (int)thread::hardware_concurrency();
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+
+	nextRow = 0;
+	task.levels = &levels;
+	task.outputs = &outputs;
+	task.format = format;
+	task.nextRow = &nextRow;
+	task.rowLevels = &rowLevels;
+	task.rowStarts = &rowStarts;
+	for (int i = 0; i < threadCount; i++)
+	{
+		threads.push_back(thread(CompressWorker, &task));
+	}
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		threads[i].join();
+	}
+
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+	milliseconds = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+	//Decode the blocks again and measure the error over the channels the format keeps
+	channelCount = (format == FORMAT_BC4) ? 1 : (format == FORMAT_BC5) ? 2 : (format == FORMAT_BC1) ? 3 : 4;
+	squaredError = 0.0;
+	samples = 0.0;
+	sourceBytes = 0;
+	compressedBytes = 0;
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		blocksWide = (levels[i].width + 3) / 4;
+		blocksHigh = (levels[i].height + 3) / 4;
+		for (int y = 0; y < blocksHigh; y++)
+		{
+			for (int x = 0; x < blocksWide; x++)
+			{
+				ReadBlock(levels[i], x, y, source);
+				DecompressBlock(&outputs[i][((size_t)y * blocksWide + x) * GetBlockBytes(format)], format, decoded);
+				for (int t = 0; t < 16; t++)
+				{
+					//Texels past the edge of the image are padding and do not count
+					if ((x * 4) + (t % 4) >= levels[i].width || (y * 4) + (t / 4) >= levels[i].height)
+					{
+						continue;
+					}
+					for (int c = 0; c < channelCount; c++)
+					{
+						difference = (double)source[(t * 4) + c] - (double)decoded[(t * 4) + c];
+						squaredError += difference * difference;
+						samples += 1.0;
+					}
+				}
+			}
+		}
+		sourceBytes += (long long)levels[i].texels.size();
+		compressedBytes += (long long)outputs[i].size();
+	}
+	psnr = (squaredError > 0.0) ? 10.0 * log10((255.0 * 255.0) / (squaredError / samples)) : 99.99;
+
+	//Display the compression results to the screen for information purpose
+	cout << "Image: " << argv[firstArgument] << " " << levels[0].width << "x" << levels[0].height << ", " << levels.size() << " mip levels" << endl;
+	cout << "Format: " << GetFormatName(format) << endl;
+	cout << "PSNR: " << fixed << setprecision(2) << psnr << " dB" << endl;
+	cout << "Size: " << sourceBytes << " -> " << compressedBytes << " bytes (" << setprecision(1) << (double)sourceBytes / (double)compressedBytes << "x)" << endl;
+	cout << "Time: " << setprecision(3) << milliseconds << " ms on " << threadCount << " threads, ";
+	cout << setprecision(1) << ((double)sourceBytes / (1024.0 * 1024.0)) / (milliseconds / 1000.0) << " MB/s" << endl;
+
+	//Write out the compressed texture
+	result = SaveCompressed(argv[firstArgument + 1], levels, outputs, format);
+	if (!result)
+	{
+		cout << "Could not write " << argv[firstArgument + 1] << endl;
+		return -1;
+	}
+
+	return 0;
+}
+
+bool LoadSourceImage(char* filename, vector<LevelType>& levels)
+{
+	DdsFile file;
+	const void* data;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+	bool result;
+
+	//Map the file in, the header sizes are checked against the file there
+	result = file.Initialize(filename);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Only single uncompressed 32 bit textures are supported, not arrays or cube maps
+	if (file.GetArraySize() != 1)
+	{
+		file.Shutdown();
+		return false;
+	}
+
+	//Read every mip level stored in the file
+	for (unsigned int mip = 0; mip < file.GetMipCount(); mip++)
+	{
+		LevelType level;
+
+		file.GetSurface(0, mip, data, rowPitch, slicePitch, width, height);
+		level.width = (int)width;
+		level.height = (int)height;
+		level.texels.resize((size_t)width * height * 4);
+
+		result = file.GetSurfaceRgba(0, mip, &level.texels[0]);
+		if (!result)
+		{
+			file.Shutdown();
+			return false;
+		}
+		levels.push_back(level);
+	}
+
+	//Release the file
+	file.Shutdown();
+
+	return true;
+}
+
+bool SaveCompressed(char* filename, const vector<LevelType>& levels, const vector<vector<unsigned char> >& outputs, int format)
+{
+	ofstream fOut;
+	DdsHeaderType header;
+	DdsHeaderDx10Type headerDx10;
+
+	//The legacy four character codes cover everything but BC7, which needs the DX10 header
+	memset(&header, 0, sizeof(DdsHeaderType));
+	header.magic = 0x20534444;
+	header.size = 124;
+	header.flags = 0x81007;
+	header.height = levels[0].height;
+	header.width = levels[0].width;
+	header.pitchOrLinearSize = (unsigned int)outputs[0].size();
+	header.pixelFormatSize = 32;
+	header.pixelFormatFlags = 0x4;
+	header.caps = 0x1000;
+	if (levels.size() > 1)
+	{
+		header.flags |= 0x20000;
+		header.mipMapCount = (unsigned int)levels.size();
+		header.caps |= 0x400008;
+	}
+
+	switch (format)
+	{
+	case FORMAT_BC1:
+		header.fourCC = 0x31545844;
+		break;
+	case FORMAT_BC3:
+		header.fourCC = 0x35545844;
+		break;
+	case FORMAT_BC4:
+		header.fourCC = 0x31495441;
+		break;
+	case FORMAT_BC5:
+		header.fourCC = 0x32495441;
+		break;
+	default:
+		header.fourCC = 0x30315844;
+		break;
+	}
+
+	//Open the output file
+	fOut.open(filename, ios::binary);
+	if (fOut.fail())
+	{
+		return false;
+	}
+
+	fOut.write((const char*)&header, sizeof(DdsHeaderType));
+	if (format == FORMAT_BC7)
+	{
+		//DXGI_FORMAT_BC7_UNORM as a single 2D texture
+		memset(&headerDx10, 0, sizeof(DdsHeaderDx10Type));
+		headerDx10.dxgiFormat = 98;
+		headerDx10.resourceDimension = 3;
+		headerDx10.arraySize = 1;
+		fOut.write((const char*)&headerDx10, sizeof(DdsHeaderDx10Type));
+	}
+
+	for (size_t i = 0; i < outputs.size(); i++)
+	{
+		fOut.write((const char*)&outputs[i][0], outputs[i].size());
+	}
+
+	//Close the output file
+	fOut.close();
+
+	return !fOut.fail();
+}
+
+int ChooseFormat(const vector<LevelType>& levels, int quality)
+{
+	const vector<unsigned char>& texels = levels[0].texels;
+	size_t count;
+	size_t unitLength;
+	bool gray;
+	bool opaque;
+	float x;
+	float y;
+	float z;
+	float length;
+
+	count = texels.size() / 4;
+	gray = true;
+	opaque = true;
+	unitLength = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		const unsigned char* texel = &texels[i * 4];
+
+		if (abs((int)texel[0] - (int)texel[1]) > GRAY_TOLERANCE || abs((int)texel[0] - (int)texel[2]) > GRAY_TOLERANCE)
+		{
+			gray = false;
+		}
+		if (texel[3] != 0xFF)
+		{
+			opaque = false;
+		}
+
+		//Normal maps hold unit vectors, so almost every texel expands to a length of one
+		x = ((float)texel[0] / 127.5f) - 1.0f;
+		y = ((float)texel[1] / 127.5f) - 1.0f;
+		z = ((float)texel[2] / 127.5f) - 1.0f;
+		length = sqrtf((x * x) + (y * y) + (z * z));
+		if (fabsf(length - 1.0f) < NORMAL_TOLERANCE && z > 0.0f)
+		{
+			unitLength++;
+		}
+	}
+
+	//Normal maps keep X and Y in two channels and the shader rebuilds Z
+	if ((float)unitLength >= NORMAL_FRACTION * (float)count)
+	{
+		return FORMAT_BC5;
+	}
+
+	//Gray maps such as alpha maps only need one channel
+	if (gray && opaque)
+	{
+		return FORMAT_BC4;
+	}
+
+	if (quality == QUALITY_HIGH)
+	{
+		return FORMAT_BC7;
+	}
+
+	return opaque ? FORMAT_BC1 : FORMAT_BC3;
+}
+
+int GetBlockBytes(int format)
+{
+	return (format == FORMAT_BC1 || format == FORMAT_BC4) ? 8 : 16;
+}
+
+const char* GetFormatName(int format)
+{
+	switch (format)
+	{
+	case FORMAT_BC1:
+		return "BC1";
+	case FORMAT_BC3:
+		return "BC3";
+	case FORMAT_BC4:
+		return "BC4";
+	case FORMAT_BC5:
+		return "BC5";
+	default:
+		return "BC7";
+	}
+}
+
+void CompressWorker(CompressTaskType* task)
+{
+	unsigned char texels[64];
+	int row;
+	int blocksWide;
+	int blockBytes;
+
+	blockBytes = GetBlockBytes(task->format);
+
+	//Take rows of blocks until there are none left
+	row = (*task->nextRow)++;
+	while (row < (int)task->rowLevels->size())
+	{
+		const LevelType& level = (*task->levels)[(*task->rowLevels)[row]];
+		vector<unsigned char>& output = (*task->outputs)[(*task->rowLevels)[row]];
+		int y = (*task->rowStarts)[row];
+
+		blocksWide = (level.width + 3) / 4;
+		for (int x = 0; x < blocksWide; x++)
+		{
+			ReadBlock(level, x, y, texels);
+			CompressBlock(texels, task->format, &output[((size_t)y * blocksWide + x) * blockBytes]);
+		}
+
+		row = (*task->nextRow)++;
+	}
+}
+
+void ReadBlock(const LevelType& level, int blockX, int blockY, unsigned char* texels)
+{
+	int x;
+	int y;
+
+	//Blocks that hang over the edge repeat the last row and column
+	for (int t = 0; t < 16; t++)
+	{
+		x = min((blockX * 4) + (t % 4), level.width - 1);
+		y = min((blockY * 4) + (t / 4), level.height - 1);
+		memcpy(&texels[t * 4], &level.texels[((size_t)y * level.width + x) * 4], 4);
+	}
+}
+
+void CompressBlock(const unsigned char* texels, int format, unsigned char* output)
+{
+	switch (format)
+	{
+	case FORMAT_BC1:
+		CompressColorBlock(texels, output);
+		break;
+	case FORMAT_BC3:
+		//The alpha block comes first, encoded the same way as a BC4 block
+		CompressSingleChannelBlock(texels, 3, output);
+		CompressColorBlock(texels, output + 8);
+		break;
+	case FORMAT_BC4:
+		CompressSingleChannelBlock(texels, 0, output);
+		break;
+	case FORMAT_BC5:
+		CompressSingleChannelBlock(texels, 0, output);
+		CompressSingleChannelBlock(texels, 1, output + 8);
+		break;
+	default:
+		CompressBc7Block(texels, output);
+		break;
+	}
+}
+
+void DecompressBlock(const unsigned char* input, int format, unsigned char* texels)
+{
+	//Channels a format does not store read back as they would on the GPU
+	for (int t = 0; t < 16; t++)
+	{
+		texels[(t * 4) + 0] = 0;
+		texels[(t * 4) + 1] = 0;
+		texels[(t * 4) + 2] = 0;
+		texels[(t * 4) + 3] = 0xFF;
+	}
+
+	switch (format)
+	{
+	case FORMAT_BC1:
+		DecompressColorBlock(input, false, texels);
+		break;
+	case FORMAT_BC3:
+		DecompressColorBlock(input + 8, true, texels);
+		DecompressSingleChannelBlock(input, 3, texels);
+		break;
+	case FORMAT_BC4:
+		DecompressSingleChannelBlock(input, 0, texels);
+		break;
+	case FORMAT_BC5:
+		DecompressSingleChannelBlock(input, 0, texels);
+		DecompressSingleChannelBlock(input + 8, 1, texels);
+		break;
+	default:
+		DecompressBc7Block(input, texels);
+		break;
+	}
+}
+
+float FindIndices(const BlockType& block, int channelCount, const float palette[][4], int paletteSize, unsigned char* indices)
+{
+	__m128 texels[4];
+	__m128 difference;
+	__m128 distance;
+	__m128 bestDistance;
+	__m128 bestIndex;
+	__m128 mask;
+	float distances[4];
+	float bestIndices[4];
+	float error;
+
+	//Four texels are matched against the palette at once, keeping the closest entry of each
+	error = 0.0f;
+	for (int i = 0; i < 16; i += 4)
+	{
+		for (int c = 0; c < channelCount; c++)
+		{
+			texels[c] = _mm_loadu_ps(&block.channels[c][i]);
+		}
+
+		bestDistance = _mm_set1_ps(FLT_MAX);
+		bestIndex = _mm_setzero_ps();
+		for (int p = 0; p < paletteSize; p++)
+		{
+			distance = _mm_setzero_ps();
+			for (int c = 0; c < channelCount; c++)
+			{
+				difference = _mm_sub_ps(texels[c], _mm_set1_ps(palette[p][c]));
+				distance = _mm_add_ps(distance, _mm_mul_ps(difference, difference));
+			}
+
+			mask = _mm_cmplt_ps(distance, bestDistance);
+			bestDistance = _mm_min_ps(distance, bestDistance);
+			bestIndex = _mm_or_ps(_mm_and_ps(mask, _mm_set1_ps((float)p)), _mm_andnot_ps(mask, bestIndex));
+		}
+
+		_mm_storeu_ps(distances, bestDistance);
+		_mm_storeu_ps(bestIndices, bestIndex);
+		for (int j = 0; j < 4; j++)
+		{
+			indices[i + j] = (unsigned char)bestIndices[j];
+			error += distances[j];
+		}
+	}
+
+	return error;
+}
+
+void FindPrincipalAxis(const BlockType& block, int channelCount, float* mean, float* axis)
+{
+	float covariance[4][4];
+	float next[4];
+	float length;
+
+	//Find the mean and the covariance of the texels
+	for (int c = 0; c < channelCount; c++)
+	{
+		mean[c] = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			mean[c] += block.channels[c][i];
+		}
+		mean[c] /= 16.0f;
+	}
+
+	for (int a = 0; a < channelCount; a++)
+	{
+		for (int b = 0; b < channelCount; b++)
+		{
+			covariance[a][b] = 0.0f;
+			for (int i = 0; i < 16; i++)
+			{
+				covariance[a][b] += (block.channels[a][i] - mean[a]) * (block.channels[b][i] - mean[b]);
+			}
+		}
+	}
+
+	//A few rounds of power iteration find the direction the colors are spread along
+	for (int c = 0; c < channelCount; c++)
+	{
+		axis[c] = 1.0f;
+	}
+	for (int iteration = 0; iteration < 8; iteration++)
+	{
+		length = 0.0f;
+		for (int a = 0; a < channelCount; a++)
+		{
+			next[a] = 0.0f;
+			for (int b = 0; b < channelCount; b++)
+			{
+				next[a] += covariance[a][b] * axis[b];
+			}
+			length = max(length, fabsf(next[a]));
+		}
+
+		//A flat block has no spread, any axis will do
+		if (length < 1e-6f)
+		{
+			break;
+		}
+		for (int c = 0; c < channelCount; c++)
+		{
+			axis[c] = next[c] / length;
+		}
+	}
+
+	length = 0.0f;
+	for (int c = 0; c < channelCount; c++)
+	{
+		length += axis[c] * axis[c];
+	}
+	length = sqrtf(length);
+	for (int c = 0; c < channelCount; c++)
+	{
+		axis[c] /= length;
+	}
+}
+
+void SolveEndpoints(const BlockType& block, int channelCount, const unsigned char* indices, const float* weights, float* endpoint0, float* endpoint1)
+{
+	float alpha;
+	float beta;
+	float alphaAlpha;
+	float betaBeta;
+	float alphaBeta;
+	float alphaX[4];
+	float betaX[4];
+	float determinant;
+
+	//Least squares fit of the two endpoints that best reproduce the texels with the chosen indices
+	alphaAlpha = 0.0f;
+	betaBeta = 0.0f;
+	alphaBeta = 0.0f;
+	for (int c = 0; c < channelCount; c++)
+	{
+		alphaX[c] = 0.0f;
+		betaX[c] = 0.0f;
+	}
+
+	for (int i = 0; i < 16; i++)
+	{
+		beta = weights[indices[i]];
+		alpha = 1.0f - beta;
+		alphaAlpha += alpha * alpha;
+		betaBeta += beta * beta;
+		alphaBeta += alpha * beta;
+		for (int c = 0; c < channelCount; c++)
+		{
+			alphaX[c] += alpha * block.channels[c][i];
+			betaX[c] += beta * block.channels[c][i];
+		}
+	}
+
+	//Every texel on one index leaves the system without a solution, so the endpoints are kept
+	determinant = (alphaAlpha * betaBeta) - (alphaBeta * alphaBeta);
+	if (fabsf(determinant) < 1e-6f)
+	{
+		return;
+	}
+
+	for (int c = 0; c < channelCount; c++)
+	{
+		endpoint0[c] = min(max(((alphaX[c] * betaBeta) - (betaX[c] * alphaBeta)) / determinant, 0.0f), 255.0f);
+		endpoint1[c] = min(max(((betaX[c] * alphaAlpha) - (alphaX[c] * alphaBeta)) / determinant, 0.0f), 255.0f);
+	}
+}
+
+void CompressColorBlock(const unsigned char* texels, unsigned char* output)
+{
+	//Weights of the second endpoint for each BC1 index
+	const float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+	BlockType block;
+	unsigned char palette[4][4];
+	float floatPalette[4][4];
+	unsigned char indices[16];
+	unsigned char bestIndices[16];
+	float mean[4];
+	float axis[4];
+	float endpoint0[4];
+	float endpoint1[4];
+	float projection;
+	float minProjection;
+	float maxProjection;
+	float error;
+	float bestError;
+	unsigned short color0;
+	unsigned short color1;
+	unsigned short bestColor0;
+	unsigned short bestColor1;
+	unsigned int packedIndices;
+
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			block.channels[c][i] = (float)texels[(i * 4) + c];
+		}
+	}
+
+	//Start with the ends of the colors along their principal axis
+	FindPrincipalAxis(block, 3, mean, axis);
+	minProjection = FLT_MAX;
+	maxProjection = -FLT_MAX;
+	for (int i = 0; i < 16; i++)
+	{
+		projection = 0.0f;
+		for (int c = 0; c < 3; c++)
+		{
+			projection += (block.channels[c][i] - mean[c]) * axis[c];
+		}
+		minProjection = min(minProjection, projection);
+		maxProjection = max(maxProjection, projection);
+	}
+	for (int c = 0; c < 3; c++)
+	{
+		endpoint0[c] = min(max(mean[c] + (axis[c] * maxProjection), 0.0f), 255.0f);
+		endpoint1[c] = min(max(mean[c] + (axis[c] * minProjection), 0.0f), 255.0f);
+	}
+
+	//Refine the endpoints against the indices they produce, keeping the best pair seen
+	bestError = FLT_MAX;
+	bestColor0 = 0;
+	bestColor1 = 0;
+	memset(bestIndices, 0, sizeof(bestIndices));
+	for (int iteration = 0; iteration <= REFINE_ITERATIONS; iteration++)
+	{
+		color0 = PackColor(endpoint0);
+		color1 = PackColor(endpoint1);
+
+		//The four color mode needs the first endpoint to be the larger
+		if (color0 < color1)
+		{
+			swap(color0, color1);
+			swap(endpoint0, endpoint1);
+		}
+
+		BuildColorPalette(color0, color1, true, palette);
+		for (int p = 0; p < 4; p++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				floatPalette[p][c] = (float)palette[p][c];
+			}
+		}
+
+		error = FindIndices(block, 3, floatPalette, 4, indices);
+		if (error < bestError)
+		{
+			bestError = error;
+			bestColor0 = color0;
+			bestColor1 = color1;
+			memcpy(bestIndices, indices, sizeof(indices));
+		}
+		if (error == 0.0f)
+		{
+			break;
+		}
+
+		SolveEndpoints(block, 3, indices, weights, endpoint0, endpoint1);
+	}
+
+	//Equal endpoints would decode as the three color mode, which has the same first entries
+	if (bestColor0 == bestColor1)
+	{
+		memset(bestIndices, 0, sizeof(bestIndices));
+	}
+
+	packedIndices = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		packedIndices |= (unsigned int)bestIndices[i] << (i * 2);
+	}
+
+	output[0] = (unsigned char)(bestColor0 & 0xFF);
+	output[1] = (unsigned char)(bestColor0 >> 8);
+	output[2] = (unsigned char)(bestColor1 & 0xFF);
+	output[3] = (unsigned char)(bestColor1 >> 8);
+	memcpy(&output[4], &packedIndices, 4);
+}
+
+void CompressSingleChannelBlock(const unsigned char* texels, int channel, unsigned char* output)
+{
+	BlockType block;
+	int palette[8];
+	float floatPalette[8][4];
+	unsigned char indices[16];
+	unsigned char bestIndices[16];
+	int minValue;
+	int maxValue;
+	int innerMin;
+	int innerMax;
+	int endpoint0;
+	int endpoint1;
+	int bestEndpoint0;
+	int bestEndpoint1;
+	float error;
+	float bestError;
+	unsigned long long packedIndices;
+
+	minValue = 255;
+	maxValue = 0;
+	innerMin = 255;
+	innerMax = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		block.channels[0][i] = (float)texels[(i * 4) + channel];
+		minValue = min(minValue, (int)texels[(i * 4) + channel]);
+		maxValue = max(maxValue, (int)texels[(i * 4) + channel]);
+
+		//The six value mode has exact 0 and 255 entries, so only the values between need endpoints
+		if (texels[(i * 4) + channel] != 0 && texels[(i * 4) + channel] != 255)
+		{
+			innerMin = min(innerMin, (int)texels[(i * 4) + channel]);
+			innerMax = max(innerMax, (int)texels[(i * 4) + channel]);
+		}
+	}
+
+	//Try the eight value mode with the endpoints nudged around the range of the block
+	bestError = FLT_MAX;
+	bestEndpoint0 = maxValue;
+	bestEndpoint1 = minValue;
+	memset(bestIndices, 0, sizeof(bestIndices));
+	for (int high = 0; high <= 2 && bestError > 0.0f; high++)
+	{
+		for (int low = 0; low <= 2 && bestError > 0.0f; low++)
+		{
+			endpoint0 = maxValue - high;
+			endpoint1 = minValue + low;
+			if (endpoint0 <= endpoint1)
+			{
+				continue;
+			}
+
+			BuildSingleChannelPalette(endpoint0, endpoint1, palette);
+			for (int p = 0; p < 8; p++)
+			{
+				floatPalette[p][0] = (float)palette[p];
+			}
+
+			error = FindIndices(block, 1, floatPalette, 8, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestEndpoint0 = endpoint0;
+				bestEndpoint1 = endpoint1;
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+		}
+	}
+
+	//Try the six value mode, which suits blocks with texels at both extremes
+	if (innerMin <= innerMax && bestError > 0.0f)
+	{
+		endpoint0 = innerMin;
+		endpoint1 = innerMax;
+		BuildSingleChannelPalette(endpoint0, endpoint1, palette);
+		for (int p = 0; p < 8; p++)
+		{
+			floatPalette[p][0] = (float)palette[p];
+		}
+
+		error = FindIndices(block, 1, floatPalette, 8, indices);
+		if (error < bestError)
+		{
+			bestError = error;
+			bestEndpoint0 = endpoint0;
+			bestEndpoint1 = endpoint1;
+			memcpy(bestIndices, indices, sizeof(indices));
+		}
+	}
+
+	//A flat block is stored in the eight value mode with every index on the first endpoint
+	if (bestError == FLT_MAX)
+	{
+		bestEndpoint0 = maxValue;
+		bestEndpoint1 = minValue;
+	}
+
+	packedIndices = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		packedIndices |= (unsigned long long)bestIndices[i] << (i * 3);
+	}
+
+	output[0] = (unsigned char)bestEndpoint0;
+	output[1] = (unsigned char)bestEndpoint1;
+	for (int i = 0; i < 6; i++)
+	{
+		output[2 + i] = (unsigned char)(packedIndices >> (i * 8));
+	}
+}
+
+void CompressBc7Block(const unsigned char* texels, unsigned char* output)
+{
+	BlockType block;
+	float weights[16];
+	float floatPalette[16][4];
+	unsigned char indices[16];
+	unsigned char bestIndices[16];
+	int quantized[2][4];
+	int bestQuantized[2][4];
+	int bestPBits[2];
+	float mean[4];
+	float axis[4];
+	float endpoints[2][4];
+	float projection;
+	float minProjection;
+	float maxProjection;
+	float error;
+	float bestError;
+	int value;
+	int position;
+
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			block.channels[c][i] = (float)texels[(i * 4) + c];
+		}
+	}
+	for (int i = 0; i < 16; i++)
+	{
+		weights[i] = (float)BC7_WEIGHTS[i] / 64.0f;
+	}
+
+	//Mode 6 is a single subset of RGBA endpoints with 4 bit indices, start along the principal axis
+	FindPrincipalAxis(block, 4, mean, axis);
+	minProjection = FLT_MAX;
+	maxProjection = -FLT_MAX;
+	for (int i = 0; i < 16; i++)
+	{
+		projection = 0.0f;
+		for (int c = 0; c < 4; c++)
+		{
+			projection += (block.channels[c][i] - mean[c]) * axis[c];
+		}
+		minProjection = min(minProjection, projection);
+		maxProjection = max(maxProjection, projection);
+	}
+	for (int c = 0; c < 4; c++)
+	{
+		endpoints[0][c] = min(max(mean[c] + (axis[c] * minProjection), 0.0f), 255.0f);
+		endpoints[1][c] = min(max(mean[c] + (axis[c] * maxProjection), 0.0f), 255.0f);
+	}
+
+	bestError = FLT_MAX;
+	memset(bestIndices, 0, sizeof(bestIndices));
+	memset(bestQuantized, 0, sizeof(bestQuantized));
+	bestPBits[0] = 0;
+	bestPBits[1] = 0;
+	for (int iteration = 0; iteration <= REFINE_ITERATIONS; iteration++)
+	{
+		//Each endpoint has 7 bits per channel and a shared low bit, every pair of low bits is tried
+		for (int pBits = 0; pBits < 4; pBits++)
+		{
+			for (int e = 0; e < 2; e++)
+			{
+				int pBit = (pBits >> e) & 1;
+				for (int c = 0; c < 4; c++)
+				{
+					value = (int)floorf(((endpoints[e][c] - (float)pBit) / 2.0f) + 0.5f);
+					quantized[e][c] = min(max(value, 0), 127);
+				}
+			}
+
+			for (int p = 0; p < 16; p++)
+			{
+				for (int c = 0; c < 4; c++)
+				{
+					int value0 = (quantized[0][c] << 1) | (pBits & 1);
+					int value1 = (quantized[1][c] << 1) | ((pBits >> 1) & 1);
+					floatPalette[p][c] = (float)((((64 - BC7_WEIGHTS[p]) * value0) + (BC7_WEIGHTS[p] * value1) + 32) >> 6);
+				}
+			}
+
+			error = FindIndices(block, 4, floatPalette, 16, indices);
+			if (error < bestError)
+			{
+				bestError = error;
+				memcpy(bestIndices, indices, sizeof(indices));
+				memcpy(bestQuantized, quantized, sizeof(quantized));
+				bestPBits[0] = pBits & 1;
+				bestPBits[1] = (pBits >> 1) & 1;
+			}
+		}
+		if (bestError == 0.0f)
+		{
+			break;
+		}
+
+		SolveEndpoints(block, 4, bestIndices, weights, endpoints[0], endpoints[1]);
+	}
+
+	//The first index is stored with its top bit implied clear, so the endpoints are swapped when it is set
+	if (bestIndices[0] & 0x8)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			swap(bestQuantized[0][c], bestQuantized[1][c]);
+		}
+		swap(bestPBits[0], bestPBits[1]);
+		for (int i = 0; i < 16; i++)
+		{
+			bestIndices[i] = 15 - bestIndices[i];
+		}
+	}
+
+	memset(output, 0, 16);
+	position = 0;
+	WriteBits(output, position, 0x40, 7);
+	for (int c = 0; c < 4; c++)
+	{
+		WriteBits(output, position, bestQuantized[0][c], 7);
+		WriteBits(output, position, bestQuantized[1][c], 7);
+	}
+	WriteBits(output, position, bestPBits[0], 1);
+	WriteBits(output, position, bestPBits[1], 1);
+	WriteBits(output, position, bestIndices[0], 3);
+	for (int i = 1; i < 16; i++)
+	{
+		WriteBits(output, position, bestIndices[i], 4);
+	}
+}
+
+void DecompressColorBlock(const unsigned char* input, bool alwaysFourColors, unsigned char* texels)
+{
+	unsigned char palette[4][4];
+	unsigned short color0;
+	unsigned short color1;
+	unsigned int packedIndices;
+	int index;
+
+	color0 = (unsigned short)(input[0] | (input[1] << 8));
+	color1 = (unsigned short)(input[2] | (input[3] << 8));
+	memcpy(&packedIndices, &input[4], 4);
+
+	BuildColorPalette(color0, color1, alwaysFourColors, palette);
+	for (int i = 0; i < 16; i++)
+	{
+		index = (packedIndices >> (i * 2)) & 0x3;
+		texels[(i * 4) + 0] = palette[index][0];
+		texels[(i * 4) + 1] = palette[index][1];
+		texels[(i * 4) + 2] = palette[index][2];
+		if (!alwaysFourColors)
+		{
+			texels[(i * 4) + 3] = palette[index][3];
+		}
+	}
+}
+
+void DecompressSingleChannelBlock(const unsigned char* input, int channel, unsigned char* texels)
+{
+	int palette[8];
+	unsigned long long packedIndices;
+
+	BuildSingleChannelPalette(input[0], input[1], palette);
+
+	packedIndices = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		packedIndices |= (unsigned long long)input[2 + i] << (i * 8);
+	}
+
+	for (int i = 0; i < 16; i++)
+	{
+		texels[(i * 4) + channel] = (unsigned char)palette[(packedIndices >> (i * 3)) & 0x7];
+	}
+}
+
+void DecompressBc7Block(const unsigned char* input, unsigned char* texels)
+{
+	int endpoints[2][4];
+	int pBits[2];
+	int index;
+	int position;
+
+	//Only mode 6 is written by this tool, any other mode decodes as black
+	if ((input[0] & 0x7F) != 0x40)
+	{
+		memset(texels, 0, 64);
+		return;
+	}
+
+	position = 7;
+	for (int c = 0; c < 4; c++)
+	{
+		endpoints[0][c] = (int)ReadBits(input, position, 7);
+		endpoints[1][c] = (int)ReadBits(input, position, 7);
+	}
+	pBits[0] = (int)ReadBits(input, position, 1);
+	pBits[1] = (int)ReadBits(input, position, 1);
+
+	for (int i = 0; i < 16; i++)
+	{
+		index = (int)ReadBits(input, position, (i == 0) ? 3 : 4);
+		for (int c = 0; c < 4; c++)
+		{
+			int value0 = (endpoints[0][c] << 1) | pBits[0];
+			int value1 = (endpoints[1][c] << 1) | pBits[1];
+			texels[(i * 4) + c] = (unsigned char)((((64 - BC7_WEIGHTS[index]) * value0) + (BC7_WEIGHTS[index] * value1) + 32) >> 6);
+		}
+	}
+}
+
+void BuildColorPalette(unsigned short color0, unsigned short color1, bool alwaysFourColors, unsigned char palette[4][4])
+{
+	UnpackColor(color0, palette[0]);
+	UnpackColor(color1, palette[1]);
+	palette[0][3] = 0xFF;
+	palette[1][3] = 0xFF;
+	palette[2][3] = 0xFF;
+	palette[3][3] = 0xFF;
+
+	//The order of the endpoints picks between four colors and three colors with transparent black
+	if (alwaysFourColors || color0 > color1)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (unsigned char)(((2 * palette[0][c]) + palette[1][c]) / 3);
+			palette[3][c] = (unsigned char)((palette[0][c] + (2 * palette[1][c])) / 3);
+		}
+	}
+	else
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (unsigned char)((palette[0][c] + palette[1][c]) / 2);
+			palette[3][c] = 0;
+		}
+		palette[3][3] = 0;
+	}
+}
+
+void BuildSingleChannelPalette(int endpoint0, int endpoint1, int* palette)
+{
+	palette[0] = endpoint0;
+	palette[1] = endpoint1;
+
+	//The order of the endpoints picks between eight interpolated values and six with exact 0 and 255
+	if (endpoint0 > endpoint1)
+	{
+		for (int i = 1; i < 7; i++)
+		{
+			palette[1 + i] = (((7 - i) * endpoint0) + (i * endpoint1)) / 7;
+		}
+	}
+	else
+	{
+		for (int i = 1; i < 5; i++)
+		{
+			palette[1 + i] = (((5 - i) * endpoint0) + (i * endpoint1)) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+unsigned short PackColor(const float* color)
+{
+	int red;
+	int green;
+	int blue;
+
+	red = min(max((int)((color[0] * 31.0f / 255.0f) + 0.5f), 0), 31);
+	green = min(max((int)((color[1] * 63.0f / 255.0f) + 0.5f), 0), 63);
+	blue = min(max((int)((color[2] * 31.0f / 255.0f) + 0.5f), 0), 31);
+
+	return (unsigned short)((red << 11) | (green << 5) | blue);
+}
+
+void UnpackColor(unsigned short color, unsigned char* rgb)
+{
+	int red;
+	int green;
+	int blue;
+
+	//Expand to 8 bits by repeating the top bits in the bottom ones
+	red = (color >> 11) & 0x1F;
+	green = (color >> 5) & 0x3F;
+	blue = color & 0x1F;
+	rgb[0] = (unsigned char)((red << 3) | (red >> 2));
+	rgb[1] = (unsigned char)((green << 2) | (green >> 4));
+	rgb[2] = (unsigned char)((blue << 3) | (blue >> 2));
+}
+
+void WriteBits(unsigned char* output, int& position, unsigned int value, int count)
+{
+	//Blocks are little endian bit streams, lowest bit first
+	for (int i = 0; i < count; i++)
+	{
+		if ((value >> i) & 1)
+		{
+			output[position >> 3] |= (unsigned char)(1 << (position & 7));
+		}
+		position++;
+	}
+}
+
+unsigned int ReadBits(const unsigned char* input, int& position, int count)
+{
+	unsigned int value;
+
+	value = 0;
+	for (int i = 0; i < count; i++)
+	{
+		value |= (unsigned int)((input[position >> 3] >> (position & 7)) & 1) << i;
+		position++;
+	}
+
+	return value;
+}
\ No newline at end of file
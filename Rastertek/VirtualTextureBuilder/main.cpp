@@ -0,0 +1,387 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "../Engine/DdsFile.h"
+
+/////////////
+// GLOBALS //
+/////////////
+const unsigned int VT_MAGIC = 0x58455456;
+const unsigned int VT_VERSION = 1;
+const int VT_MAX_MIPS = 15;
+const int VT_MAX_PAGES = 0x3FFF;
+
+//////////////
+// TYPEDEFS //
+//////////////
+
+//These three match the layout VirtualTextureFile reads
+struct VtHeaderType
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int width;
+	unsigned int height;
+	unsigned int pageSize;
+	unsigned int border;
+	unsigned int mipCount;
+	unsigned int pageCount;
+};
+
+struct VtLevelType
+{
+	unsigned int pagesWide;
+	unsigned int pagesHigh;
+	unsigned int firstPage;
+};
+
+struct VtPageType
+{
+	unsigned long long offset;
+	unsigned int size;
+	unsigned int reserved;
+};
+
+//Texels are A8R8G8B8, the format the physical texture uses
+struct LevelType
+{
+	int width;
+	int height;
+	vector<unsigned int> texels;
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+bool LoadSourceImage(const char* filename, vector<LevelType>& levels);
+void DownsampleLevel(const LevelType& source, LevelType& level);
+bool IsPowerOfTwo(int value);
+void BuildPage(const vector<LevelType>& levels, int mip, int levelWidth, int levelHeight, int pageX, int pageY, int pageSize, int border, vector<unsigned int>& page);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	bool result;
+	vector<LevelType> levels;
+	vector<VtLevelType> vtLevels;
+	vector<VtPageType> vtPages;
+	vector<unsigned int> page;
+	VtHeaderType header;
+	ofstream fOut;
+	int pageSize;
+	int border;
+	int repeat;
+	int paddedSize;
+	int width;
+	int height;
+	int mipCount;
+	int firstArgument;
+	unsigned long long offset;
+
+	//Usage: VirtualTextureBuilder [-page n] [-border n] [-repeat n] <input.dds> <output.vt>
+	if (argc < 3)
+	{
+		cout << "Usage: VirtualTextureBuilder [-page n] [-border n] [-repeat n] <input.dds> <output.vt>" << endl;
+		cout << "  -page    page size in texels without the border (default 128)" << endl;
+		cout << "  -border  texels copied from the neighbouring pages on every side (default 4)" << endl;
+		cout << "  -repeat  tile the image n times in each direction to make a larger terrain texture (default 1)" << endl;
+		cout << "  Mip levels in the input file are used, run it through MipGenerator first for the best quality" << endl;
+		return -1;
+	}
+
+	pageSize = 128;
+	border = 4;
+	repeat = 1;
+	firstArgument = 1;
+	while (firstArgument + 1 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-page") == 0)
+		{
+			pageSize = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-border") == 0)
+		{
+			border = atoi(argv[firstArgument + 1]);
+		}
+		else if (strcmp(argv[firstArgument], "-repeat") == 0)
+		{
+			repeat = atoi(argv[firstArgument + 1]);
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+		firstArgument += 2;
+	}
+	if (argc - firstArgument != 2 || !IsPowerOfTwo(pageSize) || !IsPowerOfTwo(repeat) || border < 0 || border > pageSize / 2)
+	{
+		cout << "The page size and repeat count have to be powers of two and the border at most half a page" << endl;
+		return -1;
+	}
+
+	//Read in the image and make the rest of its chain down to a single texel
+	result = LoadSourceImage(argv[firstArgument], levels);
+	if (!result)
+	{
+		cout << "Could not load " << argv[firstArgument] << ", only uncompressed 32 bit 2D DDS files are supported" << endl;
+		return -1;
+	}
+
+	width = levels[0].width * repeat;
+	height = levels[0].height * repeat;
+	if (!IsPowerOfTwo(width) || !IsPowerOfTwo(height) || width < pageSize || height < pageSize)
+	{
+		cout << "The image has to be a power of two and at least one page in size" << endl;
+		return -1;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+	//Lay out the levels, they stop once a single page covers the whole image
+	mipCount = 0;
+	while (true)
+	{
+		VtLevelType level;
+		level.pagesWide = max((width >> mipCount) / pageSize, 1);
+		level.pagesHigh = max((height >> mipCount) / pageSize, 1);
+		level.firstPage = (unsigned int)vtPages.size();
+		if (level.pagesWide > (unsigned int)VT_MAX_PAGES || level.pagesHigh > (unsigned int)VT_MAX_PAGES)
+		{
+			cout << "The virtual texture has too many pages, use a larger page size" << endl;
+			return -1;
+		}
+		vtLevels.push_back(level);
+		vtPages.resize(vtPages.size() + (level.pagesWide * level.pagesHigh));
+
+		mipCount++;
+		if (level.pagesWide == 1 && level.pagesHigh == 1)
+		{
+			break;
+		}
+	}
+	if (mipCount > VT_MAX_MIPS)
+	{
+		cout << "The virtual texture has too many levels, use a larger page size" << endl;
+		return -1;
+	}
+
+	//Every page is the same size so the table can be filled in before any page is built
+	paddedSize = pageSize + (border * 2);
+	offset = sizeof(VtHeaderType) + (sizeof(VtLevelType) * vtLevels.size()) + (sizeof(VtPageType) * vtPages.size());
+	for (size_t i = 0; i < vtPages.size(); i++)
+	{
+		vtPages[i].offset = offset;
+		vtPages[i].size = paddedSize * paddedSize * 4;
+		vtPages[i].reserved = 0;
+		offset += vtPages[i].size;
+	}
+
+	header.magic = VT_MAGIC;
+	header.version = VT_VERSION;
+	header.width = width;
+	header.height = height;
+	header.pageSize = pageSize;
+	header.border = border;
+	header.mipCount = mipCount;
+	header.pageCount = (unsigned int)vtPages.size();
+
+	//Open the output file and write the tables
+	fOut.open(argv[firstArgument + 1], ios::binary);
+	if (fOut.fail())
+	{
+		cout << "Could not write " << argv[firstArgument + 1] << endl;
+		return -1;
+	}
+
+	fOut.write((const char*)&header, sizeof(VtHeaderType));
+	fOut.write((const char*)&vtLevels[0], sizeof(VtLevelType) * vtLevels.size());
+	fOut.write((const char*)&vtPages[0], sizeof(VtPageType) * vtPages.size());
+
+	//Write every page in the order of the table, row by row from the most detailed level
+	page.resize(paddedSize * paddedSize);
+	for (int mip = 0; mip < mipCount; mip++)
+	{
+		for (unsigned int y = 0; y < vtLevels[mip].pagesHigh; y++)
+		{
+			for (unsigned int x = 0; x < vtLevels[mip].pagesWide; x++)
+			{
+				BuildPage(levels, mip, max(width >> mip, 1), max(height >> mip, 1), x, y, pageSize, border, page);
+				fOut.write((const char*)&page[0], page.size() * sizeof(unsigned int));
+			}
+		}
+	}
+
+	//Close the output file
+	fOut.close();
+	if (fOut.fail())
+	{
+		cout << "Could not write " << argv[firstArgument + 1] << endl;
+		return -1;
+	}
+
+	chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+	//Display the results to the screen for information purpose
+	cout << argv[firstArgument] << ": " << width << "x" << height << " virtual texture, " << mipCount << " levels, " << vtPages.size() << " pages of " << pageSize << "+" << border * 2 << " texels" << endl;
+	for (int mip = 0; mip < mipCount; mip++)
+	{
+		cout << "  Level " << mip << ": " << vtLevels[mip].pagesWide << "x" << vtLevels[mip].pagesHigh << " pages" << endl;
+	}
+	cout << "File size: " << offset / 1024 << " KB" << endl;
+	cout << "Time: " << fixed << setprecision(3) << chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0 << " ms" << endl;
+
+	return 0;
+}
+
+bool LoadSourceImage(const char* filename, vector<LevelType>& levels)
+{
+	DdsFile file;
+	vector<unsigned char> bytes;
+	const void* data;
+	unsigned int rowPitch;
+	unsigned int slicePitch;
+	unsigned int width;
+	unsigned int height;
+	bool result;
+
+	//Map the file in, the header sizes are checked against the file there
+	result = file.Initialize(filename);
+	if (!result)
+	{
+		return false;
+	}
+
+	//Only single uncompressed 32 bit textures are supported, not arrays or cube maps
+	if (file.GetArraySize() != 1)
+	{
+		file.Shutdown();
+		return false;
+	}
+
+	//Read in every level that is in the file
+	for (unsigned int mip = 0; mip < file.GetMipCount(); mip++)
+	{
+		LevelType level;
+
+		file.GetSurface(0, mip, data, rowPitch, slicePitch, width, height);
+		bytes.resize((size_t)width * height * 4);
+		result = file.GetSurfaceRgba(0, mip, &bytes[0]);
+		if (!result)
+		{
+			file.Shutdown();
+			return false;
+		}
+
+		level.width = (int)width;
+		level.height = (int)height;
+		level.texels.resize(bytes.size() / 4);
+		for (size_t i = 0; i < level.texels.size(); i++)
+		{
+			level.texels[i] = ((unsigned int)bytes[(i * 4) + 3] << 24) | ((unsigned int)bytes[i * 4] << 16) | ((unsigned int)bytes[(i * 4) + 1] << 8) | bytes[(i * 4) + 2];
+		}
+		levels.push_back(level);
+	}
+
+	//Release the file
+	file.Shutdown();
+
+	//Box filter any levels the file did not have
+	while (levels.back().width > 1 || levels.back().height > 1)
+	{
+		LevelType level;
+		DownsampleLevel(levels.back(), level);
+		levels.push_back(level);
+	}
+
+	return true;
+}
+
+void DownsampleLevel(const LevelType& source, LevelType& level)
+{
+	unsigned int sum;
+	unsigned int texel;
+	int sx, sy;
+
+	level.width = max(source.width / 2, 1);
+	level.height = max(source.height / 2, 1);
+	level.texels.resize((size_t)level.width * level.height);
+
+	for (int y = 0; y < level.height; y++)
+	{
+		for (int x = 0; x < level.width; x++)
+		{
+			texel = 0;
+			for (int c = 0; c < 32; c += 8)
+			{
+				sum = 0;
+				for (int i = 0; i < 4; i++)
+				{
+					sx = min((x * 2) + (i & 1), source.width - 1);
+					sy = min((y * 2) + (i >> 1), source.height - 1);
+					sum += (source.texels[(sy * source.width) + sx] >> c) & 0xFF;
+				}
+				texel |= ((sum + 2) / 4) << c;
+			}
+			level.texels[(y * level.width) + x] = texel;
+		}
+	}
+}
+
+bool IsPowerOfTwo(int value)
+{
+	return value > 0 && (value & (value - 1)) == 0;
+}
+
+void BuildPage(const vector<LevelType>& levels, int mip, int levelWidth, int levelHeight, int pageX, int pageY, int pageSize, int border, vector<unsigned int>& page)
+{
+	const LevelType* source;
+	int paddedSize, x, y, sx, sy, spanX, spanY;
+
+	//The virtual texture is the image repeated, so level n of it is level n of the image repeated
+	source = &levels[min(mip, (int)levels.size() - 1)];
+	paddedSize = pageSize + (border * 2);
+
+	//A level smaller than a page is stretched over the single page the shader maps it to
+	spanX = min(levelWidth, pageSize);
+	spanY = min(levelHeight, pageSize);
+
+	for (int py = 0; py < paddedSize; py++)
+	{
+		for (int px = 0; px < paddedSize; px++)
+		{
+			//The border wraps around into the neighbouring pages, the texture tiles at its edges
+			x = (pageX * spanX * pageSize) + ((px - border) * spanX);
+			y = (pageY * spanY * pageSize) + ((py - border) * spanY);
+			x = (x >= 0) ? x / pageSize : -((pageSize - 1 - x) / pageSize);
+			y = (y >= 0) ? y / pageSize : -((pageSize - 1 - y) / pageSize);
+			x = ((x % levelWidth) + levelWidth) % levelWidth;
+			y = ((y % levelHeight) + levelHeight) % levelHeight;
+
+			sx = x % source->width;
+			sy = y % source->height;
+			page[(py * paddedSize) + px] = source->texels[(sy * source->width) + sx];
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,391 @@
+////////////////////////////////////////////////////////////////////////////////
+// Filename: main.cpp
+////////////////////////////////////////////////////////////////////////////////
+
+
+//////////////
+// INCLUDES //
+//////////////
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cstdlib>
+using namespace std;
+
+///////////////////////
+// MY CLASS INCLUDES //
+///////////////////////
+#include "../Engine/VirtualTextureFile.h"
+#include "../Engine/PageCache.h"
+#include "../Engine/PageLoader.h"
+#include "../Engine/PageScheduler.h"
+
+//////////////
+// TYPEDEFS //
+//////////////
+struct OptionsType
+{
+	int slotsWide;
+	int slotsHigh;
+	int threadCount;
+	int maxRequests;
+	int maxUploads;
+	int frameTime;
+};
+
+/////////////////////////
+// FUNCTION PROTOTYPES //
+/////////////////////////
+bool ReplayTrace(const char* textureName, const char* traceName, OptionsType& options, bool check, bool print, vector<unsigned int>& frameCounts);
+bool ReadFrame(ifstream& trace, vector<unsigned int>& feedback);
+bool CheckLockedPages(VirtualTextureFile& file, PageCache& cache, PageScheduler& scheduler, vector<int>& lockedSlots);
+bool CheckPageTable(VirtualTextureFile& file, PageCache& cache, PageScheduler& scheduler);
+
+//////////////////
+// MAIN PROGRAM //
+//////////////////
+int main(int argc, char* argv[])
+{
+	bool result;
+	OptionsType options;
+	vector<unsigned int> frameCounts;
+	vector<unsigned int> repeatCounts;
+	bool check;
+	int firstArgument;
+
+	//Usage: VirtualTextureReplay [-cache w h] [-threads n] [-requests n] [-uploads n] [-frame ms] [-check] <texture.vt> <trace.txt>
+	if (argc < 3)
+	{
+		cout << "Usage: VirtualTextureReplay [-cache w h] [-threads n] [-requests n] [-uploads n] [-frame ms] [-check] <texture.vt> <trace.txt>" << endl;
+		cout << "  -cache     physical texture size in pages (default 16 16)" << endl;
+		cout << "  -threads   loader threads, 0 reads pages as they are requested so runs repeat exactly (default 0)" << endl;
+		cout << "  -requests  pages requested per frame (default 16)" << endl;
+		cout << "  -uploads   pages uploaded per frame (default 8)" << endl;
+		cout << "  -frame     time the loader threads get each frame, as a running game would give them (default 16)" << endl;
+		cout << "  -check     replay twice without threads and check the counts repeat, the coarsest level stays put and the page table is right" << endl;
+		cout << "  The trace is the one VirtualTexture::StartTrace records, a line per frame of page ids and counts" << endl;
+		cout << "  seafloor.vt and trace.txt next to this file are a small texture and trace, -cache 8 4 makes it evict" << endl;
+		return -1;
+	}
+
+	options.slotsWide = 16;
+	options.slotsHigh = 16;
+	options.threadCount = 0;
+	options.maxRequests = 16;
+	options.maxUploads = 8;
+	options.frameTime = 16;
+	check = false;
+	firstArgument = 1;
+	while (firstArgument + 2 < argc && argv[firstArgument][0] == '-')
+	{
+		if (strcmp(argv[firstArgument], "-cache") == 0 && firstArgument + 3 < argc)
+		{
+			options.slotsWide = atoi(argv[firstArgument + 1]);
+			options.slotsHigh = atoi(argv[firstArgument + 2]);
+			firstArgument += 3;
+		}
+		else if (strcmp(argv[firstArgument], "-threads") == 0)
+		{
+			options.threadCount = atoi(argv[firstArgument + 1]);
+			firstArgument += 2;
+		}
+		else if (strcmp(argv[firstArgument], "-requests") == 0)
+		{
+			options.maxRequests = atoi(argv[firstArgument + 1]);
+			firstArgument += 2;
+		}
+		else if (strcmp(argv[firstArgument], "-uploads") == 0)
+		{
+			options.maxUploads = atoi(argv[firstArgument + 1]);
+			firstArgument += 2;
+		}
+		else if (strcmp(argv[firstArgument], "-frame") == 0)
+		{
+			options.frameTime = atoi(argv[firstArgument + 1]);
+			firstArgument += 2;
+		}
+		else if (strcmp(argv[firstArgument], "-check") == 0)
+		{
+			check = true;
+			firstArgument += 1;
+		}
+		else
+		{
+			cout << "Unknown option " << argv[firstArgument] << endl;
+			return -1;
+		}
+	}
+	if (argc - firstArgument != 2)
+	{
+		cout << "Expected a virtual texture and a trace" << endl;
+		return -1;
+	}
+
+	if (!check)
+	{
+		result = ReplayTrace(argv[firstArgument], argv[firstArgument + 1], options, false, true, frameCounts);
+		return result ? 0 : -1;
+	}
+
+	//Only the replay without threads is meant to repeat exactly, the threads finish their pages in any order
+	options.threadCount = 0;
+
+	result = ReplayTrace(argv[firstArgument], argv[firstArgument + 1], options, true, true, frameCounts);
+	if (!result)
+	{
+		return -1;
+	}
+	cout << "Coarsest level locked: OK" << endl;
+	cout << "Page table: OK" << endl;
+
+	//Replay it again from scratch and compare the counters after every frame
+	result = ReplayTrace(argv[firstArgument], argv[firstArgument + 1], options, true, false, repeatCounts);
+	if (!result)
+	{
+		return -1;
+	}
+
+	if (repeatCounts != frameCounts)
+	{
+		cout << "FAILED: a second replay of the trace did not give the same hits, requests and evictions" << endl;
+		return -1;
+	}
+	cout << "Deterministic counts: OK" << endl;
+
+	return 0;
+}
+
+bool ReplayTrace(const char* textureName, const char* traceName, OptionsType& options, bool check, bool print, vector<unsigned int>& frameCounts)
+{
+	bool result;
+	VirtualTextureFile file;
+	PageCache cache;
+	PageLoader loader;
+	PageScheduler scheduler;
+	ifstream trace;
+	vector<unsigned int> feedback;
+	vector<int> lockedSlots;
+	int frameCount;
+	long long updateTime;
+
+	//Set up the same objects VirtualTexture uses, without any of the Direct3D side
+	result = file.Initialize(textureName);
+	if (!result)
+	{
+		cout << "Could not load " << textureName << endl;
+		return false;
+	}
+
+	result = cache.Initialize(options.slotsWide, options.slotsHigh);
+	if (!result)
+	{
+		cout << "The cache can be at most 256 by 256 pages" << endl;
+		return false;
+	}
+
+	result = loader.Initialize(&file, options.threadCount);
+	if (!result)
+	{
+		cout << "Could not start the page loader" << endl;
+		return false;
+	}
+
+	result = scheduler.Initialize(&file, &cache, &loader, options.maxRequests, options.maxUploads);
+	if (!result)
+	{
+		cout << "The cache is too small to hold the coarsest level" << endl;
+		return false;
+	}
+
+	trace.open(traceName);
+	if (trace.fail())
+	{
+		cout << "Could not load " << traceName << endl;
+		return false;
+	}
+
+	//No slot is known for any page of the coarsest level until it is uploaded
+	lockedSlots.assign(file.GetPagesWide(file.GetMipCount() - 1) * file.GetPagesHigh(file.GetMipCount() - 1), PAGE_CACHE_NO_SLOT);
+
+	//Replay every frame of the trace, the uploads are simply dropped since there is no GPU
+	frameCounts.clear();
+	frameCount = 0;
+	updateTime = 0;
+	while (ReadFrame(trace, feedback))
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		scheduler.Update(feedback.empty() ? nullptr : &feedback[0], (int)feedback.size());
+		chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+		updateTime += chrono::duration_cast<chrono::microseconds>(end - start).count();
+		frameCount++;
+
+		if (check)
+		{
+			result = CheckLockedPages(file, cache, scheduler, lockedSlots) && CheckPageTable(file, cache, scheduler);
+			if (!result)
+			{
+				cout << "  at frame " << frameCount << " of " << traceName << endl;
+				break;
+			}
+		}
+		scheduler.ReleaseUploads();
+		scheduler.ClearPageTableDirty();
+
+		//Keep the counters after every frame so two replays can be compared
+		frameCounts.push_back(scheduler.GetHitCount());
+		frameCounts.push_back(scheduler.GetMissCount());
+		frameCounts.push_back(scheduler.GetRequestCount());
+		frameCounts.push_back(scheduler.GetUploadTotal());
+		frameCounts.push_back(scheduler.GetDroppedCount());
+		frameCounts.push_back(cache.GetEvictionCount());
+
+		//A replayed frame takes a fraction of a millisecond, without the rest of a frame the threads would deliver every page many frames late
+		if (options.threadCount > 0 && options.frameTime > 0)
+		{
+			this_thread::sleep_until(start + chrono::milliseconds(options.frameTime));
+		}
+	}
+
+	//Display the results to the screen for information purpose
+	if (result && print)
+	{
+		cout << textureName << ": " << file.GetWidth() << "x" << file.GetHeight() << ", " << file.GetMipCount() << " levels, cache of " << cache.GetSlotCount() << " pages" << endl;
+		cout << "Frames: " << frameCount << endl;
+		cout << "Page lookups: " << scheduler.GetHitCount() + scheduler.GetMissCount() << ", ";
+		cout << fixed << setprecision(1) << (100.0 * scheduler.GetHitCount()) / max(scheduler.GetHitCount() + scheduler.GetMissCount(), 1u) << "% resident" << endl;
+		cout << "Requests: " << scheduler.GetRequestCount() << ", uploads: " << scheduler.GetUploadTotal() << ", dropped: " << scheduler.GetDroppedCount() << ", evictions: " << cache.GetEvictionCount() << endl;
+		cout << "Resident pages: " << cache.GetResidentCount() << ", still in flight: " << scheduler.GetInFlightCount() << endl;
+		cout << "Update: " << setprecision(3) << (frameCount > 0 ? updateTime / 1000.0 / frameCount : 0.0) << " ms per frame" << endl;
+	}
+
+	//Release the objects
+	trace.close();
+	scheduler.Shutdown();
+	loader.Shutdown();
+	cache.Shutdown();
+	file.Shutdown();
+
+	return result;
+}
+
+bool ReadFrame(ifstream& trace, vector<unsigned int>& feedback)
+{
+	unsigned int pageCount;
+	unsigned int pageId;
+	unsigned int count;
+
+	//Each line is the number of pages followed by a page id and how many pixels asked for it
+	trace >> pageCount;
+	if (trace.fail())
+	{
+		return false;
+	}
+
+	feedback.clear();
+	for (unsigned int i = 0; i < pageCount; i++)
+	{
+		trace >> pageId >> count;
+		if (trace.fail())
+		{
+			return false;
+		}
+		feedback.insert(feedback.end(), count, pageId);
+	}
+
+	return true;
+}
+
+bool CheckLockedPages(VirtualTextureFile& file, PageCache& cache, PageScheduler& scheduler, vector<int>& lockedSlots)
+{
+	unsigned int pageId;
+	int coarsest, pagesWide, slot;
+
+	coarsest = file.GetMipCount() - 1;
+	pagesWide = file.GetPagesWide(coarsest);
+
+	//Remember the slot each page of the coarsest level is uploaded to
+	for (int i = 0; i < scheduler.GetUploadCount(); i++)
+	{
+		pageId = scheduler.GetUpload(i).pageId;
+		if (VirtualTextureFile::GetPageMip(pageId) != coarsest)
+		{
+			continue;
+		}
+
+		slot = scheduler.GetUpload(i).slotY * cache.GetSlotsWide() + scheduler.GetUpload(i).slotX;
+		if (lockedSlots[VirtualTextureFile::GetPageY(pageId) * pagesWide + VirtualTextureFile::GetPageX(pageId)] != PAGE_CACHE_NO_SLOT)
+		{
+			cout << "FAILED: coarsest page " << pageId << " was uploaded a second time" << endl;
+			return false;
+		}
+		lockedSlots[VirtualTextureFile::GetPageY(pageId) * pagesWide + VirtualTextureFile::GetPageX(pageId)] = slot;
+	}
+
+	//Once uploaded they are locked, so they must never move or be evicted
+	for (size_t i = 0; i < lockedSlots.size(); i++)
+	{
+		if (lockedSlots[i] == PAGE_CACHE_NO_SLOT)
+		{
+			continue;
+		}
+
+		pageId = VirtualTextureFile::MakePageId((int)i % pagesWide, (int)i / pagesWide, coarsest);
+		if (cache.FindPage(pageId) != lockedSlots[i])
+		{
+			cout << "FAILED: coarsest page " << pageId << " left slot " << lockedSlots[i] << endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CheckPageTable(VirtualTextureFile& file, PageCache& cache, PageScheduler& scheduler)
+{
+	const unsigned int* table;
+	unsigned int pageId, expected;
+	int slot;
+
+	//Every entry must name the page itself when it is resident, otherwise the nearest resident page above it
+	for (int mip = 0; mip < file.GetMipCount(); mip++)
+	{
+		table = scheduler.GetPageTable(mip);
+		for (int y = 0; y < file.GetPagesHigh(mip); y++)
+		{
+			for (int x = 0; x < file.GetPagesWide(mip); x++)
+			{
+				pageId = VirtualTextureFile::MakePageId(x, y, mip);
+				slot = PAGE_CACHE_NO_SLOT;
+				while (VirtualTextureFile::GetPageMip(pageId) < file.GetMipCount())
+				{
+					slot = cache.FindPage(pageId);
+					if (slot != PAGE_CACHE_NO_SLOT)
+					{
+						break;
+					}
+					pageId = VirtualTextureFile::GetParentPage(pageId);
+				}
+
+				expected = 0;
+				if (slot != PAGE_CACHE_NO_SLOT)
+				{
+					expected = (unsigned int)(slot % cache.GetSlotsWide()) | ((unsigned int)(slot / cache.GetSlotsWide()) << 8) | ((unsigned int)VirtualTextureFile::GetPageMip(pageId) << 16) | 0xFF000000;
+				}
+
+				if (table[y * file.GetPagesWide(mip) + x] != expected)
+				{
+					cout << "FAILED: page table entry " << x << "," << y << " of level " << mip << " is " << hex << table[y * file.GetPagesWide(mip) + x] << " instead of " << expected << dec << endl;
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
\ No newline at end of file